@@ -10,6 +10,8 @@
 #include <filesystem>
 #include <thread>
 #include <mutex>
+#include <fstream>
+#include <iomanip>
 
 class LoggingOverheadBenchmark : public ::testing::Test {
 protected:
@@ -275,4 +277,114 @@ TEST_F(LoggingOverheadBenchmark, ActiveMessageOverheadWithFileLogging) {
     std::cout << "[DEBUG] Removing test directory\n" << std::flush;
     std::filesystem::remove_all(test_dir);
     std::cout << "[DEBUG] Completed ActiveMessageOverheadWithFileLogging test\n" << std::flush;
-}
\ No newline at end of file
+}
+
+TEST_F(LoggingOverheadBenchmark, CompiledOutStatementOverhead) {
+    // A level below XTREE_MIN_LOG_LEVEL yields NullLogWrapper: no level
+    // check, no argument encoding, no code at all after inlining
+    const int iterations = 10000000;
+    std::atomic<int> counter{0};
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        counter++;
+    }
+    auto baseline_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    counter = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        xtree::NullLogWrapper() << "Compiled out: " << i << " " << 3.14;
+        counter++;
+    }
+    auto null_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    // Runtime-filtered statement for comparison
+    xtree::logLevel.store(xtree::LOG_WARNING, std::memory_order_relaxed);
+    counter = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        xtree::LoggerWrapper(nullptr, false) << "Filtered: " << i << " " << 3.14;
+        counter++;
+    }
+    auto filtered_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    std::cout << "\nCompiled-out vs runtime-filtered statements (10M iterations):\n";
+    std::cout << "  Baseline:          " << (double)baseline_ns / iterations << " ns/iter\n";
+    std::cout << "  Compiled out:      " << (double)null_ns / iterations << " ns/iter\n";
+    std::cout << "  Runtime filtered:  " << (double)filtered_ns / iterations << " ns/iter\n";
+    std::cout << "  XTREE_MIN_LOG_LEVEL=" << XTREE_MIN_LOG_LEVEL << "\n";
+    
+    EXPECT_LT((null_ns - baseline_ns) / iterations, 1) << "Compiled-out statement should cost nothing";
+}
+
+TEST_F(LoggingOverheadBenchmark, AsyncVsSyncActiveOverhead) {
+    // Hot-path cost of an active message: synchronous format + write + fflush
+    // versus binary encode + ring push with a background drain thread
+    static int test_counter = 0;
+    std::string test_dir = "/tmp/bench_logging_async_" + std::to_string(getpid()) + "_" + std::to_string(++test_counter);
+    std::filesystem::create_directories(test_dir);
+    
+    const int per_thread = 20000;
+    const std::vector<int> thread_counts = {1, 4, 8};
+    
+    auto run = [&](int threads) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([t, per_thread]() {
+                for (int i = 0; i < per_thread; i++) {
+                    xtree::info() << "split node=" << i << " thread=" << t << " fill=" << 0.75;
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+               / (threads * per_thread);
+    };
+    
+    std::cout << "\nActive message hot-path cost WITH FILE LOGGING (" << per_thread << " msgs/thread):\n";
+    std::cout << "  Threads   Sync (ns/msg)   Async (ns/msg)   Speedup   Async stalls\n";
+    
+    size_t expected_lines = 0;
+    {
+        xtree::LogRuntime::Config config;
+        config.enable_file_logging = true;
+        config.log_dir = test_dir;
+        config.rotation_config.enable_auto_rotation = false;
+        config.initial_level = xtree::LOG_INFO;
+        xtree::LogRuntimeGuard runtime(config);
+        
+        for (int threads : thread_counts) {
+            double sync_ns = run(threads);
+            
+            xtree::Logger::startAsync();
+            uint64_t stalls_before = xtree::Logger::asyncStalls();
+            double async_ns = run(threads);
+            uint64_t stalls = xtree::Logger::asyncStalls() - stalls_before;
+            xtree::Logger::stopAsync();
+            
+            expected_lines += 2 * threads * per_thread;
+            std::cout << "  " << std::setw(7) << threads
+                      << std::setw(16) << std::fixed << std::setprecision(1) << sync_ns
+                      << std::setw(17) << async_ns
+                      << std::setw(9) << std::setprecision(2) << (sync_ns / async_ns) << "x"
+                      << std::setw(15) << stalls << "\n";
+        }
+    }
+    
+    // Both paths delivered every message
+    std::ifstream log_file(test_dir + "/xtree.log");
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(log_file, line)) {
+        if (line.find("split node=") != std::string::npos) lines++;
+    }
+    EXPECT_EQ(lines, expected_lines);
+    
+    std::filesystem::remove_all(test_dir);
+}
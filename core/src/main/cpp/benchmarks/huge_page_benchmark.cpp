@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Random point queries and random mapped reads with and without huge pages
+ *
+ * dTLB load misses are read from the PMU through perf_event_open (user
+ * space only); where the PMU is not available (most VMs and containers)
+ * the column reads n/a and the latency and the kernel's huge page counters
+ * from /proc/self/smaps_rollup are what is left to compare.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/indexdetails.hpp"
+#include "../src/memmgr/huge_page_arena.hpp"
+#include "../src/persistence/file_handle_registry.h"
+#include "../src/persistence/mapping_manager.h"
+
+using namespace xtree;
+using namespace std::chrono;
+
+namespace {
+
+    // User-space dTLB read misses of this thread, if the PMU is reachable
+    class DtlbMissCounter {
+    public:
+        DtlbMissCounter() {
+#ifdef __linux__
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+        ~DtlbMissCounter() {
+            if (fd_ >= 0) close(fd_);
+        }
+
+        bool available() const { return fd_ >= 0; }
+
+        void start() {
+#ifdef __linux__
+            if (fd_ < 0) return;
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+
+        uint64_t stop() {
+            uint64_t count = 0;
+#ifdef __linux__
+            if (fd_ < 0) return 0;
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+            return count;
+        }
+
+    private:
+        int fd_ = -1;
+    };
+
+    // A kB field of /proc/self/smaps_rollup (AnonHugePages, FilePmdMapped, ...)
+    size_t smapsKB(const std::string& field) {
+        std::ifstream in("/proc/self/smaps_rollup");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, field.size() + 1, field + ":") == 0) {
+                std::istringstream ss(line.substr(field.size() + 1));
+                size_t kb = 0;
+                ss >> kb;
+                return kb;
+            }
+        }
+        return 0;
+    }
+
+    std::string missesPerOp(const DtlbMissCounter& counter, uint64_t misses, size_t ops) {
+        if (!counter.available()) return "n/a";
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2) << static_cast<double>(misses) / ops;
+        return ss.str();
+    }
+
+}  // namespace
+
+class HugePageBenchmark : public ::testing::Test {
+protected:
+    void SetUp() override {
+        IndexDetails<DataRecord>::clearCache();
+        dataDir = "/tmp/xtree_huge_page_bench_" + std::to_string(getpid());
+        std::filesystem::remove_all(dataDir);
+        std::filesystem::create_directories(dataDir);
+    }
+
+    void TearDown() override {
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    std::string dataDir;
+    std::vector<const char*> dimLabels = {"x", "y"};
+};
+
+TEST_F(HugePageBenchmark, InMemoryPointQueries) {
+    std::cout << "\n=== In-Memory Point Queries: Node Arena on 2MB Pages ===\n";
+
+    const int NUM_RECORDS = 100000;
+    const int NUM_QUERIES = 20000;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> pos(0, 10000);
+    std::vector<std::vector<double>> points;
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        points.push_back({pos(gen), pos(gen)});
+    }
+    std::uniform_int_distribution<> pick(0, NUM_RECORDS - 1);
+    std::vector<int> targets;
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        targets.push_back(pick(gen));
+    }
+
+    auto& arena = HugePageArena::global();
+    const auto savedMode = arena.mode();
+    DtlbMissCounter counter;
+
+    std::cout << " Nodes          | Build (s) | Query (us) | Hits   | dTLB misses/q | Arena chunks | AnonHugePages (MB)\n";
+    std::cout << "----------------|-----------|------------|--------|---------------|--------------|-------------------\n";
+    for (const auto mode : {HugePageArena::Mode::Off, HugePageArena::Mode::THP}) {
+        arena.set_mode(mode);
+        const size_t chunksBefore = arena.stats().chunks;
+
+        auto* index = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "huge_bench",
+                                                   IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY);
+        index->ensure_root_initialized<DataRecord>();
+        auto t0 = high_resolution_clock::now();
+        for (int i = 0; i < NUM_RECORDS; i++) {
+            auto* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            dr->putPoint(&points[i]);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+        const double buildSec = duration<double>(high_resolution_clock::now() - t0).count();
+
+        DataRecord query(2, 32, "q");
+        size_t found = 0;
+        counter.start();
+        t0 = high_resolution_clock::now();
+        for (int t : targets) {
+            std::vector<double> lo = {points[t][0] - 0.01, points[t][1] - 0.01};
+            std::vector<double> hi = {points[t][0] + 0.01, points[t][1] + 0.01};
+            query.getKey()->reset();
+            query.putPoint(&lo);
+            query.putPoint(&hi);
+            auto iter = index->root_bucket<DataRecord>()->getPooledIterator(index->root_cache_node(), &query, INTERSECTS);
+            std::string_view rid;
+            while (iter->nextRowID(rid)) found++;
+        }
+        const double queryUs = duration<double, std::micro>(high_resolution_clock::now() - t0).count() / NUM_QUERIES;
+        const uint64_t misses = counter.stop();
+        EXPECT_GT(found, 0u);
+
+        std::cout << std::setw(15) << (mode == HugePageArena::Mode::Off ? "malloc" : "arena (THP)") << " | "
+                  << std::setw(9) << std::fixed << std::setprecision(2) << buildSec << " | "
+                  << std::setw(10) << queryUs << " | "
+                  << std::setw(6) << found << " | "
+                  << std::setw(13) << missesPerOp(counter, misses, NUM_QUERIES) << " | "
+                  << std::setw(12) << arena.stats().chunks - chunksBefore << " | "
+                  << std::setw(18) << smapsKB("AnonHugePages") / 1024 << "\n";
+
+        delete index;
+        IndexDetails<DataRecord>::clearCache();
+    }
+    arena.set_mode(savedMode);
+}
+
+TEST_F(HugePageBenchmark, RandomMappedReads) {
+    std::cout << "\n=== Random 8-Byte Reads over Mapped Segment Files ===\n";
+
+    const size_t FILE_BYTES = 512ULL << 20;
+    const size_t WINDOW = 128ULL << 20;
+    const int NUM_READS = 5000000;
+
+    DtlbMissCounter counter;
+    std::cout << " Windows        | Read (ns) | dTLB misses/read | Huge extents | FilePmdMapped (MB)\n";
+    std::cout << "----------------|-----------|------------------|--------------|-------------------\n";
+    for (const bool huge : {false, true}) {
+        persist::FileHandleRegistry fhr(16);
+        persist::MappingManager mm(fhr, WINDOW, 64);
+        mm.set_huge_pages(huge);
+        const std::string file = dataDir + (huge ? "/huge.xd" : "/plain.xd");
+
+        std::vector<persist::MappingManager::Pin> pins;
+        for (size_t off = 0; off < FILE_BYTES; off += WINDOW) {
+            pins.push_back(mm.pin(file, off, WINDOW, true));
+            std::memset(pins.back().get(), static_cast<int>(off / WINDOW) + 1, WINDOW);
+        }
+
+        std::mt19937_64 gen(7);
+        std::uniform_int_distribution<size_t> at(0, FILE_BYTES / 8 - 1);
+        std::vector<size_t> offsets(NUM_READS);
+        for (auto& o : offsets) o = at(gen) * 8;
+
+        uint64_t sum = 0;
+        counter.start();
+        auto t0 = high_resolution_clock::now();
+        for (size_t o : offsets) {
+            uint64_t v;
+            std::memcpy(&v, pins[o / WINDOW].get() + o % WINDOW, sizeof(v));
+            sum += v;
+        }
+        const double readNs = duration<double, std::nano>(high_resolution_clock::now() - t0).count() / NUM_READS;
+        const uint64_t misses = counter.stop();
+        EXPECT_NE(sum, 0u);
+
+        std::cout << std::setw(15) << (huge ? "MADV_HUGEPAGE" : "4KB") << " | "
+                  << std::setw(9) << std::fixed << std::setprecision(1) << readNs << " | "
+                  << std::setw(16) << missesPerOp(counter, misses, NUM_READS) << " | "
+                  << std::setw(12) << mm.getStats().huge_extents << " | "
+                  << std::setw(18) << smapsKB("FilePmdMapped") / 1024 << "\n";
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * NUMA-aware vs flat placement for object table shards and query workers
+ *
+ * Each run compares the machine's topology (from /sys) with a flat
+ * single-node view of the same CPUs. On a one-node box both rows match;
+ * to see the effect without a 2-socket machine, boot with numa=fake=2 (or
+ * run in a VM with two virtual nodes) and optionally constrain the process
+ * with numactl, e.g.
+ *
+ *   numactl --cpunodebind=0,1 --interleave=all ./numa_benchmark
+ *
+ * XTREE_NUMA=off makes the "/sys" and "NUMA-local" rows flat too.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/xtparallel.h"
+#include "../src/indexdetails.hpp"
+#include "../src/util/numa_topology.h"
+#include "../src/persistence/object_table_sharded.hpp"
+
+using namespace xtree;
+using namespace xtree::persist;
+using namespace std::chrono;
+
+namespace {
+
+    void printTopology(const NumaTopology& numa) {
+        std::cout << "Nodes: " << numa.node_count() << " (";
+        for (size_t n = 0; n < numa.node_count(); ++n) {
+            std::cout << (n ? ", " : "") << "node" << numa.os_node(n) << ": "
+                      << numa.cpus_of(n).size() << " cpus";
+        }
+        std::cout << ")\n";
+    }
+
+}  // namespace
+
+TEST(NumaBenchmark, ObjectTableAllocateRetire) {
+    std::cout << "\n=== Object Table Allocate/Retire: Node-Affine Shards ===\n";
+    const NumaTopology& numa = NumaTopology::system();
+    printTopology(numa);
+
+    const size_t threads = std::max<size_t>(2, std::thread::hardware_concurrency());
+    const int OPS_PER_THREAD = 200000;
+    const NumaTopology flat = NumaTopology::single_node(static_cast<int>(threads));
+
+    std::cout << " Placement | Threads | Mops/s | Handles on caller's node\n";
+    std::cout << "-----------|---------|--------|-------------------------\n";
+    for (const NumaTopology* topo : {&flat, &numa}) {
+        ObjectTableSharded ot(threads * OPS_PER_THREAD / 4, ObjectTableSharded::DEFAULT_NUM_SHARDS, topo);
+        ot.set_activation_step_for_tests(64);
+
+        std::atomic<size_t> home{0};
+        auto t0 = high_resolution_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                const size_t node = t % numa.node_count();
+                numa.bind_current_thread(node);
+                size_t mine = 0;
+                std::vector<NodeID> live;
+                live.reserve(256);
+                for (int i = 0; i < OPS_PER_THREAD; ++i) {
+                    NodeID id = ot.allocate(NodeKind::Leaf, 1, OTAddr{}, 1);
+                    const size_t shard = ShardBits::shard_from_handle_idx(id.handle_index());
+                    if (shard % numa.node_count() == node) ++mine;
+                    live.push_back(id);
+                    if (live.size() == 256) {
+                        for (NodeID l : live) ot.retire(l, 2);
+                        live.clear();
+                    }
+                }
+                home.fetch_add(mine);
+                NumaTopology::clear_thread_binding();
+            });
+        }
+        for (auto& w : workers) w.join();
+        const double sec = duration<double>(high_resolution_clock::now() - t0).count();
+
+        std::cout << std::setw(10) << (topo == &flat ? "flat" : "/sys") << " | "
+                  << std::setw(7) << threads << " | "
+                  << std::setw(6) << std::fixed << std::setprecision(2)
+                  << threads * OPS_PER_THREAD / sec / 1e6 << " | "
+                  << std::setw(22) << std::setprecision(1)
+                  << 100.0 * home.load() / (threads * OPS_PER_THREAD) << " %\n";
+    }
+}
+
+TEST(NumaBenchmark, ParallelQueryWorkers) {
+    std::cout << "\n=== Parallel Range Query: NUMA-Local Worker Pool ===\n";
+    const NumaTopology& numa = NumaTopology::system();
+    printTopology(numa);
+
+    std::vector<const char*> dimLabels = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "numa_benchmark",
+                                               IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY);
+    ASSERT_TRUE(index->ensure_root_initialized<DataRecord>());
+
+    const int GRID_SIZE = 250;
+    for (int x = 0; x < GRID_SIZE; x++) {
+        for (int y = 0; y < GRID_SIZE; y++) {
+            auto* dr = new DataRecord(2, 32, "grid_" + std::to_string(x) + "_" + std::to_string(y));
+            std::vector<double> pt = {(double)x, (double)y};
+            dr->putPoint(&pt);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+    }
+    DataRecord query(2, 32, "q");
+    std::vector<double> lo = {10.0, 10.0}, hi = {200.0, 180.0};
+    query.putPoint(&lo);
+    query.putPoint(&hi);
+
+    const size_t threads = std::max<size_t>(2, std::thread::hardware_concurrency());
+    const int REPS = 20;
+    std::cout << " Workers   | Threads | Rows   | Best (ms) | Mean (ms)\n";
+    std::cout << "-----------|---------|--------|-----------|----------\n";
+    for (const NumaTopology* topo : {static_cast<const NumaTopology*>(nullptr), &numa}) {
+        ParallelQueryExecutor<DataRecord> exec(index, threads, topo);
+        double best = 1e300, total = 0;
+        size_t rows = 0;
+        for (int r = 0; r < REPS; r++) {
+            auto t0 = high_resolution_clock::now();
+            auto result = exec.execute(index->root_cache_node(), &query, INTERSECTS);
+            rows = result.size();
+            const double ms = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+            best = std::min(best, ms);
+            total += ms;
+        }
+        EXPECT_EQ(rows, 191u * 171u);
+        std::cout << std::setw(10) << (topo ? "NUMA-local" : "unbound") << " | "
+                  << std::setw(7) << threads << " | "
+                  << std::setw(6) << rows << " | "
+                  << std::setw(9) << std::fixed << std::setprecision(2) << best << " | "
+                  << std::setw(9) << total / REPS << "\n";
+    }
+
+    delete index;
+    IndexDetails<DataRecord>::clearCache();
+}
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <vector>
 #include <random>
+#include <iomanip>
 #include <immintrin.h>  // For AVX/SSE intrinsics
 #ifdef __APPLE__
 #include <sys/sysctl.h>
@@ -17,12 +18,14 @@
 #include "../src/xtree.h"
 #include "../src/xtree.hpp"
 #include "../src/indexdetails.hpp"
-#include "../src/compact_xtree_allocator.hpp"
+#include "../src/xtiter.h"
+#include "../src/xtparallel.h"
+#include "../src/xtmulti.h"
 #include "../src/util/cpu_features.h"
 
 using namespace xtree;
 using namespace std::chrono;
-using CacheNode = LRUCacheNode<IRecord, UniqueId, LRUDeleteNone>;
+using CacheNode = XTreeBucket<DataRecord>::CacheNode;
 
 // SIMD-optimized MBR intersection for 2D points
 inline bool intersects_simd_2d(const int32_t* box1, const int32_t* box2) {
@@ -117,7 +120,7 @@ TEST_F(ParallelSIMDBenchmark, MultiThreadedQueries) {
     // Create index
     std::vector<const char*> dimLabels = {"x", "y"};
     auto* index = new IndexDetails<DataRecord>(
-        2, 32, &dimLabels, nullptr, nullptr,
+        2, 32, &dimLabels, nullptr, nullptr, "parallel_benchmark",
         IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY
     );
     
@@ -322,4 +325,178 @@ TEST_F(ParallelSIMDBenchmark, OptimalConfiguration) {
     std::cout << "- Enable SIMD optimizations in KeyMBR::intersects for 2D queries\n";
     std::cout << "- Use thread-local query objects to avoid allocation overhead\n";
     std::cout << "- Consider work-stealing queue for better load balancing\n";
-}
\ No newline at end of file
+}
+
+TEST_F(ParallelSIMDBenchmark, IntraQueryParallelRange) {
+    std::cout << "\n=== Intra-Query Parallel Range Queries ===\n";
+    
+    std::vector<const char*> dimLabels = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(
+        2, 32, &dimLabels, nullptr, nullptr, "parallel_benchmark",
+        IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY
+    );
+    ASSERT_TRUE(index->ensure_root_initialized<DataRecord>());
+    
+    const int GRID_SIZE = 1000;
+    std::cout << "Inserting " << GRID_SIZE * GRID_SIZE << " points...\n";
+    for (int x = 0; x < GRID_SIZE; x++) {
+        for (int y = 0; y < GRID_SIZE; y++) {
+            DataRecord* dr = createPointRecord(index,
+                "grid_" + std::to_string(x) + "_" + std::to_string(y),
+                (double)x, (double)y);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+    }
+    auto* cachedRoot = index->root_cache_node();
+    auto* root = index->root_bucket<DataRecord>();
+    
+    // Analytic-style query: about half the index
+    DataRecord* query = createPointRecord(index, "query", 100.0, 100.0);
+    std::vector<double> maxPt = {800.0, 725.0};
+    query->putPoint(&maxPt);
+    
+    const int REPS = 3;
+    
+    // Baseline: one Iterator draining row IDs in batches, same output work
+    size_t baselineRows = 0;
+    double baselineMs = 1e300;
+    {
+        std::vector<char> out(1 << 16);
+        std::vector<uint32_t> ends(1024);
+        for (int r = 0; r < REPS; r++) {
+            auto start = high_resolution_clock::now();
+            auto iter = root->getIterator(cachedRoot, query, INTERSECTS);
+            size_t rows = 0;
+            while (size_t n = iter->nextBatch(out.data(), out.size(), ends.data(), ends.size())) {
+                rows += n;
+            }
+            delete iter;
+            double ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+            baselineMs = std::min(baselineMs, ms);
+            baselineRows = rows;
+        }
+    }
+    
+    std::cout << "Rows per query: " << baselineRows << "\n";
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << "Threads | Tasks | Unordered (ms) | Speedup | Ordered (ms) | Speedup\n";
+    std::cout << "--------|-------|----------------|---------|--------------|--------\n";
+    std::cout << std::setw(7) << "Iter" << " | " << std::setw(5) << 1 << " | "
+              << std::setw(14) << std::fixed << std::setprecision(1) << baselineMs << " | "
+              << std::setw(6) << std::setprecision(2) << 1.0 << "x | "
+              << std::setw(12) << std::setprecision(1) << baselineMs << " | "
+              << std::setw(5) << std::setprecision(2) << 1.0 << "x\n";
+    
+    for (size_t threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        ParallelQueryExecutor<DataRecord> exec(index, threads);
+        
+        double best[2] = {1e300, 1e300};
+        const ParallelQueryExecutor<DataRecord>::Merge merges[2] = {
+            ParallelQueryExecutor<DataRecord>::Merge::UNORDERED,
+            ParallelQueryExecutor<DataRecord>::Merge::ORDERED
+        };
+        for (int m = 0; m < 2; m++) {
+            for (int r = 0; r < REPS; r++) {
+                auto start = high_resolution_clock::now();
+                auto result = exec.execute(cachedRoot, query, INTERSECTS, merges[m]);
+                size_t rows = 0;
+                result.forEach([&rows](std::string_view) { rows++; });
+                double ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+                best[m] = std::min(best[m], ms);
+                ASSERT_EQ(rows, baselineRows);
+            }
+        }
+        
+        std::cout << std::setw(7) << threads << " | "
+                  << std::setw(5) << exec.lastTaskCount() << " | "
+                  << std::setw(14) << std::setprecision(1) << best[0] << " | "
+                  << std::setw(6) << std::setprecision(2) << baselineMs / best[0] << "x | "
+                  << std::setw(12) << std::setprecision(1) << best[1] << " | "
+                  << std::setw(5) << std::setprecision(2) << baselineMs / best[1] << "x\n";
+    }
+    
+    delete index;
+}
+
+TEST_F(ParallelSIMDBenchmark, BatchedSmallBoxQueries) {
+    std::cout << "\n=== Batched Multi-Query vs One Iterator per Query ===\n";
+    
+    std::vector<const char*> dimLabels = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(
+        2, 32, &dimLabels, nullptr, nullptr, "parallel_benchmark",
+        IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY
+    );
+    ASSERT_TRUE(index->ensure_root_initialized<DataRecord>());
+    
+    const int GRID_SIZE = 316;
+    std::cout << "Inserting " << GRID_SIZE * GRID_SIZE << " points...\n";
+    for (int x = 0; x < GRID_SIZE; x++) {
+        for (int y = 0; y < GRID_SIZE; y++) {
+            DataRecord* dr = createPointRecord(index,
+                "grid_" + std::to_string(x) + "_" + std::to_string(y),
+                (double)x, (double)y);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+    }
+    auto* cachedRoot = index->root_cache_node();
+    auto* root = index->root_bucket<DataRecord>();
+    
+    // Small boxes as query records (per-query path) and flat floats (batch path)
+    const int NUM_QUERIES = 20000;
+    const double BOX = 5.0;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> dis(0, GRID_SIZE - BOX);
+    std::vector<DataRecord*> queries;
+    std::vector<float> boxes;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        DataRecord* q = createPointRecord(index, "q", dis(gen), dis(gen));
+        std::vector<double> maxPt = {q->getKey()->getMax(0) + BOX, q->getKey()->getMax(1) + BOX};
+        q->putPoint(&maxPt);
+        queries.push_back(q);
+        const float* key = q->getKey()->data();
+        boxes.insert(boxes.end(), key, key + 4);
+    }
+    
+    // Baseline: getIterator -> new Iterator -> full descent, per query
+    size_t baselineRows = 0;
+    auto start = high_resolution_clock::now();
+    for (auto* q : queries) {
+        auto iter = root->getIterator(cachedRoot, q, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) baselineRows++;
+        delete iter;
+    }
+    double baselineMs = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    
+    std::cout << "Queries: " << NUM_QUERIES << ", matches: " << baselineRows << "\n\n";
+    std::cout << "  Batch | Time (ms) |     QPS | Speedup | Nodes/query\n";
+    std::cout << "--------|-----------|---------|---------|------------\n";
+    std::cout << std::setw(7) << 1 << " | "
+              << std::setw(9) << std::fixed << std::setprecision(1) << baselineMs << " | "
+              << std::setw(7) << std::setprecision(0) << NUM_QUERIES * 1000.0 / baselineMs << " | "
+              << std::setw(6) << std::setprecision(2) << 1.0 << "x | "
+              << std::setw(11) << "(Iterator)" << "\n";
+    
+    MultiQueryExecutor<DataRecord> exec(index);
+    for (size_t batch : {16u, 64u, 256u, 1024u, 4096u}) {
+        size_t rows = 0;
+        uint64_t nodes = 0;
+        start = high_resolution_clock::now();
+        for (size_t first = 0; first < (size_t)NUM_QUERIES; first += batch) {
+            const size_t count = std::min(batch, (size_t)NUM_QUERIES - first);
+            auto result = exec.execute(cachedRoot, &boxes[first * 4], count, INTERSECTS);
+            rows += result.size();
+            nodes += exec.lastNodesVisited();
+        }
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+        EXPECT_EQ(rows, baselineRows);
+        
+        std::cout << std::setw(7) << batch << " | "
+                  << std::setw(9) << std::setprecision(1) << ms << " | "
+                  << std::setw(7) << std::setprecision(0) << NUM_QUERIES * 1000.0 / ms << " | "
+                  << std::setw(6) << std::setprecision(2) << baselineMs / ms << "x | "
+                  << std::setw(11) << std::setprecision(2) << (double)nodes / NUM_QUERIES << "\n";
+    }
+    
+    delete index;
+}
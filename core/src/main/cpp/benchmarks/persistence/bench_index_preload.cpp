@@ -0,0 +1,151 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * First-query latency after a restart, with and without background preloading
+ *
+ * Several durable fields are written, each to its own data directory, and
+ * their access history stored in the manifests. Each run then starts from a cleared cache
+ * and registry, registers the fields from the manifest and issues one range
+ * query per field. On demand, every first query opens its index; with
+ * IndexRegistry::start_preload() the opens happen while the process would
+ * otherwise be idle (here, before the first query arrives).
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include "../../src/indexdetails.hpp"
+#include "../../src/persistence/index_registry.h"
+#include "../../src/persistence/manifest.h"
+
+using namespace xtree;
+using namespace xtree::persist;
+using namespace std::chrono;
+
+class IndexPreloadBenchmark : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dataDir = "/tmp/xtree_preload_bench_" + std::to_string(getpid());
+        std::filesystem::remove_all(dataDir);
+        std::filesystem::create_directories(dataDir);
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    void TearDown() override {
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    std::string dataDir;
+    std::vector<const char*> dimLabels = {"x", "y"};
+};
+
+TEST_F(IndexPreloadBenchmark, FirstQueryAfterRestart) {
+    std::cout << "\n=== First Query per Field After Restart: On Demand vs Preloaded ===\n";
+
+    const int NUM_FIELDS = 8;
+    const int RECORDS_PER_FIELD = 5000;
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<> pos(0, 1000);
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        const std::string name = "field_" + std::to_string(f);
+        const std::string dir = dataDir + "/" + name;
+        std::filesystem::create_directories(dir);
+        auto* index = new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, name,
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, dir);
+        index->ensure_root_initialized<DataRecord>();
+        for (int i = 0; i < RECORDS_PER_FIELD; i++) {
+            auto* dr = new DataRecord(2, 32, name + "_" + std::to_string(i));
+            std::vector<double> pt = {pos(gen), pos(gen)};
+            dr->putPoint(&pt);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+        index->forceCheckpoint();   // readers recover from the checkpoint
+        index->close();
+        delete index;
+        IndexDetails<DataRecord>::clearCache();
+
+        // Earlier fields were queried more in the previous life
+        Manifest manifest(dir);
+        ASSERT_TRUE(manifest.load());
+        auto roots = manifest.get_roots();
+        for (auto& root : roots) {
+            if (root.name == name) root.access_count = 100 * (NUM_FIELDS - f);
+        }
+        manifest.set_roots(roots);
+        ASSERT_TRUE(manifest.store());
+    }
+
+    DataRecord query(2, 32, "q");
+    std::vector<double> lo = {100, 100}, hi = {300, 300};
+    query.putPoint(&lo);
+    query.putPoint(&hi);
+
+    auto run = [&](bool preload) {
+        auto& registry = IndexRegistry::global();
+        registry.reset();
+        IndexDetails<DataRecord>::clearCache();
+
+        IndexConfig defaults;
+        defaults.dimension = 2;
+        defaults.precision = 32;
+        defaults.read_only = true;
+        for (int f = 0; f < NUM_FIELDS; f++) {
+            registry.register_from_data_dir(dataDir + "/field_" + std::to_string(f), defaults);
+        }
+
+        double warmMs = 0;
+        if (preload) {
+            auto t0 = high_resolution_clock::now();
+            PreloadOptions options;
+            options.min_access_count = 1;   // only the fields queried before
+            registry.start_preload<DataRecord>(options);
+            EXPECT_TRUE(registry.wait_preload(seconds{120}));
+            warmMs = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+            EXPECT_EQ(registry.preload_stats().loaded, static_cast<size_t>(NUM_FIELDS));
+        }
+
+        std::vector<double> us;
+        size_t hits = 0;
+        for (int f = 0; f < NUM_FIELDS; f++) {
+            auto t0 = high_resolution_clock::now();
+            auto* idx = registry.get_or_load<DataRecord>("field_" + std::to_string(f));
+            EXPECT_TRUE(idx->recover_root<DataRecord>());
+            auto* iter = idx->root_bucket<DataRecord>()->getIterator(idx->root_cache_node(), &query, INTERSECTS);
+            std::string_view rid;
+            while (iter->nextRowID(rid)) hits++;
+            delete iter;
+            us.push_back(duration<double, std::micro>(high_resolution_clock::now() - t0).count());
+        }
+        std::sort(us.begin(), us.end());
+        double mean = 0;
+        for (double u : us) mean += u / us.size();
+
+        std::cout << std::setw(9) << (preload ? "preloaded" : "on demand") << " | "
+                  << std::setw(7) << hits << " | "
+                  << std::setw(10) << std::fixed << std::setprecision(1) << warmMs << " | "
+                  << std::setw(9) << us.front() << " | "
+                  << std::setw(9) << mean << " | "
+                  << std::setw(9) << us.back() << "\n";
+        return hits;
+    };
+
+    std::cout << "Fields: " << NUM_FIELDS << " x " << RECORDS_PER_FIELD << " records\n\n";
+    std::cout << " Mode     | Hits    | Preload ms | Min (us)  | Mean (us) | Max (us)\n";
+    std::cout << "----------|---------|------------|-----------|-----------|----------\n";
+    const size_t cold = run(false);
+    const size_t warm = run(true);
+    EXPECT_GT(cold, 0u);
+    EXPECT_EQ(cold, warm);
+}
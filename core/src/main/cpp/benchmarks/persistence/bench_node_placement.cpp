@@ -0,0 +1,184 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Pages touched per range query with and without subtree-clustered placement
+ *
+ * The same points are loaded into two durable indexes, one built with
+ * placement hints off (XTREE_PLACEMENT_HINTS=0) and one with them on. Each
+ * query then walks the committed tree through the store, as a cold reader
+ * would, and counts the distinct 4 KiB pages holding the buckets it enters
+ * and the data records it returns.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include <unistd.h>
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include "../../src/indexdetails.hpp"
+
+using namespace xtree;
+
+namespace {
+
+    struct PageCount {
+        size_t bucketPages = 0;
+        size_t recordPages = 0;
+        size_t buckets = 0;
+        size_t records = 0;
+        size_t hitLeaves = 0;   // leaves holding at least one result
+    };
+
+    void addPages(std::unordered_set<uintptr_t>& pages, const persist::NodeBytes& bytes) {
+        const uintptr_t first = reinterpret_cast<uintptr_t>(bytes.data) >> 12;
+        const uintptr_t last = (reinterpret_cast<uintptr_t>(bytes.data) + bytes.size - 1) >> 12;
+        for (uintptr_t p = first; p <= last; p++) pages.insert(p);
+    }
+
+    // Walk the committed tree below root for one query (layout: XTreeBucket::to_wire)
+    PageCount walk(const persist::StoreInterface* store, persist::NodeID root,
+                   const KeyMBR& query, unsigned short dims, unsigned short precision) {
+        constexpr size_t HEADER_BYTES = 1 + 2 + 4;
+        constexpr size_t TRAILER_BYTES = 8 + 1 + 7;
+
+        std::unordered_set<uintptr_t> bucketPages, recordPages;
+        PageCount count;
+        KeyMBR child(dims, precision);
+        std::vector<uint64_t> stack = {root.raw()};
+        while (!stack.empty()) {
+            const auto bytes = store->read_node(persist::NodeID::from_raw(stack.back()));
+            stack.pop_back();
+            if (!bytes.data || bytes.size < HEADER_BYTES) continue;
+            addPages(bucketPages, bytes);
+            count.buckets++;
+
+            const uint8_t* r = static_cast<const uint8_t*>(bytes.data);
+            const bool leaf = (*r++ != 0);
+            r += 2;
+            const uint32_t n = util::load_le32(r);
+            r += 4;
+            bool hit = false;
+            for (uint32_t i = 0; i < n; i++) {
+                r = child.from_wire(r, dims);
+                const uint64_t id = util::load_le64(r);
+                r += TRAILER_BYTES;
+                if (!id || !child.intersects(query)) continue;
+                if (!leaf) {
+                    stack.push_back(id);
+                    continue;
+                }
+                const auto rec = store->read_node(persist::NodeID::from_raw(id));
+                if (rec.data && rec.size) {
+                    addPages(recordPages, rec);
+                    count.records++;
+                    hit = true;
+                }
+            }
+            count.hitLeaves += hit;
+        }
+        count.bucketPages = bucketPages.size();
+        count.recordPages = recordPages.size();
+        return count;
+    }
+
+}  // namespace
+
+class NodePlacementBenchmark : public ::testing::Test {
+protected:
+    void SetUp() override {
+        baseDir = "/tmp/xtree_placement_bench_" + std::to_string(getpid());
+        std::filesystem::remove_all(baseDir);
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    void TearDown() override {
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(baseDir);
+        ::unsetenv("XTREE_PLACEMENT_HINTS");
+    }
+
+    std::string baseDir;
+    std::vector<const char*> dimLabels = {"x", "y"};
+};
+
+TEST_F(NodePlacementBenchmark, PagesTouchedPerQuery) {
+    std::cout << "\n=== Pages Touched per Range Query vs Node Placement ===\n";
+
+    const int NUM_RECORDS = 50000;
+    const int NUM_QUERIES = 200;
+
+    std::vector<std::vector<double>> points;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> pos(0, 1000);
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        points.push_back({pos(gen), pos(gen)});
+    }
+    std::vector<std::unique_ptr<DataRecord>> queries;
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        auto query = std::make_unique<DataRecord>(2, 32, "q");
+        const double x = pos(gen), y = pos(gen);
+        std::vector<double> lo = {x, y};
+        std::vector<double> hi = {x + 50, y + 50};
+        query->putPoint(&lo);
+        query->putPoint(&hi);
+        queries.push_back(std::move(query));
+    }
+
+    auto measure = [&](bool hints) {
+        ::setenv("XTREE_PLACEMENT_HINTS", hints ? "1" : "0", 1);
+        const std::string dir = baseDir + (hints ? "/clustered" : "/scattered");
+        std::filesystem::create_directories(dir);
+        IndexDetails<DataRecord>::clearCache();
+
+        auto* index = new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, "placement_bench",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, dir);
+        index->ensure_root_initialized<DataRecord>();
+        index->getStore()->commit(0);
+        for (int i = 0; i < NUM_RECORDS; i++) {
+            auto* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            dr->putPoint(&points[i]);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+        index->flush_dirty_buckets();
+        index->getStore()->commit(0);
+
+        PageCount total;
+        const auto root = index->root_bucket<DataRecord>()->getNodeID();
+        for (auto& q : queries) {
+            const PageCount c = walk(index->getStore(), root, *q->getKey(), 2, 32);
+            total.bucketPages += c.bucketPages;
+            total.recordPages += c.recordPages;
+            total.buckets += c.buckets;
+            total.records += c.records;
+            total.hitLeaves += c.hitLeaves;
+        }
+        index->close();
+        delete index;
+        return total;
+    };
+
+    const PageCount before = measure(false);
+    const PageCount after = measure(true);
+    EXPECT_EQ(before.records, after.records);
+
+    auto perQuery = [&](size_t n) { return static_cast<double>(n) / NUM_QUERIES; };
+    std::cout << "Records: " << NUM_RECORDS << ", queries: " << NUM_QUERIES
+              << " (50 x 50 boxes in 1000 x 1000)\n\n";
+    std::cout << " Placement | Buckets/q | Bucket pages/q | Records/q | Leaves hit/q | Record pages/q | Pages/q\n";
+    std::cout << "-----------|-----------|----------------|-----------|--------------|----------------|--------\n";
+    for (const auto& [name, c] : {std::make_pair("scattered", before), std::make_pair("clustered", after)}) {
+        std::cout << std::setw(10) << name << " | "
+                  << std::setw(9) << std::fixed << std::setprecision(1) << perQuery(c.buckets) << " | "
+                  << std::setw(14) << perQuery(c.bucketPages) << " | "
+                  << std::setw(9) << perQuery(c.records) << " | "
+                  << std::setw(12) << perQuery(c.hitLeaves) << " | "
+                  << std::setw(14) << perQuery(c.recordPages) << " | "
+                  << std::setw(7) << perQuery(c.bucketPages + c.recordPages) << "\n";
+    }
+}
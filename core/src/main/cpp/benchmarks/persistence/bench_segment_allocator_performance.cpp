@@ -215,6 +215,74 @@ TEST_F(SegmentAllocatorPerformanceBenchmark, ConcurrentAllocationScaling) {
     std::cout << "\n💡 Should maintain >70% scaling efficiency up to 8 threads\n";
 }
 
+// Per-thread magazines vs the class mutex on every call. Each thread keeps a
+// sliding window of live blocks so allocs and frees interleave, as in ingest.
+TEST_F(SegmentAllocatorPerformanceBenchmark, ThreadCacheScaling) {
+    printSeparator("Thread Cache Scaling (256B alloc + free)");
+    
+    const int THREAD_COUNTS[] = {1, 2, 4, 8, 16, 32, 64};
+    const size_t OPS_TOTAL = 640000;
+    const size_t WINDOW = 256;
+    const size_t ALLOC_SIZE = 256;
+    
+    auto run = [&](size_t thread_cache_bytes, int num_threads) {
+        std::string dir = test_dir_ + "/tc_" + std::to_string(thread_cache_bytes) +
+                          "_" + std::to_string(num_threads);
+        fs::create_directories(dir);
+        StorageConfig config = StorageConfig::defaults();
+        config.thread_cache_bytes = thread_cache_bytes;
+        auto alloc = std::make_unique<SegmentAllocator>(dir, config);
+        
+        const size_t per_thread = OPS_TOTAL / num_threads;
+        std::atomic<size_t> total_allocated(0);
+        auto worker = [&]() {
+            std::vector<SegmentAllocator::Allocation> window(WINDOW);
+            size_t ok = 0;
+            for (size_t i = 0; i < per_thread; ++i) {
+                auto& slot = window[i % WINDOW];
+                if (slot.is_valid()) alloc->free(slot);
+                slot = alloc->allocate(ALLOC_SIZE);
+                if (slot.is_valid()) ok++;
+            }
+            for (auto& slot : window) {
+                if (slot.is_valid()) alloc->free(slot);
+            }
+            total_allocated += ok;
+        };
+        
+        auto start = high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto wall = duration_cast<nanoseconds>(high_resolution_clock::now() - start);
+        
+        alloc.reset();
+        fs::remove_all(dir);
+        return (total_allocated * 1e9) / wall.count();
+    };
+    
+    std::cout << "\nThreads | Locked allocs/sec | Magazine allocs/sec | Speedup\n";
+    std::cout << "--------|-------------------|---------------------|--------\n";
+    
+    for (int num_threads : THREAD_COUNTS) {
+        double locked = run(0, num_threads);
+        double cached = run(segment::kThreadCacheBytes, num_threads);
+        
+        std::cout << std::setw(7) << num_threads << " | "
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(17) << locked << " | "
+                  << std::setw(19) << cached << " | "
+                  << std::setprecision(2) << std::setw(6) << (cached / locked) << "x\n";
+    }
+    
+    std::cout << "\n💡 Magazines take the class mutex once per batch instead of per call;\n"
+              << "   the gap should widen with thread count on multi-core hosts\n";
+}
+
 TEST_F(SegmentAllocatorPerformanceBenchmark, AllocationDeallocationChurn) {
     printSeparator("Allocation/Deallocation Churn");
     
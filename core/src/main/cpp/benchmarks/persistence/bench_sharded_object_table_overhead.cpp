@@ -15,8 +15,11 @@
 #include <vector>
 #include <algorithm>
 #include <thread>
+#include "../../src/persistence/object_table.hpp"
+#include "../../src/persistence/object_table_sharded.hpp"
 
 using namespace std::chrono;
+using namespace xtree::persist;
 
 // Minimal simulation focusing on the actual overhead
 class IsolatedTest {
@@ -202,4 +205,70 @@ TEST_F(ShardedObjectTableOverheadBenchmark, IsolatedOverhead) {
     
     // Assert that overhead is reasonable
     EXPECT_LT(overhead_pct, 30.0) << "Sharding overhead should be under 30%";
-}
\ No newline at end of file
+}
+// Allocate/publish/retire cycles on the real tables, with per-thread handle
+// caches on the fast path. Ops per thread are fixed, so ideal scaling keeps
+// the per-op time flat as threads are added.
+TEST_F(ShardedObjectTableOverheadBenchmark, AllocateRetireThreadScaling) {
+    printSeparator("ObjectTable Allocate/Retire Thread Scaling");
+    const size_t ops_per_thread = 4000;
+    const std::vector<size_t> thread_counts = {1, 2, 4, 8, 16, 32, 64};
+
+    auto run = [&](auto& table, size_t threads) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                OTAddr addr{};
+                addr.length = 4096;
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    NodeID id = table.allocate(NodeKind::Leaf, 0, addr, 0);
+                    NodeID live = table.mark_live_reserve(id, 1);
+                    table.mark_live_commit(live, 1);
+                    table.retire(live, 2);
+                }
+            });
+        }
+        auto start = high_resolution_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& w : workers) w.join();
+        auto end = high_resolution_clock::now();
+        double secs = duration<double>(end - start).count();
+        return (threads * ops_per_thread) / secs / 1e6;  // Mops/s
+    };
+
+    std::cout << std::setw(10) << "Threads"
+              << std::setw(16) << "OT (Mops/s)"
+              << std::setw(12) << "Speedup"
+              << std::setw(18) << "Sharded (Mops/s)"
+              << std::setw(12) << "Speedup" << "\n";
+    std::cout << std::string(68, '-') << "\n";
+
+    double ot_base = 0, sharded_base = 0;
+    for (size_t threads : thread_counts) {
+        const size_t capacity = threads * ops_per_thread + 1024;
+
+        ObjectTable ot(capacity);
+        double ot_mops = run(ot, threads);
+        auto stats = ot.get_stats();
+        EXPECT_EQ(stats.total_allocations, threads * ops_per_thread);
+        EXPECT_EQ(stats.total_retires, threads * ops_per_thread);
+        EXPECT_EQ(ot.reclaim_before_epoch(3), threads * ops_per_thread);
+
+        ObjectTableSharded sharded(capacity);
+        double sharded_mops = run(sharded, threads);
+        EXPECT_EQ(sharded.reclaim_before_epoch(3), threads * ops_per_thread);
+
+        if (threads == 1) {
+            ot_base = ot_mops;
+            sharded_base = sharded_mops;
+        }
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << threads
+                  << std::setw(16) << ot_mops
+                  << std::setw(11) << (ot_mops / ot_base) << "x"
+                  << std::setw(18) << sharded_mops
+                  << std::setw(11) << (sharded_mops / sharded_base) << "x" << "\n";
+    }
+}
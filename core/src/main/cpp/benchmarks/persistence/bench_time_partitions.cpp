@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Time-series layout: one monolithic XTree vs one XTree per time bucket
+ *
+ * The same time-ordered records (time plus two values) go into a single
+ * durable index and into a PartitionedIndex with hourly buckets. Recent
+ * windows are then queried on both; the partitioned layout only opens the
+ * buckets a window reaches. Retention drops the older half of the history:
+ * whole partition directories are deleted, while the monolithic tree, which
+ * has no delete, must be rebuilt from the records it keeps.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include "../../src/indexdetails.hpp"
+#include "../../src/persistence/index_registry.h"
+#include "../../src/persistence/partitioned_index.h"
+
+using namespace xtree;
+using namespace xtree::persist;
+using namespace std::chrono;
+
+class TimePartitionBenchmark : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dataDir = "/tmp/xtree_time_partition_bench_" + std::to_string(getpid());
+        std::filesystem::remove_all(dataDir);
+        std::filesystem::create_directories(dataDir);
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    void TearDown() override {
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    IndexDetails<DataRecord>* openMonolithic(const std::string& name) {
+        const std::string dir = dataDir + "/" + name;
+        std::filesystem::create_directories(dir);
+        auto* index = new IndexDetails<DataRecord>(
+            3, 32, &dimLabels, nullptr, nullptr, name,
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, dir);
+        index->ensure_root_initialized<DataRecord>();
+        return index;
+    }
+
+    static DataRecord* makeRecord(const std::string& rowid, const std::vector<double>& pt) {
+        auto* dr = new DataRecord(3, 32, rowid);
+        dr->putPoint(const_cast<std::vector<double>*>(&pt));
+        return dr;
+    }
+
+    // Query box over [t0, t1] on the time axis, unbounded on the values
+    static DataRecord window(double t0, double t1) {
+        DataRecord query(3, 32, "q");
+        std::vector<double> lo = {t0, -1e9, -1e9}, hi = {t1, 1e9, 1e9};
+        query.putPoint(&lo);
+        query.putPoint(&hi);
+        return query;
+    }
+
+    static size_t count(IndexDetails<DataRecord>* index, DataRecord& query) {
+        auto* iter = index->root_bucket<DataRecord>()->getIterator(index->root_cache_node(), &query, INTERSECTS);
+        size_t rows = 0;
+        std::string_view rid;
+        while (iter->nextRowID(rid)) rows++;
+        delete iter;
+        return rows;
+    }
+
+    // Blocks actually written, not the preallocated file sizes
+    static double diskMB(const std::string& dir) {
+        uint64_t bytes = 0;
+        for (const auto& e : std::filesystem::recursive_directory_iterator(dir)) {
+            struct stat st;
+            if (e.is_regular_file() && stat(e.path().c_str(), &st) == 0) {
+                bytes += static_cast<uint64_t>(st.st_blocks) * 512;
+            }
+        }
+        return bytes / (1024.0 * 1024.0);
+    }
+
+    std::string dataDir;
+    std::vector<const char*> dimLabels = {"time", "v1", "v2"};
+};
+
+TEST_F(TimePartitionBenchmark, RecentWindowsAndRetention) {
+    std::cout << "\n=== Time-Series Windows and Retention: Monolithic vs Partitioned ===\n";
+
+    const int HOURS = 24;
+    const int PER_HOUR = 2000;
+    const double HOUR = 3600.0;
+    const double END = HOURS * HOUR;
+    const int REPEAT = 20;
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<> val(0, 100);
+    std::vector<std::vector<double>> points;
+    points.reserve(HOURS * PER_HOUR);
+    for (int i = 0; i < HOURS * PER_HOUR; i++) {
+        points.push_back({i * (HOUR / PER_HOUR), val(gen), val(gen)});
+    }
+
+    // Ingest, in time order, into both layouts
+    auto t0 = high_resolution_clock::now();
+    auto* mono = openMonolithic("monolithic");
+    for (size_t i = 0; i < points.size(); i++) {
+        mono->root_bucket<DataRecord>()->xt_insert(mono->root_cache_node(),
+                                                   makeRecord("r" + std::to_string(i), points[i]));
+    }
+    mono->flush_dirty_buckets();
+    mono->getStore()->commit(0);
+    const double monoIngestMs = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+
+    PartitionOptions options;
+    options.name = "metrics";
+    options.base_dir = dataDir + "/partitioned";
+    options.dimension = 3;
+    options.dimension_labels = {"time", "v1", "v2"};
+    options.bucket_width = HOUR;
+    PartitionedIndex parts(options);
+    t0 = high_resolution_clock::now();
+    for (size_t i = 0; i < points.size(); i++) {
+        parts.insert(makeRecord("r" + std::to_string(i), points[i]));
+    }
+    parts.commit();
+    const double partIngestMs = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+
+    std::cout << "Records: " << points.size() << " over " << HOURS << " hours, "
+              << parts.partitions().size() << " partitions\n";
+    std::cout << std::fixed << std::setprecision(1)
+              << "Ingest: monolithic " << monoIngestMs << " ms, partitioned " << partIngestMs << " ms\n\n";
+
+    std::cout << " Window    | Rows   | Mono (us) | Part (us) | Partitions scanned\n";
+    std::cout << "-----------|--------|-----------|-----------|-------------------\n";
+    for (double minutes : {15.0, 60.0, 360.0, 1440.0}) {
+        DataRecord query = window(END - minutes * 60, END);
+
+        size_t monoRows = 0, partRows = 0;
+        PartitionQueryStats stats;
+        auto m0 = high_resolution_clock::now();
+        for (int r = 0; r < REPEAT; r++) monoRows = count(mono, query);
+        const double monoUs = duration<double, std::micro>(high_resolution_clock::now() - m0).count() / REPEAT;
+
+        auto p0 = high_resolution_clock::now();
+        for (int r = 0; r < REPEAT; r++) {
+            partRows = parts.query(&query, INTERSECTS, [](std::string_view) {}, &stats);
+        }
+        const double partUs = duration<double, std::micro>(high_resolution_clock::now() - p0).count() / REPEAT;
+
+        EXPECT_EQ(monoRows, partRows);
+        std::cout << std::setw(7) << static_cast<int>(minutes) << " m | "
+                  << std::setw(6) << partRows << " | "
+                  << std::setw(9) << monoUs << " | "
+                  << std::setw(9) << partUs << " | "
+                  << stats.partitions_scanned << " of " << stats.partitions_total << "\n";
+    }
+
+    // Retention: keep the newest half
+    const double cut = END / 2;
+    DataRecord kept = window(cut, std::numeric_limits<float>::max());
+
+    const double partBeforeMB = diskMB(options.base_dir);
+    t0 = high_resolution_clock::now();
+    const size_t dropped = parts.drop_before(cut);
+    const double partDropMs = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+    const double partAfterMB = diskMB(options.base_dir);
+
+    const double monoBeforeMB = diskMB(dataDir + "/monolithic");
+    t0 = high_resolution_clock::now();
+    auto* rebuilt = openMonolithic("monolithic_kept");
+    {
+        std::vector<double> bounds(6), pt(3);
+        auto* iter = mono->root_bucket<DataRecord>()->getIterator(mono->root_cache_node(), &kept, INTERSECTS);
+        while (IDataRecord* rec = iter->nextData()) {
+            if (!rec->getExactBounds(bounds.data(), 3)) continue;
+            for (int d = 0; d < 3; d++) pt[d] = bounds[2 * d];
+            rebuilt->root_bucket<DataRecord>()->xt_insert(rebuilt->root_cache_node(),
+                                                          makeRecord(rec->getRowID(), pt));
+        }
+        delete iter;
+    }
+    rebuilt->flush_dirty_buckets();
+    rebuilt->getStore()->commit(0);
+    mono->close();
+    delete mono;
+    std::filesystem::remove_all(dataDir + "/monolithic");
+    const double monoDropMs = duration<double, std::milli>(high_resolution_clock::now() - t0).count();
+    const double monoAfterMB = diskMB(dataDir + "/monolithic_kept");
+
+    std::cout << "\nRetention (drop the older " << HOURS / 2 << " hours):\n";
+    std::cout << " Layout      | Time (ms) | Disk before (MB) | Disk after (MB)\n";
+    std::cout << "-------------|-----------|------------------|----------------\n";
+    std::cout << " monolithic  | " << std::setw(9) << monoDropMs << " | "
+              << std::setw(16) << monoBeforeMB << " | " << std::setw(14) << monoAfterMB << "\n";
+    std::cout << " partitioned | " << std::setw(9) << partDropMs << " | "
+              << std::setw(16) << partBeforeMB << " | " << std::setw(14) << partAfterMB << "\n";
+
+    EXPECT_EQ(dropped, static_cast<size_t>(HOURS / 2));
+    DataRecord all = window(-1e9, 1e9);
+    const size_t partLeft = parts.query(&all, INTERSECTS, [](std::string_view) {});
+    EXPECT_EQ(count(rebuilt, all), partLeft);
+    EXPECT_EQ(partLeft, points.size() / 2);
+
+    rebuilt->close();
+    delete rebuilt;
+}
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Cold-cache query latency with and without traversal prefetching
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/indexdetails.hpp"
+#include "../src/xtiter.h"
+
+using namespace xtree;
+using namespace std::chrono;
+
+class PrefetchBenchmark : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dataDir = "/tmp/xtree_prefetch_bench_" + std::to_string(getpid());
+        std::filesystem::remove_all(dataDir);
+        std::filesystem::create_directories(dataDir);
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    void TearDown() override {
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    IndexDetails<DataRecord>* openIndex() {
+        return new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, "prefetch_bench",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, dataDir
+        );
+    }
+
+    // Push the index files out of the OS page cache so every node read faults
+    void dropPageCache() {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dataDir)) {
+            if (!entry.is_regular_file()) continue;
+            int fd = ::open(entry.path().c_str(), O_RDONLY);
+            if (fd < 0) continue;
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+
+    std::string dataDir;
+    std::vector<const char*> dimLabels = {"x", "y"};
+};
+
+TEST_F(PrefetchBenchmark, ColdCacheQueryLatency) {
+    std::cout << "\n=== Cold-Cache Query Latency vs Prefetch Distance ===\n";
+
+    const int NUM_RECORDS = 100000;
+    const int NUM_QUERIES = 200;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> pos(0, 1000);
+
+    {
+        auto* index = openIndex();
+        index->ensure_root_initialized<DataRecord>();
+        index->getStore()->commit(0);
+        for (int i = 0; i < NUM_RECORDS; i++) {
+            auto* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            std::vector<double> pt = {pos(gen), pos(gen)};
+            dr->putPoint(&pt);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+        index->getStore()->commit(NUM_RECORDS);
+        index->close();
+        delete index;
+    }
+
+    std::vector<std::unique_ptr<DataRecord>> queries;
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        auto query = std::make_unique<DataRecord>(2, 32, "q");
+        const double x = pos(gen), y = pos(gen);
+        std::vector<double> lo = {x, y};
+        std::vector<double> hi = {x + 50, y + 50};
+        query->putPoint(&lo);
+        query->putPoint(&hi);
+        queries.push_back(std::move(query));
+    }
+
+    // One cold run: empty record cache and page cache, then every query
+    struct Run { double ms; size_t rows; uint64_t hints; };
+    auto coldRun = [&](unsigned distance) -> Run {
+        IndexDetails<DataRecord>::clearCache();
+        dropPageCache();
+        auto* index = openIndex();
+        auto* root = index->root_bucket<DataRecord>();
+        Run run{0, 0, 0};
+        if (!root) {
+            delete index;
+            return run;
+        }
+
+        Iterator<DataRecord>::setDefaultPrefetchDistance(distance);
+        auto start = high_resolution_clock::now();
+        for (auto& q : queries) {
+            auto iter = root->getPooledIterator(index->root_cache_node(), q.get(), INTERSECTS);
+            std::string_view rid;
+            while (iter->nextRowID(rid)) run.rows++;
+            run.hints += iter->storePrefetches();
+        }
+        run.ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+        index->close();
+        delete index;
+        return run;
+    };
+
+    // Distances are interleaved across rounds and the best round kept, so
+    // drift in the machine's background I/O does not favour one setting
+    const std::vector<unsigned> distances = {0, 2, 4, 8, 16};
+    const int ROUNDS = 3;
+    std::vector<Run> best(distances.size(), Run{1e300, 0, 0});
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t d = 0; d < distances.size(); d++) {
+            Run run = coldRun(distances[d]);
+            if (run.ms < best[d].ms) best[d] = run;
+        }
+    }
+
+    std::cout << "Records: " << NUM_RECORDS << ", queries: " << NUM_QUERIES
+              << ", best of " << ROUNDS << " cold runs (empty record cache and page cache)\n\n";
+    std::cout << " Distance | Total (ms) | Avg (us) | Rows     | Store hints | Speedup\n";
+    std::cout << "----------|------------|----------|----------|-------------|--------\n";
+    for (size_t d = 0; d < distances.size(); d++) {
+        EXPECT_EQ(best[d].rows, best[0].rows);
+        std::cout << std::setw(9) << distances[d] << " | "
+                  << std::setw(10) << std::fixed << std::setprecision(1) << best[d].ms << " | "
+                  << std::setw(8) << std::setprecision(1) << best[d].ms * 1000.0 / NUM_QUERIES << " | "
+                  << std::setw(8) << best[d].rows << " | "
+                  << std::setw(11) << best[d].hints << " | "
+                  << std::setw(5) << std::setprecision(2) << best[0].ms / best[d].ms << "x\n";
+    }
+    Iterator<DataRecord>::setDefaultPrefetchDistance(XTREE_PREFETCH_DISTANCE);
+}
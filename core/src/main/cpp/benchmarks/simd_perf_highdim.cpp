@@ -5,6 +5,8 @@
 #include <vector>
 #include <iomanip>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 #include "../src/util/cpu_features.h"
 #include "../src/util/float_utils.h"
 
@@ -33,6 +35,17 @@ namespace xtree {
         bool intersects_avx2(const int32_t* box1, const int32_t* box2, int dimensions);
         void expand_avx2(int32_t* target, const int32_t* source, int dimensions);
         void expand_point_avx2(int32_t* box, const double* point, int dimensions);
+        
+        // Scalar-only and AVX-512 kernels
+        bool contains_scalar(const int32_t* outer, const int32_t* inner, int dimensions);
+        double area_scalar(const float* box, int dimensions);
+        double overlap_scalar(const float* box1, const float* box2, int dimensions);
+        bool intersects_avx512(const int32_t* box1, const int32_t* box2, int dimensions);
+        bool contains_avx512(const int32_t* outer, const int32_t* inner, int dimensions);
+        void expand_avx512(int32_t* target, const int32_t* source, int dimensions);
+        void expand_point_avx512(int32_t* box, const double* point, int dimensions);
+        double area_avx512(const float* box, int dimensions);
+        double overlap_avx512(const float* box1, const float* box2, int dimensions);
     }
 }
 
@@ -55,7 +68,8 @@ TEST_F(SIMDHighDimBenchmark, PerformanceAnalysis) {
     // Get CPU features
     const auto& features = CPUFeatures::get();
     std::cout << "CPU Features: SSE2=" << features.has_sse2 
-              << " AVX2=" << features.has_avx2 << std::endl << std::endl;
+              << " AVX2=" << features.has_avx2
+              << " AVX-512=" << features.has_avx512() << std::endl << std::endl;
     
     // Test with a comprehensive range of dimensions
     std::vector<int> dimensions_to_test = {1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 16, 20, 24, 32, 48, 64, 96, 128};
@@ -70,34 +84,81 @@ TEST_F(SIMDHighDimBenchmark, PerformanceAnalysis) {
     auto optimal_expand = get_optimal_expand_func();
     auto optimal_expand_point = get_optimal_expand_point_func();
     
-    // Determine SIMD type being used
+    // The pre-AVX-512 tier gets its own column so the 512-bit kernels are
+    // measured against what they replace, not just against scalar
     std::string simd_type = "Scalar";
-    if (features.has_avx2 && optimal_intersects == simd_impl::intersects_avx2) {
+    intersects_func_t base_intersects = simd_impl::intersects_scalar;
+    expand_func_t base_expand = simd_impl::expand_scalar;
+    expand_point_func_t base_expand_point = simd_impl::expand_point_scalar;
+    if (features.has_avx2) {
         simd_type = "AVX2";
-    } else if (features.has_sse2 && optimal_intersects == simd_impl::intersects_sse2) {
+        base_intersects = simd_impl::intersects_avx2;
+        base_expand = simd_impl::expand_avx2;
+        base_expand_point = simd_impl::expand_point_avx2;
+    } else if (features.has_sse2) {
         simd_type = "SSE2";
+        base_intersects = simd_impl::intersects_sse2;
+        base_expand = simd_impl::expand_sse2;
+        base_expand_point = simd_impl::expand_point_sse2;
     }
+    const bool avx512 = features.has_avx512();
     
-    std::cout << "Using SIMD: " << simd_type << std::endl << std::endl;
+    std::cout << "Using SIMD: " << simd_type << (avx512 ? " + AVX-512" : "") << std::endl << std::endl;
     
     // Print header
     std::cout << std::setw(10) << "Dimensions" 
               << std::setw(20) << "Operation"
               << std::setw(15) << "Scalar (μs)"
               << std::setw(15) << simd_type + " (μs)"
+              << std::setw(15) << "AVX-512 (μs)"
               << std::setw(12) << "Speedup"
               << std::setw(15) << "Recommendation" << std::endl;
-    std::cout << std::string(92, '-') << std::endl;
+    std::cout << std::string(107, '-') << std::endl;
+    
+    // Times `iterations` calls of body(i) over the test cases, in microseconds
+    auto time_us = [&](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            body(i % num_test_cases);
+        }
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        return (double)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    };
+    
+    // Speedup is the best available tier over scalar; a negative time is "n/a"
+    auto print_row = [&](int dimensions, const char* operation,
+                         double scalar_us, double simd_us, double avx512_us) {
+        double best = scalar_us;
+        if (simd_us >= 0) best = std::min(best, simd_us);
+        if (avx512_us >= 0) best = std::min(best, avx512_us);
+        double speedup = scalar_us / std::max(best, 1.0);
+        auto cell = [](double us) {
+            std::ostringstream os;
+            if (us < 0) os << "-"; else os << std::fixed << std::setprecision(0) << us;
+            return os.str();
+        };
+        std::cout << std::setw(10) << (dimensions > 0 ? std::to_string(dimensions) : "")
+                  << std::setw(20) << operation
+                  << std::setw(15) << cell(scalar_us)
+                  << std::setw(15) << cell(simd_us)
+                  << std::setw(15) << cell(avx512_us)
+                  << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
+                  << std::setw(15) << (speedup > 1.1 ? "Use SIMD" : "Use Scalar") << std::endl;
+    };
     
     for (int dimensions : dimensions_to_test) {
         // Generate test data for intersects/expand
         std::vector<std::vector<int32_t>> boxes1(num_test_cases);
         std::vector<std::vector<int32_t>> boxes2(num_test_cases);
+        std::vector<std::vector<float>> fboxes1(num_test_cases);
+        std::vector<std::vector<float>> fboxes2(num_test_cases);
         std::vector<std::vector<double>> points(num_test_cases);
         
         for (int i = 0; i < num_test_cases; i++) {
             boxes1[i].resize(dimensions * 2);
             boxes2[i].resize(dimensions * 2);
+            fboxes1[i].resize(dimensions * 2);
+            fboxes2[i].resize(dimensions * 2);
             points[i].resize(dimensions);
             
             for (int d = 0; d < dimensions; d++) {
@@ -106,11 +167,15 @@ TEST_F(SIMDHighDimBenchmark, PerformanceAnalysis) {
                 float max1 = min1 + std::abs(real_dist(rng));
                 boxes1[i][d * 2] = floatToSortableInt(min1);
                 boxes1[i][d * 2 + 1] = floatToSortableInt(max1);
+                fboxes1[i][d * 2] = min1;
+                fboxes1[i][d * 2 + 1] = max1;
                 
                 float min2 = real_dist(rng);
                 float max2 = min2 + std::abs(real_dist(rng));
                 boxes2[i][d * 2] = floatToSortableInt(min2);
                 boxes2[i][d * 2 + 1] = floatToSortableInt(max2);
+                fboxes2[i][d * 2] = min2;
+                fboxes2[i][d * 2 + 1] = max2;
                 
                 // Generate point
                 points[i][d] = real_dist(rng);
@@ -119,121 +184,102 @@ TEST_F(SIMDHighDimBenchmark, PerformanceAnalysis) {
         
         // Test INTERSECTS
         {
-            // Scalar
-            auto start = std::chrono::high_resolution_clock::now();
-            int scalar_matches = 0;
-            for (int i = 0; i < iterations; i++) {
-                const auto& box1 = boxes1[i % num_test_cases];
-                const auto& box2 = boxes2[i % num_test_cases];
-                if (simd_impl::intersects_scalar(box1.data(), box2.data(), dimensions)) {
-                    scalar_matches++;
-                }
-            }
-            auto scalar_time = std::chrono::high_resolution_clock::now() - start;
-            
-            // SIMD
-            start = std::chrono::high_resolution_clock::now();
-            int simd_matches = 0;
-            for (int i = 0; i < iterations; i++) {
-                const auto& box1 = boxes1[i % num_test_cases];
-                const auto& box2 = boxes2[i % num_test_cases];
-                if (optimal_intersects(box1.data(), box2.data(), dimensions)) {
-                    simd_matches++;
-                }
-            }
-            auto simd_time = std::chrono::high_resolution_clock::now() - start;
-            
-            double scalar_us = std::chrono::duration_cast<std::chrono::microseconds>(scalar_time).count();
-            double simd_us = std::chrono::duration_cast<std::chrono::microseconds>(simd_time).count();
-            double speedup = scalar_us / simd_us;
+            int scalar_matches = 0, simd_matches = 0, avx512_matches = 0;
+            double scalar_us = time_us([&](int i) {
+                scalar_matches += simd_impl::intersects_scalar(boxes1[i].data(), boxes2[i].data(), dimensions);
+            });
+            double simd_us = time_us([&](int i) {
+                simd_matches += base_intersects(boxes1[i].data(), boxes2[i].data(), dimensions);
+            });
+            double avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                avx512_matches += simd_impl::intersects_avx512(boxes1[i].data(), boxes2[i].data(), dimensions);
+            });
+            print_row(dimensions, "intersects", scalar_us, simd_us, avx512_us);
             
-            std::cout << std::setw(10) << dimensions
-                      << std::setw(20) << "intersects"
-                      << std::setw(15) << std::fixed << std::setprecision(0) << scalar_us
-                      << std::setw(15) << simd_us
-                      << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
-                      << std::setw(15) << (speedup > 1.1 ? "Use SIMD" : "Use Scalar") << std::endl;
-            
-            if (scalar_matches != simd_matches) {
+            if (scalar_matches != simd_matches || (avx512 && scalar_matches != avx512_matches)) {
                 std::cerr << "ERROR: Intersects results don't match!" << std::endl;
                 FAIL() << "Intersects results don't match!";
             }
         }
         
+        // Test CONTAINS (scalar or AVX-512 only)
+        {
+            int scalar_matches = 0, avx512_matches = 0;
+            double scalar_us = time_us([&](int i) {
+                scalar_matches += simd_impl::contains_scalar(boxes1[i].data(), boxes2[i].data(), dimensions);
+            });
+            double avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                avx512_matches += simd_impl::contains_avx512(boxes1[i].data(), boxes2[i].data(), dimensions);
+            });
+            print_row(0, "contains", scalar_us, -1, avx512_us);
+            if (avx512 && scalar_matches != avx512_matches) {
+                FAIL() << "Contains results don't match!";
+            }
+        }
+        
         // Test EXPAND
         {
             // Make copies for testing
-            std::vector<std::vector<int32_t>> target_scalar(num_test_cases);
-            std::vector<std::vector<int32_t>> target_simd(num_test_cases);
-            for (int i = 0; i < num_test_cases; i++) {
-                target_scalar[i] = boxes1[i];
-                target_simd[i] = boxes1[i];
-            }
+            std::vector<std::vector<int32_t>> target_scalar = boxes1;
+            std::vector<std::vector<int32_t>> target_simd = boxes1;
+            std::vector<std::vector<int32_t>> target_avx512 = boxes1;
             
-            // Scalar
-            auto start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < iterations; i++) {
-                int idx = i % num_test_cases;
-                simd_impl::expand_scalar(target_scalar[idx].data(), boxes2[idx].data(), dimensions);
-            }
-            auto scalar_time = std::chrono::high_resolution_clock::now() - start;
+            double scalar_us = time_us([&](int i) {
+                simd_impl::expand_scalar(target_scalar[i].data(), boxes2[i].data(), dimensions);
+            });
+            double simd_us = time_us([&](int i) {
+                base_expand(target_simd[i].data(), boxes2[i].data(), dimensions);
+            });
+            double avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                simd_impl::expand_avx512(target_avx512[i].data(), boxes2[i].data(), dimensions);
+            });
+            print_row(0, "expand", scalar_us, simd_us, avx512_us);
             
-            // SIMD
-            start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < iterations; i++) {
-                int idx = i % num_test_cases;
-                optimal_expand(target_simd[idx].data(), boxes2[idx].data(), dimensions);
+            if (target_simd != target_scalar || (avx512 && target_avx512 != target_scalar)) {
+                FAIL() << "Expand results don't match!";
             }
-            auto simd_time = std::chrono::high_resolution_clock::now() - start;
-            
-            double scalar_us = std::chrono::duration_cast<std::chrono::microseconds>(scalar_time).count();
-            double simd_us = std::chrono::duration_cast<std::chrono::microseconds>(simd_time).count();
-            double speedup = scalar_us / simd_us;
-            
-            std::cout << std::setw(10) << ""
-                      << std::setw(20) << "expand"
-                      << std::setw(15) << std::fixed << std::setprecision(0) << scalar_us
-                      << std::setw(15) << simd_us
-                      << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
-                      << std::setw(15) << (speedup > 1.1 ? "Use SIMD" : "Use Scalar") << std::endl;
         }
         
         // Test EXPAND_POINT
         {
             // Make copies for testing
-            std::vector<std::vector<int32_t>> box_scalar(num_test_cases);
-            std::vector<std::vector<int32_t>> box_simd(num_test_cases);
-            for (int i = 0; i < num_test_cases; i++) {
-                box_scalar[i] = boxes1[i];
-                box_simd[i] = boxes1[i];
-            }
+            std::vector<std::vector<int32_t>> box_scalar = boxes1;
+            std::vector<std::vector<int32_t>> box_simd = boxes1;
+            std::vector<std::vector<int32_t>> box_avx512 = boxes1;
             
-            // Scalar
-            auto start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < iterations; i++) {
-                int idx = i % num_test_cases;
-                simd_impl::expand_point_scalar(box_scalar[idx].data(), points[idx].data(), dimensions);
-            }
-            auto scalar_time = std::chrono::high_resolution_clock::now() - start;
+            double scalar_us = time_us([&](int i) {
+                simd_impl::expand_point_scalar(box_scalar[i].data(), points[i].data(), dimensions);
+            });
+            double simd_us = time_us([&](int i) {
+                base_expand_point(box_simd[i].data(), points[i].data(), dimensions);
+            });
+            double avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                simd_impl::expand_point_avx512(box_avx512[i].data(), points[i].data(), dimensions);
+            });
+            print_row(0, "expand_point", scalar_us, simd_us, avx512_us);
             
-            // SIMD
-            start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < iterations; i++) {
-                int idx = i % num_test_cases;
-                optimal_expand_point(box_simd[idx].data(), points[idx].data(), dimensions);
+            if (box_simd != box_scalar || (avx512 && box_avx512 != box_scalar)) {
+                FAIL() << "Expand_point results don't match!";
             }
-            auto simd_time = std::chrono::high_resolution_clock::now() - start;
-            
-            double scalar_us = std::chrono::duration_cast<std::chrono::microseconds>(scalar_time).count();
-            double simd_us = std::chrono::duration_cast<std::chrono::microseconds>(simd_time).count();
-            double speedup = scalar_us / simd_us;
+        }
+        
+        // Test AREA and OVERLAP on float boxes (scalar or AVX-512 only)
+        {
+            double sink = 0;
+            double scalar_us = time_us([&](int i) { sink += simd_impl::area_scalar(fboxes1[i].data(), dimensions); });
+            double avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                sink += simd_impl::area_avx512(fboxes1[i].data(), dimensions);
+            });
+            print_row(0, "area", scalar_us, -1, avx512_us);
             
-            std::cout << std::setw(10) << ""
-                      << std::setw(20) << "expand_point"
-                      << std::setw(15) << std::fixed << std::setprecision(0) << scalar_us
-                      << std::setw(15) << simd_us
-                      << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
-                      << std::setw(15) << (speedup > 1.1 ? "Use SIMD" : "Use Scalar") << std::endl;
+            scalar_us = time_us([&](int i) {
+                sink += simd_impl::overlap_scalar(fboxes1[i].data(), fboxes2[i].data(), dimensions);
+            });
+            avx512_us = !avx512 ? -1 : time_us([&](int i) {
+                sink += simd_impl::overlap_avx512(fboxes1[i].data(), fboxes2[i].data(), dimensions);
+            });
+            print_row(0, "overlap", scalar_us, -1, avx512_us);
+            EXPECT_FALSE(std::isnan(sink));
         }
         
         std::cout << std::endl;
@@ -376,7 +422,8 @@ TEST_F(SIMDHighDimBenchmark, PerformanceAnalysis) {
     }
     
     // Summary of crossover points
-    std::cout << "\nSUMMARY - Analysis for " << simd_type << ":" << std::endl;
+    // The crossover runs use the dispatched kernels, AVX-512 when present
+    std::cout << "\nSUMMARY - Analysis for " << (avx512 ? "AVX-512" : simd_type) << ":" << std::endl;
     std::cout << "==========================================" << std::endl;
     
     auto print_analysis = [](const std::string& op_name, const CrossoverInfo& info) {
@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Spatial join benchmark: synchronized traversal vs one query per record
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/indexdetails.hpp"
+#include "../src/xtiter.h"
+#include "../src/xtjoin.h"
+
+using namespace xtree;
+using namespace std::chrono;
+
+class SpatialJoinBenchmark : public ::testing::Test {
+protected:
+    void TearDown() override {
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    IndexDetails<DataRecord>* createIndex(const char* field) {
+        auto* index = new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, field,
+            IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY
+        );
+        index->ensure_root_initialized<DataRecord>();
+        return index;
+    }
+
+    void insertBox(IndexDetails<DataRecord>* index, const std::string& id,
+                   double x, double y, double w, double h) {
+        DataRecord* dr = XAlloc<DataRecord>::allocate_record(index, 2, 32, id);
+        std::vector<double> lo = {x, y};
+        std::vector<double> hi = {x + w, y + h};
+        dr->putPoint(&lo);
+        dr->putPoint(&hi);
+        index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+    }
+
+    std::vector<const char*> dimLabels = {"x", "y"};
+};
+
+// "Events within delivery zones": points joined against small boxes
+TEST_F(SpatialJoinBenchmark, JoinVsNestedLoopQueries) {
+    std::cout << "\n=== Spatial Join vs Nested-Loop Queries ===\n";
+
+    const int NUM_EVENTS = 100000;
+    const int NUM_ZONES = 10000;
+    const double EXTENT = 1000.0;
+
+    auto* events = createIndex("join_events");
+    auto* zones = createIndex("join_zones");
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> pos(0, EXTENT);
+    std::uniform_real_distribution<> size(2.0, 12.0);
+    std::vector<std::pair<double, double>> eventPoints;
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        eventPoints.emplace_back(pos(gen), pos(gen));
+        insertBox(events, "event_" + std::to_string(i), eventPoints.back().first,
+                  eventPoints.back().second, 0, 0);
+    }
+    for (int i = 0; i < NUM_ZONES; i++) {
+        insertBox(zones, "zone_" + std::to_string(i), pos(gen), pos(gen), size(gen), size(gen));
+    }
+    auto* zoneRoot = zones->root_cache_node();
+    auto* zoneBucket = zones->root_bucket<DataRecord>();
+    std::cout << "Events: " << NUM_EVENTS << ", zones: " << NUM_ZONES << "\n\n";
+
+    // Baseline: one INTERSECTS query against the zones per event
+    size_t baselinePairs = 0;
+    DataRecord query(2, 32, "q");
+    auto start = high_resolution_clock::now();
+    for (const auto& p : eventPoints) {
+        query.getKey()->reset();
+        std::vector<double> pt = {p.first, p.second};
+        query.getKey()->expandWithPoint(&pt);
+        auto iter = zoneBucket->getIterator(zoneRoot, &query, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) baselinePairs++;
+        delete iter;
+    }
+    double baselineMs = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+
+    std::cout << "   Method  | Threads | Time (ms) |  Pairs  | Speedup | Node pairs\n";
+    std::cout << "-----------|---------|-----------|---------|---------|-----------\n";
+    std::cout << std::setw(10) << "nested" << " | "
+              << std::setw(7) << 1 << " | "
+              << std::setw(9) << std::fixed << std::setprecision(1) << baselineMs << " | "
+              << std::setw(7) << baselinePairs << " | "
+              << std::setw(6) << std::setprecision(2) << 1.0 << "x | "
+              << std::setw(10) << "-" << "\n";
+
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts = {1};
+    for (size_t t = 2; t <= hw; t *= 2) threadCounts.push_back(t);
+
+    for (size_t threads : threadCounts) {
+        SpatialJoinExecutor<DataRecord> join(events, zones, threads);
+        start = high_resolution_clock::now();
+        const uint64_t pairs = join.join(events->root_cache_node(), zoneRoot,
+                                         [](std::string_view, std::string_view) {});
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+        EXPECT_EQ(pairs, baselinePairs);
+
+        std::cout << std::setw(10) << "join" << " | "
+                  << std::setw(7) << threads << " | "
+                  << std::setw(9) << std::setprecision(1) << ms << " | "
+                  << std::setw(7) << pairs << " | "
+                  << std::setw(6) << std::setprecision(2) << baselineMs / ms << "x | "
+                  << std::setw(10) << join.lastNodePairs() << "\n";
+    }
+
+    // Distance join: events within 5 units of a zone
+    SpatialJoinExecutor<DataRecord> join(events, zones, hw);
+    start = high_resolution_clock::now();
+    const uint64_t near = join.joinWithinDistance(events->root_cache_node(), zoneRoot, 5.0,
+                                                  [](std::string_view, std::string_view) {});
+    double ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    EXPECT_GE(near, baselinePairs);
+    std::cout << std::setw(10) << "within 5" << " | "
+              << std::setw(7) << hw << " | "
+              << std::setw(9) << std::setprecision(1) << ms << " | "
+              << std::setw(7) << near << " | "
+              << std::setw(7) << "-" << " | "
+              << std::setw(10) << join.lastNodePairs() << "\n";
+
+    delete events;
+    delete zones;
+}
@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <string>
 
+#include "util/miss_ratio_curve.h"
+
 #ifdef _WIN32
 #include <windows.h>
 #elif defined(__APPLE__)
@@ -61,6 +63,15 @@ public:
         (void)currentMemory;
         (void)hitRate;
     }
+
+    /**
+     * Called periodically with the cache's miss ratio curve so adaptive
+     * policies can size the budget from estimated hit rates directly.
+     * @param curve Sampled reuse-distance histogram of the cache
+     */
+    virtual void onCurve(const MissRatioCurve& curve) {
+        (void)curve;
+    }
 };
 
 // ============================================================================
@@ -215,7 +226,9 @@ private:
 
 /**
  * Adaptive policy that adjusts based on cache hit rate.
- * Increases budget when hit rate is low, decreases when high.
+ * With a miss ratio curve (onCurve), jumps straight to the smallest budget
+ * estimated to reach the target hit rate. Without one (onTick), increases
+ * budget when hit rate is low and decreases it when high.
  * Best for: Dynamic workloads where optimal cache size isn't known.
  */
 class AdaptiveCachePolicy : public CachePolicy {
@@ -253,7 +266,20 @@ public:
         }
     }
 
+    void onCurve(const MissRatioCurve& curve) override {
+        // Too few sampled reuses for a trustworthy curve - keep onTick's nudging
+        if (curve.sampledReuses() < MIN_CURVE_REUSES) return;
+
+        double bytes = curve.bytesForHitRatio(targetHitRate_);
+        if (bytes <= 0.0) return;
+
+        size_t newBudget = std::clamp(static_cast<size_t>(bytes), minBudget_, maxBudget_);
+        currentBudget_.store(newBudget, std::memory_order_relaxed);
+    }
+
 private:
+    static constexpr uint64_t MIN_CURVE_REUSES = 64;
+
     size_t minBudget_;
     size_t maxBudget_;
     double targetHitRate_;
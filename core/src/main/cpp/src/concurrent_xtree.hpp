@@ -58,11 +58,13 @@ public:
     
     /**
      * Concurrent search operation
-     * Multiple searches can run in parallel
+     * Multiple searches can run in parallel. The underlying Iterator comes
+     * from the thread's IteratorPool; construct a ConcurrentIterator on the
+     * stack rather than through search() to keep the query allocation-free.
      */
     class ConcurrentIterator {
     private:
-        Iterator<Record>* iter_;
+        PooledIterator<Record> iter_;
         ConcurrentXTree* tree_;
         typename ConcurrentCompactAllocator::ReadEpochGuard epoch_guard_;
         
@@ -75,11 +77,11 @@ public:
             tree_->active_searches_.fetch_add(1);
             
             // Create iterator on root
-            iter_ = tree_->root_->getIterator(tree_->root_cache_node_, searchKey, queryType);
+            iter_ = tree_->root_->getPooledIterator(tree_->root_cache_node_, searchKey, queryType);
         }
         
         ~ConcurrentIterator() {
-            delete iter_;
+            iter_ = PooledIterator<Record>();
             tree_->active_searches_.fetch_sub(1);
         }
         
@@ -48,4 +48,26 @@ namespace xtree {
 #define XTREE_ITER_PAGE_SIZE 100  // Reduced from 400 for faster iterator creation
 #endif
 
+// Inline capacity of an Iterator's traversal stack and record queue; both
+// spill to the heap beyond this (the queue size must be a power of two)
+#ifndef XTREE_ITER_STACK_INLINE
+#define XTREE_ITER_STACK_INLINE 128
+#endif
+
+#ifndef XTREE_ITER_QUEUE_INLINE
+#define XTREE_ITER_QUEUE_INLINE 256
+#endif
+
+// Children an Iterator prefetches ahead of the one it is expanding: CPU
+// prefetch for in-memory keys and nodes, MADV_WILLNEED for uncached
+// DURABLE nodes. 0 disables prefetching
+#ifndef XTREE_PREFETCH_DISTANCE
+#define XTREE_PREFETCH_DISTANCE 4
+#endif
+
+// Idle iterators kept per thread by IteratorPool
+#ifndef XTREE_ITER_POOL_SIZE
+#define XTREE_ITER_POOL_SIZE 8
+#endif
+
 }
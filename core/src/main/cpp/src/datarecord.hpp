@@ -55,6 +55,89 @@ struct IDataRecord {
         auto v = getRowIDView(); 
         return std::string(v.data(), v.size()); 
     }
+
+    /**
+     * Exact (double precision) bounding box of the record's points, written
+     * as min/max pairs per axis like KeyMBR. Unlike getKey(), which is
+     * rounded out to float, this is what exact refinement compares against.
+     * @return false if the record has no points
+     */
+    virtual bool getExactBounds(double* minmax, unsigned short dims) const = 0;
+};
+
+/**
+ * DataRecordWire: layout of a serialized DataRecord
+ *
+ * Format: keyMBR (dims*2 float LE) + rowid_len(2) + rowid + num_points(2)
+ *         + point_data (num_points*dims double LE)
+ *
+ * Shared by DataRecordView and by readers that scan wire bytes directly
+ * without constructing a view.
+ */
+struct DataRecordWire {
+    struct Layout {
+        size_t rowid_off = 0;
+        uint16_t rowid_len = 0;
+        size_t points_off = 0;
+        uint16_t points_count = 0;
+    };
+
+    // Bounds-checked parse of the section offsets. Returns false if the
+    // bytes are too short for the lengths they declare.
+    static bool parse(const uint8_t* data, size_t size, unsigned short dims, Layout& out) {
+        auto ensure = [size](size_t offset, size_t need) {
+            return need <= size && offset <= size - need;
+        };
+        size_t off = 0;
+
+        const size_t mbr_bytes = static_cast<size_t>(dims) * 2 * sizeof(float);
+        if (!ensure(off, mbr_bytes)) return false;
+        off += mbr_bytes;
+
+        if (!ensure(off, 2)) return false;
+        const uint16_t rid_len = util::load_le16(data + off);
+        off += 2;
+        if (!ensure(off, rid_len)) return false;
+        out.rowid_off = off;
+        out.rowid_len = rid_len;
+        off += rid_len;
+
+        if (!ensure(off, 2)) return false;
+        const uint16_t npts = util::load_le16(data + off);
+        off += 2;
+        out.points_off = off;
+        out.points_count = npts;
+
+        return ensure(off, static_cast<size_t>(npts) * dims * sizeof(double));
+    }
+
+    static std::string_view rowid(const uint8_t* data, const Layout& layout) {
+        return std::string_view(reinterpret_cast<const char*>(data + layout.rowid_off),
+                                layout.rowid_len);
+    }
+
+    // Record MBR as stored (dims*2 floats, min/max per axis)
+    static void key(const uint8_t* data, unsigned short dims, float* out) {
+        for (unsigned short i = 0; i < dims * 2; ++i) {
+            out[i] = util::load_lef32(data + i * sizeof(float));
+        }
+    }
+
+    static bool exactBounds(const uint8_t* data, const Layout& layout,
+                            unsigned short dims, double* minmax) {
+        if (layout.points_count == 0) return false;
+        const uint8_t* ptr = data + layout.points_off;
+        for (uint16_t p = 0; p < layout.points_count; ++p) {
+            for (unsigned short d = 0; d < dims; ++d) {
+                double coord;
+                std::memcpy(&coord, ptr, sizeof(double));
+                ptr += sizeof(double);
+                if (p == 0 || coord < minmax[2 * d]) minmax[2 * d] = coord;
+                if (p == 0 || coord > minmax[2 * d + 1]) minmax[2 * d + 1] = coord;
+            }
+        }
+        return true;
+    }
 };
 
 /**
@@ -105,6 +188,18 @@ public:
         return _points;
     }
 
+    bool getExactBounds(double* minmax, unsigned short dims) const override {
+        if (_points.empty()) return false;
+        for (size_t p = 0; p < _points.size(); ++p) {
+            for (unsigned short d = 0; d < dims && d < _points[p].size(); ++d) {
+                const double coord = _points[p][d];
+                if (p == 0 || coord < minmax[2 * d]) minmax[2 * d] = coord;
+                if (p == 0 || coord > minmax[2 * d + 1]) minmax[2 * d + 1] = coord;
+            }
+        }
+        return true;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const DataRecord dr) {
         os << "This DataRecord has " << dr._points.size() << "points";
         return os;
@@ -289,6 +384,12 @@ public:
     }
     // getRowID() inherits default implementation from IDataRecord
     
+    bool getExactBounds(double* minmax, unsigned short dims) const override {
+        std::call_once(layout_once_, [this]() { compute_layout(); });
+        if (!layout_ok_ || dims != dims_) return false;
+        return DataRecordWire::exactBounds(data_, layout(), dims_, minmax);
+    }
+    
     // For queries that need points (expensive - parses on demand)
     std::vector<std::vector<double>> getPoints() const {
         std::call_once(points_once_, [this]() {
@@ -324,51 +425,22 @@ private:
     
     // Precompute layout offsets once to avoid repeated scans
     void compute_layout() const {
-        
-        size_t off = 0;
-        
-        // MBR section
-        const size_t mbr_bytes = static_cast<size_t>(dims_) * 2 * sizeof(float);
-        if (!ensure(off, mbr_bytes)) { 
-            layout_ok_ = false; 
-            return; 
-        }
-        off += mbr_bytes;
-        
-        // Rowid section
-        if (!ensure(off, 2)) { 
-            layout_ok_ = false; 
-            return; 
-        }
-        uint16_t rid_len = util::load_le16(data_ + off);
-        off += 2;
-        
-        if (!ensure(off, rid_len)) { 
-            layout_ok_ = false; 
-            return; 
-        }
-        rowid_off_ = off;
-        rowid_len_ = rid_len;
-        off += rid_len;
-        
-        // Points section
-        if (!ensure(off, 2)) { 
-            layout_ok_ = false; 
-            return; 
-        }
-        uint16_t npts = util::load_le16(data_ + off);
-        off += 2;
-        
-        points_off_ = off;
-        points_count_ = npts;
-        
-        const size_t pts_bytes = static_cast<size_t>(npts) * dims_ * sizeof(double);
-        if (!ensure(off, pts_bytes)) { 
-            layout_ok_ = false; 
-            return; 
-        }
-        
-        layout_ok_ = true;
+        DataRecordWire::Layout l;
+        layout_ok_ = DataRecordWire::parse(data_, size_, dims_, l);
+        if (!layout_ok_) return;
+        rowid_off_ = l.rowid_off;
+        rowid_len_ = l.rowid_len;
+        points_off_ = l.points_off;
+        points_count_ = l.points_count;
+    }
+    
+    DataRecordWire::Layout layout() const {
+        DataRecordWire::Layout l;
+        l.rowid_off = rowid_off_;
+        l.rowid_len = rowid_len_;
+        l.points_off = points_off_;
+        l.points_count = points_count_;
+        return l;
     }
     
     void parse_points_from_wire() const {
@@ -87,7 +87,7 @@ void IndexDetails<Record>::initializeDurableStore(const std::string& data_dir, b
         if (root_id.raw() != 0) {
             // Set the recovered root NodeID so it can be lazily loaded on first access
             root_node_id_ = root_id;
-            root_cache_key_ = root_id.raw();
+            root_cache_key_ = cacheKey(root_id);
             // root_cn_ stays nullptr - will be lazily loaded by root_cache_node()
 
             std::cout << "[IndexDetails::initializeDurableStore] Recovered root NodeID: "
@@ -33,6 +33,7 @@
 #include "xtree_allocator_traits.hpp"  // For XAlloc
 #include "cache_policy.hpp"  // Cache memory policies
 #include "persistence/memory_coordinator.h"  // Adaptive memory coordination
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <atomic>
@@ -95,6 +96,9 @@ namespace xtree {
 
             IndexDetails<Record>::indexes.push_back(this);
 
+            // Per-field cache accounting handle (stable for the cache's lifetime)
+            cache_field_ = getCache().fieldHandle(field_name_);
+
             // Initialize persistence based on mode
             switch (mode) {
                 case PersistenceMode::IN_MEMORY:
@@ -107,6 +111,7 @@ namespace xtree {
                     break;
 
                 case PersistenceMode::DURABLE:
+                    cache_key_salt_ = acquireCacheKeySalt();
                     // Initialize the new durable store with MVCC and crash recovery
                     initializeDurableStore(data_dir, read_only);
                     break;
@@ -150,6 +155,7 @@ namespace xtree {
                 // Skip flushing and committing in read-only mode
                 if (!read_only_) {
                     // Flush any pending dirty buckets before final commit
+                    flush_stale_counts();
                     flush_dirty_buckets();
 
                     // Final commit to ensure all data is persisted
@@ -174,8 +180,14 @@ namespace xtree {
 
             // NOTE: We do NOT call getCache().clear() here because the cache is global
             // and shared across all IndexDetails instances. Clearing it would invalidate
-            // entries from other indexes that are still open.
-            // TODO: Implement per-index cache cleanup that only removes this index's entries.
+            // entries from other indexes that are still open. A durable index can tell
+            // its own entries apart by the cache key slot, so only those are dropped.
+            if (cache_key_salt_ != 0) {
+                const uint64_t salt = cache_key_salt_;
+                getCache().removeIf([salt](const UniqueId& key) {
+                    return (static_cast<uint64_t>(key) & CACHE_KEY_MASK) == salt;
+                });
+            }
 
             // Clear root references
             root_cache_key_ = 0;
@@ -199,6 +211,7 @@ namespace xtree {
             // Ensure proper cleanup by calling close()
             // This unpins the root, clears the cache, and commits data
             close();
+            releaseCacheKeySalt(cache_key_salt_);
         }
 
         unsigned short getDimensionCount() const {
@@ -362,6 +375,57 @@ namespace xtree {
             // keep root_node_id_ so lazy rebuild knows what to load
         }
 
+        // ========== Read-Only Replica ==========
+        // A read-only DURABLE index can follow a writer process on the same
+        // data directory. start_replica() tails the writer's commits in the
+        // background; refresh_replica() makes queries see them.
+
+        bool start_replica(const persist::ReplicaOptions& options = {}) {
+            return read_only_ && runtime_ && runtime_->start_replica(options);
+        }
+
+        void stop_replica() {
+            if (runtime_) runtime_->stop_replica();
+        }
+
+        // Switch to the newest commit the replica has applied: drops cached
+        // nodes the writer changed and reloads the root on next access.
+        // Call between queries; it must not overlap a query on this index.
+        // Without start_replica() it catches up inline first. Returns true if
+        // the index moved to a newer commit.
+        bool refresh_replica() {
+            if (!read_only_ || !runtime_ || !store_) {
+                return false;
+            }
+            if (runtime_->replica_generation() == replica_generation_) {
+                runtime_->catch_up();  // no-op while the background tailer is running
+            }
+            const uint64_t generation = runtime_->replica_generation();
+            if (generation == replica_generation_) {
+                return false;
+            }
+            replica_generation_ = generation;
+
+            // Parents reach children by NodeID lookup in read-only mode, so
+            // evicting a changed node is enough for it to be reloaded
+            auto& cache = getCache();
+            for (uint64_t raw : runtime_->take_replica_changes()) {
+                if (auto* cn = cache.find(cacheKey(persist::NodeID::from_raw(raw)))) {
+                    if (cn != root_cn_ && cn->object) {
+                        cache.remove(cn->object);
+                    }
+                }
+            }
+
+            invalidate_root_cache();
+            std::lock_guard<std::mutex> lock(root_init_mutex_);
+            const persist::NodeID root = store_->get_root(field_name_);
+            if (root.valid()) {
+                root_node_id_ = root;
+            }
+            return true;
+        }
+
         // Called when splitRoot creates a new root
         // This increments the version to mark that the in-memory root has changed.
         // Note: We don't invalidate the cache here because the new root is already
@@ -396,8 +460,8 @@ namespace xtree {
             // It only becomes internal after splitRoot creates a new root above it
             auto ref = Alloc::allocate_bucket(this, persist::NodeKind::Leaf, /*isRoot*/true);
             
-            const uint64_t key = Alloc::cache_key_for(ref.id, ref.ptr);
-            auto* cn = getCache().add(key, static_cast<IRecord*>(ref.ptr));   // registers in MRU list
+            const uint64_t key = Alloc::cache_key_for(this, ref.id, ref.ptr);
+            auto* cn = getCache().add(key, static_cast<IRecord*>(ref.ptr), true, cache_field_);   // registers in MRU list
             assert(cn && "cache.add must return a valid node for root");
 
             setRootIdentity(key, ref.id, cn);  // record identities (also pins the root)
@@ -468,8 +532,8 @@ namespace xtree {
             assert(!root_bucket->_leaf && "recovered root must be internal");
             
             // 4) Register in the MRU tracker and record identities
-            const uint64_t key = XAlloc<RecordType>::cache_key_for(stored_root, root_bucket);
-            auto* cn = getCache().add(key, reinterpret_cast<IRecord*>(root_bucket));
+            const uint64_t key = XAlloc<RecordType>::cache_key_for(this, stored_root, root_bucket);
+            auto* cn = getCache().add(key, reinterpret_cast<IRecord*>(root_bucket), true, cache_field_);
             if (!cn) return false; // must have an MRU node
 
             // Use recovery-safe identity setter that does NOT emit WAL delta (also pins the root)
@@ -520,6 +584,7 @@ namespace xtree {
         // when no tree traversal is in progress, as eviction may free unpinned nodes
         // Returns number of entries evicted
         static size_t evictCacheToMemoryBudget() {
+            tickCachePolicy();
             return getCache().evictToMemoryBudget();
         }
 
@@ -577,6 +642,58 @@ namespace xtree {
             applyCachePolicy(getDefaultCachePolicy());
         }
 
+        /**
+         * Let the active policy resize the cache from its miss ratio curve.
+         * Runs at the eviction safe points (evictCacheToMemoryBudget() and
+         * after flush_dirty_buckets()); a no-op for policies that do not adapt.
+         */
+        static void tickCachePolicy() {
+            auto policy = cachePolicy_;
+            if (!policy) return;
+            auto& cache = getCache();
+            const size_t before = policy->getMaxMemory();
+            policy->onCurve(cache.missRatioCurve());
+            const size_t after = policy->getMaxMemory();
+            // Only touch the budget when the policy moved it, so a budget set
+            // elsewhere (e.g., by MemoryCoordinator) is left alone
+            if (after != before) cache.setMaxMemory(after);
+        }
+
+        // ========== Per-Index Cache Quota ==========
+
+        /**
+         * Give this index its own share of the shared node cache.
+         *
+         * @param reserved_bytes Bytes guaranteed to this index; other indexes
+         *                       cannot evict its entries below this level
+         * @param limit_bytes    Hard cap for this index (0 = only the global budget)
+         * @param weight         Relative share of the budget left after all
+         *                       reservations (default 1.0 = equal sharing)
+         *
+         * Takes effect at the next eviction point (evictCacheToMemoryBudget()).
+         */
+        void setCacheQuota(size_t reserved_bytes, size_t limit_bytes = 0, double weight = 1.0) {
+            typename Cache::FieldQuota quota;
+            quota.reservedBytes = reserved_bytes;
+            quota.limitBytes = limit_bytes;
+            quota.weight = weight;
+            getCache().setFieldQuota(field_name_, quota);
+        }
+
+        typename Cache::FieldQuota getCacheQuota() const {
+            return getCache().getFieldQuota(field_name_);
+        }
+
+        // Handle this index's cache entries are attributed to
+        typename Cache::FieldHandle getCacheField() const {
+            return cache_field_;
+        }
+
+        // Called from cache_or_load on every child resolution (lock-free)
+        void recordCacheAccess(bool hit) {
+            Cache::recordAccess(cache_field_, hit);
+        }
+
         void updateDetails(unsigned short precision,
                       vector<const char*> *dimLabels) {
         	// Set precision
@@ -592,7 +709,22 @@ namespace xtree {
 
         }
 
-        const UniqueId getNextNodeID() { return ++_nodeCount; }
+        // The record cache is shared by every index of this record type, so
+        // in-memory ids are drawn from one process-wide sequence; otherwise two
+        // IN_MEMORY indexes would hand out the same cache keys
+        const UniqueId getNextNodeID() {
+            static std::atomic<UniqueId> next{1ULL << 48};
+            return _nodeCount = ++next;
+        }
+
+        // Cache key for a node of this index. Durable NodeIDs are only unique
+        // within one data directory, so each durable index xors its own slot
+        // into bits 49-57, which stay clear for local handles below 2^33. That
+        // keeps two open durable indexes apart, and both clear of in-memory
+        // ids (below 2^49) and of pointer keys.
+        uint64_t cacheKey(persist::NodeID id) const {
+            return id.raw() ^ cache_key_salt_;
+        }
         
         PersistenceMode getPersistenceMode() const {
             return persistence_mode_;
@@ -621,6 +753,11 @@ namespace xtree {
             // Cache memory (from ShardedLRUCache)
             size_t cache_bytes = 0;
             size_t cache_entries = 0;
+            uint64_t cache_hits = 0;
+            uint64_t cache_misses = 0;
+            size_t cache_reserved_bytes = 0;   // Quota: guaranteed share
+            size_t cache_limit_bytes = 0;      // Quota: hard cap (0 = none)
+            size_t cache_entitled_bytes = 0;   // Current weighted fair share (0 = no budget)
 
             // Segment allocator stats
             size_t segment_live_bytes = 0;
@@ -631,6 +768,11 @@ namespace xtree {
             size_t total_bytes() const {
                 return mmap_bytes + cache_bytes;
             }
+
+            double cache_hit_rate() const {
+                const uint64_t total = cache_hits + cache_misses;
+                return total ? static_cast<double>(cache_hits) / static_cast<double>(total) : 0.0;
+            }
         };
 
         // Get memory stats for this specific index
@@ -648,10 +790,17 @@ namespace xtree {
             }
 
             // Get per-field cache stats from ShardedLRUCache
-            auto cache_stats = getCache().getPerFieldMemory();
+            auto cache_stats = getCache().getPerFieldUsage();
             auto cache_it = cache_stats.find(field_name_);
             if (cache_it != cache_stats.end()) {
-                stats.cache_bytes = cache_it->second;
+                const auto& usage = cache_it->second;
+                stats.cache_bytes = usage.bytes;
+                stats.cache_entries = usage.entries;
+                stats.cache_hits = usage.hits;
+                stats.cache_misses = usage.misses;
+                stats.cache_reserved_bytes = usage.quota.reservedBytes;
+                stats.cache_limit_bytes = usage.quota.limitBytes;
+                stats.cache_entitled_bytes = usage.entitledBytes;
             }
 
             // Get segment stats if we have a durable runtime
@@ -686,8 +835,8 @@ namespace xtree {
             // Get raw per-field mmap stats directly from MappingManager
             auto raw_mmap_stats = persist::MappingManager::global().getPerFieldStats();
 
-            std::cout << "| Field | MMap (MB) | Cache (MB) | Segments (MB) | Total (MB) |" << std::endl;
-            std::cout << "|-------|-----------|------------|---------------|------------|" << std::endl;
+            std::cout << "| Field | MMap (MB) | Cache (MB) | Hit % | Segments (MB) | Total (MB) |" << std::endl;
+            std::cout << "|-------|-----------|------------|-------|---------------|------------|" << std::endl;
 
             auto all_stats = getAllIndexStats();
             size_t total_mmap = 0, total_cache = 0, total_seg = 0;
@@ -712,6 +861,8 @@ namespace xtree {
                     std::cout << "| " << stats.field_name
                               << " | " << mmap_mb
                               << " | " << cache_mb
+                              << " | " << std::fixed << std::setprecision(1)
+                              << (stats.cache_hit_rate() * 100.0)
                               << " | " << seg_mb
                               << " | " << total_mb
                               << " |" << std::endl;
@@ -730,16 +881,17 @@ namespace xtree {
             if (unreg_it != raw_mmap_stats.end() && unreg_it->second.mmap_bytes > 0) {
                 std::cout << "| _unregistered_ | "
                           << (unreg_it->second.mmap_bytes / (1024 * 1024))
-                          << " | 0 | 0 | "
+                          << " | 0 | - | 0 | "
                           << (unreg_it->second.mmap_bytes / (1024 * 1024))
                           << " |" << std::endl;
                 total_mmap += unreg_it->second.mmap_bytes;
             }
 
-            std::cout << "|-------|-----------|------------|---------------|------------|" << std::endl;
+            std::cout << "|-------|-----------|------------|-------|---------------|------------|" << std::endl;
             std::cout << "| Total | "
                       << (total_mmap / (1024 * 1024))
                       << " | " << (total_cache / (1024 * 1024))
+                      << " | -"
                       << " | " << (total_seg / (1024 * 1024))
                       << " | " << ((total_mmap + total_cache) / (1024 * 1024))
                       << " |" << std::endl;
@@ -764,6 +916,11 @@ namespace xtree {
             return store_;
         }
         
+        // Runtime owning the store, manifest and coordinator (DURABLE mode only)
+        persist::DurableRuntime* getRuntime() {
+            return runtime_.get();
+        }
+
         // Check if we have a durable store
         bool hasDurableStore() const {
             return persistence_mode_ == PersistenceMode::DURABLE && store_ != nullptr;
@@ -773,16 +930,71 @@ namespace xtree {
         // Use before close() if readers need to recover from checkpoint (serverless)
         void forceCheckpoint() {
             if (hasDurableStore() && runtime_) {
+                flush_stale_counts();
                 flush_dirty_buckets();
                 store_->commit(0);  // Ensure all deltas are in WAL
                 runtime_->coordinator().force_checkpoint();
             }
         }
 
+        // Observer for in-place writes to tree memory. A COW manager in
+        // INCREMENTAL mode installs one to feed its dirty page tracker.
+        // Called with the byte range of every mutated bucket; set it while
+        // no insert is running.
+        using WriteObserver = std::function<void(const void* ptr, size_t len)>;
+        void setWriteObserver(WriteObserver observer) {
+            write_observer_ = std::move(observer);
+        }
+
+        bool hasWriteObserver() const { return static_cast<bool>(write_observer_); }
+
         // Helper method to record write operations for tracking
-        void recordWrite(void* ptr) {
-            // No-op for now, will be handled by store interface
+        void recordWrite(const void* ptr, size_t len) {
+            if (write_observer_) write_observer_(ptr, len);
+        }
+
+        // Barrier run before in-place writes, e.g. by a COW manager taking a
+        // CONCURRENT snapshot. begin() brackets a whole insert and returns
+        // true if the insert must preserve memory before modifying it, in
+        // which case prepare(ptr, len) is called for every range first.
+        // Inserts are expected to run one at a time; set it while none is.
+        struct WriteBarrier {
+            std::function<bool()> begin;
+            std::function<void()> end;
+            std::function<void(const void* ptr, size_t len)> prepare;
+        };
+        void setWriteBarrier(WriteBarrier barrier) {
+            write_barrier_ = std::move(barrier);
+        }
+
+        bool hasWriteBarrier() const { return static_cast<bool>(write_barrier_.begin); }
+
+        // True inside an insert whose writes must be prepared
+        bool preservingWrites() const { return preserving_writes_; }
+
+        void prepareWrite(const void* ptr, size_t len) {
+            if (preserving_writes_) write_barrier_.prepare(ptr, len);
         }
+
+        // Brackets one insert with the write barrier, if any
+        class WriteScope {
+        public:
+            explicit WriteScope(IndexDetails* idx)
+                : idx_(idx->hasWriteBarrier() ? idx : nullptr) {
+                if (idx_) idx_->preserving_writes_ = idx_->write_barrier_.begin();
+            }
+            ~WriteScope() {
+                if (idx_) {
+                    idx_->preserving_writes_ = false;
+                    idx_->write_barrier_.end();
+                }
+            }
+            WriteScope(const WriteScope&) = delete;
+            WriteScope& operator=(const WriteScope&) = delete;
+
+        private:
+            IndexDetails* idx_;
+        };
         
         // Helper method to record any operation for tracking  
         void recordOperation() {
@@ -803,6 +1015,42 @@ namespace xtree {
             dirty_buckets_.push_back(bucket);
         }
         
+        // Register a bucket whose child entry counts are newer than its
+        // published copy (see XTreeBucket::markCountsStale()). The list holds
+        // NodeIDs, not pointers: once a listed bucket is published it is
+        // unpinned and may be evicted before flush_stale_counts() runs.
+        void register_stale_counts(XTreeBucket<Record>* bucket) {
+            if (!bucket || !bucket->hasNodeID() || !bucket->try_list_stale()) return;
+            std::lock_guard<std::mutex> lock(dirty_buckets_mutex_);
+            stale_count_buckets_.push_back(bucket->getNodeID());
+        }
+
+        // Schedule every bucket with stale counts for the next
+        // flush_dirty_buckets(). Buckets no longer cached under the listed
+        // NodeID were published (stale ones stay pinned), so have none left.
+        void flush_stale_counts() {
+            std::vector<persist::NodeID> ids;
+            {
+                std::lock_guard<std::mutex> lock(dirty_buckets_mutex_);
+                ids.swap(stale_count_buckets_);
+            }
+            for (const persist::NodeID& id : ids) {
+                auto* cn = getCache().find(cacheKey(id));
+                auto* bucket = (cn && cn->object) ? dynamic_cast<XTreeBucket<Record>*>(cn->object) : nullptr;
+                if (!bucket) continue;
+                bucket->clearStaleListed();
+                if (bucket->hasStaleCounts()) {
+                    bucket->markDirty();
+                }
+            }
+        }
+
+        // Buckets waiting in the dirty list
+        size_t dirty_bucket_count() const {
+            std::lock_guard<std::mutex> lock(dirty_buckets_mutex_);
+            return dirty_buckets_.size();
+        }
+
         // Flush all dirty buckets to storage with exception safety
         void flush_dirty_buckets() {
             if (!hasDurableStore() ||
@@ -852,33 +1100,8 @@ namespace xtree {
                     // If bucket was reallocated, update the parent's reference AND mark parent dirty
                     if (pub_result.id.valid() && pub_result.id != old_id) {
                         bucket->setNodeID(pub_result.id);
-
-                        // CRITICAL FIX: Update all in-memory children's _parent_node_id
-                        // When this bucket is reallocated, its children still have the old
-                        // parent NodeID. If those children are later reallocated, they would
-                        // try to find their parent using the stale NodeID (which was freed).
-                        if (bucket->getChildren()) {
-                            for (auto* kn : *bucket->getChildren()) {
-                                if (kn && !kn->isDataRecord()) {
-                                    // Try to find the child bucket in cache
-                                    persist::NodeID child_id = kn->getNodeID();
-                                    if (child_id.valid()) {
-                                        auto* child_cn = getCache().find(child_id.raw());
-                                        if (child_cn && child_cn->object) {
-                                            auto* childBucket = dynamic_cast<XTreeBucket<Record>*>(child_cn->object);
-                                            if (childBucket) {
-                                                childBucket->setParentNodeID(pub_result.id);
-#ifndef NDEBUG
-                                                trace() << "[REALLOC_CASCADE] Updated child " << child_id.raw()
-                                                          << "'s _parent_node_id: " << old_id.raw()
-                                                          << " -> " << pub_result.id.raw() << std::endl;
-#endif
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                        // publish_with_realloc() already pointed the cached children's
+                        // _parent_node_id at the new NodeID (retargetChildParents())
 #ifndef NDEBUG
                         trace() << "[REALLOC_CASCADE] Bucket " << old_id.raw() << " -> " << pub_result.id.raw()
                                   << " (isLeaf=" << bucket->getIsLeaf() << ")"
@@ -890,7 +1113,7 @@ namespace xtree {
                         // The raw _parent pointer points to a _MBRKeyNode that was deleted with parent.
                         if (bucket->getParentNodeID().valid()) {
                             // This bucket has a parent - find or reload it
-                            uint64_t parent_key = bucket->getParentNodeID().raw();
+                            uint64_t parent_key = cacheKey(bucket->getParentNodeID());
                             auto* parent_cn = getCache().find(parent_key);
                             XTreeBucket<Record>* parentBucket = nullptr;
 
@@ -942,9 +1165,12 @@ namespace xtree {
 #endif
                                 }
                             } else {
-                                // Parent was evicted - reload from disk
+                                // Parent was evicted - reload from disk. Only decode a bucket
+                                // image: a stale parent NodeID whose handle was handed out
+                                // again reads another node's staged bytes.
                                 persist::NodeBytes parent_bytes = store_->read_node(bucket->getParentNodeID());
-                                if (parent_bytes.data && parent_bytes.size > 0) {
+                                if (XTreeBucket<Record>::is_wire_image(static_cast<const uint8_t*>(parent_bytes.data),
+                                                                       parent_bytes.size, getDimensionCount())) {
                                     // Create new bucket and deserialize from wire format
                                     parentBucket = new XTreeBucket<Record>(this, /*isRoot*/false);
                                     parentBucket->setNodeID(bucket->getParentNodeID());
@@ -961,10 +1187,10 @@ namespace xtree {
                                         }
                                     }
                                     // Add to cache
-                                    auto cache_result = getCache().acquirePinned(parent_key, parentBucket);
+                                    auto cache_result = getCache().acquirePinned(parent_key, parentBucket, cache_field_);
                                     parent_cn = cache_result.node;
-                                    // If already in cache, we have duplicate - delete our loaded copy
-                                    // BUT ALSO update the existing parent's child reference!
+                                    // If already in cache, acquirePinned() freed our duplicate copy
+                                    // BUT we must also update the existing parent's child reference!
                                     if (!cache_result.created && cache_result.node && cache_result.node->object != parentBucket) {
                                         // The parent was already in cache - update ITS child reference too!
                                         auto* existingParent = dynamic_cast<XTreeBucket<Record>*>(cache_result.node->object);
@@ -980,7 +1206,6 @@ namespace xtree {
                                                 }
                                             }
                                         }
-                                        delete parentBucket;
                                         parentBucket = existingParent;
                                     }
 #ifndef NDEBUG
@@ -1032,7 +1257,7 @@ namespace xtree {
                             // When root is reallocated, we MUST update the superblock
                             // with the new root NodeID, otherwise recovery will use stale ID.
                             root_node_id_ = pub_result.id;
-                            root_cache_key_ = pub_result.id.raw();
+                            root_cache_key_ = cacheKey(pub_result.id);
 
                             // Update superblock with new root ID
                             if (store_) {
@@ -1051,7 +1276,7 @@ namespace xtree {
                             }
                         }
                         // Rekey the cache entry
-                        getCache().rekey(old_id.raw(), pub_result.id.raw());
+                        getCache().rekey(cacheKey(old_id), cacheKey(pub_result.id));
                     }
 
                     bucket->clearDirty();
@@ -1081,6 +1306,7 @@ namespace xtree {
 
             // Tick the memory coordinator at safe points (after flush, no traversal in progress)
             persist::MemoryCoordinator::global().tick();
+            tickCachePolicy();
         }
 
         /**
@@ -1096,6 +1322,46 @@ namespace xtree {
     private:
         void initializeDurableStore(const std::string& data_dir, bool read_only = false);
 
+        // Cache key slots for durable indexes. close() drops the unpinned
+        // entries of a slot; released slots are reused oldest first, and only
+        // once every slot has been handed out, in case pinned ones linger.
+        struct CacheKeySlots {
+            std::mutex mu;
+            uint64_t next = 1;
+            std::deque<uint64_t> released;
+        };
+        static constexpr uint64_t CACHE_KEY_SLOTS = 512;
+        static constexpr unsigned CACHE_KEY_SHIFT = 49;
+        static constexpr uint64_t CACHE_KEY_MASK = (CACHE_KEY_SLOTS - 1) << CACHE_KEY_SHIFT;
+
+        static CacheKeySlots& cacheKeySlots() {
+            static CacheKeySlots slots;
+            return slots;
+        }
+
+        static uint64_t acquireCacheKeySalt() {
+            auto& slots = cacheKeySlots();
+            std::lock_guard<std::mutex> lock(slots.mu);
+            uint64_t slot = 0;
+            if (slots.next < CACHE_KEY_SLOTS) {
+                slot = slots.next++;
+            } else if (!slots.released.empty()) {
+                slot = slots.released.front();
+                slots.released.pop_front();
+            } else {
+                throw std::runtime_error("Too many durable indexes open (" +
+                                         std::to_string(CACHE_KEY_SLOTS - 1) + " max)");
+            }
+            return slot << CACHE_KEY_SHIFT;
+        }
+
+        static void releaseCacheKeySalt(uint64_t salt) {
+            if (salt == 0) return;
+            auto& slots = cacheKeySlots();
+            std::lock_guard<std::mutex> lock(slots.mu);
+            slots.released.push_back(salt >> CACHE_KEY_SHIFT);
+        }
+
         static JNIEnv *jvm;
         static vector<IndexDetails<Record>*> indexes;
         
@@ -1119,14 +1385,21 @@ namespace xtree {
         uint64_t        root_cache_key_ = 0;                    // informational
         persist::NodeID root_node_id_   = persist::NodeID::invalid();
         CacheNode* root_cn_ = nullptr;  // authoritative pointer
+        typename Cache::FieldHandle cache_field_ = nullptr;  // Per-field cache accounting
+        WriteObserver write_observer_;                       // In-place write reporting
+        WriteBarrier write_barrier_;                         // Pre-write hook (concurrent snapshots)
+        bool preserving_writes_ = false;                     // Set by WriteScope
         mutable std::mutex root_init_mutex_;                    // Thread-safety for root initialization
 
         // Root version tracking for automatic cache invalidation on splits
         std::atomic<uint64_t> root_version_{0};                 // Incremented on root split
         uint64_t cached_root_version_ = 0;                      // Version of cached root
+        uint64_t replica_generation_ = 0;                       // Replica round the root reflects
+        uint64_t cache_key_salt_ = 0;                           // See cacheKey(); 0 for IN_MEMORY
         
         // Dirty bucket tracking for batched publishing
         std::vector<XTreeBucket<Record>*> dirty_buckets_;
+        std::vector<persist::NodeID> stale_count_buckets_;  // Written at checkpoint and close
         mutable std::mutex dirty_buckets_mutex_;                // Thread-safety for dirty list
 
         // Helper to rebuild root cache from persistence (after commit or reload)
@@ -1186,10 +1459,10 @@ namespace xtree {
             }
 
             // Add to cache with the committed NodeID as key
-            root_cache_key_ = root_node_id_.raw();
+            root_cache_key_ = cacheKey(root_node_id_);
 
             try {
-                root_cn_ = getCache().add(root_cache_key_, reinterpret_cast<IRecord*>(bucket));
+                root_cn_ = getCache().add(root_cache_key_, reinterpret_cast<IRecord*>(bucket), true, cache_field_);
             } catch (...) {
                 delete bucket;  // Avoid leak if cache.add throws
                 throw;
@@ -24,6 +24,7 @@
 #include "typemgr.h"
 #include "util/float_utils.h"
 #include "util/endian.hpp"  // For portable little-endian wire format
+#include "memmgr/huge_page_arena.hpp"
 #include <limits>
 #include <jni.h>
 
@@ -49,8 +50,21 @@ namespace xtree {
 
     class KeyMBR {
     private:
+        // Boxes share the keys' arena: a descent reads both
+        static float* new_box(unsigned short dim) {
+            if (void* p = HugePageArena::global().allocate(dim * 2 * sizeof(float))) {
+                return static_cast<float*>(p);
+            }
+            return new float[dim * 2];
+        }
+        static void delete_box(float* box) {
+            auto& arena = HugePageArena::global();
+            if (arena.owns(box)) arena.deallocate(box);
+            else delete[] box;
+        }
+
         void init() {
-            this->_box = new float[this->dimension*2];
+            this->_box = new_box(this->dimension);
             for(unsigned short d=0; d<this->dimension*2; d+=2) {
                 // Initialize with float min/max values
                 _box[d] = std::numeric_limits<float>::max();    // min values start at max
@@ -62,6 +76,17 @@ namespace xtree {
 
     public:
 
+        // Keys come from the huge-page arena when it is enabled
+        static void* operator new(std::size_t sz) {
+            if (void* p = HugePageArena::global().allocate(sz)) return p;
+            return ::operator new(sz);
+        }
+        static void operator delete(void* p) noexcept {
+            auto& arena = HugePageArena::global();
+            if (arena.owns(p)) arena.deallocate(p);
+            else ::operator delete(p);
+        }
+
         // Default constructor for placement new
         KeyMBR() : dimension(0), _box(NULL), _area(NULL), _owns_box(true) {}
         
@@ -92,7 +117,7 @@ namespace xtree {
 
         void free() {
             if (_owns_box && _box) {
-                delete [] _box;
+                delete_box(_box);
             }
             _box = nullptr;
         }
@@ -213,7 +238,7 @@ namespace xtree {
         // Copy constructor
         KeyMBR(const KeyMBR& rhs) : dimension(rhs.dimension), _box(NULL), _area(NULL), _owns_box(true) {
             if (rhs._box) {
-                _box = new float[dimension * 2];
+                _box = new_box(dimension);
                 memcpy(_box, rhs._box, dimension * 2 * sizeof(float));
             }
             if (rhs._area) {
@@ -224,7 +249,7 @@ namespace xtree {
         KeyMBR& operator=(const KeyMBR& rhs) {
             if (this != &rhs) {
                 // Clean up existing data
-                if (_owns_box) delete[] _box;
+                if (_owns_box) delete_box(_box);
                 delete _area;
                 
                 // Copy dimension
@@ -232,7 +257,7 @@ namespace xtree {
                 
                 // Allocate and copy box data
                 if (rhs._box) {
-                    _box = new float[dimension * 2];
+                    _box = new_box(dimension);
                     memcpy(_box, rhs._box, dimension * 2 * sizeof(float));
                     _owns_box = true;  // We allocated new memory
                 } else {
@@ -301,9 +326,9 @@ namespace xtree {
         void set_from_interleaved(const float* f, unsigned short dims) {
             // Ensure storage exists and dimensions match
             if (_box == nullptr || dimension != dims) {
-                if (_owns_box) delete[] _box;
+                if (_owns_box) delete_box(_box);
                 dimension = dims;
-                _box = new float[2 * dims];
+                _box = new_box(dims);
                 _owns_box = true;
             }
             std::memcpy(_box, f, sizeof(float) * 2 * dims);
@@ -345,9 +370,9 @@ namespace xtree {
         const uint8_t* from_wire(const uint8_t* in, unsigned short dims) {
             // Ensure storage exists
             if (_box == nullptr || dimension != dims) {
-                if (_owns_box) delete[] _box;
+                if (_owns_box) delete_box(_box);
                 dimension = dims;
-                _box = new float[2 * dims];
+                _box = new_box(dims);
                 _owns_box = true;
             }
             // Read each float in little-endian format
@@ -73,6 +73,15 @@ namespace xtree {
         LRUFreeMalloc
     };
 
+    // Unpinned nodes of one owner tag in a shard, MRU->LRU, linked through
+    // the nodes' ownerNext/ownerPrev
+    template<typename NodeType>
+    struct LRUOwnerList {
+        const void* tag = nullptr;
+        NodeType* first = nullptr;  // MRU unpinned
+        NodeType* last = nullptr;   // LRU unpinned
+    };
+
     // ------------------------------
     // Node
     // ------------------------------
@@ -112,6 +121,11 @@ namespace xtree {
         // Eviction list (only unpinned)
         _SelfType* evictNext;
         _SelfType* evictPrev;
+
+        // Eviction list of this node's owner (only unpinned)
+        LRUOwnerList<_SelfType>* owner = nullptr;
+        _SelfType* ownerNext = nullptr;
+        _SelfType* ownerPrev = nullptr;
     };
 
     // DeleteObject specialization
@@ -157,6 +171,9 @@ namespace xtree {
         _SelfType* prev;
         _SelfType* evictNext;
         _SelfType* evictPrev;
+        LRUOwnerList<_SelfType>* owner = nullptr;
+        _SelfType* ownerNext = nullptr;
+        _SelfType* ownerPrev = nullptr;
     };
 
     // DeleteArray specialization
@@ -195,6 +212,9 @@ namespace xtree {
         _SelfType* prev;
         _SelfType* evictNext;
         _SelfType* evictPrev;
+        LRUOwnerList<_SelfType>* owner = nullptr;
+        _SelfType* ownerNext = nullptr;
+        _SelfType* ownerPrev = nullptr;
     };
 
     // Free malloc specialization
@@ -233,6 +253,9 @@ namespace xtree {
         _SelfType* prev;
         _SelfType* evictNext;
         _SelfType* evictPrev;
+        LRUOwnerList<_SelfType>* owner = nullptr;
+        _SelfType* ownerNext = nullptr;
+        _SelfType* ownerPrev = nullptr;
     };
 
     // ------------------------------
@@ -265,6 +288,10 @@ namespace xtree {
         // owns_object=false: cache will NOT delete object (mmap'd, managed externally)
         Node* add(const IdType& id, CachedObjectType* object, bool owns_object);
 
+        // Add attributed to an opaque owner tag (e.g. the index the entry
+        // belongs to) so removeOneOwnedBy() can find it without a scan
+        Node* add(const IdType& id, CachedObjectType* object, bool owns_object, const void* owner);
+
         // O(1) atomic get-or-create, returns node already pinned
         // Thread-safe: If id exists, pins and returns existing node
         // If id doesn't exist, creates new node with objIfAbsent, pins it, and returns it
@@ -272,6 +299,9 @@ namespace xtree {
         // Returns AcquireResult with node pointer and created flag
         AcquireResult acquirePinned(const IdType& id, CachedObjectType* objIfAbsent);
 
+        // As above; a node created here is attributed to owner
+        AcquireResult acquirePinned(const IdType& id, CachedObjectType* objIfAbsent, const void* owner);
+
         // Atomically acquire a pinned node, persisting only if created
         // persistFn is called exactly once if a new object is inserted
         // Returns AcquireResult with node pointer and created flag
@@ -300,6 +330,10 @@ namespace xtree {
         // O(1) eviction (returns detached node; caller deletes)
         Node* removeOne();
 
+        // O(1) eviction of the least recently used unpinned node added with
+        // this owner tag (nullptr = unattributed nodes). Caller deletes.
+        Node* removeOneOwnedBy(const void* owner);
+
         // O(1) removals by key or by object
         // removeById: Removes node and returns the cached object pointer
         // IMPORTANT: Ownership transfers to caller - caller MUST delete/free the
@@ -415,6 +449,12 @@ namespace xtree {
         Node* _evictFirst; // MRU unpinned
         Node* _evictLast;  // LRU unpinned
 
+        // Per-owner eviction lists; every node is on the one of its tag.
+        // Elements of an unordered_map stay put, so nodes point at them.
+        using OwnerList = LRUOwnerList<Node>;
+        std::unordered_map<const void*, OwnerList> _owners;
+        OwnerList* ownerList(const void* owner);
+
         // List ops
         void promoteToMRU(Node* n);
         void unlinkFromLRU(Node* n);
@@ -37,6 +37,13 @@ namespace xtree {
     template<typename T, typename Id, LRUCacheDeleteType Del>
     typename LRUCache<T, Id, Del>::Node*
     LRUCache<T, Id, Del>::add(const Id& id, T* object, bool owns_object) {
+        return add(id, object, owns_object, nullptr);
+    }
+
+    // Add attributed to an owner tag
+    template<typename T, typename Id, LRUCacheDeleteType Del>
+    typename LRUCache<T, Id, Del>::Node*
+    LRUCache<T, Id, Del>::add(const Id& id, T* object, bool owns_object, const void* owner) {
         std::unique_lock<std::shared_mutex> lock(_mtx);
 
         // Prevent duplicates
@@ -44,6 +51,7 @@ namespace xtree {
         assert(_mapObj.find(object) == _mapObj.end() && "Duplicate object* in LRUCache");
 
         Node* node = new Node(id, object, _first, owns_object);
+        node->owner = ownerList(owner);
 
         // Link into LRU head
         if (_first) _first->prev = node;
@@ -66,6 +74,12 @@ namespace xtree {
     template<typename T, typename Id, LRUCacheDeleteType Del>
     typename LRUCache<T, Id, Del>::AcquireResult
     LRUCache<T, Id, Del>::acquirePinned(const Id& id, T* objIfAbsent) {
+        return acquirePinned(id, objIfAbsent, nullptr);
+    }
+
+    template<typename T, typename Id, LRUCacheDeleteType Del>
+    typename LRUCache<T, Id, Del>::AcquireResult
+    LRUCache<T, Id, Del>::acquirePinned(const Id& id, T* objIfAbsent, const void* owner) {
         std::unique_lock<std::shared_mutex> lock(_mtx);
 
         // Check if already exists
@@ -90,6 +104,7 @@ namespace xtree {
 
         // Doesn't exist - create new node already pinned
         Node* node = new Node(id, objIfAbsent, _first);
+        node->owner = ownerList(owner);
         node->pin();  // Start pinned - no eviction list
 
         // Link into LRU head
@@ -174,6 +189,19 @@ namespace xtree {
         return removeNodeAndReturn(_evictLast);
     }
 
+    // ------------------------------
+    // removeOneOwnedBy (evict LRU-unpinned of one owner)
+    // ------------------------------
+    template<typename T, typename Id, LRUCacheDeleteType Del>
+    typename LRUCache<T, Id, Del>::Node*
+    LRUCache<T, Id, Del>::removeOneOwnedBy(const void* owner) {
+        std::unique_lock<std::shared_mutex> lock(_mtx);
+
+        auto it = _owners.find(owner);
+        if (it == _owners.end() || !it->second.last) return nullptr;
+        return removeNodeAndReturn(it->second.last);
+    }
+
     // ------------------------------
     // removeById / removeByObject
     // ------------------------------
@@ -235,6 +263,7 @@ namespace xtree {
         _first = _last = _evictFirst = _evictLast = nullptr;
         _mapId.clear();
         _mapObj.clear();
+        _owners.clear();
 
         // Sanity check: maps must be empty after clear
         assert(_mapId.size() == 0 && "mapId not empty after clear");
@@ -282,6 +311,10 @@ namespace xtree {
     void LRUCache<T, Id, Del>::removeFromEvictionList(Node* n) {
         if (!n) return;
 
+        // Not in the list (e.g., already pinned): unlinking would reset the
+        // list head/tail and orphan every other evictable node
+        if (!n->evictPrev && !n->evictNext && _evictFirst != n) return;
+
         if (n->evictPrev) n->evictPrev->evictNext = n->evictNext;
         else              _evictFirst = n->evictNext;
 
@@ -289,6 +322,17 @@ namespace xtree {
         else              _evictLast  = n->evictPrev;
 
         n->evictPrev = n->evictNext = nullptr;
+
+        // Same membership on the owner's list
+        if (OwnerList* o = n->owner) {
+            if (n->ownerPrev) n->ownerPrev->ownerNext = n->ownerNext;
+            else              o->first = n->ownerNext;
+
+            if (n->ownerNext) n->ownerNext->ownerPrev = n->ownerPrev;
+            else              o->last = n->ownerPrev;
+
+            n->ownerPrev = n->ownerNext = nullptr;
+        }
     }
 
     template<typename T, typename Id, LRUCacheDeleteType Del>
@@ -308,6 +352,22 @@ namespace xtree {
         else             _evictLast = n;  // first in list
 
         _evictFirst = n;
+
+        if (OwnerList* o = n->owner) {
+            n->ownerPrev = nullptr;
+            n->ownerNext = o->first;
+            if (o->first) o->first->ownerPrev = n;
+            else          o->last = n;
+            o->first = n;
+        }
+    }
+
+    template<typename T, typename Id, LRUCacheDeleteType Del>
+    typename LRUCache<T, Id, Del>::OwnerList*
+    LRUCache<T, Id, Del>::ownerList(const void* owner) {
+        OwnerList& list = _owners[owner];
+        list.tag = owner;
+        return &list;
     }
 
     // ------------------------------
@@ -445,8 +505,9 @@ namespace xtree {
             return false;  // object already in this shard
         }
 
-        // Update node's id to new_id
+        // Update node's id to new_id; the owner list moves to this shard's
         node->id = new_id;
+        if (node->owner) node->owner = ownerList(node->owner->tag);
 
         // Link into LRU head
         node->next = _first;
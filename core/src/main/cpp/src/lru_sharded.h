@@ -20,15 +20,39 @@
  * - Global LRU ordering is lost (each shard maintains local LRU)
  * - removeByObject requires global tracking or O(numShards) scan
  * - Eviction happens per-shard, not globally
+ *
+ * Per-field quotas:
+ * - Entries added with a field name are attributed to that field (index)
+ * - setFieldQuota() gives a field a reservation (bytes never evicted to make
+ *   room for other fields), an optional hard limit, and a weight for sharing
+ *   the budget left over after all reservations
+ * - evictToMemoryBudget() evicts from the field furthest above its weighted
+ *   fair share first, so a burst on one field cannot flush the others
+ *
+ * NUMA placement:
+ * - On a multi-node machine shard i (its mutex and container headers) is
+ *   constructed in memory of node i % nodes. Keys still hash to any shard,
+ *   so this spreads the hot shard headers across sockets instead of
+ *   leaving them all on the constructing thread's node
+ *
+ * Miss ratio curve:
+ * - find() hits and acquirePinned() feed a SHARDS-sampled reuse-distance
+ *   histogram (missRatioCurve()) that estimates the hit rate at any budget
  */
 
 #pragma once
 
 #include "lru.h"
+#include "util/miss_ratio_curve.h"
+#include "util/numa_topology.h"
 #include <vector>
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
 
 namespace xtree {
 
@@ -45,7 +69,10 @@ public:
     // Default implementation tries object->memoryUsage(), falls back to fixed estimate
     using MemorySizer = std::function<size_t(const T*)>;
 
-    explicit ShardedLRUCache(size_t numShards = 32, bool enableGlobalObjMap = false)
+    struct FieldState;  // Per-field accounting, see below
+
+    explicit ShardedLRUCache(size_t numShards = 32, bool enableGlobalObjMap = false,
+                             const NumaTopology& numa = NumaTopology::system())
         : _evictCounter(0),
           _currentMemory(0),
           _maxMemory(0),  // 0 = unlimited
@@ -58,7 +85,7 @@ public:
         // Reserve space and create each shard
         _shards.reserve(powerOf2);
         for (size_t i = 0; i < powerOf2; ++i) {
-            _shards.emplace_back(std::make_unique<Shard>());
+            _shards.emplace_back(make_on_node<Shard>(numa, i % numa.node_count()));
         }
 
         // Default memory sizer - uses a fixed estimate per object
@@ -106,15 +133,48 @@ public:
         _memorySizer = std::move(sizer);
     }
 
-    // Evict entries until memory usage is under budget
+    // Evict entries until memory usage is under budget and every field is
+    // within its hard limit. Victims come from the field furthest above its
+    // fair share, then the next one once everything left of it is pinned.
+    // Only when no field over its share has anything evictable does eviction
+    // fall back to unattributed entries and then plain round-robin LRU.
     // Returns number of entries evicted
     size_t evictToMemoryBudget() {
-        size_t maxMem = _maxMemory.load(std::memory_order_relaxed);
-        if (maxMem == 0) return 0;  // No limit
+        const size_t maxMem = _maxMemory.load(std::memory_order_relaxed);
+        const bool fieldLimits = _hasFieldLimits.load(std::memory_order_relaxed);
+        if (maxMem == 0 && !fieldLimits) return 0;  // No limit
+
+        auto overBudget = [&]() {
+            return maxMem > 0 && _currentMemory.load(std::memory_order_relaxed) > maxMem;
+        };
 
         size_t evicted = 0;
-        while (_currentMemory.load(std::memory_order_relaxed) > maxMem) {
-            Node* node = removeOne();
+        std::vector<const FieldState*> exhausted;  // Over their share, all pinned
+        while (true) {
+            const bool over = overBudget();
+
+            // Pick the field to shrink and the size to shrink it to. This is
+            // recomputed once per victim, not per entry, so a large eviction
+            // batch stays cheap with dozens of fields.
+            size_t target = 0;
+            FieldState* victim = pickVictimField(maxMem, over, target, exhausted);
+            if (victim) {
+                size_t freed = 0;
+                while (fieldBytes(victim) > target) {
+                    Node* node = removeOneFromField(victim);
+                    if (!node) break;  // Everything left for this field is pinned
+                    delete node;
+                    ++freed;
+                    if (!overBudget() && !overFieldLimit(victim)) break;
+                }
+                evicted += freed;
+                if (freed == 0) exhausted.push_back(victim);
+                continue;
+            }
+
+            if (!over) break;  // Only pinned limit overruns remain
+            Node* node = removeOneFromField(nullptr);
+            if (!node) node = removeOne();
             if (!node) break;  // Nothing left to evict
 
             // Memory already decremented in removeOne()
@@ -146,9 +206,14 @@ public:
     // O(1) add with ownership control and optional field_name for per-index tracking
     // field_name: Optional field/index name for per-field memory attribution
     Node* add(const Id& id, T* object, bool owns_object, const std::string& field_name) {
+        return add(id, object, owns_object, field_name.empty() ? nullptr : fieldHandle(field_name));
+    }
+
+    // As above with the field's handle (see fieldHandle()); nullptr = none
+    Node* add(const Id& id, T* object, bool owns_object, FieldState* field) {
         size_t shardIdx = getShardIndex(id);
         auto& shard = *_shards[shardIdx];
-        Node* node = shard.add(id, object, owns_object);
+        Node* node = shard.add(id, object, owns_object, field);
 
         if (node) {
             size_t objSize = 0;
@@ -166,11 +231,9 @@ public:
             }
 
             // Track per-field memory if field_name is specified
-            if (!field_name.empty()) {
+            if (field) {
                 if (objSize == 0) objSize = _memorySizer(object);  // Calculate if not already done
-                std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-                _fieldMemory[field_name] += objSize;
-                _objToField[object] = field_name;
+                attachToField(object, field, objSize);
             }
 
             // NOTE: Do NOT evict here - it's unsafe during tree traversal
@@ -190,9 +253,14 @@ public:
 
     // O(1) atomic get-or-create with field_name for per-index tracking
     AcquireResult acquirePinned(const Id& id, T* objIfAbsent, const std::string& field_name) {
+        return acquirePinned(id, objIfAbsent, field_name.empty() ? nullptr : fieldHandle(field_name));
+    }
+
+    // As above with the field's handle; no field lock on the hit path
+    AcquireResult acquirePinned(const Id& id, T* objIfAbsent, FieldState* field) {
         size_t shardIdx = getShardIndex(id);
         auto& shard = *_shards[shardIdx];
-        AcquireResult result = shard.acquirePinned(id, objIfAbsent);
+        AcquireResult result = shard.acquirePinned(id, objIfAbsent, field);
 
         // Track memory and global map if newly created
         if (result.created && result.node) {
@@ -210,14 +278,13 @@ public:
             }
 
             // Track per-field memory if field_name is specified
-            if (!field_name.empty()) {
+            if (field) {
                 if (objSize == 0) objSize = _memorySizer(result.node->object);
-                std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-                _fieldMemory[field_name] += objSize;
-                _objToField[result.node->object] = field_name;
+                attachToField(result.node->object, field, objSize);
             }
         }
 
+        if (result.node) sampleReference(id, result.node->object);
         return result;
     }
 
@@ -268,12 +335,9 @@ public:
         T* object = shard.removeById(id);
 
         if (object) {
-            size_t objSize = 0;
-
             // Decrement memory usage (only if budget is enabled)
             if (_maxMemory.load(std::memory_order_relaxed) > 0) {
-                objSize = _memorySizer(object);
-                _currentMemory.fetch_sub(objSize, std::memory_order_relaxed);
+                _currentMemory.fetch_sub(_memorySizer(object), std::memory_order_relaxed);
             }
 
             // Clean up global map if enabled
@@ -283,22 +347,7 @@ public:
             }
 
             // Decrement per-field memory if tracked
-            {
-                std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-                auto it = _objToField.find(object);
-                if (it != _objToField.end()) {
-                    if (objSize == 0) objSize = _memorySizer(object);
-                    auto field_it = _fieldMemory.find(it->second);
-                    if (field_it != _fieldMemory.end()) {
-                        if (field_it->second >= objSize) {
-                            field_it->second -= objSize;
-                        } else {
-                            field_it->second = 0;
-                        }
-                    }
-                    _objToField.erase(it);
-                }
-            }
+            detachFromField(object);
         }
 
         return object;  // Transfer ownership to caller
@@ -309,25 +358,7 @@ public:
     bool removeByObject(T* object) {
         // Only calculate memory if budget is enabled (avoid virtual call overhead)
         const bool trackMemory = _maxMemory.load(std::memory_order_relaxed) > 0;
-        size_t objSize = trackMemory ? _memorySizer(object) : 0;
-
-        // Helper lambda to decrement per-field memory
-        auto decrementFieldMemory = [this, object, &objSize]() {
-            std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-            auto it = _objToField.find(object);
-            if (it != _objToField.end()) {
-                if (objSize == 0) objSize = _memorySizer(object);
-                auto field_it = _fieldMemory.find(it->second);
-                if (field_it != _fieldMemory.end()) {
-                    if (field_it->second >= objSize) {
-                        field_it->second -= objSize;
-                    } else {
-                        field_it->second = 0;
-                    }
-                }
-                _objToField.erase(it);
-            }
-        };
+        const size_t objSize = trackMemory ? _memorySizer(object) : 0;
 
         if (_useGlobalObjMap) {
             // 1) Read shard index under the global map lock
@@ -351,7 +382,7 @@ public:
                 _globalObjMap.erase(object);
 
                 // Decrement per-field memory
-                decrementFieldMemory();
+                detachFromField(object);
             }
             return removed;
         } else {
@@ -362,7 +393,7 @@ public:
                         _currentMemory.fetch_sub(objSize, std::memory_order_relaxed);
                     }
                     // Decrement per-field memory
-                    decrementFieldMemory();
+                    detachFromField(object);
                     return true;
                 }
             }
@@ -375,6 +406,27 @@ public:
         return removeByObject(object);
     }
 
+    // O(n) remove every unpinned entry whose id matches pred(const Id&),
+    // e.g. the nodes of an index that is being closed. pred runs under a
+    // shard lock and must not call back into this cache.
+    // Returns number of entries removed
+    template<typename Pred>
+    size_t removeIf(Pred pred) {
+        std::vector<T*> victims;
+        for (auto& shard : _shards) {
+            shard->forEachNode([&](const Node* node) {
+                if (node->object && !node->isPinned() && pred(node->id)) {
+                    victims.push_back(node->object);
+                }
+            });
+        }
+        size_t removed = 0;
+        for (T* object : victims) {
+            if (removeByObject(object)) ++removed;
+        }
+        return removed;
+    }
+
     // O(1) evict from round-robin shard
     Node* removeOne() {
         // Round-robin through shards for even eviction
@@ -388,38 +440,7 @@ public:
             size_t idx = (startIdx + i) & _shardMask;
             Node* evicted = _shards[idx]->removeOne();
             if (evicted) {
-                // Decrement memory usage (only if budget is enabled)
-                if (evicted->object) {
-                    size_t objSize = 0;
-                    if (trackMemory) {
-                        objSize = _memorySizer(evicted->object);
-                        _currentMemory.fetch_sub(objSize, std::memory_order_relaxed);
-                    }
-
-                    // Clean up global map
-                    if (_useGlobalObjMap) {
-                        std::lock_guard<std::mutex> lock(_globalMapMtx);
-                        _globalObjMap.erase(evicted->object);
-                    }
-
-                    // Decrement per-field memory if tracked
-                    {
-                        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-                        auto it = _objToField.find(evicted->object);
-                        if (it != _objToField.end()) {
-                            if (objSize == 0) objSize = _memorySizer(evicted->object);
-                            auto field_it = _fieldMemory.find(it->second);
-                            if (field_it != _fieldMemory.end()) {
-                                if (field_it->second >= objSize) {
-                                    field_it->second -= objSize;
-                                } else {
-                                    field_it->second = 0;
-                                }
-                            }
-                            _objToField.erase(it);
-                        }
-                    }
-                }
+                accountEvicted(evicted, trackMemory);
                 return evicted;
             }
         }
@@ -496,10 +517,14 @@ public:
             _globalObjMap.clear();
         }
 
-        // Reset per-field memory tracking
+        // Reset per-field memory tracking. FieldState objects survive so that
+        // handles held by indexes stay valid; quotas and hit counters are kept.
         {
             std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-            _fieldMemory.clear();
+            for (auto& kv : _fields) {
+                kv.second->bytes = 0;
+                kv.second->entries = 0;
+            }
             _objToField.clear();
         }
     }
@@ -535,7 +560,105 @@ public:
     // Returns map of field_name -> memory bytes used by that field's cache entries
     std::unordered_map<std::string, size_t> getPerFieldMemory() const {
         std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
-        return _fieldMemory;  // Return a copy
+        std::unordered_map<std::string, size_t> result;
+        result.reserve(_fields.size());
+        for (const auto& kv : _fields) {
+            result.emplace(kv.first, kv.second->bytes);
+        }
+        return result;
+    }
+
+    // ========== Per-Field Quotas and Statistics ==========
+
+    // Quota for one field (index). All values in bytes.
+    struct FieldQuota {
+        size_t reservedBytes = 0;  // Guaranteed share; not evicted to make room for other fields
+        size_t limitBytes = 0;     // Hard cap enforced even under the global budget (0 = none)
+        double weight = 1.0;       // Relative share of the budget left after all reservations
+    };
+
+    // Per-field accounting. Owned by the cache and never freed while the cache
+    // lives, so a FieldHandle can be held for the lifetime of an index.
+    struct FieldState {
+        size_t bytes = 0;     // Guarded by _fieldMemoryMtx
+        size_t entries = 0;   // Guarded by _fieldMemoryMtx
+        FieldQuota quota;     // Guarded by _fieldMemoryMtx
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+    };
+    using FieldHandle = FieldState*;
+
+    // Snapshot of one field's usage, as returned by getPerFieldUsage()
+    struct FieldUsage {
+        size_t bytes = 0;
+        size_t entries = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entitledBytes = 0;  // Current weighted fair share (0 = no global budget)
+        FieldQuota quota;
+
+        double hitRate() const {
+            const uint64_t total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // Get (creating if needed) the stable accounting handle for a field
+    FieldHandle fieldHandle(const std::string& field_name) {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        return getOrCreateField(field_name);
+    }
+
+    // Record a lookup outcome for a field. Lock-free; safe on the hot path.
+    static void recordAccess(FieldHandle field, bool hit) {
+        if (!field) return;
+        (hit ? field->hits : field->misses).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Set the reservation, hard limit and sharing weight for a field.
+    // Enforcement happens at the next evictToMemoryBudget() call.
+    void setFieldQuota(const std::string& field_name, const FieldQuota& quota) {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        FieldState* f = getOrCreateField(field_name);
+        f->quota = quota;
+        if (f->quota.weight <= 0.0) f->quota.weight = 1.0;
+
+        bool anyLimit = false;
+        for (const auto& kv : _fields) {
+            if (kv.second->quota.limitBytes > 0) { anyLimit = true; break; }
+        }
+        _hasFieldLimits.store(anyLimit, std::memory_order_relaxed);
+    }
+
+    FieldQuota getFieldQuota(const std::string& field_name) const {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        auto it = _fields.find(field_name);
+        return it != _fields.end() ? it->second->quota : FieldQuota{};
+    }
+
+    // Per-field bytes, entries, hit counters and current fair share
+    std::unordered_map<std::string, FieldUsage> getPerFieldUsage() const {
+        const size_t maxMem = _maxMemory.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+
+        std::unordered_map<std::string, size_t> entitlement;
+        if (maxMem > 0) entitlement = computeEntitlements(maxMem);
+
+        std::unordered_map<std::string, FieldUsage> result;
+        result.reserve(_fields.size());
+        for (const auto& kv : _fields) {
+            const FieldState& f = *kv.second;
+            FieldUsage u;
+            u.bytes = f.bytes;
+            u.entries = f.entries;
+            u.hits = f.hits.load(std::memory_order_relaxed);
+            u.misses = f.misses.load(std::memory_order_relaxed);
+            u.quota = f.quota;
+            auto eit = entitlement.find(kv.first);
+            if (eit != entitlement.end()) u.entitledBytes = eit->second;
+            result.emplace(kv.first, u);
+        }
+        return result;
     }
 
     // Detailed stats showing type breakdown and pin counts
@@ -595,10 +718,21 @@ public:
     }
 
     // Lookup cache node only (no insert).
+    // A hit counts as a reference for the miss ratio curve; a miss does not,
+    // because the caller's subsequent acquirePinned() will record it.
     Node* find(const Id& key) {
-        return find_node(key);
+        Node* node = find_node(key);
+        if (node && node->object) sampleReference(key, node->object);
+        return node;
     }
 
+    // ========== Miss Ratio Curve ==========
+
+    // Sampled LRU reuse-distance histogram over cache references. Use it to
+    // estimate the hit rate the cache would reach at a different budget.
+    MissRatioCurve& missRatioCurve() { return _mrc; }
+    const MissRatioCurve& missRatioCurve() const { return _mrc; }
+
     // Attach a new object pointer to an existing key if present.
     Node* refresh(const Id& key, T* record) {
         Node* cn = find_node(key);
@@ -612,7 +746,13 @@ private:
         auto& shard = *getShard(key);
         return shard.find_node_internal(key);
     }
-    std::vector<std::unique_ptr<Shard>> _shards;
+
+    // Feed the miss ratio curve. The sizer only runs for sampled keys.
+    void sampleReference(const Id& id, const T* object) {
+        const uint64_t key = static_cast<uint64_t>(std::hash<Id>{}(id));
+        if (_mrc.sampled(key)) _mrc.access(key, _memorySizer(object));
+    }
+    std::vector<NodeLocalPtr<Shard>> _shards;
     size_t _shardMask;  // For fast modulo with power-of-2
     mutable std::atomic<size_t> _evictCounter;
 
@@ -627,9 +767,176 @@ private:
     mutable std::mutex _globalMapMtx;
 
     // Per-field memory tracking for multi-index memory attribution
-    std::unordered_map<std::string, size_t> _fieldMemory;  // field_name -> bytes
-    std::unordered_map<T*, std::string> _objToField;       // object -> field_name
+    // _objToField remembers the size charged at attach time so detach
+    // releases exactly that amount even if the object has grown since.
+    struct FieldCharge {
+        FieldState* field;
+        size_t bytes;
+    };
+    std::unordered_map<std::string, std::unique_ptr<FieldState>> _fields;  // field_name -> state
+    std::unordered_map<T*, FieldCharge> _objToField;                       // object -> owning field
     mutable std::mutex _fieldMemoryMtx;
+    std::atomic<bool> _hasFieldLimits{false};
+
+    // Reuse-distance sampling for budget sizing
+    MissRatioCurve _mrc;
+
+    // Requires _fieldMemoryMtx
+    FieldState* getOrCreateField(const std::string& field_name) {
+        auto& slot = _fields[field_name];
+        if (!slot) slot = std::make_unique<FieldState>();
+        return slot.get();
+    }
+
+    void attachToField(T* object, FieldState* f, size_t objSize) {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        f->bytes += objSize;
+        f->entries++;
+        _objToField[object] = FieldCharge{f, objSize};
+    }
+
+    void detachFromField(T* object) {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        auto it = _objToField.find(object);
+        if (it == _objToField.end()) return;
+        FieldState* f = it->second.field;
+        f->bytes = f->bytes >= it->second.bytes ? f->bytes - it->second.bytes : 0;
+        if (f->entries > 0) f->entries--;
+        _objToField.erase(it);
+    }
+
+    size_t fieldBytes(const FieldState* f) const {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        return f->bytes;
+    }
+
+    bool overFieldLimit(const FieldState* f) const {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        return f->quota.limitBytes > 0 && f->bytes > f->quota.limitBytes;
+    }
+
+    // Bookkeeping shared by every path that detaches an evictable node
+    void accountEvicted(Node* evicted, bool trackMemory) {
+        if (!evicted->object) return;
+
+        // Decrement memory usage (only if budget is enabled)
+        if (trackMemory) {
+            _currentMemory.fetch_sub(_memorySizer(evicted->object), std::memory_order_relaxed);
+        }
+
+        // Clean up global map
+        if (_useGlobalObjMap) {
+            std::lock_guard<std::mutex> lock(_globalMapMtx);
+            _globalObjMap.erase(evicted->object);
+        }
+
+        // Decrement per-field memory if tracked
+        detachFromField(evicted->object);
+    }
+
+    // Weighted max-min fair share of the budget (requires _fieldMemoryMtx).
+    // Each field first gets min(reservation, budget). The remainder is
+    // water-filled across fields that want more than their reservation in
+    // proportion to weight: a field that needs less than its proportional
+    // share keeps only what it uses and the rest is redistributed. Shares are
+    // capped by each field's hard limit.
+    std::unordered_map<std::string, size_t> computeEntitlements(size_t budget) const {
+        std::unordered_map<std::string, size_t> entitled;
+        entitled.reserve(_fields.size());
+
+        size_t reservedTotal = 0;
+        struct Want { const std::string* name; double weight; size_t want; };
+        std::vector<Want> wanting;
+        for (const auto& kv : _fields) {
+            const FieldState& f = *kv.second;
+            size_t reserve = std::min(f.quota.reservedBytes, budget);
+            size_t demand = f.bytes;
+            if (f.quota.limitBytes > 0) demand = std::min(demand, f.quota.limitBytes);
+            entitled[kv.first] = reserve;
+            reservedTotal += reserve;
+            if (demand > reserve) {
+                wanting.push_back({&kv.first, f.quota.weight, demand - reserve});
+            }
+        }
+
+        double leftover = budget > reservedTotal ? static_cast<double>(budget - reservedTotal) : 0.0;
+        while (!wanting.empty() && leftover > 0.0) {
+            double totalWeight = 0.0;
+            for (const auto& w : wanting) totalWeight += w.weight;
+
+            // Satisfy every field whose remaining demand fits in its share
+            bool satisfiedAny = false;
+            for (size_t i = 0; i < wanting.size();) {
+                double share = leftover * wanting[i].weight / totalWeight;
+                if (static_cast<double>(wanting[i].want) <= share) {
+                    entitled[*wanting[i].name] += wanting[i].want;
+                    leftover -= static_cast<double>(wanting[i].want);
+                    wanting[i] = wanting.back();
+                    wanting.pop_back();
+                    satisfiedAny = true;
+                } else {
+                    ++i;
+                }
+            }
+            if (satisfiedAny) continue;
+
+            // Nobody fits: split what is left by weight and stop
+            for (const auto& w : wanting) {
+                entitled[*w.name] += static_cast<size_t>(leftover * w.weight / totalWeight);
+            }
+            break;
+        }
+        return entitled;
+    }
+
+    // Choose the field to evict from and the size it should shrink to.
+    // Over the global budget, the victim is the field furthest above its fair
+    // share; otherwise only fields above their hard limit qualify.
+    // Fields in skip are passed over.
+    FieldState* pickVictimField(size_t maxMem, bool overBudget, size_t& target,
+                                const std::vector<const FieldState*>& skip) const {
+        std::lock_guard<std::mutex> lock(_fieldMemoryMtx);
+        if (_fields.empty()) return nullptr;
+
+        std::unordered_map<std::string, size_t> entitled;
+        if (overBudget) entitled = computeEntitlements(maxMem);
+
+        FieldState* victim = nullptr;
+        size_t worstExcess = 0;
+        for (const auto& kv : _fields) {
+            FieldState* f = kv.second.get();
+            size_t fieldTarget = SIZE_MAX;
+            if (f->quota.limitBytes > 0) fieldTarget = f->quota.limitBytes;
+            if (overBudget) fieldTarget = std::min(fieldTarget, entitled[kv.first]);
+            if (fieldTarget == SIZE_MAX || f->bytes <= fieldTarget) continue;
+            if (std::find(skip.begin(), skip.end(), f) != skip.end()) continue;
+
+            size_t excess = f->bytes - fieldTarget;
+            if (excess > worstExcess) {
+                worstExcess = excess;
+                victim = f;
+                target = fieldTarget;
+            }
+        }
+        return victim;
+    }
+
+    // Evict the least recently used unpinned entry of the given field
+    // (nullptr = entries added without one). Each shard keeps a list per
+    // field, so this is O(1) per shard however deep the entries sit.
+    Node* removeOneFromField(const FieldState* field) {
+        const bool trackMemory = _maxMemory.load(std::memory_order_relaxed) > 0;
+        size_t startIdx = _evictCounter.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < _shards.size(); ++i) {
+            size_t idx = (startIdx + i) & _shardMask;
+            Node* evicted = _shards[idx]->removeOneOwnedBy(field);
+            if (evicted) {
+                accountEvicted(evicted, trackMemory);
+                return evicted;
+            }
+        }
+        return nullptr;
+    }
 
     // Get shard index for an ID
     size_t getShardIndex(const Id& id) const {
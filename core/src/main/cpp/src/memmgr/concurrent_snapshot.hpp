@@ -0,0 +1,333 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xtree {
+
+/**
+ * Write gate used to fix the point in time of a concurrent snapshot.
+ *
+ * Writers bracket each modification of tracked memory with enter()/exit().
+ * A snapshot flips the epoch after publishing its capture, then waits for
+ * writers still inside the previous epoch. Writers admitted afterwards are
+ * guaranteed to see the capture and preserve pages before touching them, so
+ * no write straddles the snapshot point. Counters are striped per thread to
+ * keep the writer fast path off a shared cache line.
+ */
+class SnapshotWriteGate {
+public:
+    static constexpr size_t STRIPES = 16;
+
+    // Returns the token to pass to exit()
+    uint32_t enter() {
+        const size_t stripe = thread_stripe();
+        for (;;) {
+            const uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+            auto& counter = counters_[epoch & 1][stripe].active;
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+                return static_cast<uint32_t>(((epoch & 1) << 16) | stripe);
+            }
+            counter.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void exit(uint32_t token) {
+        counters_[token >> 16][token & 0xffff].active.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Start a new epoch and wait until every writer admitted before it has left
+    void flip_and_drain() {
+        const uint32_t old_epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        auto& stripes = counters_[old_epoch & 1];
+        for (auto& s : stripes) {
+            while (s.active.load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::atomic<uint32_t> active{0};
+    };
+
+    static size_t thread_stripe() {
+        static thread_local const size_t stripe =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) % STRIPES;
+        return stripe;
+    }
+
+    std::atomic<uint32_t> epoch_{0};
+    Stripe counters_[2][STRIPES];
+};
+
+/**
+ * Copy-on-first-write capture of a set of page-aligned regions.
+ *
+ * Instead of write-protecting all tracked memory while a snapshot is
+ * written, writers call before_write() for the pages they are about to
+ * modify. The first write to a page the streamer has not yet reached copies
+ * that page into a fixed-size side buffer; later writes to it (and writes to
+ * pages already streamed) cost a single atomic load. The streamer takes each
+ * page from the side buffer if a writer preserved it, otherwise from live
+ * memory, so the output is the image as of the snapshot point.
+ *
+ * Extra memory is bounded by max_side_pages. When the side buffer is full a
+ * writer waits for a slot; the streamer sees the waiter and writes preserved
+ * pages out of order to free slots before continuing.
+ *
+ * Page state transitions (one byte per page):
+ *   PENDING -> COPYING -> SAVED -> DONE   (writer preserved, streamer consumed)
+ *   PENDING -> COPYING -> DONE            (streamer copied live memory)
+ */
+class ConcurrentSnapshotCapture {
+public:
+    struct Region {
+        void* start_addr;
+        size_t size;          // Multiple of page size
+        size_t first_page;    // Global index of the region's first page
+    };
+
+    struct Stats {
+        uint64_t total_pages = 0;
+        uint64_t pages_preserved = 0;      // Before-images taken by writers
+        uint64_t pages_out_of_order = 0;   // Preserved pages flushed early
+        uint64_t writer_waits = 0;         // Writers that blocked on a full side buffer
+        size_t side_buffer_pages = 0;      // Capacity
+        size_t peak_side_pages = 0;        // High-water mark of slots in use
+    };
+
+    ConcurrentSnapshotCapture(const std::vector<std::pair<void*, size_t>>& regions,
+                              size_t page_size, size_t max_side_pages)
+        : page_size_(page_size),
+          side_capacity_(std::max<size_t>(1, max_side_pages)) {
+        size_t page = 0;
+        regions_.reserve(regions.size());
+        for (const auto& [addr, size] : regions) {
+            regions_.push_back(Region{addr, size, page});
+            page += size / page_size_;
+        }
+        std::sort(regions_.begin(), regions_.end(), [](const Region& a, const Region& b) {
+            return a.start_addr < b.start_addr;
+        });
+        // Renumber in address order so streaming order matches file order
+        page = 0;
+        for (auto& r : regions_) {
+            r.first_page = page;
+            page += r.size / page_size_;
+        }
+        total_pages_ = page;
+
+        states_.reset(new std::atomic<uint8_t>[total_pages_ ? total_pages_ : 1]());
+        slot_of_.reset(new uint32_t[total_pages_ ? total_pages_ : 1]);
+
+        // Reserved up front but only touched as slots are used, so an idle
+        // snapshot costs address space rather than resident memory
+        side_buffer_.reset(new char[side_capacity_ * page_size_]);
+        free_slots_.reserve(side_capacity_);
+        for (size_t i = side_capacity_; i > 0; --i) {
+            free_slots_.push_back(static_cast<uint32_t>(i - 1));
+        }
+        stats_.total_pages = total_pages_;
+        stats_.side_buffer_pages = side_capacity_;
+    }
+
+    ConcurrentSnapshotCapture(const ConcurrentSnapshotCapture&) = delete;
+    ConcurrentSnapshotCapture& operator=(const ConcurrentSnapshotCapture&) = delete;
+
+    const std::vector<Region>& regions() const { return regions_; }
+    size_t total_pages() const { return total_pages_; }
+    size_t page_size() const { return page_size_; }
+
+    // ========== Writer side ==========
+
+    // Preserve every not-yet-streamed page overlapping [ptr, ptr + len)
+    void before_write(const void* ptr, size_t len) {
+        if (len == 0) len = 1;
+        uintptr_t addr = reinterpret_cast<uintptr_t>(ptr) & ~(page_size_ - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(ptr) + len;
+        for (; addr < end; addr += page_size_) {
+            size_t page;
+            if (find_page(addr, page)) {
+                preserve_page(page, reinterpret_cast<const char*>(addr));
+            }
+        }
+    }
+
+    // ========== Streamer side (single thread) ==========
+
+    // Copy the snapshot image of page into dst. Returns false if the page
+    // was already written out of order by take_preserved().
+    bool capture_page(size_t page, const char* live, char* dst) {
+        auto& state = states_[page];
+        uint8_t expected = PENDING;
+        if (state.compare_exchange_strong(expected, COPYING, std::memory_order_acq_rel)) {
+            std::memcpy(dst, live, page_size_);
+            state.store(DONE, std::memory_order_release);
+            return true;
+        }
+        // A writer is copying the before-image; wait for it to land
+        while (expected == COPYING) {
+            std::this_thread::yield();
+            expected = state.load(std::memory_order_acquire);
+        }
+        if (expected == DONE) {
+            return false;
+        }
+        consume_saved(page, dst);
+        return true;
+    }
+
+    // Writers are blocked on a full side buffer
+    bool under_pressure() const {
+        return waiters_.load(std::memory_order_acquire) > 0;
+    }
+
+    // Pop one preserved page the streamer has not reached yet, copying its
+    // before-image to dst. Returns false when none are pending.
+    bool take_preserved(size_t& page, char* dst) {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(slot_mutex_);
+                if (preserved_.empty()) return false;
+                page = preserved_.back();
+                preserved_.pop_back();
+            }
+            // Entries already consumed in order are skipped
+            if (states_[page].load(std::memory_order_acquire) == SAVED) {
+                consume_saved(page, dst);
+                std::lock_guard<std::mutex> lock(slot_mutex_);
+                stats_.pages_out_of_order++;
+                return true;
+            }
+        }
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        return stats_;
+    }
+
+private:
+    static constexpr uint8_t PENDING = 0;
+    static constexpr uint8_t COPYING = 1;
+    static constexpr uint8_t SAVED = 2;
+    static constexpr uint8_t DONE = 3;
+
+    bool find_page(uintptr_t addr, size_t& page) const {
+        auto it = std::upper_bound(regions_.begin(), regions_.end(), addr,
+            [](uintptr_t a, const Region& r) { return a < reinterpret_cast<uintptr_t>(r.start_addr); });
+        if (it == regions_.begin()) return false;
+        --it;
+        const uintptr_t start = reinterpret_cast<uintptr_t>(it->start_addr);
+        if (addr >= start + it->size) return false;  // Registered after the snapshot point
+        page = it->first_page + (addr - start) / page_size_;
+        return true;
+    }
+
+    void preserve_page(size_t page, const char* live) {
+        auto& state = states_[page];
+        if (state.load(std::memory_order_acquire) >= SAVED) {
+            return;  // Streamed or already preserved - write freely
+        }
+
+        // Take the slot before claiming the page so a writer never holds a
+        // page in COPYING while waiting for the streamer to free space
+        const uint32_t slot = acquire_slot();
+        uint8_t expected = PENDING;
+        while (!state.compare_exchange_weak(expected, COPYING, std::memory_order_acq_rel)) {
+            if (expected >= SAVED) {
+                release_slot(slot);
+                return;
+            }
+            std::this_thread::yield();
+            expected = PENDING;
+        }
+
+        std::memcpy(side_buffer_.get() + static_cast<size_t>(slot) * page_size_, live, page_size_);
+        slot_of_[page] = slot;
+        state.store(SAVED, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        preserved_.push_back(page);
+        stats_.pages_preserved++;
+    }
+
+    void consume_saved(size_t page, char* dst) {
+        const uint32_t slot = slot_of_[page];
+        std::memcpy(dst, side_buffer_.get() + static_cast<size_t>(slot) * page_size_, page_size_);
+        states_[page].store(DONE, std::memory_order_release);
+        release_slot(slot);
+    }
+
+    uint32_t acquire_slot() {
+        std::unique_lock<std::mutex> lock(slot_mutex_);
+        if (free_slots_.empty()) {
+            stats_.writer_waits++;
+            waiters_.fetch_add(1, std::memory_order_acq_rel);
+            slot_cv_.wait(lock, [this] { return !free_slots_.empty(); });
+            waiters_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        const uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        stats_.peak_side_pages = std::max(stats_.peak_side_pages,
+                                          side_capacity_ - free_slots_.size());
+        return slot;
+    }
+
+    void release_slot(uint32_t slot) {
+        {
+            std::lock_guard<std::mutex> lock(slot_mutex_);
+            free_slots_.push_back(slot);
+        }
+        slot_cv_.notify_one();
+    }
+
+    const size_t page_size_;
+    const size_t side_capacity_;
+    std::vector<Region> regions_;
+    size_t total_pages_ = 0;
+
+    std::unique_ptr<std::atomic<uint8_t>[]> states_;
+    std::unique_ptr<uint32_t[]> slot_of_;    // Written before SAVED is published
+    std::unique_ptr<char[]> side_buffer_;
+
+    mutable std::mutex slot_mutex_;
+    std::condition_variable slot_cv_;
+    std::vector<uint32_t> free_slots_;
+    std::vector<size_t> preserved_;          // Pages in SAVED (may go stale once DONE)
+    std::atomic<uint32_t> waiters_{0};
+    Stats stats_;
+};
+
+} // namespace xtree
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <functional>
@@ -30,6 +31,8 @@
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -62,6 +65,7 @@
 #endif
 
 #include "page_write_tracker.hpp"
+#include "concurrent_snapshot.hpp"
 
 // Direct Memory COW - works with your existing packed structures
 namespace xtree {
@@ -75,6 +79,9 @@ class DataRecord;
 // Magic number: 'XTRE' = 0x58 0x54 0x52 0x45 = X T R E in ASCII
 constexpr uint32_t COW_SNAPSHOT_MAGIC = 0x58545245; // 'XTRE' in hex
 constexpr uint32_t COW_SNAPSHOT_VERSION = 1;
+// Incremental snapshot delta files: 'XTRD' = X T R D
+constexpr uint32_t COW_DELTA_MAGIC = 0x58545244;
+constexpr uint32_t COW_DELTA_VERSION = 1;
 
 /**
  * Page-aligned memory tracker for COW optimization
@@ -87,6 +94,7 @@ public:
         bool is_cow_protected;
         std::chrono::steady_clock::time_point last_modified;
         bool is_huge_page;
+        bool in_snapshot;  // Whole region captured by a base or delta snapshot
     };
     
     // Get page size at runtime for maximum compatibility
@@ -121,6 +129,21 @@ public:
 private:
     std::atomic<size_t> total_tracked_bytes_{0};
     std::unique_ptr<PageWriteTracker> write_tracker_;
+    
+    // Active concurrent snapshot, if any
+    SnapshotWriteGate write_gate_;
+    std::atomic<bool> capture_active_{false};
+    std::shared_ptr<ConcurrentSnapshotCapture> capture_;  // Accessed via std::atomic_load/store
+    
+    // A region freed during a concurrent snapshot still belongs to the
+    // image; preserve its unstreamed pages before the memory goes away.
+    // Called with regions_lock_ held.
+    void preserve_for_capture(const MemoryRegion& region) {
+        if (!capture_active_.load(std::memory_order_seq_cst)) return;
+        if (auto capture = std::atomic_load(&capture_)) {
+            capture->before_write(region.start_addr, region.size);
+        }
+    }
 
 public:
     PageAlignedMemoryTracker() 
@@ -155,6 +178,7 @@ public:
         region.is_cow_protected = false;
         region.last_modified = std::chrono::steady_clock::now();
         region.is_huge_page = false;
+        region.in_snapshot = false;
         
         // Use the aligned address as the key for O(1) lookups
         tracked_regions_[region.start_addr] = region;
@@ -190,6 +214,7 @@ public:
             region.size = aligned_end - aligned_start;
             region.is_cow_protected = false;
             region.last_modified = std::chrono::steady_clock::now();
+            region.in_snapshot = false;
             
             tracked_regions_[region.start_addr] = region;
             total_tracked_bytes_ += region.size;
@@ -258,6 +283,8 @@ public:
         
         auto it = tracked_regions_.find(key);
         if (it != tracked_regions_.end()) {
+            preserve_for_capture(it->second);
+            
             // Update total tracked bytes
             total_tracked_bytes_ -= it->second.size;
             
@@ -299,6 +326,8 @@ public:
             
             auto it = tracked_regions_.find(key);
             if (it != tracked_regions_.end()) {
+                preserve_for_capture(it->second);
+                
                 // Update total tracked bytes
                 total_tracked_bytes_ -= it->second.size;
                 
@@ -328,6 +357,13 @@ public:
         }
     }
     
+    // Record a write to [ptr, ptr + len), dirtying every page it touches
+    void record_write(const void* ptr, size_t len) {
+        if (write_tracker_) {
+            write_tracker_->record_write(ptr, len);
+        }
+    }
+    
     // Record read access for tracking access patterns
     void record_access(void* ptr) {
         if (write_tracker_) {
@@ -340,6 +376,61 @@ public:
         return write_tracker_.get();
     }
     
+    // ========== Concurrent Snapshot Capture ==========
+    
+    // Fix the snapshot point: freeze the region list, publish the capture,
+    // then wait for writers admitted before it. Returns the capture to stream.
+    std::shared_ptr<ConcurrentSnapshotCapture> begin_concurrent_capture(size_t max_side_pages) {
+        std::shared_ptr<ConcurrentSnapshotCapture> capture;
+        {
+            std::unique_lock<std::shared_mutex> lock(regions_lock_);
+            std::vector<std::pair<void*, size_t>> regions;
+            regions.reserve(tracked_regions_.size());
+            for (const auto& [addr, region] : tracked_regions_) {
+                regions.emplace_back(region.start_addr, region.size);
+            }
+            capture = std::make_shared<ConcurrentSnapshotCapture>(
+                regions, get_cached_page_size(), max_side_pages);
+            std::atomic_store(&capture_, capture);
+            capture_active_.store(true, std::memory_order_seq_cst);
+        }
+        write_gate_.flip_and_drain();
+        return capture;
+    }
+    
+    void end_concurrent_capture() {
+        capture_active_.store(false, std::memory_order_seq_cst);
+        std::atomic_store(&capture_, std::shared_ptr<ConcurrentSnapshotCapture>());
+    }
+    
+    // Bracket a modification of [ptr, ptr + len). While a concurrent
+    // snapshot is running, pages not yet streamed are preserved first.
+    uint32_t begin_write(const void* ptr, size_t len) {
+        const uint32_t token = write_gate_.enter();
+        if (auto capture = active_capture()) {
+            capture->before_write(ptr, len);
+        }
+        return token;
+    }
+    
+    void end_write(uint32_t token) {
+        write_gate_.exit(token);
+    }
+    
+    // Writers making several writes per operation enter the gate once and
+    // use the capture seen on entry for all of them, so the operation lands
+    // wholly on one side of the snapshot point
+    uint32_t enter_write_gate() {
+        return write_gate_.enter();
+    }
+    
+    std::shared_ptr<ConcurrentSnapshotCapture> active_capture() const {
+        if (!capture_active_.load(std::memory_order_seq_cst)) {
+            return nullptr;
+        }
+        return std::atomic_load(&capture_);
+    }
+    
     // Allocate page-aligned memory with high-performance Windows fallbacks
     static void* allocate_aligned(size_t size) {
         const size_t page_size = get_cached_page_size();
@@ -444,7 +535,90 @@ public:
         uint64_t root_address;       // Fixed size instead of long
         int64_t snapshot_time_us;    // Microseconds since epoch instead of time_point
     };
+
+    // Incremental delta file header. A delta holds the extents (dirty pages,
+    // or whole regions registered since the previous snapshot) that changed
+    // after snapshot parent_sequence; sequence 0 is the full base snapshot.
+    struct DeltaSnapshotHeader {
+        uint32_t magic = COW_DELTA_MAGIC;
+        uint32_t version = COW_DELTA_VERSION;
+        uint64_t sequence;           // 1, 2, ... since the base
+        uint64_t parent_sequence;    // sequence - 1 (0 = base)
+        uint64_t extent_count;
+        uint64_t total_size;         // Sum of extent sizes
+        uint64_t page_size;
+        uint64_t root_address;
+        int64_t snapshot_time_us;
+        int64_t base_time_us;        // snapshot_time_us of the base this chain applies to
+    };
+
+    // Each extent header is followed immediately by size bytes of data
+    struct DeltaExtentHeader {
+        uint64_t original_addr;
+        uint64_t size;
+    };
+
+    // Same layout as the per-region headers of a full snapshot
+    struct SnapshotRegionHeader {
+        uint64_t original_addr;
+        uint64_t size;
+        uint64_t offset_in_file;
+    };
 #pragma pack(pop)
+
+    // Snapshot strategy
+    //   FULL:        every snapshot rewrites all tracked regions
+    //   INCREMENTAL: the first snapshot is a full base; later ones write only
+    //                pages dirtied since the previous snapshot to chained delta
+    //                files (<persist_file>.delta.<seq>), merged back into the
+    //                base once the chain reaches max_delta_chain. Only pages
+    //                reported through record_operation_with_write(ptr, len)
+    //                count as dirty, so writers must report every byte range
+    //                they modify in place. For an attached index the manager
+    //                installs an IndexDetails::WriteObserver, which XTree
+    //                buckets report to from markDirty()
+    //   CONCURRENT:  full image streamed without write-protecting memory;
+    //                writers bracketed by prepare_write() copy a page into a
+    //                bounded side buffer on their first write to it, so they
+    //                keep running while the snapshot is written. Only
+    //                point-in-time if every writer is bracketed; for an
+    //                attached index the manager installs an
+    //                IndexDetails::WriteBarrier that brackets each insert
+    enum class SnapshotMode { FULL, INCREMENTAL, CONCURRENT };
+
+    // Snapshot I/O accounting - with INCREMENTAL, bytes written per snapshot
+    // follow the write rate rather than the index size
+    struct SnapshotIOStats {
+        uint64_t full_snapshots = 0;
+        uint64_t delta_snapshots = 0;
+        uint64_t merges = 0;
+        uint64_t last_bytes_written = 0;
+        uint64_t total_bytes_written = 0;
+        uint64_t last_dirty_pages = 0;
+        size_t delta_chain_length = 0;
+    };
+
+    // One region of a reconstructed snapshot image (base + deltas)
+    struct SnapshotRegionImage {
+        uint64_t original_addr;
+        std::vector<char> data;
+    };
+    
+    using ConcurrentSnapshotStats = ConcurrentSnapshotCapture::Stats;
+
+    // RAII bracket for a write to tracked memory (see prepare_write)
+    class WriteGuard {
+    public:
+        WriteGuard(PageAlignedMemoryTracker& tracker, const void* ptr, size_t len)
+            : tracker_(tracker), token_(tracker.begin_write(ptr, len)) {}
+        ~WriteGuard() { tracker_.end_write(token_); }
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+
+    private:
+        PageAlignedMemoryTracker& tracker_;
+        uint32_t token_;
+    };
     
     // Statistics
     struct MemoryCOWStats {
@@ -497,6 +671,14 @@ public:
             wait_count++;
         }
         
+        // The index may outlive us; its barrier and observer point at this manager
+        if (write_barrier_installed_) {
+            index_details_->setWriteBarrier({});
+        }
+        if (write_observer_installed_) {
+            index_details_->setWriteObserver({});
+        }
+        
         // Disable COW protection before destroying tracker
         memory_tracker_.disable_cow_protection();
         
@@ -524,12 +706,28 @@ public:
         }
     }
     
-    // Record operation with write tracking
+    // Bracket a modification of [ptr, ptr + len) so a CONCURRENT snapshot can
+    // preserve the pages first. Hold the guard until the write is complete:
+    //   { auto guard = cow->prepare_write(p, n); modify(p, n); }
+    //   cow->record_operation_with_write(p);
+    // Costs two uncontended atomics when no snapshot is running.
+    WriteGuard prepare_write(const void* ptr, size_t len) {
+        return WriteGuard(memory_tracker_, ptr, len);
+    }
+    
+    // Record operation with write tracking (marks the page of modified_ptr)
     void record_operation_with_write(void* modified_ptr) {
         memory_tracker_.record_write(modified_ptr);
         record_operation();
     }
     
+    // Record operation that modified [ptr, ptr + len). Use this form for
+    // objects that may cross a page boundary.
+    void record_operation_with_write(const void* ptr, size_t len) {
+        memory_tracker_.record_write(ptr, len);
+        record_operation();
+    }
+    
     // Batch update support
     void add_batch_update(Record* target, std::function<void()> update) {
         if (batch_coordinator_) {
@@ -564,8 +762,11 @@ public:
         auto start = std::chrono::high_resolution_clock::now();
         
         // For MMAP backend, skip COW protection as it would cause SIGSEGV without handler
-        // MMAP already provides persistence through file mapping
-        if (backend_type_ != BackendType::MMAP) {
+        // MMAP already provides persistence through file mapping.
+        // CONCURRENT snapshots preserve pages on first write instead.
+        const bool protect = backend_type_ != BackendType::MMAP &&
+                             get_snapshot_mode() != SnapshotMode::CONCURRENT;
+        if (protect) {
             // Enable COW protection on all tracked memory
             memory_tracker_.enable_cow_protection();
             cow_snapshot_active_ = true;
@@ -579,11 +780,11 @@ public:
 #endif
         
         // Background persistence
-        std::thread([this]() {
+        std::thread([this, protect]() {
             persist_memory_snapshot();
             
             // Re-enable writes (only if COW protection was enabled)
-            if (backend_type_ != BackendType::MMAP) {
+            if (protect) {
                 memory_tracker_.disable_cow_protection();
                 cow_snapshot_active_ = false;
             }
@@ -813,6 +1014,221 @@ public:
         return header;
     }
 
+    // ========== Incremental Snapshots ==========
+
+    // CONCURRENT on a manager attached to an index installs a write barrier
+    // on the index, so each insert either completes before the snapshot
+    // point or preserves the pages it touches; INCREMENTAL installs a write
+    // observer that marks every bucket an insert rewrites as dirty. Leaving
+    // either mode removes its hook. Change modes while no insert is running.
+    bool set_snapshot_mode(SnapshotMode mode) {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        if (index_details_ && (mode == SnapshotMode::INCREMENTAL) != write_observer_installed_) {
+            if (mode == SnapshotMode::INCREMENTAL) {
+                index_details_->setWriteObserver([this](const void* ptr, size_t len) {
+                    memory_tracker_.record_write(ptr, len);
+                });
+                write_observer_installed_ = true;
+            } else {
+                index_details_->setWriteObserver({});
+                write_observer_installed_ = false;
+            }
+        }
+        if (index_details_ && (mode == SnapshotMode::CONCURRENT) != write_barrier_installed_) {
+            if (mode == SnapshotMode::CONCURRENT) {
+                install_write_barrier();
+            } else {
+                index_details_->setWriteBarrier({});
+                write_barrier_installed_ = false;
+            }
+        }
+        snapshot_mode_ = mode;
+        // Whatever is on disk may not match the chain we would extend
+        base_written_ = false;
+        return true;
+    }
+
+    SnapshotMode get_snapshot_mode() const {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        return snapshot_mode_;
+    }
+
+    // Merge the delta chain into the base once it holds this many deltas
+    void set_max_delta_chain(size_t max_deltas) {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        max_delta_chain_ = std::max<size_t>(1, max_deltas);
+    }
+
+    // Write a snapshot on the calling thread (trigger_memory_snapshot() does
+    // the same in the background). Returns false if one is already running.
+    // Memory is read live, without write protection: in FULL and INCREMENTAL
+    // mode the image is only point-in-time if writers are quiesced for the
+    // call. With INCREMENTAL a page written during the copy is dirtied again
+    // and lands, complete, in the next delta. CONCURRENT mode gives a
+    // point-in-time image while writers run.
+    bool snapshot_now() {
+        if (commit_in_progress_.exchange(true)) {
+            return false;
+        }
+        operations_since_snapshot_ = 0;
+        try {
+            persist_memory_snapshot();
+        } catch (...) {
+            commit_in_progress_ = false;
+            throw;
+        }
+        commit_in_progress_ = false;
+        return true;
+    }
+
+    // Fold all pending deltas into the base snapshot.
+    // Returns the number of deltas merged.
+    size_t merge_delta_chain() {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        return merge_delta_chain_locked();
+    }
+
+    // Upper bound on before-image memory used by a CONCURRENT snapshot.
+    // Writers wait for the streamer once it is full.
+    void set_snapshot_side_buffer_bytes(size_t bytes) {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        side_buffer_bytes_ = bytes;
+    }
+
+    // Copy-on-write statistics of the most recent CONCURRENT snapshot
+    ConcurrentSnapshotStats get_concurrent_snapshot_stats() const {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        return concurrent_stats_;
+    }
+
+    std::vector<std::string> get_delta_chain() const {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        return delta_chain_;
+    }
+
+    SnapshotIOStats get_snapshot_io_stats() const {
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        SnapshotIOStats stats = io_stats_;
+        stats.delta_chain_length = delta_chain_.size();
+        return stats;
+    }
+
+    static std::string delta_file_name(const std::string& base_file, uint64_t sequence) {
+        return base_file + ".delta." + std::to_string(sequence);
+    }
+
+    // Validate a delta file's header and extent layout
+    static bool validate_delta(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        DeltaSnapshotHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.good() || header.magic != COW_DELTA_MAGIC ||
+            header.version != COW_DELTA_VERSION ||
+            header.sequence == 0 || header.parent_sequence + 1 != header.sequence) {
+            return false;
+        }
+
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < header.extent_count; i++) {
+            DeltaExtentHeader eh;
+            file.read(reinterpret_cast<char*>(&eh), sizeof(eh));
+            if (!file.good() || eh.size == 0) {
+                return false;
+            }
+            file.seekg(static_cast<std::streamoff>(eh.size), std::ios::cur);
+            total += eh.size;
+        }
+        if (total != header.total_size) {
+            return false;
+        }
+
+        // No trailing bytes
+        uint64_t end = static_cast<uint64_t>(file.tellg());
+        file.seekg(0, std::ios::end);
+        return file.good() && static_cast<uint64_t>(file.tellg()) == end;
+    }
+
+    // Rebuild the memory image described by a base snapshot plus its delta
+    // chain (base.delta.1, .2, ... up to the first gap or foreign delta).
+    static std::vector<SnapshotRegionImage> load_snapshot_chain(const std::string& base_file) {
+        std::ifstream base(base_file, std::ios::binary);
+        if (!base) {
+            throw std::runtime_error("Cannot open snapshot file: " + base_file);
+        }
+
+        MemorySnapshotHeader header;
+        base.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!base.good() || header.magic != COW_SNAPSHOT_MAGIC ||
+            header.version != COW_SNAPSHOT_VERSION) {
+            throw std::runtime_error("Invalid snapshot file format");
+        }
+
+        std::vector<SnapshotRegionHeader> region_headers(header.total_regions);
+        for (auto& rh : region_headers) {
+            base.read(reinterpret_cast<char*>(&rh), sizeof(rh));
+        }
+
+        std::vector<SnapshotRegionImage> images;
+        images.reserve(region_headers.size());
+        for (const auto& rh : region_headers) {
+            SnapshotRegionImage image{rh.original_addr, std::vector<char>(rh.size)};
+            base.seekg(static_cast<std::streamoff>(rh.offset_in_file));
+            base.read(image.data.data(), static_cast<std::streamsize>(rh.size));
+            images.push_back(std::move(image));
+        }
+        if (!base.good()) {
+            throw std::runtime_error("Truncated snapshot file: " + base_file);
+        }
+        std::sort(images.begin(), images.end(),
+                  [](const SnapshotRegionImage& a, const SnapshotRegionImage& b) {
+                      return a.original_addr < b.original_addr;
+                  });
+
+        for (uint64_t seq = 1; ; seq++) {
+            std::ifstream delta(delta_file_name(base_file, seq), std::ios::binary);
+            if (!delta) {
+                break;
+            }
+            DeltaSnapshotHeader dh{};
+            delta.read(reinterpret_cast<char*>(&dh), sizeof(dh));
+            if (!delta.good() || dh.magic != COW_DELTA_MAGIC || dh.sequence != seq ||
+                dh.base_time_us != header.snapshot_time_us) {
+                break;  // Leftover from an older chain
+            }
+
+            for (uint64_t i = 0; i < dh.extent_count; i++) {
+                DeltaExtentHeader eh;
+                delta.read(reinterpret_cast<char*>(&eh), sizeof(eh));
+                std::vector<char> data(eh.size);
+                delta.read(data.data(), static_cast<std::streamsize>(eh.size));
+                if (!delta.good()) {
+                    throw std::runtime_error("Truncated delta snapshot: " +
+                                             delta_file_name(base_file, seq));
+                }
+
+                SnapshotRegionImage* target = find_image(images, eh.original_addr, eh.size);
+                if (target) {
+                    std::memcpy(target->data.data() + (eh.original_addr - target->original_addr),
+                                data.data(), data.size());
+                } else {
+                    // Region registered after the base was written
+                    SnapshotRegionImage image{eh.original_addr, std::move(data)};
+                    auto pos = std::lower_bound(images.begin(), images.end(), eh.original_addr,
+                        [](const SnapshotRegionImage& img, uint64_t addr) {
+                            return img.original_addr < addr;
+                        });
+                    images.insert(pos, std::move(image));
+                }
+            }
+        }
+
+        return images;
+    }
+
 private:
     
     IndexDetails<Record>* index_details_;
@@ -847,8 +1263,80 @@ private:
     std::mutex snapshot_mutex_;
     std::condition_variable snapshot_cv_;
     std::atomic<bool> snapshot_requested_{false};
+
+    // Incremental snapshot state (guarded by incremental_mutex_)
+    mutable std::mutex incremental_mutex_;
+    SnapshotMode snapshot_mode_ = SnapshotMode::FULL;
+    size_t max_delta_chain_ = 8;
+    bool base_written_ = false;
+    int64_t base_time_us_ = 0;
+    uint64_t delta_sequence_ = 0;
+    std::vector<std::string> delta_chain_;
+    SnapshotIOStats io_stats_;
+    size_t side_buffer_bytes_ = 16 * 1024 * 1024;
+    ConcurrentSnapshotStats concurrent_stats_;
+    
+    // Pages buffered between streamer writes
+    static constexpr size_t CONCURRENT_CHUNK_PAGES = 256;
+
+    // Index write barrier state. The token and capture belong to the insert
+    // in progress; inserts run one at a time (see IndexDetails::WriteBarrier).
+    bool write_barrier_installed_ = false;
+    bool write_observer_installed_ = false;  // INCREMENTAL dirty-page reporting
+    uint32_t index_write_token_ = 0;
+    std::shared_ptr<ConcurrentSnapshotCapture> index_write_capture_;
+
+    // Root address as of the snapshot point, recorded by whichever comes
+    // first: the first insert to preserve its writes or the streamer
+    static constexpr uint64_t NO_ROOT = ~uint64_t(0);
+    std::atomic<uint64_t> capture_root_{NO_ROOT};
+
+    void install_write_barrier() {
+        typename IndexDetails<Record>::WriteBarrier barrier;
+        barrier.begin = [this]() {
+            index_write_token_ = memory_tracker_.enter_write_gate();
+            index_write_capture_ = memory_tracker_.active_capture();
+            if (!index_write_capture_) {
+                return false;
+            }
+            // Before this insert can move the root
+            record_capture_root();
+            return true;
+        };
+        barrier.end = [this]() {
+            index_write_capture_.reset();
+            memory_tracker_.end_write(index_write_token_);
+        };
+        barrier.prepare = [this](const void* ptr, size_t len) {
+            index_write_capture_->before_write(ptr, len);
+        };
+        index_details_->setWriteBarrier(std::move(barrier));
+        write_barrier_installed_ = true;
+    }
+
+    void record_capture_root() {
+        if (!index_details_ || capture_root_.load(std::memory_order_seq_cst) != NO_ROOT) {
+            return;
+        }
+        uint64_t expected = NO_ROOT;
+        capture_root_.compare_exchange_strong(
+            expected, static_cast<uint64_t>(index_details_->getRootAddress()),
+            std::memory_order_seq_cst);
+    }
     
     void persist_memory_snapshot() {
+        {
+            std::lock_guard<std::mutex> lock(incremental_mutex_);
+            if (snapshot_mode_ == SnapshotMode::INCREMENTAL) {
+                // Deltas are plain file writes, independent of the backend
+                persist_incremental_snapshot_locked();
+                return;
+            }
+        }
+        if (get_snapshot_mode() == SnapshotMode::CONCURRENT) {
+            persist_concurrent_snapshot();
+            return;
+        }
         if (backend_type_ == BackendType::MMAP) {
             persist_memory_snapshot_mmap();
         } else {
@@ -925,6 +1413,382 @@ private:
         rename_file_atomic(temp_file, persist_file_);
     }
     
+    // Stream a full snapshot (same format as persist_memory_snapshot_traditional)
+    // while writers keep running. Pages come from the capture's side buffer
+    // if a writer preserved them, otherwise from live memory.
+    void persist_concurrent_snapshot() {
+        size_t side_pages;
+        {
+            std::lock_guard<std::mutex> lock(incremental_mutex_);
+            side_pages = side_buffer_bytes_ / PageAlignedMemoryTracker::get_cached_page_size();
+        }
+
+        capture_root_.store(NO_ROOT, std::memory_order_seq_cst);
+        auto capture = memory_tracker_.begin_concurrent_capture(side_pages);
+        // Writers admitted before the snapshot point have drained; if no
+        // insert has started since, the live root is the snapshot's root
+        record_capture_root();
+        uint64_t bytes = 0;
+        try {
+            bytes = stream_capture_to_file(*capture);
+        } catch (...) {
+            memory_tracker_.end_concurrent_capture();
+            throw;
+        }
+        memory_tracker_.end_concurrent_capture();
+
+        std::lock_guard<std::mutex> lock(incremental_mutex_);
+        concurrent_stats_ = capture->stats();
+        io_stats_.full_snapshots++;
+        io_stats_.last_dirty_pages = 0;
+        io_stats_.last_bytes_written = bytes;
+        io_stats_.total_bytes_written += bytes;
+    }
+
+    uint64_t stream_capture_to_file(ConcurrentSnapshotCapture& capture) {
+        const size_t page_size = capture.page_size();
+        const auto& regions = capture.regions();
+
+        std::string temp_file = persist_file_ + ".tmp";
+        std::ofstream file(temp_file, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to create memory snapshot file");
+        }
+
+        // The root may have moved since the snapshot point
+        MemorySnapshotHeader header = prepare_snapshot_header();
+        if (index_details_) {
+            header.root_address = capture_root_.load(std::memory_order_seq_cst);
+        }
+        header.total_regions = regions.size();
+        header.total_size = static_cast<uint64_t>(capture.total_pages()) * page_size;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const uint64_t data_start = sizeof(MemorySnapshotHeader) +
+                                    sizeof(SnapshotRegionHeader) * regions.size();
+        for (const auto& region : regions) {
+            SnapshotRegionHeader rh{
+                reinterpret_cast<uint64_t>(region.start_addr),
+                static_cast<uint64_t>(region.size),
+                data_start + static_cast<uint64_t>(region.first_page) * page_size
+            };
+            file.write(reinterpret_cast<const char*>(&rh), sizeof(rh));
+        }
+
+        // Pages are written in file order through a chunk buffer. Pages a
+        // writer preserved are written early, at their own offset, when
+        // writers are waiting for side buffer space; the in-order pass then
+        // skips them.
+        std::vector<char> chunk(CONCURRENT_CHUNK_PAGES * page_size);
+        size_t chunk_first = 0;
+        size_t chunk_pages = 0;
+        auto flush_chunk = [&]() {
+            if (chunk_pages == 0) return;
+            file.seekp(static_cast<std::streamoff>(data_start + chunk_first * page_size));
+            file.write(chunk.data(), static_cast<std::streamsize>(chunk_pages * page_size));
+            chunk_pages = 0;
+        };
+
+        std::vector<char> page_buf(page_size);
+        for (const auto& region : regions) {
+            const char* base = static_cast<const char*>(region.start_addr);
+            const size_t pages = region.size / page_size;
+            for (size_t i = 0; i < pages; ++i) {
+                if (capture.under_pressure()) {
+                    flush_chunk();
+                    size_t preserved;
+                    while (capture.under_pressure() &&
+                           capture.take_preserved(preserved, page_buf.data())) {
+                        file.seekp(static_cast<std::streamoff>(data_start + preserved * page_size));
+                        file.write(page_buf.data(), static_cast<std::streamsize>(page_size));
+                    }
+                }
+
+                const size_t page = region.first_page + i;
+                if (chunk_pages == 0) chunk_first = page;
+                if (capture.capture_page(page, base + i * page_size,
+                                         chunk.data() + chunk_pages * page_size)) {
+                    if (++chunk_pages == CONCURRENT_CHUNK_PAGES) flush_chunk();
+                } else {
+                    flush_chunk();  // Already written out of order
+                }
+            }
+        }
+        flush_chunk();
+
+        if (!file.good()) {
+            throw std::runtime_error("Failed to write memory snapshot");
+        }
+        file.close();
+        rename_file_atomic(temp_file, persist_file_);
+        return header.total_size;
+    }
+
+    // Write a full base, or a delta of the pages dirtied since the previous
+    // snapshot. Requires incremental_mutex_.
+    void persist_incremental_snapshot_locked() {
+        if (!base_written_ || !file_exists(persist_file_)) {
+            write_base_snapshot_locked();
+            return;
+        }
+
+        try {
+            write_delta_snapshot_locked();
+        } catch (...) {
+            // Dirty bits for this delta are gone - only a new base is safe now
+            base_written_ = false;
+            throw;
+        }
+
+        if (delta_chain_.size() >= max_delta_chain_) {
+            merge_delta_chain_locked();
+        }
+    }
+
+    void write_base_snapshot_locked() {
+        // Everything from here on is captured by the base. Dirty bits are
+        // cleared before the copy, so a page written during it is re-dirtied
+        // and lands in the next delta.
+        if (auto* tracker = memory_tracker_.get_write_tracker()) {
+            tracker->collect_dirty_pages();
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(memory_tracker_.regions_lock_);
+            for (auto& [addr, region] : memory_tracker_.tracked_regions_) {
+                region.in_snapshot = true;
+            }
+        }
+
+        persist_memory_snapshot_traditional();
+
+        MemorySnapshotHeader header = get_snapshot_header(persist_file_);
+        remove_delta_files_locked();
+        base_written_ = true;
+        base_time_us_ = header.snapshot_time_us;
+        delta_sequence_ = 0;
+
+        io_stats_.full_snapshots++;
+        io_stats_.last_dirty_pages = 0;
+        io_stats_.last_bytes_written = header.total_size;
+        io_stats_.total_bytes_written += header.total_size;
+    }
+
+    void write_delta_snapshot_locked() {
+        const size_t page_size = PageAlignedMemoryTracker::get_cached_page_size();
+
+        std::vector<void*> dirty;
+        if (auto* tracker = memory_tracker_.get_write_tracker()) {
+            dirty = tracker->collect_dirty_pages();
+        }
+        std::sort(dirty.begin(), dirty.end());
+
+        // Copy changed extents while holding the lock, write after releasing it
+        std::vector<std::pair<uint64_t, std::vector<char>>> extents;
+        {
+            std::unique_lock<std::shared_mutex> lock(memory_tracker_.regions_lock_);
+
+            std::vector<PageAlignedMemoryTracker::MemoryRegion*> regions;
+            regions.reserve(memory_tracker_.tracked_regions_.size());
+            for (auto& [addr, region] : memory_tracker_.tracked_regions_) {
+                regions.push_back(&region);
+            }
+            std::sort(regions.begin(), regions.end(),
+                      [](const auto* a, const auto* b) { return a->start_addr < b->start_addr; });
+
+            // Regions never captured before go in whole
+            std::vector<bool> copied_whole(regions.size(), false);
+            for (size_t i = 0; i < regions.size(); i++) {
+                auto* r = regions[i];
+                if (!r->in_snapshot) {
+                    const char* src = static_cast<const char*>(r->start_addr);
+                    extents.emplace_back(reinterpret_cast<uint64_t>(r->start_addr),
+                                         std::vector<char>(src, src + r->size));
+                    r->in_snapshot = true;
+                    copied_whole[i] = true;
+                }
+            }
+
+            // Dirty pages of captured regions; adjacent pages share an extent.
+            // Pages outside every region belong to freed memory and are skipped.
+            size_t extend_idx = SIZE_MAX;
+            uintptr_t extend_end = 0;
+            for (void* page : dirty) {
+                uintptr_t p = reinterpret_cast<uintptr_t>(page);
+                auto it = std::upper_bound(regions.begin(), regions.end(), p,
+                    [](uintptr_t addr, const auto* r) {
+                        return addr < reinterpret_cast<uintptr_t>(r->start_addr);
+                    });
+                if (it == regions.begin()) continue;
+                --it;
+                size_t ri = static_cast<size_t>(it - regions.begin());
+                uintptr_t rstart = reinterpret_cast<uintptr_t>((*it)->start_addr);
+                if (p >= rstart + (*it)->size || copied_whole[ri]) continue;
+
+                const char* src = reinterpret_cast<const char*>(p);
+                if (extend_idx != SIZE_MAX && p == extend_end && p != rstart) {
+                    auto& data = extents[extend_idx].second;
+                    data.insert(data.end(), src, src + page_size);
+                } else {
+                    extents.emplace_back(p, std::vector<char>(src, src + page_size));
+                    extend_idx = extents.size() - 1;
+                }
+                extend_end = p + page_size;
+            }
+        }
+
+        const uint64_t sequence = delta_sequence_ + 1;
+        DeltaSnapshotHeader header{};
+        header.sequence = sequence;
+        header.parent_sequence = delta_sequence_;
+        header.extent_count = extents.size();
+        header.total_size = 0;
+        for (const auto& [addr, data] : extents) {
+            header.total_size += data.size();
+        }
+        header.page_size = page_size;
+        header.root_address = index_details_ ?
+            static_cast<uint64_t>(index_details_->getRootAddress()) : 0;
+        header.snapshot_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.base_time_us = base_time_us_;
+
+        const std::string final_file = delta_file_name(persist_file_, sequence);
+        const std::string temp_file = final_file + ".tmp";
+        {
+            std::ofstream file(temp_file, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to create delta snapshot file");
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto& [addr, data] : extents) {
+                DeltaExtentHeader eh{addr, static_cast<uint64_t>(data.size())};
+                file.write(reinterpret_cast<const char*>(&eh), sizeof(eh));
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            }
+            if (!file.good()) {
+                throw std::runtime_error("Failed to write delta snapshot");
+            }
+        }
+        rename_file_atomic(temp_file, final_file);
+
+        delta_sequence_ = sequence;
+        delta_chain_.push_back(final_file);
+
+        io_stats_.delta_snapshots++;
+        io_stats_.last_dirty_pages = dirty.size();
+        io_stats_.last_bytes_written = header.total_size;
+        io_stats_.total_bytes_written += header.total_size;
+    }
+
+    // Patch the base in place with every delta, in order. Replaying a delta
+    // twice is harmless, so a crash mid-merge leaves base + chain loadable.
+    // Extents for regions registered after the base cannot be patched in;
+    // in that case a fresh base is written instead.
+    size_t merge_delta_chain_locked() {
+        if (delta_chain_.empty()) {
+            return 0;
+        }
+        const size_t merged = delta_chain_.size();
+
+        std::fstream base(persist_file_, std::ios::in | std::ios::out | std::ios::binary);
+        MemorySnapshotHeader header;
+        base.read(reinterpret_cast<char*>(&header), sizeof(header));
+        bool in_place = base.good() && header.magic == COW_SNAPSHOT_MAGIC;
+
+        std::vector<SnapshotRegionHeader> regions(in_place ? header.total_regions : 0);
+        for (auto& rh : regions) {
+            base.read(reinterpret_cast<char*>(&rh), sizeof(rh));
+        }
+        std::sort(regions.begin(), regions.end(),
+                  [](const SnapshotRegionHeader& a, const SnapshotRegionHeader& b) {
+                      return a.original_addr < b.original_addr;
+                  });
+
+        uint64_t bytes_written = 0;
+        uint64_t root_address = header.root_address;
+        for (const auto& delta_file : delta_chain_) {
+            if (!in_place) break;
+            std::ifstream delta(delta_file, std::ios::binary);
+            DeltaSnapshotHeader dh{};
+            delta.read(reinterpret_cast<char*>(&dh), sizeof(dh));
+            if (!delta.good() || dh.magic != COW_DELTA_MAGIC) {
+                in_place = false;
+                break;
+            }
+            for (uint64_t i = 0; i < dh.extent_count && in_place; i++) {
+                DeltaExtentHeader eh;
+                delta.read(reinterpret_cast<char*>(&eh), sizeof(eh));
+                std::vector<char> data(eh.size);
+                delta.read(data.data(), static_cast<std::streamsize>(eh.size));
+
+                auto it = std::upper_bound(regions.begin(), regions.end(), eh.original_addr,
+                    [](uint64_t addr, const SnapshotRegionHeader& r) {
+                        return addr < r.original_addr;
+                    });
+                if (!delta.good() || it == regions.begin() ||
+                    eh.original_addr + eh.size > (it - 1)->original_addr + (it - 1)->size) {
+                    in_place = false;
+                    break;
+                }
+                --it;
+                base.seekp(static_cast<std::streamoff>(
+                    it->offset_in_file + (eh.original_addr - it->original_addr)));
+                base.write(data.data(), static_cast<std::streamsize>(data.size()));
+                bytes_written += data.size();
+            }
+            root_address = dh.root_address;
+        }
+
+        if (in_place) {
+            // Stamping a new time detaches the merged deltas from the base
+            header.root_address = root_address;
+            header.snapshot_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            base.seekp(0);
+            base.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            base.flush();
+            in_place = base.good();
+        }
+        base.close();
+
+        if (!in_place) {
+            write_base_snapshot_locked();
+        } else {
+            remove_delta_files_locked();
+            base_time_us_ = header.snapshot_time_us;
+            delta_sequence_ = 0;
+            io_stats_.total_bytes_written += bytes_written;
+        }
+        io_stats_.merges++;
+        return merged;
+    }
+
+    // Remove the current chain plus any leftovers from an earlier one
+    void remove_delta_files_locked() {
+        for (const auto& delta_file : delta_chain_) {
+            std::remove(delta_file.c_str());
+        }
+        delta_chain_.clear();
+        for (uint64_t seq = 1; file_exists(delta_file_name(persist_file_, seq)); seq++) {
+            std::remove(delta_file_name(persist_file_, seq).c_str());
+        }
+    }
+
+    static bool file_exists(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return file.good();
+    }
+
+    static SnapshotRegionImage* find_image(std::vector<SnapshotRegionImage>& images,
+                                           uint64_t addr, uint64_t size) {
+        auto it = std::upper_bound(images.begin(), images.end(), addr,
+            [](uint64_t a, const SnapshotRegionImage& img) { return a < img.original_addr; });
+        if (it == images.begin()) return nullptr;
+        --it;
+        if (addr + size > it->original_addr + it->data.size()) return nullptr;
+        return &*it;
+    }
+
     void rename_file_atomic(const std::string& temp_file, const std::string& final_file) {
 #ifdef _WIN32
         // Windows rename fails if target exists, so delete it first
@@ -0,0 +1,307 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace xtree {
+
+/**
+ * Small-object arena on 2 MB pages for the in-memory tree (buckets, key
+ * nodes and keys), so a random descent touches a few huge TLB entries
+ * instead of one 4 KB entry per node.
+ *
+ * One address range is reserved up front and committed one 2 MB chunk at a
+ * time. A chunk is backed by a hugetlb page when that mode is selected and
+ * the pool has one; otherwise it is advised MADV_HUGEPAGE so transparent
+ * huge pages back it. Each chunk serves a single size class, so a freed
+ * object's class is known from its address alone. Freed objects are reused
+ * by their class and never returned to the OS.
+ *
+ * Threads are spread over kShards shards, each with its own free list and
+ * bump slab per class, so concurrent inserts do not serialize on one lock
+ * per class. A shard refills by carving a kSlabBytes slab from its class's
+ * current chunk; only that and committing a chunk take a shared lock. An
+ * object freed on another thread joins that thread's shard.
+ *
+ * Off unless XTREE_HUGE_PAGES is set (see parse_mode). allocate() returns
+ * nullptr when the arena is off, the size is above kMaxObjectSize, or the
+ * reservation is used up; callers fall back to the global operator new.
+ */
+class HugePageArena {
+public:
+    enum class Mode : uint8_t { Off, THP, HugeTLB };
+
+    static constexpr size_t kChunkSize = 2 * 1024 * 1024;
+    static constexpr size_t kGranule = 16;
+    static constexpr size_t kMaxObjectSize = 1024;
+    static constexpr size_t kNumClasses = kMaxObjectSize / kGranule;
+    static constexpr size_t kDefaultReserve = 64ULL << 30;   // address space only
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kSlabBytes = 64 * 1024;
+
+    struct Stats {
+        size_t chunks = 0;           // committed chunks
+        size_t hugetlb_chunks = 0;   // of those, backed by the hugetlb pool
+        size_t thp_chunks = 0;       // of those, advised MADV_HUGEPAGE
+        size_t live_objects = 0;
+        size_t live_bytes = 0;       // rounded to the size class
+    };
+
+    explicit HugePageArena(size_t reserve_bytes = kDefaultReserve)
+        : reserve_((reserve_bytes + kChunkSize - 1) / kChunkSize * kChunkSize),
+          chunk_class_(reserve_ / kChunkSize, 0) {}
+
+    ~HugePageArena() {
+#ifdef __linux__
+        if (const uintptr_t b = base_.load(std::memory_order_relaxed)) {
+            ::munmap(reinterpret_cast<void*>(b), reserve_);
+        }
+#endif
+    }
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // Process-wide arena used by the tree's class-scope operator new. Never
+    // destroyed: objects may still be freed during static destruction.
+    static HugePageArena& global() {
+        static HugePageArena* arena = [] {
+            auto* a = new HugePageArena();
+            a->set_mode(mode_from_env());
+            return a;
+        }();
+        return *arena;
+    }
+
+    // XTREE_HUGE_PAGES: "1", "true" or "thp" for THP chunks, "hugetlb" to
+    // try the hugetlb pool first. StorageConfig::parseHugePages() reads the
+    // same variable for mmap windows through this.
+    static Mode parse_mode(const char* str) {
+        if (!str) return Mode::Off;
+        const std::string v(str);
+        if (v == "hugetlb") return Mode::HugeTLB;
+        if (v == "1" || v == "thp" || v == "true") return Mode::THP;
+        return Mode::Off;
+    }
+
+    static Mode mode_from_env() {
+        return parse_mode(std::getenv("XTREE_HUGE_PAGES"));
+    }
+
+    // Turning the arena off only stops new allocations; objects it handed
+    // out are still recognized and freed by deallocate()
+    void set_mode(Mode m) { mode_.store(m, std::memory_order_relaxed); }
+    Mode mode() const { return mode_.load(std::memory_order_relaxed); }
+    bool enabled() const { return mode() != Mode::Off; }
+
+    void* allocate(size_t size) noexcept {
+        if (size > kMaxObjectSize || !enabled()) {
+            return nullptr;
+        }
+        const size_t cls = size == 0 ? 0 : (size - 1) / kGranule;
+        const size_t sz = (cls + 1) * kGranule;
+        Shard& sh = shards_[shard_index()][cls];
+
+        std::lock_guard<std::mutex> lock(sh.mu);
+        if (sh.free) {
+            void* p = sh.free;
+            sh.free = *static_cast<void**>(p);
+            sh.live++;
+            return p;
+        }
+        if (sh.bump + sz > sh.end && !refill_slab(sh, cls, sz)) {
+            return nullptr;
+        }
+        void* p = reinterpret_cast<void*>(sh.bump);
+        sh.bump += sz;
+        sh.live++;
+        return p;
+    }
+
+    bool owns(const void* p) const noexcept {
+        const uintptr_t b = base_.load(std::memory_order_acquire);
+        return b && reinterpret_cast<uintptr_t>(p) - b < reserve_;
+    }
+
+    // p must come from allocate() on this arena
+    void deallocate(void* p) noexcept {
+        const size_t chunk = (reinterpret_cast<uintptr_t>(p) - base_.load(std::memory_order_relaxed)) / kChunkSize;
+        Shard& sh = shards_[shard_index()][chunk_class_[chunk] - 1];
+        std::lock_guard<std::mutex> lock(sh.mu);
+        *static_cast<void**>(p) = sh.free;
+        sh.free = p;
+        sh.live--;
+    }
+
+    Stats stats() {
+        Stats s;
+        s.chunks = chunks_.load(std::memory_order_relaxed);
+        s.hugetlb_chunks = hugetlb_chunks_.load(std::memory_order_relaxed);
+        s.thp_chunks = thp_chunks_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kNumClasses; ++i) {
+            // Per-shard counts go negative when frees cross threads
+            int64_t live = 0;
+            for (auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard[i].mu);
+                live += shard[i].live;
+            }
+            s.live_objects += static_cast<size_t>(live);
+            s.live_bytes += static_cast<size_t>(live) * (i + 1) * kGranule;
+        }
+        return s;
+    }
+
+private:
+    // One size class within one shard
+    struct alignas(64) Shard {
+        std::mutex mu;
+        void* free = nullptr;        // intrusive list through the first word
+        uintptr_t bump = 0;          // next unused byte of the shard's slab
+        uintptr_t end = 0;
+        int64_t live = 0;
+    };
+
+    // Chunk a class's slabs are carved from, shared by all shards
+    struct ClassChunk {
+        uintptr_t bump = 0;
+        uintptr_t end = 0;
+    };
+
+    // Threads take shards round robin on first use, for every arena
+    static size_t shard_index() noexcept {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return index;
+    }
+
+    // Point sh at a fresh slab of whole sz-byte objects. Called with sh.mu held.
+    bool refill_slab(Shard& sh, size_t cls, size_t sz) noexcept {
+        const size_t bytes = kSlabBytes / sz * sz;
+        std::lock_guard<std::mutex> lock(chunk_mu_);
+        ClassChunk& c = class_chunks_[cls];
+        if (c.bump + sz > c.end) {
+            const uintptr_t chunk = commit_chunk_locked(static_cast<uint8_t>(cls));
+            if (!chunk) {
+                return false;
+            }
+            c.bump = chunk;
+            c.end = chunk + kChunkSize;
+        }
+        sh.bump = c.bump;
+        sh.end = std::min(c.bump + bytes, c.end);
+        c.bump = sh.end;
+        return true;
+    }
+
+    // Start of a freshly committed chunk for class cls, or 0. Called with
+    // chunk_mu_ held.
+    uintptr_t commit_chunk_locked(uint8_t cls) noexcept {
+#ifdef __linux__
+        if (!reserve_locked() || next_chunk_ == chunk_class_.size()) {
+            return 0;
+        }
+        void* addr = reinterpret_cast<void*>(base_.load(std::memory_order_relaxed) + next_chunk_ * kChunkSize);
+        constexpr int prot = PROT_READ | PROT_WRITE;
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+
+        bool hugetlb = false;
+#ifdef MAP_HUGETLB
+        if (mode() == Mode::HugeTLB) {
+            hugetlb = ::mmap(addr, kChunkSize, prot, flags | MAP_HUGETLB, -1, 0) != MAP_FAILED;
+        }
+#endif
+        if (!hugetlb) {
+            // Also restores the reservation if the hugetlb attempt dropped it
+            if (::mmap(addr, kChunkSize, prot, flags, -1, 0) == MAP_FAILED) {
+                return 0;
+            }
+#ifdef MADV_HUGEPAGE
+            if (::madvise(addr, kChunkSize, MADV_HUGEPAGE) == 0) {
+                thp_chunks_.fetch_add(1, std::memory_order_relaxed);
+            }
+#endif
+        } else {
+            hugetlb_chunks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        chunk_class_[next_chunk_++] = static_cast<uint8_t>(cls + 1);
+        chunks_.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<uintptr_t>(addr);
+#else
+        (void)cls;
+        return 0;
+#endif
+    }
+
+    // Reserve the chunk-aligned range on first use. Called with chunk_mu_ held.
+    bool reserve_locked() noexcept {
+#ifdef __linux__
+        if (base_.load(std::memory_order_relaxed)) return true;
+        if (reserve_failed_) return false;
+        const size_t len = reserve_ + kChunkSize;
+        void* p = ::mmap(nullptr, len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) {
+            reserve_failed_ = true;
+            return false;
+        }
+        const uintptr_t raw = reinterpret_cast<uintptr_t>(p);
+        const uintptr_t aligned = (raw + kChunkSize - 1) & ~(uintptr_t(kChunkSize) - 1);
+        if (aligned > raw) {
+            ::munmap(p, aligned - raw);
+        }
+        if (const size_t tail = raw + len - (aligned + reserve_)) {
+            ::munmap(reinterpret_cast<void*>(aligned + reserve_), tail);
+        }
+        base_.store(aligned, std::memory_order_release);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const size_t reserve_;
+    std::atomic<Mode> mode_{Mode::Off};
+    std::atomic<uintptr_t> base_{0};
+
+    std::mutex chunk_mu_;
+    size_t next_chunk_ = 0;                  // guarded by chunk_mu_
+    bool reserve_failed_ = false;            // guarded by chunk_mu_
+    std::vector<uint8_t> chunk_class_;       // size class + 1 per committed chunk
+    std::array<ClassChunk, kNumClasses> class_chunks_;  // guarded by chunk_mu_
+
+    std::array<std::array<Shard, kNumClasses>, kShards> shards_;
+    std::atomic<size_t> chunks_{0};
+    std::atomic<size_t> hugetlb_chunks_{0};
+    std::atomic<size_t> thp_chunks_{0};
+};
+
+} // namespace xtree
@@ -27,6 +27,7 @@
 #include <shared_mutex>
 #include <unordered_map>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
@@ -149,6 +150,7 @@ public:
         std::atomic<uint32_t> access_count{0};
         std::atomic<uint64_t> last_write_epoch{0}; // Epoch time to avoid frequent clock calls
         std::atomic<bool> is_hot{false};
+        std::atomic<bool> dirty{false};             // Written since last collect_dirty_pages()
         std::atomic_flag spinlock = ATOMIC_FLAG_INIT;
         
         // Default constructor
@@ -159,7 +161,8 @@ public:
             : write_count(other.write_count.load(std::memory_order_relaxed)),
               access_count(other.access_count.load(std::memory_order_relaxed)),
               last_write_epoch(other.last_write_epoch.load(std::memory_order_relaxed)),
-              is_hot(other.is_hot.load(std::memory_order_relaxed)) {}
+              is_hot(other.is_hot.load(std::memory_order_relaxed)),
+              dirty(other.dirty.load(std::memory_order_relaxed)) {}
         
         // Assignment operator
         PageStats& operator=(const PageStats& other) {
@@ -168,16 +171,19 @@ public:
                 access_count.store(other.access_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
                 last_write_epoch.store(other.last_write_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
                 is_hot.store(other.is_hot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                dirty.store(other.dirty.load(std::memory_order_relaxed), std::memory_order_relaxed);
             }
             return *this;
         }
         
-        // Lock-free operations
-        void increment_writes(uint32_t hot_threshold) {
+        // Lock-free operations. Returns true if this write made the page dirty.
+        bool increment_writes(uint32_t hot_threshold) {
             uint32_t writes = write_count.fetch_add(1, std::memory_order_relaxed) + 1;
+            const bool was_dirty = dirty.exchange(true, std::memory_order_acq_rel);
             if (writes >= hot_threshold && !is_hot.load(std::memory_order_relaxed)) {
                 is_hot.store(true, std::memory_order_relaxed);
             }
+            return !was_dirty;
         }
         
         void increment_access() {
@@ -229,6 +235,11 @@ private:
     std::array<std::atomic<HashEntry*>, HASH_TABLE_SIZE> hash_table_;
     ObjectPool<HashEntry, 8192> entry_pool_; // Pool for overflow entries
     
+    // Pages that turned dirty since the last collect_dirty_pages(), so
+    // collecting costs O(dirty pages) instead of a full table scan
+    std::vector<std::pair<void*, HashEntry*>> dirty_list_;
+    mutable std::mutex dirty_mutex_;
+    
     const size_t page_size_;
     const uint32_t hot_write_threshold_;
     const size_t page_shift_bits_;  // Cached bit shift value for page size
@@ -338,6 +349,44 @@ private:
         return &new_entry->stats;
     }
     
+    void mark_page_written(void* page) {
+        // Lazy timer initialization - zero overhead after first call
+        static std::once_flag timer_initialized;
+        std::call_once(timer_initialized, [this]() {
+            start_epoch_timer();
+        });
+        
+        // Check thread-local cache first - with Windows safety
+        PageStats* stats = nullptr;
+#ifdef _WIN32
+        try {
+            auto& tl_cache = get_tl_cache();
+            stats = tl_cache.find(page);
+            if (!stats) {
+                stats = find_or_create_stats(page);
+                tl_cache.insert(page, stats);
+            }
+        } catch (...) {
+            // Fallback to direct lookup without cache on Windows TLS issues
+            stats = find_or_create_stats(page);
+        }
+#else
+        auto& tl_cache = get_tl_cache();
+        stats = tl_cache.find(page);
+        if (!stats) {
+            stats = find_or_create_stats(page);
+            tl_cache.insert(page, stats);
+        }
+#endif
+        if (stats->increment_writes(hot_write_threshold_)) {
+            HashEntry* entry = reinterpret_cast<HashEntry*>(
+                reinterpret_cast<char*>(stats) - offsetof(HashEntry, stats));
+            std::lock_guard<std::mutex> lock(dirty_mutex_);
+            dirty_list_.emplace_back(page, entry);
+        }
+        stats->update_timestamp(current_epoch_.load(std::memory_order_relaxed));
+    }
+    
     static size_t calculate_page_shift(size_t page_size) {
         size_t bits = 0;
         size_t temp = page_size;
@@ -432,41 +481,18 @@ public:
     }
     
     void record_write(void* ptr) {
-        void* page = get_page_base(ptr);
-        
-        // Lazy timer initialization - zero overhead after first call
-        static std::once_flag timer_initialized;
-        std::call_once(timer_initialized, [this]() {
-            start_epoch_timer();
-        });
-        
-        // Check thread-local cache first - with Windows safety
-#ifdef _WIN32
-        try {
-            auto& tl_cache = get_tl_cache();
-            PageStats* stats = tl_cache.find(page);
-            if (!stats) {
-                stats = find_or_create_stats(page);
-                tl_cache.insert(page, stats);
-            }
-            stats->increment_writes(hot_write_threshold_);
-            stats->update_timestamp(current_epoch_.load(std::memory_order_relaxed));
-        } catch (...) {
-            // Fallback to direct lookup without cache on Windows TLS issues
-            PageStats* stats = find_or_create_stats(page);
-            stats->increment_writes(hot_write_threshold_);
-            stats->update_timestamp(current_epoch_.load(std::memory_order_relaxed));
-        }
-#else
-        auto& tl_cache = get_tl_cache();
-        PageStats* stats = tl_cache.find(page);
-        if (!stats) {
-            stats = find_or_create_stats(page);
-            tl_cache.insert(page, stats);
+        mark_page_written(get_page_base(ptr));
+    }
+    
+    // Mark every page of [ptr, ptr + len); a node that crosses a page
+    // boundary dirties both pages
+    void record_write(const void* ptr, size_t len) {
+        if (len == 0) return;
+        uintptr_t page = reinterpret_cast<uintptr_t>(get_page_base(const_cast<void*>(ptr)));
+        const uintptr_t end = reinterpret_cast<uintptr_t>(ptr) + len;
+        for (; page < end; page += page_size_) {
+            mark_page_written(reinterpret_cast<void*>(page));
         }
-        stats->increment_writes(hot_write_threshold_);
-        stats->update_timestamp(current_epoch_.load(std::memory_order_relaxed));
-#endif
     }
     
     void record_access(void* ptr) {
@@ -537,6 +563,10 @@ public:
     }
     
     void reset_stats() {
+        {
+            std::lock_guard<std::mutex> lock(dirty_mutex_);
+            dirty_list_.clear();
+        }
         // Clear all entries
         for (size_t i = 0; i < HASH_TABLE_SIZE; ++i) {
             HashEntry* current = hash_table_[i].load(std::memory_order_acquire);
@@ -562,6 +592,32 @@ public:
         return count;
     }
     
+    // Pages written since the previous call, clearing their dirty bits.
+    // A write racing with the collection is either returned now or left
+    // dirty (and listed again) for the next call, never lost.
+    std::vector<void*> collect_dirty_pages() {
+        std::vector<std::pair<void*, HashEntry*>> listed;
+        {
+            std::lock_guard<std::mutex> lock(dirty_mutex_);
+            listed.swap(dirty_list_);
+        }
+        std::vector<void*> dirty_pages;
+        dirty_pages.reserve(listed.size());
+        for (const auto& [page, entry] : listed) {
+            // Skip entries reset and reused for another page since
+            if (entry->page.load(std::memory_order_acquire) == page &&
+                entry->stats.dirty.exchange(false, std::memory_order_acq_rel)) {
+                dirty_pages.push_back(page);
+            }
+        }
+        return dirty_pages;
+    }
+
+    size_t get_dirty_page_count() const {
+        std::lock_guard<std::mutex> lock(dirty_mutex_);
+        return dirty_list_.size();
+    }
+
     void prefault_hot_pages() {
         auto hot_pages = get_hot_pages();
         
@@ -438,6 +438,10 @@ void CheckpointCoordinator::do_checkpoint_impl(uint64_t epoch, int post_op_int)
   
   // Track successful checkpoint
   last_checkpoint_epoch_.store(epoch, std::memory_order_release);
+  if (reclaimer_) {
+    // Retires up to here can no longer be undone by a crash
+    reclaimer_->set_durable_epoch(epoch);
+  }
 
   // Clean up old checkpoints (keep most recent based on policy)
   OTCheckpoint::cleanup_old_checkpoints(manifest_.get_data_dir(), policy_.checkpoint_keep_count);
@@ -461,7 +465,8 @@ void CheckpointCoordinator::do_checkpoint_impl(uint64_t epoch, int post_op_int)
                               (policy_.max_replay_bytes / 2);
     static std::atomic<uint64_t> every{0};
     if (heavy_replay || (every.fetch_add(1, std::memory_order_relaxed) % 10 == 0)) {
-      size_t reclaimed = reclaimer_->run_once();
+      // Commits after the checkpoint epoch may not be durable yet
+      size_t reclaimed = reclaimer_->run_durable();
       if (reclaimed) report_metrics();
     }
   }
@@ -48,6 +48,10 @@ public:
     // Reset to initial state
     void reset() { value_ = ~0u; }
     
+    // Copy len bytes from src to dst and fold them into the CRC in the same
+    // pass: each L1-sized chunk is checksummed from dst right after it lands
+    void update_copy(void* dst, const void* src, size_t len);
+    
     // One-shot computation
     static uint32_t compute(const void* data, size_t len);
     static uint32_t compute(const uint8_t* data, size_t len) {
@@ -57,15 +61,25 @@ public:
         return compute(data.data(), data.size());
     }
     
-    // Combine two CRCs (useful for parallel computation)
+    // One-shot copy + CRC of the copied bytes
+    static uint32_t copy_compute(void* dst, const void* src, size_t len);
+    
+    // Combine two CRCs: crc1 of A and crc2 of B (len2 bytes) gives the CRC of AB
     static uint32_t combine(uint32_t crc1, uint32_t crc2, size_t len2);
     
+    // Buffers at least this long are split into three interleaved streams
+    // when the CPU has carry-less multiply to recombine them
+    static constexpr size_t kInterleaveMin = 1024;
+    
     // Public for benchmarking
     static uint32_t software_crc32c(uint32_t crc, const uint8_t* data, size_t len);
     
     #if defined(__x86_64__) || defined(_M_X64)
     static bool has_sse42();
+    static bool has_pclmul();
     static uint32_t hardware_crc32c(uint32_t crc, const uint8_t* data, size_t len);
+    // Single dependent _mm_crc32_u64 chain, the pre-interleave baseline
+    static uint32_t hardware_crc32c_serial(uint32_t crc, const uint8_t* data, size_t len);
     #endif
     
     #if defined(__aarch64__) || defined(_M_ARM64)
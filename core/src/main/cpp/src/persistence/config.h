@@ -54,6 +54,9 @@ namespace sys_config {
         size_t page = get_page_size();
         return ((size + page - 1) / page) * page;
     }
+
+    // PMD-level huge page (x86-64, arm64 with 4KB base pages)
+    constexpr size_t kHugePageSize = 2 * 1024 * 1024;
 }
 
 // Size class configuration
@@ -103,6 +106,12 @@ namespace object_table {
     constexpr const char* kSlabSizeEnvVar = "XTREE_OT_SLAB_KB";
     constexpr size_t kMinSlabKB = 64;   // Minimum 64KB slabs
     constexpr size_t kMaxSlabKB = 1024; // Maximum 1MB slabs
+
+    // Per-thread free-handle caches: allocate() pops from the calling
+    // thread's cache without taking the table mutex, refilling
+    // kHandleCacheRefill handles at a time from the free bitmap
+    constexpr size_t kHandleCacheSize = 64;
+    constexpr size_t kHandleCacheRefill = 32;
 }
 
 // Segment allocator configuration
@@ -116,6 +125,16 @@ namespace segment {
     // Many SSDs have 4MB erase blocks; NVMe typically uses 512KB-2MB stripes
     // Using 2MB alignment provides good balance for most storage types
     constexpr size_t kSegmentAlignment = 2 * 1024 * 1024;     // 2MB alignment
+    static_assert(kSegmentAlignment % sys_config::kHugePageSize == 0,
+                  "segments must start on huge page boundaries");
+
+    // Per-thread block magazines (tcmalloc-style allocation caches)
+    // Each thread caches up to kThreadCacheBytes per size class, capped at
+    // kMagazineMaxBlocks; classes that would cache fewer than
+    // kMagazineMinBlocks go straight to the segment bitmaps.
+    constexpr size_t kThreadCacheBytes = 256 * 1024;
+    constexpr size_t kMagazineMaxBlocks = 64;
+    constexpr size_t kMagazineMinBlocks = 4;
 }
 
 // MVCC configuration
@@ -125,6 +144,12 @@ namespace mvcc {
     constexpr size_t kMaxPinSlots = 65536;                    // Maximum concurrent readers
 }
 
+// Background reclamation
+namespace reclaim {
+    constexpr size_t kPressureThreshold = 4096;               // Retired handles that trigger a pass
+    constexpr uint32_t kPollIntervalMs = 20;                  // Backlog check cadence
+}
+
 // Superblock configuration
 namespace superblock {
     constexpr uint64_t kMagic = 0x5854524545505331ULL;        // "XTREEPS1"
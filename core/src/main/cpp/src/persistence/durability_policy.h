@@ -32,6 +32,15 @@ struct DurabilityPolicy {
     bool use_fdatasync = true;          // Use fdatasync vs fsync where possible
     size_t group_commit_interval_ms = 5;  // Group commit window in milliseconds
     bool sync_on_commit = false;        // EVENTUAL mode: whether to sync on commit
+
+    // Read snapshots (see snapshot_registry.h)
+    size_t snapshot_retained_commits = 0;  // Keep the last N commits openable by epoch (0 = pinned snapshots only)
+    std::chrono::milliseconds snapshot_open_timeout{10000};  // Max wait for an in-flight batch to commit
+
+    // Republishing a committed node writes it to a new block that replaces the
+    // old one at commit, so the files never hold a half-rewritten committed
+    // node (read-only replicas map them while the writer runs)
+    bool relocate_on_republish = true;
 };
 
 // Helper to get a named policy
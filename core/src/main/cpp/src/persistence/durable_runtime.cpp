@@ -21,6 +21,7 @@
 #include "recovery.h"
 #include "ot_checkpoint.h"
 #include "node_id.hpp"
+#include "../util/log.h"
 
 #include <stdexcept>
 #include <iostream>
@@ -57,6 +58,23 @@ namespace xtree {
             recovery.cold_start();
         }
 
+        // The allocator keeps no occupancy on disk: claim the block of every
+        // live node again, or new nodes would be written over them
+        if (!read_only) {
+            std::vector<OTCheckpoint::PersistentEntry> live;
+            rt->ot_sharded_->iterate_live_snapshot(live);
+            size_t unmapped = 0;
+            for (const auto& e : live) {
+                if (!rt->alloc_->restore_live_block(e.class_id, e.file_id, e.segment_id, e.offset, e.length)) {
+                    unmapped++;
+                }
+            }
+            if (unmapped) {
+                warning() << "DurableRuntime: " << unmapped << " of " << live.size()
+                          << " live nodes could not be mapped in " << paths.data_dir;
+            }
+        }
+
         // Load catalog from manifest first (if available)
         rt->load_catalog_from_manifest();
 
@@ -96,6 +114,9 @@ namespace xtree {
             // Set read-only mode on allocator for serverless readers
             if (read_only_) {
                 alloc_->set_read_only(true);
+            } else {
+                // Reclaim returns retired and relocated blocks to the allocator
+                ot_sharded_->set_segment_allocator(alloc_.get());
             }
 
             superblock_ = std::make_unique<Superblock>(paths_.superblock);
@@ -114,10 +135,13 @@ namespace xtree {
         }
 
         DurableRuntime::~DurableRuntime() { 
+            stop_replica();
             stop(); 
             
-            // Seal the current log in the manifest before closing
-            if (manifest_) {
+            // Seal the current log in the manifest before closing. A
+            // read-only runtime never owns the log (a writer may still be
+            // appending to it) and must not rewrite the manifest.
+            if (manifest_ && !read_only_) {
                 auto log = std::atomic_load(&active_log_);
                 if (log) {
                     // Get the current epoch as the end epoch
@@ -154,13 +178,82 @@ namespace xtree {
 
         void DurableRuntime::start() {
             coordinator_->start();
+            reclaimer_->start();
         }
 
         void DurableRuntime::stop() {
+            if (reclaimer_) reclaimer_->stop();
             if (coordinator_) coordinator_->stop();
             // Note: We don't close the log here - that's done in destructor
         }
 
+        ReplicaTailer* DurableRuntime::replica_tailer() {
+            if (!read_only_) {
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> lk(replica_mu_);
+            if (!replica_) {
+                replica_ = std::make_unique<ReplicaTailer>(*superblock_, *ot_sharded_, *mvcc_,
+                                                           paths_.data_dir,
+                                                           manifest_->get_checkpoint().epoch);
+            }
+            return replica_.get();
+        }
+
+        void DurableRuntime::apply_replica_advance(const ReplicaAdvance& adv) {
+            // Background and explicit rounds may finish out of order
+            std::lock_guard<std::mutex> apply_lk(replica_apply_mu_);
+            if (adv.to_epoch <= replica_catalog_epoch_) {
+                return;
+            }
+            replica_catalog_epoch_ = adv.to_epoch;
+
+            // The tailer's catalog matches the records it applied; the
+            // manifest on disk may already be newer
+            std::lock_guard<std::mutex> lk(catalog_mu_);
+            if (!adv.roots.empty()) {
+                replace_catalog_locked(adv.roots);
+            }
+            if (adv.root.valid()) {
+                catalog_[""] = adv.root;
+            }
+            replica_generation_.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        bool DurableRuntime::start_replica(const ReplicaOptions& options) {
+            ReplicaTailer* tailer = replica_tailer();
+            if (!tailer) {
+                return false;
+            }
+            return tailer->start(options, [this](const ReplicaAdvance& adv) {
+                apply_replica_advance(adv);
+            });
+        }
+
+        void DurableRuntime::stop_replica() {
+            std::lock_guard<std::mutex> lk(replica_mu_);
+            if (replica_) {
+                replica_->stop();
+            }
+        }
+
+        bool DurableRuntime::catch_up() {
+            ReplicaTailer* tailer = replica_tailer();
+            if (!tailer) {
+                return false;
+            }
+            ReplicaAdvance adv = tailer->catch_up();
+            if (adv.advanced()) {
+                apply_replica_advance(adv);
+            }
+            return true;
+        }
+
+        std::vector<uint64_t> DurableRuntime::take_replica_changes() {
+            std::lock_guard<std::mutex> lk(replica_mu_);
+            return replica_ ? replica_->take_changed() : std::vector<uint64_t>{};
+        }
+
         NodeID DurableRuntime::get_root(std::string_view name) const {
             std::lock_guard<std::mutex> lk(catalog_mu_);
             auto it = catalog_.find(std::string(name));
@@ -224,6 +317,7 @@ namespace xtree {
             }
             
             // Update manifest with root catalog
+            std::lock_guard<std::mutex> roots_lk(manifest_roots_mu_);
             manifest_->set_roots(entries);
             if (manifest_->store()) {
                 catalog_epoch_.store(epoch, std::memory_order_release);
@@ -233,6 +327,27 @@ namespace xtree {
             }
         }
         
+        size_t DurableRuntime::raise_access_counts(const std::unordered_map<std::string, uint64_t>& counts) {
+            if (read_only_) {
+                return 0;
+            }
+            std::lock_guard<std::mutex> roots_lk(manifest_roots_mu_);
+            auto roots = manifest_->get_roots();
+            size_t changed = 0;
+            for (auto& root : roots) {
+                auto it = counts.find(root.name);
+                if (it != counts.end() && it->second > root.access_count) {
+                    root.access_count = it->second;
+                    changed++;
+                }
+            }
+            if (changed == 0) {
+                return 0;
+            }
+            manifest_->set_roots(roots);
+            return manifest_->store() ? changed : 0;
+        }
+
         void DurableRuntime::load_catalog_from_manifest() {
             // Try to load existing manifest
             if (!manifest_->load()) {
@@ -246,6 +361,10 @@ namespace xtree {
             
             // Populate catalog from manifest
             std::lock_guard<std::mutex> lk(catalog_mu_);
+            replace_catalog_locked(roots);
+        }
+
+        void DurableRuntime::replace_catalog_locked(const std::vector<Manifest::RootEntry>& roots) {
             catalog_.clear();
             catalog_mbrs_.clear();
             
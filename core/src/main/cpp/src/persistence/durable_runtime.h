@@ -33,6 +33,7 @@
 #include "superblock.hpp"
 #include "checkpoint_coordinator.h"
 #include "recovery.h"
+#include "replica_tailer.h"
 
 namespace xtree {
     namespace persist {
@@ -77,11 +78,36 @@ namespace xtree {
             void load_catalog_from_manifest();
             bool is_catalog_dirty() const { return catalog_dirty_.load(std::memory_order_acquire); }
 
+            // Raise the access counts of catalog roots by name and store the
+            // manifest. Goes through this runtime's Manifest, which the
+            // checkpoint coordinator and log GC also write, so neither side
+            // rolls back the other. Returns the number of roots raised; a
+            // read-only runtime never writes the writer's manifest and returns 0.
+            size_t raise_access_counts(const std::unordered_map<std::string, uint64_t>& counts);
+
+            // Read-only replica catch-up (see replica_tailer.h). The first call
+            // to either catch_up() or start_replica() applies the log records
+            // committed since the checkpoint the runtime was opened from; the
+            // catalog follows every advance. Both return false on a writable
+            // runtime.
+            bool start_replica(const ReplicaOptions& options = {});
+            void stop_replica();
+            bool catch_up();
+            // Bumped after the catalog moved to a newer epoch
+            uint64_t replica_generation() const {
+                return replica_generation_.load(std::memory_order_acquire);
+            }
+            // Raw NodeIDs whose entries changed since the last call
+            std::vector<uint64_t> take_replica_changes();
+
         private:
             DurableRuntime(Paths, CheckpointPolicy, bool read_only = false,
                           const std::string& field_name = "");
             void start();
             void stop();
+            ReplicaTailer* replica_tailer();
+            void apply_replica_advance(const ReplicaAdvance& adv);
+            void replace_catalog_locked(const std::vector<Manifest::RootEntry>& roots);
 
         private:
             Paths paths_;
@@ -105,6 +131,13 @@ namespace xtree {
             std::unordered_map<std::string, std::vector<float>> catalog_mbrs_;  // Root MBRs
             std::atomic<bool> catalog_dirty_{false};
             std::atomic<uint64_t> catalog_epoch_{0};
+            std::mutex manifest_roots_mu_;  // serializes root catalog writes to manifest_
+
+            std::mutex replica_mu_;                    // guards creation of replica_
+            std::unique_ptr<ReplicaTailer> replica_;   // read-only runtimes only
+            std::mutex replica_apply_mu_;              // orders catalog refreshes
+            uint64_t replica_catalog_epoch_ = 0;
+            std::atomic<uint64_t> replica_generation_{0};
         };
 
     } // namespace persist
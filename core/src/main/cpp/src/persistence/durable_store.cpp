@@ -33,8 +33,60 @@
 namespace xtree {
     namespace persist {
         
-        // Define thread-local batch storage
-        thread_local DurableStore::ThreadBatch DurableStore::tl_batch_;
+        // Per-thread batches of every store the thread writes to
+        struct DurableStore::ThreadBatches {
+            uint64_t last_id = 0;           // Most recent store, skips the lookup
+            ThreadBatch* last = nullptr;
+            std::unordered_map<uint64_t, std::shared_ptr<ThreadBatch>> by_store;
+
+            // Drop the batches of stores destroyed since
+            void prune() {
+                for (auto it = by_store.begin(); it != by_store.end();) {
+                    if (it->second->orphaned.load(std::memory_order_acquire)) {
+                        it = by_store.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+        };
+
+        namespace {
+            std::atomic<uint64_t> next_store_id{1};
+        }
+
+        DurableStore::ThreadBatches& DurableStore::thread_batches() {
+            thread_local ThreadBatches batches;
+            return batches;
+        }
+
+        DurableStore::ThreadBatch& DurableStore::tl_batch() const {
+            ThreadBatches& batches = thread_batches();
+            if (batches.last_id != store_id_) {
+                auto& batch = batches.by_store[store_id_];
+                if (!batch) {
+                    batch = std::make_shared<ThreadBatch>();
+                    {
+                        std::lock_guard<std::mutex> lock(batches_mu_);
+                        // Threads that have exited already freed theirs
+                        batches_.erase(std::remove_if(batches_.begin(), batches_.end(),
+                                                      [](const std::weak_ptr<ThreadBatch>& w) { return w.expired(); }),
+                                       batches_.end());
+                        batches_.push_back(batch);
+                    }
+                    batches.prune();
+                }
+                batches.last_id = store_id_;
+                batches.last = batch.get();
+            }
+            return *batches.last;
+        }
+
+        size_t DurableStore::thread_batch_count() {
+            ThreadBatches& batches = thread_batches();
+            batches.prune();
+            return batches.by_store.size();
+        }
         
         // Helper functions for creating delta records
         static inline OTDeltaRec make_alloc_delta(NodeID id, const OTEntry& e) {
@@ -69,21 +121,72 @@ namespace xtree {
             return d;
         }
 
+        // Point a delta at the block a staged relocation moves the node to
+        template <class Batch>
+        static inline void relocate_delta(const Batch& batch, uint64_t handle, OTDeltaRec& d) {
+            auto it = batch.relocations.find(handle);
+            if (it == batch.relocations.end()) return;
+            d.file_id    = it->second.to.file_id;
+            d.segment_id = it->second.to.segment_id;
+            d.offset     = it->second.to.offset;
+        }
+
         DurableStore::DurableStore(DurableContext& ctx, std::string name, DurabilityPolicy policy) 
-            : ctx_(ctx), name_(std::move(name)), policy_(std::move(policy)) {}
+            : ctx_(ctx), name_(std::move(name)), policy_(std::move(policy)),
+              snapshots_(ctx.mvcc, policy_.snapshot_retained_commits, policy_.snapshot_open_timeout),
+              store_id_(next_store_id.fetch_add(1, std::memory_order_relaxed)) {}
 
         DurableStore::~DurableStore() {
             // Ensure any pending writes are flushed
-            if (!tl_batch_.writes.empty() || !tl_batch_.retirements.empty()) {
+            if (!tl_batch().writes.empty() || !tl_batch().retirements.empty()) {
                 // Log warning - uncommitted writes at destruction
                 // In production, consider throwing or forcing a commit
             }
+            // Empty the batches left on other threads, whose staged nodes point
+            // into mappings that go away with the store; each thread drops the
+            // orphaned batch itself the next time it opens one
+            std::vector<std::shared_ptr<ThreadBatch>> live;
+            {
+                std::lock_guard<std::mutex> lock(batches_mu_);
+                for (auto& w : batches_) {
+                    if (auto batch = w.lock()) live.push_back(std::move(batch));
+                }
+                batches_.clear();
+            }
+            for (auto& batch : live) {
+                batch->clear();
+                batch->orphaned.store(true, std::memory_order_release);
+            }
+            ThreadBatches& batches = thread_batches();
+            batches.by_store.erase(store_id_);
+            if (batches.last_id == store_id_) {
+                batches.last_id = 0;
+                batches.last = nullptr;
+            }
         }
 
         AllocResult DurableStore::allocate_node(size_t min_len, NodeKind kind) {
+            return allocate_node(min_len, kind, PlacementHint{});
+        }
+
+        AllocResult DurableStore::allocate_node(size_t min_len, NodeKind kind, const PlacementHint& hint) {
+            // Where the hinted node lives, if it still has an allocation
+            SegmentAllocator::Allocation near;
+            if (hint.near.valid() && hint.near.handle_index() != 0) {
+                const OTEntry* e = ctx_.ot.try_get_by_handle(hint.near.handle_index());
+                if (e && ctx_.ot.validate_tag(hint.near)) {
+                    near.file_id = e->addr.file_id;
+                    near.segment_id = e->addr.segment_id;
+                    near.offset = e->addr.offset;
+                    near.length = e->addr.length;
+                    near.class_id = e->class_id;
+                }
+            }
+
             // Choose size-class and allocate from SegmentAllocator
             // Pass NodeKind to determine file type (.xi for tree nodes, .xd for data records)
-            auto a = ctx_.alloc.allocate(min_len, kind);
+            auto a = near.is_valid() ? ctx_.alloc.allocate(min_len, kind, near)
+                                     : ctx_.alloc.allocate(min_len, kind);
             
             // Check if allocation failed (returns all zeros)
             if (!a.is_valid()) {
@@ -125,7 +228,7 @@ namespace xtree {
 
             // Stage the uncommitted node for tx-local visibility
             // This allows the writer to see its own uncommitted nodes
-            tl_batch_.pending_nodes[id.handle_index()] = { vaddr, a.length };
+            tl_batch().pending_nodes[id.handle_index()] = { vaddr, a.length };
 
             // Return the allocation result with the destination pointer
             return { id, vaddr, a.length };
@@ -162,7 +265,12 @@ namespace xtree {
             // This is safe because we hold the handle (it's not in free list)
             uint64_t h = id.handle_index();
             const auto& e = ctx_.ot.get_by_handle_unsafe(h);
-            void* dst_vaddr = e.addr.vaddr;
+
+            // Republishing a committed node replaces its previous version
+            preserve_for_snapshots(id, e);
+
+            // Nodes recovered from disk carry no vaddr until mapped
+            void* dst_vaddr = write_ptr(id, e);
             size_t capacity = e.addr.length;
             
             // Bounds check - CRITICAL: Detect buffer overflow
@@ -195,6 +303,7 @@ namespace xtree {
             // Build delta with the NodeID's tag (computed at allocation)
             OTDeltaRec delta = make_alloc_delta(id, e);
             delta.tag = id.tag();  // Use the tag from allocation
+            relocate_delta(tl_batch(), h, delta);
             
             // Policy-based staging (NO WAL APPENDS HERE)
             switch (policy_.mode) {
@@ -204,7 +313,7 @@ namespace xtree {
                     if (data && dst_vaddr && len > 0) {
                         std::memcpy(dst_vaddr, data, len);
                         // Track for flush at commit (reduces syscalls)
-                        tl_batch_.dirty_ranges.push_back(DirtyRange{
+                        tl_batch().dirty_ranges.push_back(DirtyRange{
                             dst_vaddr,
                             static_cast<uint32_t>(len)
                         });
@@ -216,16 +325,13 @@ namespace xtree {
                 case DurabilityMode::BALANCED: {
                     // BALANCED: Small payloads staged for WAL, large to segments
                     if (data && dst_vaddr && len > 0) {
-                        // Always copy to segment first
-                        std::memcpy(dst_vaddr, data, len);
+                        // Always copy to segment first, checksumming in the
+                        // same pass (both sizes need the CRC)
+                        delta.data_crc32c = CRC32C::copy_compute(dst_vaddr, data, len);
                         
-                        if (len <= policy_.max_payload_in_wal) {
-                            // Small node: compute CRC for WAL inclusion
-                            delta.data_crc32c = crc32c(data, len);
-                        } else {
-                            // Large node: compute CRC and track for flush
-                            delta.data_crc32c = crc32c(dst_vaddr, len);
-                            tl_batch_.dirty_ranges.push_back(DirtyRange{
+                        if (len > policy_.max_payload_in_wal) {
+                            // Large node: track for flush
+                            tl_batch().dirty_ranges.push_back(DirtyRange{
                                 dst_vaddr,
                                 static_cast<uint32_t>(len)
                             });
@@ -238,17 +344,16 @@ namespace xtree {
                 case DurabilityMode::EVENTUAL: {
                     // EVENTUAL: Prefer payload-in-WAL for small nodes
                     if (data && dst_vaddr && len > 0) {
-                        // Always copy to segment
-                        std::memcpy(dst_vaddr, data, len);
-                        
                         if (len <= policy_.max_payload_in_wal) {
-                            // Small node: CRC for payload-in-WAL
-                            delta.data_crc32c = crc32c(data, len);
+                            // Small node: copy to segment with the CRC for
+                            // payload-in-WAL computed in the same pass
+                            delta.data_crc32c = CRC32C::copy_compute(dst_vaddr, data, len);
                         } else {
-                            // Large node: no CRC in EVENTUAL mode (best-effort)
+                            // Large node: copy only, no CRC in EVENTUAL mode (best-effort)
+                            std::memcpy(dst_vaddr, data, len);
                             delta.data_crc32c = 0;
                             // Track dirty for checkpoint/rotation flush
-                            tl_batch_.dirty_ranges.push_back(DirtyRange{
+                            tl_batch().dirty_ranges.push_back(DirtyRange{
                                 dst_vaddr,
                                 static_cast<uint32_t>(len)
                             });
@@ -260,7 +365,7 @@ namespace xtree {
             }
             
             // Track for batch operations (DO NOT mark_live here)
-            tl_batch_.stage_write(PendingWrite{
+            tl_batch().stage_write(PendingWrite{
                 .id = id,
                 .len = static_cast<uint32_t>(len),
                 .delta = delta,
@@ -272,7 +377,7 @@ namespace xtree {
             // This ensures writer can read back its own uncommitted changes
             // We update with actual length used (not allocated capacity)
             if (dst_vaddr && len > 0) {
-                tl_batch_.pending_nodes[id.handle_index()] = { dst_vaddr, len };
+                tl_batch().pending_nodes[id.handle_index()] = { dst_vaddr, len };
             }
         }
         
@@ -286,7 +391,7 @@ namespace xtree {
             const uint64_t h = id.handle_index();
             const auto& e = ctx_.ot.get_by_handle_unsafe(h);
             
-            void* dst_vaddr = e.addr.vaddr;
+            void* dst_vaddr = write_ptr(id, e);
             size_t capacity = e.addr.length;
             
             // Basic guards
@@ -310,6 +415,7 @@ namespace xtree {
             // Build delta using the same helper as publish_node()
             OTDeltaRec delta = make_alloc_delta(id, e);
             delta.tag = id.tag();  // Tag assigned at allocation time
+            relocate_delta(tl_batch(), h, delta);
             
             // Policy handling — mirror publish_node(), but use dst_vaddr as the source.
             bool include_payload_in_wal = false;
@@ -318,7 +424,7 @@ namespace xtree {
                 case DurabilityMode::STRICT: {
                     // STRICT: no WAL payload; data must be flushed before WAL append.
                     // Track dirty range so commit() can msync.
-                    tl_batch_.dirty_ranges.push_back(DirtyRange{
+                    tl_batch().dirty_ranges.push_back(DirtyRange{
                         dst_vaddr, static_cast<uint32_t>(len)
                     });
                     
@@ -339,7 +445,7 @@ namespace xtree {
                     } else {
                         // Large: no WAL payload; flush mapped bytes and include CRC over dst.
                         delta.data_crc32c = crc32c(dst_vaddr, len);
-                        tl_batch_.dirty_ranges.push_back(DirtyRange{
+                        tl_batch().dirty_ranges.push_back(DirtyRange{
                             dst_vaddr, static_cast<uint32_t>(len)
                         });
                         include_payload_in_wal = false;
@@ -356,7 +462,7 @@ namespace xtree {
                     } else {
                         // Large: best-effort; skip CRC, rely on future checkpoint/flush.
                         delta.data_crc32c = 0;
-                        tl_batch_.dirty_ranges.push_back(DirtyRange{
+                        tl_batch().dirty_ranges.push_back(DirtyRange{
                             dst_vaddr, static_cast<uint32_t>(len)
                         });
                         include_payload_in_wal = false;
@@ -366,7 +472,7 @@ namespace xtree {
             }
             
             // Queue the write for the batch; WAL builder can read from dst_vaddr at commit.
-            tl_batch_.stage_write(PendingWrite{
+            tl_batch().stage_write(PendingWrite{
                 .id = id,
                 .len = static_cast<uint32_t>(len),
                 .delta = delta,
@@ -377,7 +483,7 @@ namespace xtree {
             // Update tx-local staging for in-place published content
             // The data is already at dst_vaddr from caller's serialization
             if (dst_vaddr && len > 0) {
-                tl_batch_.pending_nodes[id.handle_index()] = { dst_vaddr, len };
+                tl_batch().pending_nodes[id.handle_index()] = { dst_vaddr, len };
             }
 
             // IMPORTANT: no memcpy here — payload already resides at dst_vaddr
@@ -423,8 +529,8 @@ namespace xtree {
 
             // Check tx-local staging for uncommitted nodes (writer visibility)
             if (is_uncommitted) {
-                auto it = tl_batch_.pending_nodes.find(id.handle_index());
-                if (it != tl_batch_.pending_nodes.end()) {
+                auto it = tl_batch().pending_nodes.find(id.handle_index());
+                if (it != tl_batch().pending_nodes.end()) {
                     // Return the staged buffer for this uncommitted node
                     return it->second;
                 }
@@ -438,6 +544,12 @@ namespace xtree {
                 return { nullptr, 0 };
             }
 
+            // Committed node this batch rewrites: its new block
+            auto moved = tl_batch().relocations.find(id.handle_index());
+            if (moved != tl_batch().relocations.end()) {
+                return { moved->second.to.vaddr, moved->second.to.length };
+            }
+
             // Committed node: use the address from ObjectTable
             void* ptr = e->addr.vaddr;
             if (ptr == nullptr) {
@@ -480,8 +592,8 @@ namespace xtree {
 
             // Check tx-local staging for uncommitted nodes
             if (is_uncommitted) {
-                auto it = tl_batch_.pending_nodes.find(id.handle_index());
-                if (it != tl_batch_.pending_nodes.end()) {
+                auto it = tl_batch().pending_nodes.find(id.handle_index());
+                if (it != tl_batch().pending_nodes.end()) {
                     // For uncommitted nodes, we can't truly "pin" since they're in mmap'd segments
                     // but not yet committed. Return a pseudo-pinned reference to the staging buffer.
                     // Note: The Pin will be empty, but data/size are valid
@@ -496,6 +608,13 @@ namespace xtree {
                 return {};
             }
 
+            // Committed node this batch rewrites: its new block, which the
+            // batch keeps mapped until commit
+            auto moved = tl_batch().relocations.find(id.handle_index());
+            if (moved != tl_batch().relocations.end()) {
+                return { MappingManager::Pin{}, moved->second.to.vaddr, moved->second.to.length };
+            }
+
             // Committed node: create a proper pinned mapping
             // Resolve file + offset for pinned mapping
             uint32_t file_id = e->addr.segment_id >> 16;  // Top 16 bits are file_id
@@ -519,6 +638,34 @@ namespace xtree {
             }
         }
 
+        void DurableStore::prefetch_node(NodeID id) const {
+            bool is_uncommitted = false;
+            const OTEntry* e = resolve_entry(id, is_uncommitted);
+            // Staged nodes are already in memory
+            if (!e || is_uncommitted || e->addr.length == 0) return;
+
+            // Same lookup as read_node(): recovered nodes have no cached vaddr
+            void* ptr = e->addr.vaddr;
+            if (!ptr) {
+                ptr = ctx_.alloc.get_ptr_for_recovery(
+                    e->class_id, e->addr.file_id, e->addr.segment_id,
+                    e->addr.offset, e->addr.length);
+                if (!ptr) return;
+            }
+
+            // Siblings are often allocated side by side; skip a node on the
+            // page this thread just advised
+            const uintptr_t kWindow = sys_config::get_page_size();
+            thread_local uintptr_t last_window = ~uintptr_t(0);
+            const uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+            const uintptr_t first = begin / kWindow;
+            const uintptr_t last = (begin + e->addr.length - 1) / kWindow;
+            if (first == last && first == last_window) return;
+            last_window = last;
+            PlatformFS::prefetch(reinterpret_cast<void*>(first * kWindow),
+                                 (last - first + 1) * kWindow);
+        }
+
         void DurableStore::retire_node(NodeID id,
                                        uint64_t retire_epoch_hint,
                                        RetireReason why,
@@ -556,7 +703,7 @@ namespace xtree {
             // Check if attempting to retire a non-LIVE entry
             if (e.birth_epoch.load(std::memory_order_relaxed) == 0) {
                 // Check if this node will be made live in this batch
-                if (!tl_batch_.will_publish(id)) {
+                if (!tl_batch().will_publish(id)) {
                     trace() << "    [ERROR] Attempting to retire RESERVED node NOT in pending writes!" << std::endl;
                     trace() << "    This is a bug - node won't be made live before retirement" << std::endl;
                     assert(false && "Retire called on uncommitted node not in same batch");
@@ -574,11 +721,12 @@ namespace xtree {
 
             // Build retirement delta (epoch stamped at commit)
             OTDeltaRec delta = make_retire_delta(id, e);
+            relocate_delta(tl_batch(), id.handle_index(), delta);
 
             // DO NOT append to WAL here - just stage it
 
             // Track for batch operations (DO NOT mark_retired here)
-            tl_batch_.retirements.emplace_back(delta);
+            tl_batch().retirements.emplace_back(delta);
             
             // Note: retire_epoch_hint is ignored - we always use commit epoch
             (void)retire_epoch_hint;
@@ -686,7 +834,7 @@ namespace xtree {
 
                 // If this NodeID is in the current batch, remove it so we won't try to commit it
                 const uint64_t raw = id.raw();
-                bool canceled = tl_batch_.cancel_write_by_raw(raw);
+                bool canceled = tl_batch().cancel_write_by_raw(raw);
 #ifndef NDEBUG
                 if (canceled) {
                     trace() << "[FREE_IMMEDIATE] Canceled staged write for NodeID " << raw << std::endl;
@@ -717,13 +865,24 @@ namespace xtree {
                 return;
             }
 
-            // LIVE path: free the segment allocation and retire immediately
-            SegmentAllocator::Allocation alloc{
-                e.addr.file_id, e.addr.segment_id, e.addr.offset, e.addr.length, e.class_id, {}
-            };
-            ctx_.alloc.free(alloc);
+            // A new block staged for this node was never committed
+            auto& batch = tl_batch();
+            auto moved = batch.relocations.find(h);
+            if (moved != batch.relocations.end()) {
+                const OTAddr& to = moved->second.to;
+                SegmentAllocator::Allocation staged{
+                    to.file_id, to.segment_id, to.offset, to.length, e.class_id, {}
+                };
+                ctx_.alloc.free(staged);
+                batch.relocations.erase(moved);
+                batch.pending_nodes.erase(h);
+                batch.cancel_write_by_raw(id.raw());
+            }
 
-            // Mark the OT entry retired immediately (not at commit)
+            // LIVE path: retire immediately (not at commit). The reclaimer
+            // frees the segment allocation once no reader can see it, and
+            // the space may be reused then, so snapshots copy it first.
+            preserve_for_snapshots(id, e);
             ctx_.ot.retire(id, ctx_.mvcc.get_global_epoch());
         }
 
@@ -741,8 +900,11 @@ namespace xtree {
             // Use the provided name or default to store name
             const std::string key = name.empty() ? name_ : std::string(name);
             
+            // Snapshots resolve roots by epoch; remember the committed one
+            snapshots_.note_root_change(key, ctx_.runtime.get_root(key));
+
             // Store the root ID in pending roots so we can update it with reserved ID at commit
-            tl_batch_.pending_roots[key] = id;
+            tl_batch().pending_roots[key] = id;
             
             // Delegate to runtime's catalog (single source of truth)
             // No fsync here - durability comes when commit() publishes
@@ -756,19 +918,27 @@ namespace xtree {
             }
 
             // Fast path: nothing to commit
-            if (tl_batch_.writes.empty() && tl_batch_.retirements.empty()) {
+            if (tl_batch().writes.empty() && tl_batch().retirements.empty()) {
                 return;
             }
             
+            // Snapshots opened from here on wait for this batch
+            snapshots_.begin_commit();
+            std::vector<std::pair<std::string, NodeID>> roots;
+            roots.reserve(tl_batch().pending_roots.size());
+            for (const auto& kv : tl_batch().pending_roots) {
+                roots.emplace_back(kv.first, NodeID::invalid());
+            }
+
             // Get the single commit epoch for this batch
             const uint64_t commit_epoch = ctx_.mvcc.advance_epoch();
             
             // Stamp epochs in all staged deltas
-            for (auto& w : tl_batch_.writes) {
+            for (auto& w : tl_batch().writes) {
                 w.delta.birth_epoch = commit_epoch;
                 w.delta.retire_epoch = ~uint64_t{0};
             }
-            for (auto& r : tl_batch_.retirements) {
+            for (auto& r : tl_batch().retirements) {
                 if (r.retire_epoch == 0) {
                     r.retire_epoch = commit_epoch;
                 }
@@ -788,15 +958,22 @@ namespace xtree {
             }
             
             // Clear staged buffers
-            tl_batch_.clear();
+            tl_batch().clear();
+
+            // Publish the batch to snapshots: stamp the versions it replaced
+            // and record the roots it committed
+            for (auto& [name, id] : roots) {
+                id = ctx_.runtime.get_root(name);
+            }
+            snapshots_.on_commit(commit_epoch, roots);
             
             (void)hint_epoch; // Ignored - we use our own epoch
         }
         
         void DurableStore::flush_strict_mode(uint64_t epoch) {
             // Fast path: nothing to commit
-            if (tl_batch_.writes.empty() && tl_batch_.retirements.empty() &&
-                tl_batch_.dirty_ranges.empty() && tl_batch_.pending_roots.empty()) {
+            if (tl_batch().writes.empty() && tl_batch().retirements.empty() &&
+                tl_batch().dirty_ranges.empty() && tl_batch().pending_roots.empty()) {
                 return;
             }
 
@@ -808,10 +985,10 @@ namespace xtree {
             // 1) Reserve final NodeIDs and build O(1) lookup map
             std::vector<NodeID> reserved_ids;
             std::unordered_map<uint64_t, NodeID> reserved_by_raw;
-            reserved_ids.reserve(tl_batch_.writes.size());
-            reserved_by_raw.reserve(tl_batch_.writes.size());
+            reserved_ids.reserve(tl_batch().writes.size());
+            reserved_by_raw.reserve(tl_batch().writes.size());
 
-            for (const auto& w : tl_batch_.writes) {
+            for (const auto& w : tl_batch().writes) {
                 NodeID reserved = ctx_.ot.mark_live_reserve(w.id, epoch);
                 reserved_ids.push_back(reserved);
                 auto [it, inserted] = reserved_by_raw.emplace(w.id.raw(), reserved);
@@ -825,8 +1002,8 @@ namespace xtree {
                               << " (handle=" << it->second.handle_index()
                               << " tag=" << static_cast<int>(it->second.tag()) << ")" << std::endl;
                     trace() << "  This should not happen - stage_write should have coalesced duplicates" << std::endl;
-                    trace() << "  Batch state: writes=" << tl_batch_.writes.size()
-                              << " retirements=" << tl_batch_.retirements.size() << std::endl;
+                    trace() << "  Batch state: writes=" << tl_batch().writes.size()
+                              << " retirements=" << tl_batch().retirements.size() << std::endl;
                 }
                 assert(inserted && "duplicate raw NodeID in writes batch after coalescing");
 #endif
@@ -834,16 +1011,16 @@ namespace xtree {
             
             // 2) Build WAL batch with reserved tags
             std::vector<OTDeltaRec> wal_batch;
-            wal_batch.reserve(tl_batch_.writes.size() + tl_batch_.retirements.size());
-            for (size_t i = 0; i < tl_batch_.writes.size(); ++i) {
-                const auto& w = tl_batch_.writes[i];
+            wal_batch.reserve(tl_batch().writes.size() + tl_batch().retirements.size());
+            for (size_t i = 0; i < tl_batch().writes.size(); ++i) {
+                const auto& w = tl_batch().writes[i];
                 OTDeltaRec delta = w.delta;
                 delta.birth_epoch = epoch;
                 delta.retire_epoch = ~uint64_t{0};
                 delta.tag = reserved_ids[i].tag();  // Use reserved tag
                 wal_batch.push_back(delta);
             }
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 OTDeltaRec delta = r;
                 delta.birth_epoch = r.birth_epoch;  // Keep original birth
                 delta.retire_epoch = epoch;
@@ -852,22 +1029,22 @@ namespace xtree {
 
 #ifndef NDEBUG
             // Verify WAL batch contains all operations
-            if (wal_batch.size() != tl_batch_.writes.size() + tl_batch_.retirements.size()) {
+            if (wal_batch.size() != tl_batch().writes.size() + tl_batch().retirements.size()) {
                 trace() << "[ASSERT] WAL batch size mismatch: expected="
-                          << (tl_batch_.writes.size() + tl_batch_.retirements.size())
+                          << (tl_batch().writes.size() + tl_batch().retirements.size())
                           << " got=" << wal_batch.size()
-                          << " (writes=" << tl_batch_.writes.size()
-                          << " retirements=" << tl_batch_.retirements.size() << ")";
+                          << " (writes=" << tl_batch().writes.size()
+                          << " retirements=" << tl_batch().retirements.size() << ")";
 
                 // Dump sample IDs for debugging
                 trace() << " | first few write IDs: ";
-                for (size_t i = 0; i < std::min<size_t>(3, tl_batch_.writes.size()); ++i) {
-                    trace() << tl_batch_.writes[i].id.raw() << " ";
+                for (size_t i = 0; i < std::min<size_t>(3, tl_batch().writes.size()); ++i) {
+                    trace() << tl_batch().writes[i].id.raw() << " ";
                 }
                 trace() << " | first few retire IDs: ";
-                for (size_t i = 0; i < std::min<size_t>(3, tl_batch_.retirements.size()); ++i) {
-                    trace() << NodeID::from_parts(tl_batch_.retirements[i].handle_idx,
-                                                    tl_batch_.retirements[i].tag).raw() << " ";
+                for (size_t i = 0; i < std::min<size_t>(3, tl_batch().retirements.size()); ++i) {
+                    trace() << NodeID::from_parts(tl_batch().retirements[i].handle_idx,
+                                                    tl_batch().retirements[i].tag).raw() << " ";
                 }
                 trace() << std::endl;
                 assert(false && "wal_batch size mismatch");
@@ -876,7 +1053,7 @@ namespace xtree {
 
             // 3) Flush dirty pages BEFORE WAL write (STRICT requirement)
             // This uses msync(MS_SYNC) to ensure data hits disk
-            for (const auto& dr : tl_batch_.dirty_ranges) {
+            for (const auto& dr : tl_batch().dirty_ranges) {
                 PlatformFS::flush_view(dr.vaddr, dr.length);
             }
             
@@ -884,8 +1061,8 @@ namespace xtree {
             if (!wal_batch.empty()) {
                 // Debug: Log WAL writes count and a sample
                 trace() << "[WAL_COMMIT] epoch=" << epoch
-                          << " writes=" << tl_batch_.writes.size()
-                          << " retirements=" << tl_batch_.retirements.size()
+                          << " writes=" << tl_batch().writes.size()
+                          << " retirements=" << tl_batch().retirements.size()
                           << " total_deltas=" << wal_batch.size() << std::endl;
 
                 // Log first few deltas and any with shard > 0
@@ -906,18 +1083,19 @@ namespace xtree {
             // 5) NOW commit OT state (after WAL is durable)
             // These MUST succeed - WAL is already visible
 #ifndef NDEBUG
-            assert(reserved_ids.size() == tl_batch_.writes.size() &&
+            assert(reserved_ids.size() == tl_batch().writes.size() &&
                    "reserved_ids and writes size mismatch");
 #endif
 
             for (size_t i = 0; i < reserved_ids.size(); ++i) {
                 ctx_.ot.mark_live_commit(reserved_ids[i], epoch);
             }
+            commit_relocations(epoch);
 
 #ifndef NDEBUG
             // Debug: Verify all published nodes are actually LIVE with correct tags
             for (size_t i = 0; i < reserved_ids.size(); ++i) {
-                const auto& w = tl_batch_.writes[i];
+                const auto& w = tl_batch().writes[i];
                 const auto& e_live = ctx_.ot.get(reserved_ids[i]);
 
                 // The node we just committed must be LIVE now
@@ -937,11 +1115,11 @@ namespace xtree {
                        "Post-commit invariant: handle index changed across reservation");
 
                 // Sanity: the original id we staged must be in writes index
-                assert(tl_batch_.will_publish(w.id) && "writes[] entry not indexed");
+                assert(tl_batch().will_publish(w.id) && "writes[] entry not indexed");
             }
 
             // Only build committed set if we have retirements to check
-            if (!tl_batch_.retirements.empty()) {
+            if (!tl_batch().retirements.empty()) {
                 std::unordered_set<uint64_t> committed_raw;
                 committed_raw.reserve(reserved_ids.size());
                 for (const auto& rid : reserved_ids) {
@@ -949,13 +1127,13 @@ namespace xtree {
                 }
 
                 // Verify retirement preconditions
-                for (const auto& r : tl_batch_.retirements) {
+                for (const auto& r : tl_batch().retirements) {
                     NodeID retire_id = NodeID::from_parts(r.handle_idx, r.tag);
                     const auto& e = ctx_.ot.get(retire_id);
 
                     if (e.birth_epoch.load(std::memory_order_relaxed) == 0) {
                         // Must be a same-batch publish
-                        if (!tl_batch_.will_publish(retire_id)) {
+                        if (!tl_batch().will_publish(retire_id)) {
                             trace() << "[COMMIT_ORDER_ERROR] Retiring RESERVED node "
                                       << retire_id.raw() << " not in writes batch!" << std::endl;
                             assert(false && "Commit ordering violation: retiring RESERVED node not in writes batch");
@@ -972,13 +1150,13 @@ namespace xtree {
             }
 #endif
 
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 ctx_.ot.retire(NodeID::from_parts(r.handle_idx, r.tag), epoch);
             }
 
 #ifndef NDEBUG
             // Verify all retired nodes are actually in RETIRED state with correct epoch
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 NodeID rid = NodeID::from_parts(r.handle_idx, r.tag);
                 const auto& e_after = ctx_.ot.get(rid);
                 assert(e_after.dbg_state.load(std::memory_order_relaxed) == OTEntry::DBG_RETIRED &&
@@ -989,7 +1167,7 @@ namespace xtree {
 #endif
             
             // 6) Update catalog with reserved IDs for any roots in this batch
-            for (const auto& [name, original_id] : tl_batch_.pending_roots) {
+            for (const auto& [name, original_id] : tl_batch().pending_roots) {
                 if (auto it = reserved_by_raw.find(original_id.raw()); it != reserved_by_raw.end()) {
                     ctx_.runtime.set_root(name, it->second, epoch);
                 }
@@ -1010,13 +1188,13 @@ namespace xtree {
             }
             
             // 9) Clear pending roots after successful commit
-            tl_batch_.pending_roots.clear();
+            tl_batch().pending_roots.clear();
         }
         
         void DurableStore::flush_eventual_mode(uint64_t epoch) {
             // Fast path: nothing to commit
-            if (tl_batch_.writes.empty() && tl_batch_.retirements.empty() &&
-                tl_batch_.dirty_ranges.empty() && tl_batch_.pending_roots.empty()) {
+            if (tl_batch().writes.empty() && tl_batch().retirements.empty() &&
+                tl_batch().dirty_ranges.empty() && tl_batch().pending_roots.empty()) {
                 return;
             }
 
@@ -1028,10 +1206,10 @@ namespace xtree {
             // 1) Reserve final NodeIDs and build O(1) lookup map
             std::vector<NodeID> reserved_ids;
             std::unordered_map<uint64_t, NodeID> reserved_by_raw;
-            reserved_ids.reserve(tl_batch_.writes.size());
-            reserved_by_raw.reserve(tl_batch_.writes.size());
+            reserved_ids.reserve(tl_batch().writes.size());
+            reserved_by_raw.reserve(tl_batch().writes.size());
 
-            for (const auto& w : tl_batch_.writes) {
+            for (const auto& w : tl_batch().writes) {
                 NodeID reserved = ctx_.ot.mark_live_reserve(w.id, epoch);
                 reserved_ids.push_back(reserved);
                 auto [it, inserted] = reserved_by_raw.emplace(w.id.raw(), reserved);
@@ -1045,8 +1223,8 @@ namespace xtree {
                               << " (handle=" << it->second.handle_index()
                               << " tag=" << static_cast<int>(it->second.tag()) << ")" << std::endl;
                     trace() << "  This should not happen - stage_write should have coalesced duplicates" << std::endl;
-                    trace() << "  Batch state: writes=" << tl_batch_.writes.size()
-                              << " retirements=" << tl_batch_.retirements.size() << std::endl;
+                    trace() << "  Batch state: writes=" << tl_batch().writes.size()
+                              << " retirements=" << tl_batch().retirements.size() << std::endl;
                 }
                 assert(inserted && "duplicate raw NodeID in writes batch after coalescing");
 #endif
@@ -1054,10 +1232,10 @@ namespace xtree {
             
             // 2) Build WAL batch with reserved tags and payloads for small nodes
             std::vector<OTDeltaLog::DeltaWithPayload> dwp;
-            dwp.reserve(tl_batch_.writes.size() + tl_batch_.retirements.size());
+            dwp.reserve(tl_batch().writes.size() + tl_batch().retirements.size());
             
-            for (size_t i = 0; i < tl_batch_.writes.size(); ++i) {
-                const auto& w = tl_batch_.writes[i];
+            for (size_t i = 0; i < tl_batch().writes.size(); ++i) {
+                const auto& w = tl_batch().writes[i];
                 OTDeltaRec delta = w.delta;
                 delta.birth_epoch = epoch;
                 delta.retire_epoch = ~uint64_t{0};
@@ -1070,7 +1248,7 @@ namespace xtree {
                     dwp.push_back({delta, nullptr, 0});
                 }
             }
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 OTDeltaRec delta = r;
                 delta.birth_epoch = r.birth_epoch;
                 delta.retire_epoch = epoch;
@@ -1079,12 +1257,12 @@ namespace xtree {
 
 #ifndef NDEBUG
             // Verify WAL batch contains all operations
-            if (dwp.size() != tl_batch_.writes.size() + tl_batch_.retirements.size()) {
+            if (dwp.size() != tl_batch().writes.size() + tl_batch().retirements.size()) {
                 trace() << "[ASSERT] WAL batch size mismatch in EVENTUAL: expected="
-                          << (tl_batch_.writes.size() + tl_batch_.retirements.size())
+                          << (tl_batch().writes.size() + tl_batch().retirements.size())
                           << " got=" << dwp.size()
-                          << " (writes=" << tl_batch_.writes.size()
-                          << " retirements=" << tl_batch_.retirements.size() << ")" << std::endl;
+                          << " (writes=" << tl_batch().writes.size()
+                          << " retirements=" << tl_batch().retirements.size() << ")" << std::endl;
                 assert(false && "dwp size mismatch");
             }
 #endif
@@ -1104,6 +1282,7 @@ namespace xtree {
             for (size_t i = 0; i < reserved_ids.size(); ++i) {
                 ctx_.ot.mark_live_commit(reserved_ids[i], epoch);
             }
+            commit_relocations(epoch);
 
 #ifndef NDEBUG
             // Verify basic state transitions (lighter than STRICT mode)
@@ -1114,20 +1293,20 @@ namespace xtree {
             }
 
             // Verify retirement ordering (same as STRICT - these are logical invariants)
-            if (!tl_batch_.retirements.empty()) {
+            if (!tl_batch().retirements.empty()) {
                 std::unordered_set<uint64_t> committed_raw;
                 committed_raw.reserve(reserved_ids.size());
                 for (const auto& rid : reserved_ids) {
                     committed_raw.insert(rid.raw());
                 }
 
-                for (const auto& r : tl_batch_.retirements) {
+                for (const auto& r : tl_batch().retirements) {
                     NodeID retire_id = NodeID::from_parts(r.handle_idx, r.tag);
                     const auto& e = ctx_.ot.get(retire_id);
 
                     if (e.birth_epoch.load(std::memory_order_relaxed) == 0) {
                         // Must be a same-batch publish
-                        if (!tl_batch_.will_publish(retire_id)) {
+                        if (!tl_batch().will_publish(retire_id)) {
                             trace() << "[COMMIT_ORDER_ERROR][EVENTUAL] Retiring RESERVED node "
                                       << retire_id.raw() << " not in writes batch!" << std::endl;
                             assert(false && "Commit ordering violation in EVENTUAL mode");
@@ -1144,13 +1323,13 @@ namespace xtree {
             }
 #endif
 
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 ctx_.ot.retire(NodeID::from_parts(r.handle_idx, r.tag), epoch);
             }
 
 #ifndef NDEBUG
             // Verify retirements succeeded
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 NodeID rid = NodeID::from_parts(r.handle_idx, r.tag);
                 const auto& e_after = ctx_.ot.get(rid);
                 assert(e_after.dbg_state.load(std::memory_order_relaxed) == OTEntry::DBG_RETIRED &&
@@ -1159,7 +1338,7 @@ namespace xtree {
 #endif
             
             // 6) Update catalog with reserved IDs for any roots in this batch
-            for (const auto& [name, original_id] : tl_batch_.pending_roots) {
+            for (const auto& [name, original_id] : tl_batch().pending_roots) {
                 if (auto it = reserved_by_raw.find(original_id.raw()); it != reserved_by_raw.end()) {
                     ctx_.runtime.set_root(name, it->second, epoch);
                 }
@@ -1180,13 +1359,13 @@ namespace xtree {
             }
             
             // 9) Clear pending roots after successful commit
-            tl_batch_.pending_roots.clear();
+            tl_batch().pending_roots.clear();
         }
         
         void DurableStore::flush_balanced_mode(uint64_t epoch) {
             // Fast path: nothing to commit
-            if (tl_batch_.writes.empty() && tl_batch_.retirements.empty() &&
-                tl_batch_.dirty_ranges.empty() && tl_batch_.pending_roots.empty()) {
+            if (tl_batch().writes.empty() && tl_batch().retirements.empty() &&
+                tl_batch().dirty_ranges.empty() && tl_batch().pending_roots.empty()) {
                 return;
             }
 
@@ -1198,10 +1377,10 @@ namespace xtree {
             // 1) Reserve final NodeIDs and build O(1) lookup map
             std::vector<NodeID> reserved_ids;
             std::unordered_map<uint64_t, NodeID> reserved_by_raw;
-            reserved_ids.reserve(tl_batch_.writes.size());
-            reserved_by_raw.reserve(tl_batch_.writes.size());
+            reserved_ids.reserve(tl_batch().writes.size());
+            reserved_by_raw.reserve(tl_batch().writes.size());
 
-            for (const auto& w : tl_batch_.writes) {
+            for (const auto& w : tl_batch().writes) {
                 NodeID reserved = ctx_.ot.mark_live_reserve(w.id, epoch);
                 reserved_ids.push_back(reserved);
                 auto [it, inserted] = reserved_by_raw.emplace(w.id.raw(), reserved);
@@ -1215,8 +1394,8 @@ namespace xtree {
                               << " (handle=" << it->second.handle_index()
                               << " tag=" << static_cast<int>(it->second.tag()) << ")" << std::endl;
                     trace() << "  This should not happen - stage_write should have coalesced duplicates" << std::endl;
-                    trace() << "  Batch state: writes=" << tl_batch_.writes.size()
-                              << " retirements=" << tl_batch_.retirements.size() << std::endl;
+                    trace() << "  Batch state: writes=" << tl_batch().writes.size()
+                              << " retirements=" << tl_batch().retirements.size() << std::endl;
                 }
                 assert(inserted && "duplicate raw NodeID in writes batch after coalescing");
 #endif
@@ -1224,10 +1403,10 @@ namespace xtree {
             
             // 2) Build WAL batch with reserved tags and payloads for small nodes
             std::vector<OTDeltaLog::DeltaWithPayload> dwp;
-            dwp.reserve(tl_batch_.writes.size() + tl_batch_.retirements.size());
+            dwp.reserve(tl_batch().writes.size() + tl_batch().retirements.size());
             
-            for (size_t i = 0; i < tl_batch_.writes.size(); ++i) {
-                const auto& w = tl_batch_.writes[i];
+            for (size_t i = 0; i < tl_batch().writes.size(); ++i) {
+                const auto& w = tl_batch().writes[i];
                 OTDeltaRec delta = w.delta;
                 delta.birth_epoch = epoch;
                 delta.retire_epoch = ~uint64_t{0};
@@ -1240,7 +1419,7 @@ namespace xtree {
                     dwp.push_back({delta, nullptr, 0});
                 }
             }
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 OTDeltaRec delta = r;
                 delta.birth_epoch = r.birth_epoch;
                 delta.retire_epoch = epoch;
@@ -1249,12 +1428,12 @@ namespace xtree {
 
 #ifndef NDEBUG
             // Verify WAL batch contains all operations
-            if (dwp.size() != tl_batch_.writes.size() + tl_batch_.retirements.size()) {
+            if (dwp.size() != tl_batch().writes.size() + tl_batch().retirements.size()) {
                 trace() << "[ASSERT] WAL batch size mismatch in BALANCED: expected="
-                          << (tl_batch_.writes.size() + tl_batch_.retirements.size())
+                          << (tl_batch().writes.size() + tl_batch().retirements.size())
                           << " got=" << dwp.size()
-                          << " (writes=" << tl_batch_.writes.size()
-                          << " retirements=" << tl_batch_.retirements.size() << ")" << std::endl;
+                          << " (writes=" << tl_batch().writes.size()
+                          << " retirements=" << tl_batch().retirements.size() << ")" << std::endl;
                 assert(false && "dwp size mismatch in BALANCED");
             }
 #endif
@@ -1263,8 +1442,8 @@ namespace xtree {
             if (!dwp.empty()) {
                 // Debug: Log WAL writes count and sample
                 trace() << "[WAL_COMMIT_BALANCED] epoch=" << epoch
-                          << " writes=" << tl_batch_.writes.size()
-                          << " retirements=" << tl_batch_.retirements.size()
+                          << " writes=" << tl_batch().writes.size()
+                          << " retirements=" << tl_batch().retirements.size()
                           << " total_deltas=" << dwp.size() << std::endl;
 
                 // Log first few deltas
@@ -1307,19 +1486,20 @@ namespace xtree {
             // CRITICAL FIX: Always flush dirty ranges in BALANCED mode
             // This ensures updated MBRs are persisted to disk
             // Without this, tree nodes with updated MBRs remain only in memory
-            for (const auto& dr : tl_batch_.dirty_ranges) {
+            for (const auto& dr : tl_batch().dirty_ranges) {
                 PlatformFS::flush_view(dr.vaddr, dr.length);
             }
             
             // 5) NOW commit OT state (after WAL is written/synced)
 #ifndef NDEBUG
-            assert(reserved_ids.size() == tl_batch_.writes.size() &&
+            assert(reserved_ids.size() == tl_batch().writes.size() &&
                    "reserved_ids and writes size mismatch (BALANCED)");
 #endif
 
             for (size_t i = 0; i < reserved_ids.size(); ++i) {
                 ctx_.ot.mark_live_commit(reserved_ids[i], epoch);
             }
+            commit_relocations(epoch);
 
 #ifndef NDEBUG
             // Verify basic state transitions (lighter than STRICT, but with epoch checks)
@@ -1335,20 +1515,20 @@ namespace xtree {
             }
 
             // Verify retirement ordering (same logical invariants as other modes)
-            if (!tl_batch_.retirements.empty()) {
+            if (!tl_batch().retirements.empty()) {
                 std::unordered_set<uint64_t> committed_raw;
                 committed_raw.reserve(reserved_ids.size());
                 for (const auto& rid : reserved_ids) {
                     committed_raw.insert(rid.raw());
                 }
 
-                for (const auto& r : tl_batch_.retirements) {
+                for (const auto& r : tl_batch().retirements) {
                     NodeID retire_id = NodeID::from_parts(r.handle_idx, r.tag);
                     const auto& e = ctx_.ot.get(retire_id);
 
                     if (e.birth_epoch.load(std::memory_order_relaxed) == 0) {
                         // Must be a same-batch publish
-                        if (!tl_batch_.will_publish(retire_id)) {
+                        if (!tl_batch().will_publish(retire_id)) {
                             trace() << "[COMMIT_ORDER_ERROR][BALANCED] Retiring RESERVED node "
                                       << retire_id.raw() << " not in writes batch!" << std::endl;
                             assert(false && "Commit ordering violation in BALANCED mode");
@@ -1365,13 +1545,13 @@ namespace xtree {
             }
 #endif
 
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 ctx_.ot.retire(NodeID::from_parts(r.handle_idx, r.tag), epoch);
             }
 
 #ifndef NDEBUG
             // Verify retirements succeeded with correct epoch
-            for (const auto& r : tl_batch_.retirements) {
+            for (const auto& r : tl_batch().retirements) {
                 NodeID rid = NodeID::from_parts(r.handle_idx, r.tag);
                 const auto& e_after = ctx_.ot.get(rid);
                 assert(e_after.dbg_state.load(std::memory_order_relaxed) == OTEntry::DBG_RETIRED &&
@@ -1383,7 +1563,7 @@ namespace xtree {
 #endif
             
             // 6) Update catalog with reserved IDs for any roots in this batch
-            for (const auto& [name, original_id] : tl_batch_.pending_roots) {
+            for (const auto& [name, original_id] : tl_batch().pending_roots) {
                 if (auto it = reserved_by_raw.find(original_id.raw()); it != reserved_by_raw.end()) {
                     ctx_.runtime.set_root(name, it->second, epoch);
                 }
@@ -1404,7 +1584,7 @@ namespace xtree {
             }
             
             // 9) Clear pending roots after successful commit
-            tl_batch_.pending_roots.clear();
+            tl_batch().pending_roots.clear();
         }
         
         void* DurableStore::get_mapped_address(NodeID id) {
@@ -1416,12 +1596,128 @@ namespace xtree {
             if (e.addr.length == 0) {
                 return nullptr;  // Node not allocated
             }
+
+            // The caller is about to serialize over the committed version
+            preserve_for_snapshots(id, e);
             
-            // Return the cached vaddr from OT entry
-            // This was populated during allocation
-            return e.addr.vaddr;
+            // The cached vaddr from allocation, the mapping of a recovered
+            // node, or the new block a committed node is rewritten into
+            return write_ptr(id, e);
         }
         
+        void* DurableStore::committed_ptr(const OTEntry& e) const {
+            if (e.addr.vaddr) {
+                return e.addr.vaddr;
+            }
+            return ctx_.alloc.get_ptr_for_recovery(
+                e.class_id, e.addr.file_id, e.addr.segment_id,
+                e.addr.offset, e.addr.length);
+        }
+
+        void DurableStore::preserve_for_snapshots(NodeID id, const OTEntry& e) {
+            const uint64_t birth = e.birth_epoch.load(std::memory_order_acquire);
+            if (!snapshots_.must_preserve(birth)) {
+                return;
+            }
+            snapshots_.preserve(id.raw(), birth, committed_ptr(e), e.addr.length);
+        }
+
+        void* DurableStore::write_ptr(NodeID id, const OTEntry& e) {
+            if (!policy_.relocate_on_republish || e.birth_epoch.load(std::memory_order_acquire) == 0) {
+                return committed_ptr(e);
+            }
+            auto& batch = tl_batch();
+            const uint64_t h = id.handle_index();
+            auto it = batch.relocations.find(h);
+            if (it != batch.relocations.end()) {
+                return it->second.to.vaddr;
+            }
+
+            // First rewrite in this batch: start the new block from the
+            // committed bytes, which stay untouched until reclaimed
+            SegmentAllocator::Allocation near{
+                e.addr.file_id, e.addr.segment_id, e.addr.offset, e.addr.length, e.class_id, {}
+            };
+            auto a = ctx_.alloc.allocate(e.addr.length, e.kind, near);
+            if (!a.is_valid()) {
+                throw std::runtime_error("Failed to allocate segment: out of space or too many segments");
+            }
+            void* vaddr = ctx_.alloc.get_ptr(a);
+            if (!vaddr) {
+                throw std::runtime_error("Failed to get memory-mapped pointer for allocation");
+            }
+            const void* src = committed_ptr(e);
+            if (src) {
+                std::memcpy(vaddr, src, e.addr.length);
+            } else {
+                std::memset(vaddr, 0, a.length);
+            }
+
+            OTAddr to{a.file_id, a.segment_id, a.offset, static_cast<uint32_t>(a.length), vaddr};
+            batch.relocations.emplace(h, Relocation{id, to});
+            batch.pending_nodes[h] = { vaddr, e.addr.length };
+            return vaddr;
+        }
+
+        void DurableStore::commit_relocations(uint64_t epoch) {
+            auto& batch = tl_batch();
+            for (const auto& [h, r] : batch.relocations) {
+                if (batch.write_index_by_raw.count(r.id.raw())) {
+                    ctx_.ot.relocate(r.id, r.to, epoch);
+                } else {
+                    // Mapped for writing but never published: nothing to log
+                    SegmentAllocator::Allocation unused{
+                        r.to.file_id, r.to.segment_id, r.to.offset, r.to.length,
+                        ctx_.ot.get_by_handle_unsafe(h).class_id, {}
+                    };
+                    ctx_.alloc.free(unused);
+                }
+            }
+        }
+
+        uint64_t DurableStore::acquire_snapshot(uint64_t epoch) {
+            // Waiting for our own uncommitted batch would never end
+            if (epoch == kLatestSnapshot && snapshots_.batch_dirty() &&
+                (!tl_batch().writes.empty() || !tl_batch().retirements.empty())) {
+                throw std::logic_error("acquire_snapshot: commit this thread's pending writes first");
+            }
+            return snapshots_.acquire(epoch);
+        }
+
+        void DurableStore::release_snapshot(uint64_t epoch) {
+            snapshots_.release(epoch);
+        }
+
+        NodeID DurableStore::root_at(uint64_t epoch, std::string_view name) const {
+            const std::string key = name.empty() ? name_ : std::string(name);
+            return snapshots_.root_at(key, epoch, [&] { return ctx_.runtime.get_root(key); });
+        }
+
+        bool DurableStore::read_node_at(NodeID id, uint64_t epoch, std::vector<uint8_t>& out) const {
+            auto lock = snapshots_.lock_versions();
+            if (snapshots_.find_version(id.raw(), epoch, out)) {
+                return true;
+            }
+
+            // Not overwritten since epoch: the current bytes, if the entry was visible then
+            const OTEntry* e = ctx_.ot.try_get_by_handle(id.handle_index());
+            if (!e || !ctx_.ot.validate_tag(id)) {
+                return false;
+            }
+            const uint64_t birth = e->birth_epoch.load(std::memory_order_acquire);
+            const uint64_t retire = e->retire_epoch.load(std::memory_order_acquire);
+            if (birth == 0 || birth > epoch || (retire != ~uint64_t{0} && retire <= epoch)) {
+                return false;
+            }
+            const void* ptr = committed_ptr(*e);
+            if (!ptr) {
+                return false;
+            }
+            const auto* p = static_cast<const uint8_t*>(ptr);
+            out.assign(p, p + e->addr.length);
+            return true;
+        }
+
         size_t DurableStore::get_capacity(NodeID id) {
             // Get the OT entry for this node
             const uint64_t h = id.handle_index();
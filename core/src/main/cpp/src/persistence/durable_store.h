@@ -24,6 +24,10 @@
 #include "segment_allocator.h"
 #include "durability_policy.h"
 #include "ot_delta_log.h"
+#include "snapshot_registry.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <cstring>
@@ -49,6 +53,8 @@ namespace xtree {
             ~DurableStore();
 
             AllocResult allocate_node(size_t min_len, NodeKind kind) override;
+            // Same segment as hint.near, nearest free block, when the size class matches
+            AllocResult allocate_node(size_t min_len, NodeKind kind, const PlacementHint& hint) override;
 
             void publish_node(NodeID id, const void* data, size_t len) override;
             
@@ -63,6 +69,9 @@ namespace xtree {
             
             // Pinned read for zero-copy access
             PinnedBytes read_node_pinned(NodeID id) const override;
+
+            // madvise(WILLNEED) over the node's committed extent
+            void prefetch_node(NodeID id) const override;
             
             void retire_node(NodeID id,
                            uint64_t retire_epoch,
@@ -82,7 +91,18 @@ namespace xtree {
 
             void commit(uint64_t epoch) override;
             
-            // Zero-copy access for in-place updates
+            // Point-in-time reads (see snapshot_registry.h)
+            uint64_t acquire_snapshot(uint64_t epoch = kLatestSnapshot) override;
+            void release_snapshot(uint64_t epoch) override;
+            NodeID root_at(uint64_t epoch, std::string_view name) const override;
+            bool read_node_at(NodeID id, uint64_t epoch, std::vector<uint8_t>& out) const override;
+
+            SnapshotRegistry& snapshots() { return snapshots_; }
+            const SnapshotRegistry& snapshots() const { return snapshots_; }
+
+            // Zero-copy access for in-place updates. Writers must take the
+            // address here before overwriting a committed node, so open
+            // snapshots can keep its previous version.
             void* get_mapped_address(NodeID id) override;
             size_t get_capacity(NodeID id) override;
 
@@ -102,10 +122,30 @@ namespace xtree {
             SegmentAllocator& get_segment_allocator() { return ctx_.alloc; }
             const SegmentAllocator& get_segment_allocator() const { return ctx_.alloc; }
 
+            // Write batches the calling thread holds, one per live store it has written to
+            static size_t thread_batch_count();
+
         private:
             // Internal helper: resolve OTEntry for a NodeID, handling uncommitted visibility
             const OTEntry* resolve_entry(NodeID id, bool& is_uncommitted) const noexcept;
 
+            // Mapped bytes of a committed entry (maps recovered segments on demand)
+            void* committed_ptr(const OTEntry& e) const;
+
+            // Hand a committed node's current bytes to the snapshot registry
+            // if an open snapshot may still read them; call before overwriting
+            // or freeing the node
+            void preserve_for_snapshots(NodeID id, const OTEntry& e);
+
+            // Where the next version of a node is written: its own block
+            // until first commit, then (with relocate_on_republish) a new
+            // block that replaces it when the batch commits
+            void* write_ptr(NodeID id, const OTEntry& e);
+
+            // Swap relocated nodes to their new blocks; call after the
+            // batch's writes are marked live
+            void commit_relocations(uint64_t epoch);
+
             // Thread-local write batching
             struct PendingWrite {
                 NodeID id;              // NodeID with tag from allocation
@@ -115,6 +155,11 @@ namespace xtree {
                 bool include_payload;   // True if payload should be in WAL
             };
             
+            struct Relocation {
+                NodeID id;           // Node moving to the new block
+                OTAddr to;           // New block (vaddr set)
+            };
+
             struct DirtyRange {
                 void* vaddr;         // Direct pointer for fast flush
                 uint32_t length;     // Length to flush
@@ -128,9 +173,15 @@ namespace xtree {
                 // Tx-local staging for uncommitted nodes (writer visibility)
                 std::unordered_map<uint64_t, NodeBytes> pending_nodes;  // handle -> {ptr, len}
 
+                // Committed nodes rewritten into new blocks, by handle
+                std::unordered_map<uint64_t, Relocation> relocations;
+
                 // Index to coalesce multiple publishes per NodeID in the same batch
                 std::unordered_map<uint64_t, size_t> write_index_by_raw;
 
+                // Set once the store is gone; the owning thread then drops the batch
+                std::atomic<bool> orphaned{false};
+
 #ifndef NDEBUG
                 // Debug-only index for O(1) "will publish" checks
                 std::unordered_set<uint64_t> writes_raw_index;
@@ -209,6 +260,7 @@ namespace xtree {
                     dirty_ranges.clear();
                     pending_roots.clear();
                     pending_nodes.clear();
+                    relocations.clear();
                     write_index_by_raw.clear();
 #ifndef NDEBUG
                     clear_debug();
@@ -216,7 +268,14 @@ namespace xtree {
                 }
             };
 
-            static thread_local ThreadBatch tl_batch_;
+            // The calling thread's batch for this store. Every store has its
+            // own, so indexes open side by side on one thread don't commit
+            // each other's writes. The thread owns the batch; the store keeps
+            // a weak handle so its destructor can empty batches left on other
+            // threads.
+            ThreadBatch& tl_batch() const;
+            struct ThreadBatches;
+            static ThreadBatches& thread_batches();
             
             // Helper methods
             void flush_strict_mode(uint64_t epoch);
@@ -241,6 +300,10 @@ namespace xtree {
             DurableContext& ctx_;
             std::string name_;
             DurabilityPolicy policy_;
+            SnapshotRegistry snapshots_;
+            const uint64_t store_id_;   // Keys tl_batch(); unlike addresses, never reused
+            mutable std::mutex batches_mu_;
+            mutable std::vector<std::weak_ptr<ThreadBatch>> batches_;  // Every thread's batch for this store
         };
     } // namespace persist
 } // namespace xtree
\ No newline at end of file
@@ -9,9 +9,11 @@
 #include "memory_coordinator.h"
 #include "mapping_manager.h"
 #include "manifest.h"
+#include "durable_runtime.h"
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 
 namespace xtree {
 namespace persist {
@@ -26,6 +28,9 @@ IndexRegistry& IndexRegistry::global() {
 }
 
 IndexRegistry::~IndexRegistry() {
+    // Preload workers use the entries; stop them first
+    cancel_preload();
+
     // Clean up all loaded indexes
     std::lock_guard<std::mutex> lock(registry_mutex_);
     for (auto& [name, entry] : entries_) {
@@ -49,7 +54,7 @@ bool IndexRegistry::register_index(const std::string& field_name,
         return false;  // Already registered
     }
 
-    auto entry = std::make_unique<IndexEntry>();
+    auto entry = std::make_shared<IndexEntry>();
     entry->metadata.config = config;
     entry->metadata.config.field_name = field_name;  // Ensure consistency
     entry->metadata.state = IndexLoadState::REGISTERED;
@@ -92,6 +97,10 @@ size_t IndexRegistry::register_from_manifest(const Manifest& manifest,
         }
 
         if (register_index(root.name, config)) {
+            // Carry the access history over so preloading ranks by it
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            entries_[root.name]->metadata.access_count.store(root.access_count,
+                                                             std::memory_order_relaxed);
             registered++;
         }
     }
@@ -164,42 +173,34 @@ size_t IndexRegistry::unload_index(const std::string& field_name) {
         return 0;
     }
 
-    auto& entry = *it->second;
-    auto& meta = entry.metadata;
+    std::shared_ptr<IndexEntry> entry = it->second;
+    auto& meta = entry->metadata;
 
     // Not loaded - nothing to do
-    if (meta.state != IndexLoadState::LOADED || !entry.index_ptr) {
+    if (meta.state != IndexLoadState::LOADED || !entry->index_ptr) {
         return 0;
     }
 
     // Release registry lock, acquire per-index lock
     lock.unlock();
 
-    std::lock_guard<std::mutex> load_lock(entry.load_mutex);
+    std::lock_guard<std::mutex> load_lock(entry->load_mutex);
 
     // Double-check after acquiring lock
-    if (meta.state != IndexLoadState::LOADED || !entry.index_ptr) {
+    if (meta.state != IndexLoadState::LOADED || !entry->index_ptr) {
         return 0;
     }
 
-    return unload_index_impl(field_name, meta);
+    return unload_index_impl(field_name, *entry);
 }
 
 size_t IndexRegistry::unload_index_impl(const std::string& field_name,
-                                        IndexMetadata& meta) {
+                                        IndexEntry& entry) {
     // Must hold entry's load_mutex when calling this
-
+    auto& meta = entry.metadata;
     meta.state = IndexLoadState::UNLOADING;
 
-    // Find the entry again to access the index_ptr
     std::lock_guard<std::mutex> lock(registry_mutex_);
-    auto it = entries_.find(field_name);
-    if (it == entries_.end()) {
-        meta.state = IndexLoadState::REGISTERED;
-        return 0;
-    }
-
-    auto& entry = *it->second;
     size_t bytes_freed = meta.estimated_memory;
 
     // Get memory stats before unloading
@@ -376,6 +377,217 @@ std::vector<std::string> IndexRegistry::get_loaded_fields() const {
     return fields;
 }
 
+// ============================================================================
+// Background Preloading
+// ============================================================================
+
+size_t IndexRegistry::start_preload_impl(std::function<PreloadOutcome(const std::string&)> loader,
+                                         const PreloadOptions& options) {
+    std::lock_guard<std::mutex> threads_lock(preload_threads_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        if (preload_workers_active_ > 0) {
+            return 0;  // One pass at a time
+        }
+    }
+    join_preload_threads();  // Reap the workers of a finished pass
+
+    // Rank unloaded fields by how often they were used, hottest first
+    std::vector<std::pair<uint64_t, std::string>> ranked;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (const auto& [name, entry] : entries_) {
+            const auto& meta = entry->metadata;
+            const uint64_t count = meta.access_count.load(std::memory_order_relaxed);
+            if (meta.state == IndexLoadState::REGISTERED && count >= options.min_access_count) {
+                ranked.emplace_back(count, name);
+            }
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    if (options.max_indexes > 0 && ranked.size() > options.max_indexes) {
+        ranked.resize(options.max_indexes);
+    }
+    if (ranked.empty()) {
+        return 0;
+    }
+
+    const size_t workers = std::min(std::max<size_t>(1, options.max_concurrent), ranked.size());
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        preload_queue_.clear();
+        for (auto& [count, name] : ranked) {
+            preload_queue_.push_back(std::move(name));
+        }
+        preload_loader_ = std::move(loader);
+        preload_cancel_ = false;
+        preload_stats_ = PreloadStats();
+        preload_stats_.queued = ranked.size();
+        preload_stats_.running = true;
+        preload_workers_active_ = workers;
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        preload_threads_.emplace_back(&IndexRegistry::preload_worker, this);
+    }
+    return ranked.size();
+}
+
+void IndexRegistry::preload_worker() {
+    for (;;) {
+        std::string field;
+        {
+            std::lock_guard<std::mutex> lock(preload_mutex_);
+            if (preload_queue_.empty()) {
+                break;
+            }
+            field = std::move(preload_queue_.front());
+            preload_queue_.pop_front();
+        }
+
+        // Loading past the pressure threshold would only feed the
+        // coordinator's cold-index unloading; leave the rest on disk
+        if (!MemoryCoordinator::global().has_headroom()) {
+            std::lock_guard<std::mutex> lock(preload_mutex_);
+            preload_stats_.skipped_for_memory += 1 + preload_queue_.size();
+            preload_queue_.clear();
+            break;
+        }
+
+        const PreloadOutcome outcome = preload_loader_(field);
+
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        switch (outcome) {
+            case PreloadOutcome::Loaded:        preload_stats_.loaded++; break;
+            case PreloadOutcome::AlreadyLoaded: preload_stats_.already_loaded++; break;
+            case PreloadOutcome::Failed:        preload_stats_.failed++; break;
+            case PreloadOutcome::Cancelled:     preload_stats_.cancelled++; break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    if (--preload_workers_active_ == 0) {
+        preload_stats_.running = false;
+        preload_done_.notify_all();
+    }
+}
+
+void IndexRegistry::join_preload_threads() {
+    // Caller holds preload_threads_mutex_
+    for (auto& t : preload_threads_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    preload_threads_.clear();
+}
+
+bool IndexRegistry::cancel_preload(const std::string& field_name) {
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    auto it = std::find(preload_queue_.begin(), preload_queue_.end(), field_name);
+    if (it == preload_queue_.end()) {
+        return false;
+    }
+    preload_queue_.erase(it);
+    preload_stats_.cancelled++;
+    return true;
+}
+
+void IndexRegistry::cancel_preload() {
+    std::lock_guard<std::mutex> threads_lock(preload_threads_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        preload_cancel_ = true;
+        preload_stats_.cancelled += preload_queue_.size();
+        preload_queue_.clear();
+    }
+    join_preload_threads();
+}
+
+bool IndexRegistry::wait_preload(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(preload_mutex_);
+    return preload_done_.wait_for(lock, timeout, [this] { return preload_workers_active_ == 0; });
+}
+
+PreloadStats IndexRegistry::preload_stats() const {
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    return preload_stats_;
+}
+
+// ============================================================================
+// Access History
+// ============================================================================
+
+size_t IndexRegistry::persist_access_counts() {
+    // Fields sharing a data directory share its manifest
+    std::map<std::string, std::vector<IndexEntry*>> by_dir;
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (const auto& [name, entry] : entries_) {
+        if (!entry->metadata.config.data_dir.empty()) {
+            by_dir[entry->metadata.config.data_dir].push_back(entry.get());
+        }
+    }
+
+    size_t updated = 0;
+    for (const auto& [dir, dir_entries] : by_dir) {
+        // Hold off loads and unloads in this directory. Lock order is
+        // load_mutex before registry_mutex_, so only try.
+        std::vector<std::unique_lock<std::mutex>> held;
+        bool busy = false;
+        for (IndexEntry* entry : dir_entries) {
+            std::unique_lock<std::mutex> load_lock(entry->load_mutex, std::try_to_lock);
+            if (!load_lock.owns_lock()) {
+                busy = true;
+                break;
+            }
+            held.push_back(std::move(load_lock));
+        }
+        if (busy) {
+            continue;
+        }
+
+        std::unordered_map<std::string, uint64_t> counts;
+        DurableRuntime* runtime = nullptr;
+        for (IndexEntry* entry : dir_entries) {
+            counts[entry->metadata.config.field_name] =
+                entry->metadata.access_count.load(std::memory_order_relaxed);
+            if (!runtime && entry->index_ptr && entry->runtime) {
+                runtime = entry->runtime(entry->index_ptr);
+            }
+        }
+
+        // A live runtime rewrites its own in-memory manifest on every
+        // checkpoint and catalog write; a separate copy would be overwritten
+        // and would in turn roll back whatever the runtime stored meanwhile
+        if (runtime) {
+            updated += runtime->raise_access_counts(counts);
+            continue;
+        }
+
+        Manifest manifest(dir);
+        if (!manifest.load()) {
+            continue;
+        }
+        auto roots = manifest.get_roots();
+        size_t changed = 0;
+        for (auto& root : roots) {
+            auto it = counts.find(root.name);
+            if (it != counts.end() && it->second > root.access_count) {
+                root.access_count = it->second;
+                changed++;
+            }
+        }
+        if (changed > 0) {
+            manifest.set_roots(roots);
+            if (manifest.store()) {
+                updated += changed;
+            }
+        }
+    }
+    return updated;
+}
+
 // ============================================================================
 // Callbacks
 // ============================================================================
@@ -402,15 +614,32 @@ void IndexRegistry::touch(IndexMetadata& meta) {
 // ============================================================================
 
 void IndexRegistry::remove_index(const std::string& field_name) {
-    // First unload if loaded
-    unload_index(field_name);
+    // Drop a queued preload of the field; one already running holds the
+    // entry's load_mutex, so taking it below waits for that load
+    cancel_preload(field_name);
 
-    // Then remove from registry
-    std::lock_guard<std::mutex> lock(registry_mutex_);
-    entries_.erase(field_name);
+    std::shared_ptr<IndexEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        auto it = entries_.find(field_name);
+        if (it == entries_.end()) {
+            return;
+        }
+        entry = std::move(it->second);
+        entries_.erase(it);
+    }
+
+    // Loaders that found the entry before the erase see removed and back off
+    std::lock_guard<std::mutex> load_lock(entry->load_mutex);
+    entry->removed = true;
+    if (entry->metadata.state == IndexLoadState::LOADED && entry->index_ptr) {
+        unload_index_impl(field_name, *entry);
+    }
 }
 
 void IndexRegistry::reset() {
+    cancel_preload();
+
     std::lock_guard<std::mutex> lock(registry_mutex_);
 
     // Unload all indexes
@@ -424,6 +653,9 @@ void IndexRegistry::reset() {
     entries_.clear();
     on_load_callback_ = nullptr;
     on_unload_callback_ = nullptr;
+
+    std::lock_guard<std::mutex> preload_lock(preload_mutex_);
+    preload_stats_ = PreloadStats();
 }
 
 } // namespace persist
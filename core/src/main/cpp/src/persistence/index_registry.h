@@ -6,6 +6,7 @@
  * This class provides:
  * - Catalog of all known indexes (from manifest or registration)
  * - Lazy loading of indexes on first access
+ * - Background preloading of the most-accessed fields after a restart
  * - Unloading of cold indexes under memory pressure
  * - Integration with MemoryCoordinator for adaptive memory management
  *
@@ -16,18 +17,28 @@
  *   // Get or load an index (loads on first access)
  *   auto* idx = IndexRegistry::global().get_or_load<DataRecord>("user_locations");
  *
+ *   // After registering from a manifest, warm the hottest fields in the
+ *   // background while the first queries are served
+ *   IndexRegistry::global().start_preload<DataRecord>();
+ *
  *   // Under memory pressure, unload cold indexes
  *   IndexRegistry::global().unload_cold_indexes(target_memory_to_free);
+ *
+ *   // At checkpoint or shutdown, keep the access history for next time
+ *   IndexRegistry::global().persist_access_counts();
  */
 
 #pragma once
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -36,6 +47,7 @@ namespace xtree {
 namespace persist {
 // Forward declaration for manifest integration
 class Manifest;
+class DurableRuntime;
 } // namespace persist
 
 // Forward declarations
@@ -85,11 +97,34 @@ struct IndexMetadata {
     // Memory tracking
     size_t estimated_memory = 0;  // Bytes when loaded
 
-    // Access statistics
+    // Access statistics. access_count starts from the manifest's history
+    // when registered from one.
     std::atomic<uint64_t> access_count{0};
     std::atomic<uint64_t> load_count{0};
 };
 
+/**
+ * Options for a background preload pass.
+ */
+struct PreloadOptions {
+    size_t max_concurrent = 2;       // Loads in flight at once (at least 1)
+    size_t max_indexes = 0;          // Fields to preload, hottest first (0 = all)
+    uint64_t min_access_count = 0;   // Skip fields accessed less often than this
+};
+
+/**
+ * Outcome counters of the current (or last) preload pass.
+ */
+struct PreloadStats {
+    size_t queued = 0;               // Fields the pass started with
+    size_t loaded = 0;               // Loaded by the preloader
+    size_t already_loaded = 0;       // Loaded by a query first
+    size_t failed = 0;
+    size_t cancelled = 0;            // Dropped from the queue by cancel_preload()
+    size_t skipped_for_memory = 0;   // Dropped because MemoryCoordinator had no headroom
+    bool running = false;
+};
+
 /**
  * IndexRegistry: Global registry for lazy index management.
  *
@@ -178,6 +213,61 @@ public:
      */
     bool is_loaded(const std::string& field_name) const;
 
+    // ========== Background Preloading ==========
+
+    /**
+     * Start loading registered (not yet loaded) fields in the background,
+     * highest access_count first, with at most options.max_concurrent loads
+     * in flight. A query for a field that is being preloaded waits for that
+     * load instead of starting its own; a query for a field still queued
+     * loads it directly and the preloader then skips it.
+     *
+     * Before each load the preloader asks MemoryCoordinator::has_headroom();
+     * once the budget is near its pressure threshold the rest of the queue
+     * is dropped rather than loading fields the coordinator would unload.
+     *
+     * Only one pass runs at a time.
+     * @return Number of fields queued (0 if a pass is already running)
+     */
+    template<class Record>
+    size_t start_preload(const PreloadOptions& options = PreloadOptions());
+
+    /**
+     * Drop a queued field from the running pass.
+     * @return true if it was still queued
+     */
+    bool cancel_preload(const std::string& field_name);
+
+    /**
+     * Drop everything still queued and wait for in-flight loads. A load
+     * that has started runs to completion; its index stays loaded.
+     */
+    void cancel_preload();
+
+    /**
+     * Wait for the running pass to finish.
+     * @return true if no pass is running on return
+     */
+    bool wait_preload(std::chrono::milliseconds timeout);
+
+    PreloadStats preload_stats() const;
+
+    // ========== Access History ==========
+
+    /**
+     * Write each field's access_count into the root catalog of the manifest
+     * in its data directory, so the next process preloads in the same
+     * order. Counts are only ever raised. Fields whose data directory has
+     * no manifest, or no root of that name, are skipped.
+     *
+     * A directory with a loaded index is written through that index's
+     * runtime, which owns the manifest. A directory with an index being
+     * loaded or unloaded is left for the next call.
+     *
+     * @return Number of roots updated
+     */
+    size_t persist_access_counts();
+
     // ========== Unloading ==========
 
     /**
@@ -248,8 +338,10 @@ public:
     // ========== Testing ==========
 
     /**
-     * Remove an index from the registry entirely.
-     * Only use for testing - in production, use unload_index().
+     * Remove an index from the registry entirely, unloading it. A queued
+     * preload of the field is dropped and one in flight is waited for, so
+     * nothing is left loaded once this returns.
+     * Used by tests and PartitionedIndex; to free memory, use unload_index().
      */
     void remove_index(const std::string& field_name);
 
@@ -262,34 +354,64 @@ private:
     IndexRegistry() = default;
     ~IndexRegistry();
 
+    struct IndexEntry;
+
     // Internal loading implementation
     template<class Record>
     IndexDetails<Record>* load_index_impl(const std::string& field_name,
-                                          IndexMetadata& meta);
+                                          IndexEntry& entry);
 
     // Internal unloading implementation
-    size_t unload_index_impl(const std::string& field_name, IndexMetadata& meta);
+    size_t unload_index_impl(const std::string& field_name, IndexEntry& entry);
 
     // Update last access time
     void touch(IndexMetadata& meta);
 
+    enum class PreloadOutcome { Loaded, AlreadyLoaded, Failed, Cancelled };
+
+    // Background load of one field; does not count as an access
+    template<class Record>
+    PreloadOutcome preload_one(const std::string& field_name);
+
+    size_t start_preload_impl(std::function<PreloadOutcome(const std::string&)> loader,
+                              const PreloadOptions& options);
+    void preload_worker();
+    void join_preload_threads();
+
     // Per-index state
     struct IndexEntry {
         IndexMetadata metadata;
         void* index_ptr = nullptr;  // Type-erased IndexDetails<Record>*
         std::mutex load_mutex;      // Serializes load/unload for this index
+        bool removed = false;       // Set by remove_index(), under load_mutex
 
         // Destructor function for type-erased cleanup
         std::function<void(void*)> destructor;
+        // Type-erased IndexDetails<Record>::getRuntime()
+        std::function<DurableRuntime*(void*)> runtime;
     };
 
     // Registry state
     mutable std::mutex registry_mutex_;
-    std::unordered_map<std::string, std::unique_ptr<IndexEntry>> entries_;
+    // Shared so that a load or unload which dropped registry_mutex_ keeps
+    // its entry alive through a concurrent remove_index()
+    std::unordered_map<std::string, std::shared_ptr<IndexEntry>> entries_;
 
     // Callbacks
     std::function<void(const std::string&)> on_load_callback_;
     std::function<void(const std::string&)> on_unload_callback_;
+
+    // Preloader state, guarded by preload_mutex_. preload_threads_ is only
+    // touched by the thread starting, cancelling or waiting for a pass.
+    mutable std::mutex preload_mutex_;
+    std::condition_variable preload_done_;
+    std::deque<std::string> preload_queue_;
+    std::function<PreloadOutcome(const std::string&)> preload_loader_;
+    size_t preload_workers_active_ = 0;
+    bool preload_cancel_ = false;
+    PreloadStats preload_stats_;
+    std::mutex preload_threads_mutex_;
+    std::vector<std::thread> preload_threads_;
 };
 
 // ============================================================================
@@ -305,29 +427,32 @@ IndexDetails<Record>* IndexRegistry::get_or_load(const std::string& field_name)
         return nullptr;  // Not registered
     }
 
-    auto& entry = *it->second;
-    auto& meta = entry.metadata;
+    std::shared_ptr<IndexEntry> entry = it->second;
+    auto& meta = entry->metadata;
 
     // Fast path: already loaded
-    if (meta.state == IndexLoadState::LOADED && entry.index_ptr) {
+    if (meta.state == IndexLoadState::LOADED && entry->index_ptr) {
         touch(meta);
         lock.unlock();
-        return static_cast<IndexDetails<Record>*>(entry.index_ptr);
+        return static_cast<IndexDetails<Record>*>(entry->index_ptr);
     }
 
     // Need to load - drop registry lock, take per-index lock
     lock.unlock();
 
-    std::lock_guard<std::mutex> load_lock(entry.load_mutex);
+    std::lock_guard<std::mutex> load_lock(entry->load_mutex);
+    if (entry->removed) {
+        return nullptr;
+    }
 
     // Double-check after acquiring load lock
-    if (meta.state == IndexLoadState::LOADED && entry.index_ptr) {
+    if (meta.state == IndexLoadState::LOADED && entry->index_ptr) {
         touch(meta);
-        return static_cast<IndexDetails<Record>*>(entry.index_ptr);
+        return static_cast<IndexDetails<Record>*>(entry->index_ptr);
     }
 
     // Actually load
-    return load_index_impl<Record>(field_name, meta);
+    return load_index_impl<Record>(field_name, *entry);
 }
 
 template<class Record>
@@ -335,10 +460,47 @@ bool IndexRegistry::load_index(const std::string& field_name) {
     return get_or_load<Record>(field_name) != nullptr;
 }
 
+template<class Record>
+size_t IndexRegistry::start_preload(const PreloadOptions& options) {
+    return start_preload_impl(
+        [this](const std::string& name) { return preload_one<Record>(name); }, options);
+}
+
+template<class Record>
+IndexRegistry::PreloadOutcome IndexRegistry::preload_one(const std::string& field_name) {
+    std::shared_ptr<IndexEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        auto it = entries_.find(field_name);
+        if (it == entries_.end()) {
+            return PreloadOutcome::Cancelled;  // Removed since it was queued
+        }
+        entry = it->second;
+    }
+
+    std::lock_guard<std::mutex> load_lock(entry->load_mutex);
+    if (entry->removed) {
+        return PreloadOutcome::Cancelled;
+    }
+    auto& meta = entry->metadata;
+    if (meta.state == IndexLoadState::LOADED && entry->index_ptr) {
+        return PreloadOutcome::AlreadyLoaded;
+    }
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        if (preload_cancel_) {
+            return PreloadOutcome::Cancelled;
+        }
+    }
+    return load_index_impl<Record>(field_name, *entry) ? PreloadOutcome::Loaded
+                                                       : PreloadOutcome::Failed;
+}
+
 template<class Record>
 IndexDetails<Record>* IndexRegistry::load_index_impl(const std::string& field_name,
-                                                      IndexMetadata& meta) {
+                                                      IndexEntry& entry) {
     // Must hold entry's load_mutex when calling this
+    auto& meta = entry.metadata;
 
     if (meta.state == IndexLoadState::LOADING) {
         return nullptr;  // Already loading (shouldn't happen with proper locking)
@@ -376,13 +538,13 @@ IndexDetails<Record>* IndexRegistry::load_index_impl(const std::string& field_na
         // Store in registry
         {
             std::lock_guard<std::mutex> lock(registry_mutex_);
-            auto it = entries_.find(field_name);
-            if (it != entries_.end()) {
-                it->second->index_ptr = idx;
-                it->second->destructor = [](void* p) {
-                    delete static_cast<IndexDetails<Record>*>(p);
-                };
-            }
+            entry.index_ptr = idx;
+            entry.destructor = [](void* p) {
+                delete static_cast<IndexDetails<Record>*>(p);
+            };
+            entry.runtime = [](void* p) {
+                return static_cast<IndexDetails<Record>*>(p)->getRuntime();
+            };
         }
 
         // Update metadata
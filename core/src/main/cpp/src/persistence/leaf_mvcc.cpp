@@ -0,0 +1,420 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include "leaf_mvcc.h"
+#include "checksums.h"
+#include "../util/endian.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace xtree {
+    namespace persist {
+
+        using namespace xtree::util;  // For endian helpers (store_le*, load_le*)
+
+        namespace {
+            // Image header: magic u32 | version u16 | dims u16 | count u32 | id bytes u32
+            constexpr uint32_t kLeafMagic = 0x43564D4C;  // "LMVC"
+            constexpr uint16_t kLeafVersion = 1;
+            constexpr size_t kImageHeaderSize = 16;
+
+            // Journal entry: crc u32 | body_len u16 | body, where body is
+            // op u8 | epoch u64 | id_len u16 | id | [box floats for insert/update]
+            // and the CRC covers body_len and body
+            constexpr uint8_t kOpInsert = 1;
+            constexpr uint8_t kOpRemove = 2;
+            constexpr uint8_t kOpUpdate = 3;
+            constexpr size_t kEntryPrefix = 6;
+            constexpr size_t kEntryFixedBody = 1 + 8 + 2;
+
+            size_t image_size(size_t dims, size_t n, size_t id_bytes) {
+                return kImageHeaderSize +
+                       n * (sizeof(uint64_t) * 2 + sizeof(uint8_t) + sizeof(uint16_t)) +
+                       n * dims * 2 * sizeof(float) +
+                       id_bytes + sizeof(uint32_t);
+            }
+
+            uint64_t hash_id(std::string_view id) {
+                return std::hash<std::string_view>{}(id);
+            }
+        }
+
+        MVCCLeaf::MVCCLeaf(uint16_t dims) : dims_(dims), lo_(dims), hi_(dims) {}
+
+        uint32_t MVCCLeaf::insert(std::string_view row_id, const float* box, uint64_t epoch) {
+            const int64_t slot = apply(kOpInsert, row_id, box, epoch);
+            journal_entry(kOpInsert, row_id, box, epoch);
+            return static_cast<uint32_t>(slot);
+        }
+
+        bool MVCCLeaf::remove(std::string_view row_id, uint64_t epoch) {
+            if (apply(kOpRemove, row_id, nullptr, epoch) < 0) {
+                return false;
+            }
+            journal_entry(kOpRemove, row_id, nullptr, epoch);
+            return true;
+        }
+
+        uint32_t MVCCLeaf::update(std::string_view row_id, const float* box, uint64_t epoch) {
+            const int64_t slot = apply(kOpUpdate, row_id, box, epoch);
+            journal_entry(kOpUpdate, row_id, box, epoch);
+            return static_cast<uint32_t>(slot);
+        }
+
+        size_t MVCCLeaf::max_row_id_length() const {
+            const size_t box_bytes = static_cast<size_t>(dims_) * 2 * sizeof(float);
+            return box_bytes + kEntryFixedBody > UINT16_MAX ? 0 : UINT16_MAX - kEntryFixedBody - box_bytes;
+        }
+
+        bool MVCCLeaf::fits_journal(std::string_view row_id) const {
+            return kEntryFixedBody + static_cast<size_t>(dims_) * 2 * sizeof(float) + row_id.size() <= UINT16_MAX;
+        }
+
+        int64_t MVCCLeaf::apply(uint8_t op, std::string_view row_id, const float* box, uint64_t epoch) {
+            // Checked before anything is retired, so a rejected update is a no-op
+            if (!fits_journal(row_id)) {
+                throw std::runtime_error("MVCCLeaf: row id too long for a journal entry");
+            }
+            if (op != kOpInsert) {
+                const int64_t old = find_live(row_id);
+                if (old >= 0) {
+                    retire_slot(static_cast<uint32_t>(old), epoch,
+                                op == kOpRemove ? kRecordTombstone : 0);
+                }
+                if (op == kOpRemove) {
+                    return old;
+                }
+            }
+            append_version(row_id, box, epoch);
+            return static_cast<int64_t>(birth_.size() - 1);
+        }
+
+        void MVCCLeaf::append_version(std::string_view row_id, const float* box, uint64_t epoch) {
+            if (!fits_journal(row_id)) {
+                throw std::runtime_error("MVCCLeaf: row id too long for a journal entry");
+            }
+            const size_t slot = birth_.size();
+            birth_.push_back(epoch);
+            retire_.push_back(kLiveEpoch);
+            flags_.push_back(0);
+
+            id_off_.push_back(static_cast<uint32_t>(ids_.size()));
+            id_len_.push_back(static_cast<uint16_t>(row_id.size()));
+            id_hash_.push_back(hash_id(row_id));
+            ids_.append(row_id.data(), row_id.size());
+
+            for (uint16_t d = 0; d < dims_; ++d) {
+                lo_[d].push_back(box[2 * d]);
+                hi_[d].push_back(box[2 * d + 1]);
+            }
+
+            if (slot / 64 >= live_.size()) {
+                live_.push_back(0);
+            }
+            live_[slot / 64] |= 1ull << (slot % 64);
+        }
+
+        void MVCCLeaf::retire_slot(uint32_t slot, uint64_t epoch, uint8_t flags) {
+            retire_[slot] = epoch;
+            flags_[slot] |= flags;
+            live_[slot / 64] &= ~(1ull << (slot % 64));
+        }
+
+        int64_t MVCCLeaf::find_live(std::string_view row_id) const {
+            const uint64_t h = hash_id(row_id);
+            for (size_t w = 0; w < live_.size(); ++w) {
+                uint64_t word = live_[w];
+                while (word) {
+                    const uint32_t slot = static_cast<uint32_t>(w * 64 + lowest_bit(word));
+                    word &= word - 1;
+                    if (id_hash_[slot] == h && this->row_id(slot) == row_id) {
+                        return slot;
+                    }
+                }
+            }
+            return -1;
+        }
+
+        int64_t MVCCLeaf::find(std::string_view row_id, uint64_t snapshot) const {
+            const uint64_t h = hash_id(row_id);
+            for (size_t slot = 0; slot < birth_.size(); ++slot) {
+                if (id_hash_[slot] == h && visible(static_cast<uint32_t>(slot), snapshot) &&
+                    this->row_id(static_cast<uint32_t>(slot)) == row_id) {
+                    return static_cast<int64_t>(slot);
+                }
+            }
+            return -1;
+        }
+
+        uint64_t MVCCLeaf::match_word(size_t w, uint64_t snapshot, const float* query) const {
+            const size_t base = w * 64;
+            const size_t n = std::min<size_t>(64, birth_.size() - base);
+
+            // Visibility first, then one pass per dimension over the box
+            // columns; the inner loops are branch-free so they vectorise
+            uint64_t mask = 0;
+            const uint64_t* birth = birth_.data() + base;
+            const uint64_t* retire = retire_.data() + base;
+            for (size_t i = 0; i < n; ++i) {
+                mask |= static_cast<uint64_t>(birth[i] <= snapshot && snapshot < retire[i]) << i;
+            }
+            for (uint16_t d = 0; d < dims_ && mask; ++d) {
+                const float qlo = query[2 * d], qhi = query[2 * d + 1];
+                const float* lo = lo_[d].data() + base;
+                const float* hi = hi_[d].data() + base;
+                uint64_t hit = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    hit |= static_cast<uint64_t>(lo[i] <= qhi && hi[i] >= qlo) << i;
+                }
+                mask &= hit;
+            }
+            return mask;
+        }
+
+        size_t MVCCLeaf::count_visible(uint64_t snapshot) const {
+            size_t n = 0;
+            for (size_t slot = 0; slot < birth_.size(); ++slot) {
+                n += visible(static_cast<uint32_t>(slot), snapshot);
+            }
+            return n;
+        }
+
+        size_t MVCCLeaf::live_count() const {
+            return static_cast<size_t>(std::count(retire_.begin(), retire_.end(), kLiveEpoch));
+        }
+
+        size_t MVCCLeaf::memory_usage() const {
+            size_t bytes = sizeof(*this) + ids_.capacity() + journal_.capacity() +
+                           birth_.capacity() * sizeof(uint64_t) +
+                           retire_.capacity() * sizeof(uint64_t) +
+                           flags_.capacity() +
+                           id_off_.capacity() * sizeof(uint32_t) +
+                           id_len_.capacity() * sizeof(uint16_t) +
+                           id_hash_.capacity() * sizeof(uint64_t) +
+                           live_.capacity() * sizeof(uint64_t);
+            for (uint16_t d = 0; d < dims_; ++d) {
+                bytes += (lo_[d].capacity() + hi_[d].capacity()) * sizeof(float);
+            }
+            return bytes;
+        }
+
+        double MVCCLeaf::dead_ratio(uint64_t min_active_epoch) const {
+            if (birth_.empty()) {
+                return 0.0;
+            }
+            size_t dead = 0;
+            for (uint64_t retire : retire_) {
+                dead += retire <= min_active_epoch;
+            }
+            return static_cast<double>(dead) / static_cast<double>(birth_.size());
+        }
+
+        size_t MVCCLeaf::compact(uint64_t min_active_epoch) {
+            MVCCLeaf kept(dims_);
+            std::vector<float> box(2 * dims_);
+            for (uint32_t slot = 0; slot < birth_.size(); ++slot) {
+                if (retire_[slot] <= min_active_epoch) {
+                    continue;  // invisible to every pinned and future reader
+                }
+                for (uint16_t d = 0; d < dims_; ++d) {
+                    box[2 * d] = lo_[d][slot];
+                    box[2 * d + 1] = hi_[d][slot];
+                }
+                kept.append_version(row_id(slot), box.data(), birth_[slot]);
+                const uint32_t k = static_cast<uint32_t>(kept.size() - 1);
+                if (retire_[slot] != kLiveEpoch) {
+                    kept.retire_slot(k, retire_[slot], flags_[slot]);
+                }
+            }
+
+            const size_t dropped = birth_.size() - kept.size();
+            if (dropped > 0) {
+                kept.journal_ = std::move(journal_);
+                kept.image_bytes_ = image_bytes_;
+                kept.journal_bytes_ = journal_bytes_;
+                *this = std::move(kept);
+                needs_image_ = true;
+            }
+            return dropped;
+        }
+
+        size_t MVCCLeaf::wire_size() const {
+            return image_size(dims_, birth_.size(), ids_.size());
+        }
+
+        uint8_t* MVCCLeaf::to_wire(uint8_t* out) {
+            const size_t n = birth_.size();
+            uint8_t* p = out;
+            store_le32(p, kLeafMagic);                           p += 4;
+            store_le16(p, kLeafVersion);                         p += 2;
+            store_le16(p, dims_);                                p += 2;
+            store_le32(p, static_cast<uint32_t>(n));             p += 4;
+            store_le32(p, static_cast<uint32_t>(ids_.size()));   p += 4;
+
+            for (size_t i = 0; i < n; ++i) { store_le64(p, birth_[i]);  p += 8; }
+            for (size_t i = 0; i < n; ++i) { store_le64(p, retire_[i]); p += 8; }
+            std::memcpy(p, flags_.data(), n);                    p += n;
+            for (size_t i = 0; i < n; ++i) { store_le16(p, id_len_[i]); p += 2; }
+            for (uint16_t d = 0; d < dims_; ++d) {
+                for (size_t i = 0; i < n; ++i) { store_lef32(p, lo_[d][i]); p += 4; }
+                for (size_t i = 0; i < n; ++i) { store_lef32(p, hi_[d][i]); p += 4; }
+            }
+            std::memcpy(p, ids_.data(), ids_.size());            p += ids_.size();
+
+            store_le32(p, CRC32C::compute(out, static_cast<size_t>(p - out)));
+            p += 4;
+
+            // The image now carries everything the journal did
+            journal_.clear();
+            image_bytes_ = static_cast<size_t>(p - out);
+            journal_bytes_ = 0;
+            needs_image_ = false;
+            return p;
+        }
+
+        MVCCLeaf MVCCLeaf::from_wire(const uint8_t* in, size_t len, size_t* consumed) {
+            if (len < kImageHeaderSize + 4 || load_le32(in) != kLeafMagic) {
+                throw std::runtime_error("MVCCLeaf: not a leaf image");
+            }
+            if (load_le16(in + 4) != kLeafVersion) {
+                throw std::runtime_error("MVCCLeaf: unsupported leaf image version");
+            }
+            const uint16_t dims = load_le16(in + 6);
+            const size_t n = load_le32(in + 8);
+            const size_t id_bytes = load_le32(in + 12);
+
+            const size_t size = image_size(dims, n, id_bytes);
+            if (len < size) {
+                throw std::runtime_error("MVCCLeaf: truncated leaf image");
+            }
+            if (CRC32C::compute(in, size - 4) != load_le32(in + size - 4)) {
+                throw std::runtime_error("MVCCLeaf: leaf image checksum mismatch");
+            }
+
+            MVCCLeaf leaf(dims);
+            const uint8_t* p = in + kImageHeaderSize;
+            leaf.ids_.resize(id_bytes);
+            leaf.birth_.resize(n);
+            leaf.retire_.resize(n);
+            leaf.flags_.resize(n);
+            leaf.id_len_.resize(n);
+            leaf.id_off_.resize(n);
+            leaf.id_hash_.resize(n);
+            leaf.live_.assign((n + 63) / 64, 0);
+            for (size_t i = 0; i < n; ++i) { leaf.birth_[i] = load_le64(p);  p += 8; }
+            for (size_t i = 0; i < n; ++i) { leaf.retire_[i] = load_le64(p); p += 8; }
+            std::memcpy(leaf.flags_.data(), p, n);               p += n;
+            for (size_t i = 0; i < n; ++i) { leaf.id_len_[i] = load_le16(p); p += 2; }
+            for (uint16_t d = 0; d < dims; ++d) {
+                leaf.lo_[d].resize(n);
+                leaf.hi_[d].resize(n);
+                for (size_t i = 0; i < n; ++i) { leaf.lo_[d][i] = load_lef32(p); p += 4; }
+                for (size_t i = 0; i < n; ++i) { leaf.hi_[d][i] = load_lef32(p); p += 4; }
+            }
+            std::memcpy(&leaf.ids_[0], p, id_bytes);
+
+            uint32_t off = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (off + leaf.id_len_[i] > id_bytes) {
+                    throw std::runtime_error("MVCCLeaf: row id lengths overrun the arena");
+                }
+                leaf.id_off_[i] = off;
+                off += leaf.id_len_[i];
+                leaf.id_hash_[i] = hash_id(leaf.row_id(static_cast<uint32_t>(i)));
+                if (leaf.retire_[i] == kLiveEpoch) {
+                    leaf.live_[i / 64] |= 1ull << (i % 64);
+                }
+            }
+
+            leaf.image_bytes_ = size;
+            leaf.needs_image_ = false;
+            if (consumed) {
+                *consumed = size;
+            }
+            return leaf;
+        }
+
+        void MVCCLeaf::journal_entry(uint8_t op, std::string_view row_id, const float* box, uint64_t epoch) {
+            const size_t box_bytes = (op == kOpRemove) ? 0 : dims_ * 2 * sizeof(float);
+            const size_t body = kEntryFixedBody + row_id.size() + box_bytes;
+            const size_t start = journal_.size();
+            journal_.resize(start + kEntryPrefix + body);
+
+            uint8_t* p = journal_.data() + start + 4;
+            store_le16(p, static_cast<uint16_t>(body));          p += 2;
+            *p++ = op;
+            store_le64(p, epoch);                                p += 8;
+            store_le16(p, static_cast<uint16_t>(row_id.size())); p += 2;
+            std::memcpy(p, row_id.data(), row_id.size());        p += row_id.size();
+            for (size_t i = 0; i < box_bytes / sizeof(float); ++i) {
+                store_lef32(p, box[i]);
+                p += 4;
+            }
+            store_le32(journal_.data() + start, CRC32C::compute(journal_.data() + start + 4, 2 + body));
+        }
+
+        std::vector<uint8_t> MVCCLeaf::take_journal() {
+            std::vector<uint8_t> out;
+            out.swap(journal_);
+            journal_bytes_ += out.size();
+            return out;
+        }
+
+        size_t MVCCLeaf::replay(const uint8_t* journal, size_t len) {
+            size_t applied = 0;
+            size_t pos = 0;
+            std::vector<float> box(2 * dims_);
+            while (len - pos >= kEntryPrefix) {
+                const uint8_t* e = journal + pos;
+                const size_t body = load_le16(e + 4);
+                if (body < kEntryFixedBody || len - pos < kEntryPrefix + body ||
+                    CRC32C::compute(e + 4, 2 + body) != load_le32(e)) {
+                    break;  // torn or corrupt tail
+                }
+                const uint8_t* p = e + kEntryPrefix;
+                const uint8_t op = *p++;
+                const uint64_t epoch = load_le64(p);            p += 8;
+                const size_t id_len = load_le16(p);             p += 2;
+                const size_t box_bytes = (op == kOpRemove) ? 0 : dims_ * 2 * sizeof(float);
+                if ((op != kOpInsert && op != kOpRemove && op != kOpUpdate) ||
+                    body != kEntryFixedBody + id_len + box_bytes) {
+                    break;
+                }
+                const std::string_view id(reinterpret_cast<const char*>(p), id_len);
+                p += id_len;
+                for (size_t i = 0; i < box_bytes / sizeof(float); ++i) {
+                    box[i] = load_lef32(p);
+                    p += 4;
+                }
+                apply(op, id, box.data(), epoch);
+                pos += kEntryPrefix + body;
+                ++applied;
+            }
+            journal_bytes_ += pos;
+            return applied;
+        }
+
+        bool MVCCLeaf::should_rewrite() const {
+            return needs_image_ || journal_bytes_ + journal_.size() > image_bytes_;
+        }
+
+    } // namespace persist
+} // namespace xtree
@@ -0,0 +1,232 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+/*
+ * Leaf-level MVCC (IMPLEMENTATION_PLAN.md Phase 6).
+ *
+ * A MVCCLeaf holds a leaf's records inline instead of as one DataRecord
+ * node (NodeID + OT row + allocation) per record. Records are stored
+ * structure-of-arrays: one column per header field, one min and one max
+ * column per dimension, and the row ids packed in a single arena. A scan
+ * over a dimension therefore touches one contiguous float array.
+ *
+ * Every record version carries [birth_epoch, retire_epoch). Inserts append
+ * a version; deletes retire the live version in place and flag it as a
+ * tombstone; updates retire and append. A reader pinned at epoch E sees a
+ * version iff birth_epoch <= E < retire_epoch, so readers never wait on
+ * the writer and never see half a batch. Versions no pinned reader can
+ * see (retire_epoch <= MVCCContext::min_active_epoch()) are dropped by
+ * compact().
+ *
+ * Persistence is a base image (to_wire) plus a journal of small,
+ * individually checksummed mutation entries (take_journal). A point update
+ * appends tens of bytes to the leaf's journal instead of rewriting the
+ * leaf; the base is rewritten only when should_rewrite() says the journal
+ * has grown past the image or compaction has space to give back. Journal
+ * entries name records by row id, not slot, so they stay valid across
+ * compact().
+ *
+ * Single writer per leaf; the caller serialises writers (the bucket's
+ * write lock). Concurrent readers need the usual COW publication of the
+ * leaf, exactly as for XTreeBucket today.
+ *
+ * Status: storage building block only. Nothing in the tree constructs an
+ * MVCCLeaf yet; XTreeBucket leaves still hold one DataRecord child per
+ * record and publishDirtyBuckets() still rewrites whole leaves. Adopting
+ * it is the open "Update leaf operations for MVCC" item of Phase 6.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace xtree {
+    namespace persist {
+
+        // Per-version header (design doc §14.1), as returned by MVCCLeaf::header()
+        struct RecordHeader {
+            uint64_t birth_epoch;   // first epoch the version is visible at
+            uint64_t retire_epoch;  // first epoch it is no longer visible at; kLiveEpoch while live
+            uint8_t  flags;         // RecordFlags
+        };
+
+        enum RecordFlags : uint8_t {
+            kRecordTombstone = 0x1  // retired by a delete rather than superseded by an update
+        };
+
+        constexpr uint64_t kLiveEpoch = UINT64_MAX;
+
+        class MVCCLeaf {
+        public:
+            // Dead-version fraction at which should_compact() fires
+            static constexpr double kDefaultCompactRatio = 0.3;
+
+            explicit MVCCLeaf(uint16_t dims);
+
+            // --- Writers (stamped with the writer's commit epoch) ---
+
+            // Append a live version. box is interleaved [min0, max0, min1, max1, ...]
+            // like KeyMBR. Returns its slot.
+            // Row ids longer than max_row_id_length() throw std::runtime_error.
+            uint32_t insert(std::string_view row_id, const float* box, uint64_t epoch);
+
+            // Retire the live version of row_id as a tombstone. False if none is live.
+            bool remove(std::string_view row_id, uint64_t epoch);
+
+            // Retire the live version (if any) and append the new one. Same
+            // row id limit as insert; an overlong id leaves the leaf unchanged.
+            uint32_t update(std::string_view row_id, const float* box, uint64_t epoch);
+
+            // Longest row id whose journal entry, box included, fits the
+            // 16-bit entry length: just under 64 KB, less 8 bytes per dimension
+            size_t max_row_id_length() const;
+
+            // --- Readers ---
+
+            bool visible(uint32_t slot, uint64_t snapshot) const {
+                return birth_[slot] <= snapshot && snapshot < retire_[slot];
+            }
+
+            // Calls fn(slot) for every version visible at snapshot whose box
+            // intersects query (interleaved like insert). Returns the match count.
+            template< typename Fn >
+            size_t scan(uint64_t snapshot, const float* query, Fn&& fn) const {
+                size_t matches = 0;
+                for (size_t w = 0; w < live_.size(); ++w) {
+                    uint64_t mask = match_word(w, snapshot, query);
+                    while (mask) {
+                        const uint32_t slot = static_cast<uint32_t>(w * 64 + lowest_bit(mask));
+                        mask &= mask - 1;
+                        fn(slot);
+                        ++matches;
+                    }
+                }
+                return matches;
+            }
+
+            size_t count_visible(uint64_t snapshot) const;
+
+            // Slot of the version of row_id visible at snapshot, or -1
+            int64_t find(std::string_view row_id, uint64_t snapshot) const;
+
+            std::string_view row_id(uint32_t slot) const {
+                return std::string_view(ids_.data() + id_off_[slot], id_len_[slot]);
+            }
+            float min(uint32_t slot, uint16_t axis) const { return lo_[axis][slot]; }
+            float max(uint32_t slot, uint16_t axis) const { return hi_[axis][slot]; }
+            RecordHeader header(uint32_t slot) const {
+                return RecordHeader{birth_[slot], retire_[slot], flags_[slot]};
+            }
+
+            uint16_t dims() const { return dims_; }
+            size_t size() const { return birth_.size(); }        // all versions
+            size_t live_count() const;                          // versions not yet retired
+            size_t memory_usage() const;
+
+            // --- Maintenance ---
+
+            // Fraction of versions no reader at or after min_active_epoch can see
+            double dead_ratio(uint64_t min_active_epoch) const;
+            bool should_compact(uint64_t min_active_epoch,
+                                double threshold = kDefaultCompactRatio) const {
+                return dead_ratio(min_active_epoch) >= threshold;
+            }
+
+            // Drop those versions, renumbering the slots. should_rewrite()
+            // turns true so the space is given back on disk as well. Returns
+            // the number of versions dropped.
+            size_t compact(uint64_t min_active_epoch);
+
+            // --- Persistence ---
+
+            // Base image: header, columns, row-id arena, CRC32C trailer
+            size_t wire_size() const;
+            uint8_t* to_wire(uint8_t* out);
+            // Throws std::runtime_error on a bad magic, length or CRC. in may
+            // run on into the journal; *consumed receives the image size.
+            static MVCCLeaf from_wire(const uint8_t* in, size_t len, size_t* consumed = nullptr);
+
+            // Mutations since the last to_wire()/take_journal(), encoded as
+            // self-checksummed entries to append after the persisted image
+            std::vector<uint8_t> take_journal();
+
+            // Apply journal entries in order. Stops at the first truncated or
+            // corrupt entry (a torn append) and returns the entries applied.
+            size_t replay(const uint8_t* journal, size_t len);
+
+            // True once appended journal bytes exceed the image, or after compact()
+            bool should_rewrite() const;
+
+        private:
+            static unsigned lowest_bit(uint64_t word) {
+            #if defined(__GNUC__) || defined(__clang__)
+                return static_cast<unsigned>(__builtin_ctzll(word));
+            #elif defined(_MSC_VER)
+                unsigned long bit;
+                _BitScanForward64(&bit, word);
+                return static_cast<unsigned>(bit);
+            #else
+                unsigned bit = 0;
+                while ((word & 1ull) == 0) { word >>= 1; ++bit; }
+                return bit;
+            #endif
+            }
+
+            bool fits_journal(std::string_view row_id) const;
+            void append_version(std::string_view row_id, const float* box, uint64_t epoch);
+            int64_t find_live(std::string_view row_id) const;
+            void retire_slot(uint32_t slot, uint64_t epoch, uint8_t flags);
+            int64_t apply(uint8_t op, std::string_view row_id, const float* box, uint64_t epoch);
+            void journal_entry(uint8_t op, std::string_view row_id, const float* box, uint64_t epoch);
+            uint64_t match_word(size_t w, uint64_t snapshot, const float* query) const;
+
+            uint16_t dims_;
+
+            // Version header columns
+            std::vector<uint64_t> birth_;
+            std::vector<uint64_t> retire_;
+            std::vector<uint8_t>  flags_;
+
+            // Row ids: packed arena plus per-slot offset, length and hash
+            std::string           ids_;
+            std::vector<uint32_t> id_off_;
+            std::vector<uint16_t> id_len_;
+            std::vector<uint64_t> id_hash_;
+
+            // Box columns, one min and one max array per dimension
+            std::vector<std::vector<float>> lo_;
+            std::vector<std::vector<float>> hi_;
+
+            // Bit per slot, set while the version is live (retire_epoch == kLiveEpoch)
+            std::vector<uint64_t> live_;
+
+            std::vector<uint8_t> journal_;
+            size_t image_bytes_ = 0;      // size of the last base image
+            size_t journal_bytes_ = 0;    // journal handed out since that image
+            bool needs_image_ = true;     // no image yet, or compact() since
+        };
+
+    } // namespace persist
+} // namespace xtree
@@ -267,6 +267,11 @@ std::string Manifest::to_json() const {
                 }
                 writer.EndArray();
             }
+
+            if (root.access_count > 0) {
+                writer.Key("access_count");
+                writer.Uint64(root.access_count);
+            }
             
             writer.EndObject();
         }
@@ -429,6 +434,10 @@ bool Manifest::from_json(const std::string& json_str) {
                     }
                 }
             }
+
+            if (root_obj.HasMember("access_count") && root_obj["access_count"].IsUint64()) {
+                entry.access_count = root_obj["access_count"].GetUint64();
+            }
             
             roots_.push_back(entry);
         }
@@ -42,10 +42,10 @@ public:
     // Checkpoint information
     struct CheckpointInfo {
         std::string path;
-        uint64_t epoch;
-        size_t size;
-        size_t entries;
-        uint32_t crc32c;
+        uint64_t epoch = 0;      // 0 until a manifest with a checkpoint is loaded
+        size_t size = 0;
+        size_t entries = 0;
+        uint32_t crc32c = 0;
     };
     
     // Delta log information
@@ -70,6 +70,7 @@ public:
         uint64_t node_id_raw;    // NodeID raw value (explicit naming)
         uint64_t epoch;          // Last update epoch
         std::vector<float> mbr;  // Root MBR: [min0, max0, min1, max1, ...] (dims*2 values)
+        uint64_t access_count = 0;  // Lifetime accesses via IndexRegistry (preload ranking)
     };
     
     explicit Manifest(const std::string& data_dir);
@@ -133,8 +134,20 @@ public:
     // Helper to generate manifest path
     std::string get_manifest_path() const;  // Implementation in .cpp to use filesystem::path
     
-    // Root catalog operations for multi-field support
-    void set_roots(const std::vector<RootEntry>& roots) { roots_ = roots; }
+    // Root catalog operations for multi-field support.
+    // Access counts only grow: a root keeps the larger of its current and
+    // new count, so a catalog rewrite does not drop recorded history.
+    void set_roots(const std::vector<RootEntry>& roots) {
+        std::vector<RootEntry> next = roots;
+        for (auto& root : next) {
+            for (const auto& old : roots_) {
+                if (old.name == root.name && old.access_count > root.access_count) {
+                    root.access_count = old.access_count;
+                }
+            }
+        }
+        roots_ = std::move(next);
+    }
     void clear_roots() { roots_.clear(); }
     bool has_roots() const { return !roots_.empty(); }
     
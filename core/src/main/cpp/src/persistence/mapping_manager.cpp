@@ -4,6 +4,7 @@
 
 #include "mapping_manager.h"
 #include "config.h"  // For sys_config::get_page_size()
+#include "storage_config.h"  // For StorageConfig::parseHugePages()
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -22,6 +23,38 @@
 namespace xtree {
 namespace persist {
 
+namespace {
+
+#ifdef MADV_HUGEPAGE
+// Map [off, off+len) of fd at a huge-page-aligned address, or MAP_FAILED.
+// Over-reserves by one huge page and trims what the alignment skipped.
+void* mmap_huge_aligned(int fd, size_t off, size_t len, int prot) {
+    const size_t align = sys_config::kHugePageSize;
+    const size_t span_len = len + align;
+    void* span = mmap(nullptr, span_len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (span == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    const uintptr_t raw = reinterpret_cast<uintptr_t>(span);
+    const uintptr_t aligned = (raw + align - 1) & ~(uintptr_t(align) - 1);
+    void* addr = mmap(reinterpret_cast<void*>(aligned), len, prot, MAP_SHARED | MAP_FIXED, fd, off);
+    if (addr == MAP_FAILED) {
+        munmap(span, span_len);
+        return MAP_FAILED;
+    }
+    if (aligned > raw) {
+        munmap(span, aligned - raw);
+    }
+    const uintptr_t tail = aligned + sys_config::page_align(len);
+    if (raw + span_len > tail) {
+        munmap(reinterpret_cast<void*>(tail), raw + span_len - tail);
+    }
+    return addr;
+}
+#endif
+
+} // namespace
+
 MappingManager& MappingManager::global() {
     // Meyers' singleton - thread-safe lazy initialization (C++11)
     static MappingManager* instance = []() {
@@ -62,6 +95,9 @@ MappingManager& MappingManager::global() {
             max_extents
         );
         mm->set_memory_budget(max_memory);
+        if (const char* env = std::getenv("XTREE_HUGE_PAGES")) {
+            mm->set_huge_pages(StorageConfig::parseHugePages(env));
+        }
         return mm;
     }();
     return *instance;
@@ -117,8 +153,12 @@ void MappingManager::Pin::release() {
             // It marks pages as "can be reused immediately" rather than just hinting
             madvise(ptr_, size_, MADV_FREE);
 #else
-            // Linux: MADV_DONTNEED immediately drops pages from RSS
-            madvise(ptr_, size_, MADV_DONTNEED);
+            // Linux: MADV_DONTNEED immediately drops pages from RSS. Not on
+            // huge extents: it would split the huge page under the segment,
+            // and eviction releases the whole window anyway.
+            if (!ext_->huge) {
+                madvise(ptr_, size_, MADV_DONTNEED);
+            }
 #endif
         }
 
@@ -213,6 +253,11 @@ MappingManager::Pin MappingManager::pin(const std::string& path,
     ext->update_last_use();
     total_pins_++;
 
+    // Feed the extent miss ratio curve, keyed by (file, window)
+    const uint64_t window_key = std::hash<std::string>{}(cpath) ^
+        ((ext->file_off / window_size_) * 0x9E3779B97F4A7C15ULL);
+    extent_mrc_.access(window_key, ext->length);
+
     return Pin(this, fmap, ext, ptr, len);
 }
 
@@ -237,12 +282,16 @@ void MappingManager::prefetch(const std::string& path,
     FileMapping* fmap = it->second.get();
     
     // For each range, issue madvise(MADV_WILLNEED) if mapped
+    const uintptr_t page = sys_config::get_page_size();
     for (const auto& [off, len] : ranges) {
         MappingExtent* ext = fmap->find_extent(off, len);
         if (ext && ext->base) {
             uint8_t* ptr = ext->ptr_at(off);
             if (ptr) {
-                madvise(ptr, len, MADV_WILLNEED);
+                // madvise needs a page-aligned start
+                const uintptr_t start = reinterpret_cast<uintptr_t>(ptr) & ~(page - 1);
+                madvise(reinterpret_cast<void*>(start),
+                        reinterpret_cast<uintptr_t>(ptr) + len - start, MADV_WILLNEED);
             }
         }
     }
@@ -299,6 +348,16 @@ void MappingManager::debug_evict_all_unpinned() {
     fhr_.debug_evict_all_unpinned();
 }
 
+void MappingManager::set_huge_pages(bool on) {
+    std::lock_guard<std::mutex> lock(mu_);
+    huge_pages_ = on;
+}
+
+bool MappingManager::huge_pages() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return huge_pages_;
+}
+
 void MappingManager::set_memory_budget(size_t max_bytes, float eviction_headroom) {
     std::lock_guard<std::mutex> lock(mu_);
     max_memory_budget_ = max_bytes;
@@ -322,6 +381,15 @@ MappingManager::MappingStats MappingManager::getStats() const {
     stats.total_pins_active = total_pins_;
     stats.evictions_count = total_evictions_;
     stats.evictions_bytes = evictions_bytes_;
+    for (const auto& [path, fmap] : by_file_) {
+        if (!fmap) continue;
+        for (const auto& ext : fmap->extents) {
+            if (ext && ext->huge) {
+                stats.huge_extents++;
+                stats.huge_bytes += ext->length;
+            }
+        }
+    }
     if (max_memory_budget_ > 0) {
         stats.memory_utilization =
             static_cast<double>(total_memory_mapped_) / static_cast<double>(max_memory_budget_);
@@ -588,7 +656,18 @@ std::unique_ptr<MappingExtent> MappingManager::create_extent(
         prot |= PROT_WRITE;
     }
     
-    void* addr = mmap(nullptr, len, prot, MAP_SHARED, fh.fd, file_off);
+    void* addr = MAP_FAILED;
+    bool huge = false;
+#ifdef MADV_HUGEPAGE
+    if (huge_pages_ && file_off % sys_config::kHugePageSize == 0) {
+        addr = mmap_huge_aligned(fh.fd, file_off, len, prot);
+        // No MADV_RANDOM here: readahead is what builds the large folios
+        huge = addr != MAP_FAILED && madvise(addr, len, MADV_HUGEPAGE) == 0;
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        addr = mmap(nullptr, len, prot, MAP_SHARED, fh.fd, file_off);
+    }
     if (addr == MAP_FAILED) {
         throw std::runtime_error("mmap failed for " + fh.path + 
                                " at offset " + std::to_string(file_off) +
@@ -598,9 +677,13 @@ std::unique_ptr<MappingExtent> MappingManager::create_extent(
     
     // Advise the kernel about our access pattern
     // For segment allocator, random access is typical
-    madvise(addr, len, MADV_RANDOM);
+    if (!huge) {
+        madvise(addr, len, MADV_RANDOM);
+    }
     
-    return std::make_unique<MappingExtent>(static_cast<uint8_t*>(addr), len, file_off);
+    auto ext = std::make_unique<MappingExtent>(static_cast<uint8_t*>(addr), len, file_off);
+    ext->huge = huge;
+    return ext;
 }
 
 void MappingManager::register_file_for_field(const std::string& path,
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "file_handle_registry.h"
+#include "../util/miss_ratio_curve.h"
 #include <string>
 #include <memory>
 #include <vector>
@@ -25,6 +26,7 @@ struct MappingExtent {
     size_t   file_off = 0;        // offset in file this window starts at
     uint32_t pins = 0;            // segments using this extent
     uint64_t last_use_ns = 0;     // for LRU
+    bool     huge = false;        // 2MB-aligned and advised MADV_HUGEPAGE
     
     MappingExtent() = default;
     MappingExtent(uint8_t* base_, size_t length_, size_t file_off_)
@@ -173,6 +175,14 @@ public:
     size_t get_memory_budget() const { return max_memory_budget_; }
     size_t get_total_memory_mapped() const;
     float get_eviction_headroom() const { return eviction_headroom_; }
+
+    // Huge page mode: windows that start on a 2MB file offset are mapped at
+    // 2MB-aligned addresses and advised MADV_HUGEPAGE, so the 2MB-aligned
+    // segments inside them can be backed by huge pages where the filesystem
+    // supports large folios (tmpfs, and XFS/ext4 on recent kernels). Applies
+    // to windows mapped after the call.
+    void set_huge_pages(bool on);
+    bool huge_pages() const;
     
     // Pin ensures segment [off, off+len) is mapped, returns pointer
     Pin pin(const std::string& path, size_t off, size_t len, bool writable);
@@ -198,9 +208,18 @@ public:
         size_t evictions_count = 0;
         size_t evictions_bytes = 0;
         double memory_utilization = 0.0;  // mapped / budget (0 if unlimited)
+        size_t huge_extents = 0;          // extents advised MADV_HUGEPAGE
+        size_t huge_bytes = 0;
     };
     MappingStats getStats() const;
 
+    // Sampled reuse-distance histogram over extent pins (one key per
+    // file window). Estimates how many pins would find their window already
+    // mapped under a different memory budget.
+    MissRatioCurve& extent_curve() { return extent_mrc_; }
+    const MissRatioCurve& extent_curve() const { return extent_mrc_; }
+    size_t window_size() const { return window_size_; }
+
 private:
     FileHandleRegistry& fhr_;
     const size_t window_size_;
@@ -211,12 +230,16 @@ private:
     size_t total_memory_mapped_ = 0;     // Current total bytes mapped
     float eviction_headroom_ = 0.1f;     // 10% hysteresis
     size_t evictions_bytes_ = 0;         // Total bytes evicted
+    bool huge_pages_ = false;            // Map new windows for huge pages
 
     mutable std::mutex mu_;
     std::unordered_map<std::string, std::unique_ptr<FileMapping>> by_file_;
     size_t total_extents_ = 0;
     size_t total_pins_ = 0;
     size_t total_evictions_ = 0;
+
+    // Miss ratio curve for extent reuse
+    MissRatioCurve extent_mrc_;
     
     // Ensure an extent exists for the range, return it
     MappingExtent* ensure_extent(FileMapping& fm, bool writable, size_t off, size_t len);
@@ -271,6 +271,12 @@ void MemoryCoordinator::rebalance_if_needed() {
         return;
     }
 
+    // Preferred: follow the miss ratio curves once they have enough samples
+    if (rebalance_by_miss_ratio()) {
+        return;
+    }
+
+    // Fallback: shift toward whichever tier is under pressure
     // If neither is under pressure, no need to rebalance
     if (!cache_under_pressure && !mmap_under_pressure) {
         return;
@@ -290,6 +296,49 @@ void MemoryCoordinator::rebalance_if_needed() {
         new_mmap_ratio = mmap_ratio_ + REBALANCE_STEP;
     }
 
+    shift_ratios(new_cache_ratio, new_mmap_ratio);
+}
+
+bool MemoryCoordinator::rebalance_by_miss_ratio() {
+    auto& cache_curve = IndexDetails<IRecord>::getCache().missRatioCurve();
+    auto& mmap_curve = MappingManager::global().extent_curve();
+
+    // Need fresh evidence since the last decision; the curves are aged below
+    uint64_t reuses = cache_curve.sampledReuses() + mmap_curve.sampledReuses();
+    uint64_t fresh = reuses > prev_mrc_reuses_ ? reuses - prev_mrc_reuses_ : reuses;
+    if (fresh < MIN_MRC_REUSES) {
+        current_metrics_.mrc_driven = false;
+        return false;
+    }
+    prev_mrc_reuses_ = reuses;
+
+    const double step = static_cast<double>(total_budget_) * REBALANCE_STEP;
+    const double cache_budget = static_cast<double>(total_budget_) * cache_ratio_;
+    const double mmap_budget = static_cast<double>(total_budget_) * mmap_ratio_;
+
+    // Hits per byte gained by growing each tier one step, and lost by shrinking it
+    double cache_gain = cache_curve.marginalHitsPerByte(cache_budget, cache_budget + step);
+    double cache_loss = cache_curve.marginalHitsPerByte(cache_budget - step, cache_budget);
+    double mmap_gain = mmap_curve.marginalHitsPerByte(mmap_budget, mmap_budget + step);
+    double mmap_loss = mmap_curve.marginalHitsPerByte(mmap_budget - step, mmap_budget);
+
+    current_metrics_.cache_hits_per_byte = cache_gain;
+    current_metrics_.mmap_hits_per_byte = mmap_gain;
+    current_metrics_.mrc_driven = true;
+
+    // Age both curves so the next decision weighs recent references more
+    cache_curve.decay();
+    mmap_curve.decay();
+
+    if (cache_gain > 0.0 && cache_gain > mmap_loss * (1.0 + MRC_HYSTERESIS)) {
+        shift_ratios(cache_ratio_ + REBALANCE_STEP, mmap_ratio_ - REBALANCE_STEP);
+    } else if (mmap_gain > 0.0 && mmap_gain > cache_loss * (1.0 + MRC_HYSTERESIS)) {
+        shift_ratios(cache_ratio_ - REBALANCE_STEP, mmap_ratio_ + REBALANCE_STEP);
+    }
+    return true;
+}
+
+void MemoryCoordinator::shift_ratios(float new_cache_ratio, float new_mmap_ratio) {
     // Clamp to min/max bounds
     new_cache_ratio = std::clamp(new_cache_ratio, MIN_RATIO, MAX_RATIO);
     new_mmap_ratio = std::clamp(new_mmap_ratio, MIN_RATIO, MAX_RATIO);
@@ -391,6 +440,21 @@ size_t MemoryCoordinator::get_rebalance_count() const {
     return rebalance_count_.load(std::memory_order_relaxed);
 }
 
+bool MemoryCoordinator::has_headroom() const {
+    size_t budget;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget = total_budget_;
+    }
+    if (budget == 0) {
+        return true;
+    }
+
+    const size_t used = IndexDetails<IRecord>::getCache().getStats().currentMemory +
+                        MappingManager::global().getStats().total_memory_mapped;
+    return static_cast<double>(used) < static_cast<double>(budget) * PRESSURE_THRESHOLD;
+}
+
 // ============================================================================
 // Testing Support
 // ============================================================================
@@ -406,6 +470,7 @@ void MemoryCoordinator::reset() {
     current_metrics_ = MemoryMetrics{};
     prev_cache_evictions_ = 0;
     prev_mmap_evictions_ = 0;
+    prev_mrc_reuses_ = 0;
     last_tick_ = std::chrono::steady_clock::now();
     last_rebalance_ = std::chrono::steady_clock::now();
     rebalance_count_.store(0, std::memory_order_relaxed);
@@ -13,7 +13,10 @@
  *
  * Solution:
  * A unified coordinator that owns the total memory budget and splits it
- * between the two systems based on observed pressure metrics.
+ * between the two systems. Both tiers keep a sampled miss ratio curve
+ * (see util/miss_ratio_curve.h); once enough reuses have been sampled,
+ * each rebalance moves a step of memory to the tier that would gain the
+ * most hits per byte. Until then, observed pressure metrics drive the split.
  */
 
 #pragma once
@@ -21,6 +24,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <mutex>
 
@@ -54,6 +58,11 @@ struct MemoryMetrics {
     double mmap_utilization = 0.0;    // used / budget (0-1)
     double cache_pressure = 0.0;      // evictions / tick (normalized)
     double mmap_pressure = 0.0;       // evictions / tick (normalized)
+
+    // Miss-ratio-curve estimates (calculated in rebalance_if_needed())
+    double cache_hits_per_byte = 0.0;  // Estimated hits gained per byte added to cache
+    double mmap_hits_per_byte = 0.0;   // Estimated hits gained per byte added to mmap
+    bool mrc_driven = false;           // Last rebalance decision came from the curves
 };
 
 /**
@@ -180,6 +189,15 @@ public:
      */
     size_t get_rebalance_count() const;
 
+    /**
+     * True when there is room to bring more data in: no budget is set, or
+     * current cache plus mmap usage is below the pressure threshold of the
+     * budget. Reads usage fresh and leaves the tick metrics alone; used by
+     * IndexRegistry to stop background preloading before it causes the
+     * pressure that would unload indexes again.
+     */
+    bool has_headroom() const;
+
     // ========== Testing Support ==========
 
     /**
@@ -195,6 +213,8 @@ private:
     void collect_metrics();
     void detect_pressure();
     void rebalance_if_needed();
+    bool rebalance_by_miss_ratio();
+    void shift_ratios(float new_cache_ratio, float new_mmap_ratio);
     void apply_budgets();
     void apply_workload_preset(WorkloadHint hint);
 
@@ -211,6 +231,7 @@ private:
     // Previous tick metrics for delta calculation
     size_t prev_cache_evictions_ = 0;
     size_t prev_mmap_evictions_ = 0;
+    uint64_t prev_mrc_reuses_ = 0;
 
     // Timing
     std::chrono::steady_clock::time_point last_tick_;
@@ -228,6 +249,8 @@ private:
     static constexpr float REBALANCE_STEP = 0.05f;       // 5% shift per tick
     static constexpr float MIN_RATIO = 0.20f;            // 20% minimum
     static constexpr float MAX_RATIO = 0.80f;            // 80% maximum
+    static constexpr uint64_t MIN_MRC_REUSES = 64;       // Sampled reuses needed per decision
+    static constexpr double MRC_HYSTERESIS = 0.10;       // Gain must beat loss by 10%
 };
 
 } // namespace persist
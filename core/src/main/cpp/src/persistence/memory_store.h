@@ -27,6 +27,7 @@ namespace xtree {
 
         class MemoryStore final : public StoreInterface {
         public:
+            using StoreInterface::allocate_node;   // Hinted form: placement is meaningless here
             AllocResult allocate_node(size_t min_len, NodeKind kind) override;
             void publish_node(NodeID id, const void* data, size_t len) override;
             NodeBytes read_node(NodeID id) const override;
@@ -32,7 +32,9 @@ namespace xtree {
         static_assert(alignof(MVCCContext::Pin) == 64, "Pin must be cache-line aligned");
 
         MVCCContext::MVCCContext() {
-            // Pre-allocate pins to avoid allocation during registration
+            // Pre-allocate pins to avoid allocation during registration.
+            // The buffer never moves, which lets min_active_epoch() scan
+            // without the registration lock.
             pins_.reserve(MAX_THREADS);
         }
 
@@ -60,6 +62,7 @@ namespace xtree {
             
             pins_.push_back(std::make_unique<Pin>());
             Pin* new_pin = pins_.back().get();
+            published_pins_.store(pins_.size(), std::memory_order_release);
             
             // Cache in thread-local storage
             t_pin = new_pin;
@@ -76,16 +79,45 @@ namespace xtree {
             }
         }
 
-        uint64_t MVCCContext::min_active_epoch() const {
-            // Note: We lock here because this is called infrequently by the reclaimer,
-            // not on the read hot path. We could make this lock-free with more complexity.
+        MVCCContext::Pin* MVCCContext::acquire_pin() {
             std::lock_guard<std::mutex> lock(registration_mutex_);
-            
+            if (!free_pins_.empty()) {
+                Pin* p = free_pins_.back();
+                free_pins_.pop_back();
+                return p;
+            }
+            if (pins_.size() >= MAX_THREADS) {
+                return nullptr;
+            }
+            pins_.push_back(std::make_unique<Pin>());
+            published_pins_.store(pins_.size(), std::memory_order_release);
+            return pins_.back().get();
+        }
+
+        void MVCCContext::release_pin(Pin* p) {
+            if (!p) return;
+            p->epoch.store(UINT64_MAX, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(registration_mutex_);
+            free_pins_.push_back(p);
+        }
+
+        uint64_t MVCCContext::min_active_epoch() const {
+            // Read the global epoch before scanning. A reader whose pin the
+            // scan misses stored it after our load of its slot; pin_current()
+            // then re-reads the global epoch and pins at least this value.
+            // Both sides need seq_cst for that ordering to hold.
+            const uint64_t global = global_epoch_.load(std::memory_order_seq_cst);
+
+            // Lock-free: pins are only appended, into a buffer reserved up front,
+            // and published through published_pins_ after construction
+            const size_t n = published_pins_.load(std::memory_order_acquire);
+            const std::unique_ptr<Pin>* pins = pins_.data();
+
             uint64_t min_epoch = UINT64_MAX;
             
             // Scan all pins to find minimum active epoch
-            for (const auto& pin : pins_) {
-                uint64_t pin_epoch = pin->epoch.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t pin_epoch = pins[i]->epoch.load(std::memory_order_seq_cst);
                 if (pin_epoch != UINT64_MAX && pin_epoch < min_epoch) {
                     min_epoch = pin_epoch;
                 }
@@ -93,7 +125,7 @@ namespace xtree {
             
             // If no pins are active, return current global epoch
             if (min_epoch == UINT64_MAX) {
-                min_epoch = global_epoch_.load(std::memory_order_acquire);
+                min_epoch = global;
             }
             
             return min_epoch;
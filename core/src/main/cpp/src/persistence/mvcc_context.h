@@ -19,6 +19,7 @@
 #pragma once
 #include <atomic>
 #include <vector>
+#include <algorithm>
 #include <mutex>
 #include <memory>
 #include <cstdint>
@@ -39,9 +40,10 @@ namespace xtree {
             // RAII guard for automatic pin/unpin
             class Guard {
             public:
+                // epoch must already be protected; see pin_epoch()
                 Guard(Pin* pin, uint64_t epoch) : pin_(pin) {
                     if (pin_) {
-                        pin_->epoch.store(epoch, std::memory_order_release);
+                        pin_->epoch.store(epoch, std::memory_order_seq_cst);
                     }
                 }
                 
@@ -83,17 +85,41 @@ namespace xtree {
             
             // Thread deregistration - useful for thread pools and tests
             void deregister_thread();
+
+            // Pins not bound to a thread, for holders that outlive a call
+            // (read snapshots). Released slots are reused; nullptr when full.
+            Pin* acquire_pin();
+            void release_pin(Pin* p);
             
-            // Lock-free pin/unpin via direct atomic operations
+            // Pin at the current global epoch and return it. The pin is
+            // stored seq_cst and the global epoch re-read until it did not
+            // move: a min_active_epoch() scan that missed the pin then read
+            // the global epoch no later than the value pinned, so it cannot
+            // have released anything this pin still needs.
+            uint64_t pin_current(Pin* p) {
+                uint64_t e = global_epoch_.load(std::memory_order_seq_cst);
+                if (!p) return e;
+                for (;;) {
+                    p->epoch.store(e, std::memory_order_seq_cst);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    const uint64_t now = global_epoch_.load(std::memory_order_seq_cst);
+                    if (now == e) return e;
+                    e = now;
+                }
+            }
+
+            // Lock-free pin/unpin via direct atomic operations. e must already
+            // be protected (held by another pin, or returned by pin_current);
+            // an epoch read earlier may have been reclaimed past in between.
             static void pin_epoch(Pin* p, uint64_t e) {
-                if (p) p->epoch.store(e, std::memory_order_release);
+                if (p) p->epoch.store(e, std::memory_order_seq_cst);
             }
             static void unpin(Pin* p) {
                 if (p) p->epoch.store(UINT64_MAX, std::memory_order_release);
             }
             
             // Epoch queries
-            uint64_t min_active_epoch() const; // scans pins (called by reclaimer, not hot path)
+            uint64_t min_active_epoch() const; // lock-free scan of published pins (reclaimer path)
             uint64_t get_global_epoch() const { return global_epoch_.load(std::memory_order_acquire); }
             uint64_t advance_epoch() { return global_epoch_.fetch_add(1, std::memory_order_acq_rel) + 1; }
             
@@ -108,10 +134,23 @@ namespace xtree {
                 // Ensure all readers see the new epoch
                 std::atomic_thread_fence(std::memory_order_release);
             }
+
+            // Raise the epoch to target while readers are running (replica
+            // catch-up). Never goes backwards; returns the resulting epoch.
+            uint64_t advance_epoch_to(uint64_t target) {
+                uint64_t cur = global_epoch_.load(std::memory_order_acquire);
+                while (cur < target &&
+                       !global_epoch_.compare_exchange_weak(cur, target, std::memory_order_acq_rel,
+                                                            std::memory_order_acquire)) {
+                }
+                return std::max(cur, target);
+            }
             
         private:
             mutable std::mutex registration_mutex_;  // Only for thread registration
             std::vector<std::unique_ptr<Pin>> pins_;  // Use unique_ptr for stable addresses
+            std::vector<Pin*> free_pins_;             // released acquire_pin() slots
+            std::atomic<size_t> published_pins_{0};   // pins_[0, n) visible to scanners
             std::atomic<uint64_t> global_epoch_{0};
             
             // Increased for large systems - can be made configurable via config.h
@@ -22,6 +22,7 @@
 #include "../util/log.h"
 #include <cassert>
 #include <algorithm>
+#include <new>
 #include <iostream>
 
 /**
@@ -87,6 +88,33 @@ namespace xtree {
             }
         }
         
+        OTEntry* ObjectTable::new_slab() {
+            if (!numa_) {
+                return new OTEntry[entries_per_slab_];
+            }
+            void* mem = numa_->allocate_on_node(entries_per_slab_ * sizeof(OTEntry), numa_node_);
+            if (!mem) {
+                throw std::bad_alloc();
+            }
+            OTEntry* slab = static_cast<OTEntry*>(mem);
+            for (size_t i = 0; i < entries_per_slab_; ++i) {
+                new (&slab[i]) OTEntry();
+            }
+            return slab;
+        }
+
+        void ObjectTable::free_slab(OTEntry* slab) {
+            if (!slab) return;
+            if (numa_) {
+                for (size_t i = 0; i < entries_per_slab_; ++i) {
+                    slab[i].~OTEntry();
+                }
+                NumaTopology::free_on_node(slab, entries_per_slab_ * sizeof(OTEntry));
+                return;
+            }
+            delete[] slab;
+        }
+
         bool ObjectTable::add_slab_locked() {
             // Must be called with mu_ held
             const uint32_t current_count = slab_count_.load(std::memory_order_relaxed);
@@ -108,7 +136,7 @@ namespace xtree {
             }
             
             // Allocate the slab
-            OTEntry* new_slab = new OTEntry[entries_per_slab_];
+            OTEntry* new_slab = this->new_slab();
             
             // Initialize all entries to safe defaults
             for (size_t i = 0; i < entries_per_slab_; ++i) {
@@ -311,11 +339,287 @@ namespace xtree {
             throw std::runtime_error("ObjectTable: no free handle after slab add");
         }
 
-        NodeID ObjectTable::allocate(NodeKind kind, uint8_t class_id, const OTAddr& addr, uint64_t /*birth_epoch_unused*/) {
+        // ========== Per-thread handle caches ==========
+
+        /**
+         * Free handles cached by one thread for one table.
+         *
+         * Only the owning thread touches `handles`, so allocate() pops without
+         * a lock. Counters are single-writer atomics summed by get_stats().
+         */
+        struct ObjectTable::HandleCache {
+            std::mutex owner_mu;                       // Thread exit vs table teardown
+            std::atomic<ObjectTable*> owner{nullptr};
+            std::atomic<bool> exited{false};
+            uint64_t generation = 0;                   // Owner's cache_generation_ at fill
+            uint64_t reclaim_seq = 0;                  // Owner's reclaim_seq_ last adopted
+            std::vector<uint64_t> handles;             // LIFO, lowest handle on top after refill
+            std::atomic<size_t> cached{0};             // Mirrors handles.size() for stats
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> retires{0};
+
+            static void bump(std::atomic<uint64_t>& c) {
+                c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            void sync_size() {
+                cached.store(handles.size(), std::memory_order_relaxed);
+            }
+        };
+
+        // A thread's caches, one per table it has used. Flushed on thread exit.
+        struct ObjectTable::HandleCacheTable {
+            struct Slot {
+                uint64_t table_id;
+                std::shared_ptr<HandleCache> cache;
+            };
+            std::vector<Slot> slots;
+            uint64_t last_id = 0;
+            HandleCache* last = nullptr;
+
+            ~HandleCacheTable() {
+                for (auto& slot : slots) {
+                    ObjectTable::release_handle_cache(*slot.cache);
+                }
+            }
+        };
+
+        uint64_t ObjectTable::next_instance_id() {
+            static std::atomic<uint64_t> next{1};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ObjectTable::HandleCache* ObjectTable::handle_cache(bool create) {
+            static thread_local HandleCacheTable table;
+            if (table.last && table.last_id == instance_id_) {
+                return table.last;
+            }
+            for (auto& slot : table.slots) {
+                if (slot.table_id == instance_id_) {
+                    table.last_id = instance_id_;
+                    table.last = slot.cache.get();
+                    return table.last;
+                }
+            }
+            if (!create) return nullptr;
+
+            // Drop caches of tables that no longer exist
+            table.slots.erase(std::remove_if(table.slots.begin(), table.slots.end(),
+                [](const HandleCacheTable::Slot& slot) {
+                    return slot.cache->owner.load(std::memory_order_acquire) == nullptr;
+                }), table.slots.end());
+
+            auto hc = std::make_shared<HandleCache>();
+            hc->owner.store(this, std::memory_order_release);
+            hc->generation = cache_generation_.load(std::memory_order_acquire);
+            hc->reclaim_seq = reclaim_seq_.load(std::memory_order_acquire);
+            hc->handles.reserve(object_table::kHandleCacheSize);
+            {
+                std::lock_guard<std::mutex> lk(caches_mu_);
+                // Fold in counters of exited threads so caches_ stays bounded
+                auto dead = std::remove_if(caches_.begin(), caches_.end(),
+                    [this](const std::shared_ptr<HandleCache>& c) {
+                        if (!c->exited.load(std::memory_order_acquire)) return false;
+                        exited_allocations_ += c->allocations.load(std::memory_order_relaxed);
+                        exited_retires_ += c->retires.load(std::memory_order_relaxed);
+                        return true;
+                    });
+                caches_.erase(dead, caches_.end());
+                caches_.push_back(hc);
+            }
+            table.slots.push_back({instance_id_, hc});
+            table.last_id = instance_id_;
+            table.last = hc.get();
+            return table.last;
+        }
+
+        void ObjectTable::refill_handle_cache(HandleCache& hc) {
+            std::lock_guard<std::mutex> lk(mu_);
+            hc.reclaim_seq = reclaim_seq_.load(std::memory_order_relaxed);
+            // First handle may add a slab (or throw when the table is full);
+            // the rest of the batch only takes what is already free
+            hc.handles.push_back(acquire_handle_locked());
+            while (hc.handles.size() < object_table::kHandleCacheRefill && free_count_ > 0) {
+                hc.handles.push_back(acquire_handle_locked());
+            }
+            // Hand out the lowest handle first
+            std::reverse(hc.handles.begin(), hc.handles.end());
+            hc.sync_size();
+        }
+
+        void ObjectTable::adopt_reclaimed_handles(HandleCache& hc) {
             std::lock_guard<std::mutex> lk(mu_);
+            hc.reclaim_seq = reclaim_seq_.load(std::memory_order_relaxed);
+
+            // The freelist top holds the most recently reclaimed handles
+            std::vector<uint64_t> taken;
+            while (taken.size() < object_table::kHandleCacheRefill && free_count_ > 0) {
+                taken.push_back(acquire_handle_locked());
+            }
+            if (taken.empty()) return;
 
-            // Pick a FREE handle and mark it RESERVED (bitmap clear happens inside)
-            uint64_t h = acquire_handle_locked();
+            // Make room by returning the oldest cached handles
+            const size_t room = object_table::kHandleCacheSize - taken.size();
+            if (hc.handles.size() > room) {
+                const size_t excess = hc.handles.size() - room;
+                return_handles_locked(std::vector<uint64_t>(hc.handles.begin(),
+                                                            hc.handles.begin() + excess),
+                                      /*stale=*/false);
+                hc.handles.erase(hc.handles.begin(), hc.handles.begin() + excess);
+            }
+            // Most recently reclaimed ends up on top
+            hc.handles.insert(hc.handles.end(), taken.rbegin(), taken.rend());
+            hc.sync_size();
+        }
+
+        void ObjectTable::return_handles_locked(const std::vector<uint64_t>& handles, bool stale) {
+            // Must be called with mu_ held
+            for (uint64_t h : handles) {
+                // Recovery may have restored the handle, or already marked it free
+                if (stale && (!slot(h).is_free() || bm_test(h))) continue;
+                bm_set(h);
+#ifndef NDEBUG
+                auto inserted = free_set_dbg_.insert(h).second;
+                assert(inserted && "Cached handle already on the free list!");
+#endif
+                free_handles_.push_back(h);
+            }
+        }
+
+        void ObjectTable::flush_handle_cache() {
+            if (HandleCache* hc = handle_cache(/*create=*/false)) {
+                flush_handle_cache(*hc);
+            }
+        }
+
+        void ObjectTable::flush_handle_cache(HandleCache& hc) {
+            const uint64_t gen = cache_generation_.load(std::memory_order_acquire);
+            if (!hc.handles.empty()) {
+                std::lock_guard<std::mutex> lk(mu_);
+                return_handles_locked(hc.handles, /*stale=*/hc.generation != gen);
+            }
+            hc.generation = gen;
+            hc.handles.clear();
+            hc.sync_size();
+        }
+
+        void ObjectTable::release_handle_cache(HandleCache& hc) {
+            std::lock_guard<std::mutex> lk(hc.owner_mu);
+            if (ObjectTable* owner = hc.owner.load(std::memory_order_acquire)) {
+                owner->flush_handle_cache(hc);
+            }
+            hc.exited.store(true, std::memory_order_release);
+        }
+
+        void ObjectTable::detach_handle_caches() {
+            std::lock_guard<std::mutex> lk(caches_mu_);
+            for (auto& hc : caches_) {
+                std::lock_guard<std::mutex> owner_lk(hc->owner_mu);
+                hc->owner.store(nullptr, std::memory_order_release);
+            }
+            caches_.clear();
+        }
+
+        ObjectTable::Stats ObjectTable::get_stats() const {
+            uint64_t allocations, retires;
+            size_t cached = 0;
+            {
+                std::lock_guard<std::mutex> lk(caches_mu_);
+                allocations = exited_allocations_;
+                retires = exited_retires_;
+                for (const auto& hc : caches_) {
+                    allocations += hc->allocations.load(std::memory_order_relaxed);
+                    retires += hc->retires.load(std::memory_order_relaxed);
+                    cached += hc->cached.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::lock_guard<std::mutex> lk(mu_);
+            Stats s = stats_;
+            s.total_allocations += allocations;
+            s.total_retires += retires;
+            s.free_handles_count = free_count_ + cached;  // Bitmap plus thread caches
+            // Retired stack entries not yet drained by reclaim
+            const uint64_t pending = retires > drained_retires_ ? retires - drained_retires_ : 0;
+            s.retired_handles_count = retired_count_ + pending;
+            s.max_handle_allocated = max_handle_;
+            return s;
+        }
+
+        size_t ObjectTable::retired_backlog() const {
+            uint64_t retires;
+            {
+                std::lock_guard<std::mutex> lk(caches_mu_);
+                retires = exited_retires_;
+                for (const auto& hc : caches_) {
+                    retires += hc->retires.load(std::memory_order_relaxed);
+                }
+            }
+            std::lock_guard<std::mutex> lk(mu_);
+            const uint64_t pending = retires > drained_retires_ ? retires - drained_retires_ : 0;
+            return retired_count_ + relocated_count_ + pending;
+        }
+
+        void ObjectTable::relocate(NodeID id, const OTAddr& to, uint64_t epoch) {
+            std::lock_guard<std::mutex> lk(mu_);
+            auto& e = slot_safe(id.handle_index());
+            if (e.tag.load(std::memory_order_relaxed) != id.tag()) {
+                assert(false && "Tag mismatch in relocate");
+                return;
+            }
+            const OTAddr from = e.addr;
+            e.addr = to;
+            if (from.length > 0) {
+                relocated_by_epoch_[epoch].push_back(SegmentAllocator::Allocation{
+                    from.file_id, from.segment_id, from.offset, from.length, e.class_id, {}});
+                ++relocated_count_;
+            }
+        }
+
+        // ========== Retired stack ==========
+
+        void ObjectTable::push_retired(uint64_t h, OTEntry& e) {
+            uint64_t head = retired_head_.load(std::memory_order_relaxed);
+            do {
+                e.retired_next = head;
+            } while (!retired_head_.compare_exchange_weak(head, h,
+                        std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void ObjectTable::drain_retired_locked() {
+            // Must be called with mu_ held
+            uint64_t h = retired_head_.exchange(0, std::memory_order_acquire);
+            std::vector<uint64_t>* bucket = nullptr;
+            uint64_t bucket_epoch = 0;
+            while (h != 0) {
+                // Bucket by retire epoch; consecutive retires mostly share one
+                const uint64_t r = slot(h).retire_epoch.load(std::memory_order_relaxed);
+                if (!bucket || r != bucket_epoch) {
+                    bucket = &retired_by_epoch_[r];
+                    bucket_epoch = r;
+                }
+                bucket->push_back(h);
+                ++retired_count_;
+                ++drained_retires_;
+                h = slot(h).retired_next;
+            }
+        }
+
+        NodeID ObjectTable::allocate(NodeKind kind, uint8_t class_id, const OTAddr& addr, uint64_t /*birth_epoch_unused*/) {
+            HandleCache& hc = *handle_cache();
+            if (hc.generation != cache_generation_.load(std::memory_order_acquire)) {
+                flush_handle_cache(hc);  // Recovery rebuilt the free state - drop
+            }
+
+            // Pick a FREE handle (already cleared in the bitmap) and mark it RESERVED.
+            // The entry is exclusively ours from here on, so no lock is needed.
+            if (hc.handles.empty()) {
+                refill_handle_cache(hc);
+            } else if (hc.reclaim_seq != reclaim_seq_.load(std::memory_order_acquire)) {
+                adopt_reclaimed_handles(hc);  // Reuse reclaimed handles before cached ones
+            }
+            const uint64_t h = hc.handles.back();
+            hc.handles.pop_back();
+            hc.sync_size();
 
             OTEntry& e = slot_safe(h);
 #ifndef NDEBUG
@@ -343,7 +647,7 @@ namespace xtree {
             e.tag.store(new_tag, std::memory_order_relaxed);
 
             // Update statistics
-            stats_.total_allocations++;
+            HandleCache::bump(hc.allocations);
 
             // Return the NodeID with handle index and NEW tag
             NodeID result = NodeID::from_parts(h, new_tag);
@@ -417,15 +721,16 @@ namespace xtree {
                       << " -> FREE" << std::endl;
 #endif
 
-            // Return handle to the freelist (with lock)
-            {
+            // Return handle to this thread's cache (still used in the bitmap),
+            // or to the table's freelist if the cache is full or stale
+            HandleCache* hc = handle_cache(/*create=*/false);
+            if (hc && hc->generation == cache_generation_.load(std::memory_order_acquire) &&
+                hc->handles.size() < object_table::kHandleCacheSize) {
+                hc->handles.push_back(h);
+                hc->sync_size();
+            } else {
                 std::lock_guard<std::mutex> lk(mu_);
-#ifndef NDEBUG
-                auto inserted = free_set_dbg_.insert(h).second;
-                assert(inserted && "Handle pushed to free list twice during abort!");
-#endif
-                free_handles_.push_back(h);
-                free_count_++;
+                return_handles_locked({h}, /*stale=*/false);
             }
 
             return true;
@@ -494,12 +799,9 @@ namespace xtree {
                 // Use release ordering to align with the CAS above
                 e.dbg_state.store(OTEntry::DBG_RETIRED, std::memory_order_release);
 #endif
-                // Successfully retired - add to retired list for efficient reclamation
-                {
-                    std::lock_guard<std::mutex> lk(mu_);
-                    retired_handles_.push_back(h);
-                    stats_.total_retires++;
-                }
+                // Successfully retired - add to retired stack for efficient reclamation
+                push_retired(h, e);
+                HandleCache::bump(handle_cache()->retires);
             } else {
 #ifndef NDEBUG
                 // CAS failed - entry was already retired or not yet committed
@@ -522,7 +824,7 @@ namespace xtree {
         }
         
         NodeID ObjectTable::mark_live_reserve(NodeID proposed, uint64_t birth_epoch) {
-            std::lock_guard<std::mutex> lk(mu_);
+            // Read-only: the entry is owned by the caller until it is committed
             const uint64_t h = proposed.handle_index();
             auto& e = slot_safe(h);
 
@@ -623,29 +925,41 @@ namespace xtree {
             
             std::vector<ToFree> to_free;
             std::vector<uint64_t> reclaimed_handles;
-            std::vector<uint64_t> still_retired;  // Build this but don't assign until Phase 3
+            std::vector<uint64_t> candidates;     // Handles from buckets older than safe_epoch
+            std::vector<uint64_t> still_retired;  // Rebucketed in Phase 3
+            std::vector<SegmentAllocator::Allocation> relocated_blocks;
             size_t freed = 0;
             
-            // Reserve space to avoid reallocations during reclaim
-            // Do this before acquiring the lock to minimize time under lock
-            size_t retired_count = 0;
-            {
-                std::lock_guard<std::mutex> lk(mu_);
-                retired_count = retired_handles_.size();
-            }
-            to_free.reserve(retired_count);
-            reclaimed_handles.reserve(retired_count);
-            still_retired.reserve(retired_count);
-            
             // Phase 1: Under lock, identify what to free but DO NOT clear entries yet
             // This ensures crash-safety: if we crash before freeing, entries remain
             // in retired state and can be reclaimed in a future pass
             {
                 std::lock_guard<std::mutex> lk(mu_);
+                drain_retired_locked();
                 
-                // Process only retired handles - O(retired) not O(capacity)
+                // Detach only the buckets older than safe_epoch - O(freed), newer
+                // buckets are never walked. Detached handles are invisible to a
+                // concurrent reclaim pass.
+                auto last = retired_by_epoch_.lower_bound(safe_epoch);
+                for (auto it = retired_by_epoch_.begin(); it != last; ++it) {
+                    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+                }
+                retired_by_epoch_.erase(retired_by_epoch_.begin(), last);
+                retired_count_ -= candidates.size();
+
+                // Blocks superseded by relocate() follow the same rule
+                auto last_block = relocated_by_epoch_.lower_bound(safe_epoch);
+                for (auto it = relocated_by_epoch_.begin(); it != last_block; ++it) {
+                    for (auto& block : it->second) {
+                        relocated_blocks.push_back(std::move(block));
+                    }
+                }
+                relocated_by_epoch_.erase(relocated_by_epoch_.begin(), last_block);
+                relocated_count_ -= relocated_blocks.size();
+                to_free.reserve(candidates.size());
+                reclaimed_handles.reserve(candidates.size());
                 
-                for (uint64_t h : retired_handles_) {
+                for (uint64_t h : candidates) {
                     auto& e = slot_safe(h);
                     uint64_t r = e.retire_epoch.load(std::memory_order_acquire);
                     
@@ -691,13 +1005,10 @@ namespace xtree {
                         
                         freed++;
                     } else {
-                        // Still retired but not safe to reclaim yet
+                        // Retired again at a newer epoch since it was bucketed
                         still_retired.push_back(h);
                     }
                 }
-                
-                // IMPORTANT: Do NOT assign retired_handles_ here
-                // We only finalize it in Phase 3 after allocator frees complete
             }
             // Lock released here
             
@@ -706,7 +1017,19 @@ namespace xtree {
                 segment_allocator_->free(tf.alloc);
                 reclaimed_handles.push_back(tf.handle);
             }
+            if (segment_allocator_) {
+                for (auto& block : relocated_blocks) {
+                    segment_allocator_->free(block);
+                }
+            }
             
+            // Reclaimed handles go to this thread's cache first so they are
+            // allocated next (LIFO), as with the table freelist below
+            HandleCache* hc = handle_cache(/*create=*/false);
+            if (hc && hc->generation != cache_generation_.load(std::memory_order_acquire)) {
+                hc = nullptr;
+            }
+
             // Phase 3: Finalize - clear entries, update retired list, return handles to free list
             {
                 std::lock_guard<std::mutex> lk(mu_);
@@ -735,8 +1058,11 @@ namespace xtree {
                     e.kind = NodeKind::Invalid;  // Free OT slot, never visible to readers
                 }
                 
-                // NOW it's safe to update retired_handles_ after allocator frees are done
-                retired_handles_ = std::move(still_retired);
+                // Return handles that are not yet safe to their current bucket
+                for (uint64_t h : still_retired) {
+                    retired_by_epoch_[slot(h).retire_epoch.load(std::memory_order_relaxed)].push_back(h);
+                    ++retired_count_;
+                }
                 
                 // Ensure bitmap capacity and mark handles as free
                 size_t max_handle_idx = 0;
@@ -751,23 +1077,37 @@ namespace xtree {
                 }
                 
                 // Mark handles as free in bitmap and prime cache for immediate reuse
+                bool shared = false;
                 for (uint64_t h : reclaimed_handles) {
                     if (h == 0) continue;                 // Never queue handle 0
+                    if (hc && hc->handles.size() < object_table::kHandleCacheSize) {
+                        hc->handles.push_back(h);         // Stays used in the bitmap
+                        continue;
+                    }
                     if (!bm_test(h)) bm_set(h);           // 1 = free; bumps free_count_ only if not already free
 #ifndef NDEBUG
                     auto [it, inserted] = free_set_dbg_.insert(h);
                     assert(inserted && "Handle pushed to free list twice during reclaim!");
 #endif
                     free_handles_.push_back(h);           // LIFO: reclaimed handles allocated next
+                    shared = true;
+                }
+                if (shared) {
+                    // Other threads' caches pick these up on their next allocate
+                    reclaim_seq_.fetch_add(1, std::memory_order_release);
                 }
                 
                 stats_.last_reclaim_count = freed;
             }
+            if (hc) hc->sync_size();
             
             return freed;
         }
         
         void ObjectTable::begin_recovery() {
+            // Thread caches may hold handles the scan below marks free again
+            cache_generation_.fetch_add(1, std::memory_order_acq_rel);
+
             std::lock_guard<std::mutex> lk(mu_);
             recovery_mode_ = true;
             
@@ -800,7 +1140,11 @@ namespace xtree {
         void ObjectTable::end_recovery() {
             std::lock_guard<std::mutex> lk(mu_);
             free_handles_.clear();
-            retired_handles_.clear();  // Also rebuild retired list
+            drain_retired_locked();
+            retired_by_epoch_.clear();  // Also rebuild retired list
+            retired_count_ = 0;
+            relocated_by_epoch_.clear();
+            relocated_count_ = 0;
 #ifndef NDEBUG
             free_set_dbg_.clear();  // Clear debug set before rebuilding
 #endif
@@ -868,9 +1212,8 @@ namespace xtree {
             // Conservatively reset max_handle_ to top of current slabs
             max_handle_ = capacity ? (capacity - 1) : 0;
             
-            // Also rebuild retired_handles_ for entries that ended up retired
+            // Also rebuild the retired buckets for entries that ended up retired
             // This ensures the first reclaim pass doesn't miss anything
-            retired_handles_.reserve(capacity / 4);  // Heuristic: most won't be retired
             
             for (uint32_t slab_idx = 0; slab_idx < published; ++slab_idx) {
                 OTEntry* slab = get_slab_ptr(slab_idx);
@@ -882,7 +1225,8 @@ namespace xtree {
                     
                     const OTEntry& e = slab[slot];
                     if (e.is_retired()) {
-                        retired_handles_.push_back(handle);
+                        retired_by_epoch_[e.retire_epoch.load(std::memory_order_relaxed)].push_back(handle);
+                        ++retired_count_;
                     }
                 }
             }
@@ -893,6 +1237,9 @@ namespace xtree {
         }
         
         void ObjectTable::restore_handle(uint64_t handle_idx, const OTCheckpoint::PersistentEntry& pe) {
+            // Recovery may hand out a handle sitting in some thread's cache
+            cache_generation_.fetch_add(1, std::memory_order_acq_rel);
+
             std::lock_guard<std::mutex> lk(mu_);
             
             // Ensure we have enough slabs allocated
@@ -954,6 +1301,9 @@ namespace xtree {
         }
         
         void ObjectTable::apply_delta(const OTDeltaRec& rec) {
+            // Recovery may hand out a handle sitting in some thread's cache
+            cache_generation_.fetch_add(1, std::memory_order_acq_rel);
+
             std::lock_guard<std::mutex> lk(mu_);
             
             // Ensure we have enough slabs allocated
@@ -978,7 +1328,12 @@ namespace xtree {
             // Get the entry
             OTEntry& entry = slot(rec.handle_idx);
             
-            // Apply all fields from the delta
+            // Apply all fields from the delta; a relocated node's cached
+            // vaddr belongs to its previous block
+            if (entry.addr.file_id != rec.file_id || entry.addr.segment_id != rec.segment_id ||
+                entry.addr.offset != rec.offset) {
+                entry.addr.vaddr = nullptr;
+            }
             entry.addr.file_id = rec.file_id;
             entry.addr.segment_id = rec.segment_id;
             entry.addr.offset = rec.offset;
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <array>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <cstdint>
@@ -37,6 +38,7 @@
 #include "node_id.hpp"
 #include "ot_delta_log.h"
 #include "ot_entry.h"
+#include "../util/numa_topology.h"
 #include "segment_allocator.h"
 #include "ot_checkpoint.h"
 
@@ -133,10 +135,18 @@ namespace xtree {
             const uint64_t slab_mask_;
             
         public:
-            explicit ObjectTable(size_t initial_capacity = object_table::kInitialCapacity) 
+            /**
+             * @param numa       Topology to place slabs with; nullptr (or a single
+             *                   node) keeps them on the heap
+             * @param numa_node  Dense node whose memory backs this table's slabs
+             */
+            explicit ObjectTable(size_t initial_capacity = object_table::kInitialCapacity,
+                                 const NumaTopology* numa = nullptr, size_t numa_node = 0)
                 : entries_per_slab_(compute_entries_per_slab()),
                   slab_shift_(31 - __builtin_clz(static_cast<unsigned int>(entries_per_slab_))),
-                  slab_mask_(entries_per_slab_ - 1) {
+                  slab_mask_(entries_per_slab_ - 1),
+                  numa_(numa && numa->is_numa() ? numa : nullptr),
+                  numa_node_(numa_node) {
                 // Initialize outer table to nullptr
                 for (auto& seg : slab_segments_) {
                     seg.store(nullptr, std::memory_order_relaxed);
@@ -145,6 +155,9 @@ namespace xtree {
             }
             
             ~ObjectTable() {
+                // Threads must stop returning cached handles before slabs go away
+                detach_handle_caches();
+
                 // Clean up all allocated slabs and segments
                 const uint32_t published = slab_count_.load(std::memory_order_relaxed);
                 
@@ -155,8 +168,7 @@ namespace xtree {
                     
                     SlabSegment* seg = slab_segments_[sidx].load(std::memory_order_relaxed);
                     if (seg) {
-                        OTEntry* slab = seg->slabs[off].load(std::memory_order_relaxed);
-                        delete[] slab;
+                        free_slab(seg->slabs[off].load(std::memory_order_relaxed));
                     }
                 }
                 
@@ -170,14 +182,25 @@ namespace xtree {
             /**
              * Allocate a new NodeID with the given properties.
              * Thread-safe. Uses release memory ordering on tag to publish all fields.
+             * Pops from the calling thread's handle cache; mu_ is only taken
+             * to refill the cache in batches.
              */
             NodeID allocate(NodeKind kind, uint8_t class_id, const OTAddr& addr, uint64_t birth_epoch);
             
             /**
              * Retire a NodeID at the given epoch.
              * Thread-safe and idempotent - multiple calls with same ID are safe.
+             * Lock-free: the winning retire pushes the handle onto a retired stack
+             * that reclaim_before_epoch() drains.
              */
             void   retire(NodeID id, uint64_t retire_epoch);
+
+            /**
+             * Move a LIVE entry to a new block at commit. The previous block
+             * is retired at the given epoch and freed by reclaim_before_epoch()
+             * like a retired handle's block. Thread-safe.
+             */
+            void   relocate(NodeID id, const OTAddr& to, uint64_t epoch);
             
             /**
              * Reserve a NodeID for marking live, potentially bumping tag if handle was reused.
@@ -378,10 +401,27 @@ namespace xtree {
 
             /**
              * Reclaim handles retired before the given epoch.
+             * Retired handles are bucketed by retire epoch, so the cost is
+             * proportional to the handles freed, not the retired backlog.
              * Returns the number of handles reclaimed.
              */
             size_t reclaim_before_epoch(uint64_t safe_epoch); // returns freed count
 
+            /**
+             * Handles retired but not yet reclaimed, plus blocks left behind
+             * by relocate(). Cheap enough for a background reclaimer to poll
+             * as its pressure signal.
+             */
+            size_t retired_backlog() const;
+
+            /**
+             * Set the segment allocator for freeing physical space.
+             * Should be called during initialization.
+             */
+            void set_segment_allocator(SegmentAllocator* alloc) {
+                segment_allocator_ = alloc;
+            }
+
             void   reserve(size_t n) { 
                 // With fixed-size two-level table, reserve is a no-op
                 // We allocate segments lazily as needed
@@ -396,6 +436,8 @@ namespace xtree {
              * Get configuration info for debugging/monitoring
              */
             size_t get_entries_per_slab() const { return entries_per_slab_; }
+            bool slabs_node_local() const { return numa_ != nullptr; }
+            size_t numa_node() const { return numa_node_; }
             size_t get_slab_count() const { return slab_count_.load(std::memory_order_acquire); }
             size_t get_allocated_slabs() const {
                 const uint32_t published = slab_count_.load(std::memory_order_acquire);
@@ -422,14 +464,13 @@ namespace xtree {
                 size_t last_reclaim_count = 0;                 // Items reclaimed in last run
             };
             
-            Stats get_stats() const {
-                std::lock_guard<std::mutex> lk(const_cast<std::mutex&>(mu_));
-                Stats s = stats_;
-                s.free_handles_count = free_count_;  // Use exact count from bitmap
-                s.retired_handles_count = retired_handles_.size();
-                s.max_handle_allocated = max_handle_;
-                return s;
-            }
+            Stats get_stats() const;
+
+            /**
+             * Return the calling thread's cached free handles to the table.
+             * Happens automatically when the thread exits.
+             */
+            void flush_handle_cache();
             
             /**
              * Get entry by handle index without tag validation (for checkpointing).
@@ -493,8 +534,8 @@ namespace xtree {
                 // max_handle_ + 1 gives us total allocated handles
                 // Subtract free and retired to get approximate live count
                 size_t total_handles = max_handle_ + 1;
-                size_t est_live = total_handles > (free_handles_.size() + retired_handles_.size()) 
-                                ? total_handles - free_handles_.size() - retired_handles_.size()
+                size_t est_live = total_handles > (free_handles_.size() + retired_count_) 
+                                ? total_handles - free_handles_.size() - retired_count_
                                 : 0;
                 out.clear();
                 if (est_live > 0) {
@@ -668,14 +709,6 @@ namespace xtree {
              */
             uint64_t acquire_handle_locked();
             
-            /**
-             * Set the segment allocator for freeing physical space.
-             * Should be called during initialization.
-             */
-            void set_segment_allocator(SegmentAllocator* alloc) {
-                segment_allocator_ = alloc;
-            }
-            
             /**
              * Initialize a new slab's entries to safe defaults.
              * Must be called with mu_ held.
@@ -717,6 +750,40 @@ namespace xtree {
              */
             void refill_free_cache_locked(size_t target_batch = 256);
 
+            // ========== Per-thread handle caches ==========
+            // Handles in a thread's cache are marked used in the bitmap but
+            // their entries stay FREE until allocate() hands them out
+            struct HandleCache;        // Defined in object_table.cpp
+            struct HandleCacheTable;   // thread_local list of a thread's caches
+
+            static uint64_t next_instance_id();
+            const uint64_t instance_id_ = next_instance_id();  // Never reused, unlike `this`
+            std::atomic<uint64_t> cache_generation_{0};         // Bumped by recovery
+            std::atomic<uint64_t> reclaim_seq_{0};              // Bumped when reclaim feeds the freelist
+            mutable std::mutex caches_mu_;                      // Lock order: caches_mu_ -> mu_
+            std::vector<std::shared_ptr<HandleCache>> caches_;
+            uint64_t exited_allocations_ = 0;                   // Counters of exited threads
+            uint64_t exited_retires_ = 0;
+
+            HandleCache* handle_cache(bool create = true);
+            void refill_handle_cache(HandleCache& hc);
+            void adopt_reclaimed_handles(HandleCache& hc);
+            void flush_handle_cache(HandleCache& hc);
+            void return_handles_locked(const std::vector<uint64_t>& handles, bool stale);
+            static void release_handle_cache(HandleCache& hc);
+            void detach_handle_caches();
+
+            // Lock-free retired stack linked through OTEntry::retired_next
+            void push_retired(uint64_t h, OTEntry& e);
+            void drain_retired_locked();
+
+            // Slab storage: node-local pages when numa_ is set, heap otherwise
+            OTEntry* new_slab();
+            void free_slab(OTEntry* slab);
+
+            const NumaTopology* numa_ = nullptr;
+            const size_t numa_node_ = 0;
+
             // Two-level segmented table for lock-free reads
             static constexpr uint32_t kSlabsPerSegment = 64;    // 64 slabs per segment (cache-friendly)
             static constexpr uint32_t kMaxSegments = 256;       // Max 256*64 = 16K slabs
@@ -757,7 +824,12 @@ namespace xtree {
             }
             
             std::vector<uint64_t> free_handles_;             // Free handle cache (LIFO)
-            std::vector<uint64_t> retired_handles_;          // Handles pending reclamation
+            std::map<uint64_t, std::vector<uint64_t>> retired_by_epoch_;  // Drained retires by retire epoch
+            size_t retired_count_ = 0;                       // Handles across retired_by_epoch_
+            std::map<uint64_t, std::vector<SegmentAllocator::Allocation>> relocated_by_epoch_;  // Blocks left by relocate()
+            size_t relocated_count_ = 0;                     // Blocks across relocated_by_epoch_
+            std::atomic<uint64_t> retired_head_{0};          // Newly retired handles (0 = empty)
+            uint64_t drained_retires_ = 0;                   // Handles moved off retired_head_
             uint64_t max_handle_ = 0;                        // Highest handle ever allocated
             mutable std::mutex mu_;                          // Protects allocation/free/retire
 
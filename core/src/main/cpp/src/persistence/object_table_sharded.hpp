@@ -71,6 +71,9 @@ struct ShardStatsAtomic {
  * - At large scale: provides linear scaling with concurrent operations
  * - Memory efficient: same total overhead as single large table
  * - Cache friendly: each shard has smaller working set
+ * - NUMA aware: on a multi-node machine shard s lives on node s % nodes
+ *   (slabs included) and a thread allocates from the active shards of the
+ *   node it runs on; handle-routed operations are unaffected
  */
 class ObjectTableSharded {
 private:
@@ -116,9 +119,11 @@ public:
      * Construct sharded object table
      * @param initial_capacity Total capacity across all shards
      * @param num_shards Number of shards (must be power of 2, max 64)
+     * @param numa Topology for shard placement; nullptr uses the machine's
      */
     explicit ObjectTableSharded(size_t initial_capacity = 100000,
-                               size_t num_shards = DEFAULT_NUM_SHARDS)
+                               size_t num_shards = DEFAULT_NUM_SHARDS,
+                               const NumaTopology* numa = nullptr)
         : num_shards_(num_shards),
           epoch_(1 + g_epoch_counter_.fetch_add(1, std::memory_order_relaxed)) {
         
@@ -149,10 +154,13 @@ public:
         size_t capacity_per_shard = (initial_capacity + num_shards_ - 1) / num_shards_;
         if (capacity_per_shard < 1000) capacity_per_shard = 1000;  // Minimum reasonable size
         
+        if (!numa) numa = &NumaTopology::system();
+        numa_ = numa->is_numa() ? numa : nullptr;
+
         // Allocate array of shards (avoids vector reallocation issues with unique_ptr)
         shards_.reset(new Shard[num_shards_]);
         for (size_t i = 0; i < num_shards_; ++i) {
-            shards_[i].table = std::make_unique<ObjectTable>(capacity_per_shard);
+            shards_[i].table = std::make_unique<ObjectTable>(capacity_per_shard, numa_, shard_home_node(i));
         }
     }
     
@@ -160,12 +168,26 @@ public:
      * Select shard for new allocation (tenant-aware in future)
      */
     inline size_t select_shard_for_allocation(uint32_t /*tenant_id*/ = 0) {
-        const size_t ticket = round_robin_.fetch_add(1, std::memory_order_relaxed);
+        // Per-thread ticket: each thread starts at its own offset and walks the
+        // shards round-robin, so there is no shared counter on the hot path
+        thread_local uint64_t tls_epoch = 0;
+        thread_local size_t tls_ticket = 0;
+        thread_local size_t tls_count = 0;
+        if (tls_epoch != epoch_) {
+            tls_epoch = epoch_;
+            tls_ticket = round_robin_.fetch_add(1, std::memory_order_relaxed);
+            tls_count = 0;
+        }
+        const size_t ticket = tls_ticket++;
 
+        // Activation is paced by each thread's own count: every `step`
+        // allocations made by one thread turn on one more shard. With T
+        // threads allocating, shards come on up to T times sooner than a
+        // shared count would, which is fine - more writers want more shards
         const uint32_t step = activation_step_.load(std::memory_order_relaxed);
-        if (step > 0 && (ticket % step) == 0 && active_shards_.load(std::memory_order_relaxed) < num_shards_) {
-            const size_t desired = std::min<size_t>(num_shards_, 1 + (ticket / step));
+        if (step > 0 && (++tls_count % step) == 0 && active_shards_.load(std::memory_order_relaxed) < num_shards_) {
             size_t cur = active_shards_.load(std::memory_order_relaxed);
+            const size_t desired = std::min<size_t>(num_shards_, cur + 1);
             while (cur < desired &&
                    !active_shards_.compare_exchange_weak(
                         cur, desired, std::memory_order_release, std::memory_order_relaxed)) { 
@@ -175,8 +197,28 @@ public:
 
         size_t active = active_shards_.load(std::memory_order_acquire);
         if (active == 0) active = 1;
+        if (numa_ && active > 1) {
+            // Walk only the active shards homed on this thread's node:
+            // node, node + nodes, node + 2 * nodes, ...
+            const size_t nodes = numa_->node_count();
+            const size_t node = numa_->current_node();
+            if (node < active) {
+                const size_t local = (active - node + nodes - 1) / nodes;
+                return node + (ticket % local) * nodes;
+            }
+        }
         return (active == 1) ? 0 : (ticket % active);
     }
+
+    /**
+     * Dense NUMA node whose memory holds the shard's slabs (0 when the
+     * table is not NUMA aware)
+     */
+    size_t shard_home_node(size_t shard) const {
+        return numa_ ? shard % numa_->node_count() : 0;
+    }
+
+    bool numa_aware() const { return numa_ != nullptr; }
     
     /**
      * Allocate a new NodeID
@@ -263,6 +305,14 @@ public:
 #endif
     }
     
+    /**
+     * Move a LIVE entry to a new block at commit (see ObjectTable::relocate)
+     */
+    void relocate(NodeID id, const OTAddr& to, uint64_t epoch) {
+        const size_t s = ShardBits::shard_from_handle_idx(id.handle_index());
+        shards_[s].table->relocate(to_local(id), to, epoch);
+    }
+
     /**
      * Mark live - Reserve phase
      * IMPORTANT: Returns new NodeID with potentially bumped tag for reused handles
@@ -452,9 +502,20 @@ public:
         return total;
     }
     
+    /**
+     * Handles retired but not yet reclaimed, summed over shards
+     */
+    size_t retired_backlog() const {
+        size_t total = 0;
+        for (size_t i = 0; i < num_shards_; ++i) {
+            total += shards_[i].table->retired_backlog();
+        }
+        return total;
+    }
+    
     /**
      * Reclaim handles retired before the safe epoch
-     * Runs in parallel across all shards for efficiency
+     * Runs in parallel across shards that have a retired backlog
      */
     size_t reclaim_before_epoch(uint64_t safe_epoch) {
         size_t total_reclaimed = 0;
@@ -464,6 +525,7 @@ public:
         futures.reserve(num_shards_);
         
         for (size_t i = 0; i < num_shards_; ++i) {
+            if (shards_[i].table->retired_backlog() == 0) continue;
             futures.push_back(std::async(std::launch::async, 
                 [this, i, safe_epoch]() {
                     // No outer lock needed
@@ -570,6 +632,15 @@ public:
         shards_[shard].table->apply_delta(local_rec);
     }
     
+    /**
+     * Set the segment allocator every shard frees reclaimed blocks to.
+     */
+    void set_segment_allocator(SegmentAllocator* alloc) {
+        for (size_t i = 0; i < num_shards_; ++i) {
+            shards_[i].table->set_segment_allocator(alloc);
+        }
+    }
+    
     /**
      * Begin recovery mode across all shards.
      */
@@ -653,8 +724,9 @@ private:
     size_t num_shards_;
     size_t shard_mask_;  // For efficient modulo via bitwise AND
     std::unique_ptr<Shard[]> shards_;  // Array of shards
-    std::atomic<size_t> round_robin_;  // For allocation distribution
+    std::atomic<size_t> round_robin_;  // Hands out per-thread starting shards
     std::atomic<size_t> active_shards_;  // Number of currently active shards
+    const NumaTopology* numa_ = nullptr;  // Set only for multi-node topologies
 };
 
 /**
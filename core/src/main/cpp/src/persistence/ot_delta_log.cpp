@@ -346,38 +346,37 @@ namespace xtree {
                     batch_max_epoch = item.delta.birth_epoch;
                 }
                 
+                const bool has_payload = item.payload_size > 0 && item.payload_data;
+                
+                // Lay out header, delta record and payload in one resize;
+                // the header is filled in last, once the payload CRC is known
+                const size_t frame_offset = buffer.size();
+                buffer.resize(frame_offset + kFrameHeaderSize + kWireRecSize +
+                              (has_payload ? item.payload_size : 0));
+                uint8_t* header_buf = buffer.data() + frame_offset;
+                
+                // Write delta record
+                serialize_delta_rec(header_buf + kFrameHeaderSize, item.delta);
+                
                 // Build frame header
                 FrameHeader header;
                 header.frame_type = (item.payload_size > 0) ? kFrameTypeDeltaWithPayload : kFrameTypeDeltaOnly;
                 header.payload_size = static_cast<uint32_t>(item.payload_size);
                 header.payload_crc = 0;
-                if (item.payload_size > 0 && item.payload_data) {
-                    header.payload_crc = crc32c(item.payload_data, item.payload_size);
+                if (has_payload) {
+                    // Copy the payload and checksum it in the same pass
+                    header.payload_crc = CRC32C::copy_compute(header_buf + kFrameHeaderSize + kWireRecSize,
+                                                              item.payload_data, item.payload_size);
                 }
                 
                 // Compute header CRC (excluding the header_crc field itself)
                 header.header_crc = crc32c(&header, offsetof(FrameHeader, header_crc));
                 
                 // Write frame header
-                size_t old_size = buffer.size();
-                buffer.resize(old_size + kFrameHeaderSize);
-                uint8_t* header_buf = buffer.data() + old_size;
                 store_le32(header_buf, header.frame_type);
                 store_le32(header_buf + 4, header.payload_size);
                 store_le32(header_buf + 8, header.payload_crc);
                 store_le32(header_buf + 12, header.header_crc);
-                
-                // Write delta record
-                old_size = buffer.size();
-                buffer.resize(old_size + kWireRecSize);
-                serialize_delta_rec(buffer.data() + old_size, item.delta);
-                
-                // Write payload if present
-                if (item.payload_size > 0 && item.payload_data) {
-                    old_size = buffer.size();
-                    buffer.resize(old_size + item.payload_size);
-                    std::memcpy(buffer.data() + old_size, item.payload_data, item.payload_size);
-                }
             }
             
             // Atomically reserve space in the log
@@ -654,6 +653,79 @@ namespace xtree {
             return true;
         }
 
+        bool OTDeltaLog::tail(const std::string& path,
+                              uint64_t start_offset,
+                              std::function<bool(const OTDeltaRec&)> apply,
+                              uint64_t* next_offset,
+                              std::string* error) {
+            *next_offset = start_offset;
+
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                if (error) *error = "Failed to open delta log file";
+                return false;
+            }
+            file.seekg(static_cast<std::streamoff>(start_offset));
+            if (!file.good()) {
+                return true;  // Nothing past start_offset yet
+            }
+
+            uint8_t header_buf[kFrameHeaderSize];
+            uint8_t delta_buf[kWireRecSize];
+            std::vector<uint8_t> payload_buf;
+            static constexpr uint8_t kZeroHeader[kFrameHeaderSize] = {};
+
+            while (true) {
+                const uint64_t frame_start = *next_offset;
+
+                file.read(reinterpret_cast<char*>(header_buf), kFrameHeaderSize);
+                if (file.gcount() < static_cast<std::streamsize>(kFrameHeaderSize)) {
+                    return true;  // EOF or header still being written
+                }
+                if (std::memcmp(header_buf, kZeroHeader, kFrameHeaderSize) == 0) {
+                    return true;  // Preallocated space the writer has not reached
+                }
+
+                const uint32_t frame_type = load_le32(header_buf);
+                const uint32_t payload_size = load_le32(header_buf + 4);
+                if (crc32c(header_buf, 12) != load_le32(header_buf + 12)) {
+                    if (error) *error = "Header CRC mismatch";
+                    return false;
+                }
+                if (frame_type != kFrameTypeDeltaOnly && frame_type != kFrameTypeDeltaWithPayload) {
+                    if (error) *error = "Invalid frame type";
+                    return false;
+                }
+
+                file.read(reinterpret_cast<char*>(delta_buf), kWireRecSize);
+                if (file.gcount() < static_cast<std::streamsize>(kWireRecSize)) {
+                    return true;  // Torn frame; the writer has not finished it
+                }
+                uint64_t frame_end = frame_start + kFrameHeaderSize + kWireRecSize;
+                if (frame_type == kFrameTypeDeltaWithPayload && payload_size > 0) {
+                    if (payload_buf.size() < payload_size) {
+                        payload_buf.resize(payload_size);
+                    }
+                    file.read(reinterpret_cast<char*>(payload_buf.data()), payload_size);
+                    if (file.gcount() < static_cast<std::streamsize>(payload_size)) {
+                        return true;  // Payload still being written
+                    }
+                    if (crc32c(payload_buf.data(), payload_size) != load_le32(header_buf + 8)) {
+                        if (error) *error = "Payload CRC mismatch";
+                        return false;
+                    }
+                    frame_end += payload_size;
+                }
+
+                OTDeltaRec rec;
+                deserialize_delta_rec(rec, delta_buf);
+                if (!apply(rec)) {
+                    return true;
+                }
+                *next_offset = frame_end;
+            }
+        }
+
         // Note: rotate_if_needed has been removed
         // All rotation decisions are now made by CheckpointCoordinator
         // which owns the rotation policy and coordinates with checkpoints
@@ -146,6 +146,19 @@ namespace xtree {
                               std::function<void(const OTDeltaRec&)> apply,
                               uint64_t* last_good_offset,
                               std::string* error);
+
+            // Incremental read of a log another process is appending to.
+            // Starts at start_offset (a frame boundary from a previous call)
+            // and stops at the end of written data: EOF, a torn frame, or the
+            // zeroed preallocated tail. apply returns false to stop before a
+            // record; that frame is then not consumed. *next_offset is where
+            // the next call should resume. Returns false on a corrupt frame
+            // (the log is never truncated).
+            static bool tail(const std::string& path,
+                             uint64_t start_offset,
+                             std::function<bool(const OTDeltaRec&)> apply,
+                             uint64_t* next_offset,
+                             std::string* error);
                        
             // Note: Rotation is entirely controlled by CheckpointCoordinator
             // Rotation methods do not belong here as rotation decisions are owned by the coordinator
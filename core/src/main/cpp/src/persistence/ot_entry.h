@@ -51,6 +51,7 @@ namespace xtree {
             std::atomic<uint16_t> tag{0}; // mirrors NodeID low 16 bits
             std::atomic<uint64_t> birth_epoch{0};
             std::atomic<uint64_t> retire_epoch{~uint64_t{0}}; // U64_MAX = live
+            uint64_t retired_next = 0;    // Next handle on the table's retired stack (0 = end)
 
 #ifndef NDEBUG
             // Debug-only fields to catch state machine violations
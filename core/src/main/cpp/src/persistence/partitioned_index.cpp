@@ -0,0 +1,485 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include "partitioned_index.h"
+#include "../xtree.hpp"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace xtree {
+    namespace persist {
+
+        namespace {
+            // "<first>+<count>" after the prefix; false if s is anything else
+            bool parse_range(const std::string& s, int64_t* first, int64_t* count) {
+                const size_t plus = s.find('+');
+                if (plus == std::string::npos || plus == 0 || plus + 1 == s.size()) {
+                    return false;
+                }
+                try {
+                    size_t used = 0;
+                    *first = std::stoll(s.substr(0, plus), &used);
+                    if (used != plus) return false;
+                    *count = std::stoll(s.substr(plus + 1), &used);
+                    if (used != s.size() - plus - 1) return false;
+                } catch (const std::exception&) {
+                    return false;
+                }
+                return *count > 0;
+            }
+        }
+
+        PartitionedIndex::PartitionedIndex(const PartitionOptions& options)
+            : options_(options),
+              registry_(options.registry ? *options.registry : IndexRegistry::global()) {
+            if (options_.name.empty() || options_.base_dir.empty()) {
+                throw std::invalid_argument("PartitionedIndex: name and base_dir are required");
+            }
+            if (!(options_.bucket_width > 0) || options_.time_dimension >= options_.dimension) {
+                throw std::invalid_argument("PartitionedIndex: bad bucket width or time dimension");
+            }
+            if (options_.max_open == 0) {
+                throw std::invalid_argument("PartitionedIndex: max_open must be at least 1");
+            }
+            for (unsigned short d = options_.dimension_labels.size(); d < options_.dimension; d++) {
+                options_.dimension_labels.push_back("d" + std::to_string(d));
+            }
+            for (const auto& label : options_.dimension_labels) {
+                label_ptrs_.push_back(label.c_str());
+            }
+            fs::create_directories(options_.base_dir);
+            discover();
+        }
+
+        PartitionedIndex::~PartitionedIndex() {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            for (auto& [first, p] : partitions_) {
+                (void)first;
+                registry_.remove_index(p.info.field_name);
+            }
+        }
+
+        int64_t PartitionedIndex::bucket_of(double t) const {
+            return static_cast<int64_t>(std::floor(t / options_.bucket_width));
+        }
+
+        std::string PartitionedIndex::partition_name(int64_t first, int64_t count, bool merging) const {
+            return options_.name + (merging ? ".m" : ".p") + std::to_string(first) + "+" + std::to_string(count);
+        }
+
+        void PartitionedIndex::register_partition(const std::string& field, const std::string& dir) {
+            IndexConfig config;
+            config.field_name = field;
+            config.data_dir = dir;
+            config.dimension = options_.dimension;
+            config.precision = options_.precision;
+            config.dimension_labels = options_.dimension_labels;
+            config.dim_labels_ptr = &label_ptrs_;
+            registry_.register_index(field, config);
+        }
+
+        PartitionedIndex::Partition& PartitionedIndex::add_partition(int64_t first, int64_t count) {
+            Partition p;
+            p.info.field_name = partition_name(first, count);
+            p.info.data_dir = (fs::path(options_.base_dir) / p.info.field_name).string();
+            p.info.first_bucket = first;
+            p.info.bucket_count = count;
+            p.info.time_begin = static_cast<double>(first) * options_.bucket_width;
+            p.info.time_end = static_cast<double>(first + count) * options_.bucket_width;
+            register_partition(p.info.field_name, p.info.data_dir);
+            return partitions_[first] = std::move(p);
+        }
+
+        IndexDetails<DataRecord>* PartitionedIndex::load(const Partition& p) {
+            auto* idx = registry_.get_or_load<DataRecord>(p.info.field_name);
+            if (!idx) {
+                throw std::runtime_error("PartitionedIndex: cannot open partition " + p.info.field_name);
+            }
+            return idx;
+        }
+
+        IndexDetails<DataRecord>* PartitionedIndex::acquire(Partition& p) {
+            {
+                std::lock_guard<std::mutex> lk(open_mu_);
+                p.users++;
+                p.last_use = ++use_clock_;
+                if (!p.open) {
+                    p.open = true;
+                    open_count_++;
+                    close_excess_locked();   // Make room before loading
+                }
+            }
+            try {
+                return load(p);
+            } catch (...) {
+                release(p);
+                throw;
+            }
+        }
+
+        void PartitionedIndex::release(Partition& p) {
+            std::lock_guard<std::mutex> lk(open_mu_);
+            p.users--;
+            close_excess_locked();
+        }
+
+        void PartitionedIndex::close_excess_locked() {
+            while (open_count_ > options_.max_open) {
+                Partition* victim = nullptr;
+                for (auto& [first, p] : partitions_) {
+                    (void)first;
+                    if (p.open && p.users == 0 && (!victim || p.last_use < victim->last_use)) {
+                        victim = &p;
+                    }
+                }
+                if (!victim) {
+                    return;  // Everything open is in use; the next release retries
+                }
+                // Unloading closes the index, which flushes and commits it.
+                // open_mu_ stays held so nobody loads it again meanwhile.
+                registry_.unload_index(victim->info.field_name);
+                victim->open = false;
+                victim->dirty = false;
+                open_count_--;
+            }
+        }
+
+        size_t PartitionedIndex::open_partitions() const {
+            std::lock_guard<std::mutex> lk(open_mu_);
+            return open_count_;
+        }
+
+        void PartitionedIndex::discover() {
+            const std::string live = options_.name + ".p";
+            const std::string merging = options_.name + ".m";
+            std::vector<std::pair<int64_t, int64_t>> found;
+            for (const auto& e : fs::directory_iterator(options_.base_dir)) {
+                if (!e.is_directory()) continue;
+                const std::string dir = e.path().filename().string();
+                int64_t first = 0, count = 0;
+                if (dir.rfind(merging, 0) == 0) {
+                    // Never renamed into place: its sources are all still here
+                    info() << "PartitionedIndex: removing unfinished merge " << dir;
+                    fs::remove_all(e.path());
+                } else if (dir.rfind(live, 0) == 0 &&
+                           parse_range(dir.substr(live.size()), &first, &count) &&
+                           dir == partition_name(first, count)) {
+                    found.emplace_back(first, count);
+                }
+            }
+
+            // Widest first, so a finished merge wins over the sources it covers
+            std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+                return a.first != b.first ? a.first < b.first : a.second > b.second;
+            });
+            int64_t covered_to = std::numeric_limits<int64_t>::min();
+            for (const auto& [first, count] : found) {
+                if (first < covered_to) {
+                    info() << "PartitionedIndex: removing merged source " << partition_name(first, count);
+                    fs::remove_all(fs::path(options_.base_dir) / partition_name(first, count));
+                    continue;
+                }
+                add_partition(first, count);
+                covered_to = first + count;
+            }
+        }
+
+        void PartitionedIndex::insert(DataRecord* record) {
+            std::vector<double> bounds(2 * options_.dimension);
+            if (!record || !record->getExactBounds(bounds.data(), options_.dimension)) {
+                throw std::invalid_argument("PartitionedIndex: record has no points");
+            }
+            const int64_t bucket = bucket_of(bounds[2 * options_.time_dimension]);
+
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            auto it = partitions_.upper_bound(bucket);
+            Partition* p = nullptr;
+            if (it != partitions_.begin()) {
+                --it;
+                if (bucket < it->second.info.first_bucket + it->second.info.bucket_count) {
+                    p = &it->second;
+                }
+            }
+            if (!p) {
+                p = &add_partition(bucket, 1);
+                p->records = 0;
+            }
+
+            auto* idx = acquire(*p);
+            p->dirty = true;
+            try {
+                if (!idx->root_node_id().valid()) {
+                    idx->ensure_root_initialized<DataRecord>();
+                }
+                idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), record);
+            } catch (...) {
+                release(*p);
+                throw;
+            }
+            if (p->records != UNKNOWN) p->records++;
+            release(*p);
+        }
+
+        void PartitionedIndex::commit() {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            for (auto& [first, p] : partitions_) {
+                (void)first;
+                if (!p.dirty) continue;
+                auto* idx = acquire(p);
+                idx->flush_dirty_buckets();
+                idx->getStore()->commit(0);
+                p.dirty = false;
+                release(p);
+            }
+        }
+
+        size_t PartitionedIndex::query(IRecord* searchKey, SearchType type,
+                                       const std::function<void(std::string_view)>& on_row,
+                                       PartitionQueryStats* stats) {
+            const KeyMBR* key = searchKey ? searchKey->getKey() : nullptr;
+            if (!key) {
+                throw std::invalid_argument("PartitionedIndex: query without a key");
+            }
+            const double lo = key->getMin(options_.time_dimension);
+            const double hi = key->getMax(options_.time_dimension);
+
+            std::shared_lock<std::shared_mutex> lk(mu_);
+            PartitionQueryStats local;
+            local.partitions_total = partitions_.size();
+            // Partitions are only written under the exclusive lock
+            for (auto& [first, p] : partitions_) {
+                (void)first;
+                if (p.info.time_end <= lo || p.info.time_begin > hi) {
+                    continue;
+                }
+                local.partitions_scanned++;
+                auto* idx = acquire(p);
+                try {
+                    if (idx->root_node_id().valid()) {
+                        std::unique_ptr<Iterator<DataRecord>> iter(
+                            idx->root_bucket<DataRecord>()->getIterator(idx->root_cache_node(), searchKey, type));
+                        std::string_view rowid;
+                        while (iter->nextRowID(rowid)) {
+                            on_row(rowid);
+                            local.rows++;
+                        }
+                    }
+                } catch (...) {
+                    release(p);
+                    throw;
+                }
+                release(p);
+            }
+            if (stats) *stats = local;
+            return local.rows;
+        }
+
+        void PartitionedIndex::drop(std::map<int64_t, Partition>::iterator it) {
+            const PartitionInfo info = it->second.info;
+            {
+                std::lock_guard<std::mutex> lk(open_mu_);
+                if (it->second.open) open_count_--;
+            }
+            partitions_.erase(it);
+            registry_.remove_index(info.field_name);
+            std::error_code ec;
+            fs::remove_all(info.data_dir, ec);
+            if (ec) {
+                warning() << "PartitionedIndex: failed to delete " << info.data_dir << ": " << ec.message();
+            }
+        }
+
+        size_t PartitionedIndex::drop_before(double t) {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            size_t dropped = 0;
+            while (!partitions_.empty() && partitions_.begin()->second.info.time_end <= t) {
+                drop(partitions_.begin());
+                dropped++;
+            }
+            return dropped;
+        }
+
+        bool PartitionedIndex::drop_partition(const std::string& field_name) {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            for (auto it = partitions_.begin(); it != partitions_.end(); ++it) {
+                if (it->second.info.field_name == field_name) {
+                    drop(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void PartitionedIndex::scan(Partition& p, const std::function<bool(IDataRecord*)>& visit) {
+            auto* idx = acquire(p);
+            struct Release {
+                PartitionedIndex* self;
+                Partition& p;
+                ~Release() { self->release(p); }
+            } release_on_exit{this, p};
+            if (!idx->root_node_id().valid()) {
+                return;
+            }
+            // Everything in the tree: unbounded on every axis
+            DataRecord all(options_.dimension, options_.precision, "");
+            std::vector<double> lo(options_.dimension, -std::numeric_limits<float>::max());
+            std::vector<double> hi(options_.dimension, std::numeric_limits<float>::max());
+            all.putPoint(&lo);
+            all.putPoint(&hi);
+            std::unique_ptr<Iterator<DataRecord>> iter(
+                idx->root_bucket<DataRecord>()->getIterator(idx->root_cache_node(), &all, INTERSECTS));
+            while (IDataRecord* rec = iter->nextData()) {
+                if (!visit(rec)) break;
+            }
+        }
+
+        size_t PartitionedIndex::count_locked(Partition& p) {
+            if (p.records == UNKNOWN) {
+                size_t n = 0;
+                scan(p, [&n](IDataRecord*) { n++; return true; });
+                p.records = n;
+            }
+            return p.records;
+        }
+
+        size_t PartitionedIndex::record_count(const std::string& field_name) {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            for (auto& [first, p] : partitions_) {
+                (void)first;
+                if (p.info.field_name == field_name) return count_locked(p);
+            }
+            return 0;
+        }
+
+        IndexDetails<DataRecord>* PartitionedIndex::partition_index(const std::string& field_name) {
+            std::shared_lock<std::shared_mutex> lk(mu_);
+            for (auto& [first, p] : partitions_) {
+                (void)first;
+                if (p.info.field_name == field_name) {
+                    auto* idx = acquire(p);
+                    release(p);
+                    return idx;
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<PartitionInfo> PartitionedIndex::partitions() const {
+            std::shared_lock<std::shared_mutex> lk(mu_);
+            std::vector<PartitionInfo> out;
+            out.reserve(partitions_.size());
+            for (const auto& [first, p] : partitions_) {
+                (void)first;
+                out.push_back(p.info);
+            }
+            return out;
+        }
+
+        size_t PartitionedIndex::merge_small_partitions() {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            const size_t limit = options_.merge_below;
+            if (limit == 0 || partitions_.size() < 3) {
+                return 0;
+            }
+
+            // Runs of adjacent small partitions, newest partition excluded
+            std::vector<std::vector<int64_t>> runs(1);
+            size_t run_records = 0;
+            const auto newest = std::prev(partitions_.end());
+            for (auto it = partitions_.begin(); it != newest; ++it) {
+                const size_t n = count_locked(it->second);
+                if (n >= limit || run_records + n > limit) {
+                    if (!runs.back().empty()) runs.emplace_back();
+                    run_records = 0;
+                    if (n >= limit) continue;
+                }
+                runs.back().push_back(it->first);
+                run_records += n;
+            }
+
+            size_t merged = 0;
+            for (const auto& run : runs) {
+                if (run.size() < 2) continue;
+                merge_run(run);
+                merged += run.size() - 1;
+            }
+            return merged;
+        }
+
+        void PartitionedIndex::merge_run(const std::vector<int64_t>& run) {
+            const int64_t first = run.front();
+            const Partition& last = partitions_.at(run.back());
+            const int64_t count = last.info.first_bucket + last.info.bucket_count - first;
+            const std::string field = partition_name(first, count);
+            const fs::path final_dir = fs::path(options_.base_dir) / field;
+            const fs::path temp_dir = fs::path(options_.base_dir) / partition_name(first, count, true);
+
+            // Build the merged tree under its final field name in the temp directory
+            fs::remove_all(temp_dir);
+            register_partition(field, temp_dir.string());
+            auto* target = registry_.get_or_load<DataRecord>(field);
+            if (!target) {
+                registry_.remove_index(field);
+                throw std::runtime_error("PartitionedIndex: cannot create " + temp_dir.string());
+            }
+            target->ensure_root_initialized<DataRecord>();
+
+            const unsigned short dims = options_.dimension;
+            std::vector<double> bounds(2 * dims), lo(dims), hi(dims);
+            size_t records = 0;
+            for (int64_t source : run) {
+                scan(partitions_.at(source), [&](IDataRecord* rec) {
+                    // Row id and exact bounds are kept; a multi-point record
+                    // is re-inserted as the corners of its box
+                    if (!rec->getExactBounds(bounds.data(), dims)) return true;
+                    for (unsigned short d = 0; d < dims; d++) {
+                        lo[d] = bounds[2 * d];
+                        hi[d] = bounds[2 * d + 1];
+                    }
+                    auto* copy = new DataRecord(dims, options_.precision, rec->getRowID());
+                    copy->putPoint(&lo);
+                    if (hi != lo) copy->putPoint(&hi);
+                    target->root_bucket<DataRecord>()->xt_insert(target->root_cache_node(), copy);
+                    records++;
+                    return true;
+                });
+            }
+            target->flush_dirty_buckets();
+            target->getStore()->commit(0);
+            registry_.remove_index(field);   // Closes the runtime before the rename
+
+            // The rename publishes the merge; the sources go after it
+            fs::rename(temp_dir, final_dir);
+            for (int64_t source : run) {
+                drop(partitions_.find(source));
+            }
+            add_partition(first, count).records = records;
+            info() << "PartitionedIndex: merged " << run.size() << " partitions into " << field
+                   << " (" << records << " records)";
+        }
+
+    } // namespace persist
+} // namespace xtree
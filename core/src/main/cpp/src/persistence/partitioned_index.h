@@ -0,0 +1,196 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+/*
+ * Time-partitioned index layout for time-series workloads.
+ *
+ * Records are a time axis plus N numeric dimensions, appended roughly in
+ * time order and queried mostly over recent windows. Instead of one XTree
+ * that grows forever, every time bucket of bucket_width gets its own
+ * durable XTree in its own data directory, registered with IndexRegistry:
+ *
+ *   - A record is filed under the bucket of its earliest time, read from
+ *     its exact (double) bounds. Pruning assumes records are points on the
+ *     time axis, which is what the workload appends.
+ *   - query() only opens partitions whose time range meets the query's,
+ *     so a recent window touches one or two trees whatever the history.
+ *   - Retention drops whole partitions: the index is unloaded and its
+ *     directory, segment files included, is deleted outright.
+ *   - merge_small_partitions() folds runs of adjacent sealed partitions
+ *     with fewer than merge_below records into one partition spanning
+ *     their buckets. The merged tree is built in a "<name>.m..." directory
+ *     and renamed to its final "<name>.p..." name once committed; the
+ *     sources are deleted afterwards. Opening the layout again removes an
+ *     unfinished merge, and partitions covered by a finished one.
+ *
+ * Partitions are named "<name>.p<first bucket>+<bucket count>"; the same
+ * string is the registry field name and the directory under base_dir.
+ * Partitions stay under IndexRegistry's control, so cold ones can be
+ * unloaded under memory pressure and are reopened on the next access.
+ *
+ * Every loaded partition holds a DurableRuntime (with its reclaimer
+ * thread) and one of IndexDetails' cache key slots, so at most max_open
+ * partitions are loaded at once. Opening another one first unloads, and
+ * so commits, the least recently used partition no query is scanning;
+ * a query over a long history therefore streams through its partitions
+ * instead of keeping them all open.
+ *
+ * Thread-safety: queries run concurrently with each other; insert(),
+ * commit(), drops and merges are exclusive.
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "index_registry.h"
+#include "../xtree.h"
+
+namespace xtree {
+    namespace persist {
+
+        struct PartitionOptions {
+            std::string name;                    // Prefix of every partition's field name
+            std::string base_dir;                // Partition directories live here
+            unsigned short dimension = 2;        // Including the time axis
+            unsigned short precision = 32;
+            std::vector<std::string> dimension_labels;  // Defaults to d0, d1, ...
+            unsigned short time_dimension = 0;   // Axis holding the timestamp
+            double bucket_width = 3600.0;        // Time units per partition
+            size_t merge_below = 0;              // See merge_small_partitions(); 0 = never
+            size_t max_open = 16;                // Partitions loaded at once (at least 1)
+            IndexRegistry* registry = nullptr;   // nullptr = IndexRegistry::global()
+        };
+
+        struct PartitionInfo {
+            std::string field_name;   // Registry name and directory name
+            std::string data_dir;
+            int64_t first_bucket = 0;
+            int64_t bucket_count = 1; // More than one after a merge
+            double time_begin = 0;    // Inclusive
+            double time_end = 0;      // Exclusive
+        };
+
+        struct PartitionQueryStats {
+            size_t partitions_total = 0;
+            size_t partitions_scanned = 0;
+            size_t rows = 0;
+        };
+
+        class PartitionedIndex {
+        public:
+            // Opens the partitions already under base_dir
+            explicit PartitionedIndex(const PartitionOptions& options);
+            // Unloads (and so commits) every partition and unregisters it
+            ~PartitionedIndex();
+
+            PartitionedIndex(const PartitionedIndex&) = delete;
+            PartitionedIndex& operator=(const PartitionedIndex&) = delete;
+
+            // Takes ownership of record, as XTreeBucket::xt_insert() does
+            void insert(DataRecord* record);
+
+            // Flush and commit every partition written since the last commit
+            void commit();
+
+            // Calls on_row for every match in the partitions the query's time
+            // range reaches. The view is valid only during the call.
+            // @return number of rows
+            size_t query(IRecord* searchKey, SearchType type,
+                         const std::function<void(std::string_view)>& on_row,
+                         PartitionQueryStats* stats = nullptr);
+
+            // Drop every partition that ends at or before time t
+            // @return number of partitions dropped
+            size_t drop_before(double t);
+
+            // @return false if there is no such partition
+            bool drop_partition(const std::string& field_name);
+
+            // Fold runs of adjacent partitions with fewer than merge_below
+            // records each, up to merge_below records per run, into one
+            // partition. The partition holding the newest bucket is left
+            // alone since it is still being appended to.
+            // @return number of partitions merged away
+            size_t merge_small_partitions();
+
+            // In time order
+            std::vector<PartitionInfo> partitions() const;
+
+            // Records in a partition, counted on first use after a reopen
+            size_t record_count(const std::string& field_name);
+
+            // The partition's index, loading it if necessary; nullptr if unknown.
+            // Valid until max_open other partitions have been opened.
+            IndexDetails<DataRecord>* partition_index(const std::string& field_name);
+
+            // Partitions currently loaded by this index
+            size_t open_partitions() const;
+
+        private:
+            struct Partition {
+                PartitionInfo info;
+                size_t records = UNKNOWN;  // Known once written or counted here
+                bool dirty = false;
+                // Guarded by open_mu_
+                bool open = false;
+                size_t users = 0;          // Callers between acquire() and release()
+                uint64_t last_use = 0;
+            };
+            static constexpr size_t UNKNOWN = SIZE_MAX;
+
+            int64_t bucket_of(double t) const;
+            std::string partition_name(int64_t first, int64_t count, bool merging = false) const;
+            Partition& add_partition(int64_t first, int64_t count);
+            void register_partition(const std::string& field, const std::string& dir);
+            IndexDetails<DataRecord>* load(const Partition& p);
+            // Load p and keep it loaded until release(p)
+            IndexDetails<DataRecord>* acquire(Partition& p);
+            void release(Partition& p);
+            // Unload idle partitions, least recently used first, down to
+            // max_open. Caller holds open_mu_.
+            void close_excess_locked();
+            void discover();
+            void drop(std::map<int64_t, Partition>::iterator it);
+            size_t count_locked(Partition& p);
+            // Visit every record of p; false stops the scan
+            void scan(Partition& p, const std::function<bool(IDataRecord*)>& visit);
+            void merge_run(const std::vector<int64_t>& run);
+
+            PartitionOptions options_;
+            IndexRegistry& registry_;
+            std::vector<const char*> label_ptrs_;   // Into options_.dimension_labels
+
+            mutable std::shared_mutex mu_;
+            std::map<int64_t, Partition> partitions_;  // By first bucket
+
+            // Queries share mu_, so loading and unloading take this too
+            mutable std::mutex open_mu_;
+            size_t open_count_ = 0;
+            uint64_t use_clock_ = 0;
+        };
+
+    } // namespace persist
+} // namespace xtree
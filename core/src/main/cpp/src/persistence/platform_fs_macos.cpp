@@ -166,7 +166,11 @@ namespace xtree {
         FSResult PlatformFS::prefetch(void* addr, size_t len) { 
             // madvise(MADV_WILLNEED)
 #ifdef MADV_WILLNEED
-            int rc = ::madvise(addr, len, MADV_WILLNEED);
+            // madvise wants a page-aligned start; widen to whole pages
+            const uintptr_t page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+            const uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~(page - 1);
+            const uintptr_t end = reinterpret_cast<uintptr_t>(addr) + len;
+            int rc = ::madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
             return { rc == 0, rc == 0 ? 0 : errno };
 #else
             return {true,0};
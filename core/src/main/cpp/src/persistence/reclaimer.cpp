@@ -18,27 +18,100 @@
  */
 
 #include "reclaimer.h"
+#include <algorithm>
+#include <chrono>
 
 namespace xtree { 
     namespace persist {
 
         size_t Reclaimer::run_once() {
             // Get the minimum epoch that any reader is currently using
-            uint64_t min_active = mvcc_.min_active_epoch();
-            
-            // Only reclaim objects retired before the minimum active epoch
+            return reclaim_before(mvcc_.min_active_epoch());
+        }
+
+        size_t Reclaimer::reclaim_before(uint64_t safe_epoch) {
+            std::lock_guard<std::mutex> run_lk(run_mu_);
+
+            // Only reclaim objects retired before safe_epoch
             // This ensures no reader can be accessing these objects
-            if (min_active == 0) {
+            if (safe_epoch == 0) {
                 // No epochs have been advanced yet, nothing to reclaim
                 return 0;
             }
             
-            // Reclaim all objects retired before min_active
-            // (objects with retire_epoch < min_active are safe to reclaim)
-            size_t reclaimed = ot_.reclaim_before_epoch(min_active);
+            // Reclaim all objects retired before safe_epoch
+            // (objects with retire_epoch < safe_epoch are safe to reclaim)
+            size_t reclaimed = ot_.reclaim_before_epoch(safe_epoch);
             
             return reclaimed;
         }
 
+        size_t Reclaimer::run_durable() {
+            return reclaim_before(durable_safe_epoch());
+        }
+
+        uint64_t Reclaimer::durable_safe_epoch() const {
+            return std::min(mvcc_.min_active_epoch(),
+                            durable_epoch_.load(std::memory_order_acquire) + 1);
+        }
+
+        void Reclaimer::set_durable_epoch(uint64_t epoch) {
+            uint64_t cur = durable_epoch_.load(std::memory_order_relaxed);
+            while (epoch > cur &&
+                   !durable_epoch_.compare_exchange_weak(cur, epoch, std::memory_order_acq_rel)) {
+            }
+        }
+
+        void Reclaimer::start() {
+            bool expected = false;
+            if (!running_.compare_exchange_strong(expected, true)) return;
+            th_ = std::thread([this]{ loop(); });
+        }
+
+        void Reclaimer::stop() {
+            if (!running_.exchange(false)) return;
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                kicked_ = true;
+            }
+            cv_.notify_all();
+            if (th_.joinable()) {
+                th_.join();
+            }
+        }
+
+        void Reclaimer::notify() {
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                kicked_ = true;
+            }
+            cv_.notify_one();
+        }
+
+        void Reclaimer::loop() {
+            const auto interval = std::chrono::milliseconds(reclaim::kPollIntervalMs);
+            while (running_.load(std::memory_order_acquire)) {
+                {
+                    std::unique_lock<std::mutex> lk(mu_);
+                    cv_.wait_for(lk, interval, [this]{ return kicked_; });
+                    kicked_ = false;
+                }
+                if (!running_.load(std::memory_order_acquire)) break;
+
+                // Retire pressure drives reclamation; an idle table costs one poll
+                if (ot_.retired_backlog() < pressure_threshold_) continue;
+
+                // Nothing newer is durable than at the last pass: wait for
+                // the next checkpoint rather than rescanning the backlog
+                const uint64_t safe = durable_safe_epoch();
+                if (safe <= last_pass_epoch_) continue;
+                last_pass_epoch_ = safe;
+
+                size_t n = reclaim_before(safe);
+                passes_.fetch_add(1, std::memory_order_relaxed);
+                reclaimed_.fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+
     } // namespace persist
-} // namespace xtree
\ No newline at end of file
+} // namespace xtree
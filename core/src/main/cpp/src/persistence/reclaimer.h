@@ -17,7 +17,12 @@
  * https://www.gnu.org/licenses/agpl-3.0.html
  */
 #pragma once
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
+#include <thread>
+#include "config.h"
 #include "object_table_sharded.hpp"
 #include "mvcc_context.h"
 
@@ -26,14 +31,55 @@ namespace xtree {
 
         class Reclaimer {
         public:
-            explicit Reclaimer(ObjectTableSharded& ot, MVCCContext& mvcc)
-                : ot_(ot), mvcc_(mvcc) {}
-            size_t run_once(); // reclaim rows with retire_epoch < min_active
+            explicit Reclaimer(ObjectTableSharded& ot, MVCCContext& mvcc,
+                               size_t pressure_threshold = reclaim::kPressureThreshold)
+                : ot_(ot), mvcc_(mvcc), pressure_threshold_(pressure_threshold) {}
+            ~Reclaimer() { stop(); }
+
+            // Reclaim rows with retire_epoch < min_active. The caller makes
+            // sure those retires are durable.
+            size_t run_once();
+
+            // Reclaim rows retired before min_active and up to durable_epoch().
+            // A freed block can be reused at once, and recovery must never
+            // find a node pointing at a block that was handed out again.
+            size_t run_durable();
+
+            // Epochs up to `epoch` are checkpointed: their retires and the
+            // blocks that replaced retired ones survive a crash
+            void set_durable_epoch(uint64_t epoch);
+            uint64_t durable_epoch() const { return durable_epoch_.load(std::memory_order_acquire); }
+
+            // Background reclamation: a run_durable() pass runs whenever the
+            // retired backlog reaches pressure_threshold, polled every
+            // kPollIntervalMs
+            void start();   // spawn background thread
+            void stop();    // signal & join
+            void notify();  // wake the thread to check the backlog now
+
+            uint64_t background_passes() const { return passes_.load(std::memory_order_relaxed); }
+            uint64_t background_reclaimed() const { return reclaimed_.load(std::memory_order_relaxed); }
 
         private:
+            void loop();
+            uint64_t durable_safe_epoch() const;
+            size_t reclaim_before(uint64_t safe_epoch);
+
             ObjectTableSharded& ot_;
             MVCCContext& mvcc_;
+            const size_t pressure_threshold_;
+
+            std::atomic<bool> running_{false};
+            std::thread th_;
+            std::mutex mu_;
+            std::condition_variable cv_;
+            bool kicked_ = false;
+            std::mutex run_mu_;                 // One pass at a time
+            std::atomic<uint64_t> passes_{0};
+            std::atomic<uint64_t> reclaimed_{0};
+            std::atomic<uint64_t> durable_epoch_{0};
+            uint64_t last_pass_epoch_ = 0;      // Bound of the last background pass
         };
 
     }
-} // namespace xtree::persist
\ No newline at end of file
+} // namespace xtree::persist
@@ -0,0 +1,344 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include "replica_tailer.h"
+#include "ot_checkpoint.h"
+#include "ot_delta_log.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace xtree {
+    namespace persist {
+
+        namespace {
+            // After a file event the superblock publish may trail the log
+            // and manifest writes slightly; re-check quickly for a while
+            constexpr auto kEventRetry = std::chrono::milliseconds(2);
+            constexpr auto kEventWindow = std::chrono::milliseconds(50);
+
+            uint64_t record_epoch(const OTDeltaRec& rec) {
+                return rec.retire_epoch != ~uint64_t{0} ? rec.retire_epoch : rec.birth_epoch;
+            }
+        }
+
+        ReplicaTailer::ReplicaTailer(Superblock& sb, ObjectTableSharded& ot, MVCCContext& mvcc,
+                                     const std::string& data_dir, uint64_t base_epoch)
+            : sb_(sb), ot_(ot), mvcc_(mvcc), data_dir_(data_dir), manifest_(data_dir),
+              loaded_epoch_(base_epoch), applied_epoch_(base_epoch) {}
+
+        ReplicaTailer::~ReplicaTailer() {
+            stop();
+        }
+
+        std::vector<ReplicaTailer::LogFile> ReplicaTailer::list_logs(bool have_manifest) {
+            std::vector<LogFile> logs;
+            if (have_manifest) {
+                for (const auto& l : manifest_.get_delta_logs()) {
+                    logs.push_back({l.path, l.start_epoch, l.end_epoch});
+                }
+            }
+            if (logs.empty()) {
+                // No manifest entries yet: names sort in sequence order
+                std::error_code ec;
+                for (const auto& e : std::filesystem::directory_iterator(data_dir_ + "/logs", ec)) {
+                    const std::string name = e.path().filename().string();
+                    if (name.rfind("delta_", 0) == 0 && e.path().extension() == ".wal") {
+                        logs.push_back({"logs/" + name, 0, 0});
+                    }
+                }
+                std::sort(logs.begin(), logs.end(),
+                          [](const LogFile& a, const LogFile& b) { return a.path < b.path; });
+            } else {
+                std::stable_sort(logs.begin(), logs.end(), [](const LogFile& a, const LogFile& b) {
+                    return a.start_epoch < b.start_epoch;
+                });
+            }
+            return logs;
+        }
+
+        void ReplicaTailer::note_changed(uint64_t handle_idx, uint16_t tag) {
+            std::lock_guard<std::mutex> lk(changed_mu_);
+            changed_.insert(NodeID::from_parts(handle_idx, tag).raw());
+        }
+
+        std::vector<uint64_t> ReplicaTailer::take_changed() {
+            std::lock_guard<std::mutex> lk(changed_mu_);
+            std::vector<uint64_t> out(changed_.begin(), changed_.end());
+            changed_.clear();
+            return out;
+        }
+
+        size_t ReplicaTailer::resync_from_checkpoint(uint64_t* epoch) {
+            std::string path = manifest_.get_checkpoint().path.empty()
+                ? OTCheckpoint::find_latest_checkpoint(data_dir_)
+                : (std::filesystem::path(data_dir_) / manifest_.get_checkpoint().path).string();
+            if (path.empty()) {
+                return 0;
+            }
+
+            OTCheckpoint checkpoint(data_dir_);
+            const OTCheckpoint::PersistentEntry* entries = nullptr;
+            size_t count = 0;
+            if (!checkpoint.map_for_read(path, epoch, &count, &entries)) {
+                warning() << "Replica: failed to map checkpoint " << path;
+                return 0;
+            }
+            // Retired rows are applied too: the replica may still hold them live
+            for (size_t i = 0; i < count; i++) {
+                const auto& pe = entries[i];
+                OTDeltaRec rec{pe.handle_idx, pe.tag, pe.class_id, pe.kind,
+                               pe.file_id, pe.segment_id, pe.offset, pe.length,
+                               0, pe.birth_epoch, pe.retire_epoch};
+                ot_.apply_delta(rec);
+                note_changed(pe.handle_idx, pe.tag);
+            }
+            return count;
+        }
+
+        ReplicaAdvance ReplicaTailer::catch_up() {
+            std::lock_guard<std::mutex> lk(catch_up_mu_);
+
+            ReplicaAdvance adv;
+            uint64_t applied = applied_epoch_.load(std::memory_order_acquire);
+            adv.from_epoch = adv.to_epoch = applied;
+            if (!sb_.valid()) {
+                return adv;
+            }
+            const Superblock::Snapshot snap = sb_.load();
+            adv.root = snap.root;
+
+            // The writer stores the root catalog after the commit's log
+            // records and before the superblock, and a group-commit follower
+            // may skip the superblock altogether, so a newer catalog is just
+            // as safe a target
+            const bool have_manifest = manifest_.reload();
+            uint64_t target = snap.epoch;
+            if (have_manifest) {
+                adv.roots = manifest_.get_roots();
+                for (const auto& r : adv.roots) {
+                    if (r.epoch > target) {
+                        target = r.epoch;
+                        if (r.name.empty()) adv.root = NodeID::from_raw(r.node_id_raw);
+                    }
+                }
+            }
+            if (target <= applied) {
+                return adv;
+            }
+
+            // Entries become visible as they are applied; the caller only
+            // switches roots once the round is complete
+            mvcc_.advance_epoch_to(target);
+
+            std::vector<LogFile> logs = list_logs(have_manifest);
+            std::unordered_map<std::string, uint64_t> still_listed;
+
+            // A log we still need is gone: the writer checkpointed past us
+            // and collected it. Start over from that checkpoint.
+            const uint64_t checkpoint_epoch = manifest_.get_checkpoint().epoch;
+            if (checkpoint_epoch > applied) {
+                bool gap = !logs.empty() && logs.front().start_epoch > applied + 1;
+                for (const auto& log : logs) {
+                    if (offsets_.count(log.path) && !std::filesystem::exists(data_dir_ + "/" + log.path)) {
+                        gap = true;
+                    }
+                }
+                for (const auto& [path, offset] : offsets_) {
+                    (void)offset;
+                    gap |= std::none_of(logs.begin(), logs.end(),
+                                        [&](const LogFile& l) { return l.path == path; });
+                }
+                uint64_t resync_epoch = 0;
+                if (gap && resync_from_checkpoint(&resync_epoch) > 0) {
+                    adv.resynced = true;
+                    applied = std::max(applied, resync_epoch);
+                    loaded_epoch_ = std::max(loaded_epoch_, resync_epoch);
+                    offsets_.clear();
+                    info() << "Replica resynced from checkpoint epoch " << resync_epoch;
+                }
+            }
+
+            // The logs are not epoch-ordered: concurrent appends reserve space
+            // before writing, so a later epoch can precede an earlier one. The
+            // round only reaches target if no log stopped on a frame it could
+            // not take; otherwise applied stays put and the cursors resume.
+            bool reached_future = false;
+            bool complete = true;
+            for (const auto& log : logs) {
+                if (reached_future) {
+                    break;
+                }
+                if (log.end_epoch != 0 && log.end_epoch <= applied) {
+                    continue;  // Sealed; nothing newer than what we applied
+                }
+                uint64_t& offset = offsets_[log.path];
+                uint64_t next = offset;
+                std::string error;
+                const bool ok = OTDeltaLog::tail(data_dir_ + "/" + log.path, offset,
+                    [&](const OTDeltaRec& rec) {
+                        const uint64_t e = record_epoch(rec);
+                        if (e > target) {
+                            reached_future = true;  // Not published yet
+                            return false;
+                        }
+                        // The cursor already keeps records from being seen
+                        // twice; only what the loaded checkpoint holds is skipped
+                        if (e > loaded_epoch_) {
+                            ot_.apply_delta(rec);
+                            note_changed(rec.handle_idx, rec.tag);
+                            ++adv.deltas;
+                        }
+                        return true;
+                    }, &next, &error);
+                offset = next;
+                still_listed[log.path] = next;
+                if (reached_future) {
+                    complete = false;
+                }
+                if (!ok) {
+                    // Usually a frame caught mid-write; the next round retries it
+                    debug() << "Replica: stopped tailing " << log.path << " at " << next << ": " << error;
+                    complete = false;
+                    break;
+                }
+            }
+            offsets_.swap(still_listed);
+
+            if (complete) {
+                applied = std::max(applied, target);
+            }
+            if (applied > adv.from_epoch) {
+                applied_epoch_.store(applied, std::memory_order_release);
+                generation_.fetch_add(1, std::memory_order_acq_rel);
+                adv.to_epoch = applied;
+            }
+            return adv;
+        }
+
+        bool ReplicaTailer::start(const ReplicaOptions& options,
+                                  std::function<void(const ReplicaAdvance&)> on_advance) {
+            bool expected = false;
+            if (!running_.compare_exchange_strong(expected, true)) {
+                return false;
+            }
+#ifdef __linux__
+            wake_fd_ = options.use_inotify ? ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) : -1;
+#endif
+            thread_ = std::thread([this, options, on_advance = std::move(on_advance)]() mutable {
+                run(options, std::move(on_advance));
+            });
+            return true;
+        }
+
+        void ReplicaTailer::stop() {
+            if (!running_.exchange(false)) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lk(wake_mu_);
+            }
+            wake_cv_.notify_all();
+#ifdef __linux__
+            if (wake_fd_ >= 0) {
+                const uint64_t one = 1;
+                (void)!::write(wake_fd_, &one, sizeof(one));
+            }
+#endif
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+#ifdef __linux__
+            if (wake_fd_ >= 0) {
+                ::close(wake_fd_);
+                wake_fd_ = -1;
+            }
+#endif
+        }
+
+        void ReplicaTailer::run(ReplicaOptions options,
+                                std::function<void(const ReplicaAdvance&)> on_advance) {
+            int watch_fd = -1;
+#ifdef __linux__
+            if (options.use_inotify && wake_fd_ >= 0) {
+                watch_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (watch_fd >= 0) {
+                    const uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+                    const bool watched = ::inotify_add_watch(watch_fd, data_dir_.c_str(), mask) >= 0;
+                    // The log directory may not exist yet; IN_CREATE on data_dir covers it
+                    (void)::inotify_add_watch(watch_fd, (data_dir_ + "/logs").c_str(), mask);
+                    if (!watched) {
+                        ::close(watch_fd);
+                        watch_fd = -1;
+                    }
+                }
+            }
+#endif
+            auto fast_until = std::chrono::steady_clock::time_point{};
+
+            while (running_.load(std::memory_order_acquire)) {
+                ReplicaAdvance adv;
+                try {
+                    adv = catch_up();
+                } catch (const std::exception& e) {
+                    warning() << "Replica catch-up failed: " << e.what();
+                }
+                if (adv.advanced()) {
+                    fast_until = {};
+                    if (on_advance) {
+                        on_advance(adv);
+                    }
+                }
+
+                auto timeout = options.poll_interval;
+                if (std::chrono::steady_clock::now() < fast_until) {
+                    timeout = std::min<std::chrono::milliseconds>(timeout, kEventRetry);
+                }
+#ifdef __linux__
+                if (watch_fd >= 0) {
+                    pollfd fds[2] = {{watch_fd, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+                    if (::poll(fds, 2, static_cast<int>(timeout.count())) > 0 && (fds[0].revents & POLLIN)) {
+                        alignas(inotify_event) char buf[4096];
+                        while (::read(watch_fd, buf, sizeof(buf)) > 0) {
+                        }
+                        fast_until = std::chrono::steady_clock::now() + kEventWindow;
+                    }
+                    continue;
+                }
+#endif
+                std::unique_lock<std::mutex> lk(wake_mu_);
+                wake_cv_.wait_for(lk, timeout, [this] { return !running_.load(std::memory_order_acquire); });
+            }
+#ifdef __linux__
+            if (watch_fd >= 0) {
+                ::close(watch_fd);
+            }
+#endif
+        }
+
+    } // namespace persist
+} // namespace xtree
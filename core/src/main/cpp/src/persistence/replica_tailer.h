@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+/*
+ * Incremental catch-up for read-only replicas.
+ *
+ * A read-only DurableRuntime starts from the latest OT checkpoint and skips
+ * WAL replay. The tailer keeps such a replica current while a writer process
+ * keeps committing to the same data directory, without re-running recovery:
+ *
+ *   - The superblock and the manifest's root catalog are the commit
+ *     points. Each catch_up() reads both and applies only the delta log
+ *     records with epochs up to the newer of the two, so a replica's object
+ *     table never holds part of a batch. Records of later epochs stay in
+ *     the log for the next round.
+ *   - Logs are tailed from a saved offset per file, in manifest order
+ *     (start_epoch); the zeroed preallocated tail and a frame still being
+ *     written both end a round cleanly. Nothing on disk is ever modified.
+ *   - If logs the replica still needed were garbage collected after a newer
+ *     checkpoint, it re-applies that checkpoint and continues from there.
+ *
+ * Node bytes are read from the same segment files the writer maps, so a
+ * new root is readable as soon as its OT entries are applied. The writer
+ * never rewrites a committed node in place: a republished node goes to a
+ * new block that its commit's records point to (relocate_on_republish in
+ * DurabilityPolicy), and the old block is only reused after the reclaimer
+ * frees it. A replica that falls that far behind can still read recycled
+ * bytes, since the writer does not see a replica's epoch. The handles
+ * touched by applied records are collected for the caller, which uses them
+ * to drop stale cached nodes before switching to the new root.
+ *
+ * start() runs catch_up() on a background thread. On Linux it sleeps on
+ * inotify events for the data and log directories and polls as a
+ * fallback; elsewhere it only polls.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "manifest.h"
+#include "mvcc_context.h"
+#include "object_table_sharded.hpp"
+#include "superblock.hpp"
+
+namespace xtree {
+    namespace persist {
+
+        struct ReplicaOptions {
+            // Longest wait between checks; the only trigger without inotify
+            std::chrono::milliseconds poll_interval{100};
+            // Wake on file system events where the platform supports it
+            bool use_inotify = true;
+        };
+
+        // Result of one catch-up round
+        struct ReplicaAdvance {
+            uint64_t from_epoch = 0;
+            uint64_t to_epoch = 0;    // == from_epoch when nothing was committed
+            NodeID   root;            // primary root at to_epoch
+            std::vector<Manifest::RootEntry> roots;  // catalog at to_epoch
+            size_t   deltas = 0;      // records applied to the object table
+            bool     resynced = false; // re-applied a checkpoint
+
+            bool advanced() const { return to_epoch > from_epoch; }
+        };
+
+        class ReplicaTailer {
+        public:
+            // base_epoch: the epoch the object table already reflects (the
+            // checkpoint a read-only runtime was opened from)
+            ReplicaTailer(Superblock& sb, ObjectTableSharded& ot, MVCCContext& mvcc,
+                          const std::string& data_dir, uint64_t base_epoch);
+            ~ReplicaTailer();
+
+            ReplicaTailer(const ReplicaTailer&) = delete;
+            ReplicaTailer& operator=(const ReplicaTailer&) = delete;
+
+            // Apply everything the writer has committed since the last round.
+            // Serialized against itself; safe to call while start() is active.
+            ReplicaAdvance catch_up();
+
+            // Background catch-up; on_advance runs on the tailer thread after
+            // every round that moved the epoch. False if already running.
+            bool start(const ReplicaOptions& options,
+                       std::function<void(const ReplicaAdvance&)> on_advance = {});
+            void stop();
+            bool running() const { return running_.load(std::memory_order_acquire); }
+
+            uint64_t applied_epoch() const { return applied_epoch_.load(std::memory_order_acquire); }
+
+            // Bumped after each round that moved the epoch
+            uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+            // Raw NodeIDs touched since the last call
+            std::vector<uint64_t> take_changed();
+
+        private:
+            struct LogFile {
+                std::string path;       // relative to data_dir
+                uint64_t start_epoch;
+                uint64_t end_epoch;     // 0 while active
+            };
+
+            std::vector<LogFile> list_logs(bool have_manifest);
+            size_t resync_from_checkpoint(uint64_t* epoch);
+            void note_changed(uint64_t handle_idx, uint16_t tag);
+            void run(ReplicaOptions options, std::function<void(const ReplicaAdvance&)> on_advance);
+
+            Superblock& sb_;
+            ObjectTableSharded& ot_;
+            MVCCContext& mvcc_;
+            std::string data_dir_;
+            Manifest manifest_;      // private copy; reloaded every round
+
+            std::mutex catch_up_mu_;
+            std::unordered_map<std::string, uint64_t> offsets_;  // next frame per log
+            uint64_t loaded_epoch_;  // checkpoint the object table was loaded from
+            std::atomic<uint64_t> applied_epoch_;
+            std::atomic<uint64_t> generation_{0};
+
+            std::mutex changed_mu_;
+            std::unordered_set<uint64_t> changed_;
+
+            std::atomic<bool> running_{false};
+            std::mutex wake_mu_;
+            std::condition_variable wake_cv_;
+            std::thread thread_;
+            int wake_fd_ = -1;       // eventfd that interrupts the inotify wait
+        };
+
+    } // namespace persist
+} // namespace xtree
@@ -66,6 +66,9 @@ namespace xtree {
                 file_registry_ = owned_file_registry_.get();
                 mapping_manager_ = owned_mapping_manager_.get();
             }
+            if (config_.huge_pages) {
+                mapping_manager_->set_huge_pages(true);
+            }
 
             // Ensure data directory exists
             FSResult dir_result = PlatformFS::ensure_directory(data_dir);
@@ -75,6 +78,7 @@ namespace xtree {
 
             // Initialize allocators for each size class
             // Actual file creation happens lazily on first allocation
+            init_thread_caches();
         }
         
         // Static assertion to ensure size classes meet alignment requirements
@@ -104,12 +108,16 @@ namespace xtree {
                 file_registry_ = owned_file_registry_.get();
                 mapping_manager_ = owned_mapping_manager_.get();
             }
+            if (config_.huge_pages) {
+                mapping_manager_->set_huge_pages(true);
+            }
 
             // Ensure data directory exists
             FSResult dir_result = PlatformFS::ensure_directory(data_dir);
             if (!dir_result.ok) {
                 // Log error but continue
             }
+            init_thread_caches();
         }
         
         // Constructor that takes registries (for DurableStore)
@@ -124,6 +132,7 @@ namespace xtree {
             if (!dir_result.ok) {
                 // Log error but continue
             }
+            init_thread_caches();
         }
         
         // Constructor with registries and config
@@ -143,117 +152,486 @@ namespace xtree {
             if (!dir_result.ok) {
                 // Log error but continue
             }
+            init_thread_caches();
         }
 
+        // ========== Per-thread block magazines ==========
+
+        /**
+         * Blocks cached by one thread for one allocator, tcmalloc style.
+         *
+         * Only the owning thread touches the magazines, so the allocate/free
+         * fast path takes no lock. Blocks in a magazine are already marked
+         * used in their segment's bitmap; magazines are refilled and trimmed
+         * in batches under the class mutex. Counters are single-writer
+         * atomics so get_stats() can sum them from any thread.
+         */
+        struct SegmentAllocator::ThreadCache {
+            struct Counters {
+                std::atomic<uint64_t> allocs{0};
+                std::atomic<uint64_t> fresh{0};
+                std::atomic<uint64_t> reused{0};
+                std::atomic<uint64_t> frees{0};
+                std::atomic<uint64_t> accepted_frees{0};
+            };
+
+            std::mutex owner_mu;                       // Thread exit vs allocator teardown
+            std::atomic<SegmentAllocator*> owner{nullptr};
+            std::atomic<bool> exited{false};
+            uint64_t generation = 0;                   // Owner's cache_generation_ at fill
+            std::vector<BlockRef> magazines[NUM_CLASSES];
+            Counters counters[NUM_CLASSES];
+
+            static void bump(std::atomic<uint64_t>& c) {
+                c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        };
+
+        // A thread's caches, one per allocator it has used. Flushed on thread exit.
+        struct SegmentAllocator::ThreadCacheTable {
+            struct Slot {
+                uint64_t allocator_id;
+                std::shared_ptr<ThreadCache> cache;
+            };
+            std::vector<Slot> slots;
+            uint64_t last_id = 0;
+            ThreadCache* last = nullptr;
+
+            ~ThreadCacheTable() {
+                for (auto& slot : slots) {
+                    SegmentAllocator::release_thread_cache(*slot.cache);
+                }
+            }
+        };
+
         SegmentAllocator::~SegmentAllocator() {
+            // Detach thread caches first so an exiting thread can no longer
+            // flush into this allocator
+            {
+                std::lock_guard<std::mutex> lock(caches_mu_);
+                for (auto& tc : caches_) {
+                    std::lock_guard<std::mutex> owner_lock(tc->owner_mu);
+                    tc->owner.store(nullptr, std::memory_order_release);
+                }
+                caches_.clear();
+            }
+
             // Ensure all pins are released before member destruction
             // This prevents accessing MappingManager during static destructor phase
             close_all();
         }
 
-        SegmentAllocator::Allocation SegmentAllocator::allocate(size_t size, NodeKind kind) {
-            // Guard: block allocations in read-only mode
-            if (read_only_) {
-                throw std::logic_error("Cannot allocate in read-only mode (serverless reader)");
+        uint64_t SegmentAllocator::next_instance_id() {
+            static std::atomic<uint64_t> next{1};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void SegmentAllocator::init_thread_caches() {
+            for (uint8_t c = 0; c < NUM_CLASSES; ++c) {
+                size_t cap = std::min<size_t>(segment::kMagazineMaxBlocks,
+                                              config_.thread_cache_bytes / class_to_size(c));
+                allocators_[c].magazine_capacity = cap >= segment::kMagazineMinBlocks ? cap : 0;
             }
+        }
 
-            uint8_t class_id = size_to_class(size);
-            size_t alloc_size = class_to_size(class_id);
+        SegmentAllocator::ThreadCache* SegmentAllocator::thread_cache(bool create) {
+            static thread_local ThreadCacheTable table;
+            if (LIKELY(table.last && table.last_id == instance_id_)) {
+                return table.last;
+            }
+            for (auto& slot : table.slots) {
+                if (slot.allocator_id == instance_id_) {
+                    table.last_id = instance_id_;
+                    table.last = slot.cache.get();
+                    return table.last;
+                }
+            }
+            if (!create) return nullptr;
 
-            auto& allocator = allocators_[class_id];
-            std::lock_guard<std::mutex> lock(allocator.mu);
-            
-            // Track total allocations
-            allocator.total_allocations++;
-            
-            // Use bitmap-based allocation for O(1) performance
-            const uint32_t class_sz = class_to_size(class_id);
-            
-            // Prefer active segment
-            Segment* seg = allocator.active_segment;
-            if (!seg || !seg->has_free_blocks()) {
-                // Find any segment with free space
-                seg = nullptr;
-                for (auto& up : allocator.segments) {
-                    if (up->has_free_blocks()) {
-                        seg = up.get();
-                        break;
+            // Drop caches of allocators that no longer exist
+            table.slots.erase(std::remove_if(table.slots.begin(), table.slots.end(),
+                [](const ThreadCacheTable::Slot& slot) {
+                    return slot.cache->owner.load(std::memory_order_acquire) == nullptr;
+                }), table.slots.end());
+
+            auto tc = std::make_shared<ThreadCache>();
+            tc->owner.store(this, std::memory_order_release);
+            tc->generation = cache_generation_.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lock(caches_mu_);
+                // Fold in counters of exited threads so caches_ stays bounded
+                auto dead = std::remove_if(caches_.begin(), caches_.end(),
+                    [this](const std::shared_ptr<ThreadCache>& c) {
+                        if (!c->exited.load(std::memory_order_acquire)) return false;
+                        for (uint8_t cls = 0; cls < NUM_CLASSES; ++cls) {
+                            const auto& src = c->counters[cls];
+                            auto& dst = retired_counters_[cls];
+                            dst.allocs += src.allocs.load(std::memory_order_relaxed);
+                            dst.fresh += src.fresh.load(std::memory_order_relaxed);
+                            dst.reused += src.reused.load(std::memory_order_relaxed);
+                            dst.frees += src.frees.load(std::memory_order_relaxed);
+                            dst.accepted_frees += src.accepted_frees.load(std::memory_order_relaxed);
+                        }
+                        return true;
+                    });
+                caches_.erase(dead, caches_.end());
+                caches_.push_back(tc);
+            }
+            table.slots.push_back({instance_id_, tc});
+            table.last_id = instance_id_;
+            table.last = tc.get();
+            return table.last;
+        }
+
+        void SegmentAllocator::flush_thread_cache() {
+            if (ThreadCache* tc = thread_cache(/*create=*/false)) {
+                flush_thread_cache(*tc);
+            }
+        }
+
+        void SegmentAllocator::flush_thread_cache(ThreadCache& tc) {
+            for (uint8_t c = 0; c < NUM_CLASSES; ++c) {
+                auto& mag = tc.magazines[c];
+                if (mag.empty()) continue;
+                auto& ca = allocators_[c];
+                std::lock_guard<std::mutex> lock(ca.mu);
+                // Checked under mu: close_all() bumps the generation before it
+                // takes mu to destroy the segments, so a match here means they
+                // are still alive. Otherwise the blocks are just dropped.
+                if (tc.generation == cache_generation_.load(std::memory_order_acquire)) {
+                    for (const auto& b : mag) {
+                        return_block_locked(ca, b.seg, b.bit);
                     }
                 }
-                if (!seg) {
-                    seg = allocate_new_segment(class_id, kind);
-                    if (!seg) {
-                        // Failed to allocate segment - critical error
-                        return Allocation{0, 0, 0, 0, 0};
+                mag.clear();
+            }
+            tc.generation = cache_generation_.load(std::memory_order_acquire);
+        }
+
+        void SegmentAllocator::release_thread_cache(ThreadCache& tc) {
+            std::lock_guard<std::mutex> lock(tc.owner_mu);
+            if (SegmentAllocator* owner = tc.owner.load(std::memory_order_acquire)) {
+                owner->flush_thread_cache(tc);
+            }
+            tc.exited.store(true, std::memory_order_release);
+        }
+
+        SegmentAllocator::CacheCounters SegmentAllocator::sum_cache_counters(uint8_t class_id) const {
+            std::lock_guard<std::mutex> lock(caches_mu_);
+            CacheCounters sum = retired_counters_[class_id];
+            for (const auto& tc : caches_) {
+                const auto& c = tc->counters[class_id];
+                sum.allocs += c.allocs.load(std::memory_order_relaxed);
+                sum.fresh += c.fresh.load(std::memory_order_relaxed);
+                sum.reused += c.reused.load(std::memory_order_relaxed);
+                sum.frees += c.frees.load(std::memory_order_relaxed);
+                sum.accepted_frees += c.accepted_frees.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        // ========== Bitmap and free-space index ==========
+
+        void SegmentAllocator::mark_segment_free_locked(ClassAllocator& ca, const Segment* seg) {
+            const size_t w = seg->segment_id >> 6;
+            if (w >= ca.free_segments.size()) {
+                ca.free_segments.resize(w + 1, 0);
+            }
+            ca.free_segments[w] |= (1ull << (seg->segment_id & 63));
+            ca.free_segments_hint = std::min(ca.free_segments_hint, w);
+        }
+
+        void SegmentAllocator::mark_segment_full_locked(ClassAllocator& ca, const Segment* seg) {
+            const size_t w = seg->segment_id >> 6;
+            if (w < ca.free_segments.size()) {
+                ca.free_segments[w] &= ~(1ull << (seg->segment_id & 63));
+            }
+        }
+
+        SegmentAllocator::Segment* SegmentAllocator::find_free_segment_locked(ClassAllocator& ca) {
+            const size_t table_size = ca.seg_table_size.load(std::memory_order_relaxed);
+            auto* table = ca.seg_table_root.load(std::memory_order_relaxed);
+            for (size_t w = ca.free_segments_hint; w < ca.free_segments.size(); ++w) {
+                while (uint64_t word = ca.free_segments[w]) {
+                    const size_t id = w * 64 + ctz64(word);
+                    Segment* seg = (table && id < table_size)
+                        ? table[id].load(std::memory_order_relaxed) : nullptr;
+                    if (seg && seg->has_free_blocks()) {
+                        ca.free_segments_hint = w;
+                        return seg;
                     }
+                    // Stale entry (segment replaced or closed)
+                    ca.free_segments[w] &= ~(1ull << (id & 63));
                 }
-                allocator.active_segment = seg;
             }
-            
-            int bit = seg->find_free_bit();
-            if (bit < 0) {
-                // Very rare race: another thread consumed last bit of active segment
-                // Fall back to scanning/creating one more time
-                seg = nullptr;
-                for (auto& up : allocator.segments) {
-                    if (up->has_free_blocks()) {
-                        seg = up.get();
-                        break;
+            ca.free_segments_hint = ca.free_segments.size();
+            return nullptr;
+        }
+
+        size_t SegmentAllocator::take_blocks_locked(ClassAllocator& ca, Segment* seg,
+                                                    std::vector<BlockRef>& out, size_t want) {
+            const uint32_t class_sz = class_to_size(seg->class_id);
+            size_t got = 0;
+            const size_t words = seg->bm.size();
+            for (size_t w = seg->scan_word; w < words && got < want; ++w) {
+                uint64_t word = seg->bm[w];
+                while (word && got < want) {
+                    const uint32_t bit = static_cast<uint32_t>(w * 64 + ctz64(word));
+                    word &= word - 1;
+                    const bool reused = bit < seg->max_allocated;
+                    if (!reused) {
+                        seg->max_allocated = bit + 1;
                     }
+                    out.push_back(BlockRef{seg, bit, reused});
+                    ++got;
                 }
-                if (!seg) {
-                    seg = allocate_new_segment(class_id, kind);
+                seg->bm[w] = word;
+                if (!word) {
+                    seg->scan_word = static_cast<uint32_t>(w + 1);
+                }
+            }
+            seg->free_count -= static_cast<uint32_t>(got);
+            seg->used = (seg->blocks - seg->free_count) * class_sz;
+            if (seg->free_count == 0) {
+                mark_segment_full_locked(ca, seg);
+            }
+            return got;
+        }
+
+        size_t SegmentAllocator::reserve_blocks_locked(ClassAllocator& ca, uint8_t class_id,
+                                                       NodeKind kind,
+                                                       std::vector<BlockRef>& out, size_t want) {
+            size_t got = 0;
+            while (got < want) {
+                // Prefer active segment, then any segment the index says has room
+                Segment* seg = ca.active_segment;
+                if (!seg || !seg->has_free_blocks()) {
+                    seg = find_free_segment_locked(ca);
                     if (!seg) {
-                        return Allocation{0, 0, 0, 0, 0};
+                        if (got > 0) break;  // Don't open a segment just to top up a batch
+                        seg = allocate_new_segment(class_id, kind);
+                        if (!seg) break;
                     }
+                    ca.active_segment = seg;
                 }
-                bit = seg->find_free_bit();
-                if (bit < 0) {
-                    // Should not happen
-                    return Allocation{0, 0, 0, 0, 0};
-                }
+                got += take_blocks_locked(ca, seg, out, want - got);
             }
-            
-            // Mark used: flip bit to 0
+            return got;
+        }
+
+        SegmentAllocator::BlockRef SegmentAllocator::take_block_locked(ClassAllocator& ca, Segment* seg,
+                                                                       uint32_t bit) {
+            seg->bm[bit >> 6] &= ~(1ull << (bit & 63));
+            const bool reused = bit < seg->max_allocated;
+            if (!reused) {
+                seg->max_allocated = bit + 1;
+            }
+            seg->free_count--;
+            seg->used = (seg->blocks - seg->free_count) * class_to_size(seg->class_id);
+            if (seg->free_count == 0) {
+                mark_segment_full_locked(ca, seg);
+            }
+            return BlockRef{seg, bit, reused};
+        }
+
+        bool SegmentAllocator::return_block_locked(ClassAllocator& ca, Segment* seg, uint32_t bit) {
             const size_t w = size_t(bit) >> 6;
-            const int b = bit & 63;
-            seg->bm[w] &= ~(1ull << b);
-            --seg->free_count;
-            
-            // Update used for consistency (though bitmap is authoritative)
-            seg->used = (seg->blocks - seg->free_count) * class_sz;
-            
-            // Track if this is a reused block or fresh allocation
-            uint32_t block_index = static_cast<uint32_t>(bit);
-            bool is_reused = block_index < seg->max_allocated;
-            
-            // Update high water mark and stats based on allocation type
-            if (!is_reused) {
-                seg->max_allocated = block_index + 1;
-                allocator.allocs_from_bump++;     // Fresh allocation
-            } else {
-                allocator.allocs_from_bitmap++;   // Reused a freed block
+            const uint64_t mask = 1ull << (bit & 63);
+            if (seg->bm[w] & mask) {
+                return false;  // Double free - ignore
             }
-            
+            seg->bm[w] |= mask;
+            if (seg->free_count++ == 0) {
+                mark_segment_free_locked(ca, seg);
+            }
+            seg->scan_word = std::min(seg->scan_word, static_cast<uint32_t>(w));
+            seg->used = (seg->blocks - seg->free_count) * class_to_size(seg->class_id);
+            return true;
+        }
+
+        bool SegmentAllocator::locate_block(const Allocation& a, Segment*& seg,
+                                            uint32_t& bit) const noexcept {
+            const auto& ca = allocators_[a.class_id];
+            const size_t size = ca.seg_table_size.load(std::memory_order_acquire);
+            auto* table = ca.seg_table_root.load(std::memory_order_relaxed);
+            if (!table || a.segment_id >= size) return false;
+            seg = table[a.segment_id].load(std::memory_order_acquire);
+            if (!seg || seg->file_id != a.file_id) {
+                return false;  // Unknown segment (corruption or race)
+            }
+            if (a.offset < seg->base_offset) {
+                return false;  // Offset before segment base - corruption
+            }
+            const uint32_t class_sz = class_to_size(a.class_id);
+            if ((a.offset - seg->base_offset) % class_sz != 0) {
+                return false;  // Misaligned offset - corruption
+            }
+            bit = block_index_from_offset(seg->base_offset, a.offset, class_sz);
+            return bit < seg->blocks;
+        }
+
+        SegmentAllocator::Allocation SegmentAllocator::make_allocation(const BlockRef& b,
+                                                                       uint8_t class_id) const noexcept {
+            const uint32_t class_sz = class_to_size(class_id);
             Allocation alloc;
-            alloc.file_id = seg->file_id;
-            alloc.segment_id = seg->segment_id;
-            alloc.offset = seg->base_offset + uint64_t(bit) * class_sz;
+            alloc.file_id = b.seg->file_id;
+            alloc.segment_id = b.seg->segment_id;
+            alloc.offset = b.seg->base_offset + uint64_t(b.bit) * class_sz;
             alloc.length = class_sz;
             alloc.class_id = class_id;
-            
             // Don't create a new pin - the allocation will use the segment's base_vaddr
             // The pin in Allocation is not used for regular allocations (only for recovery)
-            // Regular allocations rely on the segment's stable base_vaddr
-            
+            return alloc;
+        }
+
+        void SegmentAllocator::adopt_recovered_segment(ClassAllocator& ca, std::unique_ptr<Segment> seg) {
+            std::lock_guard<std::mutex> lock(ca.mu);
+            if (seg->has_free_blocks()) {
+                mark_segment_free_locked(ca, seg.get());
+            }
+            ca.segments.emplace_back(std::move(seg));
+        }
+
+        bool SegmentAllocator::restore_live_block(uint8_t class_id, uint32_t file_id, uint32_t segment_id,
+                                                  uint64_t offset, uint32_t length) {
+            // Maps and adopts the segment on first use
+            if (!get_ptr_for_recovery(class_id, file_id, segment_id, offset, length)) {
+                return false;
+            }
+            auto& ca = allocators_[class_id];
+            std::lock_guard<std::mutex> lock(ca.mu);
+            Segment* seg = ca.seg_table_root.load(std::memory_order_relaxed)[segment_id]
+                               .load(std::memory_order_relaxed);
+            const uint32_t bit = static_cast<uint32_t>((offset - seg->base_offset) / class_to_size(class_id));
+            if (seg->bm[bit >> 6] & (1ull << (bit & 63))) {
+                take_block_locked(ca, seg, bit);
+            }
+
+            // New segments go after the last recovered one, in id and in file
+            if (segment_id >= ca.next_segment_id.load(std::memory_order_relaxed)) {
+                ca.next_segment_id.store(segment_id + 1, std::memory_order_relaxed);
+            }
+            const size_t seg_end = seg->base_offset + seg->capacity;
+            if (files::kFilePerSizeClass) {
+                const uint32_t seq = file_id & 0xFFFFFF;
+                if (seq > ca.current_file_seq ||
+                    (seq == ca.current_file_seq && seg_end > ca.bytes_in_current_file)) {
+                    ca.current_file_seq = seq;
+                    ca.bytes_in_current_file = seg_end;
+                }
+            } else {
+                const uint32_t seq = file_id & 0x7FFFFFFF;
+                uint32_t next = global_file_seq_.load(std::memory_order_relaxed);
+                while (seq >= next && !global_file_seq_.compare_exchange_weak(next, seq + 1)) {}
+            }
+            return true;
+        }
+
+        SegmentAllocator::Allocation SegmentAllocator::allocate(size_t size, NodeKind kind) {
+            // Guard: block allocations in read-only mode
+            if (read_only_) {
+                throw std::logic_error("Cannot allocate in read-only mode (serverless reader)");
+            }
+
+            uint8_t class_id = size_to_class(size);
+            auto& allocator = allocators_[class_id];
+
+            // Fast path: pop from this thread's magazine, refilling in bulk
+            if (LIKELY(allocator.magazine_capacity > 0)) {
+                ThreadCache* tc = thread_cache();
+                if (UNLIKELY(tc->generation != cache_generation_.load(std::memory_order_acquire))) {
+                    flush_thread_cache(*tc);
+                }
+                auto& mag = tc->magazines[class_id];
+                if (UNLIKELY(mag.empty())) {
+                    std::lock_guard<std::mutex> lock(allocator.mu);
+                    reserve_blocks_locked(allocator, class_id, kind, mag,
+                                          allocator.magazine_capacity / 2);
+                    // Pop in address order
+                    std::reverse(mag.begin(), mag.end());
+                }
+                if (UNLIKELY(mag.empty())) {
+                    // Failed to allocate segment - critical error
+                    return Allocation{0, 0, 0, 0, 0};
+                }
+                const BlockRef b = mag.back();
+                mag.pop_back();
+
+                auto& counters = tc->counters[class_id];
+                ThreadCache::bump(counters.allocs);
+                ThreadCache::bump(b.reused ? counters.reused : counters.fresh);
+                return make_allocation(b, class_id);
+            }
+
+            // Direct path for classes too large to cache
+            std::lock_guard<std::mutex> lock(allocator.mu);
+
+            // Track total allocations
+            allocator.total_allocations++;
+
+            std::vector<BlockRef> taken;
+            if (reserve_blocks_locked(allocator, class_id, kind, taken, 1) == 0) {
+                // Failed to allocate segment - critical error
+                return Allocation{0, 0, 0, 0, 0};
+            }
+            const BlockRef& b = taken.front();
+            const uint32_t class_sz = class_to_size(class_id);
+
+            // Track if this is a reused block or fresh allocation
+            if (b.reused) {
+                allocator.allocs_from_bitmap++;   // Reused a freed block
+            } else {
+                allocator.allocs_from_bump++;     // Fresh allocation
+            }
+
             // Update stats
             allocator.live_bytes += class_sz;
             // Only decrement dead_bytes if we're actually reclaiming dead space
             if (allocator.dead_bytes >= class_sz) {
                 allocator.dead_bytes -= class_sz;  // Reclaiming dead space
             }
-            
-            return alloc;
+
+            return make_allocation(b, class_id);
+        }
+
+        SegmentAllocator::Allocation SegmentAllocator::allocate(size_t size, NodeKind kind,
+                                                                const Allocation& near) {
+            const uint8_t class_id = size_to_class(size);
+            const bool data_file = (kind == NodeKind::DataRecord || kind == NodeKind::ValueVec);
+            if (!config_.placement_hints || read_only_ || !near.is_valid() ||
+                near.class_id != class_id || ((near.file_id & 0x80000000u) != 0) != data_file) {
+                return allocate(size, kind);
+            }
+
+            auto& allocator = allocators_[class_id];
+            {
+                std::lock_guard<std::mutex> lock(allocator.mu);
+                Segment* seg;
+                uint32_t bit;
+                if (locate_block(near, seg, bit) && seg->has_free_blocks()) {
+                    int free_bit = seg->nearest_free_in_word(bit >> 6, bit);
+                    if (free_bit < 0) free_bit = seg->find_free_bit_near(bit, /*whole_word=*/true);
+                    if (free_bit < 0) free_bit = seg->find_free_bit_near(bit);
+                    if (free_bit >= 0) {
+                        const BlockRef b = take_block_locked(allocator, seg, static_cast<uint32_t>(free_bit));
+                        const uint32_t class_sz = class_to_size(class_id);
+                        allocator.total_allocations++;
+                        allocator.allocs_placed++;
+                        if (b.reused) {
+                            allocator.allocs_from_bitmap++;
+                        } else {
+                            allocator.allocs_from_bump++;
+                        }
+                        allocator.live_bytes += class_sz;
+                        if (allocator.dead_bytes >= class_sz) {
+                            allocator.dead_bytes -= class_sz;
+                        }
+                        return make_allocation(b, class_id);
+                    }
+                }
+            }
+            // Near segment is full: anywhere will do
+            return allocate(size, kind);
         }
 
         void SegmentAllocator::free(Allocation& a) {
@@ -268,71 +646,68 @@ namespace xtree {
             if (a.class_id >= NUM_CLASSES || a.length == 0) {
                 return;  // Invalid allocation
             }
-            
+
             const uint8_t cid = a.class_id;
             auto& allocator = allocators_[cid];
-            std::lock_guard<std::mutex> lock(allocator.mu);
-            
-            // Track free operations
-            allocator.total_frees++;
-            
-            // Find the segment
-            Segment* seg = nullptr;
-            for (auto& up : allocator.segments) {
-                if (up->file_id == a.file_id && up->segment_id == a.segment_id) {
-                    seg = up.get();
-                    break;
+
+            // Fast path: park the block in this thread's magazine for reuse
+            if (LIKELY(allocator.magazine_capacity > 0)) {
+                ThreadCache* tc = thread_cache();
+                if (UNLIKELY(tc->generation != cache_generation_.load(std::memory_order_acquire))) {
+                    flush_thread_cache(*tc);
                 }
-            }
-            
-            if (!seg) {
-                // Unknown segment (corruption or race) - log warning
-                return;
-            }
-            
-            // Sanity checks for offset validity
-            if (a.offset < seg->base_offset) {
-                // Offset before segment base - corruption
-                return;
-            }
-            
-            const uint32_t class_sz = class_to_size(cid);
-            const uint64_t offset_in_segment = a.offset - seg->base_offset;
-            
-            // Check alignment
-            if (offset_in_segment % class_sz != 0) {
-                // Misaligned offset - corruption
+                auto& counters = tc->counters[cid];
+                ThreadCache::bump(counters.frees);
+
+                Segment* seg;
+                uint32_t bit;
+                if (!locate_block(a, seg, bit)) {
+                    return;
+                }
+                // Only guards against this thread parking the same block twice;
+                // frees of one block from different threads are not detected
+                auto& mag = tc->magazines[cid];
+                for (const auto& b : mag) {
+                    if (b.bit == bit && b.seg == seg) {
+                        return;
+                    }
+                }
+                if (UNLIKELY(mag.size() >= allocator.magazine_capacity)) {
+                    // Return the oldest half to the bitmaps
+                    const size_t n = mag.size() / 2;
+                    std::lock_guard<std::mutex> lock(allocator.mu);
+                    for (size_t i = 0; i < n; ++i) {
+                        return_block_locked(allocator, mag[i].seg, mag[i].bit);
+                    }
+                    mag.erase(mag.begin(), mag.begin() + n);
+                }
+                mag.push_back(BlockRef{seg, bit, /*reused=*/true});
+                ThreadCache::bump(counters.accepted_frees);
                 return;
             }
-            
-            // Translate offset to block index and flip the bit back to 1
-            const uint32_t bi = block_index_from_offset(seg->base_offset, a.offset, class_sz);
-            if (bi >= seg->blocks) {
-                // Out of bounds - log warning
+
+            std::lock_guard<std::mutex> lock(allocator.mu);
+
+            // Track free operations
+            allocator.total_frees++;
+
+            // O(1) segment lookup through the segment table
+            Segment* seg;
+            uint32_t bi;
+            if (!locate_block(a, seg, bi)) {
                 return;
             }
-            
-            const size_t w = size_t(bi) >> 6;
-            const int b = bi & 63;
-            uint64_t mask = (1ull << b);
-            
-            if (seg->bm[w] & mask) {
-                // Double free detected - log warning and ignore
-                return;
-            } else {
-                seg->bm[w] |= mask;
-                ++seg->free_count;
-                // Update used for consistency
-                seg->used = (seg->blocks - seg->free_count) * class_sz;
+
+            if (return_block_locked(allocator, seg, bi)) {
                 allocator.live_bytes -= a.length;
                 allocator.dead_bytes += a.length;  // Track freed space as dead bytes
                 allocator.frees_to_bitmap++;
             }
-            
+
             // Optional: if seg->free_count == seg->blocks and seg != allocator.active_segment,
             // mark for compaction/retire later
         }
-        
+
         // get_ptr is now inlined in the header for performance
 
         SegmentAllocator::Stats SegmentAllocator::get_stats(uint8_t class_id) const {
@@ -340,6 +715,9 @@ namespace xtree {
                 return Stats{};
             }
             
+            // Magazine traffic is counted per thread; sum it before taking mu
+            const CacheCounters cached = sum_cache_counters(class_id);
+
             const auto& allocator = allocators_[class_id];
             std::lock_guard<std::mutex> lock(allocator.mu);
             
@@ -349,11 +727,21 @@ namespace xtree {
             stats.total_segments = allocator.segments.size();
             stats.active_segments = (allocator.active_segment != nullptr) ? 1 : 0;
             stats.allocs_from_freelist = allocator.allocs_from_freelist;
-            stats.allocs_from_bump = allocator.allocs_from_bump;
-            stats.allocs_from_bitmap = allocator.allocs_from_bitmap;
-            stats.frees_to_bitmap = allocator.frees_to_bitmap;
-            stats.total_allocations = allocator.total_allocations;
-            stats.total_frees = allocator.total_frees;
+            stats.allocs_from_bump = allocator.allocs_from_bump + cached.fresh;
+            stats.allocs_from_bitmap = allocator.allocs_from_bitmap + cached.reused;
+            stats.frees_to_bitmap = allocator.frees_to_bitmap + cached.accepted_frees;
+            stats.total_allocations = allocator.total_allocations + cached.allocs;
+            stats.total_frees = allocator.total_frees + cached.frees;
+            stats.allocs_placed = allocator.allocs_placed;
+
+            // A block parked by a free is dead until it is handed out again
+            const uint64_t class_sz = class_to_size(class_id);
+            if (cached.allocs > cached.accepted_frees) {
+                stats.live_bytes += (cached.allocs - cached.accepted_frees) * class_sz;
+            }
+            if (cached.accepted_frees > cached.reused) {
+                stats.dead_bytes += (cached.accepted_frees - cached.reused) * class_sz;
+            }
             
             return stats;
         }
@@ -372,6 +760,7 @@ namespace xtree {
                 total.frees_to_bitmap += s.frees_to_bitmap;
                 total.total_allocations += s.total_allocations;
                 total.total_frees += s.total_frees;
+                total.allocs_placed += s.allocs_placed;
             }
             return total;
         }
@@ -399,8 +788,15 @@ namespace xtree {
         }
         
         void SegmentAllocator::close_all() {
+            // Blocks cached by threads point into the segments closed below;
+            // a new generation makes every thread drop them untouched
+            cache_generation_.fetch_add(1, std::memory_order_acq_rel);
+
             for (auto& ca : allocators_) {
                 std::lock_guard<std::mutex> g(ca.create_mu);
+                // mu too: flushes and frees touch the segments and free lists
+                // under mu alone
+                std::lock_guard<std::mutex> lock(ca.mu);
 
                 // Unpublish the O(1) table first so concurrent readers fail fast
                 ca.seg_table_size.store(0, std::memory_order_release);
@@ -427,6 +823,8 @@ namespace xtree {
                 ca.segments.clear();
                 ca.free_list.clear();
                 ca.active_segment = nullptr;
+                ca.free_segments.clear();
+                ca.free_segments_hint = 0;
 
                 // Delete the segment table
                 if (table) {
@@ -616,6 +1014,7 @@ namespace xtree {
             
             allocator.segments.push_back(std::move(seg));
             allocator.active_segment = ptr;
+            mark_segment_free_locked(allocator, ptr);
             
             return ptr;
         }
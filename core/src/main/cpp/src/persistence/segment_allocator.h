@@ -17,6 +17,7 @@
  * https://www.gnu.org/licenses/agpl-3.0.html
  */
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
@@ -64,6 +65,36 @@ namespace xtree {
         extern std::atomic<uint64_t> g_segment_lock_count;  // Increment if any lock is taken in get_ptr()
         #endif
 
+        // Index of the lowest set bit; word must be non-zero
+        inline uint32_t ctz64(uint64_t word) noexcept {
+            #if defined(__GNUC__) || defined(__clang__)
+            return static_cast<uint32_t>(__builtin_ctzll(word));
+            #elif defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward64(&bit, word);
+            return static_cast<uint32_t>(bit);
+            #else
+            uint32_t bit = 0;
+            while ((word & 1ull) == 0) { word >>= 1; ++bit; }
+            return bit;
+            #endif
+        }
+
+        // Index of the highest set bit; word must be non-zero
+        inline uint32_t msb64(uint64_t word) noexcept {
+            #if defined(__GNUC__) || defined(__clang__)
+            return static_cast<uint32_t>(63 - __builtin_clzll(word));
+            #elif defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanReverse64(&bit, word);
+            return static_cast<uint32_t>(bit);
+            #else
+            uint32_t bit = 0;
+            while (word >>= 1) ++bit;
+            return bit;
+            #endif
+        }
+
         class SegmentAllocator {
         public:
             // Size classes from config.h
@@ -118,9 +149,22 @@ namespace xtree {
             ~SegmentAllocator();
 
             Allocation allocate(size_t size, NodeKind kind = NodeKind::Internal);
+            // Place the block next to `near` when it is of the same size class
+            // and file type: a free block in near's 64-block run, else the
+            // start of a new run (an entirely free bitmap word) close by, else
+            // any free block in near's segment; otherwise as allocate().
+            // Leaving the rest of a new run free lets the next nodes placed
+            // near the same subtree land in it. Bypasses the thread magazines.
+            Allocation allocate(size_t size, NodeKind kind, const Allocation& near);
             void       free(Allocation& a);  // Non-const now (moves the pin)
             void       close_all();  // Close all segments and mappings for clean shutdown
 
+            // Return the blocks cached by the calling thread to the segment
+            // bitmaps. Cached blocks count as used in the bitmaps (and in
+            // get_segment_utilization()) until handed out or flushed; a
+            // thread's cache is also flushed when the thread exits.
+            void flush_thread_cache();
+
             // Read-only mode for serverless readers
             void set_read_only(bool read_only) { read_only_ = read_only; }
             bool is_read_only() const { return read_only_; }
@@ -142,6 +186,14 @@ namespace xtree {
                                                     uint32_t segment_id,
                                                     uint64_t offset,
                                                     uint32_t length) noexcept;
+
+            // Recovery support: mark the block of a live OT entry as used and
+            // move new segments past it. Recovered segments start out with
+            // every block free, so a writable runtime must restore each live
+            // entry before its first allocation. False if the block can't be
+            // mapped.
+            bool restore_live_block(uint8_t class_id, uint32_t file_id, uint32_t segment_id,
+                                    uint64_t offset, uint32_t length);
             
             // Helper methods for DurableStore's read_node_pinned
             std::string get_file_path(uint32_t file_id, bool is_data_file) const;
@@ -162,6 +214,7 @@ namespace xtree {
                 size_t frees_to_bitmap = 0;       // Frees handled by bitmap
                 size_t total_allocations = 0;     // Total allocation requests
                 size_t total_frees = 0;           // Total free operations
+                size_t allocs_placed = 0;         // Placed next to a hinted block
                 double fragmentation() const {
                     size_t total = live_bytes + dead_bytes;
                     return total > 0 ? static_cast<double>(dead_bytes) / total : 0.0;
@@ -227,6 +280,7 @@ namespace xtree {
                 uint32_t blocks = 0;              // capacity / class_size
                 uint32_t free_count = 0;          // number of free blocks
                 uint32_t max_allocated = 0;       // high water mark of allocated blocks
+                uint32_t scan_word = 0;           // lowest bm word that may have a free bit
                 std::vector<uint64_t> bm;         // 1=free, 0=used
                 
                 bool has_space(size_t size) const {
@@ -271,6 +325,47 @@ namespace xtree {
                     }
                     return -1;
                 }
+
+                // Free bit of word w closest to target, or -1
+                inline int nearest_free_in_word(size_t w, uint32_t target) const noexcept {
+                    const uint64_t word = bm[w];
+                    if (!word) return -1;
+                    const uint64_t base = uint64_t(w) * 64;
+                    if (target < base) return int(base + ctz64(word));
+                    if (target >= base + 64) return int(base + msb64(word));
+                    const uint32_t t = target & 63;
+                    const uint64_t low_mask = t == 63 ? ~0ull : (2ull << t) - 1;  // bits 0..t
+                    const uint64_t below = word & low_mask;
+                    const uint64_t above = word & ~low_mask;
+                    if (!above) return int(base + msb64(below));
+                    if (!below) return int(base + ctz64(above));
+                    const uint32_t lo = msb64(below);
+                    const uint32_t hi = ctz64(above);
+                    return int(base + (t - lo <= hi - t ? lo : hi));
+                }
+
+                // Free bit closest to target, searching outward one word at a
+                // time; with whole_word, only in words that are entirely free
+                // (the start of a new run). -1 if none.
+                inline int find_free_bit_near(uint32_t target, bool whole_word = false) const noexcept {
+                    const size_t n = bm.size();
+                    if (n == 0) return -1;
+                    const size_t w0 = std::min<size_t>(target >> 6, n - 1);
+                    auto usable = [&](size_t w) { return whole_word ? bm[w] == ~0ull : bm[w] != 0; };
+                    for (size_t d = 0; d <= std::max(w0, n - 1 - w0); ++d) {
+                        int best = -1;
+                        uint32_t best_dist = UINT32_MAX;
+                        for (size_t w : {w0 - d, w0 + d}) {
+                            if (w >= n || !usable(w)) continue;   // w0 - d wraps past 0
+                            const int bit = nearest_free_in_word(w, target);
+                            const uint32_t b = static_cast<uint32_t>(bit);
+                            const uint32_t dist = b > target ? b - target : target - b;
+                            if (dist < best_dist) { best = bit; best_dist = dist; }
+                        }
+                        if (best >= 0) return best;
+                    }
+                    return -1;
+                }
                 
                 // REMOVED: get_ptr() - now using MappingManager pins
             };
@@ -291,6 +386,14 @@ namespace xtree {
                 // Active segment for new allocations
                 Segment* active_segment = nullptr;
                 
+                // Free-space index: one bit per segment_id, set while the
+                // segment has free blocks. Replaces scanning all segments.
+                std::vector<uint64_t> free_segments;
+                size_t free_segments_hint = 0;    // lowest word that may have a set bit
+                
+                // Blocks each thread may cache for this class (0 = no magazines)
+                size_t magazine_capacity = 0;
+                
                 // Creation/modification mutex (only for segment creation)
                 mutable std::mutex create_mu;
                 
@@ -310,6 +413,7 @@ namespace xtree {
                 size_t frees_to_bitmap = 0;
                 size_t total_allocations = 0;
                 size_t total_frees = 0;
+                size_t allocs_placed = 0;
                 
                 // Retired segment tables for safe memory reclamation
                 std::vector<void*> retired_tables;
@@ -362,6 +466,57 @@ namespace xtree {
             // Configuration
             StorageConfig config_;
             
+            // ========== Per-thread block magazines ==========
+            // A block reserved in a segment bitmap but not yet handed out
+            struct BlockRef {
+                Segment* seg;
+                uint32_t bit;
+                bool     reused;   // Below max_allocated when taken (or freed back)
+            };
+            
+            // Counters summed into Stats; ThreadCache keeps atomic copies
+            struct CacheCounters {
+                uint64_t allocs = 0;
+                uint64_t fresh = 0;
+                uint64_t reused = 0;
+                uint64_t frees = 0;
+                uint64_t accepted_frees = 0;
+            };
+            
+            struct ThreadCache;        // Defined in segment_allocator.cpp
+            struct ThreadCacheTable;   // thread_local list of a thread's caches
+            
+            static uint64_t next_instance_id();
+            const uint64_t instance_id_ = next_instance_id();  // Never reused, unlike `this`
+            std::atomic<uint64_t> cache_generation_{0};         // Bumped by close_all()
+            mutable std::mutex caches_mu_;
+            std::vector<std::shared_ptr<ThreadCache>> caches_;
+            CacheCounters retired_counters_[NUM_CLASSES];       // From exited threads
+            
+            void init_thread_caches();
+            ThreadCache* thread_cache(bool create = true);
+            void flush_thread_cache(ThreadCache& tc);
+            static void release_thread_cache(ThreadCache& tc);
+            CacheCounters sum_cache_counters(uint8_t class_id) const;
+            
+            // Bitmap helpers (called with ClassAllocator::mu held)
+            size_t take_blocks_locked(ClassAllocator& ca, Segment* seg,
+                                      std::vector<BlockRef>& out, size_t want);
+            size_t reserve_blocks_locked(ClassAllocator& ca, uint8_t class_id, NodeKind kind,
+                                         std::vector<BlockRef>& out, size_t want);
+            BlockRef take_block_locked(ClassAllocator& ca, Segment* seg, uint32_t bit);
+            bool   return_block_locked(ClassAllocator& ca, Segment* seg, uint32_t bit);
+            Segment* find_free_segment_locked(ClassAllocator& ca);
+            static void mark_segment_free_locked(ClassAllocator& ca, const Segment* seg);
+            static void mark_segment_full_locked(ClassAllocator& ca, const Segment* seg);
+            
+            // Lock-free validation of an allocation against the segment table
+            bool locate_block(const Allocation& a, Segment*& seg, uint32_t& bit) const noexcept;
+            Allocation make_allocation(const BlockRef& b, uint8_t class_id) const noexcept;
+            
+            // Take ownership of a segment mapped during recovery
+            void adopt_recovered_segment(ClassAllocator& ca, std::unique_ptr<Segment> seg);
+            
             Segment* allocate_new_segment(uint8_t class_id, NodeKind kind = NodeKind::Internal);
             std::string get_data_file_path(uint32_t file_id) const;
             
@@ -592,7 +747,7 @@ namespace xtree {
                 .store(seg, std::memory_order_release);
 
             // Keep ownership so the segment lives for allocator lifetime.
-            ca.segments.emplace_back(std::move(seg_uptr));
+            adopt_recovered_segment(ca, std::move(seg_uptr));
 
             // Bounds & alignment checks again (defensive).
             if (UNLIKELY(offset < seg->base_offset)) return nullptr;
@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include "snapshot_registry.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace xtree {
+    namespace persist {
+
+        SnapshotRegistry::SnapshotRegistry(MVCCContext& mvcc, size_t retained_commits,
+                                           std::chrono::milliseconds open_timeout)
+            : mvcc_(mvcc), open_timeout_(open_timeout) {
+            set_retained_commits(retained_commits);
+        }
+
+        SnapshotRegistry::~SnapshotRegistry() {
+            mvcc_.release_pin(pin_);
+        }
+
+        void SnapshotRegistry::preserve(uint64_t raw, uint64_t birth_epoch,
+                                        const void* bytes, size_t len) {
+            if (!bytes || !batch_preserved_.insert(raw).second) {
+                return;
+            }
+            // Copy before taking the lock: only this thread writes the node
+            const auto* p = static_cast<const uint8_t*>(bytes);
+            std::vector<uint8_t> copy(p, p + len);
+
+            std::unique_lock<std::shared_mutex> lock(versions_mu_);
+            auto& chain = versions_[raw];
+            const uint64_t start = chain.empty() ? birth_epoch : chain.back().superseded;
+            chain.push_back(Version{start, kOpen, std::move(copy)});
+            version_bytes_ += len;
+        }
+
+        void SnapshotRegistry::note_root_change(const std::string& name, NodeID committed) {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            batch_dirty_.store(true, std::memory_order_seq_cst);
+            auto& history = roots_[name];
+            if (history.empty()) {
+                // Everything before the first recorded commit saw this root
+                history.emplace_back(0, committed);
+            }
+        }
+
+        void SnapshotRegistry::on_commit(uint64_t epoch,
+                                         const std::vector<std::pair<std::string, NodeID>>& roots) {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            for (const auto& [name, id] : roots) {
+                auto& history = roots_[name];
+                if (!history.empty() && history.back().first == epoch) {
+                    history.back().second = id;
+                } else {
+                    history.emplace_back(epoch, id);
+                }
+            }
+            if (retained_) {
+                commits_.push_back(epoch);
+                while (commits_.size() > retained_) commits_.pop_front();
+            }
+            last_commit_ = epoch;
+            ++commit_seq_;
+
+            {
+                std::unique_lock<std::shared_mutex> vlock(versions_mu_);
+                for (uint64_t raw : batch_preserved_) {
+                    auto it = versions_.find(raw);
+                    if (it != versions_.end() && !it->second.empty() &&
+                        it->second.back().superseded == kOpen) {
+                        it->second.back().superseded = epoch;
+                    }
+                }
+                batch_preserved_.clear();
+                collect_locked();
+            }
+
+            batch_dirty_.store(false, std::memory_order_seq_cst);
+            update_protection_locked();
+            committed_.notify_all();
+        }
+
+        uint64_t SnapshotRegistry::acquire(uint64_t epoch) {
+            std::unique_lock<std::mutex> lock(meta_mu_);
+
+            if (epoch != kLatest) {
+                const bool retained = !commits_.empty() && epoch >= commits_.front() &&
+                                      epoch <= last_commit_;
+                if (!retained && pinned_.count(epoch) == 0) {
+                    throw std::runtime_error("SnapshotRegistry: epoch " + std::to_string(epoch) +
+                                             " is not retained");
+                }
+                pinned_.insert(epoch);
+                update_protection_locked();
+                return epoch;
+            }
+
+            // Protect everything before looking at the batch flag. A writer
+            // that set the flag after we read it sees the protection and
+            // copies what it overwrites; one that set it before makes us wait.
+            ++opening_;
+            max_protected_.store(UINT64_MAX, std::memory_order_seq_cst);
+            uint64_t at = mvcc_.get_global_epoch();
+            if (!pin_) {
+                pin_ = mvcc_.acquire_pin();
+            }
+            if (pin_ && pin_->epoch.load(std::memory_order_relaxed) > at) {
+                // Hold reclamation at the epoch we may end up pinning. The
+                // epoch read above may already be reclaimed past; pin_current
+                // re-reads it until the pin is known to cover it.
+                at = mvcc_.pin_current(pin_);
+            }
+            if (batch_dirty_.load(std::memory_order_seq_cst)) {
+                const uint64_t seq = commit_seq_;
+                const bool committed = committed_.wait_for(lock, open_timeout_,
+                                                           [&] { return commit_seq_ != seq; });
+                if (!committed) {
+                    --opening_;
+                    update_protection_locked();
+                    throw std::runtime_error("SnapshotRegistry: timed out waiting for the "
+                                             "in-flight batch to commit");
+                }
+                at = last_commit_;
+            }
+            --opening_;
+            pinned_.insert(at);
+            update_protection_locked();
+            return at;
+        }
+
+        void SnapshotRegistry::release(uint64_t epoch) {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            auto it = pinned_.find(epoch);
+            if (it == pinned_.end()) {
+                return;
+            }
+            pinned_.erase(it);
+            {
+                std::unique_lock<std::shared_mutex> vlock(versions_mu_);
+                collect_locked();
+            }
+            update_protection_locked();
+        }
+
+        NodeID SnapshotRegistry::root_at(const std::string& name, uint64_t epoch,
+                                         const std::function<NodeID()>& current) const {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            auto it = roots_.find(name);
+            if (it == roots_.end() || it->second.empty()) {
+                // Never changed while this store was open
+                return current();
+            }
+            const auto& history = it->second;
+            auto after = std::upper_bound(history.begin(), history.end(), epoch,
+                [](uint64_t e, const std::pair<uint64_t, NodeID>& h) { return e < h.first; });
+            if (after == history.begin()) {
+                return NodeID::invalid();   // the tree did not exist yet
+            }
+            return std::prev(after)->second;
+        }
+
+        bool SnapshotRegistry::find_version(uint64_t raw, uint64_t epoch,
+                                            std::vector<uint8_t>& out) const {
+            auto it = versions_.find(raw);
+            if (it == versions_.end()) {
+                return false;
+            }
+            for (const auto& v : it->second) {
+                if (epoch < v.superseded) {
+                    if (v.start > epoch) {
+                        return false;
+                    }
+                    out.assign(v.bytes.begin(), v.bytes.end());
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void SnapshotRegistry::set_retained_commits(size_t n) {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            if (n != retained_) {
+                // Overwrites before the next commit were not all copied, so
+                // the window starts there
+                commits_.clear();
+            }
+            retained_ = n;
+            {
+                std::unique_lock<std::shared_mutex> vlock(versions_mu_);
+                collect_locked();
+            }
+            update_protection_locked();
+        }
+
+        size_t SnapshotRegistry::retained_commits() const {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            return retained_;
+        }
+
+        uint64_t SnapshotRegistry::oldest_retained() const {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            return commits_.empty() ? kLatest : commits_.front();
+        }
+
+        size_t SnapshotRegistry::active_snapshots() const {
+            std::lock_guard<std::mutex> lock(meta_mu_);
+            return pinned_.size();
+        }
+
+        size_t SnapshotRegistry::shadow_count() const {
+            std::shared_lock<std::shared_mutex> lock(versions_mu_);
+            size_t n = 0;
+            for (const auto& kv : versions_) n += kv.second.size();
+            return n;
+        }
+
+        size_t SnapshotRegistry::shadow_bytes() const {
+            std::shared_lock<std::shared_mutex> lock(versions_mu_);
+            return version_bytes_;
+        }
+
+        bool SnapshotRegistry::needed_locked(uint64_t start, uint64_t superseded) const {
+            if (superseded == kOpen) {
+                return true;
+            }
+            if (!commits_.empty() && superseded > commits_.front()) {
+                return true;
+            }
+            auto it = pinned_.lower_bound(start);
+            return it != pinned_.end() && *it < superseded;
+        }
+
+        void SnapshotRegistry::collect_locked() {
+            for (auto it = versions_.begin(); it != versions_.end(); ) {
+                auto& chain = it->second;
+                auto keep = chain.begin();
+                for (auto v = chain.begin(); v != chain.end(); ++v) {
+                    if (needed_locked(v->start, v->superseded)) {
+                        if (keep != v) *keep = std::move(*v);
+                        ++keep;
+                    } else {
+                        version_bytes_ -= v->bytes.size();
+                    }
+                }
+                chain.erase(keep, chain.end());
+                it = chain.empty() ? versions_.erase(it) : std::next(it);
+            }
+
+            // Root history: keep the entry in force at the oldest epoch a
+            // reader can still open, and everything after it
+            uint64_t oldest = last_commit_;
+            if (!pinned_.empty()) oldest = std::min(oldest, *pinned_.begin());
+            if (!commits_.empty()) oldest = std::min(oldest, commits_.front());
+            for (auto& kv : roots_) {
+                auto& history = kv.second;
+                size_t first = 0;
+                while (first + 1 < history.size() && history[first + 1].first <= oldest) {
+                    ++first;
+                }
+                history.erase(history.begin(), history.begin() + first);
+            }
+        }
+
+        void SnapshotRegistry::update_protection_locked() {
+            uint64_t oldest = UINT64_MAX;
+            if (!pinned_.empty()) oldest = *pinned_.begin();
+            if (!commits_.empty()) oldest = std::min(oldest, commits_.front());
+
+            if (oldest != UINT64_MAX && !pin_) {
+                pin_ = mvcc_.acquire_pin();
+            }
+            if (pin_) {
+                // oldest is already covered, by this pin or by the one taken
+                // when its snapshot opened
+                pin_->epoch.store(oldest, std::memory_order_seq_cst);
+            }
+
+            uint64_t protect = pinned_.empty() ? 0 : *pinned_.rbegin();
+            if (opening_ > 0 || retained_ > 0) {
+                protect = UINT64_MAX;
+            }
+            max_protected_.store(protect, std::memory_order_seq_cst);
+        }
+
+    } // namespace persist
+} // namespace xtree
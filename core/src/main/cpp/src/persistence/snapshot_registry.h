@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+/*
+ * Point-in-time read snapshots for a DurableStore.
+ *
+ * A snapshot pins a committed epoch E and reads the tree exactly as it was
+ * after the commit of E, while the writer keeps committing. Buckets are
+ * republished in place (publishDirtyBuckets serializes straight into the
+ * mapped node), so the bytes of an old version are gone once the writer
+ * touches the node. The registry therefore keeps a heap copy ("shadow") of
+ * a committed node version just before it is first overwritten or freed in
+ * a batch, but only while some snapshot could still read that version:
+ *
+ *   - Each shadow covers [start, superseded): start is when the copied
+ *     version became current, superseded the commit that replaced it.
+ *   - A reader at E uses the shadow whose range holds E, else the node's
+ *     current bytes if its OT entry is visible at E.
+ *   - A shadow no pinned or retained epoch falls into is dropped at the next
+ *     commit or release. With no snapshots open nothing is copied; writers
+ *     pay one flag store and one atomic load per overwritten node.
+ *
+ * Snapshots also hold an MVCCContext pin at their epoch, so the reclaimer
+ * keeps nodes retired after E. Epochs that are not pinned are reclaimed as
+ * before: snapshots never block the writer or reclamation beyond their own
+ * epoch.
+ *
+ * Opening a snapshot at the latest epoch while a batch is half-written waits
+ * for that batch to commit (bounded by DurabilityPolicy::snapshot_open_timeout)
+ * and pins its epoch, since nodes the batch already overwrote were not
+ * copied. With snapshot_retained_commits = N every overwrite is copied and
+ * any of the last N commits can be opened by epoch, not only pinned ones.
+ *
+ * Root history per catalog name is recorded at commit, so root_at() answers
+ * for any epoch a snapshot can hold.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "mvcc_context.h"
+#include "node_id.hpp"
+
+namespace xtree {
+    namespace persist {
+
+        class SnapshotRegistry {
+        public:
+            static constexpr uint64_t kLatest = UINT64_MAX;
+
+            SnapshotRegistry(MVCCContext& mvcc, size_t retained_commits,
+                             std::chrono::milliseconds open_timeout);
+            ~SnapshotRegistry();
+
+            SnapshotRegistry(const SnapshotRegistry&) = delete;
+            SnapshotRegistry& operator=(const SnapshotRegistry&) = delete;
+
+            // --- Writer side (one writer per store, as for tl_batch()) ---
+
+            // Called before a committed node born at birth_epoch is overwritten
+            // or freed. Marks the batch in flight and returns true if the
+            // current bytes must be handed to preserve() first.
+            bool must_preserve(uint64_t birth_epoch) {
+                if (!batch_dirty_.load(std::memory_order_relaxed)) {
+                    batch_dirty_.store(true, std::memory_order_seq_cst);
+                }
+                return birth_epoch != 0 &&
+                       birth_epoch <= max_protected_.load(std::memory_order_seq_cst);
+            }
+
+            // Copy the node's current bytes. Once per node per batch.
+            void preserve(uint64_t raw, uint64_t birth_epoch, const void* bytes, size_t len);
+
+            // A catalog root is about to change; committed is its value before
+            void note_root_change(const std::string& name, NodeID committed);
+
+            // Start of commit(): the batch is in flight even if nothing was overwritten
+            void begin_commit() { batch_dirty_.store(true, std::memory_order_seq_cst); }
+
+            // The batch is durable at epoch with these catalog roots
+            void on_commit(uint64_t epoch, const std::vector<std::pair<std::string, NodeID>>& roots);
+
+            bool batch_dirty() const { return batch_dirty_.load(std::memory_order_acquire); }
+
+            // --- Reader side ---
+
+            // Pin epoch (kLatest = the newest committed one) and return it.
+            // Throws std::runtime_error if epoch is no longer retained, or if
+            // the in-flight batch does not commit within the open timeout.
+            uint64_t acquire(uint64_t epoch = kLatest);
+            void release(uint64_t epoch);
+
+            // Root of the named tree at epoch. current() yields the catalog's
+            // root and is only called when the name has no recorded history.
+            NodeID root_at(const std::string& name, uint64_t epoch,
+                           const std::function<NodeID()>& current) const;
+
+            // Readers hold this while resolving a node at an epoch, so the
+            // writer cannot overwrite the bytes between the shadow lookup and
+            // the copy
+            std::shared_lock<std::shared_mutex> lock_versions() const {
+                return std::shared_lock<std::shared_mutex>(versions_mu_);
+            }
+            // The shadowed version of raw visible at epoch (caller holds lock_versions())
+            bool find_version(uint64_t raw, uint64_t epoch, std::vector<uint8_t>& out) const;
+
+            // --- Retention ---
+
+            // Keep the last n commits openable by epoch. Takes effect from the
+            // next commit; 0 leaves only pinned epochs.
+            void set_retained_commits(size_t n);
+            size_t retained_commits() const;
+            uint64_t oldest_retained() const;  // kLatest while nothing is retained
+
+            // --- Stats ---
+            size_t active_snapshots() const;
+            size_t shadow_count() const;
+            size_t shadow_bytes() const;
+
+        private:
+            static constexpr uint64_t kOpen = UINT64_MAX;  // superseded by the in-flight batch
+
+            struct Version {
+                uint64_t start;
+                uint64_t superseded;
+                std::vector<uint8_t> bytes;
+            };
+
+            bool needed_locked(uint64_t start, uint64_t superseded) const;
+            void collect_locked();          // meta_mu_ and versions_mu_ held
+            void update_protection_locked();
+
+            MVCCContext& mvcc_;
+            MVCCContext::Pin* pin_ = nullptr;   // held at the oldest pinned or retained epoch
+            const std::chrono::milliseconds open_timeout_;
+
+            // Writer fast path
+            std::atomic<bool> batch_dirty_{false};
+            std::atomic<uint64_t> max_protected_{0};   // newest epoch a reader may hold
+
+            // Snapshots, retention and root history
+            mutable std::mutex meta_mu_;
+            std::condition_variable committed_;
+            std::multiset<uint64_t> pinned_;
+            size_t opening_ = 0;            // acquires waiting to learn their epoch
+            size_t retained_ = 0;
+            std::deque<uint64_t> commits_;  // last retained_ commit epochs
+            uint64_t last_commit_ = 0;
+            uint64_t commit_seq_ = 0;
+            std::unordered_map<std::string, std::vector<std::pair<uint64_t, NodeID>>> roots_;
+
+            // Shadows, oldest first per node (lock order: meta_mu_, then versions_mu_)
+            mutable std::shared_mutex versions_mu_;
+            std::unordered_map<uint64_t, std::vector<Version>> versions_;
+            size_t version_bytes_ = 0;
+            std::unordered_set<uint64_t> batch_preserved_;   // writer thread only
+        };
+
+    } // namespace persist
+} // namespace xtree
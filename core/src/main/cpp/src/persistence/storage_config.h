@@ -22,6 +22,7 @@
 #include <cstdlib>
 #include <string>
 #include "config.h"  // For defaults
+#include "../memmgr/huge_page_arena.hpp"
 
 namespace xtree {
 namespace persist {
@@ -39,12 +40,15 @@ struct StorageConfig {
     // Memory budget for mmap
     size_t max_mmap_memory     = 4ULL << 30;               // Default 4GB (0 = unlimited)
     float mmap_eviction_headroom = 0.1f;                   // 10% hysteresis
+    bool huge_pages            = false;                    // 2MB-aligned windows with MADV_HUGEPAGE
 
     // Checkpoint policy
     size_t checkpoint_keep_count = 2;                      // Keep N checkpoints (reduced for space)
 
     // Segment allocation
     size_t segment_alignment   = segment::kSegmentAlignment; // Default 4KB
+    size_t thread_cache_bytes  = segment::kThreadCacheBytes; // Per-thread, per-class (0 = off)
+    bool placement_hints       = true;                     // Place nodes next to a hinted node
 
     // File handle limits
     size_t max_open_files      = 256;                      // Max FDs to use
@@ -75,10 +79,22 @@ struct StorageConfig {
             cfg.mmap_eviction_headroom = std::stof(env);
         }
 
+        if (const char* env = std::getenv("XTREE_HUGE_PAGES")) {
+            cfg.huge_pages = parseHugePages(env);
+        }
+
         if (const char* env = std::getenv("XTREE_CHECKPOINT_KEEP_COUNT")) {
             cfg.checkpoint_keep_count = std::stoull(env);
         }
 
+        if (const char* env = std::getenv("XTREE_THREAD_CACHE_BYTES")) {
+            cfg.thread_cache_bytes = parseMemorySize(env);
+        }
+
+        if (const char* env = std::getenv("XTREE_PLACEMENT_HINTS")) {
+            cfg.placement_hints = (std::string(env) != "0" && std::string(env) != "false");
+        }
+
         if (const char* env = std::getenv("XTREE_MAX_OPEN_FILES")) {
             cfg.max_open_files = std::stoull(env);
         }
@@ -90,6 +106,12 @@ struct StorageConfig {
         return cfg;
     }
 
+    // XTREE_HUGE_PAGES, parsed as for the in-memory arena: any mode but Off
+    // turns huge pages on (hugetlb only changes how the arena backs chunks)
+    static bool parseHugePages(const char* str) {
+        return HugePageArena::parse_mode(str) != HugePageArena::Mode::Off;
+    }
+
     // Parse memory size with suffixes (e.g., "4GB", "512MB", "1024KB")
     static size_t parseMemorySize(const char* str) {
         std::string val(str);
@@ -165,6 +187,10 @@ struct StorageConfig {
             // Headroom must be in [0%, 50%]
             return false;
         }
+        if (huge_pages && mmap_window_size % sys_config::kHugePageSize != 0) {
+            // Windows must start on huge page boundaries
+            return false;
+        }
         return true;
     }
 };
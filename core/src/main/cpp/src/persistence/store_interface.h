@@ -19,7 +19,9 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 #include "node_id.hpp"          // NodeID
 #include "ot_entry.h"           // NodeKind
 #include "mapping_manager.h"    // MappingManager::Pin
@@ -37,6 +39,16 @@ namespace xtree {
             size_t  capacity;  // reserved size in bytes
         };
 
+        // Where a new node should go: next to a related node (its parent, a
+        // sibling, a record of the same leaf) when space allows, so a
+        // subtree's nodes share segments and pages. Stores may ignore it.
+        struct PlacementHint {
+            NodeID near = NodeID::invalid();
+        };
+
+        // acquire_snapshot() argument: the newest committed epoch
+        constexpr uint64_t kLatestSnapshot = UINT64_MAX;
+
         // Reason codes for retire operations (for debugging)
         enum class RetireReason : uint8_t {
             Unknown = 0,
@@ -54,6 +66,10 @@ namespace xtree {
 
             // 1) Space
             virtual AllocResult allocate_node(size_t min_len, NodeKind kind) = 0;
+            virtual AllocResult allocate_node(size_t min_len, NodeKind kind, const PlacementHint& hint) {
+                (void)hint;
+                return allocate_node(min_len, kind);
+            }
 
             // 2) Publish a new node version (bytes must be fully written)
             virtual void publish_node(NodeID id, const void* data, size_t len) = 0;
@@ -84,6 +100,11 @@ namespace xtree {
                 throw std::runtime_error("read_node_pinned not supported by this store");
             }
 
+            // Read-ahead hint: id is about to be read. Stores backed by mapped
+            // files start paging its bytes in without blocking; the default
+            // ignores the hint
+            virtual void prefetch_node(NodeID id) const { (void)id; }
+
             // 4) Lifecycle
             virtual void retire_node(NodeID id,
                                     uint64_t retire_epoch,
@@ -134,6 +155,28 @@ namespace xtree {
                 if (out_is_staged) *out_is_staged = false;
                 return is_node_present(id);
             }
+
+            // 10) Point-in-time reads. A snapshot pins a committed epoch; until
+            // it is released, root_at() and read_node_at() return the tree as
+            // it was at that epoch while writers keep committing.
+            // Default throws - override in stores that keep old versions
+            virtual uint64_t acquire_snapshot(uint64_t epoch = kLatestSnapshot) {
+                (void)epoch;
+                throw std::runtime_error("read snapshots not supported by this store");
+            }
+            virtual void release_snapshot(uint64_t epoch) { (void)epoch; }
+
+            virtual NodeID root_at(uint64_t epoch, std::string_view name = {}) const {
+                (void)epoch; (void)name;
+                throw std::runtime_error("read snapshots not supported by this store");
+            }
+
+            // Copies the node's bytes as of epoch into out. False if the node
+            // was not visible at that epoch.
+            virtual bool read_node_at(NodeID id, uint64_t epoch, std::vector<uint8_t>& out) const {
+                (void)id; (void)epoch; (void)out;
+                throw std::runtime_error("read snapshots not supported by this store");
+            }
         };
 
 
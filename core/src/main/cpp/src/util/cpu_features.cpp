@@ -5,6 +5,8 @@
  */
 
 #include "cpu_features.h"
+#include <cstdlib>
+#include <cstring>
 
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -21,6 +23,43 @@ namespace xtree {
 
 CPUFeatures::CPUFeatures() {
     detect_features();
+
+    // XTREE_SIMD_MAX_TIER=scalar|sse2|avx2 caps dispatch below what the CPU
+    // offers, e.g. on parts where 512-bit code lowers the core clock
+    if (const char* cap = std::getenv("XTREE_SIMD_MAX_TIER")) {
+        const bool scalar = std::strcmp(cap, "scalar") == 0;
+        if (scalar || std::strcmp(cap, "sse2") == 0 || std::strcmp(cap, "avx2") == 0) {
+            has_avx512f = has_avx512dq = has_avx512bw = has_avx512vl = false;
+        }
+        if (scalar || std::strcmp(cap, "sse2") == 0) {
+            has_avx = has_avx2 = false;
+        }
+        if (scalar) {
+            has_sse2 = has_sse42 = has_neon = false;
+        }
+    }
+}
+
+bool CPUFeatures::supports(SimdTier tier) const {
+    switch (tier) {
+        case SimdTier::SCALAR: return true;
+        case SimdTier::SSE2:   return has_sse2;
+        case SimdTier::AVX2:   return has_avx2;
+        case SimdTier::AVX512: return has_avx512();
+        case SimdTier::NEON:   return has_neon;
+    }
+    return false;
+}
+
+const char* simd_tier_name(SimdTier tier) {
+    switch (tier) {
+        case SimdTier::SCALAR: return "Scalar";
+        case SimdTier::SSE2:   return "SSE2";
+        case SimdTier::AVX2:   return "AVX2";
+        case SimdTier::AVX512: return "AVX-512";
+        case SimdTier::NEON:   return "NEON";
+    }
+    return "unknown";
 }
 
 void CPUFeatures::detect_features() {
@@ -48,31 +87,55 @@ void CPUFeatures::detect_features() {
     __cpuid(info, 0);
     int max_id = info[0];
     
+    bool os_zmm = false;
     if (max_id >= 1) {
         __cpuid(info, 1);
         has_sse2 = (info[3] & (1 << 26)) != 0;
         has_sse42 = (info[2] & (1 << 20)) != 0;
         has_avx = (info[2] & (1 << 28)) != 0;
+        // XCR0 bits 1,2 (XMM/YMM) and 5-7 (opmask, ZMM) must all be OS-enabled
+        if ((info[2] & (1 << 27)) != 0) {
+            os_zmm = (_xgetbv(0) & 0xE6) == 0xE6;
+        }
     }
     
     if (max_id >= 7) {
         __cpuidex(info, 7, 0);
         has_avx2 = (info[1] & (1 << 5)) != 0;
+        if (os_zmm) {
+            has_avx512f = (info[1] & (1 << 16)) != 0;
+            has_avx512dq = (info[1] & (1 << 17)) != 0;
+            has_avx512bw = (info[1] & (1 << 30)) != 0;
+            has_avx512vl = (info[1] & (1u << 31)) != 0;
+        }
     }
 #else
     unsigned int eax, ebx, ecx, edx;
     unsigned int max_id = __get_cpuid_max(0, nullptr);
     
+    bool os_zmm = false;
     if (max_id >= 1) {
         __get_cpuid(1, &eax, &ebx, &ecx, &edx);
         has_sse2 = (edx & (1 << 26)) != 0;
         has_sse42 = (ecx & (1 << 20)) != 0;
         has_avx = (ecx & (1 << 28)) != 0;
+        // XCR0 bits 1,2 (XMM/YMM) and 5-7 (opmask, ZMM) must all be OS-enabled
+        if ((ecx & (1 << 27)) != 0) {
+            unsigned int xcr0_lo, xcr0_hi;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            os_zmm = (xcr0_lo & 0xE6) == 0xE6;
+        }
     }
     
     if (max_id >= 7) {
         __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
         has_avx2 = (ebx & (1 << 5)) != 0;
+        if (os_zmm) {
+            has_avx512f = (ebx & (1 << 16)) != 0;
+            has_avx512dq = (ebx & (1 << 17)) != 0;
+            has_avx512bw = (ebx & (1 << 30)) != 0;
+            has_avx512vl = (ebx & (1u << 31)) != 0;
+        }
     }
 #endif
 
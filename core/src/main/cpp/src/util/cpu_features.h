@@ -6,18 +6,41 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace xtree {
 
+// Instruction-set tiers a kernel can be built for
+enum class SimdTier : uint8_t {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512,   // F + VL + BW + DQ
+    NEON
+};
+
+const char* simd_tier_name(SimdTier tier);
+
 // CPU feature flags
 struct CPUFeatures {
     bool has_sse2 = false;
     bool has_sse42 = false;
     bool has_avx = false;
     bool has_avx2 = false;
+    bool has_avx512f = false;
+    bool has_avx512dq = false;
+    bool has_avx512bw = false;
+    bool has_avx512vl = false;
     bool has_neon = false;
-    
+
+    // Set only when the OS also saves the opmask and ZMM state
+    bool has_avx512() const {
+        return has_avx512f && has_avx512dq && has_avx512bw && has_avx512vl;
+    }
+
+    bool supports(SimdTier tier) const;
+
     static const CPUFeatures& get();
     
 private:
@@ -29,10 +52,52 @@ private:
 typedef bool (*intersects_func_t)(const int32_t* box1, const int32_t* box2, int dimensions);
 typedef void (*expand_func_t)(int32_t* target, const int32_t* source, int dimensions);
 typedef void (*expand_point_func_t)(int32_t* box, const double* point, int dimensions);
+typedef bool (*contains_func_t)(const int32_t* outer, const int32_t* inner, int dimensions);
+
+// Float boxes in KeyMBR::data() layout, same arithmetic as KeyMBR::area()
+// and KeyMBR::overlap()
+typedef double (*area_func_t)(const float* box, int dimensions);
+typedef double (*overlap_func_t)(const float* box1, const float* box2, int dimensions);
+
+// Query x child overlap matrix for batched search. Child boxes are transposed:
+// mins[d * stride + c] / maxs[d * stride + c], stride a multiple of 8 with
+// NaN padding (never matches). Query active[i] is the float box at
+// queries + 2 * dimensions * active[i] (min/max per axis, KeyMBR::data()
+// layout). Row i of out is (stride + 63) / 64 words; bit c is set when child
+// c overlaps that query, bounds inclusive.
+typedef void (*match_matrix_func_t)(const float* queries, const uint32_t* active, size_t nactive,
+                                    const float* mins, const float* maxs, size_t stride,
+                                    int dimensions, uint64_t* out);
+
+/**
+ * ifunc-style dispatch table entry: one build of a kernel and the tier it
+ * needs. select_kernel() returns the first entry the running CPU supports,
+ * so tables list the widest tier first and end with SCALAR.
+ */
+template< typename Fn >
+struct KernelVariant {
+    SimdTier tier;
+    Fn fn;
+};
+
+template< typename Fn, size_t N >
+Fn select_kernel(const KernelVariant<Fn> (&variants)[N]) {
+    const CPUFeatures& features = CPUFeatures::get();
+    for (const KernelVariant<Fn>& v : variants) {
+        if (features.supports(v.tier)) {
+            return v.fn;
+        }
+    }
+    return variants[N - 1].fn;
+}
 
 // Get optimal function pointers based on CPU features
 intersects_func_t get_optimal_intersects_func();
+contains_func_t get_optimal_contains_func();
 expand_func_t get_optimal_expand_func();
 expand_point_func_t get_optimal_expand_point_func();
+area_func_t get_optimal_area_func();
+overlap_func_t get_optimal_overlap_func();
+match_matrix_func_t get_optimal_match_matrix_func();
 
 } // namespace xtree
\ No newline at end of file
@@ -19,6 +19,9 @@
 
 #include "log.h"
 #include "logmanager.h"
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 
 namespace xtree {
 
@@ -61,53 +64,343 @@ namespace xtree {
         }
     }
 
-    void Logger::flush(Tee *t) {
-        string msg = ss.str();
-        string threadName = getThreadName();
-        const char * type = logLevelToString(logLevel);
+    // ========== Formatting ==========
 
-        ostringstream oss;
-        oss << time_t_to_String();
-        oss << " [" << getThreadName() << "] ";
+    namespace {
 
-        // Always show log level
-        oss << "[" << type << "] ";
-        
-        for ( int i=0; i<indent; i++ )
-            oss << '\t';
+        // Fixed part of a record; the encoded arguments follow
+        struct RecordHeader {
+            uint32_t size;      // Header + payload, rounded up to 8 (kWrapMarker = skip to ring start)
+            uint32_t len;       // Payload bytes
+            int64_t  time;
+            uint8_t  level;
+            uint8_t  indent;
+            uint8_t  reserved[6];
+        };
+        static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout");
+        constexpr uint32_t kWrapMarker = ~uint32_t{0};
 
-        oss << msg << '\n';  // Add newline for auto-flushed messages
+        template<typename T>
+        T take(const char*& p) {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return v;
+        }
 
-        std::lock_guard<boost::mutex> lk(sm);
-        string out = oss.str();
+        // Appends "<time> [<thread>] [<LEVEL>] <tabs><message>\n" to out
+        void formatRecord(const RecordHeader& h, const char* payload,
+                          const string& threadName, string& out) {
+            static thread_local ostringstream os;
+            static thread_local const ostringstream pristine;
+            os.str("");
+            os.clear();
+            os.copyfmt(pristine);   // Manipulators apply to one message only
 
-        if( t ) t->write(logLevel,out);
+            char tbuf[26];
+            time_t t = static_cast<time_t>(h.time);
+#if defined(_WIN32)
+            ctime_s(tbuf, sizeof(tbuf), &t);
+#else
+            ctime_r(&t, tbuf);
+#endif
+            tbuf[24] = 0; // don't want the \n
+            os << tbuf << " [" << threadName << "] "
+               << "[" << logLevelToString(static_cast<LogLevel>(h.level)) << "] ";
+            for (int i = 0; i < h.indent; i++)
+                os << '\t';
 
-        if (logfile) {
-            // Check if logfile is actually stderr
-            if (logfile == stderr) {
-                // It's stderr, just write to it
-                fprintf(stderr, "%s", oss.str().c_str());
-                fflush(stderr);
-            } else {
+            const char* p = payload;
+            const char* end = payload + h.len;
+            while (p < end) {
+                switch (static_cast<Logger::Arg>(*p++)) {
+                case Logger::Arg::Str: {
+                    const uint32_t n = take<uint32_t>(p);
+                    os.write(p, n);
+                    p += n;
+                    break;
+                }
+                case Logger::Arg::Char:     os << take<char>(p); break;
+                case Logger::Arg::Int32:    os << take<int>(p); break;
+                case Logger::Arg::Int:      os << take<long long>(p); break;
+                case Logger::Arg::UInt:     os << take<unsigned long long>(p); break;
+                case Logger::Arg::Double:   os << take<double>(p); break;
+                case Logger::Arg::Bool:     os << take<bool>(p); break;
+                case Logger::Arg::Ptr:      os << take<const void*>(p); break;
+                case Logger::Arg::IosManip: os << take<ios_base& (*)(ios_base&)>(p); break;
+                default: p = end; break;    // Corrupt record - stop
+                }
+            }
+            os << '\n';  // Add newline for auto-flushed messages
+            out += os.str();
+        }
+
+        // Must be called with Logger::sm held
+        void writeLocked(FILE* logfile, const string& out) {
+            if (logfile && logfile != stderr) {
                 // Write ONLY to the log file when it's set
-                if(fprintf(logfile, "%s", oss.str().c_str())>=0) {
+                if (fwrite(out.data(), 1, out.size(), logfile) == out.size()) {
                     fflush(logfile);
                 }
                 else {
                     int x = errno;
                     cerr << "Failed to write to logfile: " << errnoWithDescription(x) << ": " << out << endl;
                 }
+            } else {
+                // If no logfile is set, output to stderr
+                fwrite(out.data(), 1, out.size(), stderr);
+                fflush(stderr);
+            }
+        }
+
+    } // namespace
+
+    // ========== Async ring buffers ==========
+
+    /**
+     * Single-producer/single-consumer byte ring owned by one thread's Logger.
+     * The producer only advances head, the drain thread only advances tail.
+     */
+    struct LogRing {
+        explicit LogRing(size_t capacity, string name)
+            : buf(capacity), mask(capacity - 1), threadName(std::move(name)) {}
+
+        std::vector<char> buf;
+        const size_t mask;
+        const string threadName;
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+    };
+
+    namespace {
+
+        struct AsyncState {
+            std::mutex mu;                       // Guards rings and thread lifecycle
+            std::mutex drain_mu;                 // One drain pass at a time
+            std::condition_variable cv;
+            std::vector<std::shared_ptr<LogRing>> rings;
+            std::thread drainer;
+            std::atomic<bool> enabled{false};
+            std::atomic<bool> running{false};
+            std::atomic<uint64_t> stalls{0};
+            size_t ringBytes = Logger::kDefaultRingBytes;
+
+            ~AsyncState() {
+                // Process exit: the drain thread writes what is queued and exits
+                enabled.store(false, std::memory_order_release);
+                running.store(false, std::memory_order_release);
+                cv.notify_all();
+                if (drainer.joinable()) drainer.join();
+            }
+        };
+
+        AsyncState& asyncState() {
+            static AsyncState state;
+            return state;
+        }
+
+        size_t roundUpPow2(size_t v) {
+            size_t p = 1;
+            while (p < v) p <<= 1;
+            return p;
+        }
+
+        // Format everything queued in one ring; returns the new tail
+        uint64_t drainRing(LogRing& r, string& out) {
+            uint64_t t = r.tail.load(std::memory_order_relaxed);
+            const uint64_t h = r.head.load(std::memory_order_acquire);
+            const size_t cap = r.buf.size();
+            while (t < h) {
+                const size_t pos = t & r.mask;
+                RecordHeader hdr;
+                std::memcpy(&hdr.size, &r.buf[pos], sizeof(hdr.size));
+                if (hdr.size == kWrapMarker) {
+                    t += cap - pos;
+                    continue;
+                }
+                std::memcpy(&hdr, &r.buf[pos], sizeof(hdr));
+                formatRecord(hdr, &r.buf[pos + sizeof(hdr)], r.threadName, out);
+                t += hdr.size;
             }
-        } else {
-            // If no logfile is set, output to stderr
-            fprintf(stderr, "%s", oss.str().c_str());
-            fflush(stderr);
+            return t;
         }
+
+    } // namespace
+
+    // One pass over all rings; returns true if anything was written
+    bool Logger::drainOnce() {
+        auto& st = asyncState();
+        std::lock_guard<std::mutex> drain_lk(st.drain_mu);
+        std::vector<std::shared_ptr<LogRing>> rings;
+        {
+            std::lock_guard<std::mutex> lk(st.mu);
+            // Drop rings whose thread has exited and that are fully drained
+            st.rings.erase(std::remove_if(st.rings.begin(), st.rings.end(),
+                [](const std::shared_ptr<LogRing>& r) {
+                    return r.use_count() == 1 &&
+                           r->tail.load(std::memory_order_relaxed) ==
+                           r->head.load(std::memory_order_acquire);
+                }), st.rings.end());
+            rings = st.rings;
+        }
+
+        string out;
+        std::vector<uint64_t> tails(rings.size());
+        for (size_t i = 0; i < rings.size(); ++i) {
+            tails[i] = drainRing(*rings[i], out);
+        }
+        if (out.empty()) return false;
+        {
+            std::lock_guard<boost::mutex> lk(sm);
+            writeLocked(logfile, out);
+        }
+        // Release ring space only once the text is written, so syncAsync()
+        // can wait on head == tail
+        for (size_t i = 0; i < rings.size(); ++i) {
+            rings[i]->tail.store(tails[i], std::memory_order_release);
+        }
+        return true;
+    }
+
+    void Logger::startAsync(size_t ring_bytes) {
+        auto& st = asyncState();
+        std::lock_guard<std::mutex> lk(st.mu);
+        if (st.running.load()) return;
+        // A ring must hold several maximal records plus a wrap gap
+        st.ringBytes = roundUpPow2(std::max(ring_bytes, 4 * (kMaxRecordBytes + sizeof(RecordHeader))));
+        st.running.store(true, std::memory_order_release);
+        st.drainer = std::thread([&st]{
+            while (st.running.load(std::memory_order_acquire)) {
+                if (!drainOnce()) {
+                    std::unique_lock<std::mutex> lk(st.mu);
+                    st.cv.wait_for(lk, std::chrono::milliseconds(2));
+                }
+            }
+            drainOnce();
+        });
+        st.enabled.store(true, std::memory_order_release);
+    }
+
+    void Logger::stopAsync() {
+        auto& st = asyncState();
+        std::thread drainer;
+        {
+            std::lock_guard<std::mutex> lk(st.mu);
+            if (!st.running.load()) return;
+            st.enabled.store(false, std::memory_order_release);
+            st.running.store(false, std::memory_order_release);
+            drainer = std::move(st.drainer);
+        }
+        st.cv.notify_all();
+        if (drainer.joinable()) drainer.join();
+        // Everything enqueued before the flag flipped
+        drainOnce();
+    }
+
+    bool Logger::asyncEnabled() {
+        return asyncState().enabled.load(std::memory_order_acquire);
+    }
+
+    uint64_t Logger::asyncStalls() {
+        return asyncState().stalls.load(std::memory_order_relaxed);
+    }
+
+    void Logger::syncAsync() {
+        auto& st = asyncState();
+        if (!st.running.load(std::memory_order_acquire)) return;
+        std::vector<std::pair<std::shared_ptr<LogRing>, uint64_t>> targets;
+        {
+            std::lock_guard<std::mutex> lk(st.mu);
+            for (auto& r : st.rings) {
+                targets.emplace_back(r, r->head.load(std::memory_order_acquire));
+            }
+        }
+        for (auto& [ring, target] : targets) {
+            while (ring->tail.load(std::memory_order_acquire) < target &&
+                   st.running.load(std::memory_order_acquire)) {
+                st.cv.notify_one();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    // ========== Flush ==========
+
+    void Logger::writeSync(Tee *t) {
+        RecordHeader hdr{};
+        hdr.len = static_cast<uint32_t>(rec_len_);
+        hdr.time = static_cast<int64_t>(time(0));
+        hdr.level = static_cast<uint8_t>(logLevel);
+        hdr.indent = static_cast<uint8_t>(std::max(0, std::min(indent, 255)));
+
+        string out;
+        formatRecord(hdr, rec_, getThreadName(), out);
+
+        std::lock_guard<boost::mutex> lk(sm);
+        if( t ) t->write(logLevel,out);
+        writeLocked(logfile, out);
+    }
+
+    void Logger::flush(Tee *t) {
+        auto& st = asyncState();
+        if (t || !st.enabled.load(std::memory_order_acquire)) {
+            // Tee output is synchronous
+            writeSync(t);
+            _init();
+            return;
+        }
+
+        if (!ring_ || ring_->buf.size() != st.ringBytes) {
+            std::lock_guard<std::mutex> lk(st.mu);
+            ring_ = std::make_shared<LogRing>(st.ringBytes, getThreadName());
+            st.rings.push_back(ring_);
+        }
+        LogRing& r = *ring_;
+
+        const size_t cap = r.buf.size();
+        const uint32_t size = static_cast<uint32_t>((sizeof(RecordHeader) + rec_len_ + 7) & ~size_t{7});
+        uint64_t h = r.head.load(std::memory_order_relaxed);
+        const size_t pos = h & r.mask;
+        const size_t gap = (cap - pos < size) ? cap - pos : 0;  // Skip to ring start
+
+        // Wait for the drain thread if the ring is full
+        if (h + gap + size - r.tail.load(std::memory_order_acquire) > cap) {
+            st.stalls.fetch_add(1, std::memory_order_relaxed);
+            while (h + gap + size - r.tail.load(std::memory_order_acquire) > cap) {
+                if (!st.running.load(std::memory_order_acquire)) {
+                    writeSync(nullptr);  // Async stopped underneath us
+                    _init();
+                    return;
+                }
+                st.cv.notify_one();
+                std::this_thread::yield();
+            }
+        }
+        if (gap) {
+            std::memcpy(&r.buf[pos], &kWrapMarker, sizeof(kWrapMarker));
+            h += gap;
+        }
+
+        RecordHeader hdr{};
+        hdr.size = size;
+        hdr.len = static_cast<uint32_t>(rec_len_);
+        hdr.time = static_cast<int64_t>(time(0));
+        hdr.level = static_cast<uint8_t>(logLevel);
+        hdr.indent = static_cast<uint8_t>(std::max(0, std::min(indent, 255)));
+        char* dst = &r.buf[h & r.mask];
+        std::memcpy(dst, &hdr, sizeof(hdr));
+        std::memcpy(dst + sizeof(hdr), rec_, rec_len_);
+        r.head.store(h + size, std::memory_order_release);
+
+        // Fatal messages must reach the file before we return
+        const bool severe = logLevel >= LOG_SEVERE;
         _init();
+        if (severe) syncAsync();
     }
 
     void Logger::setLogFile( FILE* f ) {
+        // Queued records belong to the outgoing file
+        syncAsync();
         std::lock_guard<boost::mutex> lk(sm);
         logfile = f;
     }
@@ -25,8 +25,21 @@
 #include <algorithm>
 #include <type_traits>
 #include <atomic>
+#include <cstdint>
 #include <boost/filesystem/path.hpp>
 
+// Statements below this level compile to nothing; XTREE_LOG also skips
+// evaluating their operands.
+// 0=TRACE 1=DEBUG 2=INFO 3=WARNING 4=ERROR 5=SEVERE. Release (NDEBUG)
+// builds drop TRACE and DEBUG by default, debug builds keep everything.
+#ifndef XTREE_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define XTREE_MIN_LOG_LEVEL 2
+#else
+#define XTREE_MIN_LOG_LEVEL 0
+#endif
+#endif
+
 namespace xtree {
 
     class LogManager;
@@ -140,9 +153,21 @@ namespace xtree {
     };
     extern ILogger iLogger;
 
+    struct LogRing;
+
     class Logger : public ILogger {
+    public:
+        // Arguments are stored as tagged binary values and formatted at
+        // flush time (on the drain thread when async logging is on)
+        enum class Arg : uint8_t { Str, Char, Int32, Int, UInt, Double, Bool, Ptr, IosManip };
+        static constexpr size_t kMaxRecordBytes = 4096;   // Longer messages are truncated
+        static constexpr size_t kDefaultRingBytes = 1 << 20;
+
+    private:
         static boost::mutex sm;
-        stringstream ss;
+        char rec_[kMaxRecordBytes];
+        size_t rec_len_ = 0;
+        std::shared_ptr<LogRing> ring_;    // This thread's async buffer, if any
         int indent;
         LogLevel logLevel;
         static FILE* logfile;
@@ -159,6 +184,19 @@ namespace xtree {
 
         void flush(Tee *t=0);
 
+        /**
+         * Async mode: flush() copies the encoded record into a per-thread
+         * lock-free ring and returns; a background thread formats and writes.
+         * stopAsync() drains everything and returns to synchronous writes.
+         */
+        static void startAsync(size_t ring_bytes = kDefaultRingBytes);
+        static void stopAsync();
+        static bool asyncEnabled();
+        // Block until every record enqueued before the call is written
+        static void syncAsync();
+        // Times a producer waited for ring space
+        static uint64_t asyncStalls();
+
         inline string getThreadName() { return _threadName; }
 
         /**
@@ -169,21 +207,21 @@ namespace xtree {
             return *this;
         }
 
-        Logger& operator<<(const char *x) { ss << x; return *this; }
-        Logger& operator<<(const string& x) { ss << x; return *this; }
-        Logger& operator<<(char *x)       { ss << x; return *this; }
-        Logger& operator<<(char x)        { ss << x; return *this; }
-        Logger& operator<<(int x)         { ss << x; return *this; }
-        Logger& operator<<(long x)          { ss << x; return *this; }
-        Logger& operator<<(unsigned long x) { ss << x; return *this; }
-        Logger& operator<<(unsigned x)      { ss << x; return *this; }
-        Logger& operator<<(unsigned short x){ ss << x; return *this; }
-        Logger& operator<<(double x)        { ss << x; return *this; }
-        Logger& operator<<(void *x)         { ss << x; return *this; }
-        Logger& operator<<(const void *x)   { ss << x; return *this; }
-        Logger& operator<<(long long x)     { ss << x; return *this; }
-        Logger& operator<<(unsigned long long x) { ss << x; return *this; }
-        Logger& operator<<(bool x)               { ss << x; return *this; }
+        Logger& operator<<(const char *x) { putStr(x); return *this; }
+        Logger& operator<<(const string& x) { putStr(x.data(), x.size()); return *this; }
+        Logger& operator<<(char *x)       { putStr(x); return *this; }
+        Logger& operator<<(char x)        { put(Arg::Char, x); return *this; }
+        Logger& operator<<(int x)         { put(Arg::Int32, x); return *this; }
+        Logger& operator<<(long x)          { put(Arg::Int, (long long)x); return *this; }
+        Logger& operator<<(unsigned long x) { put(Arg::UInt, (unsigned long long)x); return *this; }
+        Logger& operator<<(unsigned x)      { put(Arg::UInt, (unsigned long long)x); return *this; }
+        Logger& operator<<(unsigned short x){ put(Arg::UInt, (unsigned long long)x); return *this; }
+        Logger& operator<<(double x)        { put(Arg::Double, x); return *this; }
+        Logger& operator<<(void *x)         { put(Arg::Ptr, (const void*)x); return *this; }
+        Logger& operator<<(const void *x)   { put(Arg::Ptr, x); return *this; }
+        Logger& operator<<(long long x)     { put(Arg::Int, x); return *this; }
+        Logger& operator<<(unsigned long long x) { put(Arg::UInt, x); return *this; }
+        Logger& operator<<(bool x)               { put(Arg::Bool, x); return *this; }
         
         // Support for boost::filesystem::path
         template<typename PathType>
@@ -191,23 +229,24 @@ namespace xtree {
             std::is_same<PathType, boost::filesystem::path>::value,
             Logger&
         >::type operator<<(const PathType& p) {
-            ss << p.string();
+            const string str = p.string();
+            putStr(str.data(), str.size());
             return *this;
         }
 
         Logger& operator<<(Tee* tee) {
-            ss << '\n';
+            put(Arg::Char, '\n');
             flush(tee);
             return *this;
         }
 
         Logger& operator<< (ostream& ( *_endl )(ostream&)) {
-            ss << '\n';
+            put(Arg::Char, '\n');
             flush(0);
             return *this;
         }
         Logger& operator<< (ios_base& (*_hex)(ios_base&)) {
-            ss << _hex;
+            put(Arg::IosManip, _hex);
             return *this;
         }
 
@@ -226,10 +265,35 @@ namespace xtree {
             _init();
         }
         void _init() {
-            ss.str("");
+            rec_len_ = 0;
             logLevel = LOG_INFO;
             _threadName = "XTREE_NATIVE";
         }
+
+        // ========== Record encoding ==========
+
+        template<typename T>
+        void put(Arg tag, T v) {
+            if (rec_len_ + 1 + sizeof(T) > kMaxRecordBytes) return;  // Truncate
+            rec_[rec_len_++] = static_cast<char>(tag);
+            std::memcpy(rec_ + rec_len_, &v, sizeof(T));
+            rec_len_ += sizeof(T);
+        }
+        void putStr(const char* x) {
+            if (x) putStr(x, std::strlen(x));
+        }
+        void putStr(const char* x, size_t n) {
+            const size_t hdr = 1 + sizeof(uint32_t);
+            if (rec_len_ + hdr > kMaxRecordBytes) return;  // Truncate
+            n = std::min(n, kMaxRecordBytes - rec_len_ - hdr);
+            const uint32_t n32 = static_cast<uint32_t>(n);
+            rec_[rec_len_++] = static_cast<char>(Arg::Str);
+            std::memcpy(rec_ + rec_len_, &n32, sizeof(n32));
+            std::memcpy(rec_ + rec_len_ + sizeof(n32), x, n);
+            rec_len_ += sizeof(n32) + n;
+        }
+        void writeSync(Tee* t);
+        static bool drainOnce();
     public:
         static Logger& get() {
             Logger *p = tsp.get();
@@ -304,6 +368,39 @@ namespace xtree {
         }
     };
     
+    // Stand-in for LoggerWrapper at levels below XTREE_MIN_LOG_LEVEL: every
+    // operator is an empty inline, so nothing is formatted or written. The
+    // operands are still evaluated (trace() << f() calls f); use XTREE_LOG
+    // where that matters.
+    struct NullLogWrapper {
+        template<typename T>
+        constexpr const NullLogWrapper& operator<<(const T&) const { return *this; }
+        constexpr const NullLogWrapper& operator<<(ostream& (*)(ostream&)) const { return *this; }
+        constexpr const NullLogWrapper& operator<<(ios_base& (*)(ios_base&)) const { return *this; }
+    };
+
+    template<LogLevel L>
+    using LogStatement = typename std::conditional<(L >= XTREE_MIN_LOG_LEVEL),
+                                                   LoggerWrapper, NullLogWrapper>::type;
+
+    template<LogLevel L>
+    __attribute__((always_inline))
+    inline LogStatement<L> logAt() {
+        if constexpr (L < XTREE_MIN_LOG_LEVEL) {
+            return NullLogWrapper{};
+        } else {
+            if (L < logLevel.load(std::memory_order_relaxed))
+                return LoggerWrapper(nullptr, false);
+            return LoggerWrapper(&Logger::get().prolog().setLogLevel(L), true);
+        }
+    }
+
+    // Statement form that drops the whole statement, operands included, when
+    // the level is compiled out:  XTREE_LOG(LOG_TRACE) << expensive();
+    // Complete as an if/else, so it nests safely under an unbraced if.
+    #define XTREE_LOG(L) \
+        if constexpr ((L) < XTREE_MIN_LOG_LEVEL) {} else ::xtree::logAt<(L)>()
+
     inline LoggerWrapper log( LogLevel l ) {
         if ( l < logLevel.load(std::memory_order_relaxed) )  // LogLevel enum: lower value = more verbose
             return LoggerWrapper(nullptr, false);   // Return no-op wrapper
@@ -316,24 +413,18 @@ namespace xtree {
     }
 
     __attribute__((always_inline))
-    inline LoggerWrapper error() {
-        if (LOG_ERROR < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_ERROR), true);
+    inline LogStatement<LOG_ERROR> error() {
+        return logAt<LOG_ERROR>();
     }
 
     __attribute__((always_inline))
-    inline LoggerWrapper warn() {
-        if (LOG_WARNING < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_WARNING), true);
+    inline LogStatement<LOG_WARNING> warn() {
+        return logAt<LOG_WARNING>();
     }
 
     __attribute__((always_inline))
-    inline LoggerWrapper warning() {
-        if (LOG_WARNING < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_WARNING), true);
+    inline LogStatement<LOG_WARNING> warning() {
+        return logAt<LOG_WARNING>();
     }
 
     extern const char * (*getcurns)();
@@ -372,31 +463,23 @@ namespace xtree {
     // Helper functions for specific log levels
     // These return lightweight wrappers that compiler can optimize away
     __attribute__((always_inline))
-    inline LoggerWrapper trace() {
-        if (LOG_TRACE < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_TRACE), true);
+    inline LogStatement<LOG_TRACE> trace() {
+        return logAt<LOG_TRACE>();
     }
     
     __attribute__((always_inline))
-    inline LoggerWrapper debug() {
-        if (LOG_DEBUG < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_DEBUG), true);
+    inline LogStatement<LOG_DEBUG> debug() {
+        return logAt<LOG_DEBUG>();
     }
     
     __attribute__((always_inline))
-    inline LoggerWrapper info() {
-        if (LOG_INFO < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_INFO), true);
+    inline LogStatement<LOG_INFO> info() {
+        return logAt<LOG_INFO>();
     }
     
     __attribute__((always_inline))
-    inline LoggerWrapper severe() {
-        if (LOG_SEVERE < logLevel.load(std::memory_order_relaxed))
-            return LoggerWrapper(nullptr, false);
-        return LoggerWrapper(&Logger::get().prolog().setLogLevel(LOG_SEVERE), true);
+    inline LogStatement<LOG_SEVERE> severe() {
+        return logAt<LOG_SEVERE>();
     }
 
     // Set log level from string (for configuration)
@@ -39,12 +39,16 @@ public:
         // Initial log level
         LogLevel initial_level;
         
+        // Format and write on a background thread (see Logger::startAsync)
+        bool async_logging;
+        
         Config() 
             : enable_file_logging(false)
             , enable_signal_handlers(false)
             , enable_file_watcher(false)
             , control_file_path("/tmp/xtree_log_level")
-            , initial_level(LOG_WARNING) {}
+            , initial_level(LOG_WARNING)
+            , async_logging(false) {}
     };
     
     /**
@@ -73,6 +77,10 @@ public:
         if (config_.enable_file_watcher) {
             LogControl::startFileWatcher(config_.control_file_path);
         }
+        
+        if (config_.async_logging) {
+            Logger::startAsync();
+        }
     }
     
     /**
@@ -95,6 +103,12 @@ public:
             config_.enable_file_watcher = false;
         }
         
+        // Drain queued records while the log file is still open
+        if (config_.async_logging) {
+            Logger::stopAsync();
+            config_.async_logging = false;
+        }
+        
         // Reset logger to stderr before destroying LogManager
         Logger::setLogFile(nullptr);
         
@@ -131,6 +145,10 @@ public:
                 config.enable_file_watcher = (std::string(watcher) != "0");
             }
             
+            if (const char* async = std::getenv("XTREE_LOG_ASYNC")) {
+                config.async_logging = (std::string(async) != "0");
+            }
+            
             // Rotation config from environment
             if (const char* size = std::getenv("XTREE_LOG_MAX_SIZE_MB")) {
                 config.rotation_config.max_file_size = std::stoull(size) * 1024 * 1024;
@@ -0,0 +1,297 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Online miss-ratio-curve (MRC) estimation using SHARDS-style spatial sampling.
+ *
+ * A reference to key k is sampled when hash(k) falls below a fixed threshold,
+ * so every reference to a sampled key is seen and its LRU reuse distance can
+ * be measured exactly within the sample. Distances are byte-weighted (the
+ * bytes of distinct keys touched since the previous reference, including the
+ * key itself) and scaled by 1/rate to estimate the distance in the full
+ * stream. A reference hits in an LRU cache of C bytes iff its distance <= C,
+ * so the histogram of distances gives hits as a function of cache size.
+ *
+ * Cost:
+ * - Unsampled references: one hash and compare, no lock
+ * - Sampled references: O(log n) under a private mutex (Fenwick tree over
+ *   logical time + ordered map of last references)
+ * - Memory: bounded by maxTracked sampled keys; older keys fall off and
+ *   their next reference is counted as a cold miss
+ *
+ * The histogram is aged with decay() so the curve follows the recent workload.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace xtree {
+
+class MissRatioCurve {
+public:
+    static constexpr double kDefaultSamplingRate = 0.01;
+    static constexpr size_t kDefaultMaxTracked = 16384;
+
+    explicit MissRatioCurve(double samplingRate = kDefaultSamplingRate,
+                            size_t maxTracked = kDefaultMaxTracked) {
+        configure(samplingRate, maxTracked);
+    }
+
+    MissRatioCurve(const MissRatioCurve&) = delete;
+    MissRatioCurve& operator=(const MissRatioCurve&) = delete;
+
+    // Change the sampling rate (0 < rate <= 1) and tracked-key bound.
+    // Discards everything measured so far.
+    void configure(double samplingRate, size_t maxTracked) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        samplingRate = std::clamp(samplingRate, 1.0 / kHashSpace, 1.0);
+        _threshold.store(static_cast<uint64_t>(samplingRate * kHashSpace),
+                         std::memory_order_relaxed);
+        _rate = static_cast<double>(_threshold.load(std::memory_order_relaxed)) / kHashSpace;
+        _maxTracked = std::max<size_t>(maxTracked, 16);
+        resetLocked();
+    }
+
+    // Cheap, lock-free filter: callers can skip computing the entry size
+    // for keys that will not be sampled.
+    bool sampled(uint64_t key) const {
+        return (mix(key) & (kHashSpace - 1)) < _threshold.load(std::memory_order_relaxed);
+    }
+
+    // Record a reference to key whose entry occupies bytes.
+    void access(uint64_t key, size_t bytes) {
+        if (!sampled(key)) return;
+        if (bytes == 0) bytes = 1;
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _sampledRefs++;
+
+        if (_clock + 1 >= _fenwick.size()) compactLocked();
+        const uint64_t now = ++_clock;
+
+        auto it = _last.find(key);
+        if (it != _last.end()) {
+            const uint64_t prev = it->second.time;
+            // Bytes of distinct keys referenced after prev, plus this key
+            const double distance =
+                static_cast<double>(prefixSum(now - 1) - prefixSum(prev) + bytes) / _rate;
+            fenwickAdd(prev, -static_cast<int64_t>(it->second.bytes));
+            _byTime.erase(prev);
+            _hist[binFor(distance)] += 1.0 / _rate;
+            _sampledReuses++;
+            it->second = {now, bytes};
+        } else {
+            _coldMisses += 1.0 / _rate;
+            _last.emplace(key, Entry{now, bytes});
+            if (_last.size() > _maxTracked) dropOldestLocked();
+        }
+        fenwickAdd(now, static_cast<int64_t>(bytes));
+        _byTime.emplace(now, key);
+    }
+
+    // Estimated hits an LRU cache of cacheBytes would have served, scaled
+    // to the full (unsampled) reference stream since the last reset.
+    double hitsAt(double cacheBytes) const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return hitsAtLocked(cacheBytes);
+    }
+
+    // Estimated hit ratio for a cache of cacheBytes (0 if no references)
+    double hitRatioAt(double cacheBytes) const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        const double total = totalRefsLocked();
+        return total > 0.0 ? hitsAtLocked(cacheBytes) / total : 0.0;
+    }
+
+    // Estimated additional hits per additional byte between two sizes
+    double marginalHitsPerByte(double fromBytes, double toBytes) const {
+        if (toBytes <= fromBytes) return 0.0;
+        std::lock_guard<std::mutex> lock(_mtx);
+        return (hitsAtLocked(toBytes) - hitsAtLocked(fromBytes)) / (toBytes - fromBytes);
+    }
+
+    // Smallest cache size (bytes) whose estimated hit ratio reaches target.
+    // Returns 0 if there is no data, or the largest measured distance if
+    // the target is above the ratio achievable with reuse alone.
+    double bytesForHitRatio(double target) const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        const double total = totalRefsLocked();
+        if (total <= 0.0) return 0.0;
+        const double want = target * total;
+        double cum = 0.0;
+        double lastEdge = 0.0;
+        for (size_t b = 0; b < kBins; ++b) {
+            if (_hist[b] <= 0.0) continue;
+            lastEdge = binUpper(b);
+            if (cum + _hist[b] >= want) {
+                const double frac = (want - cum) / _hist[b];
+                return binLower(b) + frac * (binUpper(b) - binLower(b));
+            }
+            cum += _hist[b];
+        }
+        return lastEdge;
+    }
+
+    // Age the histogram so older references count for less
+    void decay(double factor = 0.5) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        for (double& h : _hist) h *= factor;
+        _coldMisses *= factor;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        resetLocked();
+    }
+
+    double samplingRate() const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _rate;
+    }
+
+    // Raw sample counts (unscaled), useful to judge estimate confidence
+    uint64_t sampledReferences() const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _sampledRefs;
+    }
+
+    uint64_t sampledReuses() const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _sampledReuses;
+    }
+
+    // Estimated references in the full stream (after decay)
+    double estimatedReferences() const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return totalRefsLocked();
+    }
+
+private:
+    // Histogram bins: 4 per power of two of distance in bytes
+    static constexpr size_t kBinsPerOctave = 4;
+    static constexpr size_t kBins = 64 * kBinsPerOctave;
+    static constexpr uint64_t kHashSpace = 1ULL << 24;
+
+    struct Entry {
+        uint64_t time;
+        size_t bytes;
+    };
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static size_t binFor(double distance) {
+        if (distance <= 1.0) return 0;
+        const size_t b = static_cast<size_t>(std::log2(distance) * kBinsPerOctave);
+        return std::min(b, kBins - 1);
+    }
+
+    static double binLower(size_t b) {
+        return b == 0 ? 0.0 : std::exp2(static_cast<double>(b) / kBinsPerOctave);
+    }
+
+    static double binUpper(size_t b) {
+        return std::exp2(static_cast<double>(b + 1) / kBinsPerOctave);
+    }
+
+    double totalRefsLocked() const {
+        double total = _coldMisses;
+        for (double h : _hist) total += h;
+        return total;
+    }
+
+    double hitsAtLocked(double cacheBytes) const {
+        if (cacheBytes <= 0.0) return 0.0;
+        double hits = 0.0;
+        for (size_t b = 0; b < kBins; ++b) {
+            const double lo = binLower(b);
+            if (lo >= cacheBytes) break;
+            const double hi = binUpper(b);
+            if (hi <= cacheBytes) {
+                hits += _hist[b];
+            } else {
+                // Assume distances are spread evenly within the bin
+                hits += _hist[b] * (cacheBytes - lo) / (hi - lo);
+            }
+        }
+        return hits;
+    }
+
+    // ---- Fenwick tree over logical time (1-based), values are entry bytes ----
+
+    void fenwickAdd(uint64_t i, int64_t delta) {
+        for (; i < _fenwick.size(); i += i & (~i + 1)) _fenwick[i] += delta;
+    }
+
+    int64_t prefixSum(uint64_t i) const {
+        int64_t s = 0;
+        for (; i > 0; i -= i & (~i + 1)) s += _fenwick[i];
+        return s;
+    }
+
+    // Renumber live references 1..n in time order so the clock never outgrows
+    // the tree. Amortized O(log n) per sampled reference.
+    void compactLocked() {
+        std::fill(_fenwick.begin(), _fenwick.end(), 0);
+        std::map<uint64_t, uint64_t> renumbered;
+        uint64_t t = 0;
+        for (const auto& [oldTime, key] : _byTime) {
+            Entry& e = _last[key];
+            e.time = ++t;
+            renumbered.emplace(t, key);
+            fenwickAdd(t, static_cast<int64_t>(e.bytes));
+        }
+        _byTime.swap(renumbered);
+        _clock = t;
+    }
+
+    void dropOldestLocked() {
+        auto oldest = _byTime.begin();
+        auto it = _last.find(oldest->second);
+        fenwickAdd(oldest->first, -static_cast<int64_t>(it->second.bytes));
+        _last.erase(it);
+        _byTime.erase(oldest);
+    }
+
+    void resetLocked() {
+        _last.clear();
+        _byTime.clear();
+        _fenwick.assign(4 * _maxTracked + 2, 0);
+        _clock = 0;
+        _hist.fill(0.0);
+        _coldMisses = 0.0;
+        _sampledRefs = 0;
+        _sampledReuses = 0;
+    }
+
+    std::atomic<uint64_t> _threshold{0};
+    double _rate = 1.0;
+    size_t _maxTracked = kDefaultMaxTracked;
+
+    mutable std::mutex _mtx;
+    std::unordered_map<uint64_t, Entry> _last;   // sampled key -> last reference
+    std::map<uint64_t, uint64_t> _byTime;        // last reference time -> key
+    std::vector<int64_t> _fenwick;
+    uint64_t _clock = 0;
+
+    std::array<double, kBins> _hist{};           // scaled reuses per distance bin
+    double _coldMisses = 0.0;                    // scaled first references
+    uint64_t _sampledRefs = 0;
+    uint64_t _sampledReuses = 0;
+};
+
+} // namespace xtree
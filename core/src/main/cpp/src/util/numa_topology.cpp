@@ -0,0 +1,194 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * NUMA topology discovery and node-local placement without libnuma
+ */
+
+#include "numa_topology.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
+
+namespace xtree {
+
+namespace {
+    // Dense node the thread was bound to, or -1
+    thread_local long tls_bound_node = -1;
+
+    size_t page_round(size_t bytes) {
+#ifdef __linux__
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        constexpr size_t page = 4096;
+#endif
+        return (bytes + page - 1) / page * page;
+    }
+}
+
+const NumaTopology& NumaTopology::system() {
+    static const NumaTopology topology = [] {
+        const char* env = std::getenv("XTREE_NUMA");
+        const int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        if (env && std::strcmp(env, "off") == 0) {
+            return single_node(cpus);
+        }
+        NumaTopology t = from_sysfs("/sys/devices/system/node");
+        return t.node_count() > 0 ? t : single_node(cpus);
+    }();
+    return topology;
+}
+
+NumaTopology NumaTopology::from_sysfs(const std::string& node_dir) {
+    NumaTopology t;
+#ifdef __linux__
+    std::vector<int> ids;
+    if (DIR* dir = opendir(node_dir.c_str())) {
+        while (dirent* e = readdir(dir)) {
+            char* end = nullptr;
+            if (std::strncmp(e->d_name, "node", 4) == 0 && e->d_name[4] != '\0') {
+                const long id = std::strtol(e->d_name + 4, &end, 10);
+                if (*end == '\0' && id >= 0) ids.push_back(static_cast<int>(id));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (int id : ids) {
+        std::ifstream in(node_dir + "/node" + std::to_string(id) + "/cpulist");
+        std::string list;
+        std::getline(in, list);
+        Node n;
+        n.os_id = id;
+        // Memory-only nodes (CXL, HBM) have no CPUs to schedule on; skip them
+        if (parse_cpu_list(list, n.cpus) && !n.cpus.empty()) {
+            t.nodes_.push_back(std::move(n));
+        }
+    }
+#else
+    (void)node_dir;
+#endif
+    for (size_t i = 0; i < t.nodes_.size(); ++i) {
+        for (int cpu : t.nodes_[i].cpus) {
+            if (static_cast<size_t>(cpu) >= t.cpu_to_node_.size()) {
+                t.cpu_to_node_.resize(cpu + 1, 0);
+            }
+            t.cpu_to_node_[cpu] = i;
+        }
+    }
+    return t;
+}
+
+NumaTopology NumaTopology::single_node(int cpus) {
+    NumaTopology t;
+    Node n;
+    for (int c = 0; c < std::max(1, cpus); ++c) n.cpus.push_back(c);
+    t.nodes_.push_back(std::move(n));
+    t.cpu_to_node_.assign(t.nodes_[0].cpus.size(), 0);
+    return t;
+}
+
+bool NumaTopology::parse_cpu_list(const std::string& list, std::vector<int>& cpus) {
+    cpus.clear();
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t comma = std::min(list.find(',', pos), list.size());
+        std::string range = list.substr(pos, comma - pos);
+        while (!range.empty() && std::isspace(static_cast<unsigned char>(range.back()))) range.pop_back();
+        pos = comma + 1;
+        if (range.empty()) continue;
+
+        char* end = nullptr;
+        const long lo = std::strtol(range.c_str(), &end, 10);
+        long hi = lo;
+        if (*end == '-') {
+            hi = std::strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || lo < 0 || hi < lo) {
+            cpus.clear();
+            return false;
+        }
+        for (long c = lo; c <= hi; ++c) cpus.push_back(static_cast<int>(c));
+    }
+    return true;
+}
+
+size_t NumaTopology::node_of_cpu(int cpu) const {
+    return cpu >= 0 && static_cast<size_t>(cpu) < cpu_to_node_.size() ? cpu_to_node_[cpu] : 0;
+}
+
+size_t NumaTopology::current_node() const {
+    if (tls_bound_node >= 0 && static_cast<size_t>(tls_bound_node) < nodes_.size()) {
+        return static_cast<size_t>(tls_bound_node);
+    }
+    if (!is_numa()) return 0;
+#ifdef __linux__
+    return node_of_cpu(sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+bool NumaTopology::bind_current_thread(size_t node) const {
+    if (node >= nodes_.size()) return false;
+    tls_bound_node = static_cast<long>(node);
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : nodes_[node].cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void NumaTopology::clear_thread_binding() {
+    tls_bound_node = -1;
+}
+
+void* NumaTopology::allocate_on_node(size_t bytes, size_t node) const {
+    const size_t len = page_round(bytes);
+#ifdef __linux__
+    void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    if (node < nodes_.size()) {
+        const int os = nodes_[node].os_id;
+        unsigned long mask[4] = {};
+        if (os >= 0 && os < static_cast<int>(sizeof(mask) * 8)) {
+            mask[os / 64] = 1UL << (os % 64);
+            // Best effort: seccomp'd containers and non-NUMA kernels refuse it
+            (void)syscall(SYS_mbind, p, len, MPOL_PREFERRED, mask, sizeof(mask) * 8, 0);
+        }
+    }
+    return p;
+#else
+    (void)node;
+    return ::operator new(len, std::nothrow);
+#endif
+}
+
+void NumaTopology::free_on_node(void* p, size_t bytes) {
+    if (!p) return;
+#ifdef __linux__
+    ::munmap(p, page_round(bytes));
+#else
+    (void)bytes;
+    ::operator delete(p);
+#endif
+}
+
+} // namespace xtree
@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * NUMA topology discovery and node-local placement without libnuma
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xtree {
+
+/**
+ * Memory nodes and their CPUs as listed under /sys/devices/system/node.
+ *
+ * Nodes are numbered densely from 0 in the order the kernel lists them;
+ * os_node() maps back to the kernel's id for mbind. A machine (or a
+ * container) without that directory is one node holding every CPU, and
+ * XTREE_NUMA=off forces that view.
+ *
+ * current_node() is the node of the CPU the calling thread runs on, unless
+ * the thread was bound with bind_current_thread(), in which case it is the
+ * bound node even if the affinity call itself was refused.
+ */
+class NumaTopology {
+public:
+    // Discovered once per process
+    static const NumaTopology& system();
+
+    // Parse a sysfs-style directory with node<N>/cpulist entries
+    static NumaTopology from_sysfs(const std::string& node_dir);
+
+    // One node with the given CPUs
+    static NumaTopology single_node(int cpus);
+
+    // "0-3,8,10-11" -> {0,1,2,3,8,10,11}; false on malformed input
+    static bool parse_cpu_list(const std::string& list, std::vector<int>& cpus);
+
+    size_t node_count() const { return nodes_.size(); }
+    bool is_numa() const { return nodes_.size() > 1; }
+
+    int os_node(size_t node) const { return nodes_[node].os_id; }
+    const std::vector<int>& cpus_of(size_t node) const { return nodes_[node].cpus; }
+
+    // Dense node of a CPU; 0 when the CPU is not listed
+    size_t node_of_cpu(int cpu) const;
+
+    size_t current_node() const;
+
+    // Restrict the calling thread to the node's CPUs and record the binding
+    // for current_node(). Returns false when the affinity call failed.
+    bool bind_current_thread(size_t node) const;
+
+    // Forget the binding recorded by bind_current_thread() (affinity is kept)
+    static void clear_thread_binding();
+
+    /**
+     * Page-granular memory whose pages prefer the given node (mbind
+     * MPOL_PREFERRED). Where the policy cannot be set, the pages land by
+     * first touch. Returns nullptr only when the mapping itself fails.
+     * Release with free_on_node() and the same size.
+     */
+    void* allocate_on_node(size_t bytes, size_t node) const;
+    static void free_on_node(void* p, size_t bytes);
+
+private:
+    struct Node {
+        int os_id = 0;
+        std::vector<int> cpus;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<size_t> cpu_to_node_;   // indexed by CPU id
+};
+
+// unique_ptr deleter for objects made by make_on_node()
+template< typename T >
+struct NodeLocalDelete {
+    bool on_node = false;
+
+    void operator()(T* p) const {
+        if (!p) return;
+        if (on_node) {
+            p->~T();
+            NumaTopology::free_on_node(p, sizeof(T));
+        } else {
+            delete p;
+        }
+    }
+};
+
+template< typename T >
+using NodeLocalPtr = std::unique_ptr<T, NodeLocalDelete<T>>;
+
+// Construct T in memory on the given node when the topology has more than
+// one; on a single node (or if the mapping fails) this is a plain new
+template< typename T, typename... Args >
+NodeLocalPtr<T> make_on_node(const NumaTopology& numa, size_t node, Args&&... args) {
+    if (numa.is_numa()) {
+        if (void* mem = numa.allocate_on_node(sizeof(T), node)) {
+            try {
+                return NodeLocalPtr<T>(new (mem) T(std::forward<Args>(args)...), NodeLocalDelete<T>{true});
+            } catch (...) {
+                NumaTopology::free_on_node(mem, sizeof(T));
+                throw;
+            }
+        }
+    }
+    return NodeLocalPtr<T>(new T(std::forward<Args>(args)...), NodeLocalDelete<T>{false});
+}
+
+} // namespace xtree
@@ -20,16 +20,6 @@
 
 namespace xtree {
 
-// Function pointer typedefs
-typedef bool (*intersects_func_t)(const int32_t*, const int32_t*, int);
-typedef void (*expand_func_t)(int32_t*, const int32_t*, int);
-typedef void (*expand_point_func_t)(int32_t*, const double*, int);
-
-// Function declarations
-intersects_func_t get_optimal_intersects_func();
-expand_func_t get_optimal_expand_func();
-expand_point_func_t get_optimal_expand_point_func();
-
 // Forward declarations of implementations
 namespace simd_impl {
 
@@ -59,6 +49,57 @@ void expand_point_scalar(int32_t* box, const double* point, int dimensions) {
     }
 }
 
+bool contains_scalar(const int32_t* outer, const int32_t* inner, int dimensions) {
+    for (int d = 0; d < dimensions * 2; d += 2) {
+        if (outer[d] > inner[d] || outer[d+1] < inner[d+1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Same arithmetic as KeyMBR::area(): float extents, double product
+double area_scalar(const float* box, int dimensions) {
+    double area = 1.0;
+    for (int d = 0; d < dimensions * 2; d += 2) {
+        area *= (double)(box[d+1] - box[d]);
+    }
+    return area;
+}
+
+// Same arithmetic as KeyMBR::overlap(): 0 when any axis is disjoint
+double overlap_scalar(const float* box1, const float* box2, int dimensions) {
+    if (dimensions <= 0) {
+        return 0.0;
+    }
+    double overlap = 1.0;
+    for (int d = 0; d < dimensions * 2; d += 2) {
+        overlap *= (double)std::max(0.0f, std::min(box1[d+1], box2[d+1]) - std::max(box1[d], box2[d]));
+    }
+    return overlap;
+}
+
+// Query x child overlap matrix - see match_matrix_func_t in cpu_features.h
+void match_matrix_scalar(const float* queries, const uint32_t* active, size_t nactive,
+                         const float* mins, const float* maxs, size_t stride,
+                         int dimensions, uint64_t* out) {
+    const size_t words = (stride + 63) / 64;
+    for (size_t i = 0; i < nactive; ++i) {
+        const float* q = queries + static_cast<size_t>(active[i]) * 2 * dimensions;
+        uint64_t* row = out + i * words;
+        std::fill(row, row + words, 0);
+        for (size_t c = 0; c < stride; ++c) {
+            bool hit = true;
+            for (int d = 0; d < dimensions && hit; ++d) {
+                hit = mins[d * stride + c] <= q[2 * d + 1] && maxs[d * stride + c] >= q[2 * d];
+            }
+            if (hit) {
+                row[c >> 6] |= uint64_t(1) << (c & 63);
+            }
+        }
+    }
+}
+
 #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
 
 // Platform-specific alignment and optimization attributes
@@ -73,9 +114,11 @@ void expand_point_scalar(int32_t* box, const double* point, int dimensions) {
     #ifdef __clang__
         #define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
         #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+        #define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq")))
     #else
         #define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
         #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+        #define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq")))
     #endif
 #endif
 
@@ -319,23 +362,11 @@ void expand_avx2(int32_t* target, const int32_t* source, int dimensions) {
         __m256i t = _mm256_loadu_si256((__m256i*)(target + d));
         __m256i s = _mm256_loadu_si256((__m256i*)(source + d));
 
-        // Deinterleave
-        __m256i t_min = _mm256_shuffle_epi32(t, _MM_SHUFFLE(2, 0, 2, 0)); // same lane-wise, not global
-        __m256i t_max = _mm256_shuffle_epi32(t, _MM_SHUFFLE(3, 1, 3, 1));
-        __m256i s_min = _mm256_shuffle_epi32(s, _MM_SHUFFLE(2, 0, 2, 0));
-        __m256i s_max = _mm256_shuffle_epi32(s, _MM_SHUFFLE(3, 1, 3, 1));
-
-        __m256i new_min = _mm256_min_epi32(t_min, s_min);
-        __m256i new_max = _mm256_max_epi32(t_max, s_max);
-
-        __m256i result = _mm256_unpacklo_epi32(new_min, new_max); // interleave min0,max0,...
+        // Lanes are already interleaved [min, max, ...]: take the min on even
+        // lanes and the max on odd lanes, no deinterleave needed
+        __m256i result = _mm256_blend_epi32(_mm256_min_epi32(t, s), _mm256_max_epi32(t, s), 0xAA);
 
-        // Actually, because AVX2 shuffle operates within 128-bit lanes, you need to permute 128-bit lanes
-        __m256i interleave_lo = _mm256_unpacklo_epi32(new_min, new_max); // min0,max0,...
-        __m256i interleave_hi = _mm256_unpackhi_epi32(new_min, new_max);
-        __m256i result_full = _mm256_permute2x128_si256(interleave_lo, interleave_hi, 0x20);
-
-        _mm256_storeu_si256((__m256i*)(target + d), result_full);
+        _mm256_storeu_si256((__m256i*)(target + d), result);
     }
 
     for (; d < dimensions * 2; d += 2) {
@@ -429,6 +460,231 @@ void expand_point_avx2(int32_t* box, const double* point, int dimensions) {
     }
 }
 
+// SSE2 match matrix: 4 children per compare
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_SSE2
+#endif
+#endif
+void match_matrix_sse2(const float* queries, const uint32_t* active, size_t nactive,
+                       const float* mins, const float* maxs, size_t stride,
+                       int dimensions, uint64_t* out) {
+    const size_t words = (stride + 63) / 64;
+    for (size_t i = 0; i < nactive; ++i) {
+        const float* q = queries + static_cast<size_t>(active[i]) * 2 * dimensions;
+        uint64_t* row = out + i * words;
+        std::fill(row, row + words, 0);
+        for (size_t c = 0; c < stride; c += 4) {
+            __m128 hit = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int d = 0; d < dimensions; ++d) {
+                const __m128 cmin = _mm_loadu_ps(mins + d * stride + c);
+                const __m128 cmax = _mm_loadu_ps(maxs + d * stride + c);
+                hit = _mm_and_ps(hit, _mm_cmple_ps(cmin, _mm_set1_ps(q[2 * d + 1])));
+                hit = _mm_and_ps(hit, _mm_cmpge_ps(cmax, _mm_set1_ps(q[2 * d])));
+            }
+            row[c >> 6] |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (c & 63);
+        }
+    }
+}
+
+// AVX2 match matrix: 8 children per compare
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX2
+#endif
+#endif
+void match_matrix_avx2(const float* queries, const uint32_t* active, size_t nactive,
+                       const float* mins, const float* maxs, size_t stride,
+                       int dimensions, uint64_t* out) {
+    const size_t words = (stride + 63) / 64;
+    for (size_t i = 0; i < nactive; ++i) {
+        const float* q = queries + static_cast<size_t>(active[i]) * 2 * dimensions;
+        uint64_t* row = out + i * words;
+        std::fill(row, row + words, 0);
+        for (size_t c = 0; c < stride; c += 8) {
+            __m256 hit = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int d = 0; d < dimensions; ++d) {
+                const __m256 cmin = _mm256_loadu_ps(mins + d * stride + c);
+                const __m256 cmax = _mm256_loadu_ps(maxs + d * stride + c);
+                hit = _mm256_and_ps(hit, _mm256_cmp_ps(cmin, _mm256_set1_ps(q[2 * d + 1]), _CMP_LE_OQ));
+                hit = _mm256_and_ps(hit, _mm256_cmp_ps(cmax, _mm256_set1_ps(q[2 * d]), _CMP_GE_OQ));
+            }
+            row[c >> 6] |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << (c & 63);
+        }
+    }
+}
+
+// AVX-512 implementations. One 16-lane register holds 8 interleaved
+// [min, max] dimensions, the tail is a masked load rather than a scalar
+// loop, and predicates are evaluated in mask registers without branching
+// per dimension.
+static const __mmask16 AVX512_MIN_LANES = 0x5555;
+static const __mmask16 AVX512_MAX_LANES = 0xAAAA;
+
+// Below 6 dimensions the mask setup and masked loads cost more than they
+// save: the narrower tiers (or scalar, with its early exit) are as fast or
+// faster in simd_perf_highdim, so the 512-bit kernels hand small boxes down
+static const int AVX512_MIN_DIMS = 6;
+
+static inline __mmask16 avx512_lane_mask(int lanes) {
+    return lanes >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << lanes) - 1);
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+bool intersects_avx512(const int32_t* box1, const int32_t* box2, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return intersects_avx2(box1, box2, dimensions);
+    }
+    const int lanes = dimensions * 2;
+    for (int d = 0; d < lanes; d += 16) {
+        const __mmask16 k = avx512_lane_mask(lanes - d);
+        const __m512i a = _mm512_maskz_loadu_epi32(k, box1 + d);
+        const __m512i b = _mm512_maskz_loadu_epi32(k, box2 + d);
+        // b with each [min, max] pair swapped, so a.min lines up with b.max
+        const __m512i b_swapped = _mm512_shuffle_epi32(b, _MM_PERM_CDAB);
+        const __mmask16 fail =
+            _mm512_mask_cmpgt_epi32_mask(k & AVX512_MIN_LANES, a, b_swapped) |  // a.min > b.max
+            _mm512_mask_cmpgt_epi32_mask(k & AVX512_MAX_LANES, b_swapped, a);   // b.min > a.max
+        if (fail) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+bool contains_avx512(const int32_t* outer, const int32_t* inner, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return contains_scalar(outer, inner, dimensions);
+    }
+    const int lanes = dimensions * 2;
+    for (int d = 0; d < lanes; d += 16) {
+        const __mmask16 k = avx512_lane_mask(lanes - d);
+        const __m512i o = _mm512_maskz_loadu_epi32(k, outer + d);
+        const __m512i i = _mm512_maskz_loadu_epi32(k, inner + d);
+        const __mmask16 fail =
+            _mm512_mask_cmpgt_epi32_mask(k & AVX512_MIN_LANES, o, i) |  // outer.min > inner.min
+            _mm512_mask_cmpgt_epi32_mask(k & AVX512_MAX_LANES, i, o);   // inner.max > outer.max
+        if (fail) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+void expand_avx512(int32_t* target, const int32_t* source, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return expand_avx2(target, source, dimensions);
+    }
+    const int lanes = dimensions * 2;
+    for (int d = 0; d < lanes; d += 16) {
+        const __mmask16 k = avx512_lane_mask(lanes - d);
+        const __m512i t = _mm512_maskz_loadu_epi32(k, target + d);
+        const __m512i s = _mm512_maskz_loadu_epi32(k, source + d);
+        const __m512i result = _mm512_mask_blend_epi32(AVX512_MAX_LANES,
+                                                       _mm512_min_epi32(t, s), _mm512_max_epi32(t, s));
+        _mm512_mask_storeu_epi32(target + d, k, result);
+    }
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+void expand_point_avx512(int32_t* box, const double* point, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return expand_point_avx2(box, point, dimensions);
+    }
+    // Duplicates each of 8 sortable values into its [min, max] lane pair
+    const __m512i pairs = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+    for (int d = 0; d < dimensions; d += 8) {
+        const int remaining = dimensions - d;
+        const __mmask8 kp = remaining >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << remaining) - 1);
+        const __mmask16 k = avx512_lane_mask(remaining * 2);
+
+        const __m256 p = _mm512_cvtpd_ps(_mm512_maskz_loadu_pd(kp, point + d));
+        const __m256i bits = _mm256_castps_si256(p);
+        const __m256i sortable = _mm256_xor_si256(
+            bits, _mm256_and_si256(_mm256_srai_epi32(bits, 31), _mm256_set1_epi32(0x7fffffff)));
+        const __m512i expanded = _mm512_permutexvar_epi32(pairs, _mm512_castsi256_si512(sortable));
+
+        const __m512i b = _mm512_maskz_loadu_epi32(k, box + d * 2);
+        const __m512i result = _mm512_mask_blend_epi32(AVX512_MAX_LANES,
+                                                       _mm512_min_epi32(b, expanded),
+                                                       _mm512_max_epi32(b, expanded));
+        _mm512_mask_storeu_epi32(box + d * 2, k, result);
+    }
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+double area_avx512(const float* box, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return area_scalar(box, dimensions);
+    }
+    const __m512i min_idx = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i max_idx = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 15, 13, 11, 9, 7, 5, 3, 1);
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d product = one;
+    for (int d = 0; d < dimensions; d += 8) {
+        const int remaining = dimensions - d;
+        const __mmask8 kd = remaining >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << remaining) - 1);
+        const __m512 v = _mm512_maskz_loadu_ps(avx512_lane_mask(remaining * 2), box + d * 2);
+        const __m256 mins = _mm512_castps512_ps256(_mm512_permutexvar_ps(min_idx, v));
+        const __m256 maxs = _mm512_castps512_ps256(_mm512_permutexvar_ps(max_idx, v));
+        // Extents are subtracted in float, as the scalar path does; lanes past
+        // the last dimension multiply by 1
+        const __m512d extent = _mm512_mask_cvtps_pd(one, kd, _mm256_sub_ps(maxs, mins));
+        product = _mm512_mul_pd(product, extent);
+    }
+    return _mm512_reduce_mul_pd(product);
+}
+
+#ifndef _MSC_VER
+#ifndef DISABLE_SIMD_ATTRIBUTES
+SIMD_TARGET_AVX512
+#endif
+#endif
+double overlap_avx512(const float* box1, const float* box2, int dimensions) {
+    if (dimensions < AVX512_MIN_DIMS) {
+        return overlap_scalar(box1, box2, dimensions);
+    }
+    const __m512i min_idx = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i max_idx = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 15, 13, 11, 9, 7, 5, 3, 1);
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d product = one;
+    for (int d = 0; d < dimensions; d += 8) {
+        const int remaining = dimensions - d;
+        const __mmask8 kd = remaining >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << remaining) - 1);
+        const __mmask16 k = avx512_lane_mask(remaining * 2);
+        const __m512 a = _mm512_maskz_loadu_ps(k, box1 + d * 2);
+        const __m512 b = _mm512_maskz_loadu_ps(k, box2 + d * 2);
+        // Intersection box: larger of the mins, smaller of the maxes
+        const __m256 lo = _mm512_castps512_ps256(_mm512_permutexvar_ps(min_idx, _mm512_max_ps(a, b)));
+        const __m256 hi = _mm512_castps512_ps256(_mm512_permutexvar_ps(max_idx, _mm512_min_ps(a, b)));
+        const __m256 extent = _mm256_max_ps(_mm256_sub_ps(hi, lo), _mm256_setzero_ps());
+        product = _mm512_mul_pd(product, _mm512_mask_cvtps_pd(one, kd, extent));
+    }
+    return _mm512_reduce_mul_pd(product);
+}
+
 #endif // x86 SIMD
 
 #if defined(__aarch64__) || defined(__arm64__)
@@ -636,6 +892,30 @@ void expand_point_neon(int32_t* box, const double* point, int dimensions) {
     }
 }
 
+// NEON match matrix: 4 children per compare
+void match_matrix_neon(const float* queries, const uint32_t* active, size_t nactive,
+                       const float* mins, const float* maxs, size_t stride,
+                       int dimensions, uint64_t* out) {
+    static const uint32_t kLaneBits[4] = {1, 2, 4, 8};
+    const uint32x4_t laneBits = vld1q_u32(kLaneBits);
+    const size_t words = (stride + 63) / 64;
+    for (size_t i = 0; i < nactive; ++i) {
+        const float* q = queries + static_cast<size_t>(active[i]) * 2 * dimensions;
+        uint64_t* row = out + i * words;
+        std::fill(row, row + words, 0);
+        for (size_t c = 0; c < stride; c += 4) {
+            uint32x4_t hit = vdupq_n_u32(0xFFFFFFFFu);
+            for (int d = 0; d < dimensions; ++d) {
+                const float32x4_t cmin = vld1q_f32(mins + d * stride + c);
+                const float32x4_t cmax = vld1q_f32(maxs + d * stride + c);
+                hit = vandq_u32(hit, vcleq_f32(cmin, vdupq_n_f32(q[2 * d + 1])));
+                hit = vandq_u32(hit, vcgeq_f32(cmax, vdupq_n_f32(q[2 * d])));
+            }
+            row[c >> 6] |= static_cast<uint64_t>(vaddvq_u32(vandq_u32(hit, laneBits))) << (c & 63);
+        }
+    }
+}
+
 #endif // __ARM_NEON
 #endif // ARM64
 
@@ -645,66 +925,78 @@ void expand_point_neon(int32_t* box, const double* point, int dimensions) {
 #undef SIMD_ALIGN
 #undef SIMD_RESTRICT
 #undef SIMD_TARGET_SSE2
+#undef SIMD_TARGET_AVX2
+#undef SIMD_TARGET_AVX512
 
-// Function to get optimal intersects implementation
-intersects_func_t get_optimal_intersects_func() {
-    const auto& features = CPUFeatures::get();
-    
-#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
-    if (features.has_avx2) {
-        return simd_impl::intersects_avx2;
-    } else if (features.has_sse2) {
-        return simd_impl::intersects_sse2;
-    }
-#elif defined(__aarch64__) || defined(__arm64__)
-    if (features.has_neon) {
-        return simd_impl::intersects_neon;
-    }
-#endif
-    
-    return simd_impl::intersects_scalar;
-}
-
-// Function to get optimal expand implementation
-expand_func_t get_optimal_expand_func() {
-    const auto& features = CPUFeatures::get();
-    
+// Kernel tables, widest tier first - see select_kernel() in cpu_features.h.
+// A new kernel gets runtime dispatch by adding a table here; its getter is
+// then a one-line select_kernel() call.
 #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
-    if (features.has_avx2) {
-        return simd_impl::expand_avx2;
-    } else if (features.has_sse2) {
-        return simd_impl::expand_sse2;
-    }
-#elif defined(__aarch64__) || defined(__arm64__)
-#if defined(__ARM_NEON)
-    if (features.has_neon) {
-        return simd_impl::expand_neon;
-    }
-#endif
-#endif
-    
-    return simd_impl::expand_scalar;
-}
-
-// Function to get optimal expand_point implementation
-expand_point_func_t get_optimal_expand_point_func() {
-    const auto& features = CPUFeatures::get();
-    
-#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
-    if (features.has_avx2) {
-        return simd_impl::expand_point_avx2;
-    } else if (features.has_sse2) {
-        return simd_impl::expand_point_sse2;
-    }
-#elif defined(__aarch64__) || defined(__arm64__)
-#if defined(__ARM_NEON)
-    if (features.has_neon) {
-        return simd_impl::expand_point_neon;
-    }
+    #define XTREE_KERNEL_X86(tier, fn) {SimdTier::tier, fn},
+#else
+    #define XTREE_KERNEL_X86(tier, fn)
 #endif
+#if (defined(__aarch64__) || defined(__arm64__)) && defined(__ARM_NEON)
+    #define XTREE_KERNEL_NEON(fn) {SimdTier::NEON, fn},
+#else
+    #define XTREE_KERNEL_NEON(fn)
 #endif
-    
-    return simd_impl::expand_point_scalar;
-}
 
-} // namespace xtree
\ No newline at end of file
+static const KernelVariant<intersects_func_t> intersects_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::intersects_avx512)
+    XTREE_KERNEL_X86(AVX2, simd_impl::intersects_avx2)
+    XTREE_KERNEL_X86(SSE2, simd_impl::intersects_sse2)
+    XTREE_KERNEL_NEON(simd_impl::intersects_neon)
+    {SimdTier::SCALAR, simd_impl::intersects_scalar},
+};
+
+static const KernelVariant<contains_func_t> contains_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::contains_avx512)
+    {SimdTier::SCALAR, simd_impl::contains_scalar},
+};
+
+static const KernelVariant<expand_func_t> expand_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::expand_avx512)
+    XTREE_KERNEL_X86(AVX2, simd_impl::expand_avx2)
+    XTREE_KERNEL_X86(SSE2, simd_impl::expand_sse2)
+    XTREE_KERNEL_NEON(simd_impl::expand_neon)
+    {SimdTier::SCALAR, simd_impl::expand_scalar},
+};
+
+static const KernelVariant<expand_point_func_t> expand_point_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::expand_point_avx512)
+    XTREE_KERNEL_X86(AVX2, simd_impl::expand_point_avx2)
+    XTREE_KERNEL_X86(SSE2, simd_impl::expand_point_sse2)
+    XTREE_KERNEL_NEON(simd_impl::expand_point_neon)
+    {SimdTier::SCALAR, simd_impl::expand_point_scalar},
+};
+
+static const KernelVariant<area_func_t> area_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::area_avx512)
+    {SimdTier::SCALAR, simd_impl::area_scalar},
+};
+
+static const KernelVariant<overlap_func_t> overlap_variants[] = {
+    XTREE_KERNEL_X86(AVX512, simd_impl::overlap_avx512)
+    {SimdTier::SCALAR, simd_impl::overlap_scalar},
+};
+
+static const KernelVariant<match_matrix_func_t> match_matrix_variants[] = {
+    XTREE_KERNEL_X86(AVX2, simd_impl::match_matrix_avx2)
+    XTREE_KERNEL_X86(SSE2, simd_impl::match_matrix_sse2)
+    XTREE_KERNEL_NEON(simd_impl::match_matrix_neon)
+    {SimdTier::SCALAR, simd_impl::match_matrix_scalar},
+};
+
+#undef XTREE_KERNEL_X86
+#undef XTREE_KERNEL_NEON
+
+intersects_func_t get_optimal_intersects_func() { return select_kernel(intersects_variants); }
+contains_func_t get_optimal_contains_func() { return select_kernel(contains_variants); }
+expand_func_t get_optimal_expand_func() { return select_kernel(expand_variants); }
+expand_point_func_t get_optimal_expand_point_func() { return select_kernel(expand_point_variants); }
+area_func_t get_optimal_area_func() { return select_kernel(area_variants); }
+overlap_func_t get_optimal_overlap_func() { return select_kernel(overlap_variants); }
+match_matrix_func_t get_optimal_match_matrix_func() { return select_kernel(match_matrix_variants); }
+
+} // namespace xtree
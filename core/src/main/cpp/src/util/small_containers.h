@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Stack and FIFO ring with inline storage for query scratch state.
+ *
+ * Both hold their first N elements inside the object, so a container that
+ * never grows past N costs no heap allocation at all. Past N they spill to
+ * a heap buffer that is kept across clear(); an owner that is reused (a
+ * pooled Iterator, say) therefore allocates only while it warms up to the
+ * largest query it has seen, and never on the steady-state path.
+ *
+ * Elements must be trivially copyable - these hold pointers and small
+ * PODs, and growth is a plain copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace xtree {
+
+template< typename T, size_t N >
+class SmallStack {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallStack holds trivially copyable types");
+    static_assert(N > 0, "SmallStack needs inline capacity");
+
+public:
+    SmallStack() = default;
+    SmallStack(const SmallStack& o) { *this = o; }
+    SmallStack& operator=(const SmallStack& o) {
+        if (this != &o) {
+            clear();
+            _reserve(o._size);
+            std::copy(o._data, o._data + o._size, _data);
+            _size = o._size;
+        }
+        return *this;
+    }
+
+    void push(const T& v) {
+        if (_size == _cap) {
+            _reserve(_cap * 2);
+        }
+        _data[_size++] = v;
+    }
+
+    T& top() { return _data[_size - 1]; }
+    void pop() { --_size; }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    size_t capacity() const { return _cap; }
+
+    // Drops the elements but keeps any spilled buffer
+    void clear() { _size = 0; }
+
+private:
+    void _reserve(size_t cap) {
+        if (cap <= _cap) return;
+        std::vector<T> bigger(cap);
+        std::copy(_data, _data + _size, bigger.begin());
+        _heap.swap(bigger);
+        _data = _heap.data();
+        _cap = cap;
+    }
+
+    T _inline[N];
+    T* _data = _inline;
+    size_t _size = 0;
+    size_t _cap = N;
+    std::vector<T> _heap;
+};
+
+template< typename T, size_t N >
+class SmallRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallRing holds trivially copyable types");
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SmallRing inline capacity must be a power of two");
+
+public:
+    SmallRing() = default;
+    SmallRing(const SmallRing& o) { *this = o; }
+    SmallRing& operator=(const SmallRing& o) {
+        if (this != &o) {
+            clear();
+            for (size_t i = 0; i < o._size; ++i) {
+                push_back(o._data[(o._head + i) & (o._cap - 1)]);
+            }
+        }
+        return *this;
+    }
+
+    void push_back(const T& v) {
+        if (_size == _cap) {
+            _grow();
+        }
+        _data[(_head + _size) & (_cap - 1)] = v;
+        ++_size;
+    }
+
+    T& front() { return _data[_head]; }
+    void pop_front() {
+        _head = (_head + 1) & (_cap - 1);
+        --_size;
+    }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    size_t capacity() const { return _cap; }
+
+    // Drops the elements but keeps any spilled buffer
+    void clear() {
+        _head = 0;
+        _size = 0;
+    }
+
+private:
+    // Double the capacity, unrolling the ring to start at slot 0
+    void _grow() {
+        std::vector<T> bigger(_cap * 2);
+        for (size_t i = 0; i < _size; ++i) {
+            bigger[i] = _data[(_head + i) & (_cap - 1)];
+        }
+        _heap.swap(bigger);
+        _data = _heap.data();
+        _cap *= 2;
+        _head = 0;
+    }
+
+    T _inline[N];
+    T* _data = _inline;
+    size_t _head = 0;
+    size_t _size = 0;
+    size_t _cap = N;
+    std::vector<T> _heap;
+};
+
+}
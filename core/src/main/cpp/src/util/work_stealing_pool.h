@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Fixed-size work-stealing thread pool for fork/join batches.
+ *
+ * run(count, fn) deals task indices [0, count) round-robin onto per-worker
+ * deques and blocks until fn(task, worker) has returned for all of them.
+ * A worker pops its own deque from the back and, once that is empty, steals
+ * from the front of the others, so uneven tasks (e.g. subtrees of very
+ * different sizes) still keep every worker busy until the batch drains.
+ *
+ * The worker index passed to fn is stable for the thread and lies in
+ * [0, size()), so callers can keep per-worker state without locking.
+ * The first exception thrown by a task is rethrown from run() once the
+ * batch has finished; the remaining tasks still run.
+ *
+ * Given a multi-node NumaTopology the pool runs NUMA-local: worker i is
+ * bound to the CPUs of node i % nodes, and an idle worker steals from the
+ * workers of its own node before crossing to another one.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "numa_topology.h"
+
+namespace xtree {
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t task, size_t worker)>;
+
+    explicit WorkStealingPool(size_t threads, const NumaTopology* numa = nullptr) {
+        const size_t n = threads > 0 ? threads : 1;
+        if (numa && numa->is_numa()) {
+            _numa = numa;
+        }
+        _queues.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            _queues.push_back(std::make_unique<Queue>());
+        }
+
+        // Victims in steal order: same-node workers first, nearest index first
+        _victims.resize(n);
+        for (size_t w = 0; w < n; ++w) {
+            for (int pass = 0; pass < 2; ++pass) {
+                for (size_t i = 1; i < n; ++i) {
+                    const size_t v = (w + i) % n;
+                    if ((homeNode(v) == homeNode(w)) == (pass == 0)) {
+                        _victims[w].push_back(v);
+                    }
+                }
+            }
+        }
+
+        _workers.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            _workers.emplace_back([this, i] {
+                if (_numa) {
+                    _numa->bind_current_thread(homeNode(i));
+                }
+                workerLoop(i);
+            });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& t : _workers) {
+            t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return _workers.size(); }
+
+    bool numaLocal() const { return _numa != nullptr; }
+
+    // Dense NUMA node a worker is bound to (0 unless NUMA-local)
+    size_t homeNode(size_t worker) const {
+        return _numa ? worker % _numa->node_count() : 0;
+    }
+
+    // Tasks taken from another worker's deque since construction
+    uint64_t steals() const { return _steals.load(std::memory_order_relaxed); }
+
+    // Run fn for every task in [0, count) and wait for all of them.
+    // Batches from different callers are serialized.
+    void run(size_t count, const Task& fn) {
+        if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> batch(_runMtx);
+
+        std::unique_lock<std::mutex> lock(_mtx);
+        _fn = &fn;
+        _error = nullptr;
+        _pending = count;
+        ++_generation;
+
+        // Publish tasks only once _fn is set: a queued task always belongs
+        // to the current batch, however late a worker gets to it
+        for (size_t t = 0; t < count; ++t) {
+            Queue& q = *_queues[t % _queues.size()];
+            std::lock_guard<std::mutex> qlock(q.mtx);
+            q.tasks.push_back(t);
+        }
+        _wake.notify_all();
+        _done.wait(lock, [this] { return _pending == 0; });
+        _fn = nullptr;
+
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mtx;
+        std::deque<size_t> tasks;
+    };
+
+    bool popOwn(size_t worker, size_t& task) {
+        Queue& q = *_queues[worker];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t worker, size_t& task) {
+        for (size_t victim : _victims[worker]) {
+            Queue& q = *_queues[victim];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                _steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(_mtx);
+                _wake.wait(lock, [&] { return _stop || _generation != seen; });
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+            }
+
+            // No task spawns more work, so empty deques mean this worker is done
+            size_t task;
+            while (popOwn(worker, task) || steal(worker, task)) {
+                const Task* fn;
+                {
+                    // The batch cannot finish while this task is outstanding
+                    std::lock_guard<std::mutex> lock(_mtx);
+                    fn = _fn;
+                }
+                std::exception_ptr error;
+                try {
+                    (*fn)(task, worker);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(_mtx);
+                if (error && !_error) {
+                    _error = error;
+                }
+                if (--_pending == 0) {
+                    _done.notify_all();
+                }
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::vector<size_t>> _victims;
+    const NumaTopology* _numa = nullptr;
+    std::vector<std::thread> _workers;
+    std::mutex _runMtx;                 // One batch at a time
+    std::mutex _mtx;                    // Guards everything below
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    const Task* _fn = nullptr;
+    std::exception_ptr _error;
+    size_t _pending = 0;
+    uint64_t _generation = 0;
+    bool _stop = false;
+    std::atomic<uint64_t> _steals{0};
+};
+
+} // namespace xtree
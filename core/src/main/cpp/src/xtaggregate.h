@@ -0,0 +1,228 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "xtree.h"
+
+namespace xtree {
+
+    /**
+     * COUNT and grid histogram queries answered from subtree counts.
+     *
+     * Every bucket child entry carries the number of records stored below
+     * it, so a subtree whose MBR lies entirely inside the query box (for a
+     * histogram: inside the box and within a single grid cell) contributes
+     * its count without being loaded. Only subtrees that straddle the box
+     * or a cell boundary are descended, and their data records are tested
+     * one at a time. Entries read from a snapshot written before counts
+     * were kept have an unknown count and are always descended.
+     *
+     * The tree must not be modified while a query runs.
+     */
+    template< class RecordType >
+    class AggregateQueryExecutor {
+    typedef typename xtree::XTreeBucket<RecordType>::CacheNode   CacheNode;
+    typedef typename xtree::XTreeBucket<RecordType>::_MBRKeyNode MBRKeyNode;
+
+    public:
+        explicit AggregateQueryExecutor(IndexDetails<RecordType>* idx) :
+            _idx(idx),
+            _dims(idx->getDimensionCount()) {
+        }
+
+        // Buckets entered, and subtrees counted without being entered, by the last query
+        uint64_t lastNodesVisited() const { return _nodesVisited; }
+        uint64_t lastSubtreesCounted() const { return _subtreesCounted; }
+
+        /**
+         * Number of records below startNode whose key intersects the box of
+         * searchKey - the rows an INTERSECTS Iterator would return.
+         */
+        uint64_t count(CacheNode* startNode, IRecord* searchKey) {
+            const float* q = _box(searchKey);
+            uint64_t total = 0;
+            _walk(startNode, [&](const MBRKeyNode* kn, const float* k) -> bool {
+                if (!_intersects(k, q)) {
+                    return true;
+                }
+                if (kn->isDataRecord()) {
+                    total++;
+                    return true;
+                }
+                const uint64_t c = kn->subtreeCount();
+                if (c != MBRKeyNode::UNKNOWN_COUNT && _within(k, q)) {
+                    total += c;
+                    _subtreesCounted++;
+                    return true;
+                }
+                return false;
+            });
+            return total;
+        }
+
+        /**
+         * Record counts per cell of a grid laid over searchKey's box.
+         *
+         * grid[d] is the number of equal-width cells along dimension d;
+         * dimensions past grid.size() get a single cell. A record falls in
+         * the cell holding the centre of its key, and records whose centre is
+         * outside the box are not counted. Cells are numbered row-major with
+         * dimension 0 varying slowest.
+         *
+         * @throws std::runtime_error if grid has more entries than the index
+         *         has dimensions, or a zero entry
+         */
+        std::vector<uint64_t> histogram(CacheNode* startNode, IRecord* searchKey,
+                                        const std::vector<uint32_t>& grid) {
+            if (grid.size() > _dims) {
+                throw std::runtime_error("histogram: grid has more dimensions than the index");
+            }
+            size_t cells = 1;
+            _cells.assign(_dims, 1);
+            for (size_t d = 0; d < grid.size(); ++d) {
+                if (grid[d] == 0) {
+                    throw std::runtime_error("histogram: grid dimension with zero cells");
+                }
+                _cells[d] = grid[d];
+                cells *= grid[d];
+            }
+
+            std::vector<uint64_t> counts(cells, 0);
+            const float* q = _box(searchKey);
+            _walk(startNode, [&](const MBRKeyNode* kn, const float* k) -> bool {
+                if (kn->isDataRecord()) {
+                    size_t cell = 0;
+                    for (unsigned short d = 0; d < _dims; ++d) {
+                        const float c = (k[2 * d] + k[2 * d + 1]) * 0.5f;
+                        if (c < q[2 * d] || c > q[2 * d + 1]) {
+                            return true;
+                        }
+                        cell = cell * _cells[d] + _cellOf(c, q, d);
+                    }
+                    counts[cell]++;
+                    return true;
+                }
+                if (!_intersects(k, q)) {
+                    return true;
+                }
+                const uint64_t c = kn->subtreeCount();
+                if (c == MBRKeyNode::UNKNOWN_COUNT || !_within(k, q)) {
+                    return false;
+                }
+                // Centres lie inside the MBR and cells are monotone, so an MBR
+                // whose corners share a cell holds only records of that cell
+                size_t cell = 0;
+                for (unsigned short d = 0; d < _dims; ++d) {
+                    const uint32_t lo = _cellOf(k[2 * d], q, d);
+                    if (lo != _cellOf(k[2 * d + 1], q, d)) {
+                        return false;
+                    }
+                    cell = cell * _cells[d] + lo;
+                }
+                counts[cell] += c;
+                _subtreesCounted++;
+                return true;
+            });
+            return counts;
+        }
+
+    private:
+        /**
+         * Depth-first walk below startNode. visit(kn, key) returns true when
+         * it has accounted for the entry and false to descend into it.
+         */
+        template< typename Visit >
+        void _walk(CacheNode* startNode, Visit&& visit) {
+            _nodesVisited = 0;
+            _subtreesCounted = 0;
+            if (!startNode || !startNode->object || startNode->object->isDataNode()) {
+                return;
+            }
+            _stack.clear();
+            _stack.push_back(startNode);
+
+            while (!_stack.empty()) {
+                CacheNode* cn = _stack.back();
+                _stack.pop_back();
+                auto* bucket = reinterpret_cast<XTreeBucket<RecordType>*>(cn->object);
+                auto* children = bucket->getChildren();
+                if (!children) continue;
+                _nodesVisited++;
+
+                const size_t n = std::min<size_t>(bucket->n(), children->size());
+                for (size_t i = 0; i < n; ++i) {
+                    MBRKeyNode* kn = (*children)[i];
+                    const KeyMBR* key = kn ? kn->getKey() : nullptr;
+                    if (!key || !key->data() || visit(kn, key->data())) {
+                        continue;
+                    }
+                    CacheNode* child = kn->template cache_or_load<RecordType>(_idx);
+                    if (child && child->object && !child->object->isDataNode()) {
+                        _stack.push_back(child);
+                    }
+                }
+            }
+        }
+
+        const float* _box(IRecord* searchKey) const {
+            const KeyMBR* key = searchKey ? searchKey->getKey() : nullptr;
+            if (!key || !key->data()) {
+                throw std::runtime_error("aggregate query: search key has no box");
+            }
+            return key->data();
+        }
+
+        bool _intersects(const float* k, const float* q) const {
+            for (unsigned short d = 0; d < _dims; ++d) {
+                if (k[2 * d] > q[2 * d + 1] || k[2 * d + 1] < q[2 * d]) return false;
+            }
+            return true;
+        }
+
+        bool _within(const float* k, const float* q) const {
+            for (unsigned short d = 0; d < _dims; ++d) {
+                if (k[2 * d] < q[2 * d] || k[2 * d + 1] > q[2 * d + 1]) return false;
+            }
+            return true;
+        }
+
+        // Cell of v (inside the box) along d; the top edge belongs to the last cell
+        uint32_t _cellOf(float v, const float* q, unsigned short d) const {
+            const double width = static_cast<double>(q[2 * d + 1]) - q[2 * d];
+            if (_cells[d] == 1 || width <= 0) {
+                return 0;
+            }
+            const double pos = (static_cast<double>(v) - q[2 * d]) / width * _cells[d];
+            return static_cast<uint32_t>(std::min<double>(pos, _cells[d] - 1));
+        }
+
+        IndexDetails<RecordType>* _idx;
+        unsigned short _dims;
+        std::vector<uint32_t> _cells;       // Grid of the running histogram
+        std::vector<CacheNode*> _stack;
+
+        uint64_t _nodesVisited = 0;
+        uint64_t _subtreesCounted = 0;
+    };
+}
@@ -19,16 +19,28 @@
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <memory>
-#include <deque>
+#include <stdexcept>
 #include <string_view>
+#include <utility>
+#include <vector>
+#include "config.h"
 #include "datarecord.hpp"  // For IDataRecord interface
+#include "util/small_containers.h"
 
 namespace xtree {
 
+    template< class RecordType > class IteratorPool;
+
     /**
      * Iterator
+     *
+     * The traversal stack and record queue live inline in the object (see
+     * XTREE_ITER_STACK_INLINE / XTREE_ITER_QUEUE_INLINE) and keep any heap
+     * spill across reset(), so an Iterator that is constructed on the stack
+     * or taken from an IteratorPool runs queries without allocating.
      */
     template< class RecordType >
     class Iterator {
@@ -51,10 +63,24 @@ namespace xtree {
             _startNode(startNode),
             _searchKey(searchKey),
             _searchType(searchType),
+            _idx(idx),
             _hasNext(true),
-            _invalidated(false),
-            _traversalOrder(NULL),
-            _idx(idx) {
+            _invalidated(false) {
+            _init();
+        }
+
+        /**
+         * Start a new query on this iterator. Buffers grown by earlier
+         * queries are kept, so reusing an iterator allocates nothing once
+         * it has seen a query of this size.
+         */
+        void reset(CacheNode* startNode, IRecord* searchKey, SearchType searchType,
+                   IndexDetails<RecordType>* idx = nullptr) {
+            _startNode = startNode;
+            _searchKey = searchKey;
+            _searchType = searchType;
+            _idx = idx;
+            _release();
             _init();
         }
 
@@ -151,6 +177,59 @@ namespace xtree {
             return false;
         }
 
+        /**
+         * Fetch up to maxRows row IDs in one call.
+         *
+         * Row IDs are copied back to back into out; row i occupies
+         * [ends[i-1], ends[i]) with ends[-1] taken as 0. If keys is non-null
+         * it receives each row's MBR as dims*2 floats (min/max per axis).
+         * Uncached DURABLE records are read straight from their pinned wire
+         * bytes - no DataRecordView is built and nothing enters the cache.
+         * A row that does not fit in the remaining space stays queued for
+         * the next call.
+         *
+         * @return rows written, 0 once the iterator is exhausted
+         * @throws std::length_error if one row ID is larger than outCapacity
+         */
+        size_t nextBatch(char* out, size_t outCapacity, uint32_t* ends, size_t maxRows,
+                         float* keys = nullptr);
+
+        /**
+         * Refine MBR matches against the records' exact (double) coordinates
+         * before they are returned. The MBR test alone can yield false
+         * positives because keys are rounded out to float. Applies to
+         * nextBatch(); next() and friends are unchanged.
+         */
+        void setExactRefinement(bool enabled) {
+            _exactRefinement = enabled;
+            _exactQueryReady = false;
+        }
+
+        /**
+         * How many children ahead of the one being expanded to prefetch; 0
+         * turns prefetching off. Cached children get a CPU prefetch of their
+         * key and node header; uncached DURABLE children that match the query
+         * are handed to the store's prefetch_node() so their pages are read
+         * in while earlier siblings load.
+         *
+         * setPrefetchDistance() applies to the rest of the current query
+         * (the first page is traversed by the constructor or reset()); new
+         * and reset iterators start from the process-wide default, which
+         * begins at XTREE_PREFETCH_DISTANCE.
+         */
+        void setPrefetchDistance(unsigned distance) {
+            _prefetchDistance = distance;
+        }
+        static void setDefaultPrefetchDistance(unsigned distance) {
+            _defaultPrefetchDistance.store(distance, std::memory_order_relaxed);
+        }
+        static unsigned defaultPrefetchDistance() {
+            return _defaultPrefetchDistance.load(std::memory_order_relaxed);
+        }
+
+        // Read-ahead hints passed to the store by this query so far
+        uint64_t storePrefetches() const { return _storePrefetches; }
+
         bool hasNext() {
             return _hasNext || _recordQueue.size() > 0;
         }
@@ -165,10 +244,45 @@ namespace xtree {
         bool intersects(CacheNode* nodeHandle, ...);
         bool contains(CacheNode* nodeHandle, ...);
 
-        template< typename TraversalOrder >
+        // Depth-first, one page of results per call
         void traverse( CacheNode* nodeHandle, bool(xtree::Iterator<RecordType>::* visit)(CacheNode*, ...) );
 
     private:
+        friend class IteratorPool<RecordType>;
+
+        // Drop the current query's state, keeping buffer capacity
+        void _release() {
+            _recordQueue.clear();
+            _stack.clear();
+            _traversalStarted = false;
+            owned_ephemeral_.reset();
+            _hasNext = true;
+            _invalidated = false;
+            _exactRefinement = false;
+            _exactQueryReady = false;
+            _pinnedReadsUnsupported = false;
+            _prefetchDistance = defaultPrefetchDistance();
+            _storePrefetches = 0;
+        }
+
+        // Where nextBatch() is writing
+        struct BatchOutput {
+            char* out;
+            size_t capacity;
+            size_t used;
+            uint32_t* ends;
+            float* keys;
+            size_t rows;
+        };
+
+        enum class BatchStep { ADDED, SKIPPED, NO_ROOM };
+
+        BatchStep _batchItem(QueueItem& qi, BatchOutput& b, unsigned short dims);
+        BatchStep _batchEmit(BatchOutput& b, std::string_view rowid, unsigned short dims,
+                             const uint8_t* wireKey, const KeyMBR* key);
+        bool _exactMatch(const double* recordBounds, unsigned short dims);
+        void _prefetch(MBRKeyNode* kn, const KeyMBR* searchKey);
+
         void _init() {
             bool (Iterator<RecordType>::* visit)(CacheNode*, ...);
             switch(_searchType) {
@@ -188,7 +302,7 @@ namespace xtree {
             }
 
             // traverse the tree
-            (*this).template traverse<DFS>(_startNode, visit);
+            traverse(_startNode, visit);
         }
 
 //        string toJSON(/*DataRecord* record*/) {
@@ -210,13 +324,104 @@ namespace xtree {
         CacheNode* _startNode;
         IRecord* _searchKey;
         SearchType _searchType;
-        std::deque<QueueItem> _recordQueue;     // O(1) pop_front() for efficient queue ops
+        SmallRing<QueueItem, XTREE_ITER_QUEUE_INLINE> _recordQueue;
+        SmallStack<CacheNode*, XTREE_ITER_STACK_INLINE> _stack;    // DFS frontier
+        bool _traversalStarted = false;
         std::unique_ptr<IRecord> owned_ephemeral_;  // Owns at most one ephemeral view
         IndexDetails<RecordType>* _idx;         // Needed to resolve DURABLE records
         bool _hasNext;
         bool _invalidated;
-        void* _traversalOrder;                  // void pointers aren't really smart, as
-                                                // you can guarantee proper destruction
-                                                // of the object pointed to
+        bool _exactRefinement = false;
+        bool _exactQueryReady = false;
+        bool _pinnedReadsUnsupported = false;   // Store threw once; use cache_or_load
+        unsigned _prefetchDistance = defaultPrefetchDistance();
+        static inline std::atomic<unsigned> _defaultPrefetchDistance{XTREE_PREFETCH_DISTANCE};
+        uint64_t _storePrefetches = 0;
+        std::vector<double> _exactQuery;        // Query bounds, min/max per axis
+        std::vector<double> _exactScratch;      // Record bounds
+    };
+
+    /**
+     * Per-thread pool of idle iterators.
+     *
+     * acquire() hands out a reset iterator, reusing one returned earlier on
+     * this thread when there is one, so steady-state queries neither
+     * allocate the Iterator nor regrow its buffers. Up to
+     * XTREE_ITER_POOL_SIZE iterators are kept per thread; extras are freed.
+     */
+    template< class RecordType >
+    class IteratorPool {
+    typedef typename xtree::XTreeBucket<RecordType>::CacheNode CacheNode;
+
+    public:
+        static Iterator<RecordType>* acquire(CacheNode* startNode, IRecord* searchKey,
+                                             SearchType searchType,
+                                             IndexDetails<RecordType>* idx = nullptr) {
+            auto& idle = _idle();
+            if (idle.empty()) {
+                return new Iterator<RecordType>(startNode, searchKey, searchType, idx);
+            }
+            Iterator<RecordType>* iter = idle.back();
+            idle.pop_back();
+            iter->reset(startNode, searchKey, searchType, idx);
+            return iter;
+        }
+
+        static void release(Iterator<RecordType>* iter) {
+            if (!iter) return;
+            auto& idle = _idle();
+            if (idle.size() >= XTREE_ITER_POOL_SIZE) {
+                delete iter;
+                return;
+            }
+            iter->_release();
+            idle.push_back(iter);
+        }
+
+        // Iterators idle in the calling thread's pool
+        static size_t idleCount() { return _idle().size(); }
+
+    private:
+        struct IdleList : std::vector<Iterator<RecordType>*> {
+            IdleList() { this->reserve(XTREE_ITER_POOL_SIZE); }
+            ~IdleList() {
+                for (auto* iter : *this) delete iter;
+            }
+        };
+
+        static IdleList& _idle() {
+            static thread_local IdleList idle;
+            return idle;
+        }
+    };
+
+    /**
+     * Owning handle to a pooled iterator; returns it to the calling
+     * thread's IteratorPool when destroyed.
+     */
+    template< class RecordType >
+    class PooledIterator {
+    public:
+        PooledIterator() = default;
+        explicit PooledIterator(Iterator<RecordType>* iter) : _iter(iter) {}
+        PooledIterator(PooledIterator&& o) noexcept : _iter(std::exchange(o._iter, nullptr)) {}
+        PooledIterator& operator=(PooledIterator&& o) noexcept {
+            if (this != &o) {
+                IteratorPool<RecordType>::release(_iter);
+                _iter = std::exchange(o._iter, nullptr);
+            }
+            return *this;
+        }
+        PooledIterator(const PooledIterator&) = delete;
+        PooledIterator& operator=(const PooledIterator&) = delete;
+        ~PooledIterator() { IteratorPool<RecordType>::release(_iter); }
+
+        Iterator<RecordType>* get() const { return _iter; }
+        Iterator<RecordType>* operator->() const { return _iter; }
+        Iterator<RecordType>& operator*() const { return *_iter; }
+        explicit operator bool() const { return _iter != nullptr; }
+
+    private:
+        Iterator<RecordType>* _iter = nullptr;
     };
 }
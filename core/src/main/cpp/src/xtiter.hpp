@@ -17,6 +17,8 @@
  * https://www.gnu.org/licenses/agpl-3.0.html
  */
 
+#include <algorithm>
+#include "perf_macros.h"
 #include "xtiter.h"
 
 namespace xtree {
@@ -78,27 +80,20 @@ namespace xtree {
      * and defer loading to next() for zero heap retention during traversal.
      */
     template< class RecordType >
-    template< typename TraversalOrder >
     void Iterator<RecordType>::traverse(typename Iterator<RecordType>::CacheNode* nodeHandle,
                                         bool(xtree::Iterator<RecordType>::* visit)(
                                         typename Iterator<RecordType>::CacheNode*, ...) ) {
-        // Init/restore traversal order (stack or queue)
-        TraversalOrder *sq;
-        if(_traversalOrder == NULL) {
-            sq = new TraversalOrder();
-            _traversalOrder = static_cast<void*>(sq);
-            
+        // The frontier persists in _stack between pages
+        auto* sq = &_stack;
+        if (!_traversalStarted) {
+            _traversalStarted = true;
             if (nodeHandle && nodeHandle->object) {
                 sq->push(nodeHandle);
             } else {
                 // Root should always be cached; bail safely if not
                 _hasNext = false;
-                delete sq;
-                _traversalOrder = NULL;
                 return;
             }
-        } else {
-            sq = static_cast<TraversalOrder*>(_traversalOrder);
         }
 
         // MBR-based predicate for data children (avoids materialization)
@@ -124,11 +119,12 @@ namespace xtree {
 
         // Walk until we've filled a page of results or traversal is empty
         while(!sq->empty() && _recordQueue.size()<XTREE_ITER_PAGE_SIZE) {
-            CacheNode* cur = top(*sq);
+            CacheNode* cur = sq->top();
+            sq->pop();
             
             // Safety: internal nodes must have materialized objects
             if (cur && cur->object && !cur->object->isDataNode()) {
-                bool proceed = (this->* visit)(pull(*sq));  // visit internal bucket
+                bool proceed = (this->* visit)(cur);  // visit internal bucket
                 
                 if( proceed ) {
                     // Expand children
@@ -136,18 +132,33 @@ namespace xtree {
                     auto* children = bucket ? bucket->getChildren() : nullptr;
                     if (!children) continue;
                     
-                    int n = 0;
-                    for(typename vector<MBRKeyNode*>::const_iterator iter = children->begin();
-                        n<bucket->n() && iter != children->end(); iter++, ++n
-                    ) {
-                        MBRKeyNode* kn = *iter;
+                    const size_t n = std::min<size_t>(bucket->n(), children->size());
+                    const KeyMBR* searchKey = _searchKey ? _searchKey->getKey() : nullptr;
+                    size_t ahead = 1;   // next child to prefetch
+                    for (size_t i = 0; i < n; ++i) {
+                        // Keep the prefetch window _prefetchDistance children ahead
+                        if (_prefetchDistance) {
+                            const size_t until = std::min(n, i + _prefetchDistance + 1);
+                            for (ahead = std::max(ahead, i + 1); ahead < until; ++ahead) {
+                                if ((*children)[ahead]) _prefetch((*children)[ahead], searchKey);
+                            }
+                        }
+
+                        MBRKeyNode* kn = (*children)[i];
                         if (!kn) continue;
                         
                         // Internal child: use cache_or_load for unified lazy loading
                         if (!kn->isDataRecord()) {
+                            // Every search type needs overlap, so a disjoint subtree
+                            // is skipped without being loaded
+                            const KeyMBR* childKey = kn->getKey();
+                            if (searchKey && childKey && !childKey->intersects(*searchKey)) {
+                                continue;
+                            }
                             // Production path: cache_or_load handles both cached and persistent nodes
                             CacheNode* childCN = kn->template cache_or_load<RecordType>(_idx);
                             if (childCN) {
+                                PREFETCH(childCN->object, 0, 1);
                                 sq->push(childCN);
                             }
 #ifndef NDEBUG
@@ -173,18 +184,201 @@ namespace xtree {
                         }
                     }
                 }
-            } else {
-                // Unexpected null object in traversal order - pop and continue
-                pull(*sq);
             }
+            // Unexpected null object in traversal order - already popped, continue
         }
         _hasNext = (sq->size()>0);
-        // since _traversalOrder is a void pointer you can't guarantee that the
-        // referenced object is properly destructed, by deleting sq and resetting
-        // _traversalOrder we are ensuring proper cleanup of the {stack|queue}
-        if(_hasNext == false) {
-            delete sq;
-            _traversalOrder = NULL;
-        }
     };
+
+    /**
+     * Prefetch a child the expansion loop will reach shortly. Its key is
+     * pulled toward the CPU for the MBR test. An uncached DURABLE child that
+     * can match is handed to the store, so its pages are read in while the
+     * siblings before it load.
+     */
+    template< class RecordType >
+    void Iterator<RecordType>::_prefetch(MBRKeyNode* kn, const KeyMBR* searchKey) {
+        const KeyMBR* key = kn->getKey();
+        if (!key) {
+            return;
+        }
+        PREFETCH(key->data(), 0, 1);
+
+        if (!_idx || !searchKey || !kn->hasNodeID() ||
+            _idx->getPersistenceMode() != IndexDetails<RecordType>::PersistenceMode::DURABLE) {
+            return;
+        }
+        if (!key->intersects(*searchKey)) {
+            return;
+        }
+        const persist::NodeID nid = kn->getNodeID();
+        if (_idx->getCache().find(_idx->cacheKey(nid))) {
+            return;
+        }
+        if (auto* store = _idx->getStore()) {
+            store->prefetch_node(nid);
+            _storePrefetches++;
+        }
+    }
+
+    /**
+     * Batch row ID retrieval - see Iterator::nextBatch()
+     */
+    template< class RecordType >
+    size_t Iterator<RecordType>::nextBatch(char* out, size_t outCapacity, uint32_t* ends,
+                                           size_t maxRows, float* keys) {
+        const KeyMBR* searchKey = _searchKey ? _searchKey->getKey() : nullptr;
+        if (!searchKey || maxRows == 0) {
+            return 0;
+        }
+        const unsigned short dims = searchKey->getDimensionCount();
+
+        // Any view handed out by next() is dead once we start consuming
+        owned_ephemeral_.reset();
+
+        BatchOutput b{out, outCapacity, 0, ends, keys, 0};
+        while (b.rows < maxRows) {
+            if (_recordQueue.empty()) {
+                if (!_hasNext) break;
+                _init();  // refill a page
+                continue;
+            }
+
+            const BatchStep step = _batchItem(_recordQueue.front(), b, dims);
+            if (step == BatchStep::NO_ROOM) {
+                if (b.rows == 0) {
+                    throw std::length_error("Iterator::nextBatch: row ID larger than output buffer");
+                }
+                break;  // leave the item queued for the next call
+            }
+            _recordQueue.pop_front();
+        }
+        return b.rows;
+    }
+
+    /**
+     * Resolve one queued data record and append it to the batch.
+     * Cached records are used as-is; uncached DURABLE records are read from
+     * pinned wire bytes and the pin is dropped before returning.
+     */
+    template< class RecordType >
+    typename Iterator<RecordType>::BatchStep
+    Iterator<RecordType>::_batchItem(QueueItem& qi, BatchOutput& b, unsigned short dims) {
+        IRecord* rec = (qi.cn && qi.cn->object) ? qi.cn->object : nullptr;
+
+        if (!rec && qi.kn && _idx) {
+            if (_idx->getPersistenceMode() == IndexDetails<RecordType>::PersistenceMode::DURABLE &&
+                qi.kn->hasNodeID()) {
+                const persist::NodeID nid = qi.kn->getNodeID();
+                auto* cn = _idx->getCache().find(_idx->cacheKey(nid));
+                if (cn && cn->object) {
+                    rec = cn->object;
+                } else if (auto* store = _idx->getStore(); store && !_pinnedReadsUnsupported) {
+                    try {
+                        auto pinned = store->read_node_pinned(nid);
+                        const auto* data = static_cast<const uint8_t*>(pinned.data);
+                        // Not mapped (e.g. still only in the write path) - load below
+                        if (data && pinned.size > 0) {
+                            DataRecordWire::Layout layout;
+                            if (!DataRecordWire::parse(data, pinned.size, dims, layout)) {
+                                return BatchStep::SKIPPED;
+                            }
+                            if (_exactRefinement) {
+                                _exactScratch.resize(2 * dims);
+                                if (DataRecordWire::exactBounds(data, layout, dims, _exactScratch.data()) &&
+                                    !_exactMatch(_exactScratch.data(), dims)) {
+                                    return BatchStep::SKIPPED;
+                                }
+                            }
+                            return _batchEmit(b, DataRecordWire::rowid(data, layout), dims, data, nullptr);
+                        }
+                    } catch (const std::exception&) {
+                        // Store has no pinned reads - fall back for the rest of the scan
+                        _pinnedReadsUnsupported = true;
+                    }
+                }
+            }
+            if (!rec) {
+                auto* cn = qi.kn->template cache_or_load<RecordType>(_idx);
+                rec = (cn && cn->object) ? cn->object : nullptr;
+            }
+        }
+
+        IDataRecord* d = rec ? rec->asDataRecord() : nullptr;
+        if (!d) {
+            return BatchStep::SKIPPED;
+        }
+        if (_exactRefinement) {
+            _exactScratch.resize(2 * dims);
+            if (d->getExactBounds(_exactScratch.data(), dims) &&
+                !_exactMatch(_exactScratch.data(), dims)) {
+                return BatchStep::SKIPPED;
+            }
+        }
+        return _batchEmit(b, d->getRowIDView(), dims, nullptr, rec->getKey());
+    }
+
+    template< class RecordType >
+    typename Iterator<RecordType>::BatchStep
+    Iterator<RecordType>::_batchEmit(BatchOutput& b, std::string_view rowid, unsigned short dims,
+                                     const uint8_t* wireKey, const KeyMBR* key) {
+        if (rowid.size() > b.capacity - b.used) {
+            return BatchStep::NO_ROOM;
+        }
+        std::memcpy(b.out + b.used, rowid.data(), rowid.size());
+        b.used += rowid.size();
+        b.ends[b.rows] = static_cast<uint32_t>(b.used);
+
+        if (b.keys) {
+            float* dst = b.keys + b.rows * 2 * dims;
+            if (wireKey) {
+                DataRecordWire::key(wireKey, dims, dst);
+            } else if (key && key->data()) {
+                std::memcpy(dst, key->data(), 2 * dims * sizeof(float));
+            } else {
+                std::fill(dst, dst + 2 * dims, 0.0f);
+            }
+        }
+        b.rows++;
+        return BatchStep::ADDED;
+    }
+
+    /**
+     * Exact predicate on double-precision bounds. The query bounds come from
+     * the search record's points when it has them, otherwise its float MBR.
+     */
+    template< class RecordType >
+    bool Iterator<RecordType>::_exactMatch(const double* r, unsigned short dims) {
+        if (!_exactQueryReady) {
+            _exactQuery.assign(2 * dims, 0.0);
+            const IDataRecord* qd = _searchKey->asDataRecord();
+            if (!qd || !qd->getExactBounds(_exactQuery.data(), dims)) {
+                const KeyMBR* qk = _searchKey->getKey();
+                for (unsigned short i = 0; i < 2 * dims; ++i) {
+                    _exactQuery[i] = qk->getBoxVal(i);
+                }
+            }
+            _exactQueryReady = true;
+        }
+        const double* q = _exactQuery.data();
+
+        for (unsigned short d = 0; d < dims; ++d) {
+            const double rmin = r[2 * d], rmax = r[2 * d + 1];
+            const double qmin = q[2 * d], qmax = q[2 * d + 1];
+            switch (_searchType) {
+                case INTERSECTS:
+                    if (rmin > qmax || rmax < qmin) return false;
+                    break;
+                case WITHIN:
+                    if (rmin < qmin || rmax > qmax) return false;
+                    break;
+                case CONTAINS:
+                    if (rmin > qmin || rmax < qmax) return false;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
 }
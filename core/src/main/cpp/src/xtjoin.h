@@ -0,0 +1,383 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "xtree.h"
+#include "util/work_stealing_pool.h"
+
+namespace xtree {
+
+    /**
+     * Spatial join of two indexes by synchronized traversal.
+     *
+     * Instead of running one query against the right index per record of
+     * the left one, both trees are descended together: a pair of nodes is
+     * expanded into the pairs of their children that can still match, found
+     * with a plane sweep along the first axis over the children that overlap
+     * the other node. Pairs of data records that satisfy the predicate are
+     * reported; everything else is pruned a whole node pair at a time.
+     *
+     * Node pairs near the roots are split into tasks that run on a
+     * work-stealing pool. Each worker buffers its matches and hands them to
+     * the caller's callback in chunks; the callback is called by one thread
+     * at a time, but not necessarily the calling one.
+     *
+     * Matching is on keys (MBRs), the same test Iterator makes without
+     * exact refinement. Neither tree may be modified while a join runs.
+     */
+    template< class RecordType >
+    class SpatialJoinExecutor {
+    typedef typename xtree::XTreeBucket<RecordType>::CacheNode   CacheNode;
+    typedef typename xtree::XTreeBucket<RecordType>::_MBRKeyNode MBRKeyNode;
+
+    public:
+        static constexpr size_t kTasksPerThread = 8;
+        static constexpr size_t kFlushPairs = 4096;
+
+        /**
+         * @throws std::runtime_error if the indexes differ in dimension count
+         */
+        SpatialJoinExecutor(IndexDetails<RecordType>* left, IndexDetails<RecordType>* right,
+                            size_t threads = std::thread::hardware_concurrency()) :
+            _left(left),
+            _right(right),
+            _dims(left->getDimensionCount()),
+            _pool(threads),
+            _workers(_pool.size()) {
+            if (right->getDimensionCount() != _dims) {
+                throw std::runtime_error("SpatialJoinExecutor: indexes differ in dimension count");
+            }
+        }
+
+        size_t threads() const { return _pool.size(); }
+
+        // Node pairs expanded and tasks run by the last join
+        uint64_t lastNodePairs() const { return _nodePairs.load(std::memory_order_relaxed); }
+        size_t lastTaskCount() const { return _lastTaskCount; }
+
+        /**
+         * Report every (left, right) pair of records whose keys intersect as
+         * emit(leftRowID, rightRowID). Returns the number of pairs. Joins on
+         * one executor are serialized.
+         *
+         * @throws whatever loading a node throws, once all tasks are done
+         */
+        template< typename Emit >
+        uint64_t join(CacheNode* leftRoot, CacheNode* rightRoot, Emit&& emit) {
+            return joinWithinDistance(leftRoot, rightRoot, 0.0, std::forward<Emit>(emit));
+        }
+
+        /**
+         * Same, for pairs whose keys are at most distance apart (Euclidean
+         * distance between the boxes; 0 means intersecting).
+         */
+        template< typename Emit >
+        uint64_t joinWithinDistance(CacheNode* leftRoot, CacheNode* rightRoot, double distance,
+                                    Emit&& emit) {
+            std::lock_guard<std::mutex> serial(_joinMtx);
+            _distance = std::max(0.0, distance);
+            _nodePairs.store(0, std::memory_order_relaxed);
+            _lastTaskCount = 0;
+            _pairs = 0;
+
+            const Node l = _root(leftRoot);
+            const Node r = _root(rightRoot);
+            if (!l.bucket || !r.bucket) {
+                return 0;
+            }
+
+            auto flush = [&](Worker& w) {
+                std::lock_guard<std::mutex> lock(_emitMtx);
+                size_t off = 0;
+                for (const auto& p : w.pairs) {
+                    emit(std::string_view(w.out.data() + off, p.first),
+                         std::string_view(w.out.data() + off + p.first, p.second));
+                    off += p.first + p.second;
+                }
+                _pairs += w.pairs.size();
+                w.pairs.clear();
+                w.out.clear();
+            };
+
+            // Expand near the roots on this thread until there is enough to share
+            std::vector<NodePair> tasks{{l, r}};
+            const size_t target = _pool.size() * kTasksPerThread;
+            Worker& first = _workers[0];
+            while (!tasks.empty() && tasks.size() < target) {
+                std::vector<NodePair> next;
+                for (const NodePair& p : tasks) {
+                    _expand(p, first, next);
+                }
+                tasks.swap(next);
+            }
+            flush(first);
+            _lastTaskCount = tasks.size();
+
+            _pool.run(tasks.size(), [&](size_t t, size_t wi) {
+                Worker& w = _workers[wi];
+                w.stack.clear();
+                w.stack.push_back(tasks[t]);
+                while (!w.stack.empty()) {
+                    const NodePair p = w.stack.back();
+                    w.stack.pop_back();
+                    _expand(p, w, w.stack);
+                    if (w.pairs.size() >= kFlushPairs) {
+                        flush(w);
+                    }
+                }
+                flush(w);
+            });
+            return _pairs;
+        }
+
+    private:
+        // A bucket, or a single data record paired against a deeper subtree
+        struct Node {
+            CacheNode* bucket = nullptr;
+            MBRKeyNode* data = nullptr;
+        };
+        typedef std::pair<Node, Node> NodePair;
+
+        struct Entry {
+            MBRKeyNode* kn;
+            const float* box;
+        };
+
+        // Per-worker scratch and match buffer
+        struct Worker {
+            std::vector<NodePair> stack;
+            std::vector<Entry> a, b;
+            std::vector<std::pair<uint32_t, uint32_t>> matches;   // Entry indices
+            std::vector<int64_t> aName, bName;                     // Offset in names, -1 unresolved
+            std::vector<char> names;
+            std::vector<char> out;                                 // Left then right row ID per pair
+            std::vector<std::pair<uint32_t, uint32_t>> pairs;      // Their lengths
+            persist::StoreInterface::PinnedBytes pinned;
+        };
+
+        static Node _root(CacheNode* cn) {
+            Node n;
+            if (cn && cn->object && !cn->object->isDataNode()) {
+                n.bucket = cn;
+            }
+            return n;
+        }
+
+        static const float* _box(const Node& n) {
+            const KeyMBR* key = n.data ? n.data->getKey() : n.bucket->object->getKey();
+            return key ? key->data() : nullptr;
+        }
+
+        // True if the gap between a and b is within the join distance on every axis
+        bool _near(const float* a, const float* b) const {
+            const float d = static_cast<float>(_distance);
+            for (unsigned short i = 0; i < _dims; ++i) {
+                if (a[2 * i] > b[2 * i + 1] + d || b[2 * i] > a[2 * i + 1] + d) return false;
+            }
+            return true;
+        }
+
+        bool _match(const float* a, const float* b) const {
+            if (_distance == 0.0) {
+                return _near(a, b);
+            }
+            double sq = 0.0;
+            for (unsigned short i = 0; i < _dims; ++i) {
+                const double gap = std::max({0.0,
+                                             static_cast<double>(a[2 * i]) - b[2 * i + 1],
+                                             static_cast<double>(b[2 * i]) - a[2 * i + 1]});
+                sq += gap * gap;
+            }
+            return sq <= _distance * _distance;
+        }
+
+        // Entries of n that can still match something inside other
+        void _gather(const Node& n, const float* other, std::vector<Entry>& out) const {
+            out.clear();
+            if (n.data) {
+                out.push_back(Entry{n.data, n.data->getKey()->data()});
+                return;
+            }
+            auto* bucket = reinterpret_cast<XTreeBucket<RecordType>*>(n.bucket->object);
+            auto* children = bucket->getChildren();
+            if (!children) return;
+            const size_t count = std::min<size_t>(bucket->n(), children->size());
+            for (size_t i = 0; i < count; ++i) {
+                MBRKeyNode* kn = (*children)[i];
+                const KeyMBR* key = kn ? kn->getKey() : nullptr;
+                if (!key || !key->data() || !_near(key->data(), other)) continue;
+                out.push_back(Entry{kn, key->data()});
+            }
+        }
+
+        /**
+         * Match the children of one node pair: record pairs go to the
+         * worker's buffer, pairs that still hold a subtree go to next.
+         */
+        void _expand(const NodePair& p, Worker& w, std::vector<NodePair>& next) {
+            const float* lbox = _box(p.first);
+            const float* rbox = _box(p.second);
+            if (!lbox || !rbox) return;
+            _nodePairs.fetch_add(1, std::memory_order_relaxed);
+
+            _gather(p.first, rbox, w.a);
+            _gather(p.second, lbox, w.b);
+            if (w.a.empty() || w.b.empty()) return;
+
+            // Plane sweep along axis 0
+            auto byMin = [](const Entry& x, const Entry& y) { return x.box[0] < y.box[0]; };
+            std::sort(w.a.begin(), w.a.end(), byMin);
+            std::sort(w.b.begin(), w.b.end(), byMin);
+            const float d = static_cast<float>(_distance);
+            w.matches.clear();
+            size_t i = 0, j = 0;
+            while (i < w.a.size() && j < w.b.size()) {
+                if (w.a[i].box[0] <= w.b[j].box[0]) {
+                    for (size_t k = j; k < w.b.size() && w.b[k].box[0] <= w.a[i].box[1] + d; ++k) {
+                        if (_match(w.a[i].box, w.b[k].box)) w.matches.emplace_back(i, k);
+                    }
+                    ++i;
+                } else {
+                    for (size_t k = i; k < w.a.size() && w.a[k].box[0] <= w.b[j].box[1] + d; ++k) {
+                        if (_match(w.a[k].box, w.b[j].box)) w.matches.emplace_back(k, j);
+                    }
+                    ++j;
+                }
+            }
+            if (w.matches.empty()) return;
+
+            w.aName.assign(w.a.size(), -1);
+            w.bName.assign(w.b.size(), -1);
+            w.names.clear();
+            for (const auto& m : w.matches) {
+                MBRKeyNode* ka = w.a[m.first].kn;
+                MBRKeyNode* kb = w.b[m.second].kn;
+                if (ka->isDataRecord() && kb->isDataRecord()) {
+                    if (!_name(_left, ka, w, w.aName[m.first]) ||
+                        !_name(_right, kb, w, w.bName[m.second])) {
+                        continue;
+                    }
+                    const std::string_view ln = _nameAt(w, w.aName[m.first]);
+                    const std::string_view rn = _nameAt(w, w.bName[m.second]);
+                    w.out.insert(w.out.end(), ln.begin(), ln.end());
+                    w.out.insert(w.out.end(), rn.begin(), rn.end());
+                    w.pairs.emplace_back(static_cast<uint32_t>(ln.size()),
+                                         static_cast<uint32_t>(rn.size()));
+                    continue;
+                }
+                Node l, r;
+                if (!_descend(_left, ka, l) || !_descend(_right, kb, r)) continue;
+                next.emplace_back(l, r);
+            }
+        }
+
+        bool _descend(IndexDetails<RecordType>* idx, MBRKeyNode* kn, Node& out) const {
+            if (kn->isDataRecord()) {
+                out.data = kn;
+                return true;
+            }
+            CacheNode* cn = kn->template cache_or_load<RecordType>(idx);
+            if (!cn || !cn->object || cn->object->isDataNode()) return false;
+            out.bucket = cn;
+            return true;
+        }
+
+        static std::string_view _nameAt(const Worker& w, int64_t off) {
+            uint32_t len;
+            std::memcpy(&len, w.names.data() + off, sizeof(len));
+            return std::string_view(w.names.data() + off + sizeof(len), len);
+        }
+
+        /**
+         * Resolve a data entry's row ID into w.names once per node pair and
+         * record its offset in slot. Uncached DURABLE records are read from
+         * pinned wire bytes, as in Iterator::nextBatch().
+         */
+        bool _name(IndexDetails<RecordType>* idx, MBRKeyNode* kn, Worker& w, int64_t& slot) const {
+            if (slot >= 0) return true;
+            std::string_view rowid;
+            bool found = false;
+            if (idx->getPersistenceMode() == IndexDetails<RecordType>::PersistenceMode::DURABLE &&
+                kn->hasNodeID()) {
+                const persist::NodeID nid = kn->getNodeID();
+                auto* cn = idx->getCache().find(idx->cacheKey(nid));
+                if (cn && cn->object) {
+                    auto* d = cn->object->asDataRecord();
+                    if (!d) return false;
+                    rowid = d->getRowIDView();
+                    found = true;
+                } else if (auto* store = idx->getStore()) {
+                    try {
+                        w.pinned = store->read_node_pinned(nid);
+                        const auto* data = static_cast<const uint8_t*>(w.pinned.data);
+                        if (data && w.pinned.size > 0) {
+                            DataRecordWire::Layout layout;
+                            if (!DataRecordWire::parse(data, w.pinned.size, _dims, layout)) {
+                                w.pinned = {};
+                                return false;
+                            }
+                            rowid = DataRecordWire::rowid(data, layout);
+                            found = true;
+                        }
+                    } catch (const std::exception&) {
+                        // Store without pinned reads - fall back to cache_or_load
+                    }
+                }
+            }
+            if (!found) {
+                auto* cn = kn->template cache_or_load<RecordType>(idx);
+                auto* d = (cn && cn->object) ? cn->object->asDataRecord() : nullptr;
+                if (!d) return false;
+                rowid = d->getRowIDView();
+            }
+
+            slot = static_cast<int64_t>(w.names.size());
+            const uint32_t len = static_cast<uint32_t>(rowid.size());
+            const char* lenBytes = reinterpret_cast<const char*>(&len);
+            w.names.insert(w.names.end(), lenBytes, lenBytes + sizeof(len));
+            w.names.insert(w.names.end(), rowid.begin(), rowid.end());
+            w.pinned = {};
+            return true;
+        }
+
+        IndexDetails<RecordType>* _left;
+        IndexDetails<RecordType>* _right;
+        unsigned short _dims;
+        double _distance = 0.0;
+
+        WorkStealingPool _pool;
+        std::vector<Worker> _workers;       // Indexed by pool worker
+        std::mutex _joinMtx;                // One join at a time
+        std::mutex _emitMtx;                // One callback at a time
+        uint64_t _pairs = 0;                // Guarded by _emitMtx while tasks run
+        std::atomic<uint64_t> _nodePairs{0};
+        size_t _lastTaskCount = 0;
+    };
+}
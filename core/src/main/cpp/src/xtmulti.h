@@ -0,0 +1,317 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+#include "xtree.h"
+#include "util/cpu_features.h"
+
+namespace xtree {
+
+    /**
+     * Matches produced by a MultiQueryExecutor, in traversal order. Match i
+     * is row ID rowID(i) for query queryID(i); a record that satisfies
+     * several queries appears once per query.
+     */
+    class MultiQueryResult {
+    public:
+        size_t size() const { return _queryIds.size(); }
+        bool empty() const { return _queryIds.empty(); }
+
+        uint32_t queryID(size_t i) const { return _queryIds[i]; }
+
+        std::string_view rowID(size_t i) const {
+            const uint64_t start = i ? _ends[i - 1] : 0;
+            return std::string_view(_bytes.data() + start, _ends[i] - start);
+        }
+
+        // Visit every (query id, row ID) match
+        template< typename F >
+        void forEach(F&& f) const {
+            for (size_t i = 0; i < _queryIds.size(); ++i) {
+                f(_queryIds[i], rowID(i));
+            }
+        }
+
+    private:
+        template< class R > friend class MultiQueryExecutor;
+
+        void append(uint32_t queryId, std::string_view rowid) {
+            _bytes.insert(_bytes.end(), rowid.begin(), rowid.end());
+            _ends.push_back(_bytes.size());
+            _queryIds.push_back(queryId);
+        }
+
+        std::vector<uint32_t> _queryIds;
+        std::vector<char> _bytes;
+        std::vector<uint64_t> _ends;    // Match i occupies [ends[i-1], ends[i])
+    };
+
+    /**
+     * Batched multi-query execution with a shared traversal.
+     *
+     * Many small box queries against one tree each pay for their own descent
+     * from the root, so upper levels get loaded and tested once per query.
+     * This executor walks the tree once for the whole batch. Every node on
+     * the stack carries the ids of the queries still active below it; its
+     * children are tested against all of them at once with a SIMD
+     * query x child match matrix, and a child subtree is entered only with
+     * the queries that overlap it. Data records are resolved once per batch
+     * however many queries they satisfy.
+     *
+     * Internal nodes are pruned by MBR overlap for every search type; data
+     * records are then tested with the type's own predicate on their MBR,
+     * the same test Iterator applies. The tree must not be modified while a
+     * batch runs.
+     */
+    template< class RecordType >
+    class MultiQueryExecutor {
+    typedef typename xtree::XTreeBucket<RecordType>::CacheNode   CacheNode;
+    typedef typename xtree::XTreeBucket<RecordType>::_MBRKeyNode MBRKeyNode;
+
+    public:
+        explicit MultiQueryExecutor(IndexDetails<RecordType>* idx) :
+            _idx(idx),
+            _dims(idx->getDimensionCount()),
+            _match(get_optimal_match_matrix_func()) {
+        }
+
+        // Buckets entered and query x child tests made by the last batch
+        uint64_t lastNodesVisited() const { return _nodesVisited; }
+        uint64_t lastChildTests() const { return _childTests; }
+
+        /**
+         * Run count queries below startNode. boxes holds 2 * dims floats per
+         * query (min/max per axis, the KeyMBR::data() layout); query ids are
+         * positions in boxes.
+         */
+        MultiQueryResult execute(CacheNode* startNode, const float* boxes, size_t count,
+                                 int queryType = INTERSECTS) {
+            MultiQueryResult result;
+            _nodesVisited = 0;
+            _childTests = 0;
+            if (!startNode || !startNode->object || count == 0) {
+                return result;
+            }
+            _queries = boxes;
+            _type = static_cast<SearchType>(queryType);
+
+            _active.resize(count);
+            for (size_t q = 0; q < count; ++q) {
+                _active[q] = static_cast<uint32_t>(q);
+            }
+            _stack.clear();
+            _stack.push_back(Frame{startNode, 0, static_cast<uint32_t>(count)});
+
+            std::vector<uint32_t> active;
+            while (!_stack.empty()) {
+                const Frame f = _stack.back();
+                _stack.pop_back();
+                active.assign(_active.begin() + f.off, _active.begin() + f.off + f.n);
+                _active.resize(f.off);
+                _visit(f.cn, active, result);
+            }
+            return result;
+        }
+
+        // Same, taking each query's box from its record's key
+        MultiQueryResult execute(CacheNode* startNode, const std::vector<IRecord*>& queries,
+                                 int queryType = INTERSECTS) {
+            std::vector<float> boxes(queries.size() * 2 * _dims,
+                                     std::numeric_limits<float>::quiet_NaN());
+            for (size_t q = 0; q < queries.size(); ++q) {
+                const KeyMBR* key = queries[q] ? queries[q]->getKey() : nullptr;
+                if (key && key->data()) {
+                    std::memcpy(&boxes[q * 2 * _dims], key->data(), 2 * _dims * sizeof(float));
+                }
+            }
+            return execute(startNode, boxes.data(), queries.size(), queryType);
+        }
+
+    private:
+        // A bucket to visit with _active[off, off + n) still live below it
+        struct Frame {
+            CacheNode* cn;
+            size_t off;
+            uint32_t n;
+        };
+
+        void _visit(CacheNode* cn, const std::vector<uint32_t>& active, MultiQueryResult& result) {
+            if (!cn || !cn->object || cn->object->isDataNode()) {
+                return;
+            }
+            auto* bucket = reinterpret_cast<XTreeBucket<RecordType>*>(cn->object);
+            auto* children = bucket->getChildren();
+            if (!children) {
+                return;
+            }
+            const size_t n = std::min<size_t>(bucket->n(), children->size());
+            if (n == 0) {
+                return;
+            }
+            _nodesVisited++;
+            _childTests += n * active.size();
+
+            // Transpose the child keys; padding and keyless children are NaN
+            const size_t stride = (n + 7) & ~size_t(7);
+            _mins.assign(_dims * stride, std::numeric_limits<float>::quiet_NaN());
+            _maxs.assign(_dims * stride, std::numeric_limits<float>::quiet_NaN());
+            for (size_t c = 0; c < n; ++c) {
+                const MBRKeyNode* kn = (*children)[c];
+                const KeyMBR* key = kn ? kn->getKey() : nullptr;
+                if (!key || !key->data()) continue;
+                const float* box = key->data();
+                for (unsigned short d = 0; d < _dims; ++d) {
+                    _mins[d * stride + c] = box[2 * d];
+                    _maxs[d * stride + c] = box[2 * d + 1];
+                }
+            }
+
+            const size_t words = (stride + 63) / 64;
+            _matrix.resize(active.size() * words);
+            _match(_queries, active.data(), active.size(), _mins.data(), _maxs.data(),
+                   stride, _dims, _matrix.data());
+
+            for (size_t c = 0; c < n; ++c) {
+                MBRKeyNode* kn = (*children)[c];
+                if (!kn) continue;
+                const size_t word = c >> 6;
+                const uint64_t bit = uint64_t(1) << (c & 63);
+
+                if (kn->isDataRecord()) {
+                    const float* box = kn->getKey()->data();
+                    bool resolved = false;
+                    for (size_t i = 0; i < active.size(); ++i) {
+                        if (!(_matrix[i * words + word] & bit)) continue;
+                        if (!_recordMatches(box, active[i])) continue;
+                        if (!resolved) {
+                            if (!_resolve(kn)) break;
+                            resolved = true;
+                        }
+                        result.append(active[i], _rowid);
+                    }
+                    _pinned = {};
+                    continue;
+                }
+
+                const size_t off = _active.size();
+                for (size_t i = 0; i < active.size(); ++i) {
+                    if (_matrix[i * words + word] & bit) {
+                        _active.push_back(active[i]);
+                    }
+                }
+                if (_active.size() == off) {
+                    continue;
+                }
+                CacheNode* child = kn->template cache_or_load<RecordType>(_idx);
+                if (!child || !child->object) {
+                    _active.resize(off);
+                    continue;
+                }
+                _stack.push_back(Frame{child, off, static_cast<uint32_t>(_active.size() - off)});
+            }
+        }
+
+        // MBR overlap is already known; WITHIN and CONTAINS need more
+        bool _recordMatches(const float* r, uint32_t queryId) const {
+            const float* q = _queries + static_cast<size_t>(queryId) * 2 * _dims;
+            switch (_type) {
+                case WITHIN:
+                    for (unsigned short d = 0; d < _dims; ++d) {
+                        if (r[2 * d] < q[2 * d] || r[2 * d + 1] > q[2 * d + 1]) return false;
+                    }
+                    return true;
+                case CONTAINS:
+                    for (unsigned short d = 0; d < _dims; ++d) {
+                        if (r[2 * d] > q[2 * d] || r[2 * d + 1] < q[2 * d + 1]) return false;
+                    }
+                    return true;
+                default:
+                    return true;
+            }
+        }
+
+        /**
+         * Point _rowid at the data record's row ID. Uncached DURABLE records
+         * are read from pinned wire bytes (held in _pinned until the caller
+         * is done), as in Iterator::nextBatch().
+         */
+        bool _resolve(MBRKeyNode* kn) {
+            if (_idx->getPersistenceMode() == IndexDetails<RecordType>::PersistenceMode::DURABLE &&
+                kn->hasNodeID()) {
+                const persist::NodeID nid = kn->getNodeID();
+                auto* cn = _idx->getCache().find(_idx->cacheKey(nid));
+                if (cn && cn->object) {
+                    if (auto* d = cn->object->asDataRecord()) {
+                        _rowid = d->getRowIDView();
+                        return true;
+                    }
+                    return false;
+                }
+                if (auto* store = _idx->getStore(); store && !_pinnedReadsUnsupported) {
+                    try {
+                        _pinned = store->read_node_pinned(nid);
+                        const auto* data = static_cast<const uint8_t*>(_pinned.data);
+                        if (data && _pinned.size > 0) {
+                            DataRecordWire::Layout layout;
+                            if (!DataRecordWire::parse(data, _pinned.size, _dims, layout)) {
+                                return false;
+                            }
+                            _rowid = DataRecordWire::rowid(data, layout);
+                            return true;
+                        }
+                    } catch (const std::exception&) {
+                        _pinnedReadsUnsupported = true;
+                    }
+                }
+            }
+            auto* cn = kn->template cache_or_load<RecordType>(_idx);
+            auto* d = (cn && cn->object) ? cn->object->asDataRecord() : nullptr;
+            if (!d) {
+                return false;
+            }
+            _rowid = d->getRowIDView();
+            return true;
+        }
+
+        IndexDetails<RecordType>* _idx;
+        unsigned short _dims;
+        match_matrix_func_t _match;
+        const float* _queries = nullptr;
+        SearchType _type = INTERSECTS;
+        bool _pinnedReadsUnsupported = false;   // Store threw once; use cache_or_load
+
+        // Traversal state, reused across batches
+        std::vector<Frame> _stack;
+        std::vector<uint32_t> _active;          // Query id lists of the frames on _stack
+        std::vector<float> _mins;
+        std::vector<float> _maxs;
+        std::vector<uint64_t> _matrix;
+        persist::StoreInterface::PinnedBytes _pinned;
+        std::string_view _rowid;
+
+        uint64_t _nodesVisited = 0;
+        uint64_t _childTests = 0;
+    };
+}
@@ -0,0 +1,278 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "xtree.h"
+#include "xtiter.h"
+#include "util/work_stealing_pool.h"
+
+namespace xtree {
+
+    /**
+     * Row IDs produced by a ParallelQueryExecutor.
+     *
+     * Each worker appends to its own buffer; nothing is copied when the
+     * query finishes. ORDERED results are visited task by task, which is
+     * the order a single Iterator over the same root returns them in.
+     * UNORDERED results are visited worker by worker.
+     */
+    class ParallelQueryResult {
+    public:
+        size_t size() const { return _rows; }
+        bool empty() const { return _rows == 0; }
+
+        // Visit every row ID in merge order
+        template< typename F >
+        void forEach(F&& f) const {
+            if (_ordered) {
+                for (const Segment& s : _segments) {
+                    const WorkerRows& w = _workers[s.worker];
+                    for (size_t r = s.begin; r < s.end; ++r) {
+                        f(w.rowID(r));
+                    }
+                }
+            } else {
+                for (const WorkerRows& w : _workers) {
+                    for (size_t r = 0; r < w.ends.size(); ++r) {
+                        f(w.rowID(r));
+                    }
+                }
+            }
+        }
+
+        // Views into this result, in merge order
+        std::vector<std::string_view> rowIDs() const {
+            std::vector<std::string_view> out;
+            out.reserve(_rows);
+            forEach([&out](std::string_view id) { out.push_back(id); });
+            return out;
+        }
+
+    private:
+        template< class R > friend class ParallelQueryExecutor;
+
+        // Row r occupies [ends[r-1], ends[r]) of bytes
+        struct WorkerRows {
+            std::vector<char> bytes;
+            std::vector<uint64_t> ends;
+            size_t used = 0;
+
+            std::string_view rowID(size_t r) const {
+                const uint64_t start = r ? ends[r - 1] : 0;
+                return std::string_view(bytes.data() + start, ends[r] - start);
+            }
+        };
+
+        // Rows [begin, end) of one worker's buffer came from one task
+        struct Segment {
+            uint32_t worker;
+            size_t begin;
+            size_t end;
+        };
+
+        std::vector<WorkerRows> _workers;
+        std::vector<Segment> _segments;     // Indexed by task
+        size_t _rows = 0;
+        bool _ordered = false;
+    };
+
+    /**
+     * Intra-query parallelism for large range queries.
+     *
+     * The frontier below the start node is split into subtree tasks (in the
+     * Iterator's DFS order) until there are about kTasksPerThread tasks per
+     * worker. Each task runs an ordinary Iterator rooted at its subtree and
+     * drains it with nextBatch() into the worker's own buffer, so DURABLE
+     * records keep the pinned-read path and nothing is shared between
+     * workers while the query runs. Workers steal tasks from each other, so
+     * skewed subtrees do not leave cores idle.
+     *
+     * The tree must not be modified while a query runs - the same rule as
+     * for a single Iterator.
+     */
+    template< class RecordType >
+    class ParallelQueryExecutor {
+    typedef typename xtree::XTreeBucket<RecordType>::CacheNode   CacheNode;
+    typedef typename xtree::XTreeBucket<RecordType>::_MBRKeyNode MBRKeyNode;
+
+    public:
+        enum class Merge { ORDERED, UNORDERED };
+
+        static constexpr size_t kTasksPerThread = 8;
+        static constexpr size_t kBatchRows = 1024;
+        static constexpr size_t kBatchBytes = 64 * 1024;
+
+        // Pass a NumaTopology (e.g. &NumaTopology::system()) to run the
+        // workers NUMA-local; see WorkStealingPool
+        explicit ParallelQueryExecutor(IndexDetails<RecordType>* idx,
+                                       size_t threads = std::thread::hardware_concurrency(),
+                                       const NumaTopology* numa = nullptr) :
+            _idx(idx),
+            _pool(threads, numa) {
+        }
+
+        size_t threads() const { return _pool.size(); }
+
+        // Subtree tasks the last query was split into
+        size_t lastTaskCount() const { return _lastTaskCount; }
+
+        // Tasks run by a worker other than the one they were dealt to
+        uint64_t steals() const { return _pool.steals(); }
+
+        bool numaLocal() const { return _pool.numaLocal(); }
+
+        // Same meaning as Iterator::setExactRefinement()
+        void setExactRefinement(bool enabled) { _exactRefinement = enabled; }
+
+        /**
+         * Run a query below startNode on all workers and return the row IDs.
+         * Queries on one executor are serialized.
+         *
+         * @throws whatever a task's Iterator throws, once all tasks are done
+         */
+        ParallelQueryResult execute(CacheNode* startNode, IRecord* searchKey, int queryType,
+                                    Merge merge = Merge::UNORDERED) {
+            ParallelQueryResult result;
+            result._ordered = (merge == Merge::ORDERED);
+            result._workers.resize(_pool.size());
+
+            const SearchType type = static_cast<SearchType>(queryType);
+            const std::vector<CacheNode*> tasks = _split(startNode, searchKey, type);
+            _lastTaskCount = tasks.size();
+            result._segments.resize(tasks.size());
+
+            _pool.run(tasks.size(), [&](size_t t, size_t w) {
+                ParallelQueryResult::WorkerRows& rows = result._workers[w];
+                const size_t begin = rows.ends.size();
+                _drain(tasks[t], searchKey, type, rows);
+                result._segments[t] = {static_cast<uint32_t>(w), begin, rows.ends.size()};
+            });
+
+            for (const auto& w : result._workers) {
+                result._rows += w.ends.size();
+            }
+            return result;
+        }
+
+    private:
+        /**
+         * Expand the frontier one level at a time, replacing each internal
+         * node by its matching children in the order Iterator::traverse()
+         * visits them (the DFS stack pops the last child first). Leaf buckets
+         * stay whole. The concatenation of the tasks' results is therefore
+         * exactly what one Iterator over startNode returns.
+         */
+        std::vector<CacheNode*> _split(CacheNode* startNode, IRecord* searchKey, SearchType type) {
+            std::vector<CacheNode*> frontier;
+            if (!startNode || !startNode->object) {
+                return frontier;
+            }
+            frontier.push_back(startNode);
+
+            const size_t target = _pool.size() * kTasksPerThread;
+            bool expanded = true;
+            while (expanded && frontier.size() < target) {
+                expanded = false;
+                std::vector<CacheNode*> next;
+                next.reserve(frontier.size() * 4);
+                for (CacheNode* cn : frontier) {
+                    if (!_expand(cn, searchKey, type, next)) {
+                        next.push_back(cn);
+                    } else {
+                        expanded = true;
+                    }
+                }
+                frontier.swap(next);
+            }
+            return frontier;
+        }
+
+        // Append cn's internal children (last first); false if cn must stay whole
+        bool _expand(CacheNode* cn, IRecord* searchKey, SearchType type,
+                     std::vector<CacheNode*>& out) {
+            if (!cn || !cn->object || cn->object->isDataNode()) {
+                return false;
+            }
+            auto* bucket = reinterpret_cast<XTreeBucket<RecordType>*>(cn->object);
+            auto* children = bucket->getChildren();
+            if (bucket->getIsLeaf() || !children) {
+                return false;
+            }
+
+            const int n = std::min<int>(bucket->n(), static_cast<int>(children->size()));
+            std::vector<CacheNode*> loaded;
+            loaded.reserve(n);
+            for (int i = 0; i < n; ++i) {
+                MBRKeyNode* kn = (*children)[i];
+                if (!kn) continue;
+                if (kn->isDataRecord()) {
+                    return false;  // Mixed bucket - let one Iterator handle it
+                }
+                CacheNode* child = kn->template cache_or_load<RecordType>(_idx);
+                if (child && child->object) {
+                    loaded.push_back(child);
+                }
+            }
+
+            for (auto it = loaded.rbegin(); it != loaded.rend(); ++it) {
+                // Same pruning Iterator::intersects() applies when it pops the node
+                if (type == INTERSECTS) {
+                    const KeyMBR* key = (*it)->object->getKey();
+                    const KeyMBR* q = searchKey ? searchKey->getKey() : nullptr;
+                    if (!key || !q || !key->intersects(*q)) continue;
+                }
+                out.push_back(*it);
+            }
+            return true;
+        }
+
+        void _drain(CacheNode* node, IRecord* searchKey, SearchType type,
+                    ParallelQueryResult::WorkerRows& rows) {
+            Iterator<RecordType> iter(node, searchKey, type, _idx);
+            iter.setExactRefinement(_exactRefinement);
+
+            uint32_t ends[kBatchRows];
+            for (;;) {
+                if (rows.bytes.size() - rows.used < kBatchBytes) {
+                    rows.bytes.resize(std::max(rows.bytes.size() * 2, rows.used + kBatchBytes));
+                }
+                const size_t n = iter.nextBatch(rows.bytes.data() + rows.used,
+                                                rows.bytes.size() - rows.used, ends, kBatchRows);
+                if (n == 0) {
+                    break;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    rows.ends.push_back(rows.used + ends[i]);
+                }
+                rows.used += ends[n - 1];
+            }
+        }
+
+        IndexDetails<RecordType>* _idx;
+        WorkStealingPool _pool;
+        bool _exactRefinement = false;
+        size_t _lastTaskCount = 0;
+    };
+}
@@ -53,6 +53,8 @@ namespace xtree {
     // forward declaration of XTree iterator
     template< class RecordType >
     class Iterator;
+    template< class RecordType >
+    class PooledIterator;
     
     // Forward declarations will be added as needed for arena implementation
 
@@ -149,12 +151,13 @@ namespace xtree {
         // Move constructor
         __MBRKeyNode(__MBRKeyNode&& other) noexcept
             : _node_id(other._node_id),
-              _cache_ptr(other._cache_ptr),
+              _cache_ptr(other._cache_ptr.load(std::memory_order_relaxed)),
               _recordKey(other._recordKey),
               _owner(other._owner),
               _offset(other._offset),
               _flags(other._flags),
-              _owns_key(other._owns_key)
+              _owns_key(other._owns_key),
+              _count(other._count)
         {
             other._cache_ptr = nullptr;
             other._recordKey = nullptr;
@@ -168,12 +171,13 @@ namespace xtree {
                 if (_owns_key && _recordKey) delete _recordKey;
 
                 _node_id   = other._node_id;
-                _cache_ptr = other._cache_ptr;
+                _cache_ptr = other._cache_ptr.load(std::memory_order_relaxed);
                 _recordKey = other._recordKey;
                 _owner     = other._owner;
                 _offset    = other._offset;
                 _flags     = other._flags;
                 _owns_key  = other._owns_key;
+                _count     = other._count;
 
                 other._cache_ptr = nullptr;
                 other._recordKey = nullptr;
@@ -192,12 +196,16 @@ namespace xtree {
         // Ensure all allocations of __MBRKeyNode are properly aligned for NodeID
         static_assert(alignof(xtree::persist::NodeID) >= 8, "NodeID must be at least 8B aligned");
 
-        // Scalar new/delete
+        // Scalar new/delete (from the huge-page arena when it is enabled)
         static void* operator new(std::size_t sz) {
+            static_assert(alignof(__MBRKeyNode) <= HugePageArena::kGranule, "arena alignment");
+            if (void* p = HugePageArena::global().allocate(sz)) return p;
             return ::operator new(sz, std::align_val_t{alignof(__MBRKeyNode)});
         }
         static void operator delete(void* p) noexcept {
-            ::operator delete(p, std::align_val_t{alignof(__MBRKeyNode)});
+            auto& arena = HugePageArena::global();
+            if (arena.owns(p)) arena.deallocate(p);
+            else ::operator delete(p, std::align_val_t{alignof(__MBRKeyNode)});
         }
 
         // Array new/delete (defensive; likely never used but for completeness)
@@ -220,23 +228,32 @@ namespace xtree {
             else _flags &= ~IRecord::DATA_NODE;
         }
 
-        bool getCached() { return _cache_ptr != nullptr; }
+        /**
+         * Records stored below this entry: 1 for a data record, the child
+         * bucket's subtreeCount() for a bucket child. UNKNOWN_COUNT when the
+         * entry was loaded from a snapshot written before counts were kept.
+         */
+        static constexpr uint64_t UNKNOWN_COUNT = ~uint64_t(0);
+        uint64_t subtreeCount() const { return isDataRecord() ? 1 : _count; }
+        void setSubtreeCount(uint64_t count) { _count = count; }
+
+        bool getCached() { return _cache_ptr.load(std::memory_order_acquire) != nullptr; }
         void setCached(const bool cached) { /* deprecated */ }
 
         ostream& getRecordID(ostream& os) {
-            os << "offset=" << _offset << " cached=" << (_cache_ptr != nullptr);
+            os << "offset=" << _offset << " cached=" << (_cache_ptr.load(std::memory_order_relaxed) != nullptr);
             return os;
         }
 
         /** Get cached record if available */
-        CacheNode* getCacheRecord() { return _cache_ptr; }
-        const CacheNode* getCacheRecord() const { return _cache_ptr; }
+        CacheNode* getCacheRecord() { return _cache_ptr.load(std::memory_order_acquire); }
+        const CacheNode* getCacheRecord() const { return _cache_ptr.load(std::memory_order_acquire); }
 
         /** Pull the record - either from cache or by loading from offset */
         IRecord* getRecord(LRUCache<IRecord, UniqueId, LRUDeleteNone> &cache) {
             // First try cache
-            if (_cache_ptr) {
-                return _cache_ptr->object;
+            if (CacheNode* cn = _cache_ptr.load(std::memory_order_acquire)) {
+                return cn->object;
             }
             
             // If we have an offset but no cache, we need the index to load
@@ -255,11 +272,13 @@ namespace xtree {
         IRecord* getRecord(IndexType* idx) {
             // SAFETY: When eviction is possible, _cache_ptr may be dangling.
             // Skip fast path and use NodeID resolution instead.
-            const bool may_evict = idx && idx->getCache().getMaxMemory() > 0;
+            // Read-only replicas drop changed nodes on refresh, so treat them alike
+            const bool may_evict = idx && (idx->getCache().getMaxMemory() > 0 || idx->isReadOnly());
 
             // Fast path: already have the pointer cached (only when eviction disabled)
-            if (!may_evict && _cache_ptr) {
-                return _cache_ptr->object;
+            CacheNode* cached = _cache_ptr.load(std::memory_order_acquire);
+            if (!may_evict && cached) {
+                return cached->object;
             }
 
             // DURABLE mode: resolve NodeID to get the bucket pointer
@@ -346,14 +365,16 @@ namespace xtree {
 
                         // Use acquirePinned to safely handle already-cached case
                         // This returns existing node if present, or creates new entry
-                        uint64_t cache_key = _node_id.raw();
-                        auto result = idx->getCache().acquirePinned(cache_key, reinterpret_cast<IRecord*>(bucket));
-                        _cache_ptr = result.node;
-
-                        // If the cache already had this node, we loaded a duplicate - delete it
-                        if (!result.created && _cache_ptr && _cache_ptr->object != bucket) {
-                            delete bucket;
-                            bucket = dynamic_cast<XTreeBucket<RecordType>*>(_cache_ptr->object);
+                        uint64_t cache_key = idx->cacheKey(_node_id);
+                        auto result = idx->getCache().acquirePinned(cache_key, reinterpret_cast<IRecord*>(bucket),
+                                                                    idx->getCacheField());
+                        CacheNode* cn = result.node;
+                        _cache_ptr.store(cn, std::memory_order_release);
+
+                        // If the cache already had this node, we loaded a duplicate;
+                        // acquirePinned() has already freed it
+                        if (!result.created && cn && cn->object != bucket) {
+                            bucket = dynamic_cast<XTreeBucket<RecordType>*>(cn->object);
                             if (!bucket) {
                                 return nullptr;  // Should not happen
                             }
@@ -371,8 +392,8 @@ namespace xtree {
                         setLeaf(bucket->getIsLeaf());
 
                         // Unpin the node - acquirePinned returns pinned
-                        if (_cache_ptr) {
-                            idx->getCache().unpin(_cache_ptr, cache_key);
+                        if (cn) {
+                            idx->getCache().unpin(cn, cache_key);
                         }
 
                         return reinterpret_cast<IRecord*>(bucket);
@@ -688,30 +709,37 @@ namespace xtree {
          * @tparam IndexType The index type (must have getCache() and getStore())
          * @param idx The IndexDetails containing cache and store
          * @return Cache node containing the child object, or nullptr if load fails
+         *
+         * Safe to call from several readers on the same entry: _cache_ptr is
+         * only read once per call and republished with release stores, and a
+         * racing load resolves to the single cache node via acquirePinned().
          */
         template<typename Record, typename IndexType>
         CacheNode* cache_or_load(IndexType* idx) {
             // Fast path: If cache has no memory budget, eviction won't happen
             // so _cache_ptr is always valid (no dangling pointer risk)
-            const bool may_evict = idx->getCache().getMaxMemory() > 0;
+            // Read-only replicas drop changed nodes on refresh, so treat them alike
+            const bool may_evict = idx->getCache().getMaxMemory() > 0 || idx->isReadOnly();
 
-            if (_cache_ptr && (!may_evict || !_node_id.valid())) {
+            CacheNode* cached = _cache_ptr.load(std::memory_order_acquire);
+            if (cached && (!may_evict || !_node_id.valid())) {
                 // Safe to use cached pointer directly:
                 // - No eviction possible (no memory budget), OR
                 // - IN_MEMORY mode (no NodeID, no eviction)
-                if (_cache_ptr->object && !isDataRecord()) {
-                    auto* bucket = dynamic_cast<XTreeBucket<Record>*>(_cache_ptr->object);
+                idx->recordCacheAccess(true);
+                if (cached->object && !isDataRecord()) {
+                    auto* bucket = dynamic_cast<XTreeBucket<Record>*>(cached->object);
                     if (bucket && bucket->getParent() != this) {
                         bucket->setParent(this);
                     }
                 }
-                return _cache_ptr;
+                return cached;
             }
 
             // Eviction is possible - must validate via cache lookup
             // _cache_ptr may be dangling if node was evicted
             if (_node_id.valid()) {
-                uint64_t cache_key = _node_id.raw();
+                uint64_t cache_key = idx->cacheKey(_node_id);
 
                 // find() returns the cache node if present, nullptr if evicted
                 // This is O(1) and doesn't modify LRU order
@@ -719,7 +747,10 @@ namespace xtree {
 
                 if (cn && cn->object) {
                     // Cache hit - update our cached pointer and return
-                    _cache_ptr = cn;
+                    idx->recordCacheAccess(true);
+                    if (cn != cached) {
+                        _cache_ptr.store(cn, std::memory_order_release);
+                    }
                     // Rewire stale parent pointers for cached buckets
                     if (!isDataRecord()) {
                         auto* bucket = dynamic_cast<XTreeBucket<Record>*>(cn->object);
@@ -727,10 +758,12 @@ namespace xtree {
                             bucket->setParent(this);
                         }
                     }
-                    return _cache_ptr;
+                    return cn;
                 }
                 // Cache miss - clear stale pointer before reload
-                _cache_ptr = nullptr;
+                if (cached) {
+                    _cache_ptr.store(nullptr, std::memory_order_release);
+                }
             }
 
             // IN_MEMORY mode should always have cache pointers set
@@ -749,6 +782,7 @@ namespace xtree {
             }
 
             // Load from persistence (DURABLE mode only)
+            idx->recordCacheAccess(false);
             IRecord* loaded = nullptr;
 
             // Phase 5: Determine type from store metadata
@@ -768,8 +802,11 @@ namespace xtree {
             if (found_in_ot) {
                 // Use the authoritative answer from ObjectTable
                 is_data = (kind == persist::NodeKind::DataRecord);
-                // Update our flag to match reality
-                setDataRecord(is_data);
+                // Update our flag to match reality (readers share this entry,
+                // so only write when it is actually wrong)
+                if (isDataRecord() != is_data) {
+                    setDataRecord(is_data);
+                }
             } else {
                 // Fallback to flag (shouldn't happen in production)
                 is_data = isDataRecord();
@@ -821,47 +858,47 @@ namespace xtree {
             // Insert into cache with NodeID as key using acquirePinned
             // This handles the case where the node is already cached (returns existing)
             // or creates a new entry if not (using our loaded object)
-            uint64_t cache_key = _node_id.raw();
-            auto result = idx->getCache().acquirePinned(cache_key, loaded);
-            _cache_ptr = result.node;
-
-            // If the cache already had this node, we need to clean up our loaded copy
-            // and fix the parent pointer on the existing cached bucket
-            if (!result.created && _cache_ptr && _cache_ptr->object != loaded) {
+            uint64_t cache_key = idx->cacheKey(_node_id);
+            auto result = idx->getCache().acquirePinned(cache_key, loaded, idx->getCacheField());
+            CacheNode* cn = result.node;
+            _cache_ptr.store(cn, std::memory_order_release);
+
+            // If the cache already had this node (another reader loaded it first),
+            // acquirePinned() has already freed our copy; fix the parent pointer
+            // on the existing cached bucket
+            if (!result.created && cn && cn->object != loaded) {
                 // The existing cached bucket might have a stale parent pointer
                 if (!is_data) {
-                    auto* cached_bucket = dynamic_cast<XTreeBucket<Record>*>(_cache_ptr->object);
+                    auto* cached_bucket = dynamic_cast<XTreeBucket<Record>*>(cn->object);
                     if (cached_bucket && cached_bucket->getParent() != this) {
                         cached_bucket->setParent(this);
                     }
                 }
-                // Clean up the loaded object since we're using the cached one
-                delete loaded;
             }
 
             // Unpin the node now - acquirePinned returns pinned
             // CRITICAL: Must use cache.unpin() not node->unpin() to update eviction list!
-            if (_cache_ptr) {
-                idx->getCache().unpin(_cache_ptr, cache_key);
+            if (cn) {
+                idx->getCache().unpin(cn, cache_key);
             }
 
             // Set the key reference if needed (for MBR-based filtering)
             // CRITICAL: For buckets, we must OWN the MBR to survive eviction.
             // DataRecords are transient (deleted after persist), so aliasing is OK.
-            if (!_recordKey && _cache_ptr && _cache_ptr->object) {
-                const bool child_is_bucket = !_cache_ptr->object->isDataNode();
+            if (!_recordKey && cn && cn->object) {
+                const bool child_is_bucket = !cn->object->isDataNode();
                 if (child_is_bucket) {
                     // Bucket child - create OWNED copy to survive eviction
-                    _recordKey = new KeyMBR(*_cache_ptr->object->getKey());
+                    _recordKey = new KeyMBR(*cn->object->getKey());
                     _owns_key = true;
                 } else {
                     // DataRecord - alias is safe (transient)
-                    _recordKey = _cache_ptr->object->getKey();
+                    _recordKey = cn->object->getKey();
                     _owns_key = false;
                 }
             }
 
-            return _cache_ptr;
+            return cn;
         }
 
         /**
@@ -934,8 +971,10 @@ namespace xtree {
         // PUT FIRST → naturally 8-byte aligned inside the class
         persist::NodeID _node_id;
 
-        // 8-byte on 64-bit, keeps layout naturally aligned
-        mutable CacheNode* _cache_ptr;
+        // 8-byte on 64-bit, keeps layout naturally aligned. Atomic because
+        // concurrent readers (parallel queries, joins) may resolve the same
+        // child through cache_or_load() and republish it at the same time.
+        mutable std::atomic<CacheNode*> _cache_ptr;
 
         // The key associated with this record
         // In DURABLE mode for DataRecords: owned copy (we allocate/delete)
@@ -961,6 +1000,9 @@ namespace xtree {
         // False means _recordKey is an alias to external memory (don't delete)
         bool _owns_key = false;  // Default member init
 
+        // Subtree record count of a bucket child (see subtreeCount())
+        uint64_t _count = 0;
+
     public:
         // Accessor for ownership flag (for debug checks)
         bool ownsKey() const noexcept { return _owns_key; }
@@ -970,7 +1012,7 @@ namespace xtree {
         }
 
         friend ostream& operator <<(ostream &os, const __MBRKeyNode kn) {
-            os << "offset=" << kn._offset << " cached=" << (kn._cache_ptr != nullptr) << " isLeaf: " << kn.getLeaf() << endl;
+            os << "offset=" << kn._offset << " cached=" << (kn._cache_ptr.load(std::memory_order_relaxed) != nullptr) << " isLeaf: " << kn.getLeaf() << endl;
             return os;
         }
         
@@ -1001,10 +1043,40 @@ namespace xtree {
     template< class Record >
     class XTreeBucket : public IRecord {
     public:
+        // Heap buckets come from the huge-page arena when it is enabled
+        static void* operator new(std::size_t sz) {
+            if (void* p = HugePageArena::global().allocate(sz)) return p;
+            return ::operator new(sz);
+        }
+        static void operator delete(void* p) noexcept {
+            auto& arena = HugePageArena::global();
+            if (arena.owns(p)) arena.deallocate(p);
+            else ::operator delete(p);
+        }
+        // Buckets constructed in store-provided memory
+        static void* operator new(std::size_t, void* place) noexcept { return place; }
+        static void operator delete(void*, void*) noexcept {}
+
         // grant access to privates
         template< class R >
         friend class Iterator;
 
+        // Splits the frontier into subtree tasks
+        template< class R >
+        friend class ParallelQueryExecutor;
+
+        // Walks the tree once for a batch of queries
+        template< class R >
+        friend class MultiQueryExecutor;
+
+        // Sums subtree counts instead of visiting covered subtrees
+        template< class R >
+        friend class AggregateQueryExecutor;
+
+        // Descends two trees in step
+        template< class R >
+        friend class SpatialJoinExecutor;
+
         // Grant access to serialization
         template< class R >
         friend class XTreeSerializer;
@@ -1242,17 +1314,23 @@ namespace xtree {
 
         // get an iterator for traversing the tree
         Iterator<Record>* getIterator(CacheNode* thisCacheNode, IRecord* searchKey, int queryType);
+        // same, drawn from the calling thread's IteratorPool and returned to it
+        // when the handle goes out of scope
+        PooledIterator<Record> getPooledIterator(CacheNode* thisCacheNode, IRecord* searchKey, int queryType);
 
         // wrapper around _insert that caches the record for insertion
         // into the tree
         void xt_insert(CacheNode* thisCacheNode, IRecord* record) {
+            // The whole insert lands on one side of a concurrent snapshot
+            typename IndexDetails<Record>::WriteScope write_scope(_idx);
+
             // Debug assertion to catch stale root cache issues
             #ifndef NDEBUG
             if (this->_parent == nullptr) { // I am the root
                 if (this->_n == 0) {
                     // If we have no children, we *must* be a leaf
                     if (!this->_leaf) {
-                        trace() << "[ERROR] Root has n=0 but _leaf=" << this->_leaf
+                        XTREE_LOG(LOG_TRACE) << "[ERROR] Root has n=0 but _leaf=" << this->_leaf
                                   << " NodeID=" << this->getNodeID().raw() << std::endl;
                     }
                     assert(this->_leaf && "Root has zero children but is marked internal; cache is stale or deserialization bug");
@@ -1262,7 +1340,7 @@ namespace xtree {
 
             // Debug output for root state (filtered by log level)
             if (this->_parent == nullptr && this->_n == 0) {
-                trace() << "[XT_INSERT_DEBUG] Root state: n=" << this->_n
+                XTREE_LOG(LOG_TRACE) << "[XT_INSERT_DEBUG] Root state: n=" << this->_n
                         << ", _leaf=" << this->_leaf
                         << ", NodeID=" << this->getNodeID().raw();
             }
@@ -1282,9 +1360,18 @@ namespace xtree {
                 auto* raw = static_cast<Rec*>(record);
                 const uint16_t dims = _idx->getDimensionCount();
 
+                // 0) Find the target leaf first, so the record can be placed
+                //    next to the records already under it
+                CacheNode* leafCacheNode = thisCacheNode;
+                XTreeBucket<Record>* target = descendToLeaf(leafCacheNode, record);
+                persist::PlacementHint hint;
+                if (target->_n > 0 && target->_children[target->_n - 1]) {
+                    hint.near = target->_children[target->_n - 1]->getNodeID();
+                }
+
                 // 1) Allocate NodeID and writable buffer
                 const size_t wire_sz = raw->wire_size(dims);
-                persist::AllocResult alloc = store->allocate_node(wire_sz, persist::NodeKind::DataRecord);
+                persist::AllocResult alloc = store->allocate_node(wire_sz, persist::NodeKind::DataRecord, hint);
                 if (!alloc.writable || alloc.capacity < wire_sz) {
                     if (alloc.id.valid()) {
                         try { store->free_node(alloc.id); } catch (...) {}
@@ -1292,7 +1379,7 @@ namespace xtree {
                     throw std::runtime_error("Failed to allocate storage for DataRecord");
                 }
                 raw->setNodeID(alloc.id);
-                const UniqueId cache_id = static_cast<UniqueId>(alloc.id.raw());
+                const UniqueId cache_id = static_cast<UniqueId>(_idx->cacheKey(alloc.id));
 
                 // 2) Serialize DataRecord to allocated buffer
                 raw->to_wire(static_cast<uint8_t*>(alloc.writable), dims);
@@ -1327,7 +1414,7 @@ namespace xtree {
                 trace() << "[XT_INSERT_DEBUG] Before _insert: n=" << this->_n
                         << ", _leaf=" << this->_leaf;
 
-                leaf = _insert(thisCacheNode, cachedRecord);
+                leaf = target->insertHere(leafCacheNode, cachedRecord);
 
                 // rec_guard destructor automatically unpins
 
@@ -1363,6 +1450,18 @@ namespace xtree {
         // returns the number of children
         const int n() const { return _n; }
 
+        // Records stored below this bucket, summed from the child entries;
+        // UNKNOWN_COUNT if any child's count is unknown
+        uint64_t subtreeCount() const {
+            uint64_t total = 0;
+            for (unsigned i = 0; i < _n; ++i) {
+                const uint64_t c = _children[i]->subtreeCount();
+                if (c == _MBRKeyNode::UNKNOWN_COUNT) return c;
+                total += c;
+            }
+            return total;
+        }
+
         virtual KeyMBR* getKey() const {
             return _key;
         }
@@ -1398,6 +1497,7 @@ namespace xtree {
             // Note: parent->getNodeID() SHOULD equal this->getNodeID() - that's correct!
             // The parent KN stores the child's NodeID as its reference.
 #endif
+            if (_idx && _idx->preservingWrites()) _idx->prepareWrite(this, sizeof(*this));
             _parent = parent;
             // Record parent bucket's NodeID for cache-resilient cascading updates.
             // When parent is evicted, we can use this to reload it.
@@ -1422,9 +1522,27 @@ namespace xtree {
 
         // Update the parent NodeID (used when parent bucket is reallocated)
         void setParentNodeID(persist::NodeID new_parent_id) {
+            if (_idx && _idx->preservingWrites()) _idx->prepareWrite(this, sizeof(*this));
             _parent_node_id = new_parent_id;
         }
 
+        // After this bucket moved to a new NodeID, point the cached child
+        // buckets' _parent_node_id at it. The old NodeID's handle is freed
+        // and may be handed out again at once, so a child left with it would
+        // reload some other node as its parent. Evicted children get the new
+        // NodeID from setParent() when they are loaded again.
+        void retargetChildParents() {
+            if (!_idx || !_bucket_node_id.valid()) return;
+            for (auto* kn : _children) {
+                if (!kn || kn->isDataRecord() || !kn->hasNodeID()) continue;
+                auto* cn = _idx->getCache().find(_idx->cacheKey(kn->getNodeID()));
+                if (!cn || !cn->object) continue;
+                if (auto* child = dynamic_cast<XTreeBucket<Record>*>(cn->object)) {
+                    child->setParentNodeID(_bucket_node_id);
+                }
+            }
+        }
+
         // print out this bucket for logging
         string toString(int indentLevel=0) {
             ostringstream oss;
@@ -1508,6 +1626,7 @@ namespace xtree {
                 child->setRecord(record);
                 child->setDataRecord(false);
                 child->setLeaf(bucket->isLeaf()); // only meaningful for bucket children
+                child->setSubtreeCount(bucket->subtreeCount());
 
                 // CRITICAL FIX: Wire the bucket's _parent pointer to this KN immediately.
                 // This ensures that after splits/sorts, bucket->_parent always points to
@@ -1606,6 +1725,7 @@ namespace xtree {
 
             // Set _owner immediately so any intermediate debug helpers see it
             child->_owner = this;
+            child->_count = src._count;
 #ifndef NDEBUG
             assert(child->_owner == this);
 
@@ -1647,7 +1767,7 @@ namespace xtree {
                     // So we must look up the bucket from cache directly using its NodeID.
                     if (_idx && _idx->hasDurableStore() && src.hasNodeID()) {
                         auto& cache = _idx->getCache();
-                        auto* cn = cache.find(src.getNodeID().raw());
+                        auto* cn = cache.find(_idx->cacheKey(src.getNodeID()));
                         if (cn && cn->object) {
                             auto* bucket = static_cast<XTreeBucket<Record>*>(cn->object);
                             bucket->setParent(child);
@@ -1694,6 +1814,7 @@ namespace xtree {
                     if (!child->isDataRecord() && cn->object) {
                         auto* bucket = static_cast<XTreeBucket<Record>*>(cn->object);
                         if (bucket->_parent != child) { // avoid redundant write
+                            if (_idx && _idx->preservingWrites()) _idx->prepareWrite(bucket, sizeof(*bucket));
                             bucket->_parent = child;
 #ifndef NDEBUG
                             assert(bucket->_parent == child && "Bucket parent not rewired correctly after adoption");
@@ -1835,6 +1956,8 @@ namespace xtree {
 
         /** xt_insert() is basically just a wrapper around this. */
         XTreeBucket<Record>* _insert(CacheNode* thisCacheNode, CacheNode* record);
+        // leaf the record would be inserted into; cacheNode follows the descent
+        XTreeBucket<Record>* descendToLeaf(CacheNode*& cacheNode, IRecord* record);
         XTreeBucket<Record>* insertHere(CacheNode* thisCacheNode, CacheNode* record);
         bool basicInsert(/*const KeyMBR& key,*/ /*IRecord* */ CacheNode* record);
         
@@ -1842,25 +1965,74 @@ namespace xtree {
         // Public accessor for leaf status (needed by allocator traits)
         bool getIsLeaf() const { return this->_leaf; }
 
+        // Largest subtree count a child entry can carry (48 bits)
+        static constexpr uint64_t MAX_WIRE_COUNT = (uint64_t(1) << 48) - 1;
+
         /**
          * Wire serialization size calculation for v1 format.
          * Returns the number of bytes needed to serialize this bucket.
          * Must match the layout in to_wire/from_wire exactly.
          */
         size_t wire_size(const IndexDetails<Record>& idx) const {
-            const uint16_t dims = idx.getDimensionCount();
-            
+            return wire_size(idx.getDimensionCount(), static_cast<uint32_t>(_n));
+        }
+
+        // Size of a bucket image with n children of the given dimensionality
+        static size_t wire_size(uint16_t dims, uint32_t n) {
             // Header: is_leaf(1) + dims(2) + child_count(4) = 7
             constexpr size_t HEADER_BYTES = 1 + 2 + 4;
             
-            // Child entry: MBR (2*dims * sizeof(float)) + NodeID(8) + flags(1) + pad(7)
+            // Child entry: MBR (2*dims * sizeof(float)) + NodeID(8) + flags(1) + pad(1) + count(6)
             constexpr size_t NODEID_BYTES = 8;
             constexpr size_t FLAGS_BYTES = 1;
             constexpr size_t CHILD_PAD_BYTES = 7;
             const size_t mbr_bytes = static_cast<size_t>(2) * dims * sizeof(float);
             const size_t child_bytes = mbr_bytes + NODEID_BYTES + FLAGS_BYTES + CHILD_PAD_BYTES;
             
-            return HEADER_BYTES + static_cast<size_t>(_n) * child_bytes;
+            return HEADER_BYTES + static_cast<size_t>(n) * child_bytes;
+        }
+
+        // Fields of a bucket image, decoded without materializing the bucket
+        // (used by from_wire() and by readers that only walk the image)
+        struct WireHeader {
+            bool leaf;
+            uint16_t dims;
+            uint32_t child_count;
+        };
+        struct WireChild {
+            uint64_t node_id;   // 0 if none
+            uint8_t flags;      // bit 0: isLeaf, bit 1: subtree count present
+            uint64_t count;     // subtree count, valid if flags bit 1 is set
+        };
+
+        // The caller checks that wire_size(0, 0) bytes are available
+        static const uint8_t* read_wire_header(const uint8_t* r, WireHeader& h) {
+            h.leaf = (*r++ != 0);
+            h.dims = xtree::util::load_le16(r); r += 2;
+            h.child_count = xtree::util::load_le32(r); r += 4;
+            return r;
+        }
+
+        // True if [p, p + len) holds a whole bucket image of this
+        // dimensionality. Guards decoding by a NodeID that may be stale.
+        static bool is_wire_image(const uint8_t* p, size_t len, uint16_t dims) {
+            if (!p || len < wire_size(0, 0)) return false;
+            WireHeader h;
+            read_wire_header(p, h);
+            return h.dims == dims && wire_size(h.dims, h.child_count) <= len;
+        }
+
+        // Decodes one child entry, its MBR into mbr (of h.dims dimensions).
+        // The caller checks the image holds wire_size(h.dims, h.child_count).
+        static const uint8_t* read_wire_child(const uint8_t* r, uint16_t dims,
+                                              KeyMBR& mbr, WireChild& c) {
+            r = mbr.from_wire(r, dims);  // IMPORTANT: ensure this reads floats
+            c.node_id = xtree::util::load_le64(r); r += 8;
+            c.flags = *r++;
+            r += 1;  // pad
+            c.count = xtree::util::load_le32(r) |
+                      (static_cast<uint64_t>(xtree::util::load_le16(r + 4)) << 32);
+            return r + 6;
         }
         
         /**
@@ -1875,8 +2047,9 @@ namespace xtree {
          * ChildEntry layout:
          *   [MBR]   dim*2 floats (min/max per dimension)
          *   [u64]   NodeID (0 if none)
-         *   [u8]    flags (bit 0: isLeaf, others reserved)
-         *   [u8*7]  pad (for alignment)
+         *   [u8]    flags (bit 0: isLeaf, bit 1: subtree count present, others reserved)
+         *   [u8]    pad
+         *   [u48]   subtree count (bucket children; 0 unless flags bit 1 is set)
          *
          * Notes:
          * - Parent buckets store child MBRs explicitly
@@ -1940,12 +2113,20 @@ namespace xtree {
                 }
 #endif
                 
-                // Write flags + pad
+                // Write flags + pad + subtree count (occupies what used to be padding,
+                // so entries written before counts were kept still parse)
+                const uint64_t count = kn->isDataRecord() ? 0 : kn->subtreeCount();
+                const bool hasCount = !kn->isDataRecord() && count <= MAX_WIRE_COUNT;
                 uint8_t flags = 0;
                 if (kn->getLeaf()) flags |= 0x1;  // Use getLeaf() not isLeaf()
+                if (hasCount) flags |= 0x2;
                 *out++ = flags;
-                
-                std::memset(out, 0, CHILD_PAD_BYTES); out += CHILD_PAD_BYTES;
+                *out++ = 0;
+
+                const uint64_t wireCount = hasCount ? count : 0;
+                xtree::util::store_le32(out, static_cast<uint32_t>(wireCount));
+                xtree::util::store_le16(out + 4, static_cast<uint16_t>(wireCount >> 32));
+                out += CHILD_PAD_BYTES - 1;
             }
             
 #ifndef NDEBUG
@@ -1972,15 +2153,12 @@ namespace xtree {
             const uint8_t* start = r;  // For debug size check
             const uint16_t prec = idx->getPrecision();
             
-            auto get_u8  = [&](){ return *r++; };
-            auto get_u16 = [&](){ uint16_t v = xtree::util::load_le16(r); r += 2; return v; };
-            auto get_u32 = [&](){ uint32_t v = xtree::util::load_le32(r); r += 4; return v; };
-            auto get_u64 = [&](){ uint64_t v = xtree::util::load_le64(r); r += 8; return v; };
-            
             // --- Header: is_leaf(1) + dims(2) + child_count(4) = 7 bytes ---
-            _leaf = (get_u8() != 0);  // Single byte, no endianness needed
-            const uint16_t dims = get_u16();  // Uses load_le16
-            const uint32_t n = get_u32();     // Uses load_le32
+            WireHeader header;
+            r = read_wire_header(r, header);
+            _leaf = header.leaf;
+            const uint16_t dims = header.dims;
+            const uint32_t n = header.child_count;
             
             if (!this->_key) {
                 this->_key = new KeyMBR(dims, prec);
@@ -1992,24 +2170,17 @@ namespace xtree {
             _children.clear();
             _children.reserve(n > XTREE_CHILDVEC_INIT_SIZE ? n : XTREE_CHILDVEC_INIT_SIZE);
             
-            constexpr size_t NODEID_BYTES = 8;
-            constexpr size_t FLAGS_BYTES = 1;
-            constexpr size_t CHILD_PAD_BYTES = 7;
-            
             // Hoist mode check out of loop for better performance
             const bool durable = (idx->getPersistenceMode() == IndexDetails<Record>::PersistenceMode::DURABLE);
             
             for (uint32_t i = 0; i < n; ++i) {
-                // MBR (must read floats to match wire format)
+                // MBR, NodeID, flags + subtree count
                 KeyMBR child_mbr(dims, prec);
-                r = child_mbr.from_wire(r, dims);  // IMPORTANT: ensure this reads floats
-                
-                // NodeID
-                const uint64_t raw = get_u64();
-                
-                // Flags + pad
-                const uint8_t flags = get_u8();
-                r += CHILD_PAD_BYTES; // skip padding
+                WireChild entry;
+                r = read_wire_child(r, dims, child_mbr, entry);
+                const uint64_t raw = entry.node_id;
+                const uint8_t flags = entry.flags;
+                const uint64_t count = entry.count;
                 
                 auto* kn = new _MBRKeyNode();
                 
@@ -2062,6 +2233,7 @@ namespace xtree {
                     
                     kn->setDataRecord(false);  // Explicitly mark as bucket child
                     kn->setLeaf((flags & 0x1) != 0);  // Only meaningful for bucket children
+                    kn->setSubtreeCount((flags & 0x2) ? count : _MBRKeyNode::UNKNOWN_COUNT);
                 }
                 
                 _children.push_back(kn);
@@ -2087,11 +2259,7 @@ namespace xtree {
             
 #ifndef NDEBUG
             // Strong symmetry check: verify we consumed exactly the expected bytes
-            // Reuse same constants for clarity
-            constexpr size_t HEADER_BYTES = 1 + 2 + 4;
-            const size_t mbr_bytes = static_cast<size_t>(2) * dims * sizeof(float);
-            const size_t child_bytes = mbr_bytes + NODEID_BYTES + FLAGS_BYTES + CHILD_PAD_BYTES;
-            const size_t expected = HEADER_BYTES + n * child_bytes;
+            const size_t expected = wire_size(dims, n);
             const size_t consumed = static_cast<size_t>(r - start);
             assert(consumed == expected && "from_wire consumed unexpected number of bytes");
 #endif
@@ -2105,7 +2273,7 @@ namespace xtree {
         void purge(CacheNode* thisCacheNode) {}
 
         // choose subtree (complex algorithm)
-        XTreeBucket<Record>* chooseSubtree(CacheNode* record);
+        XTreeBucket<Record>* chooseSubtree(IRecord* record);
 
         /*****************
          * Split methods *
@@ -2211,7 +2379,7 @@ namespace xtree {
         void clearDirty() {
             // Only unpin if we pinned it during markDirty()
             if (_dirty_pinned && _idx && _bucket_node_id.valid()) {
-                uint64_t key = _bucket_node_id.raw();
+                uint64_t key = _idx->cacheKey(_bucket_node_id);
                 auto* cn = _idx->getCache().find(key);
                 if (cn) {
                     _idx->getCache().unpin(cn, key);
@@ -2219,10 +2387,37 @@ namespace xtree {
                 _dirty_pinned = false;
             }
             _dirty = false;
+            _counts_stale = false;  // Publishing wrote the current counts
+            clearStaleListed();     // May republish under a new NodeID; list it again if stale
+        }
+
+        // Child entry counts changed but nothing else did (see
+        // propagateMBRUpdate). The bucket is written with its next publish,
+        // or by IndexDetails::flush_stale_counts() at checkpoint and close;
+        // until then it stays pinned so the counts are not lost to eviction.
+        bool hasStaleCounts() const { return _counts_stale; }
+        void markCountsStale() {
+            if (_idx && _idx->hasWriteObserver()) recordWrites();
+            if (_dirty || _counts_stale) return;
+            _counts_stale = true;
+            if (_idx && _idx->hasDurableStore() &&
+                _idx->getPersistenceMode() == IndexDetails<Record>::PersistenceMode::DURABLE) {
+                _idx->register_stale_counts(this);
+                if (_bucket_node_id.valid() && !_dirty_pinned) {
+                    uint64_t key = _idx->cacheKey(_bucket_node_id);
+                    if (auto* cn = _idx->getCache().find(key)) {
+                        _idx->getCache().pin(cn, key);
+                        _dirty_pinned = true;
+                    }
+                }
+            }
         }
 
-        // Mark this bucket as dirty (needs persistence), auto-register, and pin
+        // Mark this bucket as dirty (needs persistence), auto-register, and pin.
+        // Every in-place mutation (insert, split, MBR expansion) ends here, so
+        // this is also where the written memory is reported to any observer.
         void markDirty() {
+            if (_idx && _idx->hasWriteObserver()) recordWrites();
             if (!_dirty) {
                 _dirty = true;
                 // Auto-register with IndexDetails for batch publishing
@@ -2233,8 +2428,9 @@ namespace xtree {
                     // CRITICAL: Pin this bucket so it's not evicted while dirty.
                     // Dirty buckets haven't been committed to the durable store yet,
                     // so evicting them would cause failures on reload.
-                    if (_bucket_node_id.valid()) {
-                        uint64_t key = _bucket_node_id.raw();
+                    // (Buckets with stale counts are pinned already.)
+                    if (_bucket_node_id.valid() && !_dirty_pinned) {
+                        uint64_t key = _idx->cacheKey(_bucket_node_id);
                         auto* cn = _idx->getCache().find(key);
                         if (cn) {
                             _idx->getCache().pin(cn, key);
@@ -2259,6 +2455,15 @@ namespace xtree {
             }
         }
         
+        // Queue this bucket for flush_stale_counts() at most once
+        bool try_list_stale() noexcept {
+            bool expected = false;
+            return _stale_listed.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+        }
+        void clearStaleListed() noexcept {
+            _stale_listed.store(false, std::memory_order_release);
+        }
+
         // Try to enlist this bucket in the dirty list (returns true if newly enlisted)
         bool try_enlist() noexcept {
             bool expected = false;
@@ -2269,8 +2474,8 @@ namespace xtree {
         // This is called after cache insertion for buckets that were marked dirty
         // before being added to cache (markDirty() couldn't pin them at that time).
         void ensureDirtyPinned(CacheNode* cn) {
-            if (_dirty && !_dirty_pinned && cn && _bucket_node_id.valid()) {
-                uint64_t key = _bucket_node_id.raw();
+            if ((_dirty || _counts_stale) && !_dirty_pinned && cn && _bucket_node_id.valid()) {
+                uint64_t key = _idx->cacheKey(_bucket_node_id);
                 _idx->getCache().pin(cn, key);
                 _dirty_pinned = true;
 #ifndef NDEBUG
@@ -2441,7 +2646,8 @@ namespace xtree {
                 // Recompute MBR for this node
                 cur->recalculateMBR();
 
-                const bool curChanged = changed || !oldMBR.equals(*(cur->_key));
+                const bool mbrChanged = !oldMBR.equals(*(cur->_key));
+                const bool curChanged = changed || mbrChanged;
                 if (curChanged) {
                     cur->markDirty();
                 }
@@ -2463,8 +2669,16 @@ namespace xtree {
                     cur->_parent->setCacheAlias(saved_cache);
                 }
 
+                // Subtree counts change on every insert, even when the MBR does
+                // not. A count-only change is not worth republishing the whole
+                // root path per insert: the parent keeps it in memory and
+                // writes it lazily (markCountsStale()).
+                const uint64_t count = cur->subtreeCount();
+                const bool countChanged = (cur->_parent->_count != count);
+                cur->_parent->_count = count;
+
                 // If nothing changed here, no need to climb further
-                if (!curChanged) {
+                if (!curChanged && !countChanged) {
                     break;
                 }
 
@@ -2507,7 +2721,13 @@ namespace xtree {
 #endif
 
                 cur = parentBucket;
-                changed = true;
+                // The parent's entry for cur is (MBR, NodeID); only an MBR
+                // change rewrites it here. NodeID rebinds dirty the parent
+                // where they happen (insertHere, split).
+                changed = mbrChanged;
+                if (!changed) {
+                    cur->markCountsStale();
+                }
             }
         }
 
@@ -2633,6 +2853,40 @@ namespace xtree {
 #endif
 
     private:
+        // Calls fn(ptr, len) for the memory an in-place mutation touches: the
+        // bucket header, its MBR, the child pointer array and the live child
+        // entries
+        template <typename Fn>
+        void forEachWritableRange(Fn&& fn) {
+            fn(this, sizeof(*this));
+            if (this->_key) {
+                fn(this->_key, sizeof(KeyMBR));
+                if (this->_key->data()) {
+                    fn(this->_key->data(), 2 * this->_key->getDimensionCount() * sizeof(float));
+                }
+            }
+            if (!_children.empty()) {
+                fn(_children.data(), _children.size() * sizeof(_MBRKeyNode*));
+            }
+            for (unsigned int i = 0; i < _n && i < _children.size(); i++) {
+                if (_children[i]) fn(_children[i], sizeof(_MBRKeyNode));
+            }
+        }
+
+        // Reports the ranges after a mutation
+        void recordWrites() {
+            forEachWritableRange([this](const void* ptr, size_t len) {
+                XAlloc<Record>::record_write(_idx, ptr, len);
+            });
+        }
+
+        // Runs the index write barrier over the ranges before a mutation
+        void prepareWrites() {
+            forEachWritableRange([this](const void* ptr, size_t len) {
+                _idx->prepareWrite(ptr, len);
+            });
+        }
+
         /** header data below */
 
         // memory usage for this bucket
@@ -2666,6 +2920,8 @@ namespace xtree {
         // dirty flag for batch publishing
         bool _dirty;                        // 1 byte
         bool _dirty_pinned = false;         // 1 byte - tracks if we pinned during markDirty()
+        bool _counts_stale = false;         // 1 byte - see markCountsStale()
+        std::atomic<bool> _stale_listed{false};  // 1 byte - queued by register_stale_counts()
         // enlisted flag for deduplication in dirty list
         std::atomic<bool> _enlisted;        // 1 byte
         // in memory child pointers
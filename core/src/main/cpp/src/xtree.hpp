@@ -53,10 +53,17 @@ namespace xtree {
         assert(cachedRecord && cachedRecord->isPinned() &&
                "_insert requires a cache-managed, pinned node");
 
+        // Pass the CORRECT cache node for the leaf bucket, not the original root's cache node
+        CacheNode* leafCacheNode = thisCacheNode;
+        XTreeBucket<RecordType>* leaf = this->descendToLeaf(leafCacheNode, cachedRecord->object);
+        return leaf->insertHere(leafCacheNode, cachedRecord);
+    }
+
+    template< class RecordType >
+    XTreeBucket<RecordType>* XTreeBucket<RecordType>::descendToLeaf(CacheNode*& currentCacheNode, IRecord* record) {
         XTreeBucket<RecordType>* subTree = this;
         // CRITICAL: Track the cache node for the CURRENT bucket during descent
-        // thisCacheNode must always correspond to subTree, not the original root
-        CacheNode* currentCacheNode = thisCacheNode;
+        // currentCacheNode must always correspond to subTree, not the original root
 
         // OPTIMIZATION: Check if we can trust _cache_ptr directly
         // When eviction is disabled (getMaxMemory() == 0), pointers stored in _MBRKeyNode
@@ -64,9 +71,14 @@ namespace xtree {
         // This allows us to skip the O(1) cache lookup at each level of descent.
         const bool can_trust_cache_ptrs = (this->_idx->getCache().getMaxMemory() == 0);
 
+        // Every bucket on the path may be written by the insert (entry, MBR
+        // and count updates, splits), so it is prepared before it is touched
+        const bool preserve = this->_idx->preservingWrites();
+
         // traverse to a leaf level
         while(!subTree->isLeaf()) {
-            subTree = subTree->chooseSubtree(cachedRecord);
+            if (preserve) subTree->prepareWrites();
+            subTree = subTree->chooseSubtree(record);
             if (!subTree) {
                 throw std::runtime_error("_insert: null subtree during descent");
             }
@@ -90,16 +102,16 @@ namespace xtree {
             // Always use find() to get a validated cache node.
             if (subTree->_parent && subTree->hasNodeID()) {
                 using Alloc = XAlloc<RecordType>;
-                uint64_t key = Alloc::cache_key_for(subTree->getNodeID(), subTree);
+                uint64_t key = Alloc::cache_key_for(this->_idx, subTree->getNodeID(), subTree);
                 auto* cn = this->_idx->getCache().find(key);
                 if (cn && cn->object == reinterpret_cast<IRecord*>(subTree)) {
                     currentCacheNode = cn;
                 }
             }
         }
+        if (preserve) subTree->prepareWrites();
 
-        // Pass the CORRECT cache node for the leaf bucket, not the original root's cache node
-        return subTree->insertHere(currentCacheNode, cachedRecord);
+        return subTree;
     }
 
     /**
@@ -115,7 +127,7 @@ namespace xtree {
 #ifndef NDEBUG
         // CRITICAL: Tripwire to catch re-entry with same payload pointer
         static thread_local const void* last_payload = nullptr;
-        trace() << "[TRIPWIRE] insertHere called with cachedRecord=" << cachedRecord
+        XTREE_LOG(LOG_TRACE) << "[TRIPWIRE] insertHere called with cachedRecord=" << cachedRecord
                   << " last_payload=" << last_payload << std::endl;
         assert(last_payload != cachedRecord && "Same cachedRecord re-used in immediate re-entry");
         last_payload = cachedRecord;
@@ -159,7 +171,7 @@ namespace xtree {
 
 #ifndef NDEBUG
             if (current_bucket != this) {
-                trace() << "[INSERT_RELOCATE] bucket moved: " << this
+                XTREE_LOG(LOG_TRACE) << "[INSERT_RELOCATE] bucket moved: " << this
                           << " -> " << current_bucket
                           << " (old id=" << id_before.raw()
                           << " new id=" << current_bucket->getNodeID().raw() << ")\n";
@@ -177,7 +189,7 @@ namespace xtree {
 #ifndef NDEBUG
             // Detect parent/child NodeID collision (allocator bug)
             if (parent_after && current_bucket->getNodeID() == parent_after->getNodeID()) {
-                trace() << "[ID_COLLISION] child NodeID matches parent after publish: "
+                XTREE_LOG(LOG_TRACE) << "[ID_COLLISION] child NodeID matches parent after publish: "
                           << current_bucket->getNodeID().raw() << "\n";
                 assert(false && "allocator/id-publish must never collide with parent NodeID");
             }
@@ -194,6 +206,7 @@ namespace xtree {
                     KeyMBR stable_mbr = *current_bucket->_key;
                     kn->setDurableBucketChild(stable_mbr, current_bucket->getNodeID(), current_bucket->_leaf);
                     if (thisCacheNode) kn->setCacheAlias(thisCacheNode);
+                    if (parent_after) parent_after->markDirty();
 #ifndef NDEBUG
                     // Verify KN→NodeID parity (only in DURABLE mode)
                     if (this->_idx->hasDurableStore()) {
@@ -203,7 +216,7 @@ namespace xtree {
                 } else if (!current_bucket->_parent && current_bucket->_idx) {
                     // Root case: update root identity using canonical cache key
                     using Alloc = XTreeAllocatorTraits<RecordType>;
-                    const uint64_t cache_key = Alloc::cache_key_for(current_bucket->getNodeID(), current_bucket);
+                    const uint64_t cache_key = Alloc::cache_key_for(current_bucket->_idx, current_bucket->getNodeID(), current_bucket);
                     current_bucket->_idx->setRootIdentity(cache_key, current_bucket->getNodeID(), thisCacheNode);
                 }
 
@@ -355,7 +368,7 @@ namespace xtree {
         decltype(cn) cached_cn = nullptr;
         if (may_evict && pid.valid()) {
             // Safe path: validate via cache lookup
-            cached_cn = idx->getCache().find(pid.raw());
+            cached_cn = idx->getCache().find(idx->cacheKey(pid));
         } else {
             // Fast path: trust the stored pointer
             cached_cn = kn->getCacheRecord();
@@ -370,7 +383,7 @@ namespace xtree {
                 kn->setCacheAlias(nullptr);
 
                 using Alloc = XTreeAllocatorTraits<RecordType>;
-                const uint64_t key = Alloc::cache_key_for(pid, result);
+                const uint64_t key = Alloc::cache_key_for(idx, pid, result);
                 auto& cache = idx->getCache();
 
                 // Reattach (find existing or add if truly missing)
@@ -397,8 +410,7 @@ namespace xtree {
      * time splitting. we don't want that since split is expensive
      */
     template< class RecordType >
-    XTreeBucket<RecordType>* XTreeBucket<RecordType>::chooseSubtree(CacheNode* cachedRecord) {
-        IRecord* record = cachedRecord->object;
+    XTreeBucket<RecordType>* XTreeBucket<RecordType>::chooseSubtree(IRecord* record) {
 
 #ifndef NDEBUG
         // Sanity check: chooseSubtree should only be called on internal nodes
@@ -417,7 +429,7 @@ namespace xtree {
 
             // Use auto to avoid CacheNode type issues
             auto* cn_check = eviction_enabled && kn->hasNodeID()
-                ? _idx->getCache().find(kn->getNodeID().raw())
+                ? _idx->getCache().find(_idx->cacheKey(kn->getNodeID()))
                 : kn->getCacheRecord();
 
             if (cn_check && cn_check->object == reinterpret_cast<IRecord*>(this)) {
@@ -911,8 +923,8 @@ namespace xtree {
         const unsigned int old_n = this->_n;
         
         // Step 1: Create empty right sibling (NO source children - we'll use kn_from_entry)
-        auto rightRef = Alloc::allocate_bucket(
-            this->_idx, kind,
+        auto rightRef = Alloc::allocate_bucket_near(
+            this->_idx, kind, this->getNodeID(),
             /*isRoot*/ false,
             /*key*/    mbr2,
             /*source*/ nullptr,  // CRITICAL: Don't pass source
@@ -922,7 +934,7 @@ namespace xtree {
         );
         
         auto* rightBucket = rightRef.ptr;
-        Alloc::record_write(this->_idx, rightBucket);  // Optional COW instrumentation
+        Alloc::record_write(this->_idx, rightBucket, sizeof(*rightBucket));  // Optional COW instrumentation
 
 #ifndef NDEBUG
         // Verify split allocator used correct kind
@@ -1028,8 +1040,9 @@ namespace xtree {
         rightBucket->markDirty();        // Mark for batch publishing
         
         // Step 3: Cache insert (mode-transparent key)
-        const uint64_t cacheKey = Alloc::cache_key_for(rightRef.id, rightBucket);
-        CacheNode* cachedSplitNode = this->_idx->getCache().add(cacheKey, reinterpret_cast<IRecord*>(rightBucket));
+        const uint64_t cacheKey = Alloc::cache_key_for(this->_idx, rightRef.id, rightBucket);
+        CacheNode* cachedSplitNode = this->_idx->getCache().add(cacheKey, reinterpret_cast<IRecord*>(rightBucket),
+                                                                       true, this->_idx->getFieldName());
 
         // CRITICAL: Pin the bucket now that it's in cache.
         // markDirty() was called before cache insertion, so it couldn't pin.
@@ -1101,7 +1114,7 @@ namespace xtree {
             if (pub_result.id.valid() && pub_result.id != old_id) {
                 // Rekey the cache entry from old NodeID to new NodeID
                 // This maintains cache consistency after COW reallocation
-                idx->getCache().rekey(old_id.raw(), pub_result.id.raw());
+                idx->getCache().rekey(idx->cacheKey(old_id), idx->cacheKey(pub_result.id));
 
                 // CRITICAL: Update the parent's _MBRKeyNode to reference the new NodeID.
                 // Without this, the parent bucket will still serialize/reference the old NodeID,
@@ -1159,12 +1172,12 @@ namespace xtree {
         assert(this->_leaf == splitBucket->_leaf && "siblings should agree on leaf-ness");
         
         // Step 1: Allocate a new root (Internal, isRoot=true)
-        auto rootRef = Alloc::allocate_bucket(
-            this->_idx, persist::NodeKind::Internal,
+        auto rootRef = Alloc::allocate_bucket_near(
+            this->_idx, persist::NodeKind::Internal, this->getNodeID(),
             /*isRoot*/ true
         );
         auto* rootBucket = rootRef.ptr;
-        Alloc::record_write(this->_idx, rootBucket);  // Optional COW/metrics
+        Alloc::record_write(this->_idx, rootBucket, sizeof(*rootBucket));  // Optional COW/metrics
 
         // Ensure root is internal (even though allocate_bucket should handle this)
         rootBucket->_leaf = false;
@@ -1181,8 +1194,9 @@ namespace xtree {
                   << std::endl;
         
         // Step 2: Cache the new root under mode-transparent identity
-        const uint64_t rootKey = Alloc::cache_key_for(rootRef.id, rootBucket);
-        CacheNode* cachedRootNode = this->_idx->getCache().add(rootKey, reinterpret_cast<IRecord*>(rootBucket));
+        const uint64_t rootKey = Alloc::cache_key_for(this->_idx, rootRef.id, rootBucket);
+        CacheNode* cachedRootNode = this->_idx->getCache().add(rootKey, reinterpret_cast<IRecord*>(rootBucket),
+                                                                     true, this->_idx->getFieldName());
 
         // Debug: Check after caching
         if (!rootBucket->_key->debug_check_area()) {
@@ -1269,6 +1283,7 @@ namespace xtree {
             left_kn->setDataRecord(false);  // This is a bucket, not data
             left_kn->setLeaf(this->_leaf);
         }
+        left_kn->setSubtreeCount(this->subtreeCount());
         left_kn->_owner = rootBucket;
         this->setParent(left_kn);
 
@@ -1296,6 +1311,7 @@ namespace xtree {
             right_kn->setDataRecord(false);  // This is a bucket, not data
             right_kn->setLeaf(splitBucket->_leaf);
         }
+        right_kn->setSubtreeCount(splitBucket->subtreeCount());
         right_kn->_owner = rootBucket;
         splitBucket->setParent(right_kn);
 
@@ -1610,6 +1626,9 @@ namespace xtree {
         // Cascade split at MAX_FANOUT prevents unbounded growth.
         // ============================================================
 
+        // The left child gave up its tail to the sibling; kn() counts the sibling
+        left_kn->setSubtreeCount(curLeft->subtreeCount());
+
         // Insert sibling into parent via kn() - this handles all wiring
         parent->kn(cachedSplitBucket);
 
@@ -1675,7 +1694,7 @@ namespace xtree {
 
         // Get parent's cache node for MBR propagation
         using Alloc = XTreeAllocatorTraits<RecordType>;
-        const uint64_t pKey = Alloc::cache_key_for(parent->getNodeID(), parent);
+        const uint64_t pKey = Alloc::cache_key_for(this->_idx, parent->getNodeID(), parent);
         CacheNode* parentCN = this->_idx->getCache().lookup_or_attach(pKey, reinterpret_cast<IRecord*>(parent));
 
         // Recompute parent MBR and propagate
@@ -1773,4 +1792,10 @@ namespace xtree {
         return iter;
     }
 
+    template< class RecordType >
+    PooledIterator<RecordType> XTreeBucket<RecordType>::getPooledIterator(CacheNode* thisCacheNode, IRecord* searchKey, int queryType) {
+        return PooledIterator<RecordType>(IteratorPool<RecordType>::acquire(
+            thisCacheNode, searchKey, static_cast<SearchType>(queryType), this->_idx));
+    }
+
 } // namespace xtree
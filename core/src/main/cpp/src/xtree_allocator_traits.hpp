@@ -101,7 +101,7 @@ struct XTreeAllocatorTraits {
         delete record;
     }
     
-    static void record_write(IndexDetails<Record>* idx, void* ptr) {
+    static void record_write(IndexDetails<Record>* idx, const void* ptr, size_t len) {
         // No-op for standard allocation
     }
     
@@ -185,6 +185,19 @@ struct XTreeAllocatorTraits<Record,
     static BucketRef<Record> allocate_bucket(IndexDetails<Record>* idx,
                                             persist::NodeKind kind,
                                             CtorArgs&&... args) {
+        return allocate_bucket_near(idx, kind, persist::NodeID::invalid(),
+                                    std::forward<CtorArgs>(args)...);
+    }
+
+    /**
+     * allocate_bucket() placed next to `near` (the bucket being split, the
+     * old root) when the store has room there, so siblings share pages
+     */
+    template<typename... CtorArgs>
+    static BucketRef<Record> allocate_bucket_near(IndexDetails<Record>* idx,
+                                                 persist::NodeKind kind,
+                                                 persist::NodeID near,
+                                                 CtorArgs&&... args) {
         auto* store = idx ? idx->getStore() : nullptr;
 
         // Fallback path: no store configured
@@ -223,7 +236,7 @@ struct XTreeAllocatorTraits<Record,
         }
         
         // 3. Allocate storage for wire format
-        persist::AllocResult alloc = store->allocate_node(wire_sz, kind);
+        persist::AllocResult alloc = store->allocate_node(wire_sz, kind, persist::PlacementHint{near});
         
         // Record durable identity inside the bucket
         bucket->setNodeID(alloc.id);
@@ -424,8 +437,8 @@ public:
         delete record;
     }
     
-    static void record_write(IndexDetails<Record>* idx, void* ptr) {
-        idx->recordWrite(ptr);
+    static void record_write(IndexDetails<Record>* idx, const void* ptr, size_t len) {
+        if (idx) idx->recordWrite(ptr, len);
     }
     
     static void record_operation(IndexDetails<Record>* idx) {
@@ -491,10 +504,13 @@ public:
 #endif
             }
 
-            persist::AllocResult alloc = store->allocate_node(new_capacity, nk);
+            // Grown buckets move next to their parent when the size class allows
+            persist::AllocResult alloc = store->allocate_node(
+                new_capacity, nk, persist::PlacementHint{bucket->getParentNodeID()});
 
             // Update bucket's NodeID to the new allocation
             bucket->setNodeID(alloc.id);
+            bucket->retargetChildParents();
             
             // Serialize and publish to new location
             uint8_t* wire_buf = static_cast<uint8_t*>(alloc.writable);
@@ -717,11 +733,12 @@ public:
     
     /**
      * Generate a cache key transparently for both modes
-     * DURABLE: use NodeID.raw() to avoid ABA issues
+     * DURABLE: use the index's NodeID key (IndexDetails::cacheKey) to avoid ABA issues
      * IN_MEMORY: use pointer value
      */
-    static inline uint64_t cache_key_for(persist::NodeID id, void* ptr) {
-        return id.valid() ? id.raw() : reinterpret_cast<uint64_t>(ptr);
+    static inline uint64_t cache_key_for(const IndexDetails<Record>* idx, persist::NodeID id, void* ptr) {
+        if (!id.valid()) return reinterpret_cast<uint64_t>(ptr);
+        return idx ? idx->cacheKey(id) : id.raw();
     }
 };
 
@@ -74,7 +74,7 @@ public:
         if (auto* compactAlloc = index->getCompactAllocator()) {
             // Use compact allocator for MMAP mode
             root = compactAlloc->allocate_bucket(index, true);
-            index->recordWrite(root);
+            index->recordWrite(root, sizeof(*root));
         } else {
             // Fallback to standard allocation for IN_MEMORY mode
             root = new XTreeBucket<Record>(index, true);
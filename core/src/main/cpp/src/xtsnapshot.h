@@ -0,0 +1,228 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "xtree.h"
+
+namespace xtree {
+
+    /**
+     * Query over the tree as it was at a snapshot's epoch.
+     *
+     * Buckets and data records are read with StoreInterface::read_node_at()
+     * and decoded with the same readers as XTreeBucket::from_wire() and
+     * RecordType::from_wire(), so the traversal never goes through
+     * (or disturbs) the shared node cache, whose buckets always hold the
+     * latest version. Matching is the same MBR test Iterator makes:
+     * subtrees are entered when their key intersects the search key, data
+     * records are kept by the search type's predicate.
+     */
+    template< class RecordType >
+    class SnapshotIterator {
+    public:
+        SnapshotIterator(const persist::StoreInterface* store, uint64_t epoch, persist::NodeID root,
+                         const KeyMBR& searchKey, SearchType type,
+                         unsigned short dims, unsigned short precision) :
+            _store(store),
+            _epoch(epoch),
+            _search(searchKey),
+            _type(type),
+            _dims(dims),
+            _precision(precision),
+            _scratch(dims, precision),
+            _record(dims, precision, "") {
+            _minRecordBytes = _record.wire_size(dims);
+            if (root.valid() && root.raw() != 0) {
+                _buckets.push_back(root.raw());
+            }
+        }
+
+        /**
+         * Next matching row id. The view is valid until the next call.
+         * @throws std::runtime_error if a node the snapshot needs cannot be read
+         */
+        bool nextRowID(std::string_view& rowid) {
+            while (_next == _records.size()) {
+                if (_buckets.empty()) {
+                    return false;
+                }
+                const uint64_t raw = _buckets.back();
+                _buckets.pop_back();
+                expand(raw);
+            }
+
+            const uint64_t raw = _records[_next++];
+            read(raw);
+            if (_buf.size() < _minRecordBytes) {
+                throw std::runtime_error("SnapshotIterator: truncated data record " + std::to_string(raw));
+            }
+            _record.from_wire(_buf.data(), _dims, _precision);
+            if (_record.wire_size(_dims) > _buf.size()) {
+                throw std::runtime_error("SnapshotIterator: truncated data record " + std::to_string(raw));
+            }
+            rowid = _record.getRowIDView();
+            return true;
+        }
+
+        // Buckets and data records read so far
+        uint64_t nodesRead() const { return _nodesRead; }
+
+    private:
+        void read(uint64_t raw) {
+            if (!_store->read_node_at(persist::NodeID::from_raw(raw), _epoch, _buf)) {
+                throw std::runtime_error("SnapshotIterator: node " + std::to_string(raw) +
+                                         " is not visible at epoch " + std::to_string(_epoch));
+            }
+            _nodesRead++;
+        }
+
+        bool matches(const KeyMBR& child) const {
+            switch (_type) {
+                case INTERSECTS: return child.intersects(_search);
+                case WITHIN:     return _search.contains(child);
+                case CONTAINS:   return child.contains(_search);
+                default:         return true;
+            }
+        }
+
+        // Queue the children of a bucket. The image is walked with the
+        // decoders XTreeBucket::from_wire() uses, without building a bucket.
+        void expand(uint64_t raw) {
+            using Bucket = XTreeBucket<RecordType>;
+
+            read(raw);
+            if (_buf.size() < Bucket::wire_size(0, 0)) {
+                throw std::runtime_error("SnapshotIterator: truncated bucket " + std::to_string(raw));
+            }
+            typename Bucket::WireHeader header;
+            const uint8_t* r = Bucket::read_wire_header(_buf.data(), header);
+            if (header.dims != _dims || _buf.size() < Bucket::wire_size(header.dims, header.child_count)) {
+                throw std::runtime_error("SnapshotIterator: malformed bucket " + std::to_string(raw));
+            }
+
+            _records.clear();
+            _next = 0;
+            typename Bucket::WireChild entry;
+            for (uint32_t i = 0; i < header.child_count; ++i) {
+                r = Bucket::read_wire_child(r, _dims, _scratch, entry);
+                const uint64_t child = entry.node_id;
+                if (!child) {
+                    continue;
+                }
+                if (header.leaf) {
+                    if (matches(_scratch)) _records.push_back(child);
+                } else if (_scratch.intersects(_search)) {
+                    _buckets.push_back(child);
+                }
+            }
+        }
+
+        const persist::StoreInterface* _store;
+        uint64_t _epoch;
+        KeyMBR _search;
+        SearchType _type;
+        unsigned short _dims;
+        unsigned short _precision;
+        KeyMBR _scratch;                    // child key being tested
+        RecordType _record;                 // data record being returned
+        size_t _minRecordBytes = 0;         // image size of a record with no row id or points
+
+        std::vector<uint64_t> _buckets;     // DFS stack of buckets still to expand
+        std::vector<uint64_t> _records;     // matching data records of the last leaf
+        size_t _next = 0;
+        std::vector<uint8_t> _buf;
+        uint64_t _nodesRead = 0;
+    };
+
+    /**
+     * A read snapshot of a DURABLE index: pins the newest committed epoch
+     * (or, with snapshot retention configured, an older retained one) and
+     * answers queries against the tree as of that epoch until destroyed.
+     * Writers are not blocked; see persist/snapshot_registry.h for what a
+     * held snapshot keeps alive. Snapshots last for the life of the process:
+     * the root history they resolve against is kept in memory alongside the
+     * node shadows, not in the superblock.
+     */
+    template< class RecordType >
+    class ReadSnapshot {
+    public:
+        /**
+         * @throws std::runtime_error if the index has no durable store, or
+         *         the epoch is no longer retained
+         */
+        explicit ReadSnapshot(IndexDetails<RecordType>* idx,
+                              uint64_t epoch = persist::kLatestSnapshot) :
+            _idx(idx),
+            _store(idx->hasDurableStore() ? idx->getStore() : nullptr) {
+            if (!_store) {
+                throw std::runtime_error("ReadSnapshot: index has no durable store");
+            }
+            _epoch = _store->acquire_snapshot(epoch);
+            try {
+                _root = _store->root_at(_epoch, idx->getFieldName());
+            } catch (...) {
+                _store->release_snapshot(_epoch);
+                throw;
+            }
+        }
+
+        ~ReadSnapshot() {
+            _store->release_snapshot(_epoch);
+        }
+
+        ReadSnapshot(const ReadSnapshot&) = delete;
+        ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+
+        uint64_t epoch() const { return _epoch; }
+        persist::NodeID root() const { return _root; }
+
+        // The iterator must not outlive the snapshot
+        SnapshotIterator<RecordType> query(IRecord* searchKey, SearchType type = INTERSECTS) const {
+            return SnapshotIterator<RecordType>(_store, _epoch, _root, *searchKey->getKey(), type,
+                                                _idx->getDimensionCount(), _idx->getPrecision());
+        }
+
+        // Calls fn(std::string_view rowid) per match; returns the match count
+        template< typename Fn >
+        size_t forEach(IRecord* searchKey, SearchType type, Fn&& fn) const {
+            auto it = query(searchKey, type);
+            std::string_view rowid;
+            size_t n = 0;
+            while (it.nextRowID(rowid)) {
+                fn(rowid);
+                n++;
+            }
+            return n;
+        }
+
+    private:
+        IndexDetails<RecordType>* _idx;
+        persist::StoreInterface* _store;
+        uint64_t _epoch = 0;
+        persist::NodeID _root;
+    };
+
+} // namespace xtree
@@ -0,0 +1,300 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Tests for incremental (dirty-page delta) COW memory snapshots.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include "../../src/indexdetails.hpp"
+#include "../../src/memmgr/cow_memmgr.hpp"
+
+using namespace xtree;
+
+class COWIncrementalSnapshotTest : public ::testing::Test {
+protected:
+    using Manager = DirectMemoryCOWManager<DataRecord>;
+
+    std::string snapshot_file;
+    Manager* cow_manager = nullptr;
+    std::vector<char*> regions;
+    size_t page_size = PageAlignedMemoryTracker::get_cached_page_size();
+
+    void SetUp() override {
+        std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        snapshot_file = "test_cow_incr_" + test_name + ".snapshot";
+        cow_manager = new Manager(nullptr, snapshot_file, Manager::BackendType::TRADITIONAL);
+        cow_manager->set_snapshot_mode(Manager::SnapshotMode::INCREMENTAL);
+        cow_manager->set_operations_threshold(SIZE_MAX);  // Only explicit snapshots
+    }
+
+    void TearDown() override {
+        for (char* r : regions) {
+            cow_manager->get_memory_tracker().unregister_memory_region(r);
+            PageAlignedMemoryTracker::deallocate_aligned(r);
+        }
+        regions.clear();
+        delete cow_manager;
+
+        std::remove(snapshot_file.c_str());
+        for (uint64_t seq = 1; seq <= 16; seq++) {
+            std::remove(Manager::delta_file_name(snapshot_file, seq).c_str());
+        }
+    }
+
+    char* add_region(size_t pages, char fill) {
+        char* r = static_cast<char*>(cow_manager->allocate_and_register(pages * page_size));
+        std::memset(r, fill, pages * page_size);
+        regions.push_back(r);
+        return r;
+    }
+
+    void write_page(char* region, size_t page, char value) {
+        char* p = region + page * page_size;
+        std::memset(p, value, page_size);
+        cow_manager->record_operation_with_write(p);
+    }
+
+    // The base + delta chain on disk must reproduce live memory exactly
+    void expect_chain_matches_memory() {
+        auto images = Manager::load_snapshot_chain(snapshot_file);
+        ASSERT_EQ(images.size(), regions.size());
+        for (char* r : regions) {
+            auto it = std::find_if(images.begin(), images.end(), [&](const auto& img) {
+                return img.original_addr == reinterpret_cast<uint64_t>(r);
+            });
+            ASSERT_NE(it, images.end());
+            EXPECT_EQ(0, std::memcmp(it->data.data(), r, it->data.size()));
+        }
+    }
+};
+
+TEST_F(COWIncrementalSnapshotTest, FirstSnapshotIsFullBase) {
+    add_region(16, 'a');
+
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    auto stats = cow_manager->get_snapshot_io_stats();
+    EXPECT_EQ(stats.full_snapshots, 1u);
+    EXPECT_EQ(stats.delta_snapshots, 0u);
+    EXPECT_EQ(stats.last_bytes_written, 16 * page_size);
+    EXPECT_TRUE(cow_manager->validate_snapshot(snapshot_file));
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, DeltaContainsOnlyDirtyPages) {
+    char* r = add_region(64, 'a');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    write_page(r, 3, 'x');
+    write_page(r, 4, 'y');   // Adjacent to page 3 - shares an extent
+    write_page(r, 40, 'z');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    auto stats = cow_manager->get_snapshot_io_stats();
+    EXPECT_EQ(stats.delta_snapshots, 1u);
+    EXPECT_EQ(stats.last_dirty_pages, 3u);
+    EXPECT_EQ(stats.last_bytes_written, 3 * page_size);
+    EXPECT_EQ(stats.delta_chain_length, 1u);
+
+    std::string delta = Manager::delta_file_name(snapshot_file, 1);
+    EXPECT_TRUE(Manager::validate_delta(delta));
+    expect_chain_matches_memory();
+
+    // Nothing written since - next delta is empty
+    ASSERT_TRUE(cow_manager->snapshot_now());
+    EXPECT_EQ(cow_manager->get_snapshot_io_stats().last_bytes_written, 0u);
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, NewRegionsGoInWhole) {
+    add_region(8, 'a');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    add_region(4, 'b');  // Registered after the base, never written via tracker
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    EXPECT_EQ(cow_manager->get_snapshot_io_stats().last_bytes_written, 4 * page_size);
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, MergeFoldsChainIntoBase) {
+    char* r = add_region(32, 'a');
+    cow_manager->set_max_delta_chain(3);
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    write_page(r, 1, 'b');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+    write_page(r, 1, 'c');  // Later delta overwrites earlier one
+    write_page(r, 7, 'd');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+    EXPECT_EQ(cow_manager->get_delta_chain().size(), 2u);
+    expect_chain_matches_memory();
+
+    write_page(r, 31, 'e');
+    ASSERT_TRUE(cow_manager->snapshot_now());  // Third delta triggers the merge
+
+    auto stats = cow_manager->get_snapshot_io_stats();
+    EXPECT_EQ(stats.merges, 1u);
+    EXPECT_EQ(stats.full_snapshots, 1u);  // Patched in place, no rewrite
+    EXPECT_EQ(stats.delta_chain_length, 0u);
+    EXPECT_FALSE(std::ifstream(Manager::delta_file_name(snapshot_file, 1)).good());
+    EXPECT_TRUE(cow_manager->validate_snapshot(snapshot_file));
+    expect_chain_matches_memory();
+
+    // The chain restarts against the merged base
+    write_page(r, 2, 'f');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+    EXPECT_EQ(cow_manager->get_delta_chain().size(), 1u);
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, MergeRewritesBaseWhenRegionsWereAdded) {
+    add_region(8, 'a');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    add_region(8, 'b');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    EXPECT_EQ(cow_manager->merge_delta_chain(), 1u);
+
+    auto stats = cow_manager->get_snapshot_io_stats();
+    EXPECT_EQ(stats.full_snapshots, 2u);
+    EXPECT_EQ(stats.delta_chain_length, 0u);
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, StaleDeltasAreIgnoredByNewBase) {
+    char* r = add_region(8, 'a');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+    write_page(r, 0, 'b');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    // Switching modes forces a new base; the old chain must not be replayed
+    cow_manager->set_snapshot_mode(Manager::SnapshotMode::INCREMENTAL);
+    write_page(r, 0, 'c');
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    EXPECT_EQ(cow_manager->get_snapshot_io_stats().full_snapshots, 2u);
+    EXPECT_FALSE(std::ifstream(Manager::delta_file_name(snapshot_file, 1)).good());
+    expect_chain_matches_memory();
+}
+
+TEST_F(COWIncrementalSnapshotTest, DeltaRestoresInPlaceInsertsAcrossPages) {
+    // A leaf-like node laid over a page boundary: count and MBR on one page,
+    // the entry array running onto the next. Non-split inserts only touch it
+    // in place, and each insert reports the whole node range.
+    struct Node {
+        uint32_t count;
+        float mbr[4];
+        uint64_t entries[1024];
+    };
+    char* r = add_region(8, 0);
+    auto* node = reinterpret_cast<Node*>(r + 3 * page_size - 64);
+    std::memset(node, 0, sizeof(Node));
+    ASSERT_TRUE(cow_manager->snapshot_now());
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 200; i++) {
+            node->entries[node->count] = 0x1000 + node->count;
+            node->count++;
+            node->mbr[2] = std::max(node->mbr[2], static_cast<float>(node->count));
+            cow_manager->record_operation_with_write(node, sizeof(Node));
+        }
+        ASSERT_TRUE(cow_manager->snapshot_now());
+        EXPECT_GE(cow_manager->get_snapshot_io_stats().last_dirty_pages, 2u);
+        expect_chain_matches_memory();
+    }
+    EXPECT_EQ(cow_manager->get_delta_chain().size(), 3u);
+}
+
+TEST(XTreeWriteObserverTest, PlainInsertsReportRootBucket) {
+    std::vector<const char*> dims = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(
+        2, 32, &dims, nullptr, nullptr, "write_observer",
+        IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY);
+    std::vector<std::pair<const char*, const char*>> writes;
+    index->setWriteObserver([&](const void* ptr, size_t len) {
+        auto* p = static_cast<const char*>(ptr);
+        writes.emplace_back(p, p + len);
+    });
+    index->ensure_root_initialized<DataRecord>();
+    auto* root = index->root_bucket<DataRecord>();
+    const char* lo = reinterpret_cast<const char*>(root);
+    const char* hi = lo + sizeof(*root);
+
+    // Few enough records that the root leaf never splits
+    for (int i = 0; i < 5; i++) {
+        writes.clear();
+        DataRecord* dr = XAlloc<DataRecord>::allocate_record(index, 2, 32, "r" + std::to_string(i));
+        std::vector<double> pt = {double(i), double(i)};
+        dr->putPoint(&pt);
+        root->xt_insert(index->root_cache_node(), dr);
+        EXPECT_TRUE(std::any_of(writes.begin(), writes.end(), [&](const auto& w) {
+            return w.first <= lo && w.second >= hi;
+        })) << "insert " << i << " did not report the root bucket";
+        EXPECT_GE(writes.size(), 2u);  // Bucket plus its MBR and child array
+    }
+
+    delete index;
+    IndexDetails<DataRecord>::clearCache();
+}
+
+// An index-attached manager in INCREMENTAL mode installs the write observer
+// itself, so plain inserts land in the next delta without any caller-side
+// record_operation_with_write.
+TEST(XTreeWriteObserverTest, AttachedManagerTracksInsertsInDeltas) {
+    using Manager = DirectMemoryCOWManager<DataRecord>;
+    const std::string file = "test_cow_incr_attached.snapshot";
+    std::vector<const char*> dims = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(
+        2, 32, &dims, nullptr, nullptr, "write_observer_attached",
+        IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY);
+    auto insert = [&](int i) {
+        DataRecord* dr = XAlloc<DataRecord>::allocate_record(index, 2, 32, "r" + std::to_string(i));
+        std::vector<double> pt = {double(i), double(i)};
+        dr->putPoint(&pt);
+        index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+    };
+    {
+        Manager attached(index, file, Manager::BackendType::TRADITIONAL);
+        attached.set_operations_threshold(SIZE_MAX);
+        ASSERT_TRUE(attached.set_snapshot_mode(Manager::SnapshotMode::INCREMENTAL));
+        EXPECT_TRUE(index->hasWriteObserver());
+
+        index->ensure_root_initialized<DataRecord>();
+        auto* root = index->root_bucket<DataRecord>();
+        const char* root_bytes = reinterpret_cast<const char*>(root);
+        auto& tracker = attached.get_memory_tracker();
+        tracker.register_memory_region(root, sizeof(*root));
+        ASSERT_TRUE(attached.snapshot_now());
+
+        insert(0);  // Root is a leaf with room, so the insert rewrites it
+        ASSERT_TRUE(attached.snapshot_now());
+        EXPECT_GE(attached.get_snapshot_io_stats().last_dirty_pages, 1u);
+        EXPECT_EQ(attached.get_delta_chain().size(), 1u);
+
+        auto images = Manager::load_snapshot_chain(file);
+        ASSERT_EQ(images.size(), 1u);
+        const char* base = reinterpret_cast<const char*>(images[0].original_addr);
+        EXPECT_EQ(0, std::memcmp(images[0].data.data() + (root_bytes - base),
+                                 root_bytes, sizeof(*root)));
+        tracker.unregister_memory_region(const_cast<char*>(base));
+
+        // Leaving INCREMENTAL removes the observer
+        EXPECT_TRUE(attached.set_snapshot_mode(Manager::SnapshotMode::FULL));
+        EXPECT_FALSE(index->hasWriteObserver());
+        for (const auto& delta : attached.get_delta_chain()) std::remove(delta.c_str());
+    }
+    EXPECT_FALSE(index->hasWriteObserver());
+    std::remove(file.c_str());
+    delete index;
+    IndexDetails<DataRecord>::clearCache();
+}
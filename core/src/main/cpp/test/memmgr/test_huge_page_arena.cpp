@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Tests for the huge-page small-object arena behind the tree's nodes
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include "../../src/indexdetails.hpp"
+#include "../../src/memmgr/huge_page_arena.hpp"
+
+using namespace xtree;
+
+namespace {
+    constexpr uintptr_t chunkOf(const void* p) {
+        return reinterpret_cast<uintptr_t>(p) / HugePageArena::kChunkSize;
+    }
+}
+
+TEST(HugePageArenaTest, ServesEachSizeClassFromItsOwnChunk) {
+    HugePageArena arena(64ULL << 20);
+    EXPECT_EQ(arena.allocate(48), nullptr);   // off until a mode is set
+    arena.set_mode(HugePageArena::Mode::THP);
+
+    void* a = arena.allocate(48);
+    void* b = arena.allocate(40);             // same 48-byte class
+    void* c = arena.allocate(200);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(c));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % HugePageArena::kGranule, 0u);
+    EXPECT_EQ(static_cast<char*>(b) - static_cast<char*>(a), 48);
+    EXPECT_EQ(chunkOf(a), chunkOf(b));
+    EXPECT_NE(chunkOf(a), chunkOf(c));
+
+    const auto s = arena.stats();
+    EXPECT_EQ(s.chunks, 2u);
+    EXPECT_EQ(s.live_objects, 3u);
+    EXPECT_EQ(s.live_bytes, 48u + 48u + 208u);
+
+    int local = 0;
+    EXPECT_FALSE(arena.owns(&local));
+}
+
+TEST(HugePageArenaTest, ReusesFreedObjectsOfTheSameClass) {
+    HugePageArena arena(64ULL << 20);
+    arena.set_mode(HugePageArena::Mode::THP);
+
+    std::vector<void*> objs;
+    for (int i = 0; i < 1000; i++) {
+        objs.push_back(arena.allocate(64));
+        ASSERT_NE(objs.back(), nullptr);
+    }
+    arena.deallocate(objs[10]);
+    arena.deallocate(objs[500]);
+    EXPECT_EQ(arena.stats().live_objects, 998u);
+
+    std::set<void*> again = {arena.allocate(64), arena.allocate(64)};
+    EXPECT_EQ(again, (std::set<void*>{objs[10], objs[500]}));
+    EXPECT_EQ(arena.stats().chunks, 1u);
+}
+
+TEST(HugePageArenaTest, RefusesWhatItCannotServe) {
+    HugePageArena arena(2 * HugePageArena::kChunkSize);
+    arena.set_mode(HugePageArena::Mode::THP);
+
+    EXPECT_EQ(arena.allocate(HugePageArena::kMaxObjectSize + 1), nullptr);
+    void* a = arena.allocate(16);
+    void* b = arena.allocate(32);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(arena.allocate(64), nullptr);   // a third class needs a third chunk
+
+    // Switching off stops allocation, not frees
+    arena.set_mode(HugePageArena::Mode::Off);
+    EXPECT_EQ(arena.allocate(16), nullptr);
+    arena.deallocate(a);
+    arena.deallocate(b);
+    EXPECT_EQ(arena.stats().live_objects, 0u);
+}
+
+TEST(HugePageArenaTest, HugeTLBFallsBackToTransparentHugePages) {
+    HugePageArena arena(64ULL << 20);
+    arena.set_mode(HugePageArena::Mode::HugeTLB);
+
+    // Without a hugetlb pool the chunk is still committed, as a THP chunk
+    char* p = static_cast<char*>(arena.allocate(128));
+    ASSERT_NE(p, nullptr);
+    p[0] = 1;
+    p[127] = 2;
+    const auto s = arena.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    if (access("/sys/kernel/mm/transparent_hugepage/enabled", F_OK) == 0) {
+        EXPECT_EQ(s.hugetlb_chunks + s.thp_chunks, 1u);
+    }
+}
+
+TEST(HugePageArenaTest, ThreadsAllocateAndFreeAcrossShards) {
+    HugePageArena arena(256ULL << 20);
+    arena.set_mode(HugePageArena::Mode::THP);
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 20000;
+
+    // Each thread keeps half of what it allocates and hands the rest to
+    // the next thread to free, so frees cross shards
+    std::vector<std::vector<void*>> kept(kThreads), handed(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; i++) {
+                void* p = arena.allocate(i % 2 ? 48 : 200);
+                ASSERT_NE(p, nullptr);
+                std::memset(p, t, 48);
+                (i % 4 ? kept : handed)[t].push_back(p);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    threads.clear();
+
+    std::set<void*> all;
+    for (int t = 0; t < kThreads; t++) {
+        all.insert(kept[t].begin(), kept[t].end());
+        all.insert(handed[t].begin(), handed[t].end());
+    }
+    EXPECT_EQ(all.size(), size_t(kThreads) * kPerThread);
+    EXPECT_EQ(arena.stats().live_objects, size_t(kThreads) * kPerThread);
+
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (void* p : handed[(t + 1) % kThreads]) arena.deallocate(p);
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int t = 0; t < kThreads; t++) {
+        for (void* p : kept[t]) EXPECT_EQ(static_cast<char*>(p)[47], char(t));
+    }
+    EXPECT_EQ(arena.stats().live_objects, size_t(kThreads) * kPerThread * 3 / 4);
+}
+
+TEST(HugePageArenaTest, TreeNodesComeFromTheGlobalArena) {
+    auto& arena = HugePageArena::global();
+    const auto mode = arena.mode();
+    arena.set_mode(HugePageArena::Mode::THP);
+    const size_t before = arena.stats().live_objects;
+
+    std::vector<const char*> dimLabels = {"x", "y"};
+    auto* index = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "huge_arena",
+                                               IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY);
+    index->ensure_root_initialized<DataRecord>();
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<> pos(0, 100);
+    for (int i = 0; i < 3000; i++) {
+        auto* dr = new DataRecord(2, 32, "row_" + std::to_string(i));
+        std::vector<double> pt = {pos(gen), pos(gen)};
+        dr->putPoint(&pt);
+        index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+    }
+    EXPECT_GT(arena.stats().live_objects, before + 3000);
+
+    // Objects made while it was on are freed through it after it is off
+    arena.set_mode(HugePageArena::Mode::Off);
+    DataRecord query(2, 32, "q");
+    std::vector<double> lo = {0, 0}, hi = {100, 100};
+    query.putPoint(&lo);
+    query.putPoint(&hi);
+    auto* iter = index->root_bucket<DataRecord>()->getIterator(index->root_cache_node(), &query, INTERSECTS);
+    size_t n = 0;
+    std::string_view rid;
+    while (iter->nextRowID(rid)) n++;
+    delete iter;
+    EXPECT_EQ(n, 3000u);
+
+    delete index;
+    IndexDetails<DataRecord>::clearCache();
+    arena.set_mode(mode);
+}
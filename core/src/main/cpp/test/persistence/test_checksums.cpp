@@ -221,16 +221,88 @@ TEST_F(ChecksumsTest, ChecksumSelection) {
     // Test checksum selection logic
     using ChecksumType = checksum_utils::ChecksumType;
     
-    // Small data should use Adler32
-    EXPECT_EQ(checksum_utils::select_checksum(512), ChecksumType::Adler32);
-    EXPECT_EQ(checksum_utils::select_checksum(1023), ChecksumType::Adler32);
-    
-    // Medium and large data should use CRC32C (hardware accelerated)
+    // CRC32C at every size: as fast as Adler32 on small payloads, and far
+    // stronger there
+    EXPECT_EQ(checksum_utils::select_checksum(0), ChecksumType::CRC32C);
+    EXPECT_EQ(checksum_utils::select_checksum(512), ChecksumType::CRC32C);
+    EXPECT_EQ(checksum_utils::select_checksum(1023), ChecksumType::CRC32C);
     EXPECT_EQ(checksum_utils::select_checksum(1024), ChecksumType::CRC32C);
     EXPECT_EQ(checksum_utils::select_checksum(10 * 1024), ChecksumType::CRC32C);
     EXPECT_EQ(checksum_utils::select_checksum(10 * 1024 * 1024), ChecksumType::CRC32C);
 }
 
+TEST_F(ChecksumsTest, CRC32CCombine) {
+    std::vector<uint8_t> data(10000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>((i * 131) ^ (i >> 5));
+    }
+    const uint32_t whole = CRC32C::compute(data.data(), data.size());
+    
+    for (size_t split : {size_t(0), size_t(1), size_t(7), size_t(1000), size_t(4096), size_t(9999), data.size()}) {
+        uint32_t a = CRC32C::compute(data.data(), split);
+        uint32_t b = CRC32C::compute(data.data() + split, data.size() - split);
+        EXPECT_EQ(CRC32C::combine(a, b, data.size() - split), whole) << "split at " << split;
+    }
+}
+
+TEST_F(ChecksumsTest, CRC32CInterleavedMatchesSoftware) {
+    // Lengths around every ladder boundary (3 x {64, 256, 1024, 4096}) plus
+    // odd tails, at unaligned starts
+    std::vector<uint8_t> data(40000 + 16);
+    uint32_t x = 0x12345678u;
+    for (auto& b : data) {
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    
+    std::vector<size_t> lengths = {0, 1, 63, 1023, 1024, 1025, 3071, 3072, 3073, 12287, 12288,
+                                   12289, 12288 + 3072 + 768 + 192 + 7, 24576, 40000};
+    for (size_t len = 1000; len < 20000; len += 997) lengths.push_back(len);
+    
+    for (size_t offset : {0, 1, 3, 8}) {
+        for (size_t len : lengths) {
+            const uint8_t* p = data.data() + offset;
+            uint32_t expected = ~CRC32C::software_crc32c(~0u, p, len);
+            EXPECT_EQ(CRC32C::compute(p, len), expected) << "len " << len << " offset " << offset;
+            
+            // The incremental path must agree too, split at an odd point
+            CRC32C crc;
+            crc.update(p, len / 3);
+            crc.update(p + len / 3, len - len / 3);
+            EXPECT_EQ(crc.finalize(), expected) << "len " << len << " offset " << offset;
+#if defined(__x86_64__) || defined(_M_X64)
+            if (CRC32C::has_sse42()) {
+                EXPECT_EQ(~CRC32C::hardware_crc32c_serial(~0u, p, len), expected);
+            }
+#endif
+        }
+    }
+}
+
+TEST_F(ChecksumsTest, CRC32CCopyCompute) {
+    std::vector<uint8_t> src(3 * 4096 + 123);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    
+    for (size_t len : {size_t(0), size_t(17), size_t(4096), src.size()}) {
+        std::vector<uint8_t> dst(len + 1, 0xEE);
+        uint32_t crc = CRC32C::copy_compute(dst.data(), src.data(), len);
+        EXPECT_EQ(crc, CRC32C::compute(src.data(), len)) << "len " << len;
+        EXPECT_EQ(std::memcmp(dst.data(), src.data(), len), 0) << "len " << len;
+        EXPECT_EQ(dst[len], 0xEE) << "copy overran at len " << len;
+    }
+    
+    // update_copy continues a running CRC
+    std::vector<uint8_t> dst(src.size());
+    CRC32C crc;
+    crc.update(src.data(), 100);
+    std::memcpy(dst.data(), src.data(), 100);
+    crc.update_copy(dst.data() + 100, src.data() + 100, src.size() - 100);
+    EXPECT_EQ(crc.finalize(), CRC32C::compute(src.data(), src.size()));
+    EXPECT_EQ(dst, src);
+}
+
 TEST_F(ChecksumsTest, EmptyDataHandling) {
     // All checksums should handle empty data gracefully
     const uint8_t* empty = nullptr;
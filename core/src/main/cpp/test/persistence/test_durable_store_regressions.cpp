@@ -5,6 +5,8 @@
 #include "../../src/persistence/segment_allocator.h"
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <thread>
 
 namespace xtree::persist {
 
@@ -162,4 +164,211 @@ TEST_F(DurableStoreRegressionTest, MultipleOpenCloseWithVariousOps) {
     }
 }
 
-} // namespace xtree::persist
\ No newline at end of file
+// A reopened runtime must not hand out blocks of nodes that are still live
+TEST_F(DurableStoreRegressionTest, ReopenedRuntimeKeepsLiveNodes) {
+    auto open = [this](std::unique_ptr<DurableRuntime>& rt) {
+        rt = DurableRuntime::open(paths_, policy_);
+        return DurableContext{
+            .ot = rt->ot(),
+            .alloc = rt->allocator(),
+            .coord = rt->coordinator(),
+            .mvcc = rt->mvcc(),
+            .runtime = *rt
+        };
+    };
+    auto write = [](DurableStore& s, NodeID id, const std::string& text) {
+        std::array<char, 256> buf{};
+        memcpy(buf.data(), text.c_str(), text.size() + 1);
+        s.publish_node(id, buf.data(), buf.size());
+    };
+    auto read = [](DurableStore& s, NodeID id) {
+        auto bytes = s.read_node(id);
+        return bytes.data ? std::string(static_cast<const char*>(bytes.data)) : std::string{};
+    };
+
+    std::vector<NodeID> ids;
+    {
+        std::unique_ptr<DurableRuntime> rt;
+        auto ctx = open(rt);
+        DurableStore s(ctx, "primary");
+        for (int i = 0; i < 3; i++) {
+            auto a = s.allocate_node(256, NodeKind::Leaf);
+            write(s, a.id, "node" + std::to_string(i));
+            ids.push_back(a.id);
+        }
+        s.set_root(ids[0], 1, nullptr, 0, "");
+        s.commit(1);
+    }
+
+    {
+        std::unique_ptr<DurableRuntime> rt;
+        auto ctx = open(rt);
+        DurableStore s(ctx, "primary");
+        auto fresh = s.allocate_node(256, NodeKind::Leaf);
+        write(s, fresh.id, "fresh");
+        write(s, ids[1], "node1 v2");
+        ids.push_back(fresh.id);
+        s.commit(2);
+        EXPECT_EQ(read(s, ids[0]), "node0");
+    }
+
+    std::unique_ptr<DurableRuntime> rt;
+    auto ctx = open(rt);
+    DurableStore s(ctx, "primary");
+    EXPECT_EQ(read(s, ids[0]), "node0");
+    EXPECT_EQ(read(s, ids[1]), "node1 v2");
+    EXPECT_EQ(read(s, ids[2]), "node2");
+    EXPECT_EQ(read(s, ids[3]), "fresh");
+}
+
+// Nodes recovered from disk have no mapped address until first used.
+// Republishing one, by copy or in place, must write through a mapping.
+TEST_F(DurableStoreRegressionTest, RepublishesRecoveredNodes) {
+    auto open = [this](std::unique_ptr<DurableRuntime>& rt) {
+        rt = DurableRuntime::open(paths_, policy_);
+        return DurableContext{
+            .ot = rt->ot(),
+            .alloc = rt->allocator(),
+            .coord = rt->coordinator(),
+            .mvcc = rt->mvcc(),
+            .runtime = *rt
+        };
+    };
+    auto read = [](DurableStore& s, NodeID id) {
+        auto bytes = s.read_node(id);
+        return bytes.data ? std::string(static_cast<const char*>(bytes.data)) : std::string{};
+    };
+
+    NodeID copied, in_place;
+    {
+        std::unique_ptr<DurableRuntime> rt;
+        auto ctx = open(rt);
+        DurableStore s(ctx, "primary");
+        std::array<char, 256> buf{};
+        auto a = s.allocate_node(buf.size(), NodeKind::Leaf);
+        strcpy(buf.data(), "copied v1");
+        s.publish_node(a.id, buf.data(), buf.size());
+        auto b = s.allocate_node(buf.size(), NodeKind::Leaf);
+        strcpy(buf.data(), "in place v1");
+        s.publish_node(b.id, buf.data(), buf.size());
+        s.set_root(a.id, 1, nullptr, 0, "");
+        s.commit(1);
+        copied = a.id;
+        in_place = b.id;
+    }
+
+    {
+        std::unique_ptr<DurableRuntime> rt;
+        auto ctx = open(rt);
+        DurableStore s(ctx, "primary");
+        std::array<char, 256> buf{};
+        strcpy(buf.data(), "copied v2");
+        s.publish_node(copied, buf.data(), buf.size());
+
+        auto* mapped = static_cast<char*>(s.get_mapped_address(in_place));
+        ASSERT_NE(mapped, nullptr);
+        EXPECT_STREQ(mapped, "in place v1");
+        strcpy(mapped, "in place v2");
+        s.publish_node_in_place(in_place, buf.size());
+        s.commit(2);
+    }
+
+    std::unique_ptr<DurableRuntime> rt;
+    auto ctx = open(rt);
+    DurableStore s(ctx, "primary");
+    EXPECT_EQ(read(s, copied), "copied v2");
+    EXPECT_EQ(read(s, in_place), "in place v2");
+}
+
+// Stores written from one thread keep separate batches: committing one
+// must not publish the nodes the other has only staged
+TEST_F(DurableStoreRegressionTest, StoresOnOneThreadCommitSeparately) {
+    NodeID committed, staged_only;
+    {
+        auto rt = DurableRuntime::open(paths_, policy_);
+        DurableContext ctx{
+            .ot = rt->ot(),
+            .alloc = rt->allocator(),
+            .coord = rt->coordinator(),
+            .mvcc = rt->mvcc(),
+            .runtime = *rt
+        };
+        DurableStore first(ctx, "first");
+        DurableStore second(ctx, "second");
+
+        std::array<uint8_t, 256> buf{};
+        memcpy(buf.data(), "first", 6);
+        auto a = first.allocate_node(buf.size(), NodeKind::Leaf);
+        first.publish_node(a.id, buf.data(), buf.size());
+        memcpy(buf.data(), "second", 7);
+        auto b = second.allocate_node(buf.size(), NodeKind::Leaf);
+        second.publish_node(b.id, buf.data(), buf.size());
+        EXPECT_EQ(DurableStore::thread_batch_count(), 2u);
+
+        first.set_root(a.id, 1, nullptr, 0, "");
+        first.commit(1);
+        bool staged = false;
+        EXPECT_TRUE(second.is_node_present(b.id, &staged));
+        EXPECT_TRUE(staged) << "committing one store published another store's batch";
+        committed = a.id;
+        staged_only = b.id;
+    }
+
+    auto rt = DurableRuntime::open(paths_, policy_);
+    DurableContext ctx{
+        .ot = rt->ot(),
+        .alloc = rt->allocator(),
+        .coord = rt->coordinator(),
+        .mvcc = rt->mvcc(),
+        .runtime = *rt
+    };
+    DurableStore s(ctx, "first");
+    auto bytes = s.read_node(committed);
+    ASSERT_NE(bytes.data, nullptr);
+    EXPECT_STREQ(static_cast<const char*>(bytes.data), "first");
+    EXPECT_EQ(s.read_node(staged_only).data, nullptr);
+}
+
+// A store destroyed while another thread still holds a batch for it must
+// empty that batch, and the thread must let go of it
+TEST_F(DurableStoreRegressionTest, DestroyedStoreReleasesOtherThreadsBatches) {
+    auto rt = DurableRuntime::open(paths_, policy_);
+    DurableContext ctx{
+        .ot = rt->ot(),
+        .alloc = rt->allocator(),
+        .coord = rt->coordinator(),
+        .mvcc = rt->mvcc(),
+        .runtime = *rt
+    };
+    auto first = std::make_unique<DurableStore>(ctx, "first");
+    DurableStore second(ctx, "second");
+
+    std::promise<void> staged, destroyed;
+    std::future<void> destroyed_f = destroyed.get_future();
+    size_t before = 0, after = 0, reopened = 0;
+    std::thread writer([&] {
+        std::array<uint8_t, 256> buf{};
+        auto a = first->allocate_node(buf.size(), NodeKind::Leaf);
+        first->publish_node(a.id, buf.data(), buf.size());  // Left uncommitted
+        before = DurableStore::thread_batch_count();
+        staged.set_value();
+
+        destroyed_f.wait();
+        after = DurableStore::thread_batch_count();
+        auto b = second.allocate_node(buf.size(), NodeKind::Leaf);
+        second.publish_node(b.id, buf.data(), buf.size());
+        reopened = DurableStore::thread_batch_count();
+        second.commit(1);
+    });
+
+    staged.get_future().wait();
+    first.reset();
+    destroyed.set_value();
+    writer.join();
+
+    EXPECT_EQ(before, 1u);
+    EXPECT_EQ(after, 0u);
+    EXPECT_EQ(reopened, 1u);
+}
+
+} // namespace xtree::persist
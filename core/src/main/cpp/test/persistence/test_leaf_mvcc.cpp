@@ -0,0 +1,277 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "persistence/leaf_mvcc.h"
+
+using namespace xtree::persist;
+
+namespace {
+    const float kEverything[] = {-1e30f, 1e30f, -1e30f, 1e30f};
+
+    std::set<std::string> visibleIds(const MVCCLeaf& leaf, uint64_t snapshot,
+                                     const float* query = kEverything) {
+        std::set<std::string> ids;
+        leaf.scan(snapshot, query, [&](uint32_t slot) {
+            ids.insert(std::string(leaf.row_id(slot)));
+        });
+        return ids;
+    }
+}
+
+TEST(LeafMVCCTest, VersionsAreVisibleOnlyInsideTheirEpochRange) {
+    MVCCLeaf leaf(2);
+    const float a[] = {0, 1, 0, 1};
+    const float b[] = {5, 6, 5, 6};
+
+    leaf.insert("a", a, 10);
+    leaf.insert("b", b, 11);
+    EXPECT_TRUE(leaf.remove("a", 20));
+    EXPECT_FALSE(leaf.remove("a", 21));     // nothing live any more
+    EXPECT_FALSE(leaf.remove("zzz", 21));
+    leaf.update("b", a, 30);
+
+    EXPECT_EQ(visibleIds(leaf, 9), std::set<std::string>{});
+    EXPECT_EQ(visibleIds(leaf, 10), std::set<std::string>({"a"}));
+    EXPECT_EQ(visibleIds(leaf, 19), std::set<std::string>({"a", "b"}));
+    EXPECT_EQ(visibleIds(leaf, 20), std::set<std::string>({"b"}));
+    EXPECT_EQ(leaf.count_visible(40), 1u);
+
+    // The update moved b: old box before 30, new box from 30
+    EXPECT_EQ(visibleIds(leaf, 29, b), std::set<std::string>({"b"}));
+    EXPECT_EQ(visibleIds(leaf, 30, b), std::set<std::string>{});
+    EXPECT_EQ(visibleIds(leaf, 30, a), std::set<std::string>({"b"}));
+
+    // Delete leaves a tombstone, update a plain retired version
+    const RecordHeader deleted = leaf.header(static_cast<uint32_t>(leaf.find("a", 15)));
+    EXPECT_EQ(deleted.birth_epoch, 10u);
+    EXPECT_EQ(deleted.retire_epoch, 20u);
+    EXPECT_TRUE(deleted.flags & kRecordTombstone);
+    const RecordHeader superseded = leaf.header(static_cast<uint32_t>(leaf.find("b", 15)));
+    EXPECT_EQ(superseded.retire_epoch, 30u);
+    EXPECT_FALSE(superseded.flags & kRecordTombstone);
+    EXPECT_EQ(leaf.header(static_cast<uint32_t>(leaf.find("b", 30))).retire_epoch, kLiveEpoch);
+
+    EXPECT_EQ(leaf.size(), 3u);
+    EXPECT_EQ(leaf.live_count(), 1u);
+}
+
+TEST(LeafMVCCTest, CompactKeepsVersionsPinnedReadersCanSee) {
+    MVCCLeaf leaf(1);
+    const float box[] = {0, 1};
+    for (int i = 0; i < 10; i++) {
+        leaf.insert("r" + std::to_string(i), box, 1);
+    }
+    for (int i = 0; i < 6; i++) {
+        leaf.remove("r" + std::to_string(i), 5 + i);  // retired at 5..10
+    }
+    const auto at7 = visibleIds(leaf, 7);
+
+    EXPECT_DOUBLE_EQ(leaf.dead_ratio(7), 0.3);       // retired at 5, 6, 7
+    EXPECT_TRUE(leaf.should_compact(7));
+    EXPECT_FALSE(leaf.should_compact(6));
+
+    // A reader pinned at 7 still needs the versions retired at 8..10
+    EXPECT_EQ(leaf.compact(7), 3u);
+    EXPECT_EQ(leaf.size(), 7u);
+    EXPECT_EQ(visibleIds(leaf, 7), at7);
+    EXPECT_EQ(visibleIds(leaf, 100).size(), 4u);
+    EXPECT_TRUE(leaf.should_rewrite());
+    EXPECT_EQ(leaf.compact(7), 0u);
+
+    // Slots were renumbered, but removes still find their record
+    EXPECT_TRUE(leaf.remove("r9", 50));
+    EXPECT_EQ(visibleIds(leaf, 50).size(), 3u);
+}
+
+TEST(LeafMVCCTest, ImagePlusJournalRoundTrip) {
+    MVCCLeaf leaf(2);
+    const float a[] = {0, 1, 2, 3};
+    const float b[] = {4, 5, 6, 7};
+    for (int i = 0; i < 100; i++) {
+        leaf.insert("row_" + std::to_string(i), (i % 2) ? a : b, 1);
+    }
+
+    std::vector<uint8_t> disk(leaf.wire_size());
+    EXPECT_EQ(leaf.to_wire(disk.data()), disk.data() + disk.size());
+    EXPECT_FALSE(leaf.should_rewrite());
+
+    // Point updates only append journal entries
+    leaf.remove("row_3", 2);
+    leaf.update("row_4", a, 3);
+    leaf.insert("row_new", b, 4);
+    auto journal = leaf.take_journal();
+    EXPECT_LT(journal.size(), 200u);
+    EXPECT_TRUE(leaf.take_journal().empty());
+    disk.insert(disk.end(), journal.begin(), journal.end());
+
+    size_t consumed = 0;
+    MVCCLeaf loaded = MVCCLeaf::from_wire(disk.data(), disk.size(), &consumed);
+    EXPECT_EQ(loaded.replay(disk.data() + consumed, disk.size() - consumed), 3u);
+    for (uint64_t e : {1, 2, 3, 4}) {
+        EXPECT_EQ(visibleIds(loaded, e), visibleIds(leaf, e)) << "epoch " << e;
+        EXPECT_EQ(visibleIds(loaded, e, a), visibleIds(leaf, e, a)) << "epoch " << e;
+    }
+
+    // A torn append: the last entry is cut short and ignored
+    leaf.remove("row_5", 5);
+    journal = leaf.take_journal();
+    disk.insert(disk.end(), journal.begin(), journal.end() - 3);
+    MVCCLeaf torn = MVCCLeaf::from_wire(disk.data(), disk.size(), &consumed);
+    EXPECT_EQ(torn.replay(disk.data() + consumed, disk.size() - consumed), 3u);
+    EXPECT_TRUE(visibleIds(torn, 5).count("row_5"));
+}
+
+TEST(LeafMVCCTest, RowIdAtJournalLimitRoundTrips) {
+    MVCCLeaf leaf(2);
+    const float box[] = {0, 1, 2, 3};
+    const size_t limit = leaf.max_row_id_length();
+    EXPECT_EQ(limit, 65535u - 11u - 16u);
+
+    std::vector<uint8_t> disk(leaf.wire_size());
+    leaf.to_wire(disk.data());
+
+    const std::string longest(limit, 'a');
+    const std::string too_long(limit + 1, 'b');
+    leaf.insert(longest, box, 1);
+    EXPECT_THROW(leaf.insert(too_long, box, 1), std::runtime_error);
+    leaf.update(longest, box, 2);
+    leaf.insert(std::string(limit, 'c'), box, 2);
+    EXPECT_THROW(leaf.update(too_long, box, 3), std::runtime_error);
+    EXPECT_EQ(leaf.live_count(), 2u);
+    leaf.remove(longest, 3);
+
+    auto journal = leaf.take_journal();
+    disk.insert(disk.end(), journal.begin(), journal.end());
+    size_t consumed = 0;
+    MVCCLeaf loaded = MVCCLeaf::from_wire(disk.data(), disk.size(), &consumed);
+    EXPECT_EQ(loaded.replay(disk.data() + consumed, disk.size() - consumed), 4u);
+    for (uint64_t e : {1, 2, 3}) {
+        EXPECT_EQ(visibleIds(loaded, e), visibleIds(leaf, e)) << "epoch " << e;
+    }
+}
+
+TEST(LeafMVCCTest, CorruptImageIsRejected) {
+    MVCCLeaf leaf(3);
+    const float box[] = {0, 1, 0, 1, 0, 1};
+    leaf.insert("x", box, 1);
+    std::vector<uint8_t> disk(leaf.wire_size());
+    leaf.to_wire(disk.data());
+
+    auto flipped = disk;
+    flipped[disk.size() / 2] ^= 0x40;
+    EXPECT_THROW(MVCCLeaf::from_wire(flipped.data(), flipped.size()), std::runtime_error);
+    EXPECT_THROW(MVCCLeaf::from_wire(disk.data(), disk.size() - 1), std::runtime_error);
+    EXPECT_THROW(MVCCLeaf::from_wire(disk.data() + 1, disk.size() - 1), std::runtime_error);
+    EXPECT_NO_THROW(MVCCLeaf::from_wire(disk.data(), disk.size()));
+}
+
+// Random inserts, updates and deletes against a per-epoch reference model,
+// with compaction and persist/reload cycles mixed in
+TEST(LeafMVCCTest, FuzzAgainstReferenceModel) {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<int> keyDist(0, 80);
+    std::uniform_real_distribution<float> pos(0, 100);
+
+    MVCCLeaf leaf(2);
+    using Box = std::vector<float>;
+    std::map<std::string, Box> current;
+    std::map<uint64_t, std::map<std::string, Box>> history;  // state as of each epoch
+
+    std::vector<uint8_t> disk;
+    uint64_t minActive = 0;
+
+    for (uint64_t epoch = 1; epoch <= 400; epoch++) {
+        const int ops = 1 + static_cast<int>(gen() % 6);
+        for (int i = 0; i < ops; i++) {
+            const std::string key = "k" + std::to_string(keyDist(gen));
+            const float x = pos(gen), y = pos(gen);
+            Box box = {x, x + 3, y, y + 3};
+            const bool exists = current.count(key) > 0;
+            switch (gen() % 3) {
+                case 0:
+                    if (!exists) {
+                        leaf.insert(key, box.data(), epoch);
+                        current[key] = box;
+                    }
+                    break;
+                case 1:
+                    leaf.update(key, box.data(), epoch);
+                    current[key] = box;
+                    break;
+                default:
+                    EXPECT_EQ(leaf.remove(key, epoch), exists);
+                    current.erase(key);
+                    break;
+            }
+        }
+        history[epoch] = current;
+
+        // Readers pin some trailing window of epochs
+        if (epoch % 25 == 0) {
+            minActive = epoch - gen() % 20;
+            leaf.compact(minActive);
+            history.erase(history.begin(), history.lower_bound(minActive));
+        }
+
+        // Persist: full image when asked, else append the journal
+        if (epoch % 7 == 0) {
+            if (disk.empty() || leaf.should_rewrite()) {
+                disk.assign(leaf.wire_size(), 0);
+                leaf.to_wire(disk.data());
+            } else {
+                auto journal = leaf.take_journal();
+                disk.insert(disk.end(), journal.begin(), journal.end());
+            }
+        }
+        // Reload and compare as of the last persist, which must not have
+        // been compacted away in memory since
+        const uint64_t persisted = epoch - epoch % 7;
+        if (epoch % 50 == 21 && persisted >= minActive) {
+            size_t consumed = 0;
+            MVCCLeaf loaded = MVCCLeaf::from_wire(disk.data(), disk.size(), &consumed);
+            loaded.replay(disk.data() + consumed, disk.size() - consumed);
+            ASSERT_EQ(visibleIds(loaded, persisted), visibleIds(leaf, persisted)) << "epoch " << epoch;
+        }
+
+        // Every retained epoch answers exactly as the model did at the time
+        for (const auto& [e, state] : history) {
+            if (e + 40 < epoch && e % 9 != 0) continue;  // sample older epochs
+            std::set<std::string> expected;
+            for (const auto& kv : state) expected.insert(kv.first);
+            ASSERT_EQ(visibleIds(leaf, e), expected) << "epoch " << e << " at " << epoch;
+
+            const float query[] = {20, 60, 20, 60};
+            std::set<std::string> inQuery;
+            for (const auto& [k, b] : state) {
+                if (b[0] <= query[1] && b[1] >= query[0] && b[2] <= query[3] && b[3] >= query[2]) {
+                    inQuery.insert(k);
+                }
+            }
+            ASSERT_EQ(visibleIds(leaf, e, query), inQuery) << "epoch " << e << " at " << epoch;
+        }
+    }
+    EXPECT_EQ(leaf.live_count(), current.size());
+}
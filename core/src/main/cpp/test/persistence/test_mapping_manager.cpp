@@ -328,6 +328,40 @@ TEST_F(MappingManagerTest, Prefetch) {
 }
 
 // Stress test
+TEST_F(MappingManagerTest, HugePageWindows) {
+    constexpr size_t kHuge = 2 * 1024 * 1024;
+    MappingManager huge(*fhr, 2 * kHuge, 32);
+    huge.set_huge_pages(true);
+    std::string file = get_test_file(7);
+
+    // The window starts at file offset 0, so its base must be 2MB aligned
+    {
+        auto pin = huge.pin(file, kHuge + 4096, 4096, true);
+        ASSERT_TRUE(pin);
+        const auto base = reinterpret_cast<uintptr_t>(pin.get()) - (kHuge + 4096);
+        EXPECT_EQ(base % kHuge, 0u);
+        std::memset(pin.get(), 0x5A, 4096);
+    }
+#ifdef __linux__
+    if (access("/sys/kernel/mm/transparent_hugepage/enabled", F_OK) == 0) {
+        EXPECT_EQ(huge.getStats().huge_extents, 1u);
+        EXPECT_EQ(huge.getStats().huge_bytes, 2 * kHuge);
+    }
+#endif
+
+    // Released huge pins keep their pages; the data reads back either way
+    auto pin = huge.pin(file, kHuge + 4096, 4096, false);
+    ASSERT_TRUE(pin);
+    EXPECT_EQ(pin.get()[0], 0x5A);
+    EXPECT_EQ(pin.get()[4095], 0x5A);
+
+    // Off again: new windows are plain mappings
+    huge.set_huge_pages(false);
+    auto plain = huge.pin(get_test_file(8), 0, 4096, true);
+    ASSERT_TRUE(plain);
+    EXPECT_EQ(huge.getStats().huge_extents, 1u);
+}
+
 TEST_F(MappingManagerTest, StressTest) {
     std::atomic<bool> stop{false};
     std::atomic<int> operations{0};
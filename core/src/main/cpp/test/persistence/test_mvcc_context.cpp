@@ -189,6 +189,40 @@ TEST_F(MVCCContextTest, ConcurrentPinning) {
     EXPECT_EQ(mvcc.min_active_epoch(), 0u);
 }
 
+TEST_F(MVCCContextTest, ScanWhileThreadsRegister) {
+    // A long-lived reader holds the minimum
+    auto* pin = mvcc.register_thread();
+    MVCCContext::pin_epoch(pin, 5);
+    
+    // Scans run without the registration lock while new threads register
+    std::atomic<bool> stop{false};
+    std::atomic<int> bad_scans{0};
+    std::thread scanner([&]() {
+        while (!stop.load()) {
+            if (mvcc.min_active_epoch() != 5u) bad_scans++;
+        }
+    });
+    
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 64; i++) {
+        threads.emplace_back([&, i]() {
+            auto* p = mvcc.register_thread();
+            ASSERT_NE(p, nullptr);
+            MVCCContext::pin_epoch(p, 10 + i);
+            MVCCContext::unpin(p);
+            mvcc.deregister_thread();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    stop = true;
+    scanner.join();
+    
+    EXPECT_EQ(bad_scans.load(), 0);
+    MVCCContext::unpin(pin);
+}
+
 TEST_F(MVCCContextTest, SlowReaderScenario) {
     // Simulate a slow reader with one thread and fast readers with another
     std::thread slow_thread([&]() {
@@ -305,6 +339,46 @@ TEST_F(MVCCContextTest, ManyReaderStress) {
     EXPECT_EQ(mvcc.min_active_epoch(), 0u);
 }
 
+TEST_F(MVCCContextTest, PinCurrentIsNeverReclaimedPast) {
+    // A reclaimer advances the epoch and publishes each min_active_epoch()
+    // as the point below which it frees. A reader pinned by pin_current()
+    // must never find that point above its own epoch.
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> freed_below{0};
+    std::atomic<int> violations{0};
+
+    std::thread reclaimer([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            mvcc.advance_epoch();
+            const uint64_t m = mvcc.min_active_epoch();
+            uint64_t prev = freed_below.load();
+            while (m > prev && !freed_below.compare_exchange_weak(prev, m)) {
+            }
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&]() {
+            auto* pin = mvcc.register_thread();
+            ASSERT_NE(pin, nullptr);
+            for (int n = 0; n < 100000; n++) {
+                const uint64_t e = mvcc.pin_current(pin);
+                if (freed_below.load() > e) violations++;
+                MVCCContext::unpin(pin);
+            }
+            mvcc.deregister_thread();
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+    stop = true;
+    reclaimer.join();
+
+    EXPECT_EQ(violations.load(), 0);
+}
+
 TEST_F(MVCCContextTest, PinReuse) {
     // Test that the same pin can be reused many times
     auto* pin = mvcc.register_thread();
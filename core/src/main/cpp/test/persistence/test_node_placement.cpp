@@ -0,0 +1,171 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "persistence/segment_allocator.h"
+#include "persistence/durable_runtime.h"
+#include "persistence/durable_store.h"
+
+using namespace xtree::persist;
+
+class NodePlacementTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = "/tmp/xtree_node_placement_" + std::to_string(getpid());
+        std::filesystem::remove_all(test_dir_);
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // No thread magazines, so blocks go straight back to the bitmaps
+    std::unique_ptr<SegmentAllocator> makeAllocator(bool hints) {
+        StorageConfig cfg = StorageConfig::defaults();
+        cfg.thread_cache_bytes = 0;
+        cfg.placement_hints = hints;
+        return std::make_unique<SegmentAllocator>(test_dir_, cfg);
+    }
+
+    // Block index of an allocation within its segment
+    static uint64_t blockOf(const SegmentAllocator::Allocation& a,
+                            const SegmentAllocator::Allocation& first) {
+        return (a.offset - first.offset) / a.length;
+    }
+
+    std::string test_dir_;
+};
+
+TEST_F(NodePlacementTest, TakesTheNearestFreeBlockInTheHintedSegment) {
+    auto alloc = makeAllocator(true);
+    std::vector<SegmentAllocator::Allocation> blocks;
+    for (int i = 0; i < 100; i++) {
+        blocks.push_back(alloc->allocate(256, NodeKind::Leaf));
+    }
+    ASSERT_EQ(blocks.back().segment_id, blocks.front().segment_id);
+    for (int i : {10, 50, 90}) {
+        alloc->free(blocks[i]);
+    }
+
+    auto a = alloc->allocate(256, NodeKind::Leaf, blocks[52]);
+    EXPECT_EQ(blockOf(a, blocks[0]), 50u);
+    auto b = alloc->allocate(256, NodeKind::Leaf, blocks[88]);
+    EXPECT_EQ(blockOf(b, blocks[0]), 90u);
+    auto c = alloc->allocate(256, NodeKind::Leaf, blocks[0]);
+    EXPECT_EQ(blockOf(c, blocks[0]), 10u);
+
+    // No holes left: the first fresh block after the high-water mark
+    auto d = alloc->allocate(256, NodeKind::Leaf, blocks[99]);
+    EXPECT_EQ(d.segment_id, blocks[0].segment_id);
+    EXPECT_EQ(blockOf(d, blocks[0]), 100u);
+
+    EXPECT_EQ(alloc->get_stats(a.class_id).allocs_placed, 4u);
+}
+
+TEST_F(NodePlacementTest, StartsANewRunWhenTheHintedRunIsFull) {
+    auto alloc = makeAllocator(true);
+    std::vector<SegmentAllocator::Allocation> blocks;
+    for (int i = 0; i < 200; i++) {
+        blocks.push_back(alloc->allocate(256, NodeKind::Leaf));
+    }
+
+    // Runs are 64 blocks: 0..191 are full and 192..255 is in use, so the
+    // first entirely free run starts at 256, leaving 200..255 to its owner
+    auto a = alloc->allocate(256, NodeKind::Leaf, blocks[10]);
+    EXPECT_EQ(blockOf(a, blocks[0]), 256u);
+    auto b = alloc->allocate(256, NodeKind::Leaf, a);
+    EXPECT_EQ(blockOf(b, blocks[0]), 257u);
+    auto c = alloc->allocate(256, NodeKind::Leaf, blocks[199]);
+    EXPECT_EQ(blockOf(c, blocks[0]), 200u);
+
+    // Without a hint: the lowest free block
+    auto d = alloc->allocate(256, NodeKind::Leaf);
+    EXPECT_EQ(blockOf(d, blocks[0]), 201u);
+}
+
+TEST_F(NodePlacementTest, IgnoresHintsThatCannotBeHonored) {
+    auto alloc = makeAllocator(true);
+    std::vector<SegmentAllocator::Allocation> blocks;
+    for (int i = 0; i < 20; i++) {
+        blocks.push_back(alloc->allocate(256, NodeKind::Leaf));
+    }
+    alloc->free(blocks[5]);
+
+    // Another size class, another file type, or no hint at all
+    auto big = alloc->allocate(4096, NodeKind::Leaf, blocks[6]);
+    EXPECT_NE(big.class_id, blocks[6].class_id);
+    auto record = alloc->allocate(256, NodeKind::DataRecord, blocks[6]);
+    EXPECT_TRUE(record.is_valid());
+    auto plain = alloc->allocate(256, NodeKind::Leaf, SegmentAllocator::Allocation{});
+    EXPECT_TRUE(plain.is_valid());
+    EXPECT_EQ(alloc->get_total_stats().allocs_placed, 0u);
+}
+
+TEST_F(NodePlacementTest, DisabledByConfig) {
+    auto alloc = makeAllocator(false);
+    std::vector<SegmentAllocator::Allocation> blocks;
+    for (int i = 0; i < 60; i++) {
+        blocks.push_back(alloc->allocate(256, NodeKind::Leaf));
+    }
+    alloc->free(blocks[10]);
+    alloc->free(blocks[50]);
+
+    // Lowest free block, as without a hint
+    auto a = alloc->allocate(256, NodeKind::Leaf, blocks[51]);
+    EXPECT_EQ(blockOf(a, blocks[0]), 10u);
+    EXPECT_EQ(alloc->get_stats(a.class_id).allocs_placed, 0u);
+}
+
+TEST_F(NodePlacementTest, DurableStoreResolvesTheHintedNode) {
+    Paths paths{
+        .data_dir = test_dir_,
+        .manifest = test_dir_ + "/manifest.json",
+        .superblock = test_dir_ + "/superblock.bin",
+        .active_log = test_dir_ + "/ot_delta.wal"
+    };
+    auto runtime = DurableRuntime::open(paths, CheckpointPolicy{});
+    ASSERT_NE(runtime, nullptr);
+    DurableContext ctx{
+        .ot = runtime->ot(),
+        .alloc = runtime->allocator(),
+        .coord = runtime->coordinator(),
+        .mvcc = runtime->mvcc(),
+        .runtime = *runtime
+    };
+    DurableStore store(ctx, "placement");
+
+    auto parent = store.allocate_node(1024, NodeKind::Internal);
+    const size_t before = runtime->allocator().get_total_stats().allocs_placed;
+
+    auto child = store.allocate_node(1024, NodeKind::Internal, PlacementHint{parent.id});
+    EXPECT_EQ(runtime->allocator().get_total_stats().allocs_placed, before + 1);
+    const auto gap = static_cast<const uint8_t*>(child.writable) -
+                     static_cast<const uint8_t*>(parent.writable);
+    EXPECT_LT(static_cast<size_t>(gap < 0 ? -gap : gap), SegmentAllocator::DEFAULT_SEGMENT_SIZE);
+
+    // A handle that was never allocated is not a hint
+    store.allocate_node(1024, NodeKind::Internal, PlacementHint{NodeID::from_parts(123456, 1)});
+    EXPECT_EQ(runtime->allocator().get_total_stats().allocs_placed, before + 1);
+}
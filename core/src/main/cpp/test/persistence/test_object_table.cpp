@@ -221,6 +221,60 @@ TEST_F(ObjectTableTest, EpochReclamation) {
     EXPECT_FALSE(ot->is_valid(ids[4]));  // Retired at 45 (not reclaimed but still invalid)
 }
 
+TEST_F(ObjectTableTest, ReclaimOnlyDetachesOlderEpochBuckets) {
+    OTAddr addr{};
+    addr.length = 4096;
+    
+    // 100 handles retired at each of epochs 10, 20, 30
+    std::vector<NodeID> ids;
+    for (int i = 0; i < 300; i++) {
+        NodeID id = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+        NodeID live = ot->mark_live_reserve(id, 1);
+        ot->mark_live_commit(live, 1);
+        ot->retire(live, 10 * (i / 100 + 1));
+        ids.push_back(live);
+    }
+    EXPECT_EQ(ot->retired_backlog(), 300u);
+    
+    // Boundary epochs are exclusive
+    EXPECT_EQ(ot->reclaim_before_epoch(10), 0u);
+    EXPECT_EQ(ot->reclaim_before_epoch(11), 100u);
+    EXPECT_EQ(ot->retired_backlog(), 200u);
+    EXPECT_EQ(ot->get_stats().retired_handles_count, 200u);
+    
+    // Repeating a pass finds nothing new
+    EXPECT_EQ(ot->reclaim_before_epoch(11), 0u);
+    EXPECT_EQ(ot->reclaim_before_epoch(31), 200u);
+    EXPECT_EQ(ot->retired_backlog(), 0u);
+}
+
+TEST_F(ObjectTableTest, ConcurrentReclaimFreesEachHandleOnce) {
+    OTAddr addr{};
+    addr.length = 4096;
+    const int n = 2000;
+    for (int i = 0; i < n; i++) {
+        NodeID id = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+        NodeID live = ot->mark_live_reserve(id, 1);
+        ot->mark_live_commit(live, 1);
+        ot->retire(live, 2 + i % 8);
+    }
+    
+    // Passes racing on the same table never free a handle twice
+    std::atomic<size_t> total{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            total += ot->reclaim_before_epoch(4 + t * 2);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    total += ot->reclaim_before_epoch(100);
+    EXPECT_EQ(total.load(), size_t(n));
+    EXPECT_EQ(ot->retired_backlog(), 0u);
+}
+
 TEST_F(ObjectTableTest, GetMutAccess) {
     OTAddr addr{};
     addr.length = 4096;
@@ -292,6 +346,100 @@ TEST_F(ObjectTableTest, ConcurrentAllocations) {
     EXPECT_EQ(all_handles.size(), num_threads * allocs_per_thread);
 }
 
+TEST_F(ObjectTableTest, ConcurrentAllocateRetireStatsExact) {
+    const int num_threads = 8;
+    const int rounds = 200;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<NodeID>> live_ids(num_threads);
+    
+    // Each thread allocates two handles per round and retires one of them,
+    // all through the per-thread handle caches
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < rounds; i++) {
+                OTAddr addr{};
+                addr.length = 4096;
+                NodeID keep = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+                NodeID drop = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+                NodeID kept = ot->mark_live_reserve(keep, 1);
+                ot->mark_live_commit(kept, 1);
+                NodeID dropped = ot->mark_live_reserve(drop, 1);
+                ot->mark_live_commit(dropped, 1);
+                ot->retire(dropped, 2);
+                live_ids[t].push_back(kept);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    // Live handles are unique across threads
+    std::set<uint64_t> handles;
+    for (const auto& ids : live_ids) {
+        for (const auto& id : ids) {
+            EXPECT_TRUE(ot->is_valid(id));
+            EXPECT_TRUE(handles.insert(id.handle_index()).second)
+                << "Duplicate handle: " << id.handle_index();
+        }
+    }
+    
+    // Counters kept per thread add up exactly
+    auto stats = ot->get_stats();
+    EXPECT_EQ(stats.total_allocations, size_t(2 * num_threads * rounds));
+    EXPECT_EQ(stats.total_retires, size_t(num_threads * rounds));
+    EXPECT_EQ(stats.retired_handles_count, size_t(num_threads * rounds));
+    
+    // Every retired handle reaches the reclaimer
+    EXPECT_EQ(ot->reclaim_before_epoch(3), size_t(num_threads * rounds));
+    EXPECT_EQ(ot->get_stats().retired_handles_count, 0u);
+}
+
+TEST_F(ObjectTableTest, FlushHandleCacheReturnsHandles) {
+    OTAddr addr{};
+    addr.length = 4096;
+    NodeID first = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+    ASSERT_TRUE(first.valid());
+    
+    // The rest of the refill batch is parked in this thread's cache but
+    // still counts as free
+    const size_t free_before = ot->get_stats().free_handles_count;
+    ot->flush_handle_cache();
+    EXPECT_EQ(ot->get_stats().free_handles_count, free_before);
+    
+    // Flushed handles are handed out again, once each
+    std::set<uint64_t> handles{first.handle_index()};
+    for (int i = 0; i < 100; i++) {
+        NodeID id = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+        ASSERT_TRUE(id.valid());
+        EXPECT_TRUE(handles.insert(id.handle_index()).second)
+            << "Duplicate handle: " << id.handle_index();
+    }
+    EXPECT_EQ(ot->get_stats().free_handles_count, free_before - 100);
+}
+
+TEST_F(ObjectTableTest, ReclaimedHandleReusedAcrossThreads) {
+    OTAddr addr{};
+    addr.length = 4096;
+    
+    // Prime this thread's cache, then retire a handle
+    NodeID id = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+    NodeID live = ot->mark_live_reserve(id, 1);
+    ot->mark_live_commit(live, 1);
+    ot->retire(live, 2);
+    
+    // Reclaim from another thread, as the background reclaimer does
+    std::thread reclaimer([&]() {
+        EXPECT_EQ(ot->reclaim_before_epoch(3), 1u);
+    });
+    reclaimer.join();
+    
+    // The reclaimed handle is reused ahead of the cached batch
+    NodeID reused = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+    EXPECT_EQ(reused.handle_index(), live.handle_index());
+    EXPECT_NE(reused.tag(), live.tag());
+}
+
 // Edge case tests for recovery mode
 TEST_F(ObjectTableTest, RecoveryWithPartialLastWord) {
     // Test recovery with handles near capacity upper bound (last word partially used)
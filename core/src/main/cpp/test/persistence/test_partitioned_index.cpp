@@ -0,0 +1,242 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Time-partitioned indexes: routing, pruning, retention and merging
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/persistence/partitioned_index.h"
+#include "../../src/indexdetails.hpp"
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include <filesystem>
+#include <set>
+#include <unistd.h>
+
+namespace xtree {
+namespace persist {
+
+class PartitionedIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base_dir_ = "/tmp/partitioned_index_test_" + std::to_string(getpid());
+        std::filesystem::remove_all(base_dir_);
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+
+        options_.name = "metrics";
+        options_.base_dir = base_dir_;
+        options_.dimension = 2;
+        options_.dimension_labels = {"time", "value"};
+        options_.time_dimension = 0;
+        options_.bucket_width = 100.0;
+    }
+
+    void TearDown() override {
+        IndexRegistry::global().reset();
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(base_dir_);
+    }
+
+    // perBucket points at t = bucket*100 + 0.5 .. in each of the buckets
+    static void fill(PartitionedIndex& index, int firstBucket, int buckets, int perBucket) {
+        for (int b = firstBucket; b < firstBucket + buckets; b++) {
+            for (int i = 0; i < perBucket; i++) {
+                auto* dr = new DataRecord(2, 32, "r" + std::to_string(b) + "_" + std::to_string(i));
+                std::vector<double> pt = {b * 100.0 + 0.5 + i * (99.0 / perBucket), static_cast<double>(i % 50)};
+                dr->putPoint(&pt);
+                index.insert(dr);
+            }
+        }
+        index.commit();
+    }
+
+    static size_t window(PartitionedIndex& index, double t0, double t1,
+                         PartitionQueryStats* stats = nullptr, std::set<std::string>* rows = nullptr) {
+        DataRecord query(2, 32, "q");
+        std::vector<double> lo = {t0, -1000}, hi = {t1, 1000};
+        query.putPoint(&lo);
+        query.putPoint(&hi);
+        return index.query(&query, INTERSECTS, [&](std::string_view rid) {
+            if (rows) rows->insert(std::string(rid));
+        }, stats);
+    }
+
+    std::string base_dir_;
+    PartitionOptions options_;
+};
+
+TEST_F(PartitionedIndexTest, RoutesInsertsAndPrunesByTime) {
+    PartitionedIndex index(options_);
+    fill(index, 0, 10, 200);
+
+    auto parts = index.partitions();
+    ASSERT_EQ(parts.size(), 10u);
+    EXPECT_EQ(parts[3].field_name, "metrics.p3+1");
+    EXPECT_DOUBLE_EQ(parts[3].time_begin, 300.0);
+    EXPECT_DOUBLE_EQ(parts[3].time_end, 400.0);
+    EXPECT_TRUE(std::filesystem::is_directory(base_dir_ + "/metrics.p3+1"));
+    EXPECT_EQ(index.record_count("metrics.p3+1"), 200u);
+
+    PartitionQueryStats stats;
+    std::set<std::string> rows;
+    EXPECT_EQ(window(index, 300.0, 499.5, &stats, &rows), 400u);
+    EXPECT_EQ(stats.partitions_total, 10u);
+    EXPECT_EQ(stats.partitions_scanned, 2u);
+    EXPECT_TRUE(rows.count("r3_0") && rows.count("r4_199"));
+    EXPECT_FALSE(rows.count("r5_0"));
+
+    EXPECT_EQ(window(index, -1e6, 1e6, &stats), 2000u);
+    EXPECT_EQ(stats.partitions_scanned, 10u);
+    EXPECT_EQ(window(index, 5000.0, 6000.0, &stats), 0u);
+    EXPECT_EQ(stats.partitions_scanned, 0u);
+}
+
+TEST_F(PartitionedIndexTest, KeepsAtMostMaxOpenPartitionsLoaded) {
+    options_.max_open = 3;
+    {
+        PartitionedIndex index(options_);
+        fill(index, 0, 12, 50);
+        EXPECT_LE(index.open_partitions(), 3u);
+        EXPECT_LE(IndexRegistry::global().loaded_count(), 3u);
+
+        // A query over the whole history streams through the partitions
+        PartitionQueryStats stats;
+        EXPECT_EQ(window(index, -1e6, 1e6, &stats), 600u);
+        EXPECT_EQ(stats.partitions_scanned, 12u);
+        EXPECT_LE(index.open_partitions(), 3u);
+        EXPECT_LE(IndexRegistry::global().loaded_count(), 3u);
+
+        // Partitions closed while dirty were committed on the way out
+        for (int b = 0; b < 12; b++) {
+            auto* dr = new DataRecord(2, 32, "late" + std::to_string(b));
+            std::vector<double> pt = {b * 100.0 + 99.5, 1.0};
+            dr->putPoint(&pt);
+            index.insert(dr);
+        }
+        EXPECT_LE(IndexRegistry::global().loaded_count(), 3u);
+    }
+    IndexDetails<DataRecord>::clearCache();
+
+    PartitionedIndex index(options_);
+    EXPECT_EQ(window(index, -1e6, 1e6), 612u);
+    EXPECT_EQ(index.record_count("metrics.p11+1"), 51u);
+    EXPECT_LE(IndexRegistry::global().loaded_count(), 3u);
+}
+
+TEST_F(PartitionedIndexTest, DropBeforeDeletesPartitionFiles) {
+    PartitionedIndex index(options_);
+    fill(index, 0, 8, 100);
+
+    EXPECT_EQ(index.drop_before(450.0), 4u);  // [400, 500) still holds t >= 450
+    EXPECT_EQ(index.partitions().size(), 4u);
+    EXPECT_EQ(index.partitions().front().field_name, "metrics.p4+1");
+    for (int b = 0; b < 4; b++) {
+        const std::string name = "metrics.p" + std::to_string(b) + "+1";
+        EXPECT_FALSE(std::filesystem::exists(base_dir_ + "/" + name)) << name;
+        EXPECT_FALSE(IndexRegistry::global().is_registered(name)) << name;
+    }
+    EXPECT_EQ(window(index, -1e6, 1e6), 400u);
+
+    EXPECT_TRUE(index.drop_partition("metrics.p7+1"));
+    EXPECT_FALSE(index.drop_partition("metrics.p7+1"));
+    EXPECT_EQ(window(index, -1e6, 1e6), 300u);
+
+    // Dropped buckets can be written again
+    fill(index, 0, 1, 10);
+    EXPECT_EQ(window(index, 0.0, 99.0), 10u);
+}
+
+TEST_F(PartitionedIndexTest, ReopenFindsPartitions) {
+    {
+        PartitionedIndex index(options_);
+        fill(index, 10, 3, 150);
+        fill(index, -2, 1, 20);   // Negative times get their own buckets
+    }
+    IndexDetails<DataRecord>::clearCache();
+
+    // Leftover of a merge that never finished
+    std::filesystem::create_directories(base_dir_ + "/metrics.m10+3");
+
+    PartitionedIndex index(options_);
+    auto parts = index.partitions();
+    ASSERT_EQ(parts.size(), 4u);
+    EXPECT_EQ(parts.front().field_name, "metrics.p-2+1");
+    EXPECT_FALSE(std::filesystem::exists(base_dir_ + "/metrics.m10+3"));
+    EXPECT_EQ(index.record_count("metrics.p11+1"), 150u);
+
+    PartitionQueryStats stats;
+    EXPECT_EQ(window(index, 1100.0, 1199.0, &stats), 150u);
+    EXPECT_EQ(stats.partitions_scanned, 1u);
+    EXPECT_EQ(window(index, -1e6, 1e6), 470u);
+
+    // Appends go to the reopened partition
+    fill(index, 12, 1, 5);
+    EXPECT_EQ(index.partitions().size(), 4u);
+    EXPECT_EQ(window(index, 1200.0, 1299.0), 155u);
+}
+
+TEST_F(PartitionedIndexTest, MergesSmallPartitions) {
+    options_.merge_below = 100;
+    std::set<std::string> before;
+    {
+        PartitionedIndex index(options_);
+        fill(index, 0, 2, 300);   // Large: left alone
+        fill(index, 2, 5, 30);    // Small: 2-4 fit in one merge, 5-6 in another
+        fill(index, 8, 1, 10);    // Newest: still being appended to
+        window(index, -1e6, 1e6, nullptr, &before);
+        ASSERT_EQ(before.size(), 760u);
+
+        EXPECT_EQ(index.merge_small_partitions(), 3u);
+        std::vector<std::string> names;
+        for (const auto& p : index.partitions()) names.push_back(p.field_name);
+        EXPECT_EQ(names, (std::vector<std::string>{
+            "metrics.p0+1", "metrics.p1+1", "metrics.p2+3", "metrics.p5+2", "metrics.p8+1"}));
+        EXPECT_FALSE(std::filesystem::exists(base_dir_ + "/metrics.p3+1"));
+        EXPECT_EQ(index.record_count("metrics.p2+3"), 90u);
+
+        std::set<std::string> after;
+        PartitionQueryStats stats;
+        EXPECT_EQ(window(index, 300.0, 399.0, &stats, &after), 30u);
+        EXPECT_EQ(stats.partitions_scanned, 1u);
+        after.clear();
+        window(index, -1e6, 1e6, nullptr, &after);
+        EXPECT_EQ(after, before);
+
+        // A bucket inside a merged range routes to the merged partition
+        fill(index, 3, 1, 5);
+        EXPECT_EQ(index.partitions().size(), 5u);
+        EXPECT_EQ(index.record_count("metrics.p2+3"), 95u);
+    }
+    IndexDetails<DataRecord>::clearCache();
+
+    // The renamed directory reopens under its new name
+    PartitionedIndex index(options_);
+    EXPECT_EQ(index.partitions().size(), 5u);
+    EXPECT_EQ(window(index, -1e6, 1e6), 765u);
+    EXPECT_EQ(index.merge_small_partitions(), 0u);
+}
+
+TEST_F(PartitionedIndexTest, MergedSourcesLeftBehindAreRemovedOnOpen) {
+    options_.merge_below = 100;
+    {
+        PartitionedIndex index(options_);
+        fill(index, 0, 3, 10);
+        fill(index, 5, 1, 10);
+        ASSERT_EQ(index.merge_small_partitions(), 2u);
+    }
+    IndexDetails<DataRecord>::clearCache();
+
+    // As if the process died between the rename and deleting the sources
+    std::filesystem::create_directories(base_dir_ + "/metrics.p1+1");
+
+    PartitionedIndex index(options_);
+    auto parts = index.partitions();
+    ASSERT_EQ(parts.size(), 2u);
+    EXPECT_EQ(parts.front().field_name, "metrics.p0+3");
+    EXPECT_FALSE(std::filesystem::exists(base_dir_ + "/metrics.p1+1"));
+    EXPECT_EQ(window(index, -1e6, 1e6), 40u);
+}
+
+} // namespace persist
+} // namespace xtree
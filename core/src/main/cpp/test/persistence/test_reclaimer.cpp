@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include "../../src/persistence/reclaimer.h"
+#include "../../src/persistence/object_table_sharded.hpp"
+#include "../../src/persistence/mvcc_context.h"
+
+using namespace xtree::persist;
+using namespace std::chrono_literals;
+
+class ReclaimerTest : public ::testing::Test {
+protected:
+    std::unique_ptr<ObjectTableSharded> ot;
+    std::unique_ptr<MVCCContext> mvcc;
+    
+    void SetUp() override {
+        ot = std::make_unique<ObjectTableSharded>(100000);
+        mvcc = std::make_unique<MVCCContext>();
+    }
+    
+    // Allocate, publish at epoch 1 and retire at `epoch`
+    void retire_nodes(size_t n, uint64_t epoch) {
+        OTAddr addr{};
+        addr.length = 4096;
+        for (size_t i = 0; i < n; i++) {
+            NodeID id = ot->allocate(NodeKind::Leaf, 0, addr, 0);
+            NodeID live = ot->mark_live_reserve(id, 1);
+            ot->mark_live_commit(live, 1);
+            ot->retire(live, epoch);
+        }
+    }
+    
+    // Poll until the background thread has drained the backlog
+    bool wait_for_backlog(size_t target) {
+        for (int i = 0; i < 500; i++) {
+            if (ot->retired_backlog() <= target) return true;
+            std::this_thread::sleep_for(5ms);
+        }
+        return false;
+    }
+};
+
+TEST_F(ReclaimerTest, RunOnceReclaimsBeforeMinActive) {
+    retire_nodes(100, 2);
+    Reclaimer reclaimer(*ot, *mvcc);
+    
+    // Global epoch 0: nothing is safe yet
+    EXPECT_EQ(reclaimer.run_once(), 0u);
+    
+    // A reader pinned at epoch 2 still sees the retired nodes
+    auto* pin = mvcc->register_thread();
+    MVCCContext::pin_epoch(pin, 2);
+    mvcc->advance_epoch();
+    mvcc->advance_epoch();
+    mvcc->advance_epoch();
+    EXPECT_EQ(reclaimer.run_once(), 0u);
+    
+    MVCCContext::unpin(pin);
+    EXPECT_EQ(reclaimer.run_once(), 100u);
+    EXPECT_EQ(ot->retired_backlog(), 0u);
+    mvcc->deregister_thread();
+}
+
+TEST_F(ReclaimerTest, BackgroundPassRunsUnderRetirePressure) {
+    Reclaimer reclaimer(*ot, *mvcc, /*pressure_threshold=*/1000);
+    mvcc->advance_epoch();
+    mvcc->advance_epoch();
+    mvcc->advance_epoch();
+    reclaimer.set_durable_epoch(2);
+    reclaimer.start();
+    
+    // Below the threshold the backlog is left alone
+    retire_nodes(500, 1);
+    reclaimer.notify();
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(ot->retired_backlog(), 500u);
+    EXPECT_EQ(reclaimer.background_passes(), 0u);
+    
+    // Crossing it triggers a pass without any explicit call
+    retire_nodes(600, 2);
+    reclaimer.notify();
+    EXPECT_TRUE(wait_for_backlog(0));
+    EXPECT_GE(reclaimer.background_passes(), 1u);
+    EXPECT_EQ(reclaimer.background_reclaimed(), 1100u);
+    
+    reclaimer.stop();
+}
+
+// Freed blocks can be reused at once, so the background pass must not free
+// anything a crash could still resurrect
+TEST_F(ReclaimerTest, BackgroundPassWaitsForDurableEpoch) {
+    Reclaimer reclaimer(*ot, *mvcc, /*pressure_threshold=*/100);
+    for (int i = 0; i < 5; i++) mvcc->advance_epoch();
+    reclaimer.start();
+
+    retire_nodes(200, 2);
+    retire_nodes(200, 4);
+    reclaimer.notify();
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(ot->retired_backlog(), 400u);
+
+    // A checkpoint at epoch 3 covers the first retires only
+    reclaimer.set_durable_epoch(3);
+    reclaimer.notify();
+    EXPECT_TRUE(wait_for_backlog(200));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(ot->retired_backlog(), 200u);
+
+    reclaimer.set_durable_epoch(4);
+    reclaimer.notify();
+    EXPECT_TRUE(wait_for_backlog(0));
+    EXPECT_EQ(reclaimer.background_reclaimed(), 400u);
+
+    reclaimer.stop();
+}
+
+TEST_F(ReclaimerTest, StopIsIdempotent) {
+    Reclaimer reclaimer(*ot, *mvcc);
+    reclaimer.start();
+    reclaimer.start();
+    reclaimer.stop();
+    reclaimer.stop();
+    EXPECT_EQ(reclaimer.background_passes(), 0u);
+}
@@ -0,0 +1,388 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Read-only replicas following a writer on the same data directory
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/persistence/durable_runtime.h"
+#include "../../src/persistence/durable_store.h"
+#include "../../src/persistence/ot_delta_log.h"
+#include "../../src/indexdetails.hpp"
+#include "../../src/xtree.h"
+#include "../../src/xtree.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace xtree {
+namespace persist {
+
+class ReplicaTailerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        namespace fs = std::filesystem;
+        // One directory per test: writers and replicas of a failed test
+        // must not leave files behind for the next one
+        const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        test_dir_ = "/tmp/replica_tailer_test_" + std::to_string(getpid()) + "_" + test_name;
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_);
+
+        paths_ = {
+            .data_dir = test_dir_,
+            .manifest = test_dir_ + "/manifest.json",
+            .superblock = test_dir_ + "/superblock.bin",
+            .active_log = test_dir_ + "/ot_delta.wal"
+        };
+        policy_ = {
+            .max_replay_bytes = 100 * 1024 * 1024,
+            .max_replay_epochs = 100000,
+            .max_age = std::chrono::seconds(600),
+            .min_interval = std::chrono::seconds(30)
+        };
+    }
+
+    void TearDown() override {
+        // Indexes opened by a test stay in the process-wide cache
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static DurableContext contextFor(DurableRuntime& rt) {
+        return DurableContext{
+            .ot = rt.ot(),
+            .alloc = rt.allocator(),
+            .coord = rt.coordinator(),
+            .mvcc = rt.mvcc(),
+            .runtime = rt
+        };
+    }
+
+    // Commit a leaf holding text as the primary root at epoch
+    static NodeID commitRoot(DurableStore& store, const char* text, uint64_t epoch) {
+        auto alloc = store.allocate_node(256, NodeKind::Leaf);
+        std::memcpy(alloc.writable, text, std::strlen(text) + 1);
+        store.publish_node(alloc.id, alloc.writable, std::strlen(text) + 1);
+        store.set_root(alloc.id, epoch, nullptr, 0, "");
+        store.commit(epoch);
+        return store.get_root("");
+    }
+
+    static std::string readRoot(DurableStore& store) {
+        NodeID root = store.get_root("");
+        if (!root.valid()) return {};
+        auto bytes = store.read_node(root);
+        return bytes.data ? std::string(static_cast<const char*>(bytes.data)) : std::string{};
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    std::string test_dir_;
+    Paths paths_;
+    CheckpointPolicy policy_;
+};
+
+TEST_F(ReplicaTailerTest, DeltaLogTailResumesAndStopsAtPreallocatedTail) {
+    const std::string path = test_dir_ + "/tail.wal";
+    OTDeltaLog log(path);
+    ASSERT_TRUE(log.open_for_append());
+
+    auto rec = [](uint64_t handle, uint64_t epoch) {
+        OTDeltaRec r{};
+        r.handle_idx = handle;
+        r.tag = 1;
+        r.kind = static_cast<uint8_t>(NodeKind::Leaf);
+        r.birth_epoch = epoch;
+        r.retire_epoch = ~uint64_t{0};
+        return r;
+    };
+    log.append({rec(1, 1), rec(2, 1)});
+    log.sync();
+
+    std::vector<uint64_t> seen;
+    uint64_t next = 0;
+    std::string error;
+    ASSERT_TRUE(OTDeltaLog::tail(path, 0, [&](const OTDeltaRec& r) {
+        seen.push_back(r.handle_idx);
+        return true;
+    }, &next, &error)) << error;
+    EXPECT_EQ(seen, (std::vector<uint64_t>{1, 2}));
+    EXPECT_EQ(next, log.get_end_offset());
+
+    // Nothing new: the zeroed preallocation is a clean end
+    uint64_t again = 0;
+    ASSERT_TRUE(OTDeltaLog::tail(path, next, [&](const OTDeltaRec&) {
+        ADD_FAILURE() << "no record expected";
+        return true;
+    }, &again, &error));
+    EXPECT_EQ(again, next);
+
+    // A refused record is left for the next call
+    log.append({rec(3, 2), rec(4, 3)});
+    log.sync();
+    seen.clear();
+    ASSERT_TRUE(OTDeltaLog::tail(path, next, [&](const OTDeltaRec& r) {
+        if (r.birth_epoch > 2) return false;
+        seen.push_back(r.handle_idx);
+        return true;
+    }, &next, &error));
+    EXPECT_EQ(seen, (std::vector<uint64_t>{3}));
+    seen.clear();
+    ASSERT_TRUE(OTDeltaLog::tail(path, next, [&](const OTDeltaRec& r) {
+        seen.push_back(r.handle_idx);
+        return true;
+    }, &next, &error));
+    EXPECT_EQ(seen, (std::vector<uint64_t>{4}));
+
+    log.close();
+}
+
+TEST_F(ReplicaTailerTest, CatchUpFollowsWriterCommits) {
+    auto writer = DurableRuntime::open(paths_, policy_);
+    auto wctx = contextFor(*writer);
+    DurableStore wstore(wctx, "test");
+    commitRoot(wstore, "first", 1);
+
+    auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+    auto rctx = contextFor(*replica);
+    DurableStore rstore(rctx, "test");
+
+    // Opened without a checkpoint: catch-up replays the log from the start
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "first");
+    const uint64_t gen = replica->replica_generation();
+    EXPECT_FALSE(replica->take_replica_changes().empty());
+
+    NodeID second = commitRoot(wstore, "second", 2);
+    commitRoot(wstore, "third", 3);
+    EXPECT_EQ(readRoot(rstore), "first");  // not applied yet
+
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_GT(replica->replica_generation(), gen);
+    EXPECT_EQ(readRoot(rstore), "third");
+    EXPECT_TRUE(rstore.is_node_present(second));
+    EXPECT_EQ(replica->mvcc().get_global_epoch(), 3u);
+
+    // Nothing committed since: no new generation
+    const uint64_t settled = replica->replica_generation();
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(replica->replica_generation(), settled);
+
+    // Writable runtimes have no replica mode
+    EXPECT_FALSE(writer->catch_up());
+    EXPECT_FALSE(writer->start_replica());
+}
+
+TEST_F(ReplicaTailerTest, BackgroundTailerPicksUpCommits) {
+    auto writer = DurableRuntime::open(paths_, policy_);
+    auto wctx = contextFor(*writer);
+    DurableStore wstore(wctx, "test");
+    commitRoot(wstore, "v1", 1);
+
+    auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+    auto rctx = contextFor(*replica);
+    DurableStore rstore(rctx, "test");
+
+    for (bool inotify : {true, false}) {
+        SCOPED_TRACE(inotify ? "inotify" : "polling");
+        ReplicaOptions opts;
+        opts.poll_interval = std::chrono::milliseconds(5);
+        opts.use_inotify = inotify;
+        ASSERT_TRUE(replica->start_replica(opts));
+        EXPECT_FALSE(replica->start_replica(opts));
+
+        const std::string text = inotify ? "v2" : "v3";
+        commitRoot(wstore, text.c_str(), inotify ? 2 : 3);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (readRoot(rstore) != text && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(readRoot(rstore), text);
+        replica->stop_replica();
+    }
+}
+
+// Appends reserve log space before writing, so a record can sit behind one
+// from a later epoch. The round that stops there must not claim the earlier
+// epoch, and the record must still be applied once it is reached.
+TEST_F(ReplicaTailerTest, EarlierEpochBehindLaterOneIsNotDropped) {
+    auto writer = DurableRuntime::open(paths_, policy_);
+    auto wctx = contextFor(*writer);
+    DurableStore wstore(wctx, "test");
+    commitRoot(wstore, "first", 1);
+
+    auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+    auto rctx = contextFor(*replica);
+    DurableStore rstore(rctx, "test");
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "first");
+
+    auto alloc_late = wstore.allocate_node(64, NodeKind::Leaf);
+    auto alloc_early = wstore.allocate_node(64, NodeKind::Leaf);
+    auto rec = [](NodeID id, uint64_t epoch) {
+        OTDeltaRec r{};
+        r.handle_idx = id.handle_index();
+        r.tag = id.tag();
+        r.kind = static_cast<uint8_t>(NodeKind::Leaf);
+        r.birth_epoch = epoch;
+        r.retire_epoch = ~uint64_t{0};
+        return r;
+    };
+    writer->coordinator().get_active_log()->append({rec(alloc_late.id, 3), rec(alloc_early.id, 2)});
+    commitRoot(wstore, "second", 2);
+
+    // Target is epoch 2, but the epoch-3 frame comes first
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "first");
+    EXPECT_EQ(replica->ot().try_get(alloc_early.id), nullptr);
+
+    commitRoot(wstore, "third", 3);
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "third");
+    const OTEntry* early = replica->ot().try_get(alloc_early.id);
+    ASSERT_NE(early, nullptr);
+    EXPECT_EQ(early->birth_epoch.load(), 2u);
+    EXPECT_NE(replica->ot().try_get(alloc_late.id), nullptr);
+}
+
+// The replica maps the writer's files, so a republished node must go to a
+// new block: the committed one keeps its bytes until the replica catches up
+TEST_F(ReplicaTailerTest, RepublishDoesNotRewriteCommittedBytes) {
+    auto writer = DurableRuntime::open(paths_, policy_);
+    auto wctx = contextFor(*writer);
+    DurableStore wstore(wctx, "test");
+    NodeID root = commitRoot(wstore, "first", 1);
+    const OTAddr before = writer->ot().get(root).addr;
+
+    auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+    auto rctx = contextFor(*replica);
+    DurableStore rstore(rctx, "test");
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "first");
+
+    const char rewritten[] = "rewritten";
+    wstore.publish_node(root, rewritten, sizeof(rewritten));
+    EXPECT_EQ(readRoot(wstore), "rewritten");  // the writer sees its own batch
+    EXPECT_EQ(readRoot(rstore), "first");
+
+    wstore.set_root(root, 2, nullptr, 0, "");
+    wstore.commit(2);
+    const OTAddr after = writer->ot().get(root).addr;
+    EXPECT_FALSE(after.file_id == before.file_id && after.segment_id == before.segment_id &&
+                 after.offset == before.offset);
+    EXPECT_EQ(readRoot(rstore), "first");  // not applied yet
+
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "rewritten");
+}
+
+TEST_F(ReplicaTailerTest, ReplicaLeavesWriterFilesAlone) {
+    auto writer = DurableRuntime::open(paths_, policy_);
+    auto wctx = contextFor(*writer);
+    DurableStore wstore(wctx, "test");
+    commitRoot(wstore, "kept", 1);
+
+    const std::string manifest = readFile(paths_.manifest);
+    {
+        auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+        ASSERT_TRUE(replica->catch_up());
+    }
+    // Closing a replica must not seal the writer's active log
+    EXPECT_EQ(readFile(paths_.manifest), manifest);
+
+    commitRoot(wstore, "after", 2);
+    auto replica = DurableRuntime::open(paths_, policy_, false, /*read_only=*/true);
+    auto rctx = contextFor(*replica);
+    DurableStore rstore(rctx, "test");
+    ASSERT_TRUE(replica->catch_up());
+    EXPECT_EQ(readRoot(rstore), "after");
+}
+
+// The node cache is process-wide and keyed by NodeID, so the writer index
+// runs in a child process, as it would in production
+TEST_F(ReplicaTailerTest, IndexRefreshSeesWriterInserts) {
+    const int BATCH = 1500;
+    int to_parent[2], to_child[2];
+    ASSERT_EQ(pipe(to_parent), 0);
+    ASSERT_EQ(pipe(to_child), 0);
+    std::vector<const char*> dimLabels = {"x", "y"};
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        auto* index = new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, "points",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, test_dir_);
+        index->ensure_root_initialized<DataRecord>();
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> pos(0.0, 1000.0);
+        char token = 0;
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < BATCH; i++) {
+                auto* dr = new DataRecord(2, 32, "p" + std::to_string(round * BATCH + i));
+                std::vector<double> pt = {pos(gen), pos(gen)};
+                dr->putPoint(&pt);
+                index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+            }
+            index->flush_dirty_buckets();
+            index->getStore()->commit(0);
+            if (write(to_parent[1], "c", 1) != 1 || read(to_child[0], &token, 1) != 1) _exit(1);
+        }
+        index->close();
+        _exit(0);
+    }
+
+    auto count = [](IndexDetails<DataRecord>& idx) {
+        DataRecord query(2, 32, "q");
+        std::vector<double> lo = {0, 0}, hi = {1000, 1000};
+        query.putPoint(&lo);
+        query.putPoint(&hi);
+        auto* iter = idx.root_bucket<DataRecord>()->getIterator(idx.root_cache_node(), &query, INTERSECTS);
+        size_t hits = 0;
+        std::string_view rid;
+        while (iter->nextRowID(rid)) hits++;
+        delete iter;
+        return hits;
+    };
+
+    char token = 0;
+    ASSERT_EQ(read(to_parent[0], &token, 1), 1);
+    {
+        IndexDetails<DataRecord> reader(2, 32, &dimLabels, nullptr, nullptr, "points",
+                                        IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+                                        test_dir_, /*read_only=*/true);
+        ASSERT_TRUE(reader.refresh_replica());
+        EXPECT_EQ(count(reader), static_cast<size_t>(BATCH));
+        EXPECT_FALSE(reader.refresh_replica());
+
+        ASSERT_EQ(write(to_child[1], "n", 1), 1);
+        ASSERT_EQ(read(to_parent[0], &token, 1), 1);
+        EXPECT_EQ(count(reader), static_cast<size_t>(BATCH));  // until refreshed
+
+        ASSERT_TRUE(reader.refresh_replica());
+        EXPECT_EQ(count(reader), static_cast<size_t>(2 * BATCH));
+        reader.close();
+    }
+
+    ASSERT_EQ(write(to_child[1], "x", 1), 1);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    for (int fd : {to_parent[0], to_parent[1], to_child[0], to_child[1]}) close(fd);
+}
+
+} // namespace persist
+} // namespace xtree
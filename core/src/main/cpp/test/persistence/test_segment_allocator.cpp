@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 #include <set>
+#include <tuple>
 #include <thread>
 #include <vector>
 #include <atomic>
@@ -1064,6 +1065,43 @@ TEST_F(SegmentAllocatorTest, RecoveryPointerCacheMissHandling) {
 }
 
 // Test that close_all properly releases resources
+// A reopened allocator starts with every block free. restore_live_block()
+// claims the blocks of recovered nodes so new allocations go elsewhere.
+TEST_F(SegmentAllocatorTest, RestoreLiveBlockKeepsRecoveredBlocks) {
+    struct Block { uint8_t class_id; uint32_t file_id, segment_id; uint64_t offset; uint32_t length; };
+    std::vector<Block> live;
+    for (int i = 0; i < 8; i++) {
+        auto alloc = allocator->allocate(1024);
+        ASSERT_TRUE(alloc.is_valid());
+        memset(allocator->get_ptr(alloc), 'A' + i, 1024);
+        live.push_back({alloc.class_id, alloc.file_id, alloc.segment_id, alloc.offset, alloc.length});
+    }
+    allocator.reset();
+    allocator = std::make_unique<SegmentAllocator>(test_dir);
+
+    for (const auto& a : live) {
+        ASSERT_TRUE(allocator->restore_live_block(a.class_id, a.file_id, a.segment_id, a.offset, a.length));
+    }
+    for (int i = 0; i < 16; i++) {
+        auto fresh = allocator->allocate(1024);
+        ASSERT_TRUE(fresh.is_valid());
+        for (const auto& a : live) {
+            EXPECT_FALSE(fresh.file_id == a.file_id && fresh.offset == a.offset)
+                << "live block at offset " << a.offset << " handed out again";
+        }
+        memset(allocator->get_ptr(fresh), 'z', 1024);
+    }
+
+    for (size_t i = 0; i < live.size(); i++) {
+        const auto& a = live[i];
+        auto* bytes = static_cast<const char*>(
+            allocator->get_ptr_for_recovery(a.class_id, a.file_id, a.segment_id, a.offset, a.length));
+        ASSERT_NE(bytes, nullptr);
+        EXPECT_EQ(bytes[0], static_cast<char>('A' + i));
+        EXPECT_EQ(bytes[1023], static_cast<char>('A' + i));
+    }
+}
+
 TEST_F(SegmentAllocatorTest, CloseAllReleasesResources) {
     // Allocate some segments
     std::vector<std::pair<void*, size_t>> allocations;
@@ -1117,4 +1155,140 @@ TEST_F(SegmentAllocatorTest, CloseAllIdempotent) {
     auto new_alloc = allocator->allocate(512);
     void* new_ptr = allocator->get_ptr(new_alloc);
     ASSERT_NE(new_ptr, nullptr);
-}
\ No newline at end of file
+}
+// ========== Per-thread magazines and free-space index ==========
+
+// Blocks handed out from different threads' magazines never overlap, and
+// stats stay exact once the threads (and their caches) are gone
+TEST_F(SegmentAllocatorTest, ThreadCachesHandOutUniqueBlocks) {
+    const int kThreads = 8;
+    const int kPerThread = 2000;
+    const uint8_t cls = size_to_class(256);
+    std::vector<std::vector<SegmentAllocator::Allocation>> kept(kThreads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                auto a = allocator->allocate(256);
+                ASSERT_TRUE(a.is_valid());
+                if (i % 2) {
+                    allocator->free(a);
+                } else {
+                    kept[t].push_back(std::move(a));
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    std::set<std::tuple<uint32_t, uint32_t, uint64_t>> seen;
+    for (const auto& v : kept) {
+        for (const auto& a : v) {
+            EXPECT_TRUE(seen.insert({a.file_id, a.segment_id, a.offset}).second)
+                << "block handed out twice: seg " << a.segment_id << " off " << a.offset;
+        }
+    }
+
+    auto stats = allocator->get_stats(cls);
+    EXPECT_EQ(stats.total_allocations, uint64_t(kThreads) * kPerThread);
+    EXPECT_EQ(stats.total_frees, uint64_t(kThreads) * kPerThread / 2);
+    EXPECT_EQ(stats.live_bytes, seen.size() * 256);
+
+    // Exited threads flushed their magazines: only live blocks stay reserved
+    EXPECT_EQ(allocator->get_segment_utilization().total_used, seen.size() * 256);
+}
+
+TEST_F(SegmentAllocatorTest, FlushThreadCacheReturnsReservedBlocks) {
+    auto a = allocator->allocate(256);
+    ASSERT_TRUE(a.is_valid());
+
+    // The refill reserved a batch beyond the one block handed out
+    EXPECT_GT(allocator->get_segment_utilization().total_used, 256u);
+
+    allocator->free(a);
+    allocator->flush_thread_cache();
+    EXPECT_EQ(allocator->get_segment_utilization().total_used, 0u);
+
+    // The freed block is handed out again
+    auto b = allocator->allocate(256);
+    EXPECT_EQ(b.segment_id, a.segment_id);
+    EXPECT_EQ(b.offset, a.offset);
+}
+
+TEST_F(SegmentAllocatorTest, CloseAllDropsThreadCaches) {
+    auto a = allocator->allocate(256);
+    ASSERT_NE(allocator->get_ptr(a), nullptr);
+
+    // Magazine still references the closed segments; it must be discarded
+    allocator->close_all();
+
+    auto b = allocator->allocate(256);
+    void* p = allocator->get_ptr(b);
+    ASSERT_NE(p, nullptr);
+    memset(p, 0xAB, 256);
+    EXPECT_EQ(allocator->get_segment_count(), 1u);
+    allocator->free(b);
+}
+
+// A thread returning its magazines while close_all() tears the segments down
+// must either return them first or drop them, never write into freed segments
+TEST_F(SegmentAllocatorTest, FlushDuringCloseAllIsSafe) {
+    const size_t sizes[] = {256, 1024, 4096};
+    for (int round = 0; round < 50; ++round) {
+        std::atomic<bool> filled{false}, go{false};
+        std::thread flusher([&]() {
+            for (size_t sz : sizes) {
+                std::vector<SegmentAllocator::Allocation> taken;
+                for (int i = 0; i < 16; ++i) taken.push_back(allocator->allocate(sz));
+                for (auto& a : taken) allocator->free(a);  // Parked in the magazine
+            }
+            filled = true;
+            while (!go) std::this_thread::yield();
+            allocator->flush_thread_cache();
+        });
+        while (!filled) std::this_thread::yield();
+        go = true;
+        allocator->close_all();
+        flusher.join();
+
+        // The allocator keeps working on fresh segments
+        auto a = allocator->allocate(256);
+        void* p = allocator->get_ptr(a);
+        ASSERT_NE(p, nullptr);
+        memset(p, 0xCD, 256);
+        allocator->free(a);
+    }
+}
+
+// A full active segment falls back to an older segment with a freed block
+// instead of opening a new one
+TEST_F(SegmentAllocatorTest, FreeSpaceIndexReusesEarlySegment) {
+    StorageConfig config = StorageConfig::defaults();
+    config.thread_cache_bytes = 0;  // Locked path, no reservations
+    allocator.reset();
+    allocator = std::make_unique<SegmentAllocator>(test_dir, config);
+
+    // Fill segment 0, then exactly as many blocks in segment 1
+    std::vector<SegmentAllocator::Allocation> seg0;
+    SegmentAllocator::Allocation a;
+    while ((a = allocator->allocate(256)).segment_id == 0) {
+        seg0.push_back(std::move(a));
+    }
+    for (size_t i = 1; i < seg0.size(); ++i) {
+        ASSERT_EQ(allocator->allocate(256).segment_id, 1u);
+    }
+    const size_t segments = allocator->get_segment_count();
+
+    auto& victim = seg0[seg0.size() / 2];
+    const uint64_t victim_offset = victim.offset;
+    allocator->free(victim);
+
+    auto reused = allocator->allocate(256);
+    EXPECT_EQ(reused.segment_id, 0u);
+    EXPECT_EQ(reused.offset, victim_offset);
+    EXPECT_EQ(allocator->get_segment_count(), segments);
+
+    // Nothing left anywhere - a new segment is opened
+    EXPECT_EQ(allocator->allocate(256).segment_id, 2u);
+}
@@ -80,6 +80,30 @@ TEST(CachePolicyTest, AdaptivePolicy) {
     EXPECT_STREQ(policy.name(), "Adaptive");
 }
 
+TEST(CachePolicyTest, AdaptivePolicySizesFromMissRatioCurve) {
+    size_t minBudget = 64 * 1024;          // 64KB
+    size_t maxBudget = 64 * 1024 * 1024;   // 64MB
+
+    AdaptiveCachePolicy policy(minBudget, maxBudget, 0.80);
+    size_t initial = policy.getMaxMemory();
+
+    // Too few samples - curve is ignored
+    MissRatioCurve curve(1.0);
+    curve.access(1, 4096);
+    curve.access(1, 4096);
+    policy.onCurve(curve);
+    EXPECT_EQ(policy.getMaxMemory(), initial);
+
+    // Cyclic 1MB working set (256 x 4KB), 10 passes: 90% hit rate is only
+    // reachable once the whole loop fits, so the budget lands near 1MB
+    for (int pass = 0; pass < 10; ++pass) {
+        for (uint64_t k = 0; k < 256; ++k) curve.access(k, 4096);
+    }
+    policy.onCurve(curve);
+    EXPECT_GT(policy.getMaxMemory(), 800u * 1024);
+    EXPECT_LT(policy.getMaxMemory(), 1300u * 1024);
+}
+
 TEST(CachePolicyTest, CreatePolicyFromString) {
     // Unlimited
     auto unlimited = createCachePolicy("unlimited");
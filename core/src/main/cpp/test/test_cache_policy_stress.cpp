@@ -298,3 +298,51 @@ TEST_F(CachePolicyStressTest, TinyBudgetForcesEviction) {
 
     delete idx;
 }
+
+// The adaptive policy resizes the cache from its miss ratio curve at the
+// flush and eviction safe points; nothing calls tickCachePolicy() directly
+TEST_F(CachePolicyStressTest, AdaptivePolicyFollowsSkewedWorkload) {
+    auto policy = std::make_shared<AdaptiveCachePolicy>(
+        64 * 1024, 256ULL * 1024 * 1024, 0.80);
+    IndexDetails<DataRecord>::applyCachePolicy(policy);
+    const size_t initial = policy->getMaxMemory();
+    ASSERT_EQ(IndexDetails<DataRecord>::getCacheMaxMemory(), initial);
+
+    // Sample every key so a short run yields a usable curve
+    auto& curve = IndexDetails<DataRecord>::getCache().missRatioCurve();
+    curve.configure(1.0, MissRatioCurve::kDefaultMaxTracked);
+
+    auto* idx = new IndexDetails<DataRecord>(
+        2, 32, nullptr, nullptr, nullptr,
+        "test_field",
+        IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+        test_dir_
+    );
+    idx->template ensure_root_initialized<DataRecord>();
+
+    // Nine in ten inserts land in one small hot cluster
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> hot(0.0, 10.0);
+    std::uniform_real_distribution<double> cold(-1000.0, 1000.0);
+    const int NUM_RECORDS = 5000;
+    for (int i = 0; i < NUM_RECORDS; ++i) {
+        const bool isHot = i % 10 != 0;
+        std::vector<double> p = {isHot ? hot(rng) : cold(rng), isHot ? hot(rng) : cold(rng)};
+        auto* dr = XAlloc<DataRecord>::allocate_record(idx, 2, 32, "rec_" + std::to_string(i));
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+
+        if ((i + 1) % 500 == 0) {
+            idx->flush_dirty_buckets();
+            idx->getStore()->commit((i + 1) / 500);
+        }
+    }
+
+    // The hot path fits in far less than the starting budget
+    EXPECT_GT(curve.sampledReuses(), 0u);
+    EXPECT_LT(policy->getMaxMemory(), initial);
+    EXPECT_EQ(IndexDetails<DataRecord>::getCacheMaxMemory(), policy->getMaxMemory());
+
+    delete idx;
+    curve.configure(MissRatioCurve::kDefaultSamplingRate, MissRatioCurve::kDefaultMaxTracked);
+}
@@ -10,7 +10,9 @@
 #include "../src/persistence/manifest.h"
 #include "../src/xtree.h"  // Full XTree definitions including XTreeBucket
 
+#include <atomic>
 #include <filesystem>
+#include <mutex>
 #include <thread>
 #include <chrono>
 
@@ -661,3 +663,237 @@ TEST_F(IndexRegistryTest, ServerlessPatternEndToEnd) {
     size_t freed = registry.unload_cold_indexes(1024 * 1024);  // Try to free 1MB
     EXPECT_LT(registry.loaded_count(), 3u);  // Should have unloaded something
 }
+
+// ============================================================================
+// Background Preloading Tests
+// ============================================================================
+
+TEST_F(IndexRegistryTest, PreloadLoadsHottestFieldsFirst) {
+    auto& registry = IndexRegistry::global();
+
+    Manifest manifest(test_base_dir_);
+    std::vector<Manifest::RootEntry> roots;
+    roots.push_back({"cold", 6001, 600, {0.0f, 10.0f, 0.0f, 10.0f}, 3});
+    roots.push_back({"hot", 6002, 600, {0.0f, 10.0f, 0.0f, 10.0f}, 90});
+    roots.push_back({"warm", 6003, 600, {0.0f, 10.0f, 0.0f, 10.0f}, 40});
+    roots.push_back({"never", 6004, 600, {0.0f, 10.0f, 0.0f, 10.0f}});
+    manifest.set_roots(roots);
+
+    IndexConfig defaults;
+    defaults.dimension = 2;
+    defaults.precision = 32;
+    ASSERT_EQ(registry.register_from_manifest(manifest, defaults), 4u);
+    EXPECT_EQ(registry.get_metadata("hot")->access_count.load(), 90u);
+
+    std::vector<std::string> order;
+    registry.set_on_load_callback([&](const std::string& name) { order.push_back(name); });
+
+    PreloadOptions options;
+    options.max_concurrent = 1;   // one worker keeps the order observable
+    options.min_access_count = 1;
+    EXPECT_EQ(registry.start_preload<DataRecord>(options), 3u);
+    ASSERT_TRUE(registry.wait_preload(std::chrono::seconds{30}));
+
+    EXPECT_EQ(order, (std::vector<std::string>{"hot", "warm", "cold"}));
+    EXPECT_FALSE(registry.is_loaded("never"));
+
+    auto stats = registry.preload_stats();
+    EXPECT_EQ(stats.queued, 3u);
+    EXPECT_EQ(stats.loaded, 3u);
+    EXPECT_FALSE(stats.running);
+
+    // Preloading is not an access; the first query is
+    const IndexMetadata* meta = registry.get_metadata("hot");
+    EXPECT_EQ(meta->access_count.load(), 90u);
+    ASSERT_NE(registry.get_or_load<DataRecord>("hot"), nullptr);
+    EXPECT_EQ(meta->load_count.load(), 1u);
+    EXPECT_EQ(meta->access_count.load(), 91u);
+}
+
+TEST_F(IndexRegistryTest, PreloadBoundedAndCancellable) {
+    auto& registry = IndexRegistry::global();
+    for (int i = 0; i < 6; i++) {
+        std::string name = "field_" + std::to_string(i);
+        registry.register_index(name, make_config(name));
+    }
+
+    // Hold the worker inside the first load so the queue stays put
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> loads{0};
+    registry.set_on_load_callback([&](const std::string&) {
+        loads++;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+
+    PreloadOptions options;
+    options.max_concurrent = 1;
+    options.max_indexes = 4;
+    EXPECT_EQ(registry.start_preload<DataRecord>(options), 4u);
+    EXPECT_EQ(registry.start_preload<DataRecord>(options), 0u);  // one pass at a time
+
+    while (loads.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // Equal counts rank by name: field_0 is loading, field_1..3 are queued
+    EXPECT_TRUE(registry.cancel_preload("field_2"));
+    EXPECT_FALSE(registry.cancel_preload("field_0"));
+    EXPECT_FALSE(registry.cancel_preload("field_5"));
+    hold.unlock();
+
+    ASSERT_TRUE(registry.wait_preload(std::chrono::seconds{30}));
+    auto stats = registry.preload_stats();
+    EXPECT_EQ(stats.loaded, 3u);
+    EXPECT_EQ(stats.cancelled, 1u);
+    EXPECT_TRUE(registry.is_loaded("field_3"));
+    EXPECT_FALSE(registry.is_loaded("field_2"));
+    EXPECT_FALSE(registry.is_loaded("field_4"));
+}
+
+// remove_index() racing the preloader must neither free the entry under
+// a running load nor leave the index that load opened behind
+TEST_F(IndexRegistryTest, RemoveIndexWaitsForPreload) {
+    auto& registry = IndexRegistry::global();
+    for (int i = 0; i < 3; i++) {
+        std::string name = "field_" + std::to_string(i);
+        registry.register_index(name, make_config(name));
+    }
+
+    // Hold the worker inside the load of field_0
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> loads{0};
+    registry.set_on_load_callback([&](const std::string&) {
+        loads++;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+    std::mutex unloaded_mu;
+    std::vector<std::string> unloaded;
+    registry.set_on_unload_callback([&](const std::string& name) {
+        std::lock_guard<std::mutex> lock(unloaded_mu);
+        unloaded.push_back(name);
+    });
+
+    PreloadOptions options;
+    options.max_concurrent = 1;
+    EXPECT_EQ(registry.start_preload<DataRecord>(options), 3u);
+    while (loads.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    std::atomic<bool> removed{false};
+    std::thread remover([&] {
+        registry.remove_index("field_1");   // Still queued
+        registry.remove_index("field_0");   // Being loaded
+        removed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_FALSE(removed.load()) << "remove_index() did not wait for the running load";
+    hold.unlock();
+    remover.join();
+
+    EXPECT_FALSE(registry.is_registered("field_0"));
+    EXPECT_FALSE(registry.is_registered("field_1"));
+    EXPECT_EQ(unloaded, std::vector<std::string>{"field_0"});
+
+    ASSERT_TRUE(registry.wait_preload(std::chrono::seconds{30}));
+    auto stats = registry.preload_stats();
+    EXPECT_EQ(stats.loaded, 2u);
+    EXPECT_EQ(stats.cancelled, 1u);
+    EXPECT_EQ(registry.get_loaded_fields(), std::vector<std::string>{"field_2"});
+}
+
+TEST_F(IndexRegistryTest, PreloadStopsWithoutMemoryHeadroom) {
+    auto& registry = IndexRegistry::global();
+    auto& coordinator = MemoryCoordinator::global();
+    for (int i = 0; i < 3; i++) {
+        std::string name = "field_" + std::to_string(i);
+        registry.register_index(name, make_config(name));
+    }
+
+    // Anything already cached or mapped is over a 1-byte budget
+    registry.get_or_load<DataRecord>("field_0")->ensure_root_initialized<DataRecord>();
+    coordinator.set_total_budget(1);
+    ASSERT_FALSE(coordinator.has_headroom());
+
+    EXPECT_EQ(registry.start_preload<DataRecord>(), 2u);
+    ASSERT_TRUE(registry.wait_preload(std::chrono::seconds{30}));
+    auto stats = registry.preload_stats();
+    EXPECT_EQ(stats.loaded, 0u);
+    EXPECT_EQ(stats.skipped_for_memory, 2u);
+    EXPECT_EQ(registry.loaded_count(), 1u);
+
+    coordinator.reset();
+}
+
+TEST_F(IndexRegistryTest, AccessCountsPersistToManifest) {
+    auto& registry = IndexRegistry::global();
+
+    Manifest manifest(test_base_dir_);
+    std::vector<Manifest::RootEntry> roots;
+    roots.push_back({"geo", 7001, 700, {0.0f, 10.0f, 0.0f, 10.0f}, 5});
+    roots.push_back({"time", 7002, 700, {0.0f, 10.0f, 0.0f, 10.0f}});
+    manifest.set_roots(roots);
+    ASSERT_TRUE(manifest.store());
+
+    IndexConfig defaults;
+    defaults.dimension = 2;
+    defaults.precision = 32;
+    ASSERT_EQ(registry.register_from_data_dir(test_base_dir_, defaults), 2u);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_NE(registry.get_or_load<DataRecord>("time"), nullptr);
+    }
+    EXPECT_EQ(registry.persist_access_counts(), 1u);  // geo unchanged at 5
+
+    // A restarted process sees the history
+    registry.reset();
+    ASSERT_EQ(registry.register_from_data_dir(test_base_dir_, defaults), 2u);
+    EXPECT_EQ(registry.get_metadata("geo")->access_count.load(), 5u);
+    EXPECT_EQ(registry.get_metadata("time")->access_count.load(), 3u);  // hits after the load
+
+    Manifest reloaded(test_base_dir_);
+    ASSERT_TRUE(reloaded.load());
+    ASSERT_EQ(reloaded.get_roots().size(), 2u);
+    EXPECT_EQ(reloaded.get_roots()[0].epoch, 700u);
+}
+
+TEST_F(IndexRegistryTest, AccessCountsSurviveLiveRuntimeManifestWrites) {
+    auto& registry = IndexRegistry::global();
+    auto config = make_config("geo");
+    ASSERT_TRUE(registry.register_index("geo", config));
+
+    auto insert = [](IndexDetails<DataRecord>* idx, int from, int to) {
+        for (int i = from; i < to; i++) {
+            auto* record = new DataRecord(2, 32, "row_" + std::to_string(i));
+            std::vector<double> pt = {double(i), double(i)};
+            record->putPoint(&pt);
+            idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), record);
+        }
+        idx->flush_dirty_buckets();
+        idx->getStore()->commit(0);
+    };
+
+    auto* idx = registry.get_or_load<DataRecord>("geo");
+    ASSERT_NE(idx, nullptr);
+    idx->ensure_root_initialized<DataRecord>();
+    insert(idx, 0, 50);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(registry.get_or_load<DataRecord>("geo"), idx);
+    }
+    const uint64_t count = registry.get_metadata("geo")->access_count.load();
+    EXPECT_EQ(registry.persist_access_counts(), 1u);
+
+    // The loaded index keeps writing its catalog and checkpoints
+    insert(idx, 50, 400);
+    idx->forceCheckpoint();
+
+    Manifest reloaded(config.data_dir);
+    ASSERT_TRUE(reloaded.load());
+    auto roots = reloaded.get_roots();
+    auto geo = std::find_if(roots.begin(), roots.end(),
+                            [](const Manifest::RootEntry& r) { return r.name == "geo"; });
+    ASSERT_NE(geo, roots.end());
+    EXPECT_EQ(geo->access_count, count);
+    EXPECT_GT(reloaded.get_checkpoint().epoch, 0u);
+    EXPECT_EQ(registry.persist_access_counts(), 0u);  // Nothing new
+}
@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * The Lucenia project is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Affero General
+ * Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with this program. If not, see:
+ * https://www.gnu.org/licenses/agpl-3.0.html
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/indexdetails.hpp"
+#include "../src/xtiter.h"
+
+using namespace xtree;
+
+// Counting allocator: global operator new counts calls made by a thread
+// while it has counting switched on. Everything else passes straight to malloc.
+namespace {
+    thread_local bool g_counting = false;
+    thread_local size_t g_allocations = 0;
+
+    struct AllocationCounter {
+        AllocationCounter() { g_allocations = 0; g_counting = true; }
+        ~AllocationCounter() { g_counting = false; }
+        size_t count() const { return g_allocations; }
+    };
+}
+
+void* operator new(size_t size) {
+    if (g_counting) g_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+TEST(SmallContainersTest, SpillAndReuse) {
+    SmallStack<int, 4> stack;
+    for (int i = 0; i < 10; i++) stack.push(i);
+    EXPECT_EQ(stack.size(), 10u);
+    EXPECT_GE(stack.capacity(), 10u);
+    for (int i = 9; i >= 0; i--) {
+        EXPECT_EQ(stack.top(), i);
+        stack.pop();
+    }
+    stack.clear();
+    EXPECT_GE(stack.capacity(), 10u);  // spilled buffer kept
+
+    // Wrap the ring around before it has to grow
+    SmallRing<int, 4> ring;
+    for (int i = 0; i < 3; i++) ring.push_back(i);
+    ring.pop_front();
+    ring.pop_front();
+    for (int i = 3; i < 12; i++) ring.push_back(i);
+    for (int i = 2; i < 12; i++) {
+        ASSERT_FALSE(ring.empty());
+        EXPECT_EQ(ring.front(), i);
+        ring.pop_front();
+    }
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.capacity(), 16u);
+}
+
+class IteratorPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        index = new IndexDetails<DataRecord>(
+            2, 32, &dimLabels, nullptr, nullptr, "iter_pool_test",
+            IndexDetails<DataRecord>::PersistenceMode::IN_MEMORY
+        );
+        index->ensure_root_initialized<DataRecord>();
+
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<> pos(0, 1000);
+        for (int i = 0; i < 5000; i++) {
+            DataRecord* dr = XAlloc<DataRecord>::allocate_record(index, 2, 32, "row_" + std::to_string(i));
+            std::vector<double> pt = {pos(gen), pos(gen)};
+            dr->putPoint(&pt);
+            index->root_bucket<DataRecord>()->xt_insert(index->root_cache_node(), dr);
+        }
+
+        // Query boxes from tiny to large, so some queries page through the queue
+        std::uniform_real_distribution<> size(1, 400);
+        for (int q = 0; q < 100; q++) {
+            auto query = std::make_unique<DataRecord>(2, 32, "q");
+            const double x = pos(gen), y = pos(gen), s = size(gen);
+            std::vector<double> lo = {x, y};
+            std::vector<double> hi = {x + s, y + s};
+            query->putPoint(&lo);
+            query->putPoint(&hi);
+            queries.push_back(std::move(query));
+        }
+    }
+
+    void TearDown() override {
+        queries.clear();
+        delete index;
+        IndexDetails<DataRecord>::clearCache();
+    }
+
+    template< typename Iter >
+    static size_t drain(Iter& iter) {
+        size_t n = 0;
+        std::string_view rid;
+        while (iter.nextRowID(rid)) n++;
+        return n;
+    }
+
+    std::vector<const char*> dimLabels = {"x", "y"};
+    IndexDetails<DataRecord>* index = nullptr;
+    std::vector<std::unique_ptr<DataRecord>> queries;
+};
+
+TEST_F(IteratorPoolTest, ResetReusesIteratorWithoutAllocating) {
+    auto* root = index->root_bucket<DataRecord>();
+    auto* rootNode = index->root_cache_node();
+
+    std::vector<size_t> expected;
+    for (auto& q : queries) {
+        Iterator<DataRecord>* iter = root->getIterator(rootNode, q.get(), INTERSECTS);
+        expected.push_back(drain(*iter));
+        delete iter;
+    }
+
+    // One stack-constructed iterator, warmed on every query once
+    Iterator<DataRecord> iter(rootNode, queries[0].get(), INTERSECTS, index);
+    for (auto& q : queries) {
+        iter.reset(rootNode, q.get(), INTERSECTS, index);
+        drain(iter);
+    }
+
+    AllocationCounter counter;
+    for (size_t i = 0; i < queries.size(); i++) {
+        iter.reset(rootNode, queries[i].get(), INTERSECTS, index);
+        ASSERT_EQ(drain(iter), expected[i]) << "query " << i;
+    }
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST_F(IteratorPoolTest, PooledQueriesAreAllocationFree) {
+    auto* root = index->root_bucket<DataRecord>();
+    auto* rootNode = index->root_cache_node();
+
+    std::vector<size_t> expected;
+    {
+        // The plain path allocates per query - and the counter sees it
+        AllocationCounter counter;
+        for (auto& q : queries) {
+            Iterator<DataRecord>* iter = root->getIterator(rootNode, q.get(), INTERSECTS);
+            expected.push_back(drain(*iter));
+            delete iter;
+        }
+        EXPECT_GE(counter.count(), queries.size());
+    }
+    for (auto& q : queries) {
+        auto iter = root->getPooledIterator(rootNode, q.get(), INTERSECTS);
+        drain(*iter);
+    }
+    EXPECT_GE(IteratorPool<DataRecord>::idleCount(), 1u);
+
+    AllocationCounter counter;
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto iter = root->getPooledIterator(rootNode, queries[i].get(), INTERSECTS);
+        ASSERT_EQ(drain(*iter), expected[i]) << "query " << i;
+    }
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST_F(IteratorPoolTest, PoolKeepsABoundedIdleList) {
+    auto* root = index->root_bucket<DataRecord>();
+    auto* rootNode = index->root_cache_node();
+
+    Iterator<DataRecord>* first = nullptr;
+    {
+        auto iter = root->getPooledIterator(rootNode, queries[0].get(), INTERSECTS);
+        first = iter.get();
+    }
+    {
+        // The released iterator is handed out again, reset for the new query
+        auto iter = root->getPooledIterator(rootNode, queries[1].get(), INTERSECTS);
+        EXPECT_EQ(iter.get(), first);
+    }
+
+    {
+        std::vector<PooledIterator<DataRecord>> held;
+        for (int i = 0; i < XTREE_ITER_POOL_SIZE + 4; i++) {
+            held.push_back(root->getPooledIterator(rootNode, queries[i].get(), INTERSECTS));
+        }
+    }
+    EXPECT_EQ(IteratorPool<DataRecord>::idleCount(), static_cast<size_t>(XTREE_ITER_POOL_SIZE));
+}
@@ -528,6 +528,132 @@ TEST_F(LruShardedTest, PowerOfTwoShardCount) {
     }
 }
 
+// ============= Per-Field Quotas =============
+
+TEST_F(LruShardedTest, PerFieldAccountingAndHitCounters) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+
+    for (int i = 0; i < 10; i++) cache->add(i, new int(i), true, "a");
+    for (int i = 10; i < 14; i++) cache->add(i, new int(i), true, "b");
+
+    auto* a = cache->fieldHandle("a");
+    ShardedCache::recordAccess(a, true);
+    ShardedCache::recordAccess(a, true);
+    ShardedCache::recordAccess(a, true);
+    ShardedCache::recordAccess(a, false);
+
+    auto usage = cache->getPerFieldUsage();
+    EXPECT_EQ(usage["a"].bytes, 1000u);
+    EXPECT_EQ(usage["a"].entries, 10u);
+    EXPECT_EQ(usage["b"].bytes, 400u);
+    EXPECT_DOUBLE_EQ(usage["a"].hitRate(), 0.75);
+
+    // Removal releases exactly what was charged
+    delete cache->removeById(10);
+    EXPECT_EQ(cache->getPerFieldMemory()["b"], 300u);
+}
+
+TEST_F(LruShardedTest, BurstOnOneFieldDoesNotEvictReservedField) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+    cache->setMaxMemory(2000);  // 20 entries
+
+    ShardedCache::FieldQuota hotQuota;
+    hotQuota.reservedBytes = 1000;
+    cache->setFieldQuota("hot", hotQuota);
+
+    for (int i = 0; i < 10; i++) cache->add(i, new int(i), true, "hot");
+    // Burst of 50 entries on another field
+    for (int i = 100; i < 150; i++) cache->add(i, new int(i), true, "burst");
+
+    cache->evictToMemoryBudget();
+
+    auto usage = cache->getPerFieldUsage();
+    EXPECT_LE(cache->getCurrentMemory(), 2000u);
+    EXPECT_EQ(usage["hot"].entries, 10u);    // Reservation protected
+    EXPECT_EQ(usage["burst"].entries, 10u);  // Burst absorbed the eviction
+    for (int i = 0; i < 10; i++) {
+        EXPECT_NE(cache->peek(i), nullptr);
+    }
+}
+
+TEST_F(LruShardedTest, BurstBehindDeepReservedEntriesIsStillFound) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+    cache->setMaxMemory(150000);  // 1500 entries
+
+    ShardedCache::FieldQuota hotQuota;
+    hotQuota.reservedBytes = 100000;
+    cache->setFieldQuota("hot", hotQuota);
+
+    // The reserved field fills the LRU end of every shard, hundreds deep
+    for (int i = 0; i < 1000; i++) cache->add(i, new int(i), true, "hot");
+    for (int i = 10000; i < 11000; i++) cache->add(i, new int(i), true, "burst");
+
+    EXPECT_EQ(cache->evictToMemoryBudget(), 500u);
+
+    auto usage = cache->getPerFieldUsage();
+    EXPECT_EQ(usage["hot"].entries, 1000u);
+    EXPECT_EQ(usage["burst"].entries, 500u);
+    EXPECT_EQ(cache->getCurrentMemory(), 150000u);
+}
+
+TEST_F(LruShardedTest, WeightedSharingOfLeftoverSpace) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+    cache->setMaxMemory(3000);  // 30 entries, no reservations
+
+    ShardedCache::FieldQuota heavy;
+    heavy.weight = 2.0;
+    cache->setFieldQuota("heavy", heavy);
+
+    for (int i = 0; i < 40; i++) cache->add(i, new int(i), true, "heavy");
+    for (int i = 100; i < 140; i++) cache->add(i, new int(i), true, "light");
+    // A small field that uses less than its share gives the rest back
+    for (int i = 200; i < 203; i++) cache->add(i, new int(i), true, "small");
+
+    cache->evictToMemoryBudget();
+
+    auto usage = cache->getPerFieldUsage();
+    EXPECT_EQ(usage["small"].entries, 3u);
+    // 2700 bytes left for heavy:light at 2:1
+    EXPECT_EQ(usage["heavy"].entries, 18u);
+    EXPECT_EQ(usage["light"].entries, 9u);
+}
+
+TEST_F(LruShardedTest, FieldHardLimitWithoutGlobalBudget) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+
+    ShardedCache::FieldQuota capped;
+    capped.limitBytes = 500;
+    cache->setFieldQuota("capped", capped);
+
+    for (int i = 0; i < 20; i++) cache->add(i, new int(i), true, "capped");
+    for (int i = 100; i < 120; i++) cache->add(i, new int(i), true, "free");
+
+    cache->evictToMemoryBudget();
+
+    auto usage = cache->getPerFieldUsage();
+    EXPECT_EQ(usage["capped"].entries, 5u);
+    EXPECT_EQ(usage["free"].entries, 20u);
+}
+
+TEST_F(LruShardedTest, PinnedFieldFallsBackToGlobalEviction) {
+    cache->setMemorySizer([](const int*) -> size_t { return 100; });
+    cache->setMaxMemory(1000);
+
+    std::vector<ShardedCache::Node*> pinned;
+    for (int i = 0; i < 15; i++) {
+        pinned.push_back(cache->add(i, new int(i), true, "pinned"));
+        cache->pin(pinned.back(), i);
+    }
+    for (int i = 100; i < 105; i++) cache->add(i, new int(i), true, "other");
+
+    // "pinned" is over its share but nothing of it can go; the budget is
+    // still enforced as far as possible from the rest of the cache
+    EXPECT_EQ(cache->evictToMemoryBudget(), 5u);
+    EXPECT_EQ(cache->getPerFieldUsage()["other"].entries, 0u);
+
+    for (int i = 0; i < 15; i++) cache->unpin(pinned[i], i);
+}
+
 // ============= Edge Cases =============
 
 TEST_F(LruShardedTest, EmptyShardOperations) {
@@ -337,6 +337,103 @@ TEST_F(MemoryCoordinatorTest, IntegrationWithMappingManager) {
     EXPECT_EQ(mmap_budget, expected_mmap);
 }
 
+// ============================================================================
+// Miss Ratio Curve Rebalancing
+// ============================================================================
+
+class MemoryCoordinatorMrcTest : public MemoryCoordinatorTest {
+protected:
+    void SetUp() override {
+        MemoryCoordinatorTest::SetUp();
+        // Sample every reference so small synthetic loops give exact curves
+        cacheCurve().configure(1.0, MissRatioCurve::kDefaultMaxTracked);
+        mmapCurve().configure(1.0, MissRatioCurve::kDefaultMaxTracked);
+    }
+
+    void TearDown() override {
+        cacheCurve().configure(MissRatioCurve::kDefaultSamplingRate,
+                               MissRatioCurve::kDefaultMaxTracked);
+        mmapCurve().configure(MissRatioCurve::kDefaultSamplingRate,
+                              MissRatioCurve::kDefaultMaxTracked);
+        MemoryCoordinatorTest::TearDown();
+    }
+
+    static MissRatioCurve& cacheCurve() {
+        return IndexDetails<IRecord>::getCache().missRatioCurve();
+    }
+
+    static MissRatioCurve& mmapCurve() {
+        return MappingManager::global().extent_curve();
+    }
+
+    // Cyclic loop over a working set of the given size
+    static void loop(MissRatioCurve& curve, size_t working_set, size_t entry, int passes) {
+        for (int p = 0; p < passes; ++p) {
+            for (uint64_t k = 0; k < working_set / entry; ++k) {
+                curve.access(k, entry);
+            }
+        }
+    }
+};
+
+TEST_F(MemoryCoordinatorMrcTest, MovesMemoryToCacheWhenItGainsMoreHitsPerByte) {
+    auto& coord = MemoryCoordinator::global();
+    const size_t budget = 100 * 1024 * 1024;  // cache 40MB, mmap 60MB
+    coord.set_total_budget(budget);
+
+    // Cache loop of 42MB misses at 40MB but fits after one 5% step;
+    // mmap loop of 30MB already fits, so shrinking mmap costs nothing
+    loop(cacheCurve(), 42 * 1024 * 1024, 64 * 1024, 4);
+    loop(mmapCurve(), 30 * 1024 * 1024, 1024 * 1024, 4);
+
+    coord.force_rebalance();
+
+    auto metrics = coord.get_metrics();
+    EXPECT_TRUE(metrics.mrc_driven);
+    EXPECT_GT(metrics.cache_hits_per_byte, metrics.mmap_hits_per_byte);
+    EXPECT_NEAR(coord.get_cache_ratio(), 0.45f, 0.001f);
+    EXPECT_EQ(coord.get_rebalance_count(), 1u);
+}
+
+TEST_F(MemoryCoordinatorMrcTest, MovesMemoryToMmapWhenItGainsMoreHitsPerByte) {
+    auto& coord = MemoryCoordinator::global();
+    const size_t budget = 100 * 1024 * 1024;
+    coord.set_total_budget(budget);
+
+    // mmap loop of 62MB fits after one step; cache loop of 10MB fits with room to spare
+    loop(mmapCurve(), 62 * 1024 * 1024, 1024 * 1024, 4);
+    loop(cacheCurve(), 10 * 1024 * 1024, 64 * 1024, 4);
+
+    coord.force_rebalance();
+
+    EXPECT_TRUE(coord.get_metrics().mrc_driven);
+    EXPECT_NEAR(coord.get_mmap_ratio(), 0.65f, 0.001f);
+}
+
+TEST_F(MemoryCoordinatorMrcTest, HoldsSteadyWhenNeitherTierGains) {
+    auto& coord = MemoryCoordinator::global();
+    coord.set_total_budget(100 * 1024 * 1024);
+
+    // Both working sets fit comfortably
+    loop(cacheCurve(), 8 * 1024 * 1024, 64 * 1024, 4);
+    loop(mmapCurve(), 16 * 1024 * 1024, 1024 * 1024, 4);
+
+    coord.force_rebalance();
+
+    EXPECT_TRUE(coord.get_metrics().mrc_driven);
+    EXPECT_FLOAT_EQ(coord.get_cache_ratio(), 0.40f);
+    EXPECT_EQ(coord.get_rebalance_count(), 0u);
+}
+
+TEST_F(MemoryCoordinatorMrcTest, FallsBackToPressureWithoutSamples) {
+    auto& coord = MemoryCoordinator::global();
+    coord.set_total_budget(100 * 1024 * 1024);
+
+    coord.force_rebalance();
+
+    EXPECT_FALSE(coord.get_metrics().mrc_driven);
+}
+
 // ============================================================================
 // Edge Cases
 // ============================================================================
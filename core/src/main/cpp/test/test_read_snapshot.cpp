@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Point-in-time queries through ReadSnapshot while the writer keeps committing
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../src/xtree.h"
+#include "../src/xtree.hpp"
+#include "../src/indexdetails.hpp"
+#include "../src/xtiter.h"
+#include "../src/xtsnapshot.h"
+#include "../src/persistence/durable_store.h"
+
+namespace xtree {
+
+class ReadSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = "/tmp/xtree_read_snapshot_" + std::to_string(getpid());
+        std::filesystem::remove_all(test_dir_);
+        std::filesystem::create_directories(test_dir_);
+        IndexDetails<DataRecord>::clearCache();
+
+        query_.putPoint(&query_min_);
+        query_.putPoint(&query_max_);
+    }
+
+    void TearDown() override {
+        IndexDetails<DataRecord>::clearCache();
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    std::unique_ptr<IndexDetails<DataRecord>> openIndex(const std::string& name) {
+        auto index = std::make_unique<IndexDetails<DataRecord>>(
+            2, 32, &dim_ptrs_, nullptr, nullptr, name,
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE, test_dir_);
+        index->ensure_root_initialized<DataRecord>();
+        index->getStore()->commit(0);
+        return index;
+    }
+
+    // Buckets are written back in batches; a commit covers what was flushed
+    static void commit(IndexDetails<DataRecord>& index) {
+        index.flush_dirty_buckets();
+        index.getStore()->commit(0);
+    }
+
+    // Points on a 60-wide grid, rows [first, first + n / 60)
+    void insertGrid(IndexDetails<DataRecord>& index, int first, int n, const std::string& prefix) {
+        for (int i = 0; i < n; ++i) {
+            auto* dr = new DataRecord(2, 32, prefix + std::to_string(i));
+            std::vector<double> pt = {static_cast<double>(i % 60), static_cast<double>(first + i / 60)};
+            dr->putPoint(&pt);
+            index.root_bucket<DataRecord>()->xt_insert(index.root_cache_node(), dr);
+        }
+    }
+
+    std::set<std::string> liveQuery(IndexDetails<DataRecord>& index) {
+        std::set<std::string> rows;
+        auto* iter = index.root_bucket<DataRecord>()->getIterator(index.root_cache_node(), &query_, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) rows.insert(std::string(rid));
+        delete iter;
+        return rows;
+    }
+
+    std::set<std::string> snapshotQuery(const ReadSnapshot<DataRecord>& snap) {
+        std::set<std::string> rows;
+        snap.forEach(&query_, INTERSECTS, [&](std::string_view rid) { rows.insert(std::string(rid)); });
+        return rows;
+    }
+
+    static persist::SnapshotRegistry& registry(IndexDetails<DataRecord>& index) {
+        return dynamic_cast<persist::DurableStore*>(index.getStore())->snapshots();
+    }
+
+    std::string test_dir_;
+    std::vector<const char*> dim_ptrs_ = {"x", "y"};
+    std::vector<double> query_min_ = {10.0, 5.0};
+    std::vector<double> query_max_ = {40.0, 60.0};
+    DataRecord query_{2, 32, "query"};
+};
+
+TEST_F(ReadSnapshotTest, SeesTreeAsOfItsEpoch) {
+    auto index = openIndex("snap_epoch");
+    insertGrid(*index, 0, 1800, "a_");
+    commit(*index);
+
+    auto before = std::make_unique<ReadSnapshot<DataRecord>>(index.get());
+    const auto atOpen = liveQuery(*index);
+    ASSERT_EQ(atOpen.size(), 31u * 25u);   // rows 5..29 of the first grid
+    EXPECT_EQ(snapshotQuery(*before), atOpen);
+
+    // Grow the tree across the query box: splits and in-place republishes
+    // happen behind the snapshot
+    insertGrid(*index, 20, 1800, "b_");
+    commit(*index);
+    EXPECT_GT(registry(*index).shadow_count(), 0u);
+
+    const auto now = liveQuery(*index);
+    EXPECT_GT(now.size(), atOpen.size());
+    EXPECT_EQ(snapshotQuery(*before), atOpen);
+
+    ReadSnapshot<DataRecord> after(index.get());
+    EXPECT_GT(after.epoch(), before->epoch());
+    EXPECT_EQ(snapshotQuery(after), now);
+
+    // Nothing older than the remaining snapshot is kept
+    before.reset();
+    EXPECT_EQ(registry(*index).shadow_count(), 0u);
+    EXPECT_EQ(registry(*index).active_snapshots(), 1u);
+}
+
+TEST_F(ReadSnapshotTest, ReaderRunsWhileWriterCommits) {
+    auto index = openIndex("snap_concurrent");
+    insertGrid(*index, 0, 2000, "a_");
+    commit(*index);
+
+    ReadSnapshot<DataRecord> snap(index.get());
+    const auto expected = liveQuery(*index);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+    std::atomic<int> queries{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            if (snapshotQuery(snap) != expected) mismatches++;
+            queries++;
+        }
+    });
+
+    for (int batch = 0; batch < 10; ++batch) {
+        insertGrid(*index, 10 + batch * 5, 300, "w" + std::to_string(batch) + "_");
+        commit(*index);
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_GT(queries.load(), 0);
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(snapshotQuery(snap), expected);
+}
+
+TEST_F(ReadSnapshotTest, RetainedCommitsOpenByEpoch) {
+    auto index = openIndex("snap_retained");
+    registry(*index).set_retained_commits(3);
+
+    std::map<uint64_t, std::set<std::string>> history;
+    for (int batch = 0; batch < 6; ++batch) {
+        insertGrid(*index, batch * 10, 600, "r" + std::to_string(batch) + "_");
+        commit(*index);
+        ReadSnapshot<DataRecord> latest(index.get());
+        history[latest.epoch()] = liveQuery(*index);
+    }
+
+    size_t opened = 0;
+    for (const auto& [epoch, rows] : history) {
+        if (epoch < registry(*index).oldest_retained()) {
+            EXPECT_THROW({ ReadSnapshot<DataRecord> snap(index.get(), epoch); }, std::runtime_error);
+            continue;
+        }
+        ReadSnapshot<DataRecord> snap(index.get(), epoch);
+        EXPECT_EQ(snapshotQuery(snap), rows) << "epoch " << epoch;
+        opened++;
+    }
+    EXPECT_EQ(opened, 3u);
+
+    // Turning retention off gives the old versions back
+    registry(*index).set_retained_commits(0);
+    EXPECT_EQ(registry(*index).shadow_count(), 0u);
+    EXPECT_THROW({ ReadSnapshot<DataRecord> snap(index.get(), history.rbegin()->first - 1); },
+                 std::runtime_error);
+}
+
+TEST_F(ReadSnapshotTest, RejectsUnsupportedOpens) {
+    auto index = openIndex("snap_reject");
+    insertGrid(*index, 0, 100, "a_");
+    // This thread's own batch would never commit while it waits
+    EXPECT_THROW({ ReadSnapshot<DataRecord> snap(index.get()); }, std::logic_error);
+    commit(*index);
+    EXPECT_NO_THROW({ ReadSnapshot<DataRecord> snap(index.get()); });
+
+    IndexDetails<DataRecord> memory(2, 32, &dim_ptrs_, nullptr, nullptr, "snap_memory");
+    EXPECT_THROW({ ReadSnapshot<DataRecord> snap(&memory); }, std::runtime_error);
+}
+
+} // namespace xtree
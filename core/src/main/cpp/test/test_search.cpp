@@ -20,10 +20,22 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
 #include "../src/xtree.h"
 #include "../src/xtree.hpp"
 #include "../src/indexdetails.hpp"
 #include "../src/xtiter.h"
+#include "../src/xtparallel.h"
+#include "../src/xtmulti.h"
+#include "../src/xtaggregate.h"
+#include "../src/xtjoin.h"
 
 using namespace xtree;
 using namespace std;
@@ -413,6 +425,497 @@ TEST_F(TreeSearchTest, SearchNoRecords) {
     delete searchRecord;
 }
 
+TEST(IteratorBatchTest, BatchRowIDsMatchNextRowID) {
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* idx = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_batch");
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+
+    const int N = 400;  // Splits the root and spans several iterator pages
+    for (int i = 0; i < N; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i % 20), static_cast<double>(i / 20)};
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+    }
+    auto* cachedRoot = idx->root_cache_node();
+    auto* root = idx->root_bucket<DataRecord>();
+
+    DataRecord* searchRecord = new DataRecord(2, 32, "search");
+    vector<double> searchMin = {2.0, 2.0};
+    vector<double> searchMax = {9.0, 7.0};
+    searchRecord->putPoint(&searchMin);
+    searchRecord->putPoint(&searchMax);
+
+    multiset<string> expected;
+    auto iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    std::string_view rid;
+    while (iter->nextRowID(rid)) expected.insert(string(rid));
+    delete iter;
+    ASSERT_GT(expected.size(), static_cast<size_t>(XTREE_ITER_PAGE_SIZE) / 4);
+
+    // Small buffers force both the row limit and the byte limit to kick in
+    char out[40];
+    uint32_t ends[7];
+    float keys[7 * 4];
+    multiset<string> found;
+    iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    while (size_t n = iter->nextBatch(out, sizeof(out), ends, 7, keys)) {
+        EXPECT_LE(n, 7u);
+        uint32_t start = 0;
+        for (size_t i = 0; i < n; i++) {
+            found.insert(string(out + start, ends[i] - start));
+            start = ends[i];
+            // Each key is the record's point: x in [2,9], y in [2,7]
+            EXPECT_GE(keys[i * 4 + 0], 2.0f - 1e-3f);
+            EXPECT_LE(keys[i * 4 + 1], 9.0f + 1e-3f);
+            EXPECT_GE(keys[i * 4 + 2], 2.0f - 1e-3f);
+            EXPECT_LE(keys[i * 4 + 3], 7.0f + 1e-3f);
+        }
+    }
+    EXPECT_EQ(found, expected);
+    EXPECT_EQ(iter->nextBatch(out, sizeof(out), ends, 7), 0u);
+
+    // A row ID that can never fit is an error, not silent truncation
+    delete iter;
+    iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    EXPECT_THROW(iter->nextBatch(out, 2, ends, 7), std::length_error);
+
+    delete iter;
+    delete searchRecord;
+    delete idx;
+    IndexDetails<DataRecord>::clearCache();
+}
+
+TEST_F(TreeSearchTest, BatchExactRefinementDropsFloatFalsePositives) {
+    // Just outside the query box in double precision, but inside once the
+    // key is rounded out to float
+    DataRecord* outside = new DataRecord(2, 32, "outside");
+    vector<double> p1 = {1.0 + 1e-9, 0.5};
+    outside->putPoint(&p1);
+    root->xt_insert(cachedRoot, outside);
+
+    DataRecord* inside = new DataRecord(2, 32, "inside");
+    vector<double> p2 = {1.0, 0.5};
+    inside->putPoint(&p2);
+    root->xt_insert(cachedRoot, inside);
+
+    DataRecord* searchRecord = new DataRecord(2, 32, "search");
+    vector<double> searchMin = {0.0, 0.0};
+    vector<double> searchMax = {1.0, 1.0};
+    searchRecord->putPoint(&searchMin);
+    searchRecord->putPoint(&searchMax);
+
+    char out[64];
+    uint32_t ends[8];
+
+    auto iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    EXPECT_EQ(iter->nextBatch(out, sizeof(out), ends, 8), 2u);  // MBR test only
+    delete iter;
+
+    iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    iter->setExactRefinement(true);
+    ASSERT_EQ(iter->nextBatch(out, sizeof(out), ends, 8), 1u);
+    EXPECT_EQ(string(out, ends[0]), "inside");
+    delete iter;
+
+    delete searchRecord;
+}
+
+TEST(ParallelQueryTest, MatchesSingleIterator) {
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* idx = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_parallel");
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+
+    const int N = 3000;  // Deep enough for the frontier to split below the root
+    for (int i = 0; i < N; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i % 60), static_cast<double>(i / 60)};
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+    }
+    auto* cachedRoot = idx->root_cache_node();
+    auto* root = idx->root_bucket<DataRecord>();
+
+    DataRecord* searchRecord = new DataRecord(2, 32, "search");
+    vector<double> searchMin = {5.0, 3.0};
+    vector<double> searchMax = {44.0, 38.0};
+    searchRecord->putPoint(&searchMin);
+    searchRecord->putPoint(&searchMax);
+
+    vector<string> expected;
+    auto iter = root->getIterator(cachedRoot, searchRecord, INTERSECTS);
+    std::string_view rid;
+    while (iter->nextRowID(rid)) expected.push_back(string(rid));
+    delete iter;
+    ASSERT_EQ(expected.size(), 40u * 36u);
+
+    for (size_t threads : {1u, 3u, 8u}) {
+        ParallelQueryExecutor<DataRecord> exec(idx, threads);
+
+        auto ordered = exec.execute(cachedRoot, searchRecord, INTERSECTS,
+                                    ParallelQueryExecutor<DataRecord>::Merge::ORDERED);
+        EXPECT_GT(exec.lastTaskCount(), 1u) << threads << " threads";
+        ASSERT_EQ(ordered.size(), expected.size());
+        vector<string> got;
+        ordered.forEach([&got](std::string_view id) { got.push_back(string(id)); });
+        EXPECT_EQ(got, expected) << threads << " threads";
+
+        auto unordered = exec.execute(cachedRoot, searchRecord, INTERSECTS);
+        multiset<string> gotSet;
+        for (auto id : unordered.rowIDs()) gotSet.insert(string(id));
+        EXPECT_EQ(gotSet, multiset<string>(expected.begin(), expected.end()));
+    }
+
+    // A query outside the data returns nothing
+    DataRecord* missRecord = new DataRecord(2, 32, "miss");
+    vector<double> missMin = {500.0, 500.0};
+    vector<double> missMax = {600.0, 600.0};
+    missRecord->putPoint(&missMin);
+    missRecord->putPoint(&missMax);
+    ParallelQueryExecutor<DataRecord> exec(idx, 4);
+    EXPECT_TRUE(exec.execute(cachedRoot, missRecord, INTERSECTS).empty());
+
+    delete missRecord;
+    delete searchRecord;
+    delete idx;
+    IndexDetails<DataRecord>::clearCache();
+}
+
+TEST(ParallelQueryTest, ConcurrentQueriesOnEvictingDurableIndex) {
+    // Several executors share the upper levels of the tree, so their workers
+    // resolve the same child entries through cache_or_load() at once while
+    // the cache has a budget (the path that revalidates _cache_ptr)
+    namespace fs = std::filesystem;
+    const std::string dir = "./test_parallel_durable_" + to_string(::getpid());
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    IndexDetails<DataRecord>::clearCache();
+    ASSERT_TRUE(IndexDetails<DataRecord>::applyCachePolicy("100KB"));
+
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* idx = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_parallel_durable",
+                                             IndexDetails<DataRecord>::PersistenceMode::DURABLE, dir);
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+    auto* store = idx->getStore();
+    ASSERT_NE(store, nullptr);
+    store->commit(0);
+    idx->invalidate_root_cache();
+
+    const int N = 3000;
+    for (int i = 0; i < N; i++) {
+        auto* dr = XAlloc<DataRecord>::allocate_record(idx, 2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i % 60), static_cast<double>(i / 60)};
+        dr->putPoint(&p);
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+        if ((i + 1) % 500 == 0) {
+            // Buckets must be persisted before they can be evicted
+            idx->flush_dirty_buckets();
+            store->commit((i + 1) / 500);
+            IndexDetails<DataRecord>::evictCacheToMemoryBudget();
+        }
+    }
+    ASSERT_GT(IndexDetails<DataRecord>::getCacheMaxMemory(), 0u);
+
+    DataRecord* searchRecord = new DataRecord(2, 32, "search");
+    vector<double> searchMin = {5.0, 3.0};
+    vector<double> searchMax = {44.0, 38.0};
+    searchRecord->putPoint(&searchMin);
+    searchRecord->putPoint(&searchMax);
+
+    vector<string> expected;
+    {
+        auto* iter = idx->root_bucket<DataRecord>()->getIterator(idx->root_cache_node(), searchRecord, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) expected.push_back(string(rid));
+        delete iter;
+    }
+    ASSERT_EQ(expected.size(), 40u * 36u);
+
+    for (int round = 0; round < 3; round++) {
+        // Start every round cold so the workers race on reloads too
+        IndexDetails<DataRecord>::evictCacheToMemoryBudget();
+        auto* cachedRoot = idx->root_cache_node();
+
+        const int kQueries = 4;
+        vector<vector<string>> got(kQueries);
+        vector<thread> threads;
+        for (int q = 0; q < kQueries; q++) {
+            threads.emplace_back([&, q]() {
+                ParallelQueryExecutor<DataRecord> exec(idx, 2);
+                auto result = exec.execute(cachedRoot, searchRecord, INTERSECTS,
+                                           ParallelQueryExecutor<DataRecord>::Merge::ORDERED);
+                result.forEach([&got, q](std::string_view id) { got[q].push_back(string(id)); });
+            });
+        }
+        for (auto& t : threads) t.join();
+        for (int q = 0; q < kQueries; q++) {
+            EXPECT_EQ(got[q], expected) << "round " << round << " query " << q;
+        }
+    }
+
+    delete searchRecord;
+    delete idx;
+    IndexDetails<DataRecord>::applyCachePolicy("unlimited");
+    IndexDetails<DataRecord>::clearCache();
+    fs::remove_all(dir);
+}
+
+TEST_F(TreeSearchTest, ParallelQueryOnLeafRoot) {
+    // A root that is still a leaf is a single task
+    for (int i = 0; i < 5; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i), static_cast<double>(i)};
+        dr->putPoint(&p);
+        root->xt_insert(cachedRoot, dr);
+    }
+
+    DataRecord* searchRecord = new DataRecord(2, 32, "search");
+    vector<double> searchMin = {1.0, 1.0};
+    vector<double> searchMax = {3.0, 3.0};
+    searchRecord->putPoint(&searchMin);
+    searchRecord->putPoint(&searchMax);
+
+    ParallelQueryExecutor<DataRecord> exec(idx, 4);
+    auto result = exec.execute(cachedRoot, searchRecord, INTERSECTS,
+                               ParallelQueryExecutor<DataRecord>::Merge::ORDERED);
+    EXPECT_EQ(exec.lastTaskCount(), 1u);
+    vector<std::string_view> ids = result.rowIDs();
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(ids[0], "row1");
+    EXPECT_EQ(ids[1], "row2");
+    EXPECT_EQ(ids[2], "row3");
+
+    delete searchRecord;
+}
+
+TEST(MultiQueryTest, BatchMatchesPerQueryIterators) {
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* idx = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_multi");
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+
+    const int N = 3000;
+    for (int i = 0; i < N; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i % 60), static_cast<double>(i / 60)};
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+    }
+    auto* cachedRoot = idx->root_cache_node();
+    auto* root = idx->root_bucket<DataRecord>();
+
+    // Small boxes, overlapping each other, some past the edge of the data
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> pos(-5.0, 60.0);
+    vector<DataRecord*> queries;
+    for (int q = 0; q < 200; q++) {
+        auto* qr = new DataRecord(2, 32, "q" + to_string(q));
+        vector<double> lo = {pos(rng), pos(rng) * 50.0 / 60.0};
+        vector<double> hi = {lo[0] + 3.5, lo[1] + 2.5};
+        qr->putPoint(&lo);
+        qr->putPoint(&hi);
+        queries.push_back(qr);
+    }
+
+    map<uint32_t, multiset<string>> expected;
+    size_t total = 0;
+    for (size_t q = 0; q < queries.size(); q++) {
+        auto iter = root->getIterator(cachedRoot, queries[q], INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) {
+            expected[static_cast<uint32_t>(q)].insert(string(rid));
+            total++;
+        }
+        delete iter;
+    }
+    ASSERT_GT(total, queries.size());
+
+    MultiQueryExecutor<DataRecord> exec(idx);
+    auto result = exec.execute(cachedRoot, vector<IRecord*>(queries.begin(), queries.end()), INTERSECTS);
+    ASSERT_EQ(result.size(), total);
+    map<uint32_t, multiset<string>> got;
+    result.forEach([&got](uint32_t q, std::string_view id) { got[q].insert(string(id)); });
+    EXPECT_EQ(got, expected);
+
+    // Upper levels are tested once per batch, not once per query
+    EXPECT_GT(exec.lastNodesVisited(), 0u);
+
+    // WITHIN keeps only records inside the box; for points that is the same set
+    auto within = exec.execute(cachedRoot, vector<IRecord*>(queries.begin(), queries.end()), WITHIN);
+    EXPECT_EQ(within.size(), total);
+
+    // CONTAINS: only a record whose box covers the whole query - no point does
+    auto contains = exec.execute(cachedRoot, vector<IRecord*>(queries.begin(), queries.end()), CONTAINS);
+    EXPECT_TRUE(contains.empty());
+
+    EXPECT_TRUE(exec.execute(cachedRoot, nullptr, 0).empty());
+
+    for (auto* q : queries) delete q;
+    delete idx;
+    IndexDetails<DataRecord>::clearCache();
+}
+
+TEST(AggregateQueryTest, CountsAndHistogramsMatchIterator) {
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* idx = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_aggregate");
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+
+    const int N = 3000;
+    vector<pair<double, double>> points;
+    for (int i = 0; i < N; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "row" + to_string(i));
+        vector<double> p = {static_cast<double>(i % 60), static_cast<double>(i / 60)};
+        points.emplace_back(p[0], p[1]);
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+    }
+    auto* cachedRoot = idx->root_cache_node();
+    auto* root = idx->root_bucket<DataRecord>();
+    ASSERT_FALSE(root->getIsLeaf());
+    EXPECT_EQ(root->subtreeCount(), static_cast<uint64_t>(N));
+
+    AggregateQueryExecutor<DataRecord> agg(idx);
+    auto makeBox = [](double x0, double y0, double x1, double y1) {
+        auto* q = new DataRecord(2, 32, "q");
+        vector<double> lo = {x0, y0};
+        vector<double> hi = {x1, y1};
+        q->putPoint(&lo);
+        q->putPoint(&hi);
+        return q;
+    };
+
+    // A box around everything is answered from the root's entries alone
+    auto* all = makeBox(-1.0, -1.0, 100.0, 100.0);
+    EXPECT_EQ(agg.count(cachedRoot, all), static_cast<uint64_t>(N));
+    EXPECT_EQ(agg.lastNodesVisited(), 1u);
+    delete all;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> pos(-5.0, 55.0);
+    for (int q = 0; q < 50; q++) {
+        const double x0 = pos(rng), y0 = pos(rng) * 50.0 / 60.0;
+        auto* box = makeBox(x0, y0, x0 + 2.0 + q, y0 + 1.5 + q / 2.0);
+
+        uint64_t expected = 0;
+        auto iter = root->getIterator(cachedRoot, box, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) expected++;
+        delete iter;
+        EXPECT_EQ(agg.count(cachedRoot, box), expected) << "query " << q;
+        delete box;
+    }
+
+    // 6 x 5 heatmap: cell i*5+j covers x in [10i, 10i+10), y in [10j, 10j+10)
+    auto* area = makeBox(0.0, 0.0, 60.0, 50.0);
+    auto counts = agg.histogram(cachedRoot, area, {6, 5});
+    ASSERT_EQ(counts.size(), 30u);
+    vector<uint64_t> expected(30, 0);
+    for (const auto& p : points) {
+        const int i = std::min(5, static_cast<int>(p.first / 10.0));
+        const int j = std::min(4, static_cast<int>(p.second / 10.0));
+        expected[i * 5 + j]++;
+    }
+    EXPECT_EQ(counts, expected);
+    EXPECT_GT(agg.lastSubtreesCounted(), 0u);
+
+    EXPECT_THROW(agg.histogram(cachedRoot, area, {2, 2, 2}), std::runtime_error);
+    EXPECT_THROW(agg.histogram(cachedRoot, area, {0, 2}), std::runtime_error);
+    delete area;
+
+    delete idx;
+    IndexDetails<DataRecord>::clearCache();
+}
+
+TEST(SpatialJoinTest, MatchesNestedLoopQueries) {
+    vector<const char*> dimLabels = {"x", "y"};
+    auto* events = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_join_events");
+    auto* zones = new IndexDetails<DataRecord>(2, 32, &dimLabels, nullptr, nullptr, "test_join_zones");
+    ASSERT_TRUE(events->ensure_root_initialized<DataRecord>());
+    ASSERT_TRUE(zones->ensure_root_initialized<DataRecord>());
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> pos(0.0, 100.0);
+    vector<vector<double>> eventBoxes, zoneBoxes;
+    for (int i = 0; i < 2000; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "e" + to_string(i));
+        vector<double> p = {pos(rng), pos(rng)};
+        dr->putPoint(&p);
+        eventBoxes.push_back({p[0], p[0], p[1], p[1]});
+        events->root_bucket<DataRecord>()->xt_insert(events->root_cache_node(), dr);
+    }
+    for (int i = 0; i < 300; i++) {
+        DataRecord* dr = new DataRecord(2, 32, "z" + to_string(i));
+        vector<double> lo = {pos(rng), pos(rng)};
+        vector<double> hi = {lo[0] + 4.0, lo[1] + 3.0};
+        dr->putPoint(&lo);
+        dr->putPoint(&hi);
+        zoneBoxes.push_back({lo[0], hi[0], lo[1], hi[1]});
+        zones->root_bucket<DataRecord>()->xt_insert(zones->root_cache_node(), dr);
+    }
+    auto* eventRoot = events->root_cache_node();
+    auto* zoneRoot = zones->root_cache_node();
+
+    // Nested loop: one query against the zones per event
+    set<pair<string, string>> expected;
+    for (int i = 0; i < 2000; i++) {
+        auto* q = new DataRecord(2, 32, "q");
+        vector<double> p = {eventBoxes[i][0], eventBoxes[i][2]};
+        q->putPoint(&p);
+        auto iter = zones->root_bucket<DataRecord>()->getIterator(zoneRoot, q, INTERSECTS);
+        std::string_view rid;
+        while (iter->nextRowID(rid)) expected.emplace("e" + to_string(i), string(rid));
+        delete iter;
+        delete q;
+    }
+    ASSERT_GT(expected.size(), 100u);
+
+    for (size_t threads : {1u, 3u}) {
+        SpatialJoinExecutor<DataRecord> join(events, zones, threads);
+        set<pair<string, string>> got;
+        const uint64_t n = join.join(eventRoot, zoneRoot, [&got](std::string_view e, std::string_view z) {
+            EXPECT_TRUE(got.emplace(string(e), string(z)).second) << "duplicate pair";
+        });
+        EXPECT_EQ(n, got.size());
+        EXPECT_EQ(got, expected) << threads << " threads";
+        EXPECT_GT(join.lastTaskCount(), 0u);
+    }
+
+    // Distance join against brute force over the inserted boxes (float keys,
+    // so pairs right at the threshold are left out of the comparison)
+    const double D = 2.5;
+    auto boxDistance = [](const vector<double>& a, const vector<double>& b) {
+        double sq = 0;
+        for (int d = 0; d < 2; d++) {
+            const double gap = std::max({0.0, a[2 * d] - b[2 * d + 1], b[2 * d] - a[2 * d + 1]});
+            sq += gap * gap;
+        }
+        return std::sqrt(sq);
+    };
+    SpatialJoinExecutor<DataRecord> join(events, zones, 2);
+    set<pair<string, string>> got;
+    join.joinWithinDistance(eventRoot, zoneRoot, D, [&got](std::string_view e, std::string_view z) {
+        got.emplace(string(e), string(z));
+    });
+    size_t near = 0;
+    for (int i = 0; i < 2000; i++) {
+        for (int j = 0; j < 300; j++) {
+            const double dist = boxDistance(eventBoxes[i], zoneBoxes[j]);
+            const bool found = got.count({"e" + to_string(i), "z" + to_string(j)}) > 0;
+            if (dist < D - 1e-3) {
+                EXPECT_TRUE(found) << i << " " << j;
+                near++;
+            } else if (dist > D + 1e-3) {
+                EXPECT_FALSE(found) << i << " " << j;
+            }
+        }
+    }
+    EXPECT_GT(near, expected.size()) << got.size() << " " << join.lastNodePairs() << " " << join.lastTaskCount();
+
+    delete events;
+    delete zones;
+    IndexDetails<DataRecord>::clearCache();
+}
+
 // Performance Tests
 TEST(IntersectionPerformanceTest, HighVolumeIntersectionChecks) {
     const int NUM_ITERATIONS = 100000;
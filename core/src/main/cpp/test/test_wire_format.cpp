@@ -208,6 +208,40 @@ TEST_F(WireFormatTest, TreeStructurePreservation) {
     delete restored;
 }
 
+// Subtree counts of bucket children survive a roundtrip; entries written
+// without one load as unknown
+TEST_F(WireFormatTest, SubtreeCountsRoundtrip) {
+    ASSERT_TRUE(idx->ensure_root_initialized<DataRecord>());
+    for (int i = 0; i < 500; i++) {
+        DataRecord* dr = new DataRecord(dimensions, precision, "record_" + std::to_string(i));
+        std::vector<double> p = {static_cast<double>(i % 25), static_cast<double>(i / 25)};
+        dr->putPoint(&p);
+        idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+    }
+    auto* root = idx->root_bucket<DataRecord>();
+    ASSERT_FALSE(root->getIsLeaf());
+    ASSERT_EQ(root->subtreeCount(), 500u);
+
+    size_t wireSize = root->wire_size(*idx);
+    std::vector<uint8_t> buffer(wireSize);
+    ASSERT_EQ(root->to_wire(buffer.data(), *idx) - buffer.data(), wireSize);
+
+    XTreeBucket<DataRecord>* restored = new XTreeBucket<DataRecord>(idx, /*isRoot*/true);
+    ASSERT_EQ(restored->from_wire(buffer.data(), idx) - buffer.data(), wireSize);
+    ASSERT_EQ(restored->n(), root->n());
+    EXPECT_EQ(restored->subtreeCount(), 500u);
+
+    // Clear the "count present" flag of the first child, as an older writer left it
+    const size_t flagsOffset = 1 + 2 + 4 + 2 * dimensions * sizeof(float) + 8;
+    buffer[flagsOffset] &= ~0x2;
+    XTreeBucket<DataRecord>* legacy = new XTreeBucket<DataRecord>(idx, /*isRoot*/true);
+    legacy->from_wire(buffer.data(), idx);
+    EXPECT_EQ(legacy->subtreeCount(), XTreeBucket<DataRecord>::_MBRKeyNode::UNKNOWN_COUNT);
+
+    delete restored;
+    delete legacy;
+}
+
 // Test edge case: Empty DataRecord
 TEST_F(WireFormatTest, EmptyDataRecordRoundtrip) {
     // Create an empty DataRecord (no points)
@@ -8,6 +8,8 @@
 #include <gtest/gtest.h>
 #include "indexdetails.hpp"
 #include "xtree.h"
+#include "xtree.hpp"
+#include "datarecord.hpp"
 #include "persistence/memory_store.h"
 #include "persistence/durable_runtime.h"
 #include <memory>
@@ -17,6 +19,7 @@
 #include <set>
 #include <iostream>
 #include <cmath>
+#include <unistd.h>
 
 namespace xtree {
 
@@ -123,7 +126,7 @@ TEST_F(XTreeDurabilityTest, SplitOperationsInMemoryMode) {
     ASSERT_NE(root, nullptr);
     
     // Cache the root with proper key
-    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(rootRef.id, root);
+    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(&index, rootRef.id, root);
     auto* rootCacheNode = index.getCache().add(rootKey, static_cast<IRecord*>(root));
     
     // Set root identity
@@ -172,7 +175,7 @@ TEST_F(XTreeDurabilityTest, BasicOperationsDurableMode) {
     EXPECT_NE(root->getNodeID().raw(), persist::NodeID::invalid().raw());
     
     // Cache the root with proper key
-    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(rootRef.id, root);
+    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(&index, rootRef.id, root);
     auto* rootCacheNode = index.getCache().add(rootKey, static_cast<IRecord*>(root));
     
     // Set root identity (should call store->set_root)
@@ -192,6 +195,50 @@ TEST_F(XTreeDurabilityTest, BasicOperationsDurableMode) {
     // TODO: Test recovery - close and reopen the index, verify data is still there
 }
 
+// Durable NodeIDs are only unique within one data directory, so two
+// durable indexes open side by side hand out the same ids. Their nodes
+// must still get distinct cache keys.
+TEST_F(XTreeDurabilityTest, DurableIndexesSideBySideKeepSeparateCacheEntries) {
+    const std::string base = "/tmp/xtree_side_by_side_" + std::to_string(getpid());
+    test_dirs_.push_back(base + "_a");
+    test_dirs_.push_back(base + "_b");
+    using Index = IndexDetails<DataRecord>;
+    Index a(2, 32, &dim_ptrs_, nullptr, nullptr, "side_a", Index::PersistenceMode::DURABLE, base + "_a");
+    Index b(2, 32, &dim_ptrs_, nullptr, nullptr, "side_b", Index::PersistenceMode::DURABLE, base + "_b");
+    a.ensure_root_initialized<DataRecord>();
+    b.ensure_root_initialized<DataRecord>();
+    ASSERT_EQ(a.root_node_id().raw(), b.root_node_id().raw());
+    EXPECT_NE(a.cacheKey(a.root_node_id()), b.cacheKey(b.root_node_id()));
+
+    // Same points in both, enough to split, under different row ids
+    for (int i = 0; i < 500; i++) {
+        std::vector<double> pt = {static_cast<double>(i % 25), static_cast<double>(i / 25)};
+        for (Index* idx : {&a, &b}) {
+            auto* dr = new DataRecord(2, 32, std::string(idx == &a ? "a" : "b") + std::to_string(i));
+            dr->putPoint(&pt);
+            idx->root_bucket<DataRecord>()->xt_insert(idx->root_cache_node(), dr);
+        }
+    }
+
+    DataRecord query(2, 32, "q");
+    std::vector<double> lo = {-1, -1}, hi = {100, 100};
+    query.putPoint(&lo);
+    query.putPoint(&hi);
+    for (Index* idx : {&a, &b}) {
+        const char prefix = idx == &a ? 'a' : 'b';
+        std::unique_ptr<Iterator<DataRecord>> iter(
+            idx->root_bucket<DataRecord>()->getIterator(idx->root_cache_node(), &query, INTERSECTS));
+        size_t rows = 0, foreign = 0;
+        std::string_view rowid;
+        while (iter->nextRowID(rowid)) {
+            rows++;
+            if (rowid.empty() || rowid[0] != prefix) foreign++;
+        }
+        EXPECT_EQ(rows, 500u) << prefix;
+        EXPECT_EQ(foreign, 0u) << prefix;
+    }
+}
+
 // Test XTree split operations with DURABLE mode
 TEST_F(XTreeDurabilityTest, SplitOperationsDurableMode) {
     // Create a temporary directory for the test
@@ -222,7 +269,7 @@ TEST_F(XTreeDurabilityTest, SplitOperationsDurableMode) {
     ASSERT_TRUE(root->hasNodeID());
     
     // Cache and set as root
-    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(rootRef.id, root);
+    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(&index, rootRef.id, root);
     auto* rootCacheNode = index.getCache().add(rootKey, static_cast<IRecord*>(root));
     index.setRootIdentity(rootKey, rootRef.id, rootCacheNode);
     
@@ -276,7 +323,7 @@ TEST_F(XTreeDurabilityTest, RealStressTestWithInsertAndSearch) {
     ASSERT_NE(root, nullptr);
     
     // Cache the root
-    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(rootRef.id, root);
+    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(&index, rootRef.id, root);
     auto* rootCacheNode = index.getCache().add(rootKey, static_cast<IRecord*>(root));
     index.setRootIdentity(rootKey, rootRef.id, rootCacheNode);
     
@@ -356,7 +403,7 @@ TEST_F(XTreeDurabilityTest, StressTestDurableMode) {
     ASSERT_TRUE(root->hasNodeID());
     
     // Cache and set as root
-    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(rootRef.id, root);
+    auto rootKey = XTreeAllocatorTraits<IRecord>::cache_key_for(&index, rootRef.id, root);
     auto* rootCacheNode = index.getCache().add(rootKey, static_cast<IRecord*>(root));
     index.setRootIdentity(rootKey, rootRef.id, rootCacheNode);
     
@@ -10,6 +10,7 @@
 #include "persistence/durable_store.h"
 #include "xtree.h"
 #include "xtree.hpp"
+#include "xtaggregate.h"
 #include "datarecord.hpp"
 #include "config.h"  // For XTREE_M
 #include <memory>
@@ -539,4 +540,230 @@ TEST_F(XTreeDurabilityUnitTest, ParentNodeIDUpdatedOnRealloc) {
 #endif
 }
 
+// Test 9: Batch iteration after reload - leaf records come straight from
+// the mapped node bytes instead of being materialized as DataRecords
+TEST_F(XTreeDurabilityUnitTest, BatchReadAfterReloadTest) {
+    std::set<std::string> insertedIds;
+    {
+        IndexDetails<DataRecord> index(
+            2, 32, &dim_ptrs_, nullptr, nullptr,
+            "batch_reload_test",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+            test_dir_
+        );
+        ASSERT_TRUE(index.ensure_root_initialized<DataRecord>());
+        index.getStore()->commit(0);
+
+        for (int i = 0; i < 2 * XTREE_M; ++i) {
+            std::string recordId = "rec_" + std::to_string(i);
+            DataRecord* dr = new DataRecord(2, 32, recordId);
+            std::vector<double> point = {i * 0.01, i * 0.01};
+            dr->putPoint(&point);
+            insertedIds.insert(recordId);
+            index.root_bucket<DataRecord>()->xt_insert(index.root_cache_node(), dr);
+        }
+        index.getStore()->commit(2 * XTREE_M);
+        index.close();
+    }
+
+    IndexDetails<DataRecord>::clearCache();
+
+    IndexDetails<DataRecord> index(
+        2, 32, &dim_ptrs_, nullptr, nullptr,
+        "batch_reload_test",
+        IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+        test_dir_
+    );
+    auto* cachedRoot = index.root_cache_node();
+    ASSERT_NE(cachedRoot, nullptr);
+    auto* root = index.root_bucket<DataRecord>();
+
+    DataRecord* query = new DataRecord(2, 32, "query");
+    std::vector<double> min_pt = {-1.0, -1.0};
+    std::vector<double> max_pt = {100.0, 100.0};
+    query->putPoint(&min_pt);
+    query->putPoint(&max_pt);
+
+    auto* iter = root->getIterator(cachedRoot, query, INTERSECTS);
+    iter->setExactRefinement(true);
+    char out[256];
+    uint32_t ends[16];
+    std::set<std::string> foundIds;
+    while (size_t n = iter->nextBatch(out, sizeof(out), ends, 16)) {
+        uint32_t start = 0;
+        for (size_t i = 0; i < n; i++) {
+            foundIds.insert(std::string(out + start, ends[i] - start));
+            start = ends[i];
+        }
+    }
+    delete iter;
+    delete query;
+
+    EXPECT_EQ(foundIds, insertedIds);
+}
+
+// Subtree counts are written with the buckets and answer COUNT after reload
+TEST_F(XTreeDurabilityUnitTest, SubtreeCountsSurviveReload) {
+    const int N = 600;
+    {
+        IndexDetails<DataRecord> index(
+            2, 32, &dim_ptrs_, nullptr, nullptr,
+            "count_test",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+            test_dir_
+        );
+        auto* store = index.getStore();
+        ASSERT_TRUE(index.ensure_root_initialized<DataRecord>());
+        store->commit(0);
+
+        for (int i = 0; i < N; ++i) {
+            DataRecord* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            std::vector<double> point = {static_cast<double>(i % 30), static_cast<double>(i / 30)};
+            dr->putPoint(&point);
+            index.root_bucket<DataRecord>()->xt_insert(index.root_cache_node(), dr);
+        }
+        store->commit(N);
+        EXPECT_EQ(index.root_bucket<DataRecord>()->subtreeCount(), static_cast<uint64_t>(N));
+        index.close();
+    }
+
+    IndexDetails<DataRecord>::clearCache();
+    IndexDetails<DataRecord> index(
+        2, 32, &dim_ptrs_, nullptr, nullptr,
+        "count_test",
+        IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+        test_dir_
+    );
+    auto* cachedRoot = index.root_cache_node();
+    ASSERT_NE(cachedRoot, nullptr);
+    auto* root = index.root_bucket<DataRecord>();
+    ASSERT_FALSE(root->getIsLeaf());
+    EXPECT_EQ(root->subtreeCount(), static_cast<uint64_t>(N));
+
+    DataRecord* query = new DataRecord(2, 32, "query");
+    std::vector<double> min_pt = {-1.0, -1.0};
+    std::vector<double> max_pt = {100.0, 100.0};
+    query->putPoint(&min_pt);
+    query->putPoint(&max_pt);
+
+    AggregateQueryExecutor<DataRecord> agg(&index);
+    EXPECT_EQ(agg.count(cachedRoot, query), static_cast<uint64_t>(N));
+    EXPECT_EQ(agg.lastNodesVisited(), 1u);
+    delete query;
+}
+
+// An insert that leaves every MBR alone only changes counts above its leaf.
+// Those are written lazily, so the leaf is the only bucket to republish.
+TEST_F(XTreeDurabilityUnitTest, CountOnlyChangeDirtiesOnlyTheLeaf) {
+    const int N = 600;
+    {
+        IndexDetails<DataRecord> index(
+            2, 32, &dim_ptrs_, nullptr, nullptr,
+            "count_dirty_test",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+            test_dir_
+        );
+        auto* store = index.getStore();
+        ASSERT_TRUE(index.ensure_root_initialized<DataRecord>());
+        for (int i = 0; i < N; ++i) {
+            DataRecord* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            std::vector<double> point = {static_cast<double>(i % 30), static_cast<double>(i / 30)};
+            dr->putPoint(&point);
+            index.root_bucket<DataRecord>()->xt_insert(index.root_cache_node(), dr);
+        }
+        index.flush_dirty_buckets();
+        store->commit(1);
+        auto* root = index.root_bucket<DataRecord>();
+        ASSERT_FALSE(root->getIsLeaf());
+        ASSERT_EQ(index.dirty_bucket_count(), 0u);
+
+        // Same spot as an existing record: no bounding box grows
+        DataRecord* dup = new DataRecord(2, 32, "dup");
+        std::vector<double> point = {7.0, 7.0};
+        dup->putPoint(&point);
+        root->xt_insert(index.root_cache_node(), dup);
+
+        root = index.root_bucket<DataRecord>();
+        EXPECT_EQ(index.dirty_bucket_count(), 1u);
+        EXPECT_FALSE(root->isDirty());
+        EXPECT_TRUE(root->hasStaleCounts());
+        EXPECT_EQ(root->subtreeCount(), static_cast<uint64_t>(N + 1));
+
+        // Publishing the leaf leaves the counts pending until close
+        index.flush_dirty_buckets();
+        store->commit(2);
+        EXPECT_TRUE(root->hasStaleCounts());
+        index.close();
+        EXPECT_FALSE(root->hasStaleCounts());
+    }
+
+    IndexDetails<DataRecord>::clearCache();
+    IndexDetails<DataRecord> index(
+        2, 32, &dim_ptrs_, nullptr, nullptr,
+        "count_dirty_test",
+        IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+        test_dir_
+    );
+    ASSERT_NE(index.root_cache_node(), nullptr);
+    EXPECT_EQ(index.root_bucket<DataRecord>()->subtreeCount(), static_cast<uint64_t>(N + 1));
+}
+
+TEST_F(XTreeDurabilityUnitTest, PrefetchingTraversalOnColdCache) {
+    const int N = 3000;
+    {
+        IndexDetails<DataRecord> index(
+            2, 32, &dim_ptrs_, nullptr, nullptr,
+            "prefetch_test",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+            test_dir_
+        );
+        auto* store = index.getStore();
+        ASSERT_TRUE(index.ensure_root_initialized<DataRecord>());
+        store->commit(0);
+
+        for (int i = 0; i < N; ++i) {
+            DataRecord* dr = new DataRecord(2, 32, "rec_" + std::to_string(i));
+            std::vector<double> point = {static_cast<double>(i % 60), static_cast<double>(i / 60)};
+            dr->putPoint(&point);
+            index.root_bucket<DataRecord>()->xt_insert(index.root_cache_node(), dr);
+        }
+        store->commit(N);
+        index.close();
+    }
+
+    DataRecord query(2, 32, "query");
+    std::vector<double> min_pt = {10.0, 5.0};
+    std::vector<double> max_pt = {40.0, 30.0};
+    query.putPoint(&min_pt);
+    query.putPoint(&max_pt);
+    const size_t expected = 31 * 26;
+
+    // Same query on a cold cache, with and without read-ahead
+    for (unsigned distance : {0u, 4u}) {
+        IndexDetails<DataRecord>::clearCache();
+        IndexDetails<DataRecord> index(
+            2, 32, &dim_ptrs_, nullptr, nullptr,
+            "prefetch_test",
+            IndexDetails<DataRecord>::PersistenceMode::DURABLE,
+            test_dir_
+        );
+        auto* root = index.root_bucket<DataRecord>();
+        ASSERT_NE(root, nullptr);
+
+        Iterator<DataRecord>::setDefaultPrefetchDistance(distance);
+        Iterator<DataRecord>* iter = root->getIterator(index.root_cache_node(), &query, INTERSECTS);
+        size_t found = 0;
+        std::string_view rid;
+        while (iter->nextRowID(rid)) found++;
+        EXPECT_EQ(found, expected) << "distance " << distance;
+        if (distance == 0) {
+            EXPECT_EQ(iter->storePrefetches(), 0u);
+        } else {
+            EXPECT_GT(iter->storePrefetches(), 0u);
+        }
+        delete iter;
+    }
+    Iterator<DataRecord>::setDefaultPrefetchDistance(XTREE_PREFETCH_DISTANCE);
+}
+
 } // namespace xtree
\ No newline at end of file
@@ -385,6 +385,117 @@ TEST_F(LoggingTest, ComplexDataTypes) {
     SUCCEED();
 }
 
+TEST_F(LoggingTest, AsyncLoggingWritesEveryMessage) {
+    LogManager::RotationConfig config;
+    config.enable_auto_rotation = false;
+    
+    const int num_threads = 8;
+    const int messages_per_thread = 2000;
+    {
+        LogManager log_mgr(test_log_dir, config);
+        logLevel = LOG_INFO;
+        // Small rings so producers wrap and wait on the drain thread
+        Logger::startAsync(64 * 1024);
+        ASSERT_TRUE(Logger::asyncEnabled());
+        
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([i]() {
+                for (int j = 0; j < messages_per_thread; ++j) {
+                    info() << "async t" << i << " m" << j << " " << 1.5 << " " << true;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        Logger::stopAsync();
+        EXPECT_FALSE(Logger::asyncEnabled());
+    }
+    
+    // Every message arrives, in order within each thread
+    std::ifstream log_file(test_log_dir + "/xtree.log");
+    std::vector<int> next(num_threads, 0);
+    std::regex re("\\[INFO\\] async t(\\d+) m(\\d+) 1\\.5 1$");
+    std::string line;
+    int total = 0;
+    while (std::getline(log_file, line)) {
+        std::smatch m;
+        if (!std::regex_search(line, m, re)) continue;
+        int t = std::stoi(m[1]);
+        EXPECT_EQ(std::stoi(m[2]), next[t]) << "Out of order for thread " << t;
+        next[t] = std::stoi(m[2]) + 1;
+        total++;
+    }
+    EXPECT_EQ(total, num_threads * messages_per_thread);
+}
+
+TEST_F(LoggingTest, AsyncFormattingMatchesSync) {
+    logLevel = LOG_INFO;
+    auto emit = []() {
+        info() << "fmt " << 42 << ' ' << -7L << ' ' << 123u << ' ' << std::string("str")
+               << ' ' << static_cast<void*>(nullptr) << ' ' << std::hex << 255 << ' ' << -1;
+        info() << "next " << 255;  // Manipulators do not leak across messages
+    };
+    std::string sync_out = captureLogOutput(emit);
+    std::string async_out = captureLogOutput([&]() {
+        Logger::startAsync();
+        emit();
+        Logger::stopAsync();
+    });
+    
+    // Compare lines without the timestamp prefix
+    auto lines = [](const std::string& s) {
+        std::vector<std::string> out;
+        std::istringstream is(s);
+        std::string line;
+        while (std::getline(is, line)) {
+            if (!line.empty()) out.push_back(std::regex_replace(line, std::regex("^[^\\[]*"), ""));
+        }
+        return out;
+    };
+    auto sync_lines = lines(sync_out);
+    ASSERT_EQ(sync_lines.size(), 2u);
+    EXPECT_EQ(sync_lines[0], "[XTREE_NATIVE] [INFO] fmt 42 -7 123 str 0 ff ffffffff");
+    EXPECT_EQ(sync_lines[1], "[XTREE_NATIVE] [INFO] next 255");
+    EXPECT_EQ(lines(async_out), sync_lines);
+}
+
+TEST_F(LoggingTest, CompiledOutLevelIsNoOp) {
+    // Levels below XTREE_MIN_LOG_LEVEL resolve to NullLogWrapper
+    static_assert(std::is_same<LogStatement<LOG_SEVERE>, LoggerWrapper>::value ||
+                  XTREE_MIN_LOG_LEVEL > LOG_SEVERE, "SEVERE compiled in");
+    static_assert(std::is_empty<NullLogWrapper>::value, "NullLogWrapper carries no state");
+    
+    std::string out = captureLogOutput([]() {
+        logLevel = LOG_TRACE;
+        NullLogWrapper() << "never written " << 1 << std::endl;
+    });
+    EXPECT_EQ(out.find("never written"), std::string::npos);
+}
+
+TEST_F(LoggingTest, LogMacroSkipsCompiledOutOperands) {
+    int evaluated = 0;
+    auto arg = [&evaluated]() { return ++evaluated; };
+
+    std::string out = captureLogOutput([&]() {
+        logLevel = LOG_TRACE;
+        if (evaluated < 0)
+            XTREE_LOG(LOG_INFO) << "not taken";
+        else
+            XTREE_LOG(LOG_INFO) << "macro " << arg();
+    });
+
+    if constexpr (LOG_INFO < XTREE_MIN_LOG_LEVEL) {
+        EXPECT_EQ(evaluated, 0);
+        EXPECT_EQ(out.find("macro"), std::string::npos);
+    } else {
+        EXPECT_EQ(evaluated, 1);
+        EXPECT_NE(out.find("macro 1"), std::string::npos);
+        EXPECT_EQ(out.find("not taken"), std::string::npos);
+    }
+}
+
 TEST_F(LoggingTest, NoSpamAtHighLevels) {
     // Ensure that when log level is set high, lower priority messages don't appear
     
@@ -489,7 +600,8 @@ TEST_F(LoggingTest, RuntimeLogLevelControl) {
         debug() << "debug2";
         warning() << "warning2";
     });
-    EXPECT_TRUE(containsLogMessage(output2, "DEBUG", "debug2"));
+    // Release builds compile DEBUG out regardless of the runtime level
+    EXPECT_EQ(containsLogMessage(output2, "DEBUG", "debug2"), LOG_DEBUG >= XTREE_MIN_LOG_LEVEL);
     EXPECT_TRUE(containsLogMessage(output2, "WARN", "warning2"));
 }
 
@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Unit tests for MissRatioCurve (SHARDS-style sampled reuse distances).
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/util/miss_ratio_curve.h"
+
+#include <cstdint>
+
+using namespace xtree;
+
+namespace {
+
+// Reference keys [0, numKeys) in order, passes times (cyclic LRU worst case)
+void runCyclic(MissRatioCurve& mrc, uint64_t numKeys, size_t bytes, int passes) {
+    for (int p = 0; p < passes; ++p) {
+        for (uint64_t k = 0; k < numKeys; ++k) {
+            mrc.access(k, bytes);
+        }
+    }
+}
+
+} // namespace
+
+TEST(MissRatioCurveTest, EmptyCurve) {
+    MissRatioCurve mrc(1.0);
+    EXPECT_EQ(mrc.sampledReferences(), 0u);
+    EXPECT_DOUBLE_EQ(mrc.hitsAt(1 << 20), 0.0);
+    EXPECT_DOUBLE_EQ(mrc.hitRatioAt(1 << 20), 0.0);
+    EXPECT_DOUBLE_EQ(mrc.bytesForHitRatio(0.9), 0.0);
+}
+
+TEST(MissRatioCurveTest, CyclicWorkingSetHasCliffAtItsSize) {
+    MissRatioCurve mrc(1.0);
+    // 100 keys x 100 bytes = 10000-byte working set, 10 passes
+    runCyclic(mrc, 100, 100, 10);
+
+    EXPECT_EQ(mrc.sampledReferences(), 1000u);
+    EXPECT_EQ(mrc.sampledReuses(), 900u);
+
+    // LRU smaller than the loop misses everything; larger hits every reuse
+    EXPECT_DOUBLE_EQ(mrc.hitRatioAt(8000), 0.0);
+    EXPECT_NEAR(mrc.hitRatioAt(12000), 0.9, 1e-9);
+
+    // The size needed for 50% hits sits in the bin holding 10000
+    double needed = mrc.bytesForHitRatio(0.5);
+    EXPECT_GT(needed, 8000.0);
+    EXPECT_LT(needed, 12000.0);
+}
+
+TEST(MissRatioCurveTest, ReuseDistanceCountsDistinctKeysOnly) {
+    MissRatioCurve mrc(1.0);
+    // Key 0 is re-referenced after many touches of only two other keys,
+    // so its distance is 3 entries no matter how often 1 and 2 repeat
+    mrc.access(0, 1000);
+    for (int i = 0; i < 50; ++i) {
+        mrc.access(1, 1000);
+        mrc.access(2, 1000);
+    }
+    mrc.access(0, 1000);
+
+    // All reuses have distance <= 3000 bytes
+    double total = mrc.estimatedReferences();
+    EXPECT_NEAR(mrc.hitsAt(4000), total - 3.0, 1e-9);  // 3 cold misses
+}
+
+TEST(MissRatioCurveTest, MarginalHitsPerByteIsPositiveOnlyAcrossTheCliff) {
+    MissRatioCurve mrc(1.0);
+    runCyclic(mrc, 100, 100, 5);
+
+    EXPECT_DOUBLE_EQ(mrc.marginalHitsPerByte(1000, 5000), 0.0);
+    EXPECT_DOUBLE_EQ(mrc.marginalHitsPerByte(20000, 40000), 0.0);
+    EXPECT_GT(mrc.marginalHitsPerByte(5000, 20000), 0.0);
+    EXPECT_DOUBLE_EQ(mrc.marginalHitsPerByte(5000, 5000), 0.0);
+}
+
+TEST(MissRatioCurveTest, SampledEstimateTracksFullStream) {
+    MissRatioCurve mrc(0.1);
+    // 20000 keys x 64 bytes = 1.28MB working set
+    runCyclic(mrc, 20000, 64, 5);
+
+    // Only ~10% of references are processed
+    EXPECT_GT(mrc.sampledReferences(), 5000u);
+    EXPECT_LT(mrc.sampledReferences(), 15000u);
+
+    // ...but the scaled curve still describes the full stream
+    EXPECT_NEAR(mrc.estimatedReferences(), 100000.0, 15000.0);
+    EXPECT_NEAR(mrc.hitRatioAt(2.0 * 1280000), 0.8, 0.02);
+    EXPECT_LT(mrc.hitRatioAt(0.5 * 1280000), 0.02);
+}
+
+TEST(MissRatioCurveTest, DecayAgesHistory) {
+    MissRatioCurve mrc(1.0);
+    runCyclic(mrc, 100, 100, 3);
+    double before = mrc.hitsAt(1 << 20);
+    mrc.decay(0.5);
+    EXPECT_NEAR(mrc.hitsAt(1 << 20), before * 0.5, 1e-9);
+    EXPECT_NEAR(mrc.hitRatioAt(1 << 20), 2.0 / 3.0, 1e-9);  // Ratio unchanged
+}
+
+TEST(MissRatioCurveTest, TrackedKeysAreBounded) {
+    MissRatioCurve mrc(1.0, 64);
+    // 200 distinct keys cycle: beyond the tracked bound, so reuse is never
+    // observed and every reference is a cold miss
+    runCyclic(mrc, 200, 10, 4);
+    EXPECT_EQ(mrc.sampledReuses(), 0u);
+    EXPECT_DOUBLE_EQ(mrc.hitsAt(1e12), 0.0);
+
+    // A loop that fits within the bound is still measured, including after
+    // the logical clock has been compacted many times
+    MissRatioCurve small(1.0, 64);
+    runCyclic(small, 32, 10, 100);
+    EXPECT_EQ(small.sampledReuses(), 32u * 99u);
+    EXPECT_NEAR(small.hitRatioAt(1000), 0.99, 1e-9);
+}
+
+TEST(MissRatioCurveTest, ConfigureResets) {
+    MissRatioCurve mrc(1.0);
+    runCyclic(mrc, 10, 10, 2);
+    EXPECT_GT(mrc.sampledReferences(), 0u);
+
+    mrc.configure(0.5, 1024);
+    EXPECT_EQ(mrc.sampledReferences(), 0u);
+    EXPECT_NEAR(mrc.samplingRate(), 0.5, 1e-6);
+}
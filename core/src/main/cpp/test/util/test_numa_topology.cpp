@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Unit tests for NUMA topology discovery and the NUMA-aware shard placement
+ * built on it. A fake two-node sysfs tree stands in for a 2-socket machine.
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/util/numa_topology.h"
+#include "../../src/util/work_stealing_pool.h"
+#include "../../src/persistence/object_table_sharded.hpp"
+#include "../../src/lru_sharded.h"
+#include "../../src/lru.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace xtree;
+using namespace xtree::persist;
+
+class NumaTopologyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / ("xtree_numa_" + std::to_string(getpid()));
+        std::filesystem::remove_all(dir);
+        writeNode(0, "0-1\n");
+        writeNode(2, "2,3\n");   // ids need not be contiguous
+        writeNode(3, "\n");      // memory-only node
+        std::ofstream(dir / "possible") << "0-3\n";
+        topo = NumaTopology::from_sysfs(dir.string());
+    }
+
+    void TearDown() override {
+        NumaTopology::clear_thread_binding();
+        std::filesystem::remove_all(dir);
+    }
+
+    void writeNode(int id, const char* cpulist) {
+        std::filesystem::create_directories(dir / ("node" + std::to_string(id)));
+        std::ofstream(dir / ("node" + std::to_string(id)) / "cpulist") << cpulist;
+    }
+
+    // Run fn on a thread bound (by bookkeeping at least) to the node
+    template< typename F >
+    void onNode(size_t node, F&& fn) {
+        std::thread t([&] {
+            topo.bind_current_thread(node);
+            fn();
+        });
+        t.join();
+    }
+
+    std::filesystem::path dir;
+    NumaTopology topo;
+};
+
+TEST_F(NumaTopologyTest, ParsesCpuLists) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(NumaTopology::parse_cpu_list("0-3,8,10-11\n", cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_TRUE(NumaTopology::parse_cpu_list("", cpus));
+    EXPECT_TRUE(cpus.empty());
+    EXPECT_FALSE(NumaTopology::parse_cpu_list("3-1", cpus));
+    EXPECT_FALSE(NumaTopology::parse_cpu_list("0,x", cpus));
+}
+
+TEST_F(NumaTopologyTest, ReadsNodesFromSysfs) {
+    ASSERT_EQ(topo.node_count(), 2u);
+    EXPECT_TRUE(topo.is_numa());
+    EXPECT_EQ(topo.os_node(0), 0);
+    EXPECT_EQ(topo.os_node(1), 2);
+    EXPECT_EQ(topo.cpus_of(1), (std::vector<int>{2, 3}));
+    EXPECT_EQ(topo.node_of_cpu(1), 0u);
+    EXPECT_EQ(topo.node_of_cpu(3), 1u);
+    EXPECT_EQ(topo.node_of_cpu(99), 0u);
+
+    EXPECT_EQ(NumaTopology::from_sysfs((dir / "missing").string()).node_count(), 0u);
+    EXPECT_GE(NumaTopology::system().node_count(), 1u);
+    EXPECT_FALSE(NumaTopology::single_node(4).is_numa());
+}
+
+TEST_F(NumaTopologyTest, BoundThreadReportsItsNode) {
+    size_t seen = 99;
+    onNode(1, [&] { seen = topo.current_node(); });
+    EXPECT_EQ(seen, 1u);
+    EXPECT_FALSE(topo.bind_current_thread(2));
+}
+
+TEST_F(NumaTopologyTest, NodeLocalMemoryIsUsable) {
+    // The policy is best effort; the memory must be usable either way
+    auto* p = static_cast<char*>(topo.allocate_on_node(10000, 1));
+    ASSERT_NE(p, nullptr);
+    std::memset(p, 0x5a, 10000);
+    EXPECT_EQ(p[9999], 0x5a);
+    NumaTopology::free_on_node(p, 10000);
+
+    auto boxed = make_on_node<std::vector<int>>(topo, 1, 3, 7);
+    EXPECT_EQ(*boxed, (std::vector<int>{7, 7, 7}));
+}
+
+TEST_F(NumaTopologyTest, ObjectTableAllocatesFromTheCallersNode) {
+    ObjectTableSharded ot(100000, 8, &topo);
+    ASSERT_TRUE(ot.numa_aware());
+    EXPECT_EQ(ot.shard_home_node(5), 1u);
+    ot.set_activation_step_for_tests(1);
+
+    for (size_t node : {0u, 1u}) {
+        std::vector<NodeID> ids;
+        onNode(node, [&] {
+            for (int i = 0; i < 500; ++i) {
+                ids.push_back(ot.allocate(NodeKind::Leaf, 1, OTAddr{}, 1));
+            }
+        });
+        ASSERT_EQ(ot.active_shards(), 8u);
+        size_t onHome = 0;
+        for (NodeID id : ids) {
+            const size_t shard = ShardBits::shard_from_handle_idx(id.handle_index());
+            if (ot.shard_home_node(shard) == node) ++onHome;
+        }
+        // Only the allocations made before the node's first shard was
+        // active may land elsewhere
+        EXPECT_GE(onHome, ids.size() - 2) << "node " << node;
+    }
+
+    // Off a NUMA machine nothing changes
+    const NumaTopology one = NumaTopology::single_node(2);
+    ObjectTableSharded flat(100000, 8, &one);
+    EXPECT_FALSE(flat.numa_aware());
+    EXPECT_EQ(flat.shard_home_node(5), 0u);
+}
+
+TEST_F(NumaTopologyTest, WorkerPoolRunsNodeLocal) {
+    WorkStealingPool pool(4, &topo);
+    ASSERT_TRUE(pool.numaLocal());
+    EXPECT_EQ(pool.homeNode(2), 0u);
+    EXPECT_EQ(pool.homeNode(3), 1u);
+
+    std::vector<std::atomic<int>> runs(200);
+    std::atomic<int> offNode{0};
+    pool.run(runs.size(), [&](size_t task, size_t worker) {
+        runs[task].fetch_add(1);
+        if (topo.current_node() != pool.homeNode(worker)) offNode.fetch_add(1);
+    });
+    for (auto& r : runs) EXPECT_EQ(r.load(), 1);
+    EXPECT_EQ(offNode.load(), 0);
+
+    WorkStealingPool flat(2, nullptr);
+    EXPECT_FALSE(flat.numaLocal());
+}
+
+TEST_F(NumaTopologyTest, CacheShardsPlacedAcrossNodes) {
+    ShardedLRUCache<int, int, LRUDeleteObject> cache(8, true, topo);
+    for (int i = 0; i < 64; i++) {
+        ASSERT_NE(cache.add(i, new int(i * 10)), nullptr);
+    }
+    for (int i = 0; i < 64; i++) {
+        int* v = cache.get(i);
+        ASSERT_NE(v, nullptr);
+        EXPECT_EQ(*v, i * 10);
+    }
+}
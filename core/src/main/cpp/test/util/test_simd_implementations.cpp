@@ -43,6 +43,12 @@ namespace xtree {
         bool intersects_scalar(const int32_t* box1, const int32_t* box2, int dimensions);
         void expand_scalar(int32_t* target, const int32_t* source, int dimensions);
         void expand_point_scalar(int32_t* box, const double* point, int dimensions);
+        void match_matrix_scalar(const float* queries, const uint32_t* active, size_t nactive,
+                                 const float* mins, const float* maxs, size_t stride,
+                                 int dimensions, uint64_t* out);
+        bool contains_scalar(const int32_t* outer, const int32_t* inner, int dimensions);
+        double area_scalar(const float* box, int dimensions);
+        double overlap_scalar(const float* box1, const float* box2, int dimensions);
         
         #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
         bool intersects_sse2(const int32_t* box1, const int32_t* box2, int dimensions);
@@ -51,12 +57,27 @@ namespace xtree {
         void expand_avx2(int32_t* target, const int32_t* source, int dimensions);
         void expand_point_sse2(int32_t* box, const double* point, int dimensions);
         void expand_point_avx2(int32_t* box, const double* point, int dimensions);
+        void match_matrix_sse2(const float* queries, const uint32_t* active, size_t nactive,
+                               const float* mins, const float* maxs, size_t stride,
+                               int dimensions, uint64_t* out);
+        void match_matrix_avx2(const float* queries, const uint32_t* active, size_t nactive,
+                               const float* mins, const float* maxs, size_t stride,
+                               int dimensions, uint64_t* out);
+        bool intersects_avx512(const int32_t* box1, const int32_t* box2, int dimensions);
+        bool contains_avx512(const int32_t* outer, const int32_t* inner, int dimensions);
+        void expand_avx512(int32_t* target, const int32_t* source, int dimensions);
+        void expand_point_avx512(int32_t* box, const double* point, int dimensions);
+        double area_avx512(const float* box, int dimensions);
+        double overlap_avx512(const float* box1, const float* box2, int dimensions);
         #endif
         
         #if defined(__aarch64__) || defined(__arm64__)
         bool intersects_neon(const int32_t* box1, const int32_t* box2, int dimensions);
         void expand_neon(int32_t* target, const int32_t* source, int dimensions);
         void expand_point_neon(int32_t* box, const double* point, int dimensions);
+        void match_matrix_neon(const float* queries, const uint32_t* active, size_t nactive,
+                               const float* mins, const float* maxs, size_t stride,
+                               int dimensions, uint64_t* out);
         #endif
     }
 }
@@ -333,6 +354,214 @@ TEST_F(SIMDImplementationsTest, ExpandPointCorrectness) {
     }
 }
 
+// Query x child match matrix: every implementation agrees with a direct
+// per-pair overlap test, including padded (NaN) children and shared edges
+TEST_F(SIMDImplementationsTest, MatchMatrixMatchesPairwise) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(0.0f, 100.0f);
+    std::uniform_real_distribution<float> ext(0.0f, 20.0f);
+
+    std::vector<match_matrix_func_t> impls = {simd_impl::match_matrix_scalar,
+                                              get_optimal_match_matrix_func()};
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    if (CPUFeatures::get().has_sse2) impls.push_back(simd_impl::match_matrix_sse2);
+    if (CPUFeatures::get().has_avx2) impls.push_back(simd_impl::match_matrix_avx2);
+    #endif
+    #if defined(__aarch64__) || defined(__arm64__)
+    if (CPUFeatures::get().has_neon) impls.push_back(simd_impl::match_matrix_neon);
+    #endif
+
+    for (int dims : {1, 2, 3, 8}) {
+        for (size_t n : {1u, 7u, 8u, 33u, 100u}) {
+            const size_t stride = (n + 7) & ~size_t(7);
+            const size_t words = (stride + 63) / 64;
+            std::vector<float> children(n * 2 * dims);
+            for (size_t c = 0; c < n; c++) {
+                for (int d = 0; d < dims; d++) {
+                    children[c * 2 * dims + 2 * d] = pos(rng);
+                    children[c * 2 * dims + 2 * d + 1] = children[c * 2 * dims + 2 * d] + ext(rng);
+                }
+            }
+            const size_t nq = 20;
+            std::vector<float> queries(nq * 2 * dims);
+            for (size_t q = 0; q < nq; q++) {
+                for (int d = 0; d < dims; d++) {
+                    queries[q * 2 * dims + 2 * d] = pos(rng);
+                    queries[q * 2 * dims + 2 * d + 1] = queries[q * 2 * dims + 2 * d] + ext(rng);
+                }
+            }
+            // Query 0 touches child 0 exactly at its max edge
+            for (int d = 0; d < dims; d++) {
+                queries[2 * d] = children[2 * d + 1];
+                queries[2 * d + 1] = children[2 * d + 1] + 1.0f;
+            }
+
+            std::vector<float> mins(dims * stride, std::numeric_limits<float>::quiet_NaN());
+            std::vector<float> maxs(dims * stride, std::numeric_limits<float>::quiet_NaN());
+            for (size_t c = 0; c < n; c++) {
+                for (int d = 0; d < dims; d++) {
+                    mins[d * stride + c] = children[c * 2 * dims + 2 * d];
+                    maxs[d * stride + c] = children[c * 2 * dims + 2 * d + 1];
+                }
+            }
+            // Even queries, in reverse
+            std::vector<uint32_t> active;
+            for (int q = static_cast<int>(nq) - 2; q >= 0; q -= 2) active.push_back(static_cast<uint32_t>(q));
+
+            for (auto impl : impls) {
+                std::vector<uint64_t> out(active.size() * words, ~uint64_t(0));
+                impl(queries.data(), active.data(), active.size(), mins.data(), maxs.data(),
+                     stride, dims, out.data());
+                for (size_t i = 0; i < active.size(); i++) {
+                    const float* q = &queries[active[i] * 2 * dims];
+                    for (size_t c = 0; c < stride; c++) {
+                        bool expected = c < n;
+                        for (int d = 0; d < dims && expected; d++) {
+                            expected = children[c * 2 * dims + 2 * d] <= q[2 * d + 1] &&
+                                       children[c * 2 * dims + 2 * d + 1] >= q[2 * d];
+                        }
+                        const bool got = (out[i * words + c / 64] >> (c % 64)) & 1;
+                        EXPECT_EQ(got, expected) << "dims=" << dims << " n=" << n
+                                                 << " query=" << active[i] << " child=" << c;
+                    }
+                }
+                // Edge contact counts as overlap
+                ASSERT_EQ(active.back(), 0u);
+                EXPECT_TRUE(out[(active.size() - 1) * words] & 1);
+            }
+        }
+    }
+}
+
+// Every x86 tier agrees with scalar across dimension counts that hit full
+// registers, partial tails and multiple chunks
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+TEST_F(SIMDImplementationsTest, X86TiersMatchScalar) {
+    const auto& features = CPUFeatures::get();
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-1000.0, 1000.0);
+
+    struct IntTier { const char* name; bool available;
+                     intersects_func_t intersects; contains_func_t contains;
+                     expand_func_t expand; expand_point_func_t expand_point; };
+    std::vector<IntTier> tiers = {
+        {"SSE2", features.has_sse2, simd_impl::intersects_sse2, nullptr,
+         simd_impl::expand_sse2, simd_impl::expand_point_sse2},
+        {"AVX2", features.has_avx2, simd_impl::intersects_avx2, nullptr,
+         simd_impl::expand_avx2, simd_impl::expand_point_avx2},
+        {"AVX-512", features.has_avx512(), simd_impl::intersects_avx512, simd_impl::contains_avx512,
+         simd_impl::expand_avx512, simd_impl::expand_point_avx512},
+    };
+
+    for (int dims = 1; dims <= 40; dims++) {
+        for (int trial = 0; trial < 50; trial++) {
+            std::vector<int32_t> a = createRandomMBR(dims, rng);
+            std::vector<int32_t> b = trial % 3 == 0 ? createOverlappingMBRs(dims, rng).second
+                                                    : createRandomMBR(dims, rng);
+            // Every few trials b sits inside a, so contains is exercised both ways
+            if (trial % 4 == 1) {
+                for (int d = 0; d < dims; d++) {
+                    b[2 * d] = a[2 * d] + (a[2 * d + 1] - a[2 * d]) / 4;
+                    b[2 * d + 1] = a[2 * d + 1] - (a[2 * d + 1] - a[2 * d]) / 4;
+                }
+            }
+            std::vector<double> point(dims);
+            for (auto& p : point) p = coord(rng);
+
+            std::vector<int32_t> expanded = a;
+            simd_impl::expand_scalar(expanded.data(), b.data(), dims);
+            std::vector<int32_t> with_point = a;
+            simd_impl::expand_point_scalar(with_point.data(), point.data(), dims);
+
+            for (const auto& tier : tiers) {
+                if (!tier.available) continue;
+                SCOPED_TRACE(std::string(tier.name) + " dims=" + std::to_string(dims));
+                EXPECT_EQ(tier.intersects(a.data(), b.data(), dims),
+                          simd_impl::intersects_scalar(a.data(), b.data(), dims));
+                if (tier.contains) {
+                    EXPECT_EQ(tier.contains(a.data(), b.data(), dims),
+                              simd_impl::contains_scalar(a.data(), b.data(), dims));
+                    EXPECT_EQ(tier.contains(b.data(), a.data(), dims),
+                              simd_impl::contains_scalar(b.data(), a.data(), dims));
+                }
+                // Guard words past the box must survive the masked stores
+                std::vector<int32_t> target = a;
+                target.push_back(0x5a5a5a5a);
+                tier.expand(target.data(), b.data(), dims);
+                EXPECT_EQ(std::vector<int32_t>(target.begin(), target.end() - 1), expanded);
+                EXPECT_EQ(target.back(), 0x5a5a5a5a);
+
+                target = a;
+                target.push_back(0x5a5a5a5a);
+                tier.expand_point(target.data(), point.data(), dims);
+                EXPECT_EQ(std::vector<int32_t>(target.begin(), target.end() - 1), with_point);
+                EXPECT_EQ(target.back(), 0x5a5a5a5a);
+            }
+        }
+    }
+}
+
+TEST_F(SIMDImplementationsTest, AVX512AreaAndOverlapMatchScalar) {
+    if (!CPUFeatures::get().has_avx512()) {
+        GTEST_SKIP() << "CPU has no AVX-512";
+    }
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> ext(0.0f, 3.0f);
+
+    for (int dims = 1; dims <= 40; dims++) {
+        for (int trial = 0; trial < 50; trial++) {
+            std::vector<float> a(dims * 2), b(dims * 2);
+            for (int d = 0; d < dims; d++) {
+                a[2 * d] = pos(rng);
+                a[2 * d + 1] = a[2 * d] + ext(rng);
+                // Mostly overlapping so the product is not trivially 0
+                b[2 * d] = a[2 * d] + ext(rng) * (trial % 5 == 0 ? 2.0f : 0.3f);
+                b[2 * d + 1] = b[2 * d] + ext(rng);
+            }
+            // Products differ only by multiplication order
+            const double area = simd_impl::area_scalar(a.data(), dims);
+            EXPECT_NEAR(simd_impl::area_avx512(a.data(), dims), area, std::abs(area) * 1e-12)
+                << "dims=" << dims;
+            const double overlap = simd_impl::overlap_scalar(a.data(), b.data(), dims);
+            EXPECT_NEAR(simd_impl::overlap_avx512(a.data(), b.data(), dims), overlap,
+                        std::abs(overlap) * 1e-12) << "dims=" << dims;
+        }
+    }
+    EXPECT_EQ(simd_impl::overlap_avx512(nullptr, nullptr, 0), 0.0);
+
+    // A KeyMBR-shaped 2D box agrees with KeyMBR's own arithmetic
+    const float box[4] = {1.0f, 4.0f, -2.0f, 3.0f};
+    const float other[4] = {3.0f, 9.0f, 0.0f, 1.0f};
+    EXPECT_DOUBLE_EQ(simd_impl::area_avx512(box, 2), 15.0);
+    EXPECT_DOUBLE_EQ(simd_impl::overlap_avx512(box, other, 2), 1.0);
+}
+#endif
+
+// Kernel tables fall through to the first tier the CPU supports
+TEST_F(SIMDImplementationsTest, KernelTableSelectsWidestSupportedTier) {
+    const auto& features = CPUFeatures::get();
+    EXPECT_TRUE(features.supports(SimdTier::SCALAR));
+
+    static const KernelVariant<area_func_t> table[] = {
+        {SimdTier::AVX512, [](const float*, int) { return 512.0; }},
+        {SimdTier::AVX2, [](const float*, int) { return 256.0; }},
+        {SimdTier::SCALAR, [](const float*, int) { return 1.0; }},
+    };
+    const double expected = features.supports(SimdTier::AVX512) ? 512.0
+                          : features.supports(SimdTier::AVX2) ? 256.0 : 1.0;
+    EXPECT_EQ(select_kernel(table)(nullptr, 0), expected);
+
+    // Every getter resolves, and the new ones agree with scalar
+    EXPECT_NE(get_optimal_contains_func(), nullptr);
+    EXPECT_NE(get_optimal_area_func(), nullptr);
+    EXPECT_NE(get_optimal_overlap_func(), nullptr);
+    const int32_t outer[4] = {0, 10, 0, 10};
+    const int32_t inner[4] = {2, 8, 3, 7};
+    EXPECT_TRUE(get_optimal_contains_func()(outer, inner, 2));
+    EXPECT_FALSE(get_optimal_contains_func()(inner, outer, 2));
+}
+
 // Test optimal function selection
 TEST_F(SIMDImplementationsTest, OptimalFunctionSelection) {
     const auto& features = CPUFeatures::get();
@@ -344,6 +573,7 @@ TEST_F(SIMDImplementationsTest, OptimalFunctionSelection) {
     std::cout << "CPU Features:" << std::endl;
     std::cout << "  SSE2: " << (features.has_sse2 ? "yes" : "no") << std::endl;
     std::cout << "  AVX2: " << (features.has_avx2 ? "yes" : "no") << std::endl;
+    std::cout << "  AVX-512: " << (features.has_avx512() ? "yes" : "no") << std::endl;
     std::cout << "  NEON: " << (features.has_neon ? "yes" : "no") << std::endl;
     
     #if defined(__aarch64__) || defined(__arm64__)
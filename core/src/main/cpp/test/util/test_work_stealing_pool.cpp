@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Unit tests for WorkStealingPool.
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/util/work_stealing_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace xtree;
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+    WorkStealingPool pool(4);
+    ASSERT_EQ(pool.size(), 4u);
+
+    for (size_t count : {1u, 3u, 1000u}) {
+        std::vector<std::atomic<int>> runs(count);
+        std::atomic<bool> badWorker{false};
+        pool.run(count, [&](size_t task, size_t worker) {
+            if (worker >= pool.size()) badWorker = true;
+            runs[task].fetch_add(1);
+        });
+        EXPECT_FALSE(badWorker);
+        for (size_t t = 0; t < count; ++t) {
+            EXPECT_EQ(runs[t].load(), 1) << "task " << t << " of " << count;
+        }
+    }
+    pool.run(0, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersStealFromBusyOnes) {
+    WorkStealingPool pool(2);
+
+    // The first task worker 0 picks up blocks it until every other task has
+    // run, so worker 1 has to take the rest of worker 0's deque
+    const size_t count = 16;
+    std::atomic<size_t> finished{0};
+    std::atomic<bool> blocked{false};
+    pool.run(count, [&](size_t, size_t worker) {
+        if (worker == 0 && !blocked.exchange(true)) {
+            while (finished.load() < count - 1) {
+                std::this_thread::yield();
+            }
+        }
+        finished.fetch_add(1);
+    });
+    EXPECT_EQ(finished.load(), count);
+    EXPECT_GT(pool.steals(), 0u);
+}
+
+TEST(WorkStealingPoolTest, FirstExceptionIsRethrownAfterBatch) {
+    WorkStealingPool pool(3);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(pool.run(50, [&](size_t task, size_t) {
+        ran.fetch_add(1);
+        if (task == 7) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+    EXPECT_EQ(ran.load(), 50);
+
+    // Pool is still usable
+    ran = 0;
+    pool.run(10, [&](size_t, size_t) { ran.fetch_add(1); });
+    EXPECT_EQ(ran.load(), 10);
+}
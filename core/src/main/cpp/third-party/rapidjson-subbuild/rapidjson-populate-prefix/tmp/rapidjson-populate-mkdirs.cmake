@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-src"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-build"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/tmp"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/src/rapidjson-populate-stamp"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/src"
+  "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/src/rapidjson-populate-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/src/rapidjson-populate-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/core/src/main/cpp/third-party/rapidjson-subbuild/rapidjson-populate-prefix/src/rapidjson-populate-stamp${cfgdir}") # cfgdir has leading slash
+endif()